@@ -0,0 +1,26 @@
+#include <stdio.h>
+#include <string.h>
+#include "ast.h"
+#include "parser.h"
+#include "y.tab.h"
+#include "/tmp/harness/lex_reentrant.c"
+
+// 解析内存中的源代码：扫描器直接在 source 上工作，不再经过临时文件
+// source[length] 和 source[length + 1] 必须为 '\0'（flex 的缓冲区结束标记），
+// 否则退回到复制一份缓冲区
+int parse_buffer(char *source, size_t length, FILE *diag, ASTNode **root)
+{
+    yyscan_t scanner;
+    if (yylex_init_extra(diag, &scanner) != 0)
+        return 1;
+
+    YY_BUFFER_STATE buffer = yy_scan_buffer(source, length + 2, scanner);
+    if (!buffer)
+        buffer = yy_scan_bytes(source, (int)length, scanner);
+
+    *root = NULL;
+    int result = yyparse(scanner, root);
+    yy_delete_buffer(buffer, scanner);
+    yylex_destroy(scanner);
+    return result;
+}
@@ -0,0 +1,3165 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison implementation for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* C LALR(1) parser skeleton written by Richard Stallman, by
+   simplifying the original so-called "semantic" parser.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+/* All symbols defined below should begin with yy or YY, to avoid
+   infringing on user name space.  This should be done even for local
+   variables, as they might otherwise be expanded by user macros.
+   There are some unavoidable exceptions within include files to
+   define necessary library symbols; they are noted "INFRINGES ON
+   USER NAME SPACE" below.  */
+
+/* Identify Bison output, and Bison version.  */
+#define YYBISON 30802
+
+/* Bison version string.  */
+#define YYBISON_VERSION "3.8.2"
+
+/* Skeleton name.  */
+#define YYSKELETON_NAME "yacc.c"
+
+/* Pure parsers.  */
+#define YYPURE 2
+
+/* Push parsers.  */
+#define YYPUSH 0
+
+/* Pull parsers.  */
+#define YYPULL 1
+
+
+
+
+/* First part of user prologue.  */
+#line 1 "src/parser/parser.y"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast.h"
+
+#line 78 "build/y.tab.c"
+
+# ifndef YY_CAST
+#  ifdef __cplusplus
+#   define YY_CAST(Type, Val) static_cast<Type> (Val)
+#   define YY_REINTERPRET_CAST(Type, Val) reinterpret_cast<Type> (Val)
+#  else
+#   define YY_CAST(Type, Val) ((Type) (Val))
+#   define YY_REINTERPRET_CAST(Type, Val) ((Type) (Val))
+#  endif
+# endif
+# ifndef YY_NULLPTR
+#  if defined __cplusplus
+#   if 201103L <= __cplusplus
+#    define YY_NULLPTR nullptr
+#   else
+#    define YY_NULLPTR 0
+#   endif
+#  else
+#   define YY_NULLPTR ((void*)0)
+#  endif
+# endif
+
+#include "y.tab.h"
+/* Symbol kind.  */
+enum yysymbol_kind_t
+{
+  YYSYMBOL_YYEMPTY = -2,
+  YYSYMBOL_YYEOF = 0,                      /* "end of file"  */
+  YYSYMBOL_YYerror = 1,                    /* error  */
+  YYSYMBOL_YYUNDEF = 2,                    /* "invalid token"  */
+  YYSYMBOL_IDENTIFIER = 3,                 /* IDENTIFIER  */
+  YYSYMBOL_INTEGER_CONSTANT = 4,           /* INTEGER_CONSTANT  */
+  YYSYMBOL_FLOATING_CONSTANT = 5,          /* FLOATING_CONSTANT  */
+  YYSYMBOL_FLOATING_CONSTANT_F = 6,        /* FLOATING_CONSTANT_F  */
+  YYSYMBOL_CHARACTER_CONSTANT = 7,         /* CHARACTER_CONSTANT  */
+  YYSYMBOL_STRING_LITERAL = 8,             /* STRING_LITERAL  */
+  YYSYMBOL_INT = 9,                        /* INT  */
+  YYSYMBOL_FLOAT = 10,                     /* FLOAT  */
+  YYSYMBOL_CHAR = 11,                      /* CHAR  */
+  YYSYMBOL_VOID = 12,                      /* VOID  */
+  YYSYMBOL_SHORT = 13,                     /* SHORT  */
+  YYSYMBOL_LONG = 14,                      /* LONG  */
+  YYSYMBOL_DOUBLE = 15,                    /* DOUBLE  */
+  YYSYMBOL_UNSIGNED = 16,                  /* UNSIGNED  */
+  YYSYMBOL_STRUCT = 17,                    /* STRUCT  */
+  YYSYMBOL_UNION = 18,                     /* UNION  */
+  YYSYMBOL_STATIC = 19,                    /* STATIC  */
+  YYSYMBOL_EXTERN = 20,                    /* EXTERN  */
+  YYSYMBOL_TYPEDEF = 21,                   /* TYPEDEF  */
+  YYSYMBOL_ENUM = 22,                      /* ENUM  */
+  YYSYMBOL_SIZEOF = 23,                    /* SIZEOF  */
+  YYSYMBOL_RETURN = 24,                    /* RETURN  */
+  YYSYMBOL_IF = 25,                        /* IF  */
+  YYSYMBOL_ELSE = 26,                      /* ELSE  */
+  YYSYMBOL_WHILE = 27,                     /* WHILE  */
+  YYSYMBOL_DO = 28,                        /* DO  */
+  YYSYMBOL_FOR = 29,                       /* FOR  */
+  YYSYMBOL_SWITCH = 30,                    /* SWITCH  */
+  YYSYMBOL_CASE = 31,                      /* CASE  */
+  YYSYMBOL_DEFAULT = 32,                   /* DEFAULT  */
+  YYSYMBOL_BREAK = 33,                     /* BREAK  */
+  YYSYMBOL_CONTINUE = 34,                  /* CONTINUE  */
+  YYSYMBOL_ASM = 35,                       /* ASM  */
+  YYSYMBOL_CONST = 36,                     /* CONST  */
+  YYSYMBOL_VOLATILE = 37,                  /* VOLATILE  */
+  YYSYMBOL_INLINE = 38,                    /* INLINE  */
+  YYSYMBOL_SEMICOLON = 39,                 /* SEMICOLON  */
+  YYSYMBOL_LBRACE = 40,                    /* LBRACE  */
+  YYSYMBOL_RBRACE = 41,                    /* RBRACE  */
+  YYSYMBOL_COMMA = 42,                     /* COMMA  */
+  YYSYMBOL_LPAREN = 43,                    /* LPAREN  */
+  YYSYMBOL_RPAREN = 44,                    /* RPAREN  */
+  YYSYMBOL_LBRACKET = 45,                  /* LBRACKET  */
+  YYSYMBOL_RBRACKET = 46,                  /* RBRACKET  */
+  YYSYMBOL_ASSIGN = 47,                    /* ASSIGN  */
+  YYSYMBOL_ADD_ASSIGN = 48,                /* ADD_ASSIGN  */
+  YYSYMBOL_SUB_ASSIGN = 49,                /* SUB_ASSIGN  */
+  YYSYMBOL_MUL_ASSIGN = 50,                /* MUL_ASSIGN  */
+  YYSYMBOL_DIV_ASSIGN = 51,                /* DIV_ASSIGN  */
+  YYSYMBOL_MOD_ASSIGN = 52,                /* MOD_ASSIGN  */
+  YYSYMBOL_AND_ASSIGN = 53,                /* AND_ASSIGN  */
+  YYSYMBOL_OR_ASSIGN = 54,                 /* OR_ASSIGN  */
+  YYSYMBOL_XOR_ASSIGN = 55,                /* XOR_ASSIGN  */
+  YYSYMBOL_LEFT_ASSIGN = 56,               /* LEFT_ASSIGN  */
+  YYSYMBOL_RIGHT_ASSIGN = 57,              /* RIGHT_ASSIGN  */
+  YYSYMBOL_PLUS = 58,                      /* PLUS  */
+  YYSYMBOL_MINUS = 59,                     /* MINUS  */
+  YYSYMBOL_STAR = 60,                      /* STAR  */
+  YYSYMBOL_SLASH = 61,                     /* SLASH  */
+  YYSYMBOL_PERCENT = 62,                   /* PERCENT  */
+  YYSYMBOL_AMPERSAND = 63,                 /* AMPERSAND  */
+  YYSYMBOL_LT = 64,                        /* LT  */
+  YYSYMBOL_GT = 65,                        /* GT  */
+  YYSYMBOL_LE_OP = 66,                     /* LE_OP  */
+  YYSYMBOL_GE_OP = 67,                     /* GE_OP  */
+  YYSYMBOL_EQ_OP = 68,                     /* EQ_OP  */
+  YYSYMBOL_NE_OP = 69,                     /* NE_OP  */
+  YYSYMBOL_LEFT_SHIFT = 70,                /* LEFT_SHIFT  */
+  YYSYMBOL_RIGHT_SHIFT = 71,               /* RIGHT_SHIFT  */
+  YYSYMBOL_AND_OP = 72,                    /* AND_OP  */
+  YYSYMBOL_OR_OP = 73,                     /* OR_OP  */
+  YYSYMBOL_NOT_OP = 74,                    /* NOT_OP  */
+  YYSYMBOL_PIPE = 75,                      /* PIPE  */
+  YYSYMBOL_XOR = 76,                       /* XOR  */
+  YYSYMBOL_TILDE = 77,                     /* TILDE  */
+  YYSYMBOL_DOT = 78,                       /* DOT  */
+  YYSYMBOL_ARROW = 79,                     /* ARROW  */
+  YYSYMBOL_INC_OP = 80,                    /* INC_OP  */
+  YYSYMBOL_DEC_OP = 81,                    /* DEC_OP  */
+  YYSYMBOL_QUESTION = 82,                  /* QUESTION  */
+  YYSYMBOL_COLON = 83,                     /* COLON  */
+  YYSYMBOL_ELLIPSIS = 84,                  /* ELLIPSIS  */
+  YYSYMBOL_YYACCEPT = 85,                  /* $accept  */
+  YYSYMBOL_program = 86,                   /* program  */
+  YYSYMBOL_external_declaration = 87,      /* external_declaration  */
+  YYSYMBOL_function_definition = 88,       /* function_definition  */
+  YYSYMBOL_declaration_specifiers = 89,    /* declaration_specifiers  */
+  YYSYMBOL_declarator = 90,                /* declarator  */
+  YYSYMBOL_parameter_list = 91,            /* parameter_list  */
+  YYSYMBOL_parameter_declaration = 92,     /* parameter_declaration  */
+  YYSYMBOL_declaration = 93,               /* declaration  */
+  YYSYMBOL_init_declarator = 94,           /* init_declarator  */
+  YYSYMBOL_initializer = 95,               /* initializer  */
+  YYSYMBOL_initializer_list = 96,          /* initializer_list  */
+  YYSYMBOL_compound_statement = 97,        /* compound_statement  */
+  YYSYMBOL_statement_list = 98,            /* statement_list  */
+  YYSYMBOL_statement = 99,                 /* statement  */
+  YYSYMBOL_labeled_statement = 100,        /* labeled_statement  */
+  YYSYMBOL_expression_statement = 101,     /* expression_statement  */
+  YYSYMBOL_selection_statement = 102,      /* selection_statement  */
+  YYSYMBOL_iteration_statement = 103,      /* iteration_statement  */
+  YYSYMBOL_jump_statement = 104,           /* jump_statement  */
+  YYSYMBOL_expression = 105,               /* expression  */
+  YYSYMBOL_assignment_expression = 106,    /* assignment_expression  */
+  YYSYMBOL_conditional_expression = 107,   /* conditional_expression  */
+  YYSYMBOL_logical_or_expression = 108,    /* logical_or_expression  */
+  YYSYMBOL_logical_and_expression = 109,   /* logical_and_expression  */
+  YYSYMBOL_bitwise_or_expression = 110,    /* bitwise_or_expression  */
+  YYSYMBOL_bitwise_xor_expression = 111,   /* bitwise_xor_expression  */
+  YYSYMBOL_bitwise_and_expression = 112,   /* bitwise_and_expression  */
+  YYSYMBOL_equality_expression = 113,      /* equality_expression  */
+  YYSYMBOL_relational_expression = 114,    /* relational_expression  */
+  YYSYMBOL_shift_expression = 115,         /* shift_expression  */
+  YYSYMBOL_additive_expression = 116,      /* additive_expression  */
+  YYSYMBOL_multiplicative_expression = 117, /* multiplicative_expression  */
+  YYSYMBOL_unary_expression = 118,         /* unary_expression  */
+  YYSYMBOL_postfix_expression = 119,       /* postfix_expression  */
+  YYSYMBOL_argument_expression_list = 120, /* argument_expression_list  */
+  YYSYMBOL_primary_expression = 121,       /* primary_expression  */
+  YYSYMBOL_struct_specifier = 122,         /* struct_specifier  */
+  YYSYMBOL_enum_specifier = 123,           /* enum_specifier  */
+  YYSYMBOL_enumerator_list = 124,          /* enumerator_list  */
+  YYSYMBOL_struct_declaration_list = 125,  /* struct_declaration_list  */
+  YYSYMBOL_struct_declaration = 126,       /* struct_declaration  */
+  YYSYMBOL_union_specifier = 127           /* union_specifier  */
+};
+typedef enum yysymbol_kind_t yysymbol_kind_t;
+
+
+
+/* Unqualified %code blocks.  */
+#line 17 "src/parser/parser.y"
+
+int yylex(YYSTYPE *yylval_param, yyscan_t scanner);
+int yyget_lineno(yyscan_t scanner);
+char *yyget_text(yyscan_t scanner);
+FILE *yyget_extra(yyscan_t scanner);
+void yyerror(yyscan_t scanner, ASTNode **ast_root, const char *s);
+
+// 可重入解析：行号取自当前扫描器实例
+#define yylineno yyget_lineno(scanner)
+
+#line 251 "build/y.tab.c"
+
+#ifdef short
+# undef short
+#endif
+
+/* On compilers that do not define __PTRDIFF_MAX__ etc., make sure
+   <limits.h> and (if available) <stdint.h> are included
+   so that the code can choose integer types of a good width.  */
+
+#ifndef __PTRDIFF_MAX__
+# include <limits.h> /* INFRINGES ON USER NAME SPACE */
+# if defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stdint.h> /* INFRINGES ON USER NAME SPACE */
+#  define YY_STDINT_H
+# endif
+#endif
+
+/* Narrow types that promote to a signed type and that can represent a
+   signed or unsigned integer of at least N bits.  In tables they can
+   save space and decrease cache pressure.  Promoting to a signed type
+   helps avoid bugs in integer arithmetic.  */
+
+#ifdef __INT_LEAST8_MAX__
+typedef __INT_LEAST8_TYPE__ yytype_int8;
+#elif defined YY_STDINT_H
+typedef int_least8_t yytype_int8;
+#else
+typedef signed char yytype_int8;
+#endif
+
+#ifdef __INT_LEAST16_MAX__
+typedef __INT_LEAST16_TYPE__ yytype_int16;
+#elif defined YY_STDINT_H
+typedef int_least16_t yytype_int16;
+#else
+typedef short yytype_int16;
+#endif
+
+/* Work around bug in HP-UX 11.23, which defines these macros
+   incorrectly for preprocessor constants.  This workaround can likely
+   be removed in 2023, as HPE has promised support for HP-UX 11.23
+   (aka HP-UX 11i v2) only through the end of 2022; see Table 2 of
+   <https://h20195.www2.hpe.com/V2/getpdf.aspx/4AA4-7673ENW.pdf>.  */
+#ifdef __hpux
+# undef UINT_LEAST8_MAX
+# undef UINT_LEAST16_MAX
+# define UINT_LEAST8_MAX 255
+# define UINT_LEAST16_MAX 65535
+#endif
+
+#if defined __UINT_LEAST8_MAX__ && __UINT_LEAST8_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST8_TYPE__ yytype_uint8;
+#elif (!defined __UINT_LEAST8_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST8_MAX <= INT_MAX)
+typedef uint_least8_t yytype_uint8;
+#elif !defined __UINT_LEAST8_MAX__ && UCHAR_MAX <= INT_MAX
+typedef unsigned char yytype_uint8;
+#else
+typedef short yytype_uint8;
+#endif
+
+#if defined __UINT_LEAST16_MAX__ && __UINT_LEAST16_MAX__ <= __INT_MAX__
+typedef __UINT_LEAST16_TYPE__ yytype_uint16;
+#elif (!defined __UINT_LEAST16_MAX__ && defined YY_STDINT_H \
+       && UINT_LEAST16_MAX <= INT_MAX)
+typedef uint_least16_t yytype_uint16;
+#elif !defined __UINT_LEAST16_MAX__ && USHRT_MAX <= INT_MAX
+typedef unsigned short yytype_uint16;
+#else
+typedef int yytype_uint16;
+#endif
+
+#ifndef YYPTRDIFF_T
+# if defined __PTRDIFF_TYPE__ && defined __PTRDIFF_MAX__
+#  define YYPTRDIFF_T __PTRDIFF_TYPE__
+#  define YYPTRDIFF_MAXIMUM __PTRDIFF_MAX__
+# elif defined PTRDIFF_MAX
+#  ifndef ptrdiff_t
+#   include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  endif
+#  define YYPTRDIFF_T ptrdiff_t
+#  define YYPTRDIFF_MAXIMUM PTRDIFF_MAX
+# else
+#  define YYPTRDIFF_T long
+#  define YYPTRDIFF_MAXIMUM LONG_MAX
+# endif
+#endif
+
+#ifndef YYSIZE_T
+# ifdef __SIZE_TYPE__
+#  define YYSIZE_T __SIZE_TYPE__
+# elif defined size_t
+#  define YYSIZE_T size_t
+# elif defined __STDC_VERSION__ && 199901 <= __STDC_VERSION__
+#  include <stddef.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYSIZE_T size_t
+# else
+#  define YYSIZE_T unsigned
+# endif
+#endif
+
+#define YYSIZE_MAXIMUM                                  \
+  YY_CAST (YYPTRDIFF_T,                                 \
+           (YYPTRDIFF_MAXIMUM < YY_CAST (YYSIZE_T, -1)  \
+            ? YYPTRDIFF_MAXIMUM                         \
+            : YY_CAST (YYSIZE_T, -1)))
+
+#define YYSIZEOF(X) YY_CAST (YYPTRDIFF_T, sizeof (X))
+
+
+/* Stored state numbers (used for stacks). */
+typedef yytype_int16 yy_state_t;
+
+/* State numbers in computations.  */
+typedef int yy_state_fast_t;
+
+#ifndef YY_
+# if defined YYENABLE_NLS && YYENABLE_NLS
+#  if ENABLE_NLS
+#   include <libintl.h> /* INFRINGES ON USER NAME SPACE */
+#   define YY_(Msgid) dgettext ("bison-runtime", Msgid)
+#  endif
+# endif
+# ifndef YY_
+#  define YY_(Msgid) Msgid
+# endif
+#endif
+
+
+#ifndef YY_ATTRIBUTE_PURE
+# if defined __GNUC__ && 2 < __GNUC__ + (96 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_PURE __attribute__ ((__pure__))
+# else
+#  define YY_ATTRIBUTE_PURE
+# endif
+#endif
+
+#ifndef YY_ATTRIBUTE_UNUSED
+# if defined __GNUC__ && 2 < __GNUC__ + (7 <= __GNUC_MINOR__)
+#  define YY_ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+# else
+#  define YY_ATTRIBUTE_UNUSED
+# endif
+#endif
+
+/* Suppress unused-variable warnings by "using" E.  */
+#if ! defined lint || defined __GNUC__
+# define YY_USE(E) ((void) (E))
+#else
+# define YY_USE(E) /* empty */
+#endif
+
+/* Suppress an incorrect diagnostic about yylval being uninitialized.  */
+#if defined __GNUC__ && ! defined __ICC && 406 <= __GNUC__ * 100 + __GNUC_MINOR__
+# if __GNUC__ * 100 + __GNUC_MINOR__ < 407
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")
+# else
+#  define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN                           \
+    _Pragma ("GCC diagnostic push")                                     \
+    _Pragma ("GCC diagnostic ignored \"-Wuninitialized\"")              \
+    _Pragma ("GCC diagnostic ignored \"-Wmaybe-uninitialized\"")
+# endif
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END      \
+    _Pragma ("GCC diagnostic pop")
+#else
+# define YY_INITIAL_VALUE(Value) Value
+#endif
+#ifndef YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+# define YY_IGNORE_MAYBE_UNINITIALIZED_END
+#endif
+#ifndef YY_INITIAL_VALUE
+# define YY_INITIAL_VALUE(Value) /* Nothing. */
+#endif
+
+#if defined __cplusplus && defined __GNUC__ && ! defined __ICC && 6 <= __GNUC__
+# define YY_IGNORE_USELESS_CAST_BEGIN                          \
+    _Pragma ("GCC diagnostic push")                            \
+    _Pragma ("GCC diagnostic ignored \"-Wuseless-cast\"")
+# define YY_IGNORE_USELESS_CAST_END            \
+    _Pragma ("GCC diagnostic pop")
+#endif
+#ifndef YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_BEGIN
+# define YY_IGNORE_USELESS_CAST_END
+#endif
+
+
+#define YY_ASSERT(E) ((void) (0 && (E)))
+
+#if !defined yyoverflow
+
+/* The parser invokes alloca or malloc; define the necessary symbols.  */
+
+# ifdef YYSTACK_USE_ALLOCA
+#  if YYSTACK_USE_ALLOCA
+#   ifdef __GNUC__
+#    define YYSTACK_ALLOC __builtin_alloca
+#   elif defined __BUILTIN_VA_ARG_INCR
+#    include <alloca.h> /* INFRINGES ON USER NAME SPACE */
+#   elif defined _AIX
+#    define YYSTACK_ALLOC __alloca
+#   elif defined _MSC_VER
+#    include <malloc.h> /* INFRINGES ON USER NAME SPACE */
+#    define alloca _alloca
+#   else
+#    define YYSTACK_ALLOC alloca
+#    if ! defined _ALLOCA_H && ! defined EXIT_SUCCESS
+#     include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+      /* Use EXIT_SUCCESS as a witness for stdlib.h.  */
+#     ifndef EXIT_SUCCESS
+#      define EXIT_SUCCESS 0
+#     endif
+#    endif
+#   endif
+#  endif
+# endif
+
+# ifdef YYSTACK_ALLOC
+   /* Pacify GCC's 'empty if-body' warning.  */
+#  define YYSTACK_FREE(Ptr) do { /* empty */; } while (0)
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+    /* The OS might guarantee only one guard page at the bottom of the stack,
+       and a page size can be as small as 4096 bytes.  So we cannot safely
+       invoke alloca (N) if N exceeds 4096.  Use a slightly smaller number
+       to allow for a few compiler-allocated temporary stack slots.  */
+#   define YYSTACK_ALLOC_MAXIMUM 4032 /* reasonable circa 2006 */
+#  endif
+# else
+#  define YYSTACK_ALLOC YYMALLOC
+#  define YYSTACK_FREE YYFREE
+#  ifndef YYSTACK_ALLOC_MAXIMUM
+#   define YYSTACK_ALLOC_MAXIMUM YYSIZE_MAXIMUM
+#  endif
+#  if (defined __cplusplus && ! defined EXIT_SUCCESS \
+       && ! ((defined YYMALLOC || defined malloc) \
+             && (defined YYFREE || defined free)))
+#   include <stdlib.h> /* INFRINGES ON USER NAME SPACE */
+#   ifndef EXIT_SUCCESS
+#    define EXIT_SUCCESS 0
+#   endif
+#  endif
+#  ifndef YYMALLOC
+#   define YYMALLOC malloc
+#   if ! defined malloc && ! defined EXIT_SUCCESS
+void *malloc (YYSIZE_T); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+#  ifndef YYFREE
+#   define YYFREE free
+#   if ! defined free && ! defined EXIT_SUCCESS
+void free (void *); /* INFRINGES ON USER NAME SPACE */
+#   endif
+#  endif
+# endif
+#endif /* !defined yyoverflow */
+
+#if (! defined yyoverflow \
+     && (! defined __cplusplus \
+         || (defined YYSTYPE_IS_TRIVIAL && YYSTYPE_IS_TRIVIAL)))
+
+/* A type that is properly aligned for any stack member.  */
+union yyalloc
+{
+  yy_state_t yyss_alloc;
+  YYSTYPE yyvs_alloc;
+};
+
+/* The size of the maximum gap between one aligned stack and the next.  */
+# define YYSTACK_GAP_MAXIMUM (YYSIZEOF (union yyalloc) - 1)
+
+/* The size of an array large to enough to hold all stacks, each with
+   N elements.  */
+# define YYSTACK_BYTES(N) \
+     ((N) * (YYSIZEOF (yy_state_t) + YYSIZEOF (YYSTYPE)) \
+      + YYSTACK_GAP_MAXIMUM)
+
+# define YYCOPY_NEEDED 1
+
+/* Relocate STACK from its old location to the new one.  The
+   local variables YYSIZE and YYSTACKSIZE give the old and new number of
+   elements in the stack, and YYPTR gives the new location of the
+   stack.  Advance YYPTR to a properly aligned location for the next
+   stack.  */
+# define YYSTACK_RELOCATE(Stack_alloc, Stack)                           \
+    do                                                                  \
+      {                                                                 \
+        YYPTRDIFF_T yynewbytes;                                         \
+        YYCOPY (&yyptr->Stack_alloc, Stack, yysize);                    \
+        Stack = &yyptr->Stack_alloc;                                    \
+        yynewbytes = yystacksize * YYSIZEOF (*Stack) + YYSTACK_GAP_MAXIMUM; \
+        yyptr += yynewbytes / YYSIZEOF (*yyptr);                        \
+      }                                                                 \
+    while (0)
+
+#endif
+
+#if defined YYCOPY_NEEDED && YYCOPY_NEEDED
+/* Copy COUNT objects from SRC to DST.  The source and destination do
+   not overlap.  */
+# ifndef YYCOPY
+#  if defined __GNUC__ && 1 < __GNUC__
+#   define YYCOPY(Dst, Src, Count) \
+      __builtin_memcpy (Dst, Src, YY_CAST (YYSIZE_T, (Count)) * sizeof (*(Src)))
+#  else
+#   define YYCOPY(Dst, Src, Count)              \
+      do                                        \
+        {                                       \
+          YYPTRDIFF_T yyi;                      \
+          for (yyi = 0; yyi < (Count); yyi++)   \
+            (Dst)[yyi] = (Src)[yyi];            \
+        }                                       \
+      while (0)
+#  endif
+# endif
+#endif /* !YYCOPY_NEEDED */
+
+/* YYFINAL -- State number of the termination state.  */
+#define YYFINAL  47
+/* YYLAST -- Last index in YYTABLE.  */
+#define YYLAST   1041
+
+/* YYNTOKENS -- Number of terminals.  */
+#define YYNTOKENS  85
+/* YYNNTS -- Number of nonterminals.  */
+#define YYNNTS  43
+/* YYNRULES -- Number of rules.  */
+#define YYNRULES  165
+/* YYNSTATES -- Number of states.  */
+#define YYNSTATES  319
+
+/* YYMAXUTOK -- Last valid token kind.  */
+#define YYMAXUTOK   339
+
+
+/* YYTRANSLATE(TOKEN-NUM) -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex, with out-of-bounds checking.  */
+#define YYTRANSLATE(YYX)                                \
+  (0 <= (YYX) && (YYX) <= YYMAXUTOK                     \
+   ? YY_CAST (yysymbol_kind_t, yytranslate[YYX])        \
+   : YYSYMBOL_YYUNDEF)
+
+/* YYTRANSLATE[TOKEN-NUM] -- Symbol number corresponding to TOKEN-NUM
+   as returned by yylex.  */
+static const yytype_int8 yytranslate[] =
+{
+       0,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     2,     2,     1,     2,     3,     4,
+       5,     6,     7,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    21,    22,    23,    24,
+      25,    26,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    36,    37,    38,    39,    40,    41,    42,    43,    44,
+      45,    46,    47,    48,    49,    50,    51,    52,    53,    54,
+      55,    56,    57,    58,    59,    60,    61,    62,    63,    64,
+      65,    66,    67,    68,    69,    70,    71,    72,    73,    74,
+      75,    76,    77,    78,    79,    80,    81,    82,    83,    84
+};
+
+#if YYDEBUG
+/* YYRLINE[YYN] -- Source line where rule number YYN was defined.  */
+static const yytype_int16 yyrline[] =
+{
+       0,    76,    76,    81,    88,    89,    90,    91,    92,    93,
+     102,   111,   120,   134,   143,   144,   145,   146,   147,   153,
+     154,   155,   156,   157,   158,   159,   160,   161,   162,   163,
+     164,   165,   166,   167,   168,   172,   177,   184,   188,   192,
+     198,   207,   211,   215,   225,   230,   241,   249,   252,   259,
+     260,   261,   265,   269,   276,   279,   285,   289,   296,   297,
+     298,   299,   300,   301,   302,   306,   311,   318,   321,   328,
+     333,   339,   347,   352,   357,   363,   370,   376,   386,   389,
+     393,   396,   399,   406,   407,   414,   415,   419,   423,   427,
+     431,   435,   439,   443,   447,   451,   455,   462,   463,   472,
+     473,   479,   480,   486,   487,   493,   494,   500,   501,   507,
+     508,   511,   517,   518,   521,   524,   527,   533,   534,   537,
+     543,   544,   547,   553,   554,   557,   560,   566,   567,   572,
+     577,   580,   583,   586,   589,   592,   595,   601,   602,   606,
+     611,   616,   621,   626,   629,   635,   639,   646,   650,   653,
+     656,   659,   663,   669,   676,   680,   689,   696,   703,   709,
+     719,   723,   730,   738,   745,   749
+};
+#endif
+
+/** Accessing symbol of state STATE.  */
+#define YY_ACCESSING_SYMBOL(State) YY_CAST (yysymbol_kind_t, yystos[State])
+
+#if YYDEBUG || 0
+/* The user-facing name of the symbol whose (internal) number is
+   YYSYMBOL.  No bounds checking.  */
+static const char *yysymbol_name (yysymbol_kind_t yysymbol) YY_ATTRIBUTE_UNUSED;
+
+/* YYTNAME[SYMBOL-NUM] -- String name of the symbol SYMBOL-NUM.
+   First, the terminals, then, starting at YYNTOKENS, nonterminals.  */
+static const char *const yytname[] =
+{
+  "\"end of file\"", "error", "\"invalid token\"", "IDENTIFIER",
+  "INTEGER_CONSTANT", "FLOATING_CONSTANT", "FLOATING_CONSTANT_F",
+  "CHARACTER_CONSTANT", "STRING_LITERAL", "INT", "FLOAT", "CHAR", "VOID",
+  "SHORT", "LONG", "DOUBLE", "UNSIGNED", "STRUCT", "UNION", "STATIC",
+  "EXTERN", "TYPEDEF", "ENUM", "SIZEOF", "RETURN", "IF", "ELSE", "WHILE",
+  "DO", "FOR", "SWITCH", "CASE", "DEFAULT", "BREAK", "CONTINUE", "ASM",
+  "CONST", "VOLATILE", "INLINE", "SEMICOLON", "LBRACE", "RBRACE", "COMMA",
+  "LPAREN", "RPAREN", "LBRACKET", "RBRACKET", "ASSIGN", "ADD_ASSIGN",
+  "SUB_ASSIGN", "MUL_ASSIGN", "DIV_ASSIGN", "MOD_ASSIGN", "AND_ASSIGN",
+  "OR_ASSIGN", "XOR_ASSIGN", "LEFT_ASSIGN", "RIGHT_ASSIGN", "PLUS",
+  "MINUS", "STAR", "SLASH", "PERCENT", "AMPERSAND", "LT", "GT", "LE_OP",
+  "GE_OP", "EQ_OP", "NE_OP", "LEFT_SHIFT", "RIGHT_SHIFT", "AND_OP",
+  "OR_OP", "NOT_OP", "PIPE", "XOR", "TILDE", "DOT", "ARROW", "INC_OP",
+  "DEC_OP", "QUESTION", "COLON", "ELLIPSIS", "$accept", "program",
+  "external_declaration", "function_definition", "declaration_specifiers",
+  "declarator", "parameter_list", "parameter_declaration", "declaration",
+  "init_declarator", "initializer", "initializer_list",
+  "compound_statement", "statement_list", "statement", "labeled_statement",
+  "expression_statement", "selection_statement", "iteration_statement",
+  "jump_statement", "expression", "assignment_expression",
+  "conditional_expression", "logical_or_expression",
+  "logical_and_expression", "bitwise_or_expression",
+  "bitwise_xor_expression", "bitwise_and_expression",
+  "equality_expression", "relational_expression", "shift_expression",
+  "additive_expression", "multiplicative_expression", "unary_expression",
+  "postfix_expression", "argument_expression_list", "primary_expression",
+  "struct_specifier", "enum_specifier", "enumerator_list",
+  "struct_declaration_list", "struct_declaration", "union_specifier", YY_NULLPTR
+};
+
+static const char *
+yysymbol_name (yysymbol_kind_t yysymbol)
+{
+  return yytname[yysymbol];
+}
+#endif
+
+#define YYPACT_NINF (-144)
+
+#define yypact_value_is_default(Yyn) \
+  ((Yyn) == YYPACT_NINF)
+
+#define YYTABLE_NINF (-19)
+
+#define yytable_value_is_error(Yyn) \
+  0
+
+/* YYPACT[STATE-NUM] -- Index in YYTABLE of the portion describing
+   STATE-NUM.  */
+static const yytype_int16 yypact[] =
+{
+     973,  -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,
+      19,    22,   110,   153,   120,    28,  1003,   877,  -144,  -144,
+       6,  -144,   -28,   -10,    24,    35,  1003,    54,  1003,  -144,
+    -144,  -144,  -144,  1003,  -144,  -144,  -144,  -144,   157,   166,
+     195,   199,    87,   211,  -144,  -144,  -144,  -144,  -144,  -144,
+       6,   114,   117,  -144,  -144,  -144,  1003,     6,   423,  -144,
+    1003,   501,  -144,   183,   189,   214,   224,   211,  -144,    63,
+     -39,   227,   841,     9,   591,  -144,  -144,   907,    64,  -144,
+    -144,   940,  -144,  -144,  -144,  -144,  -144,    72,  -144,   231,
+       4,  -144,  -144,  -144,  -144,   221,   634,   226,   230,   385,
+     233,   234,   768,   196,   241,   244,   242,  -144,  -144,   768,
+     768,   768,   768,   768,   768,   768,   768,     6,  -144,  -144,
+     306,  -144,  -144,  -144,  -144,  -144,  -144,   -15,  -144,  -144,
+     -50,   212,   213,   215,   229,   125,   141,   149,   167,    89,
+     303,    37,  -144,  -144,     7,    10,  -144,   243,  -144,  -144,
+     591,  -144,  -144,  -144,  -144,  -144,  -144,  -144,   543,  -144,
+      45,   768,   768,   266,   464,   768,   216,  -144,   385,  -144,
+    -144,   286,    66,  -144,  -144,  -144,  -144,  -144,  -144,  -144,
+      81,  -144,  -144,  -144,   768,   768,   768,   768,   768,   768,
+     768,   768,   768,   768,   768,   768,   768,   768,   768,   768,
+     768,   768,   768,   768,   768,   768,   768,   768,   768,   768,
+     768,   768,   768,   768,   768,   658,   768,   292,   293,  -144,
+    -144,  -144,   -39,    27,  -144,  -144,  -144,   207,   253,   254,
+    -144,   103,   111,   257,   681,   681,   124,   385,  -144,   258,
+    -144,  -144,   212,   -34,   213,   215,   229,   125,   141,   141,
+     149,   149,   149,   149,   167,   167,    89,    89,  -144,  -144,
+    -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,  -144,
+    -144,  -144,  -144,  -144,   128,    44,  -144,  -144,  -144,  -144,
+    -144,   567,  -144,  -144,   385,   385,   768,   722,   745,   385,
+    -144,   264,   768,   768,  -144,  -144,  -144,  -144,   279,  -144,
+     148,   385,   159,   385,   173,  -144,  -144,  -144,  -144,   385,
+     267,  -144,   385,  -144,   385,  -144,  -144,  -144,  -144
+};
+
+/* YYDEFACT[STATE-NUM] -- Default reduction number in state STATE-NUM.
+   Performed when YYTABLE does not specify something else to do.  Zero
+   means the default is an error.  */
+static const yytype_uint8 yydefact[] =
+{
+       0,    18,    14,    15,    16,    17,    19,    20,    21,    22,
+       0,     0,     0,     0,     0,     0,     0,     0,     2,     4,
+       0,     5,    23,     0,    24,   155,     0,   165,     0,    25,
+      26,    27,    28,     0,    29,    30,    31,    32,     0,     0,
+       0,     0,     0,     0,    33,    23,    24,     1,     3,    35,
+       0,    47,     0,     6,     8,     7,     0,     0,     0,   160,
+       0,     0,    34,     0,     0,     0,     0,     0,   158,     0,
+      36,     0,     0,     0,     0,    13,    46,     0,     0,   154,
+     161,     0,   164,    12,     9,    10,    11,     0,   157,     0,
+     147,   148,   149,   150,   151,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    67,    54,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,    58,    60,
+       0,    56,    64,    59,    61,    62,    63,     0,    83,    85,
+      97,    99,   101,   103,   105,   107,   109,   112,   117,   120,
+     123,   127,   137,    37,     0,     0,    41,     0,    40,   147,
+       0,    48,    49,   153,   162,   163,   156,   159,     0,    78,
+       0,     0,     0,     0,     0,     0,     0,   123,     0,    80,
+      81,     0,     0,   133,   135,   134,   132,   136,   130,   131,
+      47,    55,    57,    68,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,   143,
+     144,    35,    44,     0,    38,    39,    52,     0,     0,     0,
+      79,     0,     0,     0,     0,     0,     0,     0,    66,     0,
+     152,    84,   100,     0,   102,   104,   106,   108,   110,   111,
+     113,   114,   115,   116,   118,   119,   121,   122,   124,   125,
+     126,    86,    87,    88,    89,    90,    91,    92,    93,    94,
+      95,    96,   138,   145,     0,     0,   141,   142,    43,    42,
+      50,     0,   128,   129,     0,     0,     0,     0,     0,     0,
+      65,     0,     0,     0,   139,   140,    51,    53,    69,    72,
+       0,     0,     0,     0,     0,    71,    82,    98,   146,     0,
+       0,    76,     0,    74,     0,    70,    73,    77,    75
+};
+
+/* YYPGOTO[NTERM-NUM].  */
+static const yytype_int16 yypgoto[] =
+{
+    -144,  -144,   296,  -144,     0,   -38,  -144,   104,     3,  -144,
+    -135,  -144,   277,  -144,   -85,  -144,  -143,  -144,  -144,  -144,
+     -91,   -72,  -101,  -144,   147,   155,   160,   154,   171,    80,
+      17,    77,    82,   -14,  -144,  -144,  -144,    34,  -144,   295,
+      29,    -8,    76
+};
+
+/* YYDEFGOTO[NTERM-NUM].  */
+static const yytype_int16 yydefgoto[] =
+{
+       0,    17,    18,    19,   117,    51,   145,   146,   118,    52,
+     151,   227,   119,   120,   121,   122,   123,   124,   125,   126,
+     127,   128,   129,   130,   131,   132,   133,   134,   135,   136,
+     137,   138,   139,   140,   141,   274,   142,    45,    23,    69,
+      58,    59,    46
+};
+
+/* YYTABLE[YYPACT[STATE-NUM]] -- What to do in state STATE-NUM.  If
+   positive, shift that token.  If negative, reduce the rule whose
+   number is the opposite.  If YYTABLE_NINF, syntax error.  */
+static const yytype_int16 yytable[] =
+{
+      20,   166,   152,    21,    72,   160,    73,   -18,   184,    49,
+     221,    53,    70,   147,   163,   226,    44,    20,   172,    78,
+      21,   235,    25,   185,   183,    27,    57,   184,    57,    54,
+       1,    42,   186,    62,    22,   182,     2,     3,     4,     5,
+       6,     7,     8,     9,    10,    11,    12,    13,   -18,   292,
+      80,    22,   223,    80,   224,   148,    57,    61,    57,    26,
+      57,    57,    28,    55,   -18,    16,    50,    50,    43,    80,
+     231,   232,   144,    80,   236,    56,    24,    57,   152,   180,
+     215,    57,   216,   238,   230,    77,   184,   184,   167,    81,
+     295,   287,   288,    24,    60,   243,   173,   174,   175,   176,
+     177,   178,   179,   154,    88,    89,   222,    72,   184,    73,
+     240,   278,   241,   156,    89,   217,   218,   219,   220,    29,
+      30,    31,    32,    38,    72,   275,    73,    67,    74,    39,
+      40,    41,   261,   262,   263,   264,   265,   266,   267,   268,
+     269,   270,   271,   273,   229,   184,   297,   284,    33,   201,
+     202,   203,   290,   184,    71,   285,    76,    72,   228,    73,
+      63,    74,    34,    35,    36,    37,   184,   234,   289,    64,
+     293,   167,   294,   167,   167,   167,   167,   167,   167,   167,
+     167,   167,   167,   167,   167,   167,   167,   258,   259,   260,
+     184,   307,   310,   191,   192,   300,   302,   304,    65,   298,
+     299,   184,    66,   312,   305,   193,   194,   195,   196,   152,
+     250,   251,   252,   253,    68,   184,   311,   314,   313,   197,
+     198,   308,    83,   144,   315,   199,   200,   317,    84,   318,
+      90,    91,    92,    93,   157,    94,     2,     3,     4,     5,
+       6,     7,     8,     9,    10,    11,    12,    13,   280,   281,
+      95,    96,    97,    85,    98,    99,   100,   101,   102,   103,
+     104,   105,   106,    86,   158,    16,   107,    71,   108,   161,
+     109,   248,   249,   162,   254,   255,   164,   165,   167,   168,
+     169,   256,   257,   170,   187,   171,   110,   111,   188,   225,
+     112,   189,   190,   233,   239,   276,   277,   282,   283,   237,
+     286,   113,   291,   306,   114,   309,   316,   115,   116,    90,
+      91,    92,    93,    48,    94,     2,     3,     4,     5,     6,
+       7,     8,     9,    10,    11,    12,    13,   279,    75,    95,
+      96,    97,   242,    98,    99,   100,   101,   102,   103,   104,
+     105,   106,   244,   246,    16,   107,    71,   181,   245,   109,
+     204,   205,   206,   207,   208,   209,   210,   211,   212,   213,
+     214,   247,    87,     0,     0,   110,   111,     0,     0,   112,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+     113,     0,     0,   114,     0,     0,   115,   116,    90,    91,
+      92,    93,     0,    94,     2,     3,     4,     5,     6,     7,
+       8,     9,    10,    11,    12,    13,     0,     0,    95,    96,
+      97,     0,    98,    99,   100,   101,   102,   103,   104,   105,
+     106,     0,     0,    16,   107,    71,     1,     0,   109,     0,
+       0,     0,     2,     3,     4,     5,     6,     7,     8,     9,
+      10,    11,    12,    13,   110,   111,     0,     0,   112,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,   113,
+       0,    16,   114,     0,    79,   115,   116,    90,    91,    92,
+      93,     0,    94,     2,     3,     4,     5,     6,     7,     8,
+       9,    10,    11,    12,    13,     0,     0,    95,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,    16,   107,     1,     0,     0,   109,     0,     0,
+       2,     3,     4,     5,     6,     7,     8,     9,    10,    11,
+      12,    13,     0,   110,   111,     0,     0,   112,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,   113,    16,
+       0,   114,    82,     0,   115,   116,    90,    91,    92,    93,
+       0,    94,     2,     3,     4,     5,     6,     7,     8,     9,
+      10,    11,    12,    13,     0,     0,    95,     0,     0,     0,
+     149,    91,    92,    93,     0,    94,     0,     0,     0,     0,
+       0,    16,     0,     0,     0,     0,   109,     0,     0,     0,
+      95,     0,     0,     0,   149,    91,    92,    93,     0,    94,
+       0,     0,   110,   111,     0,     0,   112,   150,   296,     0,
+     109,     0,     0,     0,    95,     0,     0,   113,     0,     0,
+     114,     0,     0,   115,   116,     0,   110,   111,     0,     0,
+     112,   150,     0,     0,   109,     0,     0,   149,    91,    92,
+      93,   113,    94,     0,   114,     0,     0,   115,   116,     0,
+     110,   111,     0,     0,   112,     0,     0,    95,     0,     0,
+       0,   149,    91,    92,    93,   113,    94,     0,   114,     0,
+       0,   115,   116,   159,     0,     0,     0,   109,     0,     0,
+       0,    95,     0,     0,   149,    91,    92,    93,     0,    94,
+       0,     0,     0,   110,   111,     0,     0,   112,     0,     0,
+       0,   109,   272,     0,    95,     0,     0,     0,   113,     0,
+       0,   114,     0,     0,   115,   116,     0,   110,   111,     0,
+     107,   112,     0,     0,   109,   149,    91,    92,    93,     0,
+      94,     0,   113,     0,     0,   114,     0,     0,   115,   116,
+     110,   111,     0,     0,   112,    95,     0,     0,   149,    91,
+      92,    93,     0,    94,     0,   113,     0,     0,   114,     0,
+       0,   115,   116,     0,     0,   109,   301,     0,    95,     0,
+       0,   149,    91,    92,    93,     0,    94,     0,     0,     0,
+       0,   110,   111,     0,     0,   112,     0,     0,   109,   303,
+       0,    95,     0,     0,     0,     0,   113,     0,     0,   114,
+       0,     0,   115,   116,   110,   111,     0,     0,   112,     0,
+       0,   109,     0,     0,     0,     0,     0,     0,     0,   113,
+       0,     0,   114,     0,     0,   115,   116,   110,   111,     0,
+       0,   112,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,   113,     0,     1,   114,     0,     0,   115,   116,
+       2,     3,     4,     5,     6,     7,     8,     9,    10,    11,
+      12,    13,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,    47,     0,    16,
+       1,     0,     0,     0,     0,   143,     2,     3,     4,     5,
+       6,     7,     8,     9,    10,    11,    12,    13,    14,    15,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       1,     0,     0,     0,     0,    16,     2,     3,     4,     5,
+       6,     7,     8,     9,    10,    11,    12,    13,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     1,     0,    16,     0,     0,   153,     2,
+       3,     4,     5,     6,     7,     8,     9,    10,    11,    12,
+      13,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     1,     0,    16,     0,
+       0,   155,     2,     3,     4,     5,     6,     7,     8,     9,
+      10,    11,    12,    13,    14,    15,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     1,     0,     0,     0,
+       0,    16,     2,     3,     4,     5,     6,     7,     8,     9,
+      10,    11,    12,    13,     0,     0,     0,     0,     0,     0,
+       0,     0,     0,     0,     0,     0,     0,     0,     0,     0,
+       0,    16
+};
+
+static const yytype_int16 yycheck[] =
+{
+       0,   102,    74,     0,    43,    96,    45,     3,    42,     3,
+       3,    39,    50,     4,    99,   150,    16,    17,   109,    57,
+      17,   164,     3,    73,    39,     3,    26,    42,    28,    39,
+       3,     3,    82,    33,     0,   120,     9,    10,    11,    12,
+      13,    14,    15,    16,    17,    18,    19,    20,    44,    83,
+      58,    17,    42,    61,    44,    46,    56,    28,    58,    40,
+      60,    61,    40,    39,    60,    38,    60,    60,    40,    77,
+     161,   162,    72,    81,   165,    40,     0,    77,   150,   117,
+      43,    81,    45,   168,    39,    56,    42,    42,   102,    60,
+      46,   234,   235,    17,    40,   186,   110,   111,   112,   113,
+     114,   115,   116,    39,    41,    42,   144,    43,    42,    45,
+      44,    84,   184,    41,    42,    78,    79,    80,    81,     9,
+      10,    11,    12,     3,    43,   216,    45,    40,    47,     9,
+      10,    11,   204,   205,   206,   207,   208,   209,   210,   211,
+     212,   213,   214,   215,   158,    42,   281,    44,    38,    60,
+      61,    62,   237,    42,    40,    44,    39,    43,   158,    45,
+       3,    47,     9,    10,    11,    12,    42,   164,    44,     3,
+      42,   185,    44,   187,   188,   189,   190,   191,   192,   193,
+     194,   195,   196,   197,   198,   199,   200,   201,   202,   203,
+      42,   292,    44,    68,    69,   286,   287,   288,     3,   284,
+     285,    42,     3,    44,   289,    64,    65,    66,    67,   281,
+     193,   194,   195,   196,     3,    42,   301,    44,   303,    70,
+      71,   293,    39,   223,   309,    58,    59,   312,    39,   314,
+       3,     4,     5,     6,     3,     8,     9,    10,    11,    12,
+      13,    14,    15,    16,    17,    18,    19,    20,    41,    42,
+      23,    24,    25,    39,    27,    28,    29,    30,    31,    32,
+      33,    34,    35,    39,    43,    38,    39,    40,    41,    43,
+      43,   191,   192,    43,   197,   198,    43,    43,   292,    83,
+      39,   199,   200,    39,    72,    43,    59,    60,    75,    46,
+      63,    76,    63,    27,     8,     3,     3,    44,    44,    83,
+      43,    74,    44,    39,    77,    26,    39,    80,    81,     3,
+       4,     5,     6,    17,     8,     9,    10,    11,    12,    13,
+      14,    15,    16,    17,    18,    19,    20,   223,    51,    23,
+      24,    25,   185,    27,    28,    29,    30,    31,    32,    33,
+      34,    35,   187,   189,    38,    39,    40,    41,   188,    43,
+      47,    48,    49,    50,    51,    52,    53,    54,    55,    56,
+      57,   190,    67,    -1,    -1,    59,    60,    -1,    -1,    63,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      74,    -1,    -1,    77,    -1,    -1,    80,    81,     3,     4,
+       5,     6,    -1,     8,     9,    10,    11,    12,    13,    14,
+      15,    16,    17,    18,    19,    20,    -1,    -1,    23,    24,
+      25,    -1,    27,    28,    29,    30,    31,    32,    33,    34,
+      35,    -1,    -1,    38,    39,    40,     3,    -1,    43,    -1,
+      -1,    -1,     9,    10,    11,    12,    13,    14,    15,    16,
+      17,    18,    19,    20,    59,    60,    -1,    -1,    63,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    74,
+      -1,    38,    77,    -1,    41,    80,    81,     3,     4,     5,
+       6,    -1,     8,     9,    10,    11,    12,    13,    14,    15,
+      16,    17,    18,    19,    20,    -1,    -1,    23,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    38,    39,     3,    -1,    -1,    43,    -1,    -1,
+       9,    10,    11,    12,    13,    14,    15,    16,    17,    18,
+      19,    20,    -1,    59,    60,    -1,    -1,    63,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    74,    38,
+      -1,    77,    41,    -1,    80,    81,     3,     4,     5,     6,
+      -1,     8,     9,    10,    11,    12,    13,    14,    15,    16,
+      17,    18,    19,    20,    -1,    -1,    23,    -1,    -1,    -1,
+       3,     4,     5,     6,    -1,     8,    -1,    -1,    -1,    -1,
+      -1,    38,    -1,    -1,    -1,    -1,    43,    -1,    -1,    -1,
+      23,    -1,    -1,    -1,     3,     4,     5,     6,    -1,     8,
+      -1,    -1,    59,    60,    -1,    -1,    63,    40,    41,    -1,
+      43,    -1,    -1,    -1,    23,    -1,    -1,    74,    -1,    -1,
+      77,    -1,    -1,    80,    81,    -1,    59,    60,    -1,    -1,
+      63,    40,    -1,    -1,    43,    -1,    -1,     3,     4,     5,
+       6,    74,     8,    -1,    77,    -1,    -1,    80,    81,    -1,
+      59,    60,    -1,    -1,    63,    -1,    -1,    23,    -1,    -1,
+      -1,     3,     4,     5,     6,    74,     8,    -1,    77,    -1,
+      -1,    80,    81,    39,    -1,    -1,    -1,    43,    -1,    -1,
+      -1,    23,    -1,    -1,     3,     4,     5,     6,    -1,     8,
+      -1,    -1,    -1,    59,    60,    -1,    -1,    63,    -1,    -1,
+      -1,    43,    44,    -1,    23,    -1,    -1,    -1,    74,    -1,
+      -1,    77,    -1,    -1,    80,    81,    -1,    59,    60,    -1,
+      39,    63,    -1,    -1,    43,     3,     4,     5,     6,    -1,
+       8,    -1,    74,    -1,    -1,    77,    -1,    -1,    80,    81,
+      59,    60,    -1,    -1,    63,    23,    -1,    -1,     3,     4,
+       5,     6,    -1,     8,    -1,    74,    -1,    -1,    77,    -1,
+      -1,    80,    81,    -1,    -1,    43,    44,    -1,    23,    -1,
+      -1,     3,     4,     5,     6,    -1,     8,    -1,    -1,    -1,
+      -1,    59,    60,    -1,    -1,    63,    -1,    -1,    43,    44,
+      -1,    23,    -1,    -1,    -1,    -1,    74,    -1,    -1,    77,
+      -1,    -1,    80,    81,    59,    60,    -1,    -1,    63,    -1,
+      -1,    43,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    74,
+      -1,    -1,    77,    -1,    -1,    80,    81,    59,    60,    -1,
+      -1,    63,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    74,    -1,     3,    77,    -1,    -1,    80,    81,
+       9,    10,    11,    12,    13,    14,    15,    16,    17,    18,
+      19,    20,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,     0,    -1,    38,
+       3,    -1,    -1,    -1,    -1,    44,     9,    10,    11,    12,
+      13,    14,    15,    16,    17,    18,    19,    20,    21,    22,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+       3,    -1,    -1,    -1,    -1,    38,     9,    10,    11,    12,
+      13,    14,    15,    16,    17,    18,    19,    20,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,     3,    -1,    38,    -1,    -1,    41,     9,
+      10,    11,    12,    13,    14,    15,    16,    17,    18,    19,
+      20,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,     3,    -1,    38,    -1,
+      -1,    41,     9,    10,    11,    12,    13,    14,    15,    16,
+      17,    18,    19,    20,    21,    22,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,     3,    -1,    -1,    -1,
+      -1,    38,     9,    10,    11,    12,    13,    14,    15,    16,
+      17,    18,    19,    20,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,    -1,
+      -1,    38
+};
+
+/* YYSTOS[STATE-NUM] -- The symbol kind of the accessing symbol of
+   state STATE-NUM.  */
+static const yytype_int8 yystos[] =
+{
+       0,     3,     9,    10,    11,    12,    13,    14,    15,    16,
+      17,    18,    19,    20,    21,    22,    38,    86,    87,    88,
+      89,    93,   122,   123,   127,     3,    40,     3,    40,     9,
+      10,    11,    12,    38,     9,    10,    11,    12,     3,     9,
+      10,    11,     3,    40,    89,   122,   127,     0,    87,     3,
+      60,    90,    94,    39,    39,    39,    40,    89,   125,   126,
+      40,   125,    89,     3,     3,     3,     3,    40,     3,   124,
+      90,    40,    43,    45,    47,    97,    39,   125,    90,    41,
+     126,   125,    41,    39,    39,    39,    39,   124,    41,    42,
+       3,     4,     5,     6,     8,    23,    24,    25,    27,    28,
+      29,    30,    31,    32,    33,    34,    35,    39,    41,    43,
+      59,    60,    63,    74,    77,    80,    81,    89,    93,    97,
+      98,    99,   100,   101,   102,   103,   104,   105,   106,   107,
+     108,   109,   110,   111,   112,   113,   114,   115,   116,   117,
+     118,   119,   121,    44,    89,    91,    92,     4,    46,     3,
+      40,    95,   106,    41,    39,    41,    41,     3,    43,    39,
+     105,    43,    43,    99,    43,    43,   107,   118,    83,    39,
+      39,    43,   105,   118,   118,   118,   118,   118,   118,   118,
+      90,    41,    99,    39,    42,    73,    82,    72,    75,    76,
+      63,    68,    69,    64,    65,    66,    67,    70,    71,    58,
+      59,    60,    61,    62,    47,    48,    49,    50,    51,    52,
+      53,    54,    55,    56,    57,    43,    45,    78,    79,    80,
+      81,     3,    90,    42,    44,    46,    95,    96,    89,   118,
+      39,   105,   105,    27,    93,   101,   105,    83,    99,     8,
+      44,   106,   109,   105,   110,   111,   112,   113,   114,   114,
+     115,   115,   115,   115,   116,   116,   117,   117,   118,   118,
+     118,   106,   106,   106,   106,   106,   106,   106,   106,   106,
+     106,   106,    44,   106,   120,   105,     3,     3,    84,    92,
+      41,    42,    44,    44,    44,    44,    43,   101,   101,    44,
+      99,    44,    83,    42,    44,    46,    41,    95,    99,    99,
+     105,    44,   105,    44,   105,    99,    39,   107,   106,    26,
+      44,    99,    44,    99,    44,    99,    39,    99,    99
+};
+
+/* YYR1[RULE-NUM] -- Symbol kind of the left-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr1[] =
+{
+       0,    85,    86,    86,    87,    87,    87,    87,    87,    87,
+      87,    87,    87,    88,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    89,    89,    89,    89,    89,
+      89,    89,    89,    89,    89,    90,    90,    90,    90,    90,
+      90,    91,    91,    91,    92,    92,    93,    94,    94,    95,
+      95,    95,    96,    96,    97,    97,    98,    98,    99,    99,
+      99,    99,    99,    99,    99,   100,   100,   101,   101,   102,
+     102,   102,   103,   103,   103,   103,   103,   103,   104,   104,
+     104,   104,   104,   105,   105,   106,   106,   106,   106,   106,
+     106,   106,   106,   106,   106,   106,   106,   107,   107,   108,
+     108,   109,   109,   110,   110,   111,   111,   112,   112,   113,
+     113,   113,   114,   114,   114,   114,   114,   115,   115,   115,
+     116,   116,   116,   117,   117,   117,   117,   118,   118,   118,
+     118,   118,   118,   118,   118,   118,   118,   119,   119,   119,
+     119,   119,   119,   119,   119,   120,   120,   121,   121,   121,
+     121,   121,   121,   122,   122,   122,   123,   123,   124,   124,
+     125,   125,   126,   127,   127,   127
+};
+
+/* YYR2[RULE-NUM] -- Number of symbols on the right-hand side of rule RULE-NUM.  */
+static const yytype_int8 yyr2[] =
+{
+       0,     2,     1,     2,     1,     1,     2,     2,     2,     4,
+       4,     4,     4,     3,     1,     1,     1,     1,     1,     1,
+       1,     1,     1,     1,     1,     2,     2,     2,     2,     2,
+       2,     2,     2,     2,     3,     1,     2,     3,     4,     4,
+       3,     1,     3,     3,     2,     2,     3,     1,     3,     1,
+       3,     4,     1,     3,     2,     3,     1,     2,     1,     1,
+       1,     1,     1,     1,     1,     4,     3,     1,     2,     5,
+       7,     5,     5,     7,     6,     7,     6,     7,     2,     3,
+       2,     2,     5,     1,     3,     1,     3,     3,     3,     3,
+       3,     3,     3,     3,     3,     3,     3,     1,     5,     1,
+       3,     1,     3,     1,     3,     1,     3,     1,     3,     1,
+       3,     3,     1,     3,     3,     3,     3,     1,     3,     3,
+       1,     3,     3,     1,     3,     3,     3,     1,     4,     4,
+       2,     2,     2,     2,     2,     2,     2,     1,     3,     4,
+       4,     3,     3,     2,     2,     1,     3,     1,     1,     1,
+       1,     1,     3,     5,     4,     2,     5,     4,     1,     3,
+       1,     2,     3,     5,     4,     2
+};
+
+
+enum { YYENOMEM = -2 };
+
+#define yyerrok         (yyerrstatus = 0)
+#define yyclearin       (yychar = YYEMPTY)
+
+#define YYACCEPT        goto yyacceptlab
+#define YYABORT         goto yyabortlab
+#define YYERROR         goto yyerrorlab
+#define YYNOMEM         goto yyexhaustedlab
+
+
+#define YYRECOVERING()  (!!yyerrstatus)
+
+#define YYBACKUP(Token, Value)                                    \
+  do                                                              \
+    if (yychar == YYEMPTY)                                        \
+      {                                                           \
+        yychar = (Token);                                         \
+        yylval = (Value);                                         \
+        YYPOPSTACK (yylen);                                       \
+        yystate = *yyssp;                                         \
+        goto yybackup;                                            \
+      }                                                           \
+    else                                                          \
+      {                                                           \
+        yyerror (scanner, ast_root, YY_("syntax error: cannot back up")); \
+        YYERROR;                                                  \
+      }                                                           \
+  while (0)
+
+/* Backward compatibility with an undocumented macro.
+   Use YYerror or YYUNDEF. */
+#define YYERRCODE YYUNDEF
+
+
+/* Enable debugging if requested.  */
+#if YYDEBUG
+
+# ifndef YYFPRINTF
+#  include <stdio.h> /* INFRINGES ON USER NAME SPACE */
+#  define YYFPRINTF fprintf
+# endif
+
+# define YYDPRINTF(Args)                        \
+do {                                            \
+  if (yydebug)                                  \
+    YYFPRINTF Args;                             \
+} while (0)
+
+
+
+
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)                    \
+do {                                                                      \
+  if (yydebug)                                                            \
+    {                                                                     \
+      YYFPRINTF (stderr, "%s ", Title);                                   \
+      yy_symbol_print (stderr,                                            \
+                  Kind, Value, scanner, ast_root); \
+      YYFPRINTF (stderr, "\n");                                           \
+    }                                                                     \
+} while (0)
+
+
+/*-----------------------------------.
+| Print this symbol's value on YYO.  |
+`-----------------------------------*/
+
+static void
+yy_symbol_value_print (FILE *yyo,
+                       yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, yyscan_t scanner, ASTNode **ast_root)
+{
+  FILE *yyoutput = yyo;
+  YY_USE (yyoutput);
+  YY_USE (scanner);
+  YY_USE (ast_root);
+  if (!yyvaluep)
+    return;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+/*---------------------------.
+| Print this symbol on YYO.  |
+`---------------------------*/
+
+static void
+yy_symbol_print (FILE *yyo,
+                 yysymbol_kind_t yykind, YYSTYPE const * const yyvaluep, yyscan_t scanner, ASTNode **ast_root)
+{
+  YYFPRINTF (yyo, "%s %s (",
+             yykind < YYNTOKENS ? "token" : "nterm", yysymbol_name (yykind));
+
+  yy_symbol_value_print (yyo, yykind, yyvaluep, scanner, ast_root);
+  YYFPRINTF (yyo, ")");
+}
+
+/*------------------------------------------------------------------.
+| yy_stack_print -- Print the state stack from its BOTTOM up to its |
+| TOP (included).                                                   |
+`------------------------------------------------------------------*/
+
+static void
+yy_stack_print (yy_state_t *yybottom, yy_state_t *yytop)
+{
+  YYFPRINTF (stderr, "Stack now");
+  for (; yybottom <= yytop; yybottom++)
+    {
+      int yybot = *yybottom;
+      YYFPRINTF (stderr, " %d", yybot);
+    }
+  YYFPRINTF (stderr, "\n");
+}
+
+# define YY_STACK_PRINT(Bottom, Top)                            \
+do {                                                            \
+  if (yydebug)                                                  \
+    yy_stack_print ((Bottom), (Top));                           \
+} while (0)
+
+
+/*------------------------------------------------.
+| Report that the YYRULE is going to be reduced.  |
+`------------------------------------------------*/
+
+static void
+yy_reduce_print (yy_state_t *yyssp, YYSTYPE *yyvsp,
+                 int yyrule, yyscan_t scanner, ASTNode **ast_root)
+{
+  int yylno = yyrline[yyrule];
+  int yynrhs = yyr2[yyrule];
+  int yyi;
+  YYFPRINTF (stderr, "Reducing stack by rule %d (line %d):\n",
+             yyrule - 1, yylno);
+  /* The symbols being reduced.  */
+  for (yyi = 0; yyi < yynrhs; yyi++)
+    {
+      YYFPRINTF (stderr, "   $%d = ", yyi + 1);
+      yy_symbol_print (stderr,
+                       YY_ACCESSING_SYMBOL (+yyssp[yyi + 1 - yynrhs]),
+                       &yyvsp[(yyi + 1) - (yynrhs)], scanner, ast_root);
+      YYFPRINTF (stderr, "\n");
+    }
+}
+
+# define YY_REDUCE_PRINT(Rule)          \
+do {                                    \
+  if (yydebug)                          \
+    yy_reduce_print (yyssp, yyvsp, Rule, scanner, ast_root); \
+} while (0)
+
+/* Nonzero means print parse trace.  It is left uninitialized so that
+   multiple parsers can coexist.  */
+int yydebug;
+#else /* !YYDEBUG */
+# define YYDPRINTF(Args) ((void) 0)
+# define YY_SYMBOL_PRINT(Title, Kind, Value, Location)
+# define YY_STACK_PRINT(Bottom, Top)
+# define YY_REDUCE_PRINT(Rule)
+#endif /* !YYDEBUG */
+
+
+/* YYINITDEPTH -- initial size of the parser's stacks.  */
+#ifndef YYINITDEPTH
+# define YYINITDEPTH 200
+#endif
+
+/* YYMAXDEPTH -- maximum size the stacks can grow to (effective only
+   if the built-in stack extension method is used).
+
+   Do not make this value too large; the results are undefined if
+   YYSTACK_ALLOC_MAXIMUM < YYSTACK_BYTES (YYMAXDEPTH)
+   evaluated with infinite-precision integer arithmetic.  */
+
+#ifndef YYMAXDEPTH
+# define YYMAXDEPTH 10000
+#endif
+
+
+
+
+
+
+/*-----------------------------------------------.
+| Release the memory associated to this symbol.  |
+`-----------------------------------------------*/
+
+static void
+yydestruct (const char *yymsg,
+            yysymbol_kind_t yykind, YYSTYPE *yyvaluep, yyscan_t scanner, ASTNode **ast_root)
+{
+  YY_USE (yyvaluep);
+  YY_USE (scanner);
+  YY_USE (ast_root);
+  if (!yymsg)
+    yymsg = "Deleting";
+  YY_SYMBOL_PRINT (yymsg, yykind, yyvaluep, yylocationp);
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  YY_USE (yykind);
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+}
+
+
+
+
+
+
+/*----------.
+| yyparse.  |
+`----------*/
+
+int
+yyparse (yyscan_t scanner, ASTNode **ast_root)
+{
+/* Lookahead token kind.  */
+int yychar;
+
+
+/* The semantic value of the lookahead symbol.  */
+/* Default value used for initialization, for pacifying older GCCs
+   or non-GCC compilers.  */
+YY_INITIAL_VALUE (static YYSTYPE yyval_default;)
+YYSTYPE yylval YY_INITIAL_VALUE (= yyval_default);
+
+    /* Number of syntax errors so far.  */
+    int yynerrs = 0;
+
+    yy_state_fast_t yystate = 0;
+    /* Number of tokens to shift before error messages enabled.  */
+    int yyerrstatus = 0;
+
+    /* Refer to the stacks through separate pointers, to allow yyoverflow
+       to reallocate them elsewhere.  */
+
+    /* Their size.  */
+    YYPTRDIFF_T yystacksize = YYINITDEPTH;
+
+    /* The state stack: array, bottom, top.  */
+    yy_state_t yyssa[YYINITDEPTH];
+    yy_state_t *yyss = yyssa;
+    yy_state_t *yyssp = yyss;
+
+    /* The semantic value stack: array, bottom, top.  */
+    YYSTYPE yyvsa[YYINITDEPTH];
+    YYSTYPE *yyvs = yyvsa;
+    YYSTYPE *yyvsp = yyvs;
+
+  int yyn;
+  /* The return value of yyparse.  */
+  int yyresult;
+  /* Lookahead symbol kind.  */
+  yysymbol_kind_t yytoken = YYSYMBOL_YYEMPTY;
+  /* The variables used to return semantic value and location from the
+     action routines.  */
+  YYSTYPE yyval;
+
+
+
+#define YYPOPSTACK(N)   (yyvsp -= (N), yyssp -= (N))
+
+  /* The number of symbols on the RHS of the reduced rule.
+     Keep to zero when no symbol should be popped.  */
+  int yylen = 0;
+
+  YYDPRINTF ((stderr, "Starting parse\n"));
+
+  yychar = YYEMPTY; /* Cause a token to be read.  */
+
+  goto yysetstate;
+
+
+/*------------------------------------------------------------.
+| yynewstate -- push a new state, which is found in yystate.  |
+`------------------------------------------------------------*/
+yynewstate:
+  /* In all cases, when you get here, the value and location stacks
+     have just been pushed.  So pushing a state here evens the stacks.  */
+  yyssp++;
+
+
+/*--------------------------------------------------------------------.
+| yysetstate -- set current state (the top of the stack) to yystate.  |
+`--------------------------------------------------------------------*/
+yysetstate:
+  YYDPRINTF ((stderr, "Entering state %d\n", yystate));
+  YY_ASSERT (0 <= yystate && yystate < YYNSTATES);
+  YY_IGNORE_USELESS_CAST_BEGIN
+  *yyssp = YY_CAST (yy_state_t, yystate);
+  YY_IGNORE_USELESS_CAST_END
+  YY_STACK_PRINT (yyss, yyssp);
+
+  if (yyss + yystacksize - 1 <= yyssp)
+#if !defined yyoverflow && !defined YYSTACK_RELOCATE
+    YYNOMEM;
+#else
+    {
+      /* Get the current used size of the three stacks, in elements.  */
+      YYPTRDIFF_T yysize = yyssp - yyss + 1;
+
+# if defined yyoverflow
+      {
+        /* Give user a chance to reallocate the stack.  Use copies of
+           these so that the &'s don't force the real ones into
+           memory.  */
+        yy_state_t *yyss1 = yyss;
+        YYSTYPE *yyvs1 = yyvs;
+
+        /* Each stack pointer address is followed by the size of the
+           data in use in that stack, in bytes.  This used to be a
+           conditional around just the two extra args, but that might
+           be undefined if yyoverflow is a macro.  */
+        yyoverflow (YY_("memory exhausted"),
+                    &yyss1, yysize * YYSIZEOF (*yyssp),
+                    &yyvs1, yysize * YYSIZEOF (*yyvsp),
+                    &yystacksize);
+        yyss = yyss1;
+        yyvs = yyvs1;
+      }
+# else /* defined YYSTACK_RELOCATE */
+      /* Extend the stack our own way.  */
+      if (YYMAXDEPTH <= yystacksize)
+        YYNOMEM;
+      yystacksize *= 2;
+      if (YYMAXDEPTH < yystacksize)
+        yystacksize = YYMAXDEPTH;
+
+      {
+        yy_state_t *yyss1 = yyss;
+        union yyalloc *yyptr =
+          YY_CAST (union yyalloc *,
+                   YYSTACK_ALLOC (YY_CAST (YYSIZE_T, YYSTACK_BYTES (yystacksize))));
+        if (! yyptr)
+          YYNOMEM;
+        YYSTACK_RELOCATE (yyss_alloc, yyss);
+        YYSTACK_RELOCATE (yyvs_alloc, yyvs);
+#  undef YYSTACK_RELOCATE
+        if (yyss1 != yyssa)
+          YYSTACK_FREE (yyss1);
+      }
+# endif
+
+      yyssp = yyss + yysize - 1;
+      yyvsp = yyvs + yysize - 1;
+
+      YY_IGNORE_USELESS_CAST_BEGIN
+      YYDPRINTF ((stderr, "Stack size increased to %ld\n",
+                  YY_CAST (long, yystacksize)));
+      YY_IGNORE_USELESS_CAST_END
+
+      if (yyss + yystacksize - 1 <= yyssp)
+        YYABORT;
+    }
+#endif /* !defined yyoverflow && !defined YYSTACK_RELOCATE */
+
+
+  if (yystate == YYFINAL)
+    YYACCEPT;
+
+  goto yybackup;
+
+
+/*-----------.
+| yybackup.  |
+`-----------*/
+yybackup:
+  /* Do appropriate processing given the current state.  Read a
+     lookahead token if we need one and don't already have one.  */
+
+  /* First try to decide what to do without reference to lookahead token.  */
+  yyn = yypact[yystate];
+  if (yypact_value_is_default (yyn))
+    goto yydefault;
+
+  /* Not known => get a lookahead token if don't already have one.  */
+
+  /* YYCHAR is either empty, or end-of-input, or a valid lookahead.  */
+  if (yychar == YYEMPTY)
+    {
+      YYDPRINTF ((stderr, "Reading a token\n"));
+      yychar = yylex (&yylval, scanner);
+    }
+
+  if (yychar <= YYEOF)
+    {
+      yychar = YYEOF;
+      yytoken = YYSYMBOL_YYEOF;
+      YYDPRINTF ((stderr, "Now at end of input.\n"));
+    }
+  else if (yychar == YYerror)
+    {
+      /* The scanner already issued an error message, process directly
+         to error recovery.  But do not keep the error token as
+         lookahead, it is too special and may lead us to an endless
+         loop in error recovery. */
+      yychar = YYUNDEF;
+      yytoken = YYSYMBOL_YYerror;
+      goto yyerrlab1;
+    }
+  else
+    {
+      yytoken = YYTRANSLATE (yychar);
+      YY_SYMBOL_PRINT ("Next token is", yytoken, &yylval, &yylloc);
+    }
+
+  /* If the proper action on seeing token YYTOKEN is to reduce or to
+     detect an error, take that action.  */
+  yyn += yytoken;
+  if (yyn < 0 || YYLAST < yyn || yycheck[yyn] != yytoken)
+    goto yydefault;
+  yyn = yytable[yyn];
+  if (yyn <= 0)
+    {
+      if (yytable_value_is_error (yyn))
+        goto yyerrlab;
+      yyn = -yyn;
+      goto yyreduce;
+    }
+
+  /* Count tokens shifted since error; after three, turn off error
+     status.  */
+  if (yyerrstatus)
+    yyerrstatus--;
+
+  /* Shift the lookahead token.  */
+  YY_SYMBOL_PRINT ("Shifting", yytoken, &yylval, &yylloc);
+  yystate = yyn;
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+  /* Discard the shifted token.  */
+  yychar = YYEMPTY;
+  goto yynewstate;
+
+
+/*-----------------------------------------------------------.
+| yydefault -- do the default action for the current state.  |
+`-----------------------------------------------------------*/
+yydefault:
+  yyn = yydefact[yystate];
+  if (yyn == 0)
+    goto yyerrlab;
+  goto yyreduce;
+
+
+/*-----------------------------.
+| yyreduce -- do a reduction.  |
+`-----------------------------*/
+yyreduce:
+  /* yyn is the number of a rule to reduce with.  */
+  yylen = yyr2[yyn];
+
+  /* If YYLEN is nonzero, implement the default value of the action:
+     '$$ = $1'.
+
+     Otherwise, the following line sets YYVAL to garbage.
+     This behavior is undocumented and Bison
+     users should not rely upon it.  Assigning to YYVAL
+     unconditionally makes the parser a bit smaller, and it avoids a
+     GCC warning that YYVAL may be used uninitialized.  */
+  yyval = yyvsp[1-yylen];
+
+
+  YY_REDUCE_PRINT (yyn);
+  switch (yyn)
+    {
+  case 2: /* program: external_declaration  */
+#line 76 "src/parser/parser.y"
+                         {
+        *ast_root = create_ast_node(AST_PROGRAM, yylineno);
+        add_child(*ast_root, (yyvsp[0].node));
+        (yyval.node) = *ast_root;
+    }
+#line 1596 "build/y.tab.c"
+    break;
+
+  case 3: /* program: program external_declaration  */
+#line 81 "src/parser/parser.y"
+                                   {
+        add_child((yyvsp[-1].node), (yyvsp[0].node));
+        (yyval.node) = (yyvsp[-1].node);
+    }
+#line 1605 "build/y.tab.c"
+    break;
+
+  case 4: /* external_declaration: function_definition  */
+#line 88 "src/parser/parser.y"
+                        { (yyval.node) = (yyvsp[0].node); }
+#line 1611 "build/y.tab.c"
+    break;
+
+  case 5: /* external_declaration: declaration  */
+#line 89 "src/parser/parser.y"
+                  { (yyval.node) = (yyvsp[0].node); }
+#line 1617 "build/y.tab.c"
+    break;
+
+  case 6: /* external_declaration: struct_specifier SEMICOLON  */
+#line 90 "src/parser/parser.y"
+                                 { (yyval.node) = (yyvsp[-1].node); }
+#line 1623 "build/y.tab.c"
+    break;
+
+  case 7: /* external_declaration: union_specifier SEMICOLON  */
+#line 91 "src/parser/parser.y"
+                                { (yyval.node) = (yyvsp[-1].node); }
+#line 1629 "build/y.tab.c"
+    break;
+
+  case 8: /* external_declaration: enum_specifier SEMICOLON  */
+#line 92 "src/parser/parser.y"
+                               { (yyval.node) = (yyvsp[-1].node); }
+#line 1635 "build/y.tab.c"
+    break;
+
+  case 9: /* external_declaration: TYPEDEF INT IDENTIFIER SEMICOLON  */
+#line 93 "src/parser/parser.y"
+                                       {
+        (yyval.node) = create_ast_node(AST_TYPEDEF, yylineno);
+        ASTNode *type_node = create_string_node("int", yylineno);
+        type_node->type = AST_TYPE_SPECIFIER;
+        ASTNode *name_node = create_identifier_node((yyvsp[-1].string_val), yylineno);
+        add_child((yyval.node), type_node);
+        add_child((yyval.node), name_node);
+        free((yyvsp[-1].string_val));
+    }
+#line 1649 "build/y.tab.c"
+    break;
+
+  case 10: /* external_declaration: TYPEDEF FLOAT IDENTIFIER SEMICOLON  */
+#line 102 "src/parser/parser.y"
+                                         {
+        (yyval.node) = create_ast_node(AST_TYPEDEF, yylineno);
+        ASTNode *type_node = create_string_node("float", yylineno);
+        type_node->type = AST_TYPE_SPECIFIER;
+        ASTNode *name_node = create_identifier_node((yyvsp[-1].string_val), yylineno);
+        add_child((yyval.node), type_node);
+        add_child((yyval.node), name_node);
+        free((yyvsp[-1].string_val));
+    }
+#line 1663 "build/y.tab.c"
+    break;
+
+  case 11: /* external_declaration: TYPEDEF CHAR IDENTIFIER SEMICOLON  */
+#line 111 "src/parser/parser.y"
+                                        {
+        (yyval.node) = create_ast_node(AST_TYPEDEF, yylineno);
+        ASTNode *type_node = create_string_node("char", yylineno);
+        type_node->type = AST_TYPE_SPECIFIER;
+        ASTNode *name_node = create_identifier_node((yyvsp[-1].string_val), yylineno);
+        add_child((yyval.node), type_node);
+        add_child((yyval.node), name_node);
+        free((yyvsp[-1].string_val));
+    }
+#line 1677 "build/y.tab.c"
+    break;
+
+  case 12: /* external_declaration: TYPEDEF IDENTIFIER IDENTIFIER SEMICOLON  */
+#line 120 "src/parser/parser.y"
+                                              {
+        // typedef MyInt MyInt2; (嵌套typedef)
+        (yyval.node) = create_ast_node(AST_TYPEDEF, yylineno);
+        ASTNode *type_node = create_string_node((yyvsp[-2].string_val), yylineno);
+        type_node->type = AST_TYPE_SPECIFIER;
+        ASTNode *name_node = create_identifier_node((yyvsp[-1].string_val), yylineno);
+        add_child((yyval.node), type_node);
+        add_child((yyval.node), name_node);
+        free((yyvsp[-2].string_val));
+        free((yyvsp[-1].string_val));
+    }
+#line 1693 "build/y.tab.c"
+    break;
+
+  case 13: /* function_definition: declaration_specifiers declarator compound_statement  */
+#line 134 "src/parser/parser.y"
+                                                         {
+        (yyval.node) = create_ast_node(AST_FUNCTION_DEF, yylineno);
+        add_child((yyval.node), (yyvsp[-2].node));
+        add_child((yyval.node), (yyvsp[-1].node));
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 1704 "build/y.tab.c"
+    break;
+
+  case 14: /* declaration_specifiers: INT  */
+#line 143 "src/parser/parser.y"
+        { (yyval.node) = create_string_node("int", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; }
+#line 1710 "build/y.tab.c"
+    break;
+
+  case 15: /* declaration_specifiers: FLOAT  */
+#line 144 "src/parser/parser.y"
+            { (yyval.node) = create_string_node("float", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; }
+#line 1716 "build/y.tab.c"
+    break;
+
+  case 16: /* declaration_specifiers: CHAR  */
+#line 145 "src/parser/parser.y"
+           { (yyval.node) = create_string_node("char", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; }
+#line 1722 "build/y.tab.c"
+    break;
+
+  case 17: /* declaration_specifiers: VOID  */
+#line 146 "src/parser/parser.y"
+           { (yyval.node) = create_string_node("void", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; }
+#line 1728 "build/y.tab.c"
+    break;
+
+  case 18: /* declaration_specifiers: IDENTIFIER  */
+#line 147 "src/parser/parser.y"
+                 { 
+        // 可能是typedef定义的类型名
+        (yyval.node) = create_string_node((yyvsp[0].string_val), yylineno); 
+        (yyval.node)->type = AST_TYPE_SPECIFIER;
+        free((yyvsp[0].string_val));
+    }
+#line 1739 "build/y.tab.c"
+    break;
+
+  case 19: /* declaration_specifiers: SHORT  */
+#line 153 "src/parser/parser.y"
+            { (yyval.node) = create_string_node("short", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; }
+#line 1745 "build/y.tab.c"
+    break;
+
+  case 20: /* declaration_specifiers: LONG  */
+#line 154 "src/parser/parser.y"
+           { (yyval.node) = create_string_node("long", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; }
+#line 1751 "build/y.tab.c"
+    break;
+
+  case 21: /* declaration_specifiers: DOUBLE  */
+#line 155 "src/parser/parser.y"
+             { (yyval.node) = create_string_node("double", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; }
+#line 1757 "build/y.tab.c"
+    break;
+
+  case 22: /* declaration_specifiers: UNSIGNED  */
+#line 156 "src/parser/parser.y"
+               { (yyval.node) = create_string_node("unsigned", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; }
+#line 1763 "build/y.tab.c"
+    break;
+
+  case 23: /* declaration_specifiers: struct_specifier  */
+#line 157 "src/parser/parser.y"
+                       { (yyval.node) = (yyvsp[0].node); }
+#line 1769 "build/y.tab.c"
+    break;
+
+  case 24: /* declaration_specifiers: union_specifier  */
+#line 158 "src/parser/parser.y"
+                      { (yyval.node) = (yyvsp[0].node); }
+#line 1775 "build/y.tab.c"
+    break;
+
+  case 25: /* declaration_specifiers: STATIC INT  */
+#line 159 "src/parser/parser.y"
+                 { (yyval.node) = create_string_node("int", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; (yyval.node)->lineno = -1; /* Mark as static with negative lineno */ }
+#line 1781 "build/y.tab.c"
+    break;
+
+  case 26: /* declaration_specifiers: STATIC FLOAT  */
+#line 160 "src/parser/parser.y"
+                   { (yyval.node) = create_string_node("float", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; (yyval.node)->lineno = -1; }
+#line 1787 "build/y.tab.c"
+    break;
+
+  case 27: /* declaration_specifiers: STATIC CHAR  */
+#line 161 "src/parser/parser.y"
+                  { (yyval.node) = create_string_node("char", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; (yyval.node)->lineno = -1; }
+#line 1793 "build/y.tab.c"
+    break;
+
+  case 28: /* declaration_specifiers: STATIC VOID  */
+#line 162 "src/parser/parser.y"
+                  { (yyval.node) = create_string_node("void", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; (yyval.node)->lineno = -1; }
+#line 1799 "build/y.tab.c"
+    break;
+
+  case 29: /* declaration_specifiers: EXTERN INT  */
+#line 163 "src/parser/parser.y"
+                 { (yyval.node) = create_string_node("int", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; (yyval.node)->lineno = -2; /* Mark as extern with lineno=-2 */ }
+#line 1805 "build/y.tab.c"
+    break;
+
+  case 30: /* declaration_specifiers: EXTERN FLOAT  */
+#line 164 "src/parser/parser.y"
+                   { (yyval.node) = create_string_node("float", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; (yyval.node)->lineno = -2; }
+#line 1811 "build/y.tab.c"
+    break;
+
+  case 31: /* declaration_specifiers: EXTERN CHAR  */
+#line 165 "src/parser/parser.y"
+                  { (yyval.node) = create_string_node("char", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; (yyval.node)->lineno = -2; }
+#line 1817 "build/y.tab.c"
+    break;
+
+  case 32: /* declaration_specifiers: EXTERN VOID  */
+#line 166 "src/parser/parser.y"
+                  { (yyval.node) = create_string_node("void", yylineno); (yyval.node)->type = AST_TYPE_SPECIFIER; (yyval.node)->lineno = -2; }
+#line 1823 "build/y.tab.c"
+    break;
+
+  case 33: /* declaration_specifiers: INLINE declaration_specifiers  */
+#line 167 "src/parser/parser.y"
+                                    { (yyval.node) = (yyvsp[0].node); (yyval.node)->lineno = (yyvsp[0].node)->lineno == -1 ? -6 : -5; /* Mark as inline with lineno=-5, static inline with -6 */ }
+#line 1829 "build/y.tab.c"
+    break;
+
+  case 34: /* declaration_specifiers: STATIC INLINE declaration_specifiers  */
+#line 168 "src/parser/parser.y"
+                                           { (yyval.node) = (yyvsp[0].node); (yyval.node)->lineno = -6; }
+#line 1835 "build/y.tab.c"
+    break;
+
+  case 35: /* declarator: IDENTIFIER  */
+#line 172 "src/parser/parser.y"
+               {
+        (yyval.node) = create_identifier_node((yyvsp[0].string_val), yylineno);
+        (yyval.node)->type = AST_DECLARATOR;
+        free((yyvsp[0].string_val));
+    }
+#line 1845 "build/y.tab.c"
+    break;
+
+  case 36: /* declarator: STAR declarator  */
+#line 177 "src/parser/parser.y"
+                      {
+        // 创建一个包装节点来表示指针声明
+        ASTNode *ptr_node = create_ast_node(AST_DECLARATOR, yylineno);
+        ptr_node->value.int_val = -1;  // 特殊标记：-1表示指针声明
+        add_child(ptr_node, (yyvsp[0].node));  // 子节点是被指向的声明
+        (yyval.node) = ptr_node;
+    }
+#line 1857 "build/y.tab.c"
+    break;
+
+  case 37: /* declarator: declarator LPAREN RPAREN  */
+#line 184 "src/parser/parser.y"
+                               {
+        (yyval.node) = (yyvsp[-2].node);
+        add_child((yyval.node), create_ast_node(AST_PARAM_LIST, yylineno));  // 空参数列表
+    }
+#line 1866 "build/y.tab.c"
+    break;
+
+  case 38: /* declarator: declarator LPAREN parameter_list RPAREN  */
+#line 188 "src/parser/parser.y"
+                                              {
+        (yyval.node) = (yyvsp[-3].node);
+        add_child((yyval.node), (yyvsp[-1].node));  // Add parameter list as child
+    }
+#line 1875 "build/y.tab.c"
+    break;
+
+  case 39: /* declarator: declarator LBRACKET INTEGER_CONSTANT RBRACKET  */
+#line 192 "src/parser/parser.y"
+                                                    {
+        ASTNode *array_decl = create_ast_node(AST_DECLARATOR, yylineno);
+        array_decl->value.int_val = (yyvsp[-1].int_val);  // Store array size
+        add_child(array_decl, (yyvsp[-3].node));
+        (yyval.node) = array_decl;
+    }
+#line 1886 "build/y.tab.c"
+    break;
+
+  case 40: /* declarator: declarator LBRACKET RBRACKET  */
+#line 198 "src/parser/parser.y"
+                                   {
+        ASTNode *array_decl = create_ast_node(AST_DECLARATOR, yylineno);
+        array_decl->value.int_val = -2;  // Unsized array（-1 已用于指针）
+        add_child(array_decl, (yyvsp[-2].node));
+        (yyval.node) = array_decl;
+    }
+#line 1897 "build/y.tab.c"
+    break;
+
+  case 41: /* parameter_list: parameter_declaration  */
+#line 207 "src/parser/parser.y"
+                          {
+        (yyval.node) = create_ast_node(AST_PARAM_LIST, yylineno);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 1906 "build/y.tab.c"
+    break;
+
+  case 42: /* parameter_list: parameter_list COMMA parameter_declaration  */
+#line 211 "src/parser/parser.y"
+                                                 {
+        (yyval.node) = (yyvsp[-2].node);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 1915 "build/y.tab.c"
+    break;
+
+  case 43: /* parameter_list: parameter_list COMMA ELLIPSIS  */
+#line 215 "src/parser/parser.y"
+                                    {
+        (yyval.node) = (yyvsp[-2].node);
+        // 添加一个特殊节点表示可变参数
+        ASTNode *varargs = create_ast_node(AST_PARAM_LIST, yylineno);
+        varargs->value.string_val = strdup("...");
+        add_child((yyval.node), varargs);
+    }
+#line 1927 "build/y.tab.c"
+    break;
+
+  case 44: /* parameter_declaration: declaration_specifiers declarator  */
+#line 225 "src/parser/parser.y"
+                                      {
+        (yyval.node) = create_ast_node(AST_DECLARATION, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 1937 "build/y.tab.c"
+    break;
+
+  case 45: /* parameter_declaration: declaration_specifiers IDENTIFIER  */
+#line 230 "src/parser/parser.y"
+                                        {
+        (yyval.node) = create_ast_node(AST_DECLARATION, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+        ASTNode *id = create_identifier_node((yyvsp[0].string_val), yylineno);
+        id->type = AST_DECLARATOR;
+        add_child((yyval.node), id);
+        free((yyvsp[0].string_val));
+    }
+#line 1950 "build/y.tab.c"
+    break;
+
+  case 46: /* declaration: declaration_specifiers init_declarator SEMICOLON  */
+#line 241 "src/parser/parser.y"
+                                                     {
+        (yyval.node) = create_ast_node(AST_DECLARATION, yylineno);
+        add_child((yyval.node), (yyvsp[-2].node));
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 1960 "build/y.tab.c"
+    break;
+
+  case 47: /* init_declarator: declarator  */
+#line 249 "src/parser/parser.y"
+               {
+        (yyval.node) = (yyvsp[0].node);
+    }
+#line 1968 "build/y.tab.c"
+    break;
+
+  case 48: /* init_declarator: declarator ASSIGN initializer  */
+#line 252 "src/parser/parser.y"
+                                    {
+        (yyval.node) = create_binary_expr_node(OP_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 1977 "build/y.tab.c"
+    break;
+
+  case 49: /* initializer: assignment_expression  */
+#line 259 "src/parser/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 1983 "build/y.tab.c"
+    break;
+
+  case 50: /* initializer: LBRACE initializer_list RBRACE  */
+#line 260 "src/parser/parser.y"
+                                     { (yyval.node) = (yyvsp[-1].node); }
+#line 1989 "build/y.tab.c"
+    break;
+
+  case 51: /* initializer: LBRACE initializer_list COMMA RBRACE  */
+#line 261 "src/parser/parser.y"
+                                           { (yyval.node) = (yyvsp[-2].node); }
+#line 1995 "build/y.tab.c"
+    break;
+
+  case 52: /* initializer_list: initializer  */
+#line 265 "src/parser/parser.y"
+                {
+        (yyval.node) = create_ast_node(AST_INIT_LIST, yylineno);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2004 "build/y.tab.c"
+    break;
+
+  case 53: /* initializer_list: initializer_list COMMA initializer  */
+#line 269 "src/parser/parser.y"
+                                         {
+        (yyval.node) = (yyvsp[-2].node);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2013 "build/y.tab.c"
+    break;
+
+  case 54: /* compound_statement: LBRACE RBRACE  */
+#line 276 "src/parser/parser.y"
+                  {
+        (yyval.node) = create_ast_node(AST_COMPOUND_STMT, yylineno);
+    }
+#line 2021 "build/y.tab.c"
+    break;
+
+  case 55: /* compound_statement: LBRACE statement_list RBRACE  */
+#line 279 "src/parser/parser.y"
+                                   {
+        (yyval.node) = (yyvsp[-1].node);
+    }
+#line 2029 "build/y.tab.c"
+    break;
+
+  case 56: /* statement_list: statement  */
+#line 285 "src/parser/parser.y"
+              {
+        (yyval.node) = create_ast_node(AST_COMPOUND_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2038 "build/y.tab.c"
+    break;
+
+  case 57: /* statement_list: statement_list statement  */
+#line 289 "src/parser/parser.y"
+                               {
+        add_child((yyvsp[-1].node), (yyvsp[0].node));
+        (yyval.node) = (yyvsp[-1].node);
+    }
+#line 2047 "build/y.tab.c"
+    break;
+
+  case 58: /* statement: declaration  */
+#line 296 "src/parser/parser.y"
+                { (yyval.node) = (yyvsp[0].node); }
+#line 2053 "build/y.tab.c"
+    break;
+
+  case 59: /* statement: expression_statement  */
+#line 297 "src/parser/parser.y"
+                           { (yyval.node) = (yyvsp[0].node); }
+#line 2059 "build/y.tab.c"
+    break;
+
+  case 60: /* statement: compound_statement  */
+#line 298 "src/parser/parser.y"
+                         { (yyval.node) = (yyvsp[0].node); }
+#line 2065 "build/y.tab.c"
+    break;
+
+  case 61: /* statement: selection_statement  */
+#line 299 "src/parser/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2071 "build/y.tab.c"
+    break;
+
+  case 62: /* statement: iteration_statement  */
+#line 300 "src/parser/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2077 "build/y.tab.c"
+    break;
+
+  case 63: /* statement: jump_statement  */
+#line 301 "src/parser/parser.y"
+                     { (yyval.node) = (yyvsp[0].node); }
+#line 2083 "build/y.tab.c"
+    break;
+
+  case 64: /* statement: labeled_statement  */
+#line 302 "src/parser/parser.y"
+                        { (yyval.node) = (yyvsp[0].node); }
+#line 2089 "build/y.tab.c"
+    break;
+
+  case 65: /* labeled_statement: CASE conditional_expression COLON statement  */
+#line 306 "src/parser/parser.y"
+                                                {
+        (yyval.node) = create_ast_node(AST_CASE_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-2].node));
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2099 "build/y.tab.c"
+    break;
+
+  case 66: /* labeled_statement: DEFAULT COLON statement  */
+#line 311 "src/parser/parser.y"
+                              {
+        (yyval.node) = create_ast_node(AST_DEFAULT_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2108 "build/y.tab.c"
+    break;
+
+  case 67: /* expression_statement: SEMICOLON  */
+#line 318 "src/parser/parser.y"
+              {
+        (yyval.node) = create_ast_node(AST_EXPR_STMT, yylineno);
+    }
+#line 2116 "build/y.tab.c"
+    break;
+
+  case 68: /* expression_statement: expression SEMICOLON  */
+#line 321 "src/parser/parser.y"
+                           {
+        (yyval.node) = create_ast_node(AST_EXPR_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 2125 "build/y.tab.c"
+    break;
+
+  case 69: /* selection_statement: IF LPAREN expression RPAREN statement  */
+#line 328 "src/parser/parser.y"
+                                          {
+        (yyval.node) = create_ast_node(AST_IF_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-2].node));
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2135 "build/y.tab.c"
+    break;
+
+  case 70: /* selection_statement: IF LPAREN expression RPAREN statement ELSE statement  */
+#line 333 "src/parser/parser.y"
+                                                           {
+        (yyval.node) = create_ast_node(AST_IF_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-4].node));
+        add_child((yyval.node), (yyvsp[-2].node));
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2146 "build/y.tab.c"
+    break;
+
+  case 71: /* selection_statement: SWITCH LPAREN expression RPAREN statement  */
+#line 339 "src/parser/parser.y"
+                                                {
+        (yyval.node) = create_ast_node(AST_SWITCH_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-2].node));
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2156 "build/y.tab.c"
+    break;
+
+  case 72: /* iteration_statement: WHILE LPAREN expression RPAREN statement  */
+#line 347 "src/parser/parser.y"
+                                             {
+        (yyval.node) = create_ast_node(AST_WHILE_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-2].node));
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2166 "build/y.tab.c"
+    break;
+
+  case 73: /* iteration_statement: DO statement WHILE LPAREN expression RPAREN SEMICOLON  */
+#line 352 "src/parser/parser.y"
+                                                            {
+        (yyval.node) = create_ast_node(AST_DO_WHILE_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-5].node));  // 循环体
+        add_child((yyval.node), (yyvsp[-2].node));  // 条件表达式
+    }
+#line 2176 "build/y.tab.c"
+    break;
+
+  case 74: /* iteration_statement: FOR LPAREN expression_statement expression_statement RPAREN statement  */
+#line 357 "src/parser/parser.y"
+                                                                            {
+        (yyval.node) = create_ast_node(AST_FOR_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-3].node));  // init
+        add_child((yyval.node), (yyvsp[-2].node));  // condition
+        add_child((yyval.node), (yyvsp[0].node));  // body
+    }
+#line 2187 "build/y.tab.c"
+    break;
+
+  case 75: /* iteration_statement: FOR LPAREN expression_statement expression_statement expression RPAREN statement  */
+#line 363 "src/parser/parser.y"
+                                                                                       {
+        (yyval.node) = create_ast_node(AST_FOR_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-4].node));  // init
+        add_child((yyval.node), (yyvsp[-3].node));  // condition
+        add_child((yyval.node), (yyvsp[-2].node));  // increment
+        add_child((yyval.node), (yyvsp[0].node));  // body
+    }
+#line 2199 "build/y.tab.c"
+    break;
+
+  case 76: /* iteration_statement: FOR LPAREN declaration expression_statement RPAREN statement  */
+#line 370 "src/parser/parser.y"
+                                                                   {
+        (yyval.node) = create_ast_node(AST_FOR_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-3].node));  // init (declaration)
+        add_child((yyval.node), (yyvsp[-2].node));  // condition
+        add_child((yyval.node), (yyvsp[0].node));  // body
+    }
+#line 2210 "build/y.tab.c"
+    break;
+
+  case 77: /* iteration_statement: FOR LPAREN declaration expression_statement expression RPAREN statement  */
+#line 376 "src/parser/parser.y"
+                                                                              {
+        (yyval.node) = create_ast_node(AST_FOR_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-4].node));  // init (declaration)
+        add_child((yyval.node), (yyvsp[-3].node));  // condition
+        add_child((yyval.node), (yyvsp[-2].node));  // increment
+        add_child((yyval.node), (yyvsp[0].node));  // body
+    }
+#line 2222 "build/y.tab.c"
+    break;
+
+  case 78: /* jump_statement: RETURN SEMICOLON  */
+#line 386 "src/parser/parser.y"
+                     {
+        (yyval.node) = create_ast_node(AST_RETURN_STMT, yylineno);
+    }
+#line 2230 "build/y.tab.c"
+    break;
+
+  case 79: /* jump_statement: RETURN expression SEMICOLON  */
+#line 389 "src/parser/parser.y"
+                                  {
+        (yyval.node) = create_ast_node(AST_RETURN_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 2239 "build/y.tab.c"
+    break;
+
+  case 80: /* jump_statement: BREAK SEMICOLON  */
+#line 393 "src/parser/parser.y"
+                      {
+        (yyval.node) = create_ast_node(AST_BREAK_STMT, yylineno);
+    }
+#line 2247 "build/y.tab.c"
+    break;
+
+  case 81: /* jump_statement: CONTINUE SEMICOLON  */
+#line 396 "src/parser/parser.y"
+                         {
+        (yyval.node) = create_ast_node(AST_CONTINUE_STMT, yylineno);
+    }
+#line 2255 "build/y.tab.c"
+    break;
+
+  case 82: /* jump_statement: ASM LPAREN STRING_LITERAL RPAREN SEMICOLON  */
+#line 399 "src/parser/parser.y"
+                                                 {
+        (yyval.node) = create_ast_node(AST_ASM_STMT, yylineno);
+        (yyval.node)->value.string_val = (yyvsp[-2].string_val);
+    }
+#line 2264 "build/y.tab.c"
+    break;
+
+  case 83: /* expression: assignment_expression  */
+#line 406 "src/parser/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2270 "build/y.tab.c"
+    break;
+
+  case 84: /* expression: expression COMMA assignment_expression  */
+#line 407 "src/parser/parser.y"
+                                             {
+        (yyval.node) = create_binary_expr_node(OP_COMMA, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_BINARY_EXPR;
+    }
+#line 2279 "build/y.tab.c"
+    break;
+
+  case 85: /* assignment_expression: conditional_expression  */
+#line 414 "src/parser/parser.y"
+                           { (yyval.node) = (yyvsp[0].node); }
+#line 2285 "build/y.tab.c"
+    break;
+
+  case 86: /* assignment_expression: unary_expression ASSIGN assignment_expression  */
+#line 415 "src/parser/parser.y"
+                                                    {
+        (yyval.node) = create_binary_expr_node(OP_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2294 "build/y.tab.c"
+    break;
+
+  case 87: /* assignment_expression: unary_expression ADD_ASSIGN assignment_expression  */
+#line 419 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_ADD_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2303 "build/y.tab.c"
+    break;
+
+  case 88: /* assignment_expression: unary_expression SUB_ASSIGN assignment_expression  */
+#line 423 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_SUB_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2312 "build/y.tab.c"
+    break;
+
+  case 89: /* assignment_expression: unary_expression MUL_ASSIGN assignment_expression  */
+#line 427 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_MUL_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2321 "build/y.tab.c"
+    break;
+
+  case 90: /* assignment_expression: unary_expression DIV_ASSIGN assignment_expression  */
+#line 431 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_DIV_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2330 "build/y.tab.c"
+    break;
+
+  case 91: /* assignment_expression: unary_expression MOD_ASSIGN assignment_expression  */
+#line 435 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_MOD_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2339 "build/y.tab.c"
+    break;
+
+  case 92: /* assignment_expression: unary_expression AND_ASSIGN assignment_expression  */
+#line 439 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_AND_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2348 "build/y.tab.c"
+    break;
+
+  case 93: /* assignment_expression: unary_expression OR_ASSIGN assignment_expression  */
+#line 443 "src/parser/parser.y"
+                                                       {
+        (yyval.node) = create_binary_expr_node(OP_OR_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2357 "build/y.tab.c"
+    break;
+
+  case 94: /* assignment_expression: unary_expression XOR_ASSIGN assignment_expression  */
+#line 447 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_XOR_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2366 "build/y.tab.c"
+    break;
+
+  case 95: /* assignment_expression: unary_expression LEFT_ASSIGN assignment_expression  */
+#line 451 "src/parser/parser.y"
+                                                         {
+        (yyval.node) = create_binary_expr_node(OP_LEFT_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2375 "build/y.tab.c"
+    break;
+
+  case 96: /* assignment_expression: unary_expression RIGHT_ASSIGN assignment_expression  */
+#line 455 "src/parser/parser.y"
+                                                          {
+        (yyval.node) = create_binary_expr_node(OP_RIGHT_ASSIGN, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+        (yyval.node)->type = AST_ASSIGN_EXPR;
+    }
+#line 2384 "build/y.tab.c"
+    break;
+
+  case 97: /* conditional_expression: logical_or_expression  */
+#line 462 "src/parser/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2390 "build/y.tab.c"
+    break;
+
+  case 98: /* conditional_expression: logical_or_expression QUESTION expression COLON conditional_expression  */
+#line 463 "src/parser/parser.y"
+                                                                             {
+        (yyval.node) = create_ast_node(AST_TERNARY_EXPR, yylineno);
+        add_child((yyval.node), (yyvsp[-4].node));  // condition
+        add_child((yyval.node), (yyvsp[-2].node));  // true_expr
+        add_child((yyval.node), (yyvsp[0].node));  // false_expr
+    }
+#line 2401 "build/y.tab.c"
+    break;
+
+  case 99: /* logical_or_expression: logical_and_expression  */
+#line 472 "src/parser/parser.y"
+                           { (yyval.node) = (yyvsp[0].node); }
+#line 2407 "build/y.tab.c"
+    break;
+
+  case 100: /* logical_or_expression: logical_or_expression OR_OP logical_and_expression  */
+#line 473 "src/parser/parser.y"
+                                                         {
+        (yyval.node) = create_binary_expr_node(OP_OR, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2415 "build/y.tab.c"
+    break;
+
+  case 101: /* logical_and_expression: bitwise_or_expression  */
+#line 479 "src/parser/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2421 "build/y.tab.c"
+    break;
+
+  case 102: /* logical_and_expression: logical_and_expression AND_OP bitwise_or_expression  */
+#line 480 "src/parser/parser.y"
+                                                          {
+        (yyval.node) = create_binary_expr_node(OP_AND, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2429 "build/y.tab.c"
+    break;
+
+  case 103: /* bitwise_or_expression: bitwise_xor_expression  */
+#line 486 "src/parser/parser.y"
+                           { (yyval.node) = (yyvsp[0].node); }
+#line 2435 "build/y.tab.c"
+    break;
+
+  case 104: /* bitwise_or_expression: bitwise_or_expression PIPE bitwise_xor_expression  */
+#line 487 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_BIT_OR, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2443 "build/y.tab.c"
+    break;
+
+  case 105: /* bitwise_xor_expression: bitwise_and_expression  */
+#line 493 "src/parser/parser.y"
+                           { (yyval.node) = (yyvsp[0].node); }
+#line 2449 "build/y.tab.c"
+    break;
+
+  case 106: /* bitwise_xor_expression: bitwise_xor_expression XOR bitwise_and_expression  */
+#line 494 "src/parser/parser.y"
+                                                        {
+        (yyval.node) = create_binary_expr_node(OP_BIT_XOR, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2457 "build/y.tab.c"
+    break;
+
+  case 107: /* bitwise_and_expression: equality_expression  */
+#line 500 "src/parser/parser.y"
+                        { (yyval.node) = (yyvsp[0].node); }
+#line 2463 "build/y.tab.c"
+    break;
+
+  case 108: /* bitwise_and_expression: bitwise_and_expression AMPERSAND equality_expression  */
+#line 501 "src/parser/parser.y"
+                                                           {
+        (yyval.node) = create_binary_expr_node(OP_BIT_AND, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2471 "build/y.tab.c"
+    break;
+
+  case 109: /* equality_expression: relational_expression  */
+#line 507 "src/parser/parser.y"
+                          { (yyval.node) = (yyvsp[0].node); }
+#line 2477 "build/y.tab.c"
+    break;
+
+  case 110: /* equality_expression: equality_expression EQ_OP relational_expression  */
+#line 508 "src/parser/parser.y"
+                                                      {
+        (yyval.node) = create_binary_expr_node(OP_EQ, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2485 "build/y.tab.c"
+    break;
+
+  case 111: /* equality_expression: equality_expression NE_OP relational_expression  */
+#line 511 "src/parser/parser.y"
+                                                      {
+        (yyval.node) = create_binary_expr_node(OP_NE, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2493 "build/y.tab.c"
+    break;
+
+  case 112: /* relational_expression: shift_expression  */
+#line 517 "src/parser/parser.y"
+                     { (yyval.node) = (yyvsp[0].node); }
+#line 2499 "build/y.tab.c"
+    break;
+
+  case 113: /* relational_expression: relational_expression LT shift_expression  */
+#line 518 "src/parser/parser.y"
+                                                {
+        (yyval.node) = create_binary_expr_node(OP_LT, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2507 "build/y.tab.c"
+    break;
+
+  case 114: /* relational_expression: relational_expression GT shift_expression  */
+#line 521 "src/parser/parser.y"
+                                                {
+        (yyval.node) = create_binary_expr_node(OP_GT, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2515 "build/y.tab.c"
+    break;
+
+  case 115: /* relational_expression: relational_expression LE_OP shift_expression  */
+#line 524 "src/parser/parser.y"
+                                                   {
+        (yyval.node) = create_binary_expr_node(OP_LE, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2523 "build/y.tab.c"
+    break;
+
+  case 116: /* relational_expression: relational_expression GE_OP shift_expression  */
+#line 527 "src/parser/parser.y"
+                                                   {
+        (yyval.node) = create_binary_expr_node(OP_GE, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2531 "build/y.tab.c"
+    break;
+
+  case 117: /* shift_expression: additive_expression  */
+#line 533 "src/parser/parser.y"
+                        { (yyval.node) = (yyvsp[0].node); }
+#line 2537 "build/y.tab.c"
+    break;
+
+  case 118: /* shift_expression: shift_expression LEFT_SHIFT additive_expression  */
+#line 534 "src/parser/parser.y"
+                                                      {
+        (yyval.node) = create_binary_expr_node(OP_LEFT_SHIFT, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2545 "build/y.tab.c"
+    break;
+
+  case 119: /* shift_expression: shift_expression RIGHT_SHIFT additive_expression  */
+#line 537 "src/parser/parser.y"
+                                                       {
+        (yyval.node) = create_binary_expr_node(OP_RIGHT_SHIFT, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2553 "build/y.tab.c"
+    break;
+
+  case 120: /* additive_expression: multiplicative_expression  */
+#line 543 "src/parser/parser.y"
+                              { (yyval.node) = (yyvsp[0].node); }
+#line 2559 "build/y.tab.c"
+    break;
+
+  case 121: /* additive_expression: additive_expression PLUS multiplicative_expression  */
+#line 544 "src/parser/parser.y"
+                                                         {
+        (yyval.node) = create_binary_expr_node(OP_ADD, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2567 "build/y.tab.c"
+    break;
+
+  case 122: /* additive_expression: additive_expression MINUS multiplicative_expression  */
+#line 547 "src/parser/parser.y"
+                                                          {
+        (yyval.node) = create_binary_expr_node(OP_SUB, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2575 "build/y.tab.c"
+    break;
+
+  case 123: /* multiplicative_expression: unary_expression  */
+#line 553 "src/parser/parser.y"
+                     { (yyval.node) = (yyvsp[0].node); }
+#line 2581 "build/y.tab.c"
+    break;
+
+  case 124: /* multiplicative_expression: multiplicative_expression STAR unary_expression  */
+#line 554 "src/parser/parser.y"
+                                                      {
+        (yyval.node) = create_binary_expr_node(OP_MUL, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2589 "build/y.tab.c"
+    break;
+
+  case 125: /* multiplicative_expression: multiplicative_expression SLASH unary_expression  */
+#line 557 "src/parser/parser.y"
+                                                       {
+        (yyval.node) = create_binary_expr_node(OP_DIV, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2597 "build/y.tab.c"
+    break;
+
+  case 126: /* multiplicative_expression: multiplicative_expression PERCENT unary_expression  */
+#line 560 "src/parser/parser.y"
+                                                         {
+        (yyval.node) = create_binary_expr_node(OP_MOD, (yyvsp[-2].node), (yyvsp[0].node), yylineno);
+    }
+#line 2605 "build/y.tab.c"
+    break;
+
+  case 127: /* unary_expression: postfix_expression  */
+#line 566 "src/parser/parser.y"
+                       { (yyval.node) = (yyvsp[0].node); }
+#line 2611 "build/y.tab.c"
+    break;
+
+  case 128: /* unary_expression: SIZEOF LPAREN declaration_specifiers RPAREN  */
+#line 567 "src/parser/parser.y"
+                                                  {
+        // sizeof(int), sizeof(float), etc.
+        (yyval.node) = create_ast_node(AST_SIZEOF_EXPR, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 2621 "build/y.tab.c"
+    break;
+
+  case 129: /* unary_expression: SIZEOF LPAREN unary_expression RPAREN  */
+#line 572 "src/parser/parser.y"
+                                            {
+        // sizeof(expr)
+        (yyval.node) = create_ast_node(AST_SIZEOF_EXPR, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 2631 "build/y.tab.c"
+    break;
+
+  case 130: /* unary_expression: INC_OP unary_expression  */
+#line 577 "src/parser/parser.y"
+                              {
+        (yyval.node) = create_unary_expr_node(OP_PREINC, (yyvsp[0].node), yylineno);
+    }
+#line 2639 "build/y.tab.c"
+    break;
+
+  case 131: /* unary_expression: DEC_OP unary_expression  */
+#line 580 "src/parser/parser.y"
+                              {
+        (yyval.node) = create_unary_expr_node(OP_PREDEC, (yyvsp[0].node), yylineno);
+    }
+#line 2647 "build/y.tab.c"
+    break;
+
+  case 132: /* unary_expression: NOT_OP unary_expression  */
+#line 583 "src/parser/parser.y"
+                              {
+        (yyval.node) = create_unary_expr_node(OP_NOT, (yyvsp[0].node), yylineno);
+    }
+#line 2655 "build/y.tab.c"
+    break;
+
+  case 133: /* unary_expression: MINUS unary_expression  */
+#line 586 "src/parser/parser.y"
+                             {
+        (yyval.node) = create_unary_expr_node(OP_NEG, (yyvsp[0].node), yylineno);
+    }
+#line 2663 "build/y.tab.c"
+    break;
+
+  case 134: /* unary_expression: AMPERSAND unary_expression  */
+#line 589 "src/parser/parser.y"
+                                 {
+        (yyval.node) = create_unary_expr_node(OP_ADDR, (yyvsp[0].node), yylineno);
+    }
+#line 2671 "build/y.tab.c"
+    break;
+
+  case 135: /* unary_expression: STAR unary_expression  */
+#line 592 "src/parser/parser.y"
+                            {
+        (yyval.node) = create_unary_expr_node(OP_DEREF, (yyvsp[0].node), yylineno);
+    }
+#line 2679 "build/y.tab.c"
+    break;
+
+  case 136: /* unary_expression: TILDE unary_expression  */
+#line 595 "src/parser/parser.y"
+                             {
+        (yyval.node) = create_unary_expr_node(OP_BIT_NOT, (yyvsp[0].node), yylineno);
+    }
+#line 2687 "build/y.tab.c"
+    break;
+
+  case 137: /* postfix_expression: primary_expression  */
+#line 601 "src/parser/parser.y"
+                       { (yyval.node) = (yyvsp[0].node); }
+#line 2693 "build/y.tab.c"
+    break;
+
+  case 138: /* postfix_expression: postfix_expression LPAREN RPAREN  */
+#line 602 "src/parser/parser.y"
+                                       {
+        (yyval.node) = create_ast_node(AST_CALL_EXPR, yylineno);
+        add_child((yyval.node), (yyvsp[-2].node));  // function name/expression
+    }
+#line 2702 "build/y.tab.c"
+    break;
+
+  case 139: /* postfix_expression: postfix_expression LPAREN argument_expression_list RPAREN  */
+#line 606 "src/parser/parser.y"
+                                                                {
+        (yyval.node) = create_ast_node(AST_CALL_EXPR, yylineno);
+        add_child((yyval.node), (yyvsp[-3].node));  // function name/expression
+        add_child((yyval.node), (yyvsp[-1].node));  // argument list
+    }
+#line 2712 "build/y.tab.c"
+    break;
+
+  case 140: /* postfix_expression: postfix_expression LBRACKET expression RBRACKET  */
+#line 611 "src/parser/parser.y"
+                                                      {
+        (yyval.node) = create_ast_node(AST_ARRAY_SUBSCRIPT, yylineno);
+        add_child((yyval.node), (yyvsp[-3].node));  // array expression
+        add_child((yyval.node), (yyvsp[-1].node));  // subscript expression
+    }
+#line 2722 "build/y.tab.c"
+    break;
+
+  case 141: /* postfix_expression: postfix_expression DOT IDENTIFIER  */
+#line 616 "src/parser/parser.y"
+                                        {
+        (yyval.node) = create_binary_expr_node(OP_MEMBER, (yyvsp[-2].node), create_identifier_node((yyvsp[0].string_val), yylineno), yylineno);
+        (yyval.node)->type = AST_MEMBER_ACCESS;
+        free((yyvsp[0].string_val));
+    }
+#line 2732 "build/y.tab.c"
+    break;
+
+  case 142: /* postfix_expression: postfix_expression ARROW IDENTIFIER  */
+#line 621 "src/parser/parser.y"
+                                          {
+        (yyval.node) = create_binary_expr_node(OP_ARROW, (yyvsp[-2].node), create_identifier_node((yyvsp[0].string_val), yylineno), yylineno);
+        (yyval.node)->type = AST_MEMBER_ACCESS;
+        free((yyvsp[0].string_val));
+    }
+#line 2742 "build/y.tab.c"
+    break;
+
+  case 143: /* postfix_expression: postfix_expression INC_OP  */
+#line 626 "src/parser/parser.y"
+                                {
+        (yyval.node) = create_unary_expr_node(OP_POSTINC, (yyvsp[-1].node), yylineno);
+    }
+#line 2750 "build/y.tab.c"
+    break;
+
+  case 144: /* postfix_expression: postfix_expression DEC_OP  */
+#line 629 "src/parser/parser.y"
+                                {
+        (yyval.node) = create_unary_expr_node(OP_POSTDEC, (yyvsp[-1].node), yylineno);
+    }
+#line 2758 "build/y.tab.c"
+    break;
+
+  case 145: /* argument_expression_list: assignment_expression  */
+#line 635 "src/parser/parser.y"
+                          {
+        (yyval.node) = create_ast_node(AST_ARG_LIST, yylineno);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2767 "build/y.tab.c"
+    break;
+
+  case 146: /* argument_expression_list: argument_expression_list COMMA assignment_expression  */
+#line 639 "src/parser/parser.y"
+                                                           {
+        (yyval.node) = (yyvsp[-2].node);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2776 "build/y.tab.c"
+    break;
+
+  case 147: /* primary_expression: IDENTIFIER  */
+#line 646 "src/parser/parser.y"
+               {
+        (yyval.node) = create_identifier_node((yyvsp[0].string_val), yylineno);
+        free((yyvsp[0].string_val));
+    }
+#line 2785 "build/y.tab.c"
+    break;
+
+  case 148: /* primary_expression: INTEGER_CONSTANT  */
+#line 650 "src/parser/parser.y"
+                       {
+        (yyval.node) = create_int_node((yyvsp[0].int_val), yylineno);
+    }
+#line 2793 "build/y.tab.c"
+    break;
+
+  case 149: /* primary_expression: FLOATING_CONSTANT  */
+#line 653 "src/parser/parser.y"
+                        {
+        (yyval.node) = create_float_node((yyvsp[0].float_val), 0, yylineno);
+    }
+#line 2801 "build/y.tab.c"
+    break;
+
+  case 150: /* primary_expression: FLOATING_CONSTANT_F  */
+#line 656 "src/parser/parser.y"
+                          {
+        (yyval.node) = create_float_node((yyvsp[0].float_val), 1, yylineno);
+    }
+#line 2809 "build/y.tab.c"
+    break;
+
+  case 151: /* primary_expression: STRING_LITERAL  */
+#line 659 "src/parser/parser.y"
+                     {
+        (yyval.node) = create_string_node((yyvsp[0].string_val), yylineno);
+        free((yyvsp[0].string_val));
+    }
+#line 2818 "build/y.tab.c"
+    break;
+
+  case 152: /* primary_expression: LPAREN expression RPAREN  */
+#line 663 "src/parser/parser.y"
+                               {
+        (yyval.node) = (yyvsp[-1].node);
+    }
+#line 2826 "build/y.tab.c"
+    break;
+
+  case 153: /* struct_specifier: STRUCT IDENTIFIER LBRACE struct_declaration_list RBRACE  */
+#line 669 "src/parser/parser.y"
+                                                            {
+        (yyval.node) = create_ast_node(AST_STRUCT_DEF, yylineno);
+        ASTNode *name = create_identifier_node((yyvsp[-3].string_val), yylineno);
+        add_child((yyval.node), name);
+        add_child((yyval.node), (yyvsp[-1].node));
+        free((yyvsp[-3].string_val));
+    }
+#line 2838 "build/y.tab.c"
+    break;
+
+  case 154: /* struct_specifier: STRUCT LBRACE struct_declaration_list RBRACE  */
+#line 676 "src/parser/parser.y"
+                                                   {
+        (yyval.node) = create_ast_node(AST_STRUCT_DEF, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 2847 "build/y.tab.c"
+    break;
+
+  case 155: /* struct_specifier: STRUCT IDENTIFIER  */
+#line 680 "src/parser/parser.y"
+                        {
+        (yyval.node) = create_ast_node(AST_STRUCT_DEF, yylineno);
+        ASTNode *name = create_identifier_node((yyvsp[0].string_val), yylineno);
+        add_child((yyval.node), name);
+        free((yyvsp[0].string_val));
+    }
+#line 2858 "build/y.tab.c"
+    break;
+
+  case 156: /* enum_specifier: ENUM IDENTIFIER LBRACE enumerator_list RBRACE  */
+#line 689 "src/parser/parser.y"
+                                                  {
+        (yyval.node) = create_ast_node(AST_ENUM_DEF, yylineno);
+        ASTNode *name_node = create_identifier_node((yyvsp[-3].string_val), yylineno);
+        add_child((yyval.node), name_node);
+        add_child((yyval.node), (yyvsp[-1].node));
+        free((yyvsp[-3].string_val));
+    }
+#line 2870 "build/y.tab.c"
+    break;
+
+  case 157: /* enum_specifier: ENUM LBRACE enumerator_list RBRACE  */
+#line 696 "src/parser/parser.y"
+                                         {
+        (yyval.node) = create_ast_node(AST_ENUM_DEF, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 2879 "build/y.tab.c"
+    break;
+
+  case 158: /* enumerator_list: IDENTIFIER  */
+#line 703 "src/parser/parser.y"
+               {
+        (yyval.node) = create_ast_node(AST_ENUM_CONST, yylineno);
+        (yyval.node)->value.string_val = strdup((yyvsp[0].string_val));
+        // 不要在这里设置int_val，会覆盖string_val（union类型）
+        free((yyvsp[0].string_val));
+    }
+#line 2890 "build/y.tab.c"
+    break;
+
+  case 159: /* enumerator_list: enumerator_list COMMA IDENTIFIER  */
+#line 709 "src/parser/parser.y"
+                                       {
+        (yyval.node) = (yyvsp[-2].node);
+        ASTNode *new_const = create_ast_node(AST_ENUM_CONST, yylineno);
+        new_const->value.string_val = strdup((yyvsp[0].string_val));
+        add_child((yyval.node), new_const);
+        free((yyvsp[0].string_val));
+    }
+#line 2902 "build/y.tab.c"
+    break;
+
+  case 160: /* struct_declaration_list: struct_declaration  */
+#line 719 "src/parser/parser.y"
+                       {
+        (yyval.node) = create_ast_node(AST_COMPOUND_STMT, yylineno);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2911 "build/y.tab.c"
+    break;
+
+  case 161: /* struct_declaration_list: struct_declaration_list struct_declaration  */
+#line 723 "src/parser/parser.y"
+                                                 {
+        (yyval.node) = (yyvsp[-1].node);
+        add_child((yyval.node), (yyvsp[0].node));
+    }
+#line 2920 "build/y.tab.c"
+    break;
+
+  case 162: /* struct_declaration: declaration_specifiers declarator SEMICOLON  */
+#line 730 "src/parser/parser.y"
+                                                {
+        (yyval.node) = create_ast_node(AST_DECLARATION, yylineno);
+        add_child((yyval.node), (yyvsp[-2].node));
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 2930 "build/y.tab.c"
+    break;
+
+  case 163: /* union_specifier: UNION IDENTIFIER LBRACE struct_declaration_list RBRACE  */
+#line 738 "src/parser/parser.y"
+                                                           {
+        (yyval.node) = create_ast_node(AST_UNION_DEF, yylineno);
+        ASTNode *name = create_identifier_node((yyvsp[-3].string_val), yylineno);
+        add_child((yyval.node), name);
+        add_child((yyval.node), (yyvsp[-1].node));
+        free((yyvsp[-3].string_val));
+    }
+#line 2942 "build/y.tab.c"
+    break;
+
+  case 164: /* union_specifier: UNION LBRACE struct_declaration_list RBRACE  */
+#line 745 "src/parser/parser.y"
+                                                  {
+        (yyval.node) = create_ast_node(AST_UNION_DEF, yylineno);
+        add_child((yyval.node), (yyvsp[-1].node));
+    }
+#line 2951 "build/y.tab.c"
+    break;
+
+  case 165: /* union_specifier: UNION IDENTIFIER  */
+#line 749 "src/parser/parser.y"
+                       {
+        (yyval.node) = create_ast_node(AST_UNION_DEF, yylineno);
+        ASTNode *name = create_identifier_node((yyvsp[0].string_val), yylineno);
+        add_child((yyval.node), name);
+        free((yyvsp[0].string_val));
+    }
+#line 2962 "build/y.tab.c"
+    break;
+
+
+#line 2966 "build/y.tab.c"
+
+      default: break;
+    }
+  /* User semantic actions sometimes alter yychar, and that requires
+     that yytoken be updated with the new translation.  We take the
+     approach of translating immediately before every use of yytoken.
+     One alternative is translating here after every semantic action,
+     but that translation would be missed if the semantic action invokes
+     YYABORT, YYACCEPT, or YYERROR immediately after altering yychar or
+     if it invokes YYBACKUP.  In the case of YYABORT or YYACCEPT, an
+     incorrect destructor might then be invoked immediately.  In the
+     case of YYERROR or YYBACKUP, subsequent parser actions might lead
+     to an incorrect destructor call or verbose syntax error message
+     before the lookahead is translated.  */
+  YY_SYMBOL_PRINT ("-> $$ =", YY_CAST (yysymbol_kind_t, yyr1[yyn]), &yyval, &yyloc);
+
+  YYPOPSTACK (yylen);
+  yylen = 0;
+
+  *++yyvsp = yyval;
+
+  /* Now 'shift' the result of the reduction.  Determine what state
+     that goes to, based on the state we popped back to and the rule
+     number reduced by.  */
+  {
+    const int yylhs = yyr1[yyn] - YYNTOKENS;
+    const int yyi = yypgoto[yylhs] + *yyssp;
+    yystate = (0 <= yyi && yyi <= YYLAST && yycheck[yyi] == *yyssp
+               ? yytable[yyi]
+               : yydefgoto[yylhs]);
+  }
+
+  goto yynewstate;
+
+
+/*--------------------------------------.
+| yyerrlab -- here on detecting error.  |
+`--------------------------------------*/
+yyerrlab:
+  /* Make sure we have latest lookahead translation.  See comments at
+     user semantic actions for why this is necessary.  */
+  yytoken = yychar == YYEMPTY ? YYSYMBOL_YYEMPTY : YYTRANSLATE (yychar);
+  /* If not already recovering from an error, report this error.  */
+  if (!yyerrstatus)
+    {
+      ++yynerrs;
+      yyerror (scanner, ast_root, YY_("syntax error"));
+    }
+
+  if (yyerrstatus == 3)
+    {
+      /* If just tried and failed to reuse lookahead token after an
+         error, discard it.  */
+
+      if (yychar <= YYEOF)
+        {
+          /* Return failure if at end of input.  */
+          if (yychar == YYEOF)
+            YYABORT;
+        }
+      else
+        {
+          yydestruct ("Error: discarding",
+                      yytoken, &yylval, scanner, ast_root);
+          yychar = YYEMPTY;
+        }
+    }
+
+  /* Else will try to reuse lookahead token after shifting the error
+     token.  */
+  goto yyerrlab1;
+
+
+/*---------------------------------------------------.
+| yyerrorlab -- error raised explicitly by YYERROR.  |
+`---------------------------------------------------*/
+yyerrorlab:
+  /* Pacify compilers when the user code never invokes YYERROR and the
+     label yyerrorlab therefore never appears in user code.  */
+  if (0)
+    YYERROR;
+  ++yynerrs;
+
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYERROR.  */
+  YYPOPSTACK (yylen);
+  yylen = 0;
+  YY_STACK_PRINT (yyss, yyssp);
+  yystate = *yyssp;
+  goto yyerrlab1;
+
+
+/*-------------------------------------------------------------.
+| yyerrlab1 -- common code for both syntax error and YYERROR.  |
+`-------------------------------------------------------------*/
+yyerrlab1:
+  yyerrstatus = 3;      /* Each real token shifted decrements this.  */
+
+  /* Pop stack until we find a state that shifts the error token.  */
+  for (;;)
+    {
+      yyn = yypact[yystate];
+      if (!yypact_value_is_default (yyn))
+        {
+          yyn += YYSYMBOL_YYerror;
+          if (0 <= yyn && yyn <= YYLAST && yycheck[yyn] == YYSYMBOL_YYerror)
+            {
+              yyn = yytable[yyn];
+              if (0 < yyn)
+                break;
+            }
+        }
+
+      /* Pop the current state because it cannot handle the error token.  */
+      if (yyssp == yyss)
+        YYABORT;
+
+
+      yydestruct ("Error: popping",
+                  YY_ACCESSING_SYMBOL (yystate), yyvsp, scanner, ast_root);
+      YYPOPSTACK (1);
+      yystate = *yyssp;
+      YY_STACK_PRINT (yyss, yyssp);
+    }
+
+  YY_IGNORE_MAYBE_UNINITIALIZED_BEGIN
+  *++yyvsp = yylval;
+  YY_IGNORE_MAYBE_UNINITIALIZED_END
+
+
+  /* Shift the error token.  */
+  YY_SYMBOL_PRINT ("Shifting", YY_ACCESSING_SYMBOL (yyn), yyvsp, yylsp);
+
+  yystate = yyn;
+  goto yynewstate;
+
+
+/*-------------------------------------.
+| yyacceptlab -- YYACCEPT comes here.  |
+`-------------------------------------*/
+yyacceptlab:
+  yyresult = 0;
+  goto yyreturnlab;
+
+
+/*-----------------------------------.
+| yyabortlab -- YYABORT comes here.  |
+`-----------------------------------*/
+yyabortlab:
+  yyresult = 1;
+  goto yyreturnlab;
+
+
+/*-----------------------------------------------------------.
+| yyexhaustedlab -- YYNOMEM (memory exhaustion) comes here.  |
+`-----------------------------------------------------------*/
+yyexhaustedlab:
+  yyerror (scanner, ast_root, YY_("memory exhausted"));
+  yyresult = 2;
+  goto yyreturnlab;
+
+
+/*----------------------------------------------------------.
+| yyreturnlab -- parsing is finished, clean up and return.  |
+`----------------------------------------------------------*/
+yyreturnlab:
+  if (yychar != YYEMPTY)
+    {
+      /* Make sure we have latest lookahead translation.  See comments at
+         user semantic actions for why this is necessary.  */
+      yytoken = YYTRANSLATE (yychar);
+      yydestruct ("Cleanup: discarding lookahead",
+                  yytoken, &yylval, scanner, ast_root);
+    }
+  /* Do not reclaim the symbols of the rule whose action triggered
+     this YYABORT or YYACCEPT.  */
+  YYPOPSTACK (yylen);
+  YY_STACK_PRINT (yyss, yyssp);
+  while (yyssp != yyss)
+    {
+      yydestruct ("Cleanup: popping",
+                  YY_ACCESSING_SYMBOL (+*yyssp), yyvsp, scanner, ast_root);
+      YYPOPSTACK (1);
+    }
+#ifndef yyoverflow
+  if (yyss != yyssa)
+    YYSTACK_FREE (yyss);
+#endif
+
+  return yyresult;
+}
+
+#line 757 "src/parser/parser.y"
+
+
+void yyerror(yyscan_t scanner, ASTNode **ast_root, const char *s) {
+    (void)ast_root;
+    fprintf(yyget_extra(scanner), "Parse Error at line %d: %s near '%s'\n",
+            yylineno, s, yyget_text(scanner));
+}
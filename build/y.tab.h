@@ -0,0 +1,179 @@
+/* A Bison parser, made by GNU Bison 3.8.2.  */
+
+/* Bison interface for Yacc-like parsers in C
+
+   Copyright (C) 1984, 1989-1990, 2000-2015, 2018-2021 Free Software Foundation,
+   Inc.
+
+   This program is free software: you can redistribute it and/or modify
+   it under the terms of the GNU General Public License as published by
+   the Free Software Foundation, either version 3 of the License, or
+   (at your option) any later version.
+
+   This program is distributed in the hope that it will be useful,
+   but WITHOUT ANY WARRANTY; without even the implied warranty of
+   MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+   GNU General Public License for more details.
+
+   You should have received a copy of the GNU General Public License
+   along with this program.  If not, see <https://www.gnu.org/licenses/>.  */
+
+/* As a special exception, you may create a larger work that contains
+   part or all of the Bison parser skeleton and distribute that work
+   under terms of your choice, so long as that work isn't itself a
+   parser generator using the skeleton or a modified version thereof
+   as a parser skeleton.  Alternatively, if you modify or redistribute
+   the parser skeleton itself, you may (at your option) remove this
+   special exception, which will cause the skeleton and the resulting
+   Bison output files to be licensed under the GNU General Public
+   License without this special exception.
+
+   This special exception was added by the Free Software Foundation in
+   version 2.2 of Bison.  */
+
+/* DO NOT RELY ON FEATURES THAT ARE NOT DOCUMENTED in the manual,
+   especially those whose name start with YY_ or yy_.  They are
+   private implementation details that can be changed or removed.  */
+
+#ifndef YY_YY_BUILD_Y_TAB_H_INCLUDED
+# define YY_YY_BUILD_Y_TAB_H_INCLUDED
+/* Debug traces.  */
+#ifndef YYDEBUG
+# define YYDEBUG 0
+#endif
+#if YYDEBUG
+extern int yydebug;
+#endif
+/* "%code requires" blocks.  */
+#line 8 "src/parser/parser.y"
+
+#include "ast.h"
+
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+
+#line 58 "build/y.tab.h"
+
+/* Token kinds.  */
+#ifndef YYTOKENTYPE
+# define YYTOKENTYPE
+  enum yytokentype
+  {
+    YYEMPTY = -2,
+    YYEOF = 0,                     /* "end of file"  */
+    YYerror = 256,                 /* error  */
+    YYUNDEF = 257,                 /* "invalid token"  */
+    IDENTIFIER = 258,              /* IDENTIFIER  */
+    INTEGER_CONSTANT = 259,        /* INTEGER_CONSTANT  */
+    FLOATING_CONSTANT = 260,       /* FLOATING_CONSTANT  */
+    FLOATING_CONSTANT_F = 261,     /* FLOATING_CONSTANT_F  */
+    CHARACTER_CONSTANT = 262,      /* CHARACTER_CONSTANT  */
+    STRING_LITERAL = 263,          /* STRING_LITERAL  */
+    INT = 264,                     /* INT  */
+    FLOAT = 265,                   /* FLOAT  */
+    CHAR = 266,                    /* CHAR  */
+    VOID = 267,                    /* VOID  */
+    SHORT = 268,                   /* SHORT  */
+    LONG = 269,                    /* LONG  */
+    DOUBLE = 270,                  /* DOUBLE  */
+    UNSIGNED = 271,                /* UNSIGNED  */
+    STRUCT = 272,                  /* STRUCT  */
+    UNION = 273,                   /* UNION  */
+    STATIC = 274,                  /* STATIC  */
+    EXTERN = 275,                  /* EXTERN  */
+    TYPEDEF = 276,                 /* TYPEDEF  */
+    ENUM = 277,                    /* ENUM  */
+    SIZEOF = 278,                  /* SIZEOF  */
+    RETURN = 279,                  /* RETURN  */
+    IF = 280,                      /* IF  */
+    ELSE = 281,                    /* ELSE  */
+    WHILE = 282,                   /* WHILE  */
+    DO = 283,                      /* DO  */
+    FOR = 284,                     /* FOR  */
+    SWITCH = 285,                  /* SWITCH  */
+    CASE = 286,                    /* CASE  */
+    DEFAULT = 287,                 /* DEFAULT  */
+    BREAK = 288,                   /* BREAK  */
+    CONTINUE = 289,                /* CONTINUE  */
+    ASM = 290,                     /* ASM  */
+    CONST = 291,                   /* CONST  */
+    VOLATILE = 292,                /* VOLATILE  */
+    INLINE = 293,                  /* INLINE  */
+    SEMICOLON = 294,               /* SEMICOLON  */
+    LBRACE = 295,                  /* LBRACE  */
+    RBRACE = 296,                  /* RBRACE  */
+    COMMA = 297,                   /* COMMA  */
+    LPAREN = 298,                  /* LPAREN  */
+    RPAREN = 299,                  /* RPAREN  */
+    LBRACKET = 300,                /* LBRACKET  */
+    RBRACKET = 301,                /* RBRACKET  */
+    ASSIGN = 302,                  /* ASSIGN  */
+    ADD_ASSIGN = 303,              /* ADD_ASSIGN  */
+    SUB_ASSIGN = 304,              /* SUB_ASSIGN  */
+    MUL_ASSIGN = 305,              /* MUL_ASSIGN  */
+    DIV_ASSIGN = 306,              /* DIV_ASSIGN  */
+    MOD_ASSIGN = 307,              /* MOD_ASSIGN  */
+    AND_ASSIGN = 308,              /* AND_ASSIGN  */
+    OR_ASSIGN = 309,               /* OR_ASSIGN  */
+    XOR_ASSIGN = 310,              /* XOR_ASSIGN  */
+    LEFT_ASSIGN = 311,             /* LEFT_ASSIGN  */
+    RIGHT_ASSIGN = 312,            /* RIGHT_ASSIGN  */
+    PLUS = 313,                    /* PLUS  */
+    MINUS = 314,                   /* MINUS  */
+    STAR = 315,                    /* STAR  */
+    SLASH = 316,                   /* SLASH  */
+    PERCENT = 317,                 /* PERCENT  */
+    AMPERSAND = 318,               /* AMPERSAND  */
+    LT = 319,                      /* LT  */
+    GT = 320,                      /* GT  */
+    LE_OP = 321,                   /* LE_OP  */
+    GE_OP = 322,                   /* GE_OP  */
+    EQ_OP = 323,                   /* EQ_OP  */
+    NE_OP = 324,                   /* NE_OP  */
+    LEFT_SHIFT = 325,              /* LEFT_SHIFT  */
+    RIGHT_SHIFT = 326,             /* RIGHT_SHIFT  */
+    AND_OP = 327,                  /* AND_OP  */
+    OR_OP = 328,                   /* OR_OP  */
+    NOT_OP = 329,                  /* NOT_OP  */
+    PIPE = 330,                    /* PIPE  */
+    XOR = 331,                     /* XOR  */
+    TILDE = 332,                   /* TILDE  */
+    DOT = 333,                     /* DOT  */
+    ARROW = 334,                   /* ARROW  */
+    INC_OP = 335,                  /* INC_OP  */
+    DEC_OP = 336,                  /* DEC_OP  */
+    QUESTION = 337,                /* QUESTION  */
+    COLON = 338,                   /* COLON  */
+    ELLIPSIS = 339                 /* ELLIPSIS  */
+  };
+  typedef enum yytokentype yytoken_kind_t;
+#endif
+
+/* Value type.  */
+#if ! defined YYSTYPE && ! defined YYSTYPE_IS_DECLARED
+union YYSTYPE
+{
+#line 33 "src/parser/parser.y"
+
+    int int_val;
+    double float_val;
+    char *string_val;
+    ASTNode *node;
+
+#line 166 "build/y.tab.h"
+
+};
+typedef union YYSTYPE YYSTYPE;
+# define YYSTYPE_IS_TRIVIAL 1
+# define YYSTYPE_IS_DECLARED 1
+#endif
+
+
+
+
+int yyparse (yyscan_t scanner, ASTNode **ast_root);
+
+
+#endif /* !YY_YY_BUILD_Y_TAB_H_INCLUDED  */
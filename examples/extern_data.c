@@ -0,0 +1,47 @@
+// 访问在别处定义的数据：libc 的 optind/opterr/stdout。
+// 即时运行（--run）时这些对象在宿主进程中，可能离生成的代码超过 ±2GB，
+// 经 GOT 表项取地址，和编译成可执行文件的结果相同
+
+int printf(char *fmt, ...);
+int fputs(char *s, void *stream);
+int fflush(void *stream);
+
+extern void *stdout;
+extern int optind;
+extern int opterr;
+
+int twice(int x)
+{
+    return x * 2;
+}
+
+// 含浮点运算的函数由语法树直接生成代码
+double scaled(double k)
+{
+    double x = optind;
+    optind = twice(optind) + 1;
+    return x * k;
+}
+
+int main()
+{
+    int *p;
+    p = &opterr;
+    *p = *p + 41;
+    optind += 2;
+    opterr++;
+    fputs("written through stdout\n", stdout);
+    fflush(stdout);
+    printf("optind %d opterr %d\n", optind, opterr);
+
+    int sum = 0;
+    for (int i = 0; i < 10; i++)
+        sum += optind + i;
+    printf("sum %d\n", sum);
+
+    double r = scaled(2.5);
+    printf("scaled %d optind %d\n", r > 7.0, optind);
+    optind = 1;
+    opterr = 1;
+    return 0;
+}
@@ -0,0 +1,97 @@
+// 归约和逐元素循环的剩余迭代：长度 0..40 覆盖向量宽度（4/8 个 int、2/4 个 long）
+// 和展开份数的每一种余数。各个优化级别（-funroll-loops、-mavx2 等）的输出必须和 -O0 相同
+
+int printf(char *fmt, ...);
+
+long sum_int(int *a, int n)
+{
+    long s = 0;
+    for (int i = 0; i < n; i++)
+        s += a[i];
+    return s;
+}
+
+long sum_long(long *a, int n)
+{
+    long s = 0;
+    for (int i = 0; i < n; i++)
+        s = s + a[i];
+    return s;
+}
+
+int min_int(int *a, int n)
+{
+    int m = 2147483647;
+    for (int i = 0; i < n; i++)
+    {
+        if (a[i] < m)
+            m = a[i];
+    }
+    return m;
+}
+
+int max_int(int *a, int n)
+{
+    int m = -2147483647;
+    for (int i = 0; i < n; i++)
+        m = a[i] > m ? a[i] : m;
+    return m;
+}
+
+int bits(int *a, int n)
+{
+    int x = 0;
+    int o = 0;
+    int y = -1;
+    for (int i = 0; i < n; i++)
+    {
+        x ^= a[i];
+        o |= a[i];
+        y &= a[i];
+    }
+    return x + o * 3 + y * 7;
+}
+
+// 逐元素运算，起点不为 0
+void axpy(int *c, int *a, int *b, int k, int start, int n)
+{
+    for (int i = start; i < n; i++)
+        c[i] = a[i] + b[i] * k;
+}
+
+// 结果截断成 int 的求和
+int sum_wrap(int *a, int n)
+{
+    int s = 0;
+    for (int i = 0; i < n; i++)
+        s += a[i] * 65536;
+    return s;
+}
+
+int main()
+{
+    int a[40];
+    int b[40];
+    int c[40];
+    long l[40];
+    long big = 1000000007;
+    for (int i = 0; i < 40; i++)
+    {
+        a[i] = (i * 37 + 11) % 101 - 50;
+        b[i] = i * i - 300;
+        l[i] = i * big - 5;
+        c[i] = 0;
+    }
+
+    long check = 0;
+    for (int n = 0; n <= 40; n++)
+    {
+        printf("%d: %ld %ld %d %d %d %d\n", n, sum_int(a, n), sum_long(l, n), min_int(a, n), max_int(a, n),
+               bits(b, n), sum_wrap(b, n));
+        axpy(c, a, b, n - 3, n / 3, n);
+        for (int i = 0; i < 40; i++)
+            check = check * 31 + c[i];
+    }
+    printf("axpy %ld\n", check);
+    return 0;
+}
@@ -0,0 +1,191 @@
+// switch 的两种降低方式：稠密的 case 值生成跳转表，稀疏的按簇二分查找。
+// 边界值、负数、跳转表中的空洞、fallthrough 和没有 default 的情况都要和 -O0 的结果相同
+
+int printf(char *fmt, ...);
+
+// 稠密：0..9 中有两个空洞，走跳转表
+int dense(int x)
+{
+    switch (x)
+    {
+    case 0:
+        return 100;
+    case 1:
+        return 101;
+    case 2:
+    case 3:
+        return 123;
+    case 5:
+        return 105;
+    case 6:
+        x = x * 3;
+    case 7:
+        return x + 7; // 6 落到这里
+    case 9:
+        return 109;
+    default:
+        return -1;
+    }
+}
+
+// 稠密但从负数开始
+int negative(int x)
+{
+    int r = 0;
+    switch (x)
+    {
+    case -3:
+        r = 30;
+        break;
+    case -2:
+        r = 20;
+        break;
+    case -1:
+        r = 10;
+        break;
+    case 0:
+        r = 1;
+        break;
+    case 1:
+        r = 2;
+    case 2:
+        r = r + 3;
+        break;
+    }
+    return r;
+}
+
+// 稀疏：二分查找，没有 default
+int sparse(int x)
+{
+    int r = 7;
+    switch (x)
+    {
+    case -100000:
+        r = 1;
+        break;
+    case 3:
+        r = 2;
+        break;
+    case 1000:
+        r = 3;
+        break;
+    case 1001:
+        r = 4;
+        break;
+    case 65536:
+        r = 5;
+        break;
+    case 2147483647:
+        r = 6;
+        break;
+    case -2147483647:
+        r = 8;
+        break;
+    }
+    return r;
+}
+
+// 一个稠密的簇加上远处的几个值
+int clustered(int x)
+{
+    switch (x)
+    {
+    case 10:
+        return 1;
+    case 11:
+        return 2;
+    case 12:
+        return 3;
+    case 13:
+        return 4;
+    case 14:
+        return 5;
+    case 500:
+        return 6;
+    case 900:
+        return 7;
+    default:
+        return 0;
+    }
+}
+
+// char 类型的选择表达式（字符按 ASCII 码书写）
+int classify(char c)
+{
+    switch (c)
+    {
+    case 97:
+    case 101:
+    case 105:
+    case 111:
+    case 117:
+        return 1;
+    case 32:
+        return 2;
+    case 48:
+    case 49:
+    case 50:
+    case 51:
+        return 3;
+    default:
+        return 0;
+    }
+}
+
+int main()
+{
+    int total = 0;
+    for (int i = -3; i < 12; i++)
+    {
+        printf("%d:%d ", i, dense(i));
+        total = total + dense(i);
+    }
+    printf("\n");
+
+    for (int i = -5; i < 5; i++)
+        printf("%d ", negative(i));
+    printf("\n");
+
+    int keys[12];
+    keys[0] = -100000;
+    keys[1] = -99999;
+    keys[2] = 3;
+    keys[3] = 4;
+    keys[4] = 999;
+    keys[5] = 1000;
+    keys[6] = 1001;
+    keys[7] = 65536;
+    keys[8] = 2147483647;
+    keys[9] = 2147483646;
+    keys[10] = -2147483647;
+    keys[11] = 0;
+    for (int i = 0; i < 12; i++)
+        printf("%d ", sparse(keys[i]));
+    printf("\n");
+
+    int sum = 0;
+    for (int i = 0; i < 1000; i++)
+        sum = sum + clustered(i) * i;
+    printf("clustered %d\n", sum);
+
+    char text[32];
+    int n = 0;
+    text[n++] = 104;
+    text[n++] = 101;
+    text[n++] = 108;
+    text[n++] = 108;
+    text[n++] = 111;
+    text[n++] = 32;
+    text[n++] = 50;
+    text[n++] = 48;
+    text[n++] = 57;
+    text[n++] = 117;
+    int counts[4];
+    for (int i = 0; i < 4; i++)
+        counts[i] = 0;
+    for (int i = 0; i < n; i++)
+        counts[classify(text[i])]++;
+    printf("classes %d %d %d %d total %d\n", counts[0], counts[1], counts[2], counts[3], total);
+    return 0;
+}
@@ -0,0 +1,110 @@
+// 尾调用：自身尾递归变成循环，结果再乘上或加上一个值的递归用累加器改写，
+// 调用其他函数的尾调用变成 jmp。各个优化级别的输出必须和 -O0 相同
+
+int printf(char *fmt, ...);
+
+// 自身尾递归，参数互相交换
+int gcd(int a, int b)
+{
+    if (b == 0)
+        return a;
+    return gcd(b, a % b);
+}
+
+// 递归深度 100000：-O0 时是真正的递归，-O1 起是循环
+long count_down(long n, long acc)
+{
+    if (n == 0)
+        return acc;
+    return count_down(n - 1, acc + n);
+}
+
+// 结果再乘上一个值：累加器改写
+long fact(int n)
+{
+    if (n <= 1)
+        return 1;
+    return n * fact(n - 1);
+}
+
+// 结果再加上一个值
+int sum_to(int n)
+{
+    if (n == 0)
+        return 0;
+    return n + sum_to(n - 1);
+}
+
+// 两次递归调用，只有后一次在尾部
+int fib(int n)
+{
+    if (n < 2)
+        return n;
+    return fib(n - 1) + fib(n - 2);
+}
+
+// 参数用完 6 个寄存器的尾调用
+int weigh(int a, int b, int c, int d, int e, int f)
+{
+    return a + 2 * b + 3 * c + 4 * d + 5 * e + 6 * f;
+}
+
+int rotate(int a, int b, int c, int d, int e, int f)
+{
+    return weigh(f, a, b, c, d, e);
+}
+
+// 互相尾调用
+int is_odd(int n);
+
+int is_even(int n)
+{
+    if (n == 0)
+        return 1;
+    return is_odd(n - 1);
+}
+
+int is_odd(int n)
+{
+    if (n == 0)
+        return 0;
+    return is_even(n - 1);
+}
+
+// 取过局部对象地址的函数不能拆掉栈帧
+int through_pointer(int *p)
+{
+    return *p + 1;
+}
+
+int keeps_frame(int x)
+{
+    int local = x * 2;
+    return through_pointer(&local);
+}
+
+// 没有返回值的尾递归
+int visited;
+
+void walk(int n)
+{
+    if (n == 0)
+        return;
+    visited = visited + n;
+    walk(n - 1);
+}
+
+int main()
+{
+    printf("gcd %d %d %d\n", gcd(1071, 462), gcd(17, 5), gcd(0, 9));
+    printf("count_down %ld\n", count_down(100000, 0));
+    printf("fact %ld %ld %ld\n", fact(0), fact(10), fact(20));
+    printf("sum_to %d %d\n", sum_to(0), sum_to(1000));
+    printf("fib %d %d\n", fib(1), fib(20));
+    printf("rotate %d\n", rotate(1, 2, 3, 4, 5, 6));
+    printf("parity %d %d %d\n", is_even(10), is_even(7), is_odd(1001));
+    printf("keeps_frame %d\n", keeps_frame(20));
+    walk(100);
+    printf("walk %d\n", visited);
+    return 0;
+}
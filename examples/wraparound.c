@@ -0,0 +1,77 @@
+// 整数变量的截断：不足 8 字节的变量赋值、参数、返回值都要回绕到类型的取值范围，
+// 各个优化级别（-O0/-O1/-O2、-funroll-loops、-mavx2）的输出必须相同
+
+int printf(char *fmt, ...);
+
+int narrow(long x)
+{
+    return x;
+}
+
+char to_char(int x)
+{
+    return x;
+}
+
+int take_char(char c)
+{
+    return c;
+}
+
+static int take_short(short s)
+{
+    return s;
+}
+
+// 自身尾递归变成循环之后，参数仍然按 char 截断
+int count_up(char c, int n)
+{
+    if (n == 0)
+        return c;
+    return count_up(c + 1, n - 1);
+}
+
+int main()
+{
+    long big = 65536;
+    big = big * 65536 + 5;
+    int t = big;
+    long back = t;
+    printf("int from long: %ld %d\n", back, narrow(big) == 5);
+
+    char c = 300;
+    short s = 65535;
+    unsigned u = -1;
+    printf("init: %d %d %u\n", c, s, u);
+
+    short h = 32767;
+    h = h + 1;
+    short g = 32767;
+    g += 1;
+    short k = 32767;
+    k++;
+    printf("short: %d %d %d\n", h, g, k);
+
+    int count = 0;
+    char ch;
+    for (ch = 0; ch < 200 && count < 1000; ch++)
+        count++;
+    printf("char counter: %d %d\n", count, ch);
+
+    printf("calls: %d %d %d %d\n", to_char(200), take_char(384), take_short(98304), count_up(0, 300));
+
+    int values[37];
+    for (int i = 0; i < 37; i++)
+    {
+        values[i] = i * 7 + 100;
+    }
+    char char_sum = 0;
+    short short_sum = 0;
+    for (int i = 0; i < 37; i++)
+    {
+        char_sum = char_sum + values[i];
+        short_sum += values[i] * 50;
+    }
+    printf("sums: %d %d\n", char_sum, short_sum);
+    return 0;
+}
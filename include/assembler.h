@@ -0,0 +1,80 @@
+#ifndef ASSEMBLER_H
+#define ASSEMBLER_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// 内置汇编器：把代码生成器输出的 AT&T 汇编（x86-64 子集）直接编码为机器码，
+// 结果保存在内存中的 ObjectCode 里，可以写成 ELF 目标文件
+
+// 段编号
+typedef enum
+{
+    SECTION_TEXT,
+    SECTION_DATA,
+    SECTION_RODATA,
+    SECTION_COUNT
+} SectionIndex;
+
+// 重定位类型（取值与 ELF 的 R_X86_64_* 一致）
+typedef enum
+{
+    RELOC_ABS64 = 1,   // R_X86_64_64：S + A
+    RELOC_PC32 = 2,    // R_X86_64_PC32：S + A - P
+    RELOC_PLT32 = 4,   // R_X86_64_PLT32：L + A - P（函数调用）
+    RELOC_GOTPCREL = 9 // R_X86_64_GOTPCREL：G + GOT + A - P（从 GOT 表项读取外部数据的地址）
+} RelocType;
+
+// 重定位项
+typedef struct Relocation
+{
+    size_t offset;  // 在段内的偏移
+    int symbol;     // 符号下标（ObjectCode.symbols）
+    RelocType type; // 重定位类型
+    long addend;    // 加数
+} Relocation;
+
+// 段内容
+typedef struct Section
+{
+    const char *name;      // 段名（.text/.data/.rodata）
+    unsigned char *data;   // 段数据
+    size_t size;           // 段大小
+    size_t capacity;       // 缓冲区容量
+    int alignment;         // 对齐要求
+    Relocation *relocs;    // 重定位表
+    int num_relocs;        // 重定位项数量
+    int reloc_capacity;    // 重定位表容量
+} Section;
+
+// 符号
+typedef struct AsmSymbol
+{
+    char *name;      // 符号名
+    int section;     // 所在段（未定义时为 -1）
+    size_t offset;   // 段内偏移
+    int is_global;   // .globl 声明
+    int is_function; // .type name, @function
+    int is_defined;  // 是否已定义
+} AsmSymbol;
+
+// 汇编结果
+typedef struct ObjectCode
+{
+    Section sections[SECTION_COUNT];
+    AsmSymbol *symbols;
+    int num_symbols;
+    int symbol_capacity;
+} ObjectCode;
+
+// 汇编一段文本，失败（例如遇到不支持的指令）时返回 NULL，原因写入 diag
+ObjectCode *assemble(const char *source, FILE *diag);
+void object_code_free(ObjectCode *obj);
+
+// 按名字查找符号，找不到返回 -1
+int object_find_symbol(ObjectCode *obj, const char *name);
+
+// 局部标签（.L 开头）不会出现在目标文件的符号表中
+int is_local_label(const char *name);
+
+#endif // ASSEMBLER_H
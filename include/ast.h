@@ -114,7 +114,11 @@ typedef struct ASTNode
     union
     {
         int int_val;
-        float float_val;
+        struct
+        {
+            double value;
+            int is_float; // 带 f/F 后缀的常量是 float，否则是 double
+        } float_val;
         char *string_val;
         OperatorType op_type;
     } value;
@@ -126,7 +130,7 @@ typedef struct ASTNode
 // 函数声明
 ASTNode *create_ast_node(ASTNodeType type, int lineno);
 ASTNode *create_int_node(int value, int lineno);
-ASTNode *create_float_node(float value, int lineno);
+ASTNode *create_float_node(double value, int is_float, int lineno);
 ASTNode *create_string_node(const char *value, int lineno);
 ASTNode *create_identifier_node(const char *name, int lineno);
 ASTNode *create_binary_expr_node(OperatorType op, ASTNode *left, ASTNode *right, int lineno);
@@ -0,0 +1,33 @@
+#ifndef BUILD_DB_H
+#define BUILD_DB_H
+
+// --incremental：记录每个编译单元的依赖（源文件 + 所有 #include 的头文件），
+// 再次编译时只重新编译源文件或任一头文件发生变化的单元。
+//
+// 每个依赖保存修改时间、大小和 SHA-256：修改时间和大小都没变时直接认为未变化，
+// 否则比较内容摘要（只 touch 过的文件不会触发重新编译）
+
+// 默认数据库文件（位于当前目录）
+#define BUILD_DB_DEFAULT_PATH ".vc_build_db"
+
+typedef struct BuildDb BuildDb;
+
+// 读入数据库，文件不存在时返回空数据库
+BuildDb *build_db_open(const char *path);
+// 有改动时写回文件（先写临时文件再改名），然后释放
+void build_db_close(BuildDb *db);
+
+// output 存在、flags 相同且所有依赖都没有变化时返回 1（可以在多个线程中调用）
+int build_db_is_up_to_date(BuildDb *db, const char *source, const char *output, const char *flags);
+// 编译成功后记录（替换）该单元的依赖
+void build_db_record(BuildDb *db, const char *source, const char *output, const char *flags,
+                     char **headers, int num_headers);
+
+// -MD：写出 make 格式的依赖文件 "target: source headers..."，成功返回 0
+int write_dependency_file(const char *dep_file, const char *target, const char *source,
+                          char **headers, int num_headers);
+// 不重新编译的单元按数据库中记录的头文件写出依赖文件，没有该单元的记录时返回 -1
+int build_db_write_dependency_file(BuildDb *db, const char *dep_file, const char *source,
+                                   const char *output);
+
+#endif // BUILD_DB_H
@@ -3,6 +3,8 @@
 
 #include "ast.h"
 #include "semantic.h"
+#include "ir.h"
+#include "pass_manager.h"
 #include <stdio.h>
 
 // 循环上下文（用于 break/continue）
@@ -31,15 +33,34 @@ typedef struct CodeGenerator
     int max_stack_size;         // 最大栈大小
     LoopContext *loop_context;  // 当前循环上下文（用于 break/continue）
     int return_label;           // 当前函数的返回标签
-    StringConstant **strings;   // 字符串常量数组
+    int rbx_save_offset;        // 栈式代码生成的函数把 %rbx 保存在这个 %rbp 偏移处
+    TypeInfo *return_type;      // 栈式代码生成中当前函数的返回类型（浮点值在 %xmm0 中返回）
+    StringConstant **strings;   // 字符串常量数组（相同内容只保存一份）
     int num_strings;            // 字符串常量数量
     int string_capacity;        // 字符串数组容量
+    Symbol **data_symbols;      // 所有编译单元的全局/静态变量，最后统一输出到 .data
+    int num_data_symbols;
+    int data_capacity;
+    int num_units;              // 已生成的编译单元数
+    int rename_statics;         // --unity：静态符号加上编译单元编号，避免文件之间重名
+    FILE *ir_dump;              // --dump-ir：每个函数的 IR 输出到这里（NULL 表示不输出）
+    PassManager *passes;        // 优化遍（-O 级别和 -f 开关），默认 -O1
+    PeepholeBuffer *asm_buffer; // emit() 输出的指令先缓冲到这里，每个函数结束时经窥孔优化后写入 output
 } CodeGenerator;
 
 // 主要函数
 CodeGenerator *codegen_create(FILE *output, SemanticAnalyzer *analyzer);
 void codegen_destroy(CodeGenerator *gen);
 void generate_code(CodeGenerator *gen, ASTNode *root);
+// 替换优化选项（在生成代码之前调用）
+void codegen_set_pass_options(CodeGenerator *gen, const PassOptions *options);
+
+// 把多个编译单元生成到同一个汇编文件（--unity）：
+// codegen_begin → 每个文件一次 codegen_add_unit → codegen_finish。
+// 在 codegen_finish 之前，各单元的 AST 和语义分析器必须保持有效
+void codegen_begin(CodeGenerator *gen);
+void codegen_add_unit(CodeGenerator *gen, SemanticAnalyzer *analyzer, ASTNode *root);
+void codegen_finish(CodeGenerator *gen);
 
 // 代码生成函数
 void gen_function(CodeGenerator *gen, ASTNode *node);
@@ -47,11 +68,17 @@ void gen_statement(CodeGenerator *gen, ASTNode *node);
 void gen_expression(CodeGenerator *gen, ASTNode *node);
 
 // 辅助函数
-void gen_prologue(CodeGenerator *gen, const char *func_name);
+void gen_prologue(CodeGenerator *gen, const char *func_name, int is_static, int frame_size);
 void gen_epilogue(CodeGenerator *gen);
 int new_label(CodeGenerator *gen);
+int add_string_constant(CodeGenerator *gen, const char *str);
 void emit(CodeGenerator *gen, const char *format, ...);
 
+// 寄存器分配后端：函数先降低为 IR（ir_lower.c），分配寄存器后输出（ir_x86.c）。
+// ir_lower_function 遇到不支持的结构时返回 NULL，由 gen_function 回退到栈式代码生成
+IrFunction *ir_lower_function(CodeGenerator *gen, ASTNode *node);
+void ir_emit_function(CodeGenerator *gen, IrFunction *func, RegAllocation *alloc);
+
 // 栈管理
 void push_reg(CodeGenerator *gen, const char *reg);
 void pop_reg(CodeGenerator *gen, const char *reg);
@@ -0,0 +1,51 @@
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "sha256.h"
+
+// 编译缓存：以 预处理后的源码 + 影响输出的编译选项 的 SHA-256 为键，
+// 在磁盘目录中保存生成的 .s/.o。命中时跳过语法分析、语义分析和代码生成。
+// 缓存目录可以被多个 vc 进程（以及 -j 的多个线程）同时使用
+
+#define CACHE_DEFAULT_MAX_SIZE (256UL * 1024 * 1024)
+
+typedef struct CompileCache CompileCache;
+
+// 累计统计（保存在缓存目录的 stats 文件中）
+typedef struct CacheStats
+{
+    long hits;
+    long misses;
+    long evictions;
+    long entries;
+    size_t total_size;
+} CacheStats;
+
+// 打开（必要时创建）缓存目录，max_size 为缓存总大小上限（字节）
+CompileCache *compile_cache_open(const char *directory, size_t max_size, FILE *diag);
+void compile_cache_close(CompileCache *cache);
+
+// 计算编译器可执行文件的摘要（缓存键的一部分）。第一次计算缓存键时自动调用；
+// 服务器在派生子进程之前调用，每个请求不必重新读取可执行文件
+void compile_cache_init_compiler_digest(void);
+
+// 计算缓存键：flags 描述影响输出的选项（例如 "-c integrated-as"）
+void compile_cache_key(const char *text, size_t length, const char *flags,
+                       char key[SHA256_HEX_SIZE]);
+
+// 命中时把缓存的文件复制到 output_file 并返回 0，未命中返回 -1
+int compile_cache_fetch(CompileCache *cache, const char *key, const char *suffix,
+                        const char *output_file);
+
+// 把刚生成的 output_file 存入缓存，超过大小上限时按最近使用时间淘汰
+void compile_cache_store(CompileCache *cache, const char *key, const char *suffix,
+                         const char *output_file);
+
+// 本进程的命中/未命中次数
+void compile_cache_session_stats(CompileCache *cache, long *hits, long *misses);
+// 缓存目录的累计统计
+int compile_cache_read_stats(CompileCache *cache, CacheStats *stats);
+
+#endif // COMPILE_CACHE_H
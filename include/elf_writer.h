@@ -0,0 +1,13 @@
+#ifndef ELF_WRITER_H
+#define ELF_WRITER_H
+
+#include <stdio.h>
+#include "assembler.h"
+
+// 把汇编结果写成 x86-64 ELF 可重定位目标文件（.o），成功返回 0
+int write_elf_object(ObjectCode *obj, const char *output_file, FILE *diag);
+
+// 在内存中生成 ELF 目标文件，*data 由调用者释放，成功返回 0
+int elf_object_to_memory(ObjectCode *obj, unsigned char **data, size_t *size);
+
+#endif // ELF_WRITER_H
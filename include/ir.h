@@ -0,0 +1,166 @@
+#ifndef IR_H
+#define IR_H
+
+#include <stdio.h>
+
+// 函数级的三地址中间代码：所有值都放在虚拟寄存器中（个数不限），
+// 由寄存器分配器映射到物理寄存器或栈上的溢出槽。
+// 地址取值的局部变量、数组和全局变量通过显式的 LOAD/STORE 访问内存。
+
+// 操作数
+typedef enum
+{
+    IR_OPERAND_NONE,
+    IR_OPERAND_VREG,   // 虚拟寄存器 v<value>
+    IR_OPERAND_IMM,    // 立即数
+    IR_OPERAND_LOCAL,  // 栈上对象的地址：-value(%rbp) + offset
+    IR_OPERAND_GLOBAL, // 全局/静态变量或函数的地址：name(%rip) + offset
+    IR_OPERAND_GOT,    // extern 变量的 GOT 表项：name@GOTPCREL(%rip)，表项中是变量的地址
+    IR_OPERAND_STRING, // 字符串常量的地址：.LC<value>
+    IR_OPERAND_LABEL,  // 跳转目标 .L<value>
+    IR_OPERAND_VECTOR  // 向量寄存器 %xmm<value>（宽度 32 字节时是 %ymm<value>），由 vectorize 直接分配
+} IrOperandKind;
+
+typedef struct IrOperand
+{
+    IrOperandKind kind;
+    long value;
+    long offset;      // LOCAL/GLOBAL 的附加字节偏移
+    const char *name; // GLOBAL 的符号名（指向符号表中的字符串）
+} IrOperand;
+
+// 指令
+typedef enum
+{
+    IR_MOV,   // dst = a（a 为地址类操作数时取地址）
+    IR_ADD,   // dst = a + b
+    IR_SUB,   // dst = a - b
+    IR_MUL,   // dst = a * b
+    IR_DIV,   // dst = a / b（有符号）
+    IR_MOD,   // dst = a % b
+    IR_AND,   // dst = a & b
+    IR_OR,    // dst = a | b
+    IR_XOR,   // dst = a ^ b
+    IR_SHL,   // dst = a << b
+    IR_SAR,   // dst = a >> b（算术右移）
+    IR_NEG,   // dst = -a
+    IR_NOT,   // dst = ~a
+    IR_EXT,   // dst = a 的低 size 字节符号扩展（is_unsigned 时零扩展）成 64 位
+    IR_EQ,    // dst = (a == b)
+    IR_NE,    // dst = (a != b)
+    IR_LT,    // dst = (a < b)
+    IR_LE,    // dst = (a <= b)
+    IR_GT,    // dst = (a > b)
+    IR_GE,    // dst = (a >= b)
+    IR_LOAD,  // dst = *(size *)a
+    IR_STORE, // *(size *)a = b
+    IR_PARAM, // dst = 第 a 个参数（只出现在函数开头）
+    IR_CALL,  // dst = a(args...)，dst 可以为 NONE
+    IR_JMP,   // goto a
+    IR_BR,    // if (a <cond> b) goto dst
+    IR_SWITCH, // goto args[a - b]（跳转表，args 都是标签），a - b 不在 [0, num_args) 内时 goto dst
+    IR_LABEL, // a:
+    IR_RET,   // return a（a 可以为 NONE）
+    // 向量指令（vectorize 生成）：一次处理 width 字节，元素大小是 size 字节（4 或 8）的整数
+    IR_VLOAD,   // dst = a 开始的 width 字节
+    IR_VSTORE,  // a 开始的 width 字节 = b
+    IR_VSPLAT,  // dst 的每个元素 = a（VREG 或 IMM）
+    IR_VADD,    // dst = a + b（逐元素，下同）
+    IR_VSUB,    // dst = a - b
+    IR_VMUL,    // dst = a * b（只有 4 字节元素）
+    IR_VAND,    // dst = a & b
+    IR_VOR,     // dst = a | b
+    IR_VXOR,    // dst = a ^ b
+    IR_VMIN,    // dst = min(a, b)（有符号，只有 4 字节元素）
+    IR_VMAX,    // dst = max(a, b)
+    IR_VWIDEN,  // dst = a 的低半部分（b 为 0）或高半部分（b 为 1）的 4 字节元素扩展成 8 字节
+    IR_VREDUCE  // dst（VREG）= a 的所有元素按 cond（IR_VADD ... IR_VMAX）合并，扩展成 64 位
+} IrOpcode;
+
+typedef struct IrInstr
+{
+    IrOpcode op;
+    IrOpcode cond; // IR_BR 的比较条件（IR_EQ ... IR_GE）
+    int size;      // LOAD/STORE 的访问宽度（字节）；EXT 保留的字节数；PARAM/CALL 是参数/返回值类型的大小
+    int is_unsigned; // IR_LOAD、IR_EXT、IR_PARAM、IR_CALL、IR_VWIDEN、IR_VREDUCE：不足 8 字节的值零扩展（否则符号扩展）
+    int width;       // 向量指令的宽度（16 或 32 字节）
+    IrOperand dst;
+    IrOperand a;
+    IrOperand b;
+    IrOperand *args; // IR_CALL 的参数，IR_SWITCH 的跳转表
+    int num_args;
+    int is_variadic; // IR_CALL：被调函数是可变参数函数（需要设置 %al）
+    int is_tail;     // IR_CALL：尾调用（后面紧跟返回它的结果的 ret），拆掉栈帧之后 jmp 到被调函数
+} IrInstr;
+
+// 基本块：指令数组中连续的一段，只有第一条指令可以是跳转目标，
+// 只有最后一条指令可以是跳转/返回
+typedef struct IrBlock
+{
+    int first;    // 第一条指令的下标
+    int last;     // 最后一条指令的下标（含）
+    int *succs; // 后继块（顺序执行的下一块在前，IR_SWITCH 结尾的块可以有多个）
+    int num_succs;
+    int *preds; // 前驱块
+    int num_preds;
+} IrBlock;
+
+typedef struct IrFunction
+{
+    char *name;
+    int is_static;
+    int is_inline; // 源码中声明为 inline（内联时使用更宽的预算）
+    int return_size; // 返回值类型的大小（不足 8 字节时高位没有定义，由调用者扩展），void 和 8 字节类型为 8
+    IrInstr *instrs;
+    int num_instrs;
+    int capacity;
+    int num_vregs;
+    int frame_size;   // LOCAL 对象占用的栈空间（字节）
+    IrBlock *blocks;  // 控制流图（ir_build_cfg 生成，修改指令后需要重建）
+    int num_blocks;
+    int (*new_label)(void *ctx); // 分配编译单元内唯一的标签（优化遍插入新块时使用）
+    void *label_ctx;
+} IrFunction;
+
+IrFunction *ir_function_create(const char *name, int is_static);
+void ir_function_free(IrFunction *func);
+
+// 操作数构造
+IrOperand ir_none(void);
+IrOperand ir_vreg(int vreg);
+IrOperand ir_imm(long value);
+IrOperand ir_local(int slot, long offset);
+IrOperand ir_global(const char *name, long offset);
+IrOperand ir_got(const char *name);
+IrOperand ir_string(int label);
+IrOperand ir_label(int label);
+
+// 分配新的虚拟寄存器
+int ir_new_vreg(IrFunction *func);
+// 分配新的标签
+int ir_new_label(IrFunction *func);
+// 追加一条指令，返回指向它的指针（下一次追加后失效）
+IrInstr *ir_emit(IrFunction *func, IrOpcode op, IrOperand dst, IrOperand a, IrOperand b);
+// 在栈帧中分配 size 字节的对象，返回 LOCAL 槽号
+int ir_alloc_local(IrFunction *func, int size);
+// 删除 dead[i] 非零的指令（保持其余指令的顺序），控制流图需要重建
+void ir_remove_instrs(IrFunction *func, const char *dead);
+// 在下标 pos 之前插入 count 条指令（复制），控制流图需要重建
+void ir_insert_instrs(IrFunction *func, int pos, const IrInstr *instrs, int count);
+
+// dst = a 的复制：mov，或者 int 变量赋值时的 4 字节符号扩展。有符号整数运算溢出是未定义行为，
+// 归纳变量 i = i + c 的结果在有定义的程序中不需要截断，循环分析把它当作复制
+int ir_is_int_copy(const IrInstr *instr);
+
+// 指令写入的虚拟寄存器，没有则返回 -1
+int ir_instr_def(const IrInstr *instr);
+// 指令读取的操作数（uses 至少要有 2 和 num_args 中较大者个位置），返回个数。
+// 返回的是操作数在指令中的地址，可以直接改写
+int ir_instr_uses(IrInstr *instr, IrOperand **uses);
+
+// 划分基本块并连接控制流边
+void ir_build_cfg(IrFunction *func);
+// 以文本形式输出函数的 IR（--dump-ir）
+void ir_print_function(IrFunction *func, FILE *out);
+
+#endif // IR_H
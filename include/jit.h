@@ -0,0 +1,13 @@
+#ifndef JIT_H
+#define JIT_H
+
+#include <stdio.h>
+#include "assembler.h"
+
+// 内存中执行（--run）：把汇编结果装入可执行内存，完成重定位后直接调用 main
+// 外部函数（printf/malloc/strlen...）从进程内符号表解析
+// 成功时返回 0，并把 main 的返回值写入 exit_code
+int jit_run(ObjectCode **objects, int num_objects, int argc, char **argv,
+            FILE *diag, int *exit_code);
+
+#endif // JIT_H
@@ -0,0 +1,31 @@
+#ifndef JOB_POOL_H
+#define JOB_POOL_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "time_report.h"
+
+// 编译任务（每个输入文件一个）
+typedef struct CompileJob
+{
+    const char *input_file; // 输入文件
+    char *output_file;      // 输出文件
+    int status;             // 编译结果（0 表示成功）
+    int done;               // 是否已完成
+    char *log_text;         // 缓冲的进度输出（stdout）
+    size_t log_size;
+    char *diag_text;        // 缓冲的诊断输出（stderr）
+    size_t diag_size;
+    FileTimeReport *time_report; // 各阶段开销（--time-report，未启用时为 NULL）
+} CompileJob;
+
+// 任务函数：进度写入 log，诊断写入 diag，返回 0 表示成功
+typedef int (*CompileJobFunc)(CompileJob *job, FILE *log, FILE *diag, void *ctx);
+
+// 在 num_workers 个线程上编译所有任务，并按输入顺序回放各任务的输出
+// num_workers <= 1 时在当前线程顺序执行，输出直接写到 stdout/stderr
+// 返回第一个失败任务的下标，全部成功返回 -1
+int job_pool_run(CompileJob *jobs, int num_jobs, int num_workers,
+                 CompileJobFunc func, void *ctx);
+
+#endif // JOB_POOL_H
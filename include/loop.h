@@ -0,0 +1,80 @@
+#ifndef LOOP_H
+#define LOOP_H
+
+#include <stdint.h>
+#include "ir.h"
+
+// 循环结构：在控制流图上计算支配关系，跳到支配自己的块的边是回边，
+// 回边 b → h 确定一个以 h 为头块的自然循环（能不经过 h 到达 b 的块）。
+// 同一个头块的多条回边合并为一个循环。
+
+typedef struct IrLoop
+{
+    int header;      // 头块：循环的唯一入口
+    long label;      // 头块的标签（重建控制流图之后用它重新找到同一个循环），没有标签时为 -1
+    char *contains;  // contains[b] 非零表示块 b 属于循环
+    int num_blocks;  // 循环包含的块数
+    int *latches;    // 回边的起点
+    int num_latches;
+    int depth;       // 嵌套深度，最外层为 1
+} IrLoop;
+
+typedef struct IrLoopInfo
+{
+    IrLoop *loops; // 按包含的块数从小到大排列，内层循环在外层之前
+    int num_loops;
+    int num_blocks;
+    int words;     // 支配集合每行的 64 位字数
+    uint64_t *dom; // dom[b] 是支配块 b 的块的集合
+} IrLoopInfo;
+
+// 找出函数中的循环（需要已经建立控制流图）
+IrLoopInfo *ir_find_loops(IrFunction *func);
+void ir_loops_free(IrLoopInfo *info);
+// 块 a 是否支配块 b
+int ir_dominates(const IrLoopInfo *info, int a, int b);
+// 按头块标签查找循环，找不到返回 NULL
+IrLoop *ir_find_loop(IrLoopInfo *info, long label);
+
+// 保证循环有专用的前置块：紧挨在头块之前、只流向头块、是头块唯一的循环外前驱，
+// 插入前置块的指令在进入循环之前恰好执行一次。
+// 已经有前置块时返回 0，插入了前置块返回 1（控制流图需要重建），循环没有外部入口时返回 -1
+int ir_make_preheader(IrFunction *func, const IrLoop *loop);
+
+// 确保循环有前置块，需要插入时重新分析（*info 换成新的结果），返回新分析中的同一个循环；
+// 没有前置块可用时返回 NULL
+IrLoop *ir_prepare_loop(IrFunction *func, IrLoopInfo **info, IrLoop *loop);
+
+// 从内层到外层对开始时已有的每个循环调用一次 visit（visit 新建的循环不再访问），
+// visit 修改了指令时返回非零。每次调用之前重新建立控制流图和循环信息。返回是否修改过指令
+int ir_visit_loops(IrFunction *func, int (*visit)(IrFunction *func, IrLoopInfo **info, IrLoop *loop, void *ctx),
+                   void *ctx);
+
+// 规范的计数循环：for/while 降低后的形状
+//   .Lh: br <cond> i, n -> .Lexit   头块只有这一条比较，也是循环唯一的出口
+//        循环体                      紧跟在头块之后的连续块，最后一块 jmp .Lh
+// 其中 i 是步长为 ±1 的基本归纳变量，n 是常量或循环中不变的 vreg，退出条件随 i 单调
+typedef struct IrCountedLoop
+{
+    int header;     // 头块
+    int latch;      // 最后一块（jmp 回头块）
+    int body_first; // 循环体的第一条指令
+    int body_last;  // 循环体的最后一条指令（回边的 jmp）
+    int body_size;  // 循环体中标签以外的指令数
+    int iv;         // 归纳变量 i
+    long step;      // ±1
+    int iv_def;     // 循环中 i 唯一的定义（i = i + c 或 i = mov t）
+    int step_def;   // t = i + c 的位置，直接递增时为 -1
+    IrOpcode cond;  // 退出条件，写成 i <cond> bound 的方向
+    IrOperand bound;
+    long exit_label;
+} IrCountedLoop;
+
+// 识别最内层的规范计数循环，是返回 1
+int ir_match_counted_loop(IrFunction *func, IrLoopInfo *info, const IrLoop *loop, IrCountedLoop *cl);
+// 进入循环时 i 的常量初值：从前置块向前找 i 的最后一个定义（只经过唯一前驱的块），找不到返回 0
+int ir_loop_initial_value(IrFunction *func, const IrCountedLoop *cl, long *value);
+// 从 initial 开始、bound 为常量时的迭代次数，超过 limit 时返回 -1
+long ir_loop_trip_count(const IrCountedLoop *cl, long initial, long limit);
+
+#endif // LOOP_H
@@ -0,0 +1,46 @@
+#ifndef OPT_H
+#define OPT_H
+
+#include "ast.h"
+#include "ir.h"
+#include "symbol_table.h"
+
+// 各个优化遍，由 pass_manager 按优化级别调度。
+// 返回非零表示修改了代码。
+
+// constfold：折叠常量表达式，把只初始化一次、从不修改的整型变量替换为常量
+int opt_constfold(ASTNode *root);
+// tail-calls：调用自己的尾调用（包括结果再加上或乘上一个值才返回的）改成跳回函数开头的循环，
+// 其余参数都在寄存器中的尾调用标记为 is_tail
+int opt_tail_calls(IrFunction *func);
+// simplify-cfg：折叠常量条件的分支，删除不可达指令、跳到下一条的跳转、跳到跳转的跳转和无人引用的标签
+int opt_simplify_cfg(IrFunction *func);
+// licm：把循环中不变的计算移到循环的前置块
+int opt_licm(IrFunction *func);
+// vectorize：最内层计数循环中逐元素的数组运算和归约换成一次处理 width 字节（16 或 32）的向量指令，
+// 余下的迭代由原来的循环完成
+int opt_vectorize(IrFunction *func, int width);
+// strength-reduce：把基本归纳变量的乘法和由它导出的地址换成每次迭代递增的 vreg
+int opt_strength_reduce(IrFunction *func);
+// unroll-loops：计数循环的循环体复制 factor 份，余下的迭代由原来的循环完成；
+// 次数为常量的短循环完全展开
+int opt_unroll_loops(IrFunction *func, int factor);
+// dce：删除从入口不可达的块和结果没有用到的纯计算
+int opt_dce(IrFunction *func);
+// inline：把同一编译单元内的小叶子函数和声明为 inline 的函数展开到调用处。
+// funcs 是本单元的函数（没有降低为 IR 的为 NULL），limit 是函数体大小的预算（IR 指令数），
+// new_label 分配编译单元内唯一的标签。需要在建立控制流图之前运行
+int opt_inline(IrFunction **funcs, int num_funcs, int limit, int (*new_label)(void *ctx), void *ctx);
+// dce（编译单元）：从非 static 的函数和变量出发，沿着函数体和初始值中的引用找出用到的 static 函数和变量。
+// funcs[i] 是 root->children[i] 降低好的函数（各函数的 IR 遍之后，没有降低为 IR 的为 NULL，按语法树查找引用），
+// vars 是本单元的全局/静态变量。live_funcs[i]、live_vars[k] 置为是否需要输出，返回删除的个数。
+// 单元中有内联汇编时全部保留
+int opt_dce_unit(ASTNode *root, IrFunction **funcs, Symbol **vars, int num_vars, char *live_funcs, char *live_vars);
+
+// 整数常量表达式求值（不做变量传播），是常量返回 1。
+// 全局/静态变量的初始值在任何优化级别下都用它计算
+int const_eval(ASTNode *node, long *value);
+// sizeof 表达式的值
+int const_sizeof(ASTNode *node);
+
+#endif // OPT_H
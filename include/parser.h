@@ -0,0 +1,13 @@
+#ifndef PARSER_H
+#define PARSER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "ast.h"
+
+// 解析内存中的源代码生成 AST（可重入：扫描器和语法分析器状态均为每次调用独立）
+// source 需以两个 '\0' 结尾（preprocessor_process 的返回值满足该要求）
+// 返回 0 表示成功，语法错误写入 diag
+int parse_buffer(char *source, size_t length, FILE *diag, ASTNode **root);
+
+#endif // PARSER_H
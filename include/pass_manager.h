@@ -0,0 +1,99 @@
+#ifndef PASS_MANAGER_H
+#define PASS_MANAGER_H
+
+#include <stdio.h>
+#include <stddef.h>
+#include "ast.h"
+#include "ir.h"
+#include "symbol_table.h"
+#include "regalloc.h"
+#include "peephole.h"
+
+// 优化遍管理：-O0/-O1/-O2 决定默认启用哪些遍，-f<遍名>/-fno-<遍名> 单独开关。
+// AST 遍在语义分析之后、代码生成之前对整个编译单元运行一次；
+// IR 遍在每个函数降低为 IR 之后、寄存器分配之前运行；
+// 汇编遍在每个函数的汇编输出之前，对缓冲的指令运行。
+
+typedef enum
+{
+    PASS_CONSTFOLD,       // AST：常量折叠和常量传播
+    PASS_INLINE,          // IR：把小函数展开到同一编译单元内的调用处
+    PASS_TAIL_CALLS,      // IR：自递归改成循环，其余尾调用改成跳转
+    PASS_SIMPLIFY_CFG,    // IR：删除不可达指令、多余的跳转和标签
+    PASS_LICM,            // IR：循环不变代码外提
+    PASS_VECTORIZE,       // IR：最内层数组循环的向量化（SSE2，-mavx2 时 AVX2）
+    PASS_STRENGTH_REDUCE, // IR：归纳变量的强度削弱
+    PASS_UNROLL_LOOPS,    // IR：展开计数循环（只能用 -funroll-loops 打开）
+    PASS_DCE,             // IR：删除不可达的块、无用的计算和没有被引用的 static 函数/变量
+    PASS_REGALLOC,        // IR：线性扫描寄存器分配（关闭时所有值都放在栈上）
+    PASS_PEEPHOLE,        // 汇编：窥孔优化
+    NUM_PASSES
+} PassId;
+
+#define OPT_LEVEL_DEFAULT 1
+#define OPT_LEVEL_MAX 2
+#define INLINE_LIMIT_DEFAULT 40 // -finline-limit= 的默认值（IR 指令数）
+#define INLINE_LIMIT_MAX 100000
+#define UNROLL_FACTOR_DEFAULT 4 // -funroll-factor= 的默认值
+#define UNROLL_FACTOR_MIN 2
+#define UNROLL_FACTOR_MAX 16
+
+typedef struct PassOptions
+{
+    int opt_level;                 // -O0 / -O1 / -O2
+    signed char forced[NUM_PASSES]; // -f<遍名> 为 1，-fno-<遍名> 为 0，未指定为 -1
+    int verbose;                   // -v：打印每一遍的耗时
+    int inline_limit;              // -finline-limit=<n>：可以内联的函数体大小
+    int unroll_factor;             // -funroll-factor=<n>：循环体展开的份数
+    int avx2;                      // -mavx2：向量化使用 32 字节的 AVX2 指令
+} PassOptions;
+
+// 每一遍累计的开销
+typedef struct PassStats
+{
+    int runs;       // 运行次数（IR 遍按函数计）
+    int changed;    // 修改了代码的次数
+    double wall_ms; // 累计耗时
+} PassStats;
+
+typedef struct PassManager
+{
+    PassOptions options;
+    PassStats stats[NUM_PASSES];
+} PassManager;
+
+void pass_options_init(PassOptions *options);
+// 解析一个命令行选项（-O<n>、-f<遍名>、-fno-<遍名>、-finline-limit=<n>、-funroll-factor=<n>、-mavx2、-v）：
+// 识别返回 1，不是优化选项返回 0，遍名未知返回 -1，数值不合法或超出范围返回 -2
+int pass_options_parse(PassOptions *options, const char *arg);
+// 为返回 -2 的选项打印错误：哪个值不合法、允许的范围
+void pass_options_print_value_error(FILE *out, const char *arg);
+// 影响输出的选项的规范写法（编译缓存键和依赖数据库使用），例如 "-O1 -fno-regalloc"
+const char *pass_options_string(const PassOptions *options, char *buffer, size_t size);
+// 打印可用的遍（--help）
+void pass_options_print_help(FILE *out);
+
+PassManager *pass_manager_create(const PassOptions *options);
+void pass_manager_destroy(PassManager *pm);
+int pass_enabled(const PassManager *pm, PassId id);
+
+// 运行 AST 遍（每个编译单元一次）
+void pass_manager_run_ast(PassManager *pm, ASTNode *root);
+// 运行 IR 遍（每个函数一次）
+void pass_manager_run_ir(PassManager *pm, IrFunction *func);
+// 内联（每个编译单元一次，在各函数的 IR 遍之前）：funcs 为本单元降低好的函数，
+// 不能降低为 IR 的函数为 NULL
+void pass_manager_inline(PassManager *pm, IrFunction **funcs, int num_funcs, int (*new_label)(void *ctx),
+                         void *ctx);
+// 删除本单元中没有被引用的 static 函数和变量（每个编译单元一次，在各函数的 IR 遍之后）：
+// live_funcs[i]、live_vars[k] 置为是否需要输出，dce 遍关闭时全部保留
+void pass_manager_dce_unit(PassManager *pm, ASTNode *root, IrFunction **funcs, Symbol **vars, int num_vars,
+                           char *live_funcs, char *live_vars);
+// 寄存器分配（regalloc 遍关闭时全部溢出到栈上）
+RegAllocation *pass_manager_allocate(PassManager *pm, IrFunction *func);
+// 运行汇编遍（每个函数一次）
+void pass_manager_run_asm(PassManager *pm, PeepholeBuffer *buf);
+// 打印各遍的统计（-v）
+void pass_manager_report(const PassManager *pm, FILE *out);
+
+#endif // PASS_MANAGER_H
@@ -0,0 +1,30 @@
+#ifndef PEEPHOLE_H
+#define PEEPHOLE_H
+
+#include <stdio.h>
+
+// 窥孔优化：emit() 不直接写文件，而是把一行行汇编追加到缓冲区，
+// 每个函数生成完毕后在整个函数的指令窗口上按规则表改写，再一次性输出。
+// 规则用模式描述，例如 "pushq {a}" + "popq {b}" → "movq {a}, {b}"，
+// 同名占位符必须绑定到同一段文本，条件（寄存器是否已死等）由规则的 guard 检查。
+
+typedef struct PeepholeBuffer
+{
+    char **lines; // 不含换行符
+    int num_lines;
+    int capacity;
+} PeepholeBuffer;
+
+PeepholeBuffer *peephole_create(void);
+void peephole_destroy(PeepholeBuffer *buf);
+void peephole_append(PeepholeBuffer *buf, const char *line);
+// 输出缓冲区中的所有行并清空
+void peephole_flush(PeepholeBuffer *buf, FILE *out);
+
+// 对缓冲区中的代码应用所有规则直到不再变化，返回改写次数
+int peephole_optimize(PeepholeBuffer *buf);
+
+// 逐条运行规则表中的 before/after 例子，打印结果，返回失败的个数（--peephole-self-test）
+int peephole_self_test(FILE *out);
+
+#endif // PEEPHOLE_H
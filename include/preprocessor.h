@@ -28,6 +28,11 @@ typedef struct Preprocessor
     int num_macros;               // 宏定义数量
     int macro_capacity;           // 宏定义容量
     const char *current_filename; // 当前文件名
+    int include_depth;            // 当前include嵌套深度
+    FILE *diag;                   // 诊断输出流（默认 stderr）
+    char **included_files;        // 读入的头文件路径（按首次出现顺序，不重复）
+    int num_included_files;
+    int included_capacity;
 } Preprocessor;
 
 // 函数声明
@@ -38,7 +43,21 @@ void preprocessor_define_macro(Preprocessor *pp, const char *name, const char *v
 void preprocessor_undef_macro(Preprocessor *pp, const char *name);
 int preprocessor_is_defined(Preprocessor *pp, const char *name);
 const char *preprocessor_get_macro_value(Preprocessor *pp, const char *name);
+// 返回处理后的代码（调用者负责释放），以两个 '\0' 结尾，可直接交给 parse_buffer
 char *preprocessor_process(Preprocessor *pp, const char *input, const char *filename);
 char *read_file_content(const char *filename);
+// 取走 included_files（调用者负责释放每一项和数组本身），用于依赖跟踪
+char **preprocessor_take_included_files(Preprocessor *pp, int *count);
+
+// 头文件缓存（编译服务器使用）：启用后 #include 读到的文件内容在进程内保留，
+// 文件被替换（inode 变化）或者修改时间（纳秒）、状态改变时间、大小变化时自动失效
+void preprocessor_enable_header_cache(int enabled);
+// 预先读入一个文件 / 目录下所有 .h 文件，返回读入的文件数
+int preprocessor_preload_header(const char *path);
+int preprocessor_preload_headers(const char *directory);
+// 对上次调用之后读入或更新的头文件的绝对路径调用 report（report 为 NULL 时只清除记录）。
+// 服务器的子进程用它把新读入的头文件报告给服务器进程预热
+void preprocessor_header_cache_take_new(void (*report)(const char *path, void *ctx), void *ctx);
+void preprocessor_header_cache_stats(int *entries, int *hits, int *misses);
 
 #endif // PREPROCESSOR_H
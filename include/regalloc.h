@@ -0,0 +1,48 @@
+#ifndef REGALLOC_H
+#define REGALLOC_H
+
+#include "ir.h"
+
+// 线性扫描寄存器分配（Poletto & Sarkar）：
+// 先做活跃变量分析得到每个虚拟寄存器的活跃区间，再按起点顺序扫描，
+// 寄存器不够时溢出结束得最晚的区间。跨越函数调用的区间只分配被调用者保存的寄存器。
+
+// 可分配的物理寄存器（%rax、%rcx、%rdx、%r11 留作代码生成的临时寄存器）
+typedef enum
+{
+    PREG_RBX, // 被调用者保存
+    PREG_R12,
+    PREG_R13,
+    PREG_R14,
+    PREG_R15,
+    PREG_RSI, // 调用者保存
+    PREG_RDI,
+    PREG_R8,
+    PREG_R9,
+    PREG_R10,
+    NUM_PREGS
+} PhysReg;
+
+#define NUM_CALLEE_SAVED_PREGS 5
+
+typedef struct RegAllocation
+{
+    int *reg;             // vreg → 物理寄存器，-1 表示溢出到栈上
+    int *spill_slot;      // vreg → 溢出槽编号（reg 为 -1 时有效）
+    int num_vregs;
+    int num_spill_slots;
+    int used_callee_saved; // 用到的被调用者保存寄存器（按 PhysReg 位掩码）
+} RegAllocation;
+
+RegAllocation *regalloc_run(IrFunction *func);
+// 不分配寄存器，每个 vreg 一个栈槽（-O0 / -fno-regalloc）
+RegAllocation *regalloc_spill_all(IrFunction *func);
+void regalloc_free(RegAllocation *alloc);
+
+// 物理寄存器名（64、32、16 和 8 位）
+const char *preg_name(int reg);
+const char *preg_name32(int reg);
+const char *preg_name16(int reg);
+const char *preg_name8(int reg);
+
+#endif // REGALLOC_H
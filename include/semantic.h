@@ -1,6 +1,7 @@
 #ifndef SEMANTIC_H
 #define SEMANTIC_H
 
+#include <stdio.h>
 #include "ast.h"
 #include "symbol_table.h"
 
@@ -11,6 +12,9 @@ typedef struct SemanticAnalyzer
     int error_count;
     int warning_count;
     int loop_depth; // 当前循环嵌套深度（用于检查 break/continue）
+    int in_function;    // 是否正在分析函数体（区分全局变量和局部变量）
+    int static_counter; // 局部静态变量标签编号
+    FILE *diag;     // 诊断输出流（默认 stderr）
 } SemanticAnalyzer;
 
 // 主要函数
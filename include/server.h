@@ -0,0 +1,29 @@
+#ifndef SERVER_H
+#define SERVER_H
+
+// 编译服务器：vc --server <socket> 常驻内存，通过 Unix 域套接字接收编译请求，
+// 每个请求在 fork 出的子进程中处理，继承服务器预先加载的状态（头文件缓存等）。
+// 客户端（vc --connect <socket> ...）把命令行、工作目录、环境变量和 stdin/stdout/stderr
+// 文件描述符发给服务器，编译输出直接写到客户端的终端
+
+// 处理一次请求，签名与命令行入口相同，输出写到 stdout/stderr，返回退出码
+typedef int (*ServerRequestFunc)(int argc, char **argv);
+
+// 服务器进程的缓存预热：子进程的状态在退出时丢失，所以子进程处理完请求之后用 collect
+// 列出这次新读入的文件（report 为 NULL 时只清除继承来的记录），服务器进程对收到的
+// 每个路径调用 warm，之后 fork 的子进程就能直接使用
+typedef void (*ServerReportFunc)(const char *path, void *ctx);
+typedef struct ServerCacheHooks
+{
+    void (*collect)(ServerReportFunc report, void *ctx);
+    int (*warm)(const char *path);
+} ServerCacheHooks;
+
+// 运行服务器直到收到 SIGINT/SIGTERM，返回 0 表示正常退出。hooks 可以为 NULL
+int server_run(const char *socket_path, ServerRequestFunc handler, const ServerCacheHooks *hooks);
+
+// 把命令行转发给服务器；成功时返回 0 并把退出码写入 exit_status，
+// 无法连接服务器时返回 -1（调用者可以改为本地编译）
+int client_forward(const char *socket_path, int argc, char **argv, int *exit_status);
+
+#endif // SERVER_H
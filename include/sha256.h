@@ -0,0 +1,26 @@
+#ifndef SHA256_H
+#define SHA256_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#define SHA256_DIGEST_SIZE 32
+#define SHA256_HEX_SIZE (SHA256_DIGEST_SIZE * 2 + 1) // 含结尾 '\0'
+
+// SHA-256 增量计算（用于编译缓存的内容寻址）
+typedef struct Sha256
+{
+    uint32_t state[8];
+    uint64_t length;          // 已输入的字节数
+    unsigned char block[64];  // 未满一块的数据
+    size_t block_size;
+} Sha256;
+
+void sha256_init(Sha256 *ctx);
+void sha256_update(Sha256 *ctx, const void *data, size_t size);
+void sha256_final(Sha256 *ctx, unsigned char digest[SHA256_DIGEST_SIZE]);
+
+// 计算摘要并转换为小写十六进制字符串
+void sha256_final_hex(Sha256 *ctx, char hex[SHA256_HEX_SIZE]);
+
+#endif // SHA256_H
@@ -0,0 +1,42 @@
+#ifndef SWITCH_LOWER_H
+#define SWITCH_LOWER_H
+
+#include "codegen.h"
+
+// switch 的分派：case 值排序后从小到大划分成簇，足够稠密的一段连续值用一张跳转表
+// （一次边界检查 + 间接跳转），其余的 case 各自成簇；簇之间按起始值二分查找，
+// 因此稠密的 switch 只需常数时间，稀疏的 switch 也只需 O(log n) 次比较。
+
+#define SWITCH_TABLE_MIN_CASES 4  // 至少这么多个 case 才建跳转表
+#define SWITCH_TABLE_MAX_RATIO 3  // 表项数（high - low + 1）不超过 case 数的这个倍数，空位跳到 default
+#define SWITCH_LINEAR_MAX 3       // 剩下不超过这么多个单值簇时直接顺序比较
+
+typedef struct SwitchCase
+{
+    long value; // case 的常量值
+    int label;  // case 语句的标签
+} SwitchCase;
+
+// 分派代码的输出方式，由栈式代码生成和 IR 降低各自提供
+typedef struct SwitchTarget
+{
+    void *ctx;
+    int (*new_label)(void *ctx);
+    void (*emit_label)(void *ctx, int label);
+    void (*emit_jump)(void *ctx, int label);
+    // if (switch 值 <cond> value) goto label，cond 为 IR_EQ 或 IR_LT
+    void (*emit_branch)(void *ctx, IrOpcode cond, long value, int label);
+    // switch 值在 [low, low + num_entries) 内时跳到 labels[值 - low]，否则跳到 default_label
+    void (*emit_table)(void *ctx, long low, const int *labels, int num_entries, int default_label);
+} SwitchTarget;
+
+// 生成整个分派序列，之后不会落空（没有匹配时跳到 default_label）。
+// cases 会被排序，重复的值只保留第一个
+void switch_emit_dispatch(const SwitchTarget *target, SwitchCase *cases, int num_cases, int default_label);
+
+// 输出跳转表分派的汇编：reg 中为 switch 值（会被修改），另外使用 %r11。
+// 表放在 .rodata，表项是目标相对表头的 32 位偏移，与位置无关
+void emit_jump_table(CodeGenerator *gen, const char *reg, long low, const int *labels, int num_entries,
+                     int default_label);
+
+#endif // SWITCH_LOWER_H
@@ -1,6 +1,7 @@
 #ifndef SYMBOL_TABLE_H
 #define SYMBOL_TABLE_H
 
+#include <stdio.h>
 #include "types.h"
 #include "ast.h"
 
@@ -10,7 +11,8 @@ typedef enum
     SYMBOL_VARIABLE,
     SYMBOL_FUNCTION,
     SYMBOL_PARAMETER,
-    SYMBOL_TYPEDEF // typedef类型别名
+    SYMBOL_TYPEDEF, // typedef类型别名
+    SYMBOL_STRUCT   // 结构体标签，名字为 "struct 标签"，类型是完成布局的定义
 } SymbolKind;
 
 // 符号表项
@@ -20,13 +22,15 @@ typedef struct Symbol
     TypeInfo *type;
     SymbolKind kind;
     int scope_level;
-    int offset;           // 相对于栈帧的偏移（局部变量）
+    int offset;           // 局部变量：对象的地址为 -offset(%rbp)
     ASTNode *declaration; // 指向声明节点
     int is_defined;       // 函数是否已定义
     int is_static;        // 是否是静态变量
     int is_global;        // 是否是全局变量
     int is_extern;        // 是否是外部符号
+    int is_inline;        // 函数：是否声明为 inline
     char *label;          // 全局/静态变量的标签名
+    int frame_size;       // 函数：参数和局部变量占用的栈空间（字节）
 } Symbol;
 
 // 作用域
@@ -38,6 +42,7 @@ typedef struct Scope
     struct Scope *parent; // 父作用域
     int level;            // 作用域层级
     int next_offset;      // 下一个可用的偏移量
+    struct Scope *next_retired; // 已退出作用域链表（代码生成阶段仍要引用其中的符号）
 } Scope;
 
 // 符号表
@@ -45,8 +50,10 @@ typedef struct SymbolTable
 {
     Scope *current_scope;
     Scope *global_scope;
+    Scope *retired_scopes; // 已退出的作用域，在销毁符号表时统一释放
     int current_level;
     int has_errors; // 是否有错误
+    FILE *diag;     // 诊断输出流（默认 stderr）
 } SymbolTable;
 
 // 函数声明
@@ -0,0 +1,64 @@
+#ifndef TIME_REPORT_H
+#define TIME_REPORT_H
+
+#include <stdio.h>
+#include <stddef.h>
+
+// --time-report：统计每个文件各编译阶段的耗时和内存
+
+// 编译阶段
+typedef enum
+{
+    PHASE_PREPROCESS,
+    PHASE_PARSE,
+    PHASE_SEMANTIC,
+    PHASE_CODEGEN,
+    PHASE_ASSEMBLE,
+    PHASE_LINK,
+    PHASE_COUNT
+} CompilePhase;
+
+// 一个阶段的开销（同一阶段多次计时会累加）
+typedef struct PhaseStats
+{
+    int measured;         // 是否执行过该阶段
+    double wall_ms;       // 墙钟时间
+    double cpu_ms;        // 当前线程 CPU 时间 + 子进程（gcc）CPU 时间
+    long peak_rss_kb;     // 进程峰值 RSS 的增长（-j 时为整个进程的值）
+    long allocations;     // 当前线程的 malloc/calloc/realloc 次数
+    size_t alloc_bytes;   // 申请的字节数
+} PhaseStats;
+
+// 一个输入文件（或链接步骤）的统计
+typedef struct FileTimeReport
+{
+    const char *name;
+    PhaseStats phases[PHASE_COUNT];
+} FileTimeReport;
+
+// 计时开始时的快照
+typedef struct PhaseTimer
+{
+    double wall_ms;
+    double cpu_ms;
+    long peak_rss_kb;
+    long allocations;
+    size_t alloc_bytes;
+} PhaseTimer;
+
+// 开始统计内存分配（之前的分配不计入）
+void time_report_enable_alloc_tracking(void);
+
+// report 为 NULL（未启用 --time-report）时两个函数都什么都不做
+void phase_timer_start(PhaseTimer *timer, FileTimeReport *report);
+// 把从 start 到现在的开销累加到 report 的 phase 阶段
+void phase_timer_stop(PhaseTimer *timer, FileTimeReport *report, CompilePhase phase);
+
+const char *compile_phase_name(CompilePhase phase);
+
+// 文本表格
+void time_report_print(FILE *out, FileTimeReport *reports, int num_reports);
+// JSON 格式，便于脚本采集
+void time_report_print_json(FILE *out, FileTimeReport *reports, int num_reports);
+
+#endif // TIME_REPORT_H
@@ -1,6 +1,8 @@
 #ifndef TYPES_H
 #define TYPES_H
 
+#include <stddef.h>
+
 // 基本数据类型
 typedef enum
 {
@@ -35,10 +37,12 @@ typedef struct TypeInfo
     struct TypeInfo *return_type;  // 函数返回类型
     struct TypeInfo **param_types; // 函数参数类型
     int num_params;                // 参数数量
+    int is_variadic;               // 可变参数函数 (...)
     char *struct_name;             // 结构体名称
     struct StructMember *members;  // 结构体成员
     int num_members;               // 成员数量
     int struct_size;               // 结构体大小（字节）
+    int struct_align;              // 结构体的对齐要求（成员中最大的对齐）
 } TypeInfo;
 
 // 结构体成员
@@ -56,7 +60,25 @@ TypeInfo *create_array_type(TypeInfo *base, int size);
 TypeInfo *create_function_type(TypeInfo *return_type);
 void add_param_type(TypeInfo *func_type, TypeInfo *param_type);
 int types_compatible(TypeInfo *t1, TypeInfo *t2);
-const char *type_to_string(TypeInfo *type);
+// 类型名写入调用者提供的缓冲区（可重入），返回 buffer
+const char *type_to_string(TypeInfo *type, char *buffer, size_t size);
 void free_type(TypeInfo *type);
+// 深拷贝（结构体类型的每个使用者各持有一份成员表，free_type 时互不影响）
+TypeInfo *type_clone(TypeInfo *type);
+
+// 大小和对齐（x86-64 System V）：char 1，short 2，int/unsigned/float 4，long/double/指针 8，
+// 结构体按成员布局（含填充），数组为元素大小乘以各维长度
+int type_is_array(TypeInfo *type);
+int type_size(TypeInfo *type);
+int type_alignment(TypeInfo *type);
+// 无符号整数类型（读入寄存器时零扩展）
+int type_is_unsigned(TypeInfo *type);
+// 数组的元素类型（多维数组去掉第一维）或指针指向的类型，都不是时返回 NULL
+TypeInfo *type_element(TypeInfo *type);
+
+// 在调用处的栈上分配缓冲区，同一条语句中可以使用多次，例如
+// semantic_warning(..., "%s = %s", TYPE_NAME(lhs), TYPE_NAME(rhs));
+#define TYPE_NAME_SIZE 256
+#define TYPE_NAME(type) type_to_string((type), (char[TYPE_NAME_SIZE]){0}, TYPE_NAME_SIZE)
 
 #endif // TYPES_H
@@ -0,0 +1,41 @@
+#ifndef VC_H
+#define VC_H
+
+#include <stddef.h>
+
+// libvc：可嵌入的编译器库
+//
+// 每个 vc_context 保存一组编译设置（宏定义、include 路径）和最近一次编译的诊断信息。
+// 编译过程的所有状态（预处理器、可重入的词法/语法分析器、语义分析器、代码生成器）
+// 都在每次调用时独立创建，不使用全局变量，因此不同线程可以同时使用各自的 vc_context。
+// 同一个 vc_context 不能被多个线程同时使用。
+//
+//     vc_context *ctx = vc_context_create();
+//     char *asm_text; size_t asm_size;
+//     if (vc_compile_to_assembly(ctx, source, strlen(source), "a.c", &asm_text, &asm_size) != 0)
+//         fputs(vc_context_diagnostics(ctx), stderr);
+//     free(asm_text);
+//     vc_context_destroy(ctx);
+
+typedef struct vc_context vc_context;
+
+vc_context *vc_context_create(void);
+void vc_context_destroy(vc_context *ctx);
+
+// 编译设置，对之后的所有编译生效
+void vc_context_define(vc_context *ctx, const char *name, const char *value);
+void vc_context_add_include_path(vc_context *ctx, const char *path);
+
+// 编译内存中的源代码（filename 用于 __FILE__ 和诊断），成功返回 0。
+// 输出缓冲区由调用者用 free() 释放；失败时输出为 NULL，原因见 vc_context_diagnostics()
+int vc_compile_to_assembly(vc_context *ctx, const char *source, size_t length,
+                           const char *filename, char **asm_text, size_t *asm_size);
+
+// 生成 x86-64 ELF 可重定位目标文件的内容（使用内置汇编器）
+int vc_compile_to_object(vc_context *ctx, const char *source, size_t length,
+                         const char *filename, unsigned char **object, size_t *object_size);
+
+// 最近一次编译的错误和警告（以 '\0' 结尾，没有诊断时为空字符串）
+const char *vc_context_diagnostics(vc_context *ctx);
+
+#endif // VC_H
@@ -35,10 +35,11 @@ ASTNode *create_int_node(int value, int lineno)
 }
 
 // 创建浮点数字面量节点
-ASTNode *create_float_node(float value, int lineno)
+ASTNode *create_float_node(double value, int is_float, int lineno)
 {
     ASTNode *node = create_ast_node(AST_FLOAT_LITERAL, lineno);
-    node->value.float_val = value;
+    node->value.float_val.value = value;
+    node->value.float_val.is_float = is_float;
     return node;
 }
 
@@ -232,7 +233,7 @@ void print_ast(ASTNode *node, int indent)
         printf(": %d", node->value.int_val);
         break;
     case AST_FLOAT_LITERAL:
-        printf(": %f", node->value.float_val);
+        printf(": %g%s", node->value.float_val.value, node->value.float_val.is_float ? "f" : "");
         break;
     case AST_IDENTIFIER:
     case AST_STRING_LITERAL:
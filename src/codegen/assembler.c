@@ -0,0 +1,1988 @@
+#include "assembler.h"
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+
+// ==================== 操作数 ====================
+
+typedef enum
+{
+    OPERAND_REG,   // %rax, %xmm0 ...
+    OPERAND_IMM,   // $123
+    OPERAND_MEM,   // disp(base,index,scale) / sym(%rip)
+    OPERAND_LABEL  // 跳转/调用目标
+} OperandKind;
+
+typedef struct Operand
+{
+    OperandKind kind;
+    int reg;          // 寄存器编号 0-15
+    int size;         // 寄存器宽度（字节），xmm 为 16，ymm 为 32
+    int is_xmm;       // 是否为 xmm/ymm 寄存器
+    int needs_rex;    // %spl/%bpl/%sil/%dil 需要 REX 前缀
+    int indirect;     // call *%rax / jmp *mem
+    long value;       // 立即数 / 位移
+    int base;         // 基址寄存器（-1 表示无）
+    int index;        // 变址寄存器（-1 表示无）
+    int scale;        // 比例因子
+    int rip;          // RIP 相对寻址
+    int gotpcrel;     // sym@GOTPCREL(%rip)：引用符号的 GOT 表项
+    char symbol[128]; // 引用的符号（可为空）
+} Operand;
+
+#define MAX_OPERANDS 3
+
+// 待处理的符号引用：汇编结束后能在段内解析的直接回填，否则生成重定位项
+typedef struct Fixup
+{
+    int section;
+    size_t offset;
+    int symbol;
+    RelocType type;
+    long addend;
+} Fixup;
+
+// 汇编器状态（每次 assemble 调用独立，可在多个线程中并发使用）
+typedef struct Assembler
+{
+    ObjectCode *obj;
+    int section;        // 当前段
+    int line;           // 当前行号（用于报错）
+    FILE *diag;
+    int failed;
+    Fixup *fixups;      // 待处理的引用
+    int num_fixups;
+    int fixup_capacity;
+    int *symbol_hash;   // 符号名哈希表（开放寻址，存放符号下标，-1 为空）
+    int hash_size;
+} Assembler;
+
+// ==================== 寄存器表 ====================
+
+typedef struct RegisterInfo
+{
+    const char *name;
+    int number;
+    int size;
+} RegisterInfo;
+
+static const RegisterInfo registers[] = {
+    {"rax", 0, 8}, {"rcx", 1, 8}, {"rdx", 2, 8}, {"rbx", 3, 8},
+    {"rsp", 4, 8}, {"rbp", 5, 8}, {"rsi", 6, 8}, {"rdi", 7, 8},
+    {"r8", 8, 8}, {"r9", 9, 8}, {"r10", 10, 8}, {"r11", 11, 8},
+    {"r12", 12, 8}, {"r13", 13, 8}, {"r14", 14, 8}, {"r15", 15, 8},
+    {"eax", 0, 4}, {"ecx", 1, 4}, {"edx", 2, 4}, {"ebx", 3, 4},
+    {"esp", 4, 4}, {"ebp", 5, 4}, {"esi", 6, 4}, {"edi", 7, 4},
+    {"r8d", 8, 4}, {"r9d", 9, 4}, {"r10d", 10, 4}, {"r11d", 11, 4},
+    {"r12d", 12, 4}, {"r13d", 13, 4}, {"r14d", 14, 4}, {"r15d", 15, 4},
+    {"ax", 0, 2}, {"cx", 1, 2}, {"dx", 2, 2}, {"bx", 3, 2},
+    {"sp", 4, 2}, {"bp", 5, 2}, {"si", 6, 2}, {"di", 7, 2},
+    {"r8w", 8, 2}, {"r9w", 9, 2}, {"r10w", 10, 2}, {"r11w", 11, 2},
+    {"r12w", 12, 2}, {"r13w", 13, 2}, {"r14w", 14, 2}, {"r15w", 15, 2},
+    {"al", 0, 1}, {"cl", 1, 1}, {"dl", 2, 1}, {"bl", 3, 1},
+    {"spl", 4, 1}, {"bpl", 5, 1}, {"sil", 6, 1}, {"dil", 7, 1},
+    {"r8b", 8, 1}, {"r9b", 9, 1}, {"r10b", 10, 1}, {"r11b", 11, 1},
+    {"r12b", 12, 1}, {"r13b", 13, 1}, {"r14b", 14, 1}, {"r15b", 15, 1},
+    {NULL, 0, 0}};
+
+// 条件码（jcc/setcc/cmovcc 共用）
+typedef struct ConditionInfo
+{
+    const char *name;
+    int code;
+} ConditionInfo;
+
+static const ConditionInfo conditions[] = {
+    {"o", 0}, {"no", 1}, {"b", 2}, {"c", 2}, {"nae", 2}, {"ae", 3}, {"nb", 3}, {"nc", 3},
+    {"e", 4}, {"z", 4}, {"ne", 5}, {"nz", 5}, {"be", 6}, {"na", 6}, {"a", 7}, {"nbe", 7},
+    {"s", 8}, {"ns", 9}, {"p", 10}, {"pe", 10}, {"np", 11}, {"po", 11},
+    {"l", 12}, {"nge", 12}, {"ge", 13}, {"nl", 13}, {"le", 14}, {"ng", 14},
+    {"g", 15}, {"nle", 15}, {NULL, 0}};
+
+// SSE 指令：prefix 为 0 表示无前缀
+typedef struct SseInfo
+{
+    const char *name;
+    unsigned char prefix;
+    unsigned char opcode;
+} SseInfo;
+
+static const SseInfo sse_arith[] = {
+    {"addss", 0xF3, 0x58}, {"addsd", 0xF2, 0x58}, {"subss", 0xF3, 0x5C}, {"subsd", 0xF2, 0x5C},
+    {"mulss", 0xF3, 0x59}, {"mulsd", 0xF2, 0x59}, {"divss", 0xF3, 0x5E}, {"divsd", 0xF2, 0x5E},
+    {"sqrtss", 0xF3, 0x51}, {"sqrtsd", 0xF2, 0x51}, {"minss", 0xF3, 0x5D}, {"minsd", 0xF2, 0x5D},
+    {"maxss", 0xF3, 0x5F}, {"maxsd", 0xF2, 0x5F}, {"ucomiss", 0, 0x2E}, {"ucomisd", 0x66, 0x2E},
+    {"comiss", 0, 0x2F}, {"comisd", 0x66, 0x2F}, {"cvtss2sd", 0xF3, 0x5A}, {"cvtsd2ss", 0xF2, 0x5A},
+    {"xorps", 0, 0x57}, {"xorpd", 0x66, 0x57}, {"andps", 0, 0x54}, {"andpd", 0x66, 0x54},
+    {"addps", 0, 0x58}, {"addpd", 0x66, 0x58}, {"subps", 0, 0x5C}, {"subpd", 0x66, 0x5C},
+    {"mulps", 0, 0x59}, {"mulpd", 0x66, 0x59}, {"divps", 0, 0x5E}, {"divpd", 0x66, 0x5E},
+    {"pxor", 0x66, 0xEF}, {"paddd", 0x66, 0xFE}, {"paddq", 0x66, 0xD4},
+    {"psubd", 0x66, 0xFA}, {"psubq", 0x66, 0xFB}, {"pand", 0x66, 0xDB}, {"por", 0x66, 0xEB},
+    {"pandn", 0x66, 0xDF}, {"pmuludq", 0x66, 0xF4}, {"pcmpgtd", 0x66, 0x66},
+    {"punpckldq", 0x66, 0x62}, {"punpckhdq", 0x66, 0x6A}, {"punpcklqdq", 0x66, 0x6C},
+    {NULL, 0, 0}};
+
+// SSE 数据移动：load 为 xmm ← r/m，store 为 r/m ← xmm
+typedef struct SseMoveInfo
+{
+    const char *name;
+    unsigned char prefix;
+    unsigned char load;
+    unsigned char store;
+} SseMoveInfo;
+
+static const SseMoveInfo sse_moves[] = {
+    {"movss", 0xF3, 0x10, 0x11}, {"movsd", 0xF2, 0x10, 0x11},
+    {"movaps", 0, 0x28, 0x29}, {"movapd", 0x66, 0x28, 0x29},
+    {"movups", 0, 0x10, 0x11}, {"movupd", 0x66, 0x10, 0x11},
+    {"movdqa", 0x66, 0x6F, 0x7F}, {"movdqu", 0xF3, 0x6F, 0x7F},
+    {NULL, 0, 0, 0}};
+
+// AVX/AVX2 指令（VEX 编码）。pp：0 无前缀、1 为 66、2 为 F3、3 为 F2；map：1 为 0F、2 为 0F38、3 为 0F3A
+typedef enum
+{
+    VEX_RVM,  // op src2, src1, dst：reg = dst，vvvv = src1，r/m = src2
+    VEX_RM,   // op src, dst：reg = dst，r/m = src
+    VEX_RMI,  // op $imm, src, dst
+    VEX_MRI,  // op $imm, src, dst：reg = src，r/m = dst（vextracti128）
+    VEX_MOVE  // load 为 op r/m, reg（opcode），store 为 op reg, mem（opcode + 0x10）
+} VexForm;
+
+typedef struct VexInfo
+{
+    const char *name;
+    unsigned char pp;
+    unsigned char map;
+    unsigned char opcode;
+    VexForm form;
+} VexInfo;
+
+static const VexInfo vex_ops[] = {
+    {"vpaddd", 1, 1, 0xFE, VEX_RVM},        {"vpaddq", 1, 1, 0xD4, VEX_RVM},
+    {"vpsubd", 1, 1, 0xFA, VEX_RVM},        {"vpsubq", 1, 1, 0xFB, VEX_RVM},
+    {"vpand", 1, 1, 0xDB, VEX_RVM},         {"vpandn", 1, 1, 0xDF, VEX_RVM},
+    {"vpor", 1, 1, 0xEB, VEX_RVM},          {"vpxor", 1, 1, 0xEF, VEX_RVM},
+    {"vpcmpgtd", 1, 1, 0x66, VEX_RVM},      {"vpmulld", 1, 2, 0x40, VEX_RVM},
+    {"vpminsd", 1, 2, 0x39, VEX_RVM},       {"vpmaxsd", 1, 2, 0x3D, VEX_RVM},
+    {"vpshufd", 1, 1, 0x70, VEX_RMI},       {"vpmovsxdq", 1, 2, 0x25, VEX_RM},
+    {"vpmovzxdq", 1, 2, 0x35, VEX_RM},      {"vpbroadcastd", 1, 2, 0x58, VEX_RM},
+    {"vpbroadcastq", 1, 2, 0x59, VEX_RM},   {"vextracti128", 1, 3, 0x39, VEX_MRI},
+    {"vmovdqu", 2, 1, 0x6F, VEX_MOVE},      {"vmovdqa", 1, 1, 0x6F, VEX_MOVE},
+    {NULL, 0, 0, 0, VEX_RM}};
+
+// ==================== 基础工具 ====================
+
+int is_local_label(const char *name)
+{
+    return name[0] == '.' && name[1] == 'L';
+}
+
+static void asm_error(Assembler *as, const char *message, const char *text)
+{
+    if (!as->failed)
+    {
+        fprintf(as->diag, "  Assembler: line %d: %s: %s\n", as->line, message, text);
+    }
+    as->failed = 1;
+}
+
+static void section_reserve(Section *sec, size_t extra)
+{
+    if (sec->size + extra <= sec->capacity)
+        return;
+    size_t capacity = sec->capacity ? sec->capacity : 256;
+    while (capacity < sec->size + extra)
+        capacity *= 2;
+    sec->data = (unsigned char *)realloc(sec->data, capacity);
+    if (!sec->data)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    sec->capacity = capacity;
+}
+
+static void emit_byte(Assembler *as, unsigned char byte)
+{
+    Section *sec = &as->obj->sections[as->section];
+    section_reserve(sec, 1);
+    sec->data[sec->size++] = byte;
+}
+
+static void emit_value(Assembler *as, uint64_t value, int size)
+{
+    for (int i = 0; i < size; i++)
+    {
+        emit_byte(as, (unsigned char)(value >> (i * 8)));
+    }
+}
+
+static size_t current_offset(Assembler *as)
+{
+    return as->obj->sections[as->section].size;
+}
+
+int object_find_symbol(ObjectCode *obj, const char *name)
+{
+    for (int i = 0; i < obj->num_symbols; i++)
+    {
+        if (strcmp(obj->symbols[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+static unsigned int hash_name(const char *name)
+{
+    unsigned int hash = 2166136261u;
+    while (*name)
+    {
+        hash ^= (unsigned char)*name++;
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// 符号数量超过哈希表一半时扩容并重建
+static void rehash_symbols(Assembler *as)
+{
+    int size = as->hash_size ? as->hash_size * 2 : 256;
+    int *table = (int *)malloc(sizeof(int) * size);
+    if (!table)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < size; i++)
+        table[i] = -1;
+    for (int i = 0; i < as->obj->num_symbols; i++)
+    {
+        unsigned int slot = hash_name(as->obj->symbols[i].name) & (size - 1);
+        while (table[slot] >= 0)
+            slot = (slot + 1) & (size - 1);
+        table[slot] = i;
+    }
+    free(as->symbol_hash);
+    as->symbol_hash = table;
+    as->hash_size = size;
+}
+
+// 查找符号，不存在时创建一个未定义符号
+static int get_symbol(Assembler *as, const char *name)
+{
+    ObjectCode *obj = as->obj;
+    if ((obj->num_symbols + 1) * 2 > as->hash_size)
+        rehash_symbols(as);
+
+    unsigned int slot = hash_name(name) & (as->hash_size - 1);
+    while (as->symbol_hash[slot] >= 0)
+    {
+        if (strcmp(obj->symbols[as->symbol_hash[slot]].name, name) == 0)
+            return as->symbol_hash[slot];
+        slot = (slot + 1) & (as->hash_size - 1);
+    }
+
+    if (obj->num_symbols >= obj->symbol_capacity)
+    {
+        obj->symbol_capacity = obj->symbol_capacity ? obj->symbol_capacity * 2 : 32;
+        obj->symbols = (AsmSymbol *)realloc(obj->symbols, sizeof(AsmSymbol) * obj->symbol_capacity);
+        if (!obj->symbols)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+
+    AsmSymbol *sym = &obj->symbols[obj->num_symbols];
+    sym->name = strdup(name);
+    sym->section = -1;
+    sym->offset = 0;
+    sym->is_global = 0;
+    sym->is_function = 0;
+    sym->is_defined = 0;
+    as->symbol_hash[slot] = obj->num_symbols;
+    return obj->num_symbols++;
+}
+
+static void add_fixup(Assembler *as, const char *name, RelocType type, long addend)
+{
+    if (as->num_fixups >= as->fixup_capacity)
+    {
+        as->fixup_capacity = as->fixup_capacity ? as->fixup_capacity * 2 : 64;
+        as->fixups = (Fixup *)realloc(as->fixups, sizeof(Fixup) * as->fixup_capacity);
+        if (!as->fixups)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    Fixup *fix = &as->fixups[as->num_fixups++];
+    fix->section = as->section;
+    fix->offset = current_offset(as);
+    fix->symbol = get_symbol(as, name);
+    fix->type = type;
+    fix->addend = addend;
+}
+
+static void add_relocation(Section *sec, size_t offset, int symbol, RelocType type, long addend)
+{
+    if (sec->num_relocs >= sec->reloc_capacity)
+    {
+        sec->reloc_capacity = sec->reloc_capacity ? sec->reloc_capacity * 2 : 32;
+        sec->relocs = (Relocation *)realloc(sec->relocs, sizeof(Relocation) * sec->reloc_capacity);
+        if (!sec->relocs)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    Relocation *rel = &sec->relocs[sec->num_relocs++];
+    rel->offset = offset;
+    rel->symbol = symbol;
+    rel->type = type;
+    rel->addend = addend;
+}
+
+// ==================== 操作数解析 ====================
+
+static const char *skip_spaces(const char *p)
+{
+    while (*p == ' ' || *p == '\t')
+        p++;
+    return p;
+}
+
+static int is_symbol_char(char c)
+{
+    return isalnum((unsigned char)c) || c == '_' || c == '.' || c == '$';
+}
+
+static int parse_register(const char *name, Operand *op)
+{
+    if (strncmp(name, "xmm", 3) == 0 && isdigit((unsigned char)name[3]))
+    {
+        int number = atoi(name + 3);
+        if (number > 15)
+            return 0;
+        op->reg = number;
+        op->size = 16;
+        op->is_xmm = 1;
+        return 1;
+    }
+    if (strncmp(name, "ymm", 3) == 0 && isdigit((unsigned char)name[3]))
+    {
+        int number = atoi(name + 3);
+        if (number > 15)
+            return 0;
+        op->reg = number;
+        op->size = 32;
+        op->is_xmm = 1;
+        return 1;
+    }
+    for (int i = 0; registers[i].name; i++)
+    {
+        if (strcmp(registers[i].name, name) == 0)
+        {
+            op->reg = registers[i].number;
+            op->size = registers[i].size;
+            op->needs_rex = (op->size == 1 && op->reg >= 4 && op->reg <= 7);
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 解析 "sym+8" / "-16" / "sym" 形式的表达式
+static int parse_expression(const char *text, char *symbol, long *value)
+{
+    const char *p = skip_spaces(text);
+    symbol[0] = '\0';
+    *value = 0;
+
+    if (isalpha((unsigned char)*p) || *p == '_' || *p == '.')
+    {
+        int len = 0;
+        while (is_symbol_char(*p) && len < 127)
+            symbol[len++] = *p++;
+        symbol[len] = '\0';
+        p = skip_spaces(p);
+        if (*p == '\0')
+            return 1;
+        if (*p != '+' && *p != '-')
+            return 0;
+    }
+
+    if (*p == '\0')
+        return 0;
+    char *end;
+    *value = strtol(p, &end, 0);
+    if (end == p)
+        return 0;
+    return *skip_spaces(end) == '\0';
+}
+
+// 解析 "sym1-sym2" 形式的两个符号之差（跳转表的表项）
+static int parse_difference(const char *text, char *minuend, char *subtrahend)
+{
+    const char *p = skip_spaces(text);
+    char *names[2] = {minuend, subtrahend};
+    for (int k = 0; k < 2; k++)
+    {
+        if (!isalpha((unsigned char)*p) && *p != '_' && *p != '.')
+            return 0;
+        int len = 0;
+        while (is_symbol_char(*p) && len < 127)
+            names[k][len++] = *p++;
+        names[k][len] = '\0';
+        p = skip_spaces(p);
+        if (k == 0 && *p++ != '-')
+            return 0;
+        p = skip_spaces(p);
+    }
+    return *p == '\0';
+}
+
+static int parse_operand(const char *text, Operand *op)
+{
+    memset(op, 0, sizeof(Operand));
+    op->base = -1;
+    op->index = -1;
+    op->scale = 1;
+
+    const char *p = skip_spaces(text);
+    if (*p == '*')
+    {
+        op->indirect = 1;
+        p = skip_spaces(p + 1);
+    }
+
+    if (*p == '%')
+    {
+        op->kind = OPERAND_REG;
+        return parse_register(p + 1, op);
+    }
+
+    if (*p == '$')
+    {
+        op->kind = OPERAND_IMM;
+        return parse_expression(p + 1, op->symbol, &op->value);
+    }
+
+    const char *paren = strchr(p, '(');
+    if (!paren)
+    {
+        // 不带括号：跳转目标或绝对地址
+        op->kind = op->indirect ? OPERAND_MEM : OPERAND_LABEL;
+        return parse_expression(p, op->symbol, &op->value);
+    }
+
+    op->kind = OPERAND_MEM;
+    char disp[160];
+    size_t len = (size_t)(paren - p);
+    if (len >= sizeof(disp))
+        return 0;
+    memcpy(disp, p, len);
+    disp[len] = '\0';
+    char *at = strstr(disp, "@GOTPCREL");
+    if (at)
+    {
+        memmove(at, at + 9, strlen(at + 9) + 1);
+        op->gotpcrel = 1;
+    }
+    if (len > 0 && !parse_expression(disp, op->symbol, &op->value))
+        return 0;
+
+    // (base,index,scale)
+    char inner[64];
+    const char *close = strchr(paren, ')');
+    if (!close || (size_t)(close - paren - 1) >= sizeof(inner))
+        return 0;
+    memcpy(inner, paren + 1, close - paren - 1);
+    inner[close - paren - 1] = '\0';
+
+    char *parts[3] = {NULL, NULL, NULL};
+    int num_parts = 0;
+    char *start = inner;
+    for (char *q = inner;; q++)
+    {
+        if (*q == ',' || *q == '\0')
+        {
+            int last = (*q == '\0');
+            *q = '\0';
+            if (num_parts >= 3)
+                return 0;
+            parts[num_parts++] = (char *)skip_spaces(start);
+            start = q + 1;
+            if (last)
+                break;
+        }
+    }
+
+    for (int i = 0; i < num_parts; i++)
+    {
+        char *end = parts[i] + strlen(parts[i]);
+        while (end > parts[i] && (end[-1] == ' ' || end[-1] == '\t'))
+            *--end = '\0';
+    }
+
+    if (parts[0][0] != '\0')
+    {
+        if (strcmp(parts[0], "%rip") == 0)
+        {
+            op->rip = 1;
+        }
+        else
+        {
+            Operand base;
+            memset(&base, 0, sizeof(base));
+            if (parts[0][0] != '%' || !parse_register(parts[0] + 1, &base) || base.size != 8)
+                return 0;
+            op->base = base.reg;
+        }
+    }
+    if (num_parts >= 2)
+    {
+        Operand index;
+        memset(&index, 0, sizeof(index));
+        if (parts[1][0] != '%' || !parse_register(parts[1] + 1, &index) || index.size != 8 ||
+            index.reg == 4)
+            return 0;
+        op->index = index.reg;
+    }
+    if (num_parts == 3)
+    {
+        op->scale = atoi(parts[2]);
+        if (op->scale != 1 && op->scale != 2 && op->scale != 4 && op->scale != 8)
+            return 0;
+    }
+    if (op->gotpcrel && (!op->rip || !op->symbol[0]))
+        return 0;
+    return *skip_spaces(close + 1) == '\0';
+}
+
+// ==================== 指令编码 ====================
+
+static int fits_int8(long value)
+{
+    return value >= -128 && value <= 127;
+}
+
+static int fits_int32(long value)
+{
+    return value >= INT32_MIN && value <= INT32_MAX;
+}
+
+// 输出 REX 前缀（需要时）
+static void emit_rex(Assembler *as, int w, int reg, const Operand *rm, int force)
+{
+    int r = (reg >> 3) & 1;
+    int x = 0, b = 0;
+    if (rm->kind == OPERAND_REG)
+    {
+        b = (rm->reg >> 3) & 1;
+        force |= rm->needs_rex;
+    }
+    else if (rm->kind == OPERAND_MEM)
+    {
+        if (rm->base >= 0)
+            b = (rm->base >> 3) & 1;
+        if (rm->index >= 0)
+            x = (rm->index >> 3) & 1;
+    }
+    if (w || r || x || b || force)
+    {
+        emit_byte(as, (unsigned char)(0x40 | (w << 3) | (r << 2) | (x << 1) | b));
+    }
+}
+
+// 输出 ModRM/SIB/位移；trailing 为位移之后还有多少字节（立即数），用于计算 RIP 相对加数
+static void emit_modrm(Assembler *as, int reg, const Operand *rm, int trailing)
+{
+    reg &= 7;
+    if (rm->kind == OPERAND_REG)
+    {
+        emit_byte(as, (unsigned char)(0xC0 | (reg << 3) | (rm->reg & 7)));
+        return;
+    }
+
+    if (rm->rip)
+    {
+        emit_byte(as, (unsigned char)(0x05 | (reg << 3)));
+        if (rm->symbol[0])
+        {
+            add_fixup(as, rm->symbol, rm->gotpcrel ? RELOC_GOTPCREL : RELOC_PC32, rm->value - 4 - trailing);
+            emit_value(as, 0, 4);
+        }
+        else
+        {
+            emit_value(as, (uint64_t)rm->value, 4);
+        }
+        return;
+    }
+
+    if (rm->base < 0)
+    {
+        // 无基址：[index*scale + disp32] 或绝对地址
+        int index = rm->index >= 0 ? rm->index & 7 : 4;
+        int scale = rm->scale == 8 ? 3 : rm->scale == 4 ? 2 : rm->scale == 2 ? 1 : 0;
+        emit_byte(as, (unsigned char)(0x04 | (reg << 3)));
+        emit_byte(as, (unsigned char)((scale << 6) | (index << 3) | 5));
+        emit_value(as, (uint64_t)rm->value, 4);
+        return;
+    }
+
+    int mod;
+    if (rm->value == 0 && (rm->base & 7) != 5)
+        mod = 0;
+    else if (fits_int8(rm->value))
+        mod = 1;
+    else
+        mod = 2;
+
+    if (rm->index >= 0 || (rm->base & 7) == 4)
+    {
+        int index = rm->index >= 0 ? rm->index & 7 : 4;
+        int scale = rm->scale == 8 ? 3 : rm->scale == 4 ? 2 : rm->scale == 2 ? 1 : 0;
+        emit_byte(as, (unsigned char)((mod << 6) | (reg << 3) | 4));
+        emit_byte(as, (unsigned char)((scale << 6) | (index << 3) | (rm->base & 7)));
+    }
+    else
+    {
+        emit_byte(as, (unsigned char)((mod << 6) | (reg << 3) | (rm->base & 7)));
+    }
+
+    if (mod == 1)
+        emit_byte(as, (unsigned char)rm->value);
+    else if (mod == 2)
+        emit_value(as, (uint64_t)rm->value, 4);
+}
+
+// 通用整数指令：[66] [REX] opcode... ModRM（reg 为扩展操作码或非字节寄存器）
+static void emit_int_op(Assembler *as, int size, const unsigned char *opcode, int opcode_len,
+                        int reg, const Operand *rm, int trailing)
+{
+    if (size == 2)
+        emit_byte(as, 0x66);
+    emit_rex(as, size == 8, reg, rm, 0);
+    for (int i = 0; i < opcode_len; i++)
+        emit_byte(as, opcode[i]);
+    emit_modrm(as, reg, rm, trailing);
+}
+
+// 同上，但 reg 字段本身是 %spl/%sil 等需要 REX 的字节寄存器
+static void emit_int_op_reg(Assembler *as, int size, const unsigned char *opcode, int opcode_len,
+                            const Operand *reg, const Operand *rm, int trailing)
+{
+    if (size == 2)
+        emit_byte(as, 0x66);
+    emit_rex(as, size == 8, reg->reg, rm, reg->needs_rex);
+    for (int i = 0; i < opcode_len; i++)
+        emit_byte(as, opcode[i]);
+    emit_modrm(as, reg->reg, rm, trailing);
+}
+
+static void emit_immediate(Assembler *as, long value, int size)
+{
+    emit_value(as, (uint64_t)value, size);
+}
+
+// 从助记符后缀推断操作数宽度
+static int suffix_size(char suffix)
+{
+    switch (suffix)
+    {
+    case 'b':
+        return 1;
+    case 'w':
+        return 2;
+    case 'l':
+        return 4;
+    case 'q':
+        return 8;
+    default:
+        return 0;
+    }
+}
+
+// 在带/不带后缀两种写法中匹配助记符，返回操作数宽度（无后缀时为 0），不匹配返回 -1
+static int match_mnemonic(const char *mnemonic, const char *base)
+{
+    size_t len = strlen(base);
+    if (strncmp(mnemonic, base, len) != 0)
+        return -1;
+    if (mnemonic[len] == '\0')
+        return 0;
+    if (mnemonic[len + 1] == '\0' && suffix_size(mnemonic[len]))
+        return suffix_size(mnemonic[len]);
+    return -1;
+}
+
+// 确定操作数宽度：优先使用后缀，否则取寄存器操作数的宽度
+static int operand_size(int suffix, Operand *ops, int num_ops)
+{
+    if (suffix > 0)
+        return suffix;
+    for (int i = 0; i < num_ops; i++)
+    {
+        if (ops[i].kind == OPERAND_REG && !ops[i].is_xmm)
+            return ops[i].size;
+    }
+    return 0;
+}
+
+static int match_condition(const char *text)
+{
+    for (int i = 0; conditions[i].name; i++)
+    {
+        if (strcmp(conditions[i].name, text) == 0)
+            return conditions[i].code;
+    }
+    return -1;
+}
+
+// 跳转/调用目标：rel32 + 引用
+static void emit_branch_target(Assembler *as, const Operand *target, RelocType type)
+{
+    add_fixup(as, target->symbol, type, target->value - 4);
+    emit_value(as, 0, 4);
+}
+
+// ALU 指令编号：add/or/adc/sbb/and/sub/xor/cmp
+static const char *alu_names[] = {"add", "or", "adc", "sbb", "and", "sub", "xor", "cmp", NULL};
+
+static int encode_alu(Assembler *as, int op, int size, Operand *src, Operand *dst)
+{
+    if (src->kind == OPERAND_IMM)
+    {
+        if (src->symbol[0] || (dst->kind != OPERAND_REG && dst->kind != OPERAND_MEM))
+            return 0;
+        if (size == 1)
+        {
+            unsigned char opcode = 0x80;
+            emit_int_op(as, size, &opcode, 1, op, dst, 1);
+            emit_immediate(as, src->value, 1);
+        }
+        else if (fits_int8(src->value))
+        {
+            unsigned char opcode = 0x83;
+            emit_int_op(as, size, &opcode, 1, op, dst, 1);
+            emit_immediate(as, src->value, 1);
+        }
+        else
+        {
+            int imm_size = size == 2 ? 2 : 4;
+            if (!fits_int32(src->value))
+                return 0;
+            unsigned char opcode = 0x81;
+            emit_int_op(as, size, &opcode, 1, op, dst, imm_size);
+            emit_immediate(as, src->value, imm_size);
+        }
+        return 1;
+    }
+
+    if (src->kind == OPERAND_REG && (dst->kind == OPERAND_REG || dst->kind == OPERAND_MEM))
+    {
+        unsigned char opcode = (unsigned char)(op * 8 + (size == 1 ? 0 : 1));
+        emit_int_op_reg(as, size, &opcode, 1, src, dst, 0);
+        return 1;
+    }
+
+    if (src->kind == OPERAND_MEM && dst->kind == OPERAND_REG)
+    {
+        unsigned char opcode = (unsigned char)(op * 8 + (size == 1 ? 2 : 3));
+        emit_int_op_reg(as, size, &opcode, 1, dst, src, 0);
+        return 1;
+    }
+    return 0;
+}
+
+static int encode_mov(Assembler *as, int size, Operand *src, Operand *dst)
+{
+    // xmm 与通用寄存器/内存之间的 movq/movd
+    if ((src->kind == OPERAND_REG && src->is_xmm) || (dst->kind == OPERAND_REG && dst->is_xmm))
+    {
+        if (src->size == 32 || dst->size == 32)
+            return 0;
+        int wide = size != 4;
+        if (dst->kind == OPERAND_REG && dst->is_xmm &&
+            src->kind == OPERAND_REG && !src->is_xmm)
+        {
+            emit_byte(as, 0x66);
+            emit_rex(as, wide, dst->reg, src, 0);
+            emit_byte(as, 0x0F);
+            emit_byte(as, 0x6E);
+            emit_modrm(as, dst->reg, src, 0);
+            return 1;
+        }
+        if (src->kind == OPERAND_REG && src->is_xmm &&
+            dst->kind == OPERAND_REG && !dst->is_xmm)
+        {
+            emit_byte(as, 0x66);
+            emit_rex(as, wide, src->reg, dst, 0);
+            emit_byte(as, 0x0F);
+            emit_byte(as, 0x7E);
+            emit_modrm(as, src->reg, dst, 0);
+            return 1;
+        }
+        if (dst->kind == OPERAND_REG && dst->is_xmm && wide)
+        {
+            // movq xmm/m64 → xmm
+            emit_byte(as, 0xF3);
+            emit_rex(as, 0, dst->reg, src, 0);
+            emit_byte(as, 0x0F);
+            emit_byte(as, 0x7E);
+            emit_modrm(as, dst->reg, src, 0);
+            return 1;
+        }
+        if (src->kind == OPERAND_REG && src->is_xmm && dst->kind == OPERAND_MEM && wide)
+        {
+            emit_byte(as, 0x66);
+            emit_rex(as, 0, src->reg, dst, 0);
+            emit_byte(as, 0x0F);
+            emit_byte(as, 0xD6);
+            emit_modrm(as, src->reg, dst, 0);
+            return 1;
+        }
+        return 0;
+    }
+
+    if (size == 0)
+        return 0;
+
+    if (src->kind == OPERAND_IMM)
+    {
+        if (src->symbol[0])
+            return 0;
+        if (dst->kind == OPERAND_REG)
+        {
+            if (size == 8 && !fits_int32(src->value))
+            {
+                // movabs $imm64, reg
+                Operand none;
+                memset(&none, 0, sizeof(none));
+                none.kind = OPERAND_REG;
+                none.reg = dst->reg;
+                emit_rex(as, 1, 0, &none, 0);
+                emit_byte(as, (unsigned char)(0xB8 + (dst->reg & 7)));
+                emit_immediate(as, src->value, 8);
+                return 1;
+            }
+            if (size == 4 || size == 2 || size == 1)
+            {
+                // mov $imm, reg 的短格式
+                if (size == 2)
+                    emit_byte(as, 0x66);
+                emit_rex(as, 0, 0, dst, 0);
+                emit_byte(as, (unsigned char)((size == 1 ? 0xB0 : 0xB8) + (dst->reg & 7)));
+                emit_immediate(as, src->value, size);
+                return 1;
+            }
+        }
+        if (size == 8 && !fits_int32(src->value))
+            return 0;
+        unsigned char opcode = size == 1 ? 0xC6 : 0xC7;
+        int imm_size = size == 1 ? 1 : size == 2 ? 2 : 4;
+        emit_int_op(as, size, &opcode, 1, 0, dst, imm_size);
+        emit_immediate(as, src->value, imm_size);
+        return 1;
+    }
+
+    if (src->kind == OPERAND_REG && (dst->kind == OPERAND_REG || dst->kind == OPERAND_MEM))
+    {
+        unsigned char opcode = size == 1 ? 0x88 : 0x89;
+        emit_int_op_reg(as, size, &opcode, 1, src, dst, 0);
+        return 1;
+    }
+    if (src->kind == OPERAND_MEM && dst->kind == OPERAND_REG)
+    {
+        unsigned char opcode = size == 1 ? 0x8A : 0x8B;
+        emit_int_op_reg(as, size, &opcode, 1, dst, src, 0);
+        return 1;
+    }
+    return 0;
+}
+
+// movzbq/movsbl/movslq 等带扩展的移动
+static int encode_extend(Assembler *as, const char *mnemonic, Operand *src, Operand *dst)
+{
+    if (dst->kind != OPERAND_REG || dst->is_xmm || strlen(mnemonic) != 6)
+        return 0;
+    int sign = mnemonic[3] == 's';
+    int from = suffix_size(mnemonic[4]);
+    int to = suffix_size(mnemonic[5]);
+    if (from == 0 || to == 0 || from >= to)
+        return 0;
+
+    if (from == 4)
+    {
+        // movslq
+        if (!sign || to != 8)
+            return 0;
+        unsigned char opcode = 0x63;
+        emit_int_op(as, 8, &opcode, 1, dst->reg, src, 0);
+        return 1;
+    }
+
+    unsigned char opcode[2] = {0x0F, 0};
+    opcode[1] = (unsigned char)((sign ? 0xBE : 0xB6) + (from == 2 ? 1 : 0));
+    if (to == 2)
+        emit_byte(as, 0x66);
+    emit_rex(as, to == 8, dst->reg, src, 0);
+    emit_byte(as, opcode[0]);
+    emit_byte(as, opcode[1]);
+    emit_modrm(as, dst->reg, src, 0);
+    return 1;
+}
+
+// SSE 指令：prefix [REX] 0F opcode ModRM(reg=xmm 目标)
+static void emit_sse(Assembler *as, unsigned char prefix, int wide, unsigned char opcode,
+                     int reg, const Operand *rm)
+{
+    if (prefix)
+        emit_byte(as, prefix);
+    emit_rex(as, wide, reg, rm, 0);
+    emit_byte(as, 0x0F);
+    emit_byte(as, opcode);
+    emit_modrm(as, reg, rm, 0);
+}
+
+// 带 8 位立即数的打包整数指令：pshufd $imm, src, dst；psrlq/psllq $imm, dst
+static int encode_sse_immediate(Assembler *as, const char *mnemonic, Operand *ops, int num_ops)
+{
+    if (num_ops < 2 || ops[0].kind != OPERAND_IMM || ops[0].symbol[0])
+        return 0;
+    Operand *dst = &ops[num_ops - 1];
+    if (dst->kind != OPERAND_REG || !dst->is_xmm)
+        return 0;
+    if (strcmp(mnemonic, "pshufd") == 0 && num_ops == 3)
+    {
+        if (ops[1].kind == OPERAND_REG && !ops[1].is_xmm)
+            return 0;
+        emit_byte(as, 0x66);
+        emit_rex(as, 0, dst->reg, &ops[1], 0);
+        emit_byte(as, 0x0F);
+        emit_byte(as, 0x70);
+        emit_modrm(as, dst->reg, &ops[1], 1);
+        emit_byte(as, (unsigned char)ops[0].value);
+        return 1;
+    }
+    int ext = strcmp(mnemonic, "psrlq") == 0 ? 2 : strcmp(mnemonic, "psllq") == 0 ? 6 : -1;
+    if (ext < 0 || num_ops != 2)
+        return 0;
+    emit_byte(as, 0x66);
+    emit_rex(as, 0, 0, dst, 0);
+    emit_byte(as, 0x0F);
+    emit_byte(as, 0x73);
+    emit_modrm(as, ext, dst, 1);
+    emit_byte(as, (unsigned char)ops[0].value);
+    return 1;
+}
+
+static int encode_sse(Assembler *as, const char *mnemonic, Operand *ops, int num_ops)
+{
+    for (int i = 0; i < num_ops; i++)
+    {
+        if (ops[i].kind == OPERAND_REG && ops[i].size == 32)
+            return 0; // ymm 只能用 VEX 编码
+    }
+    if (encode_sse_immediate(as, mnemonic, ops, num_ops))
+        return 1;
+    if (num_ops != 2)
+        return 0;
+    Operand *src = &ops[0];
+    Operand *dst = &ops[1];
+
+    for (int i = 0; sse_arith[i].name; i++)
+    {
+        if (strcmp(mnemonic, sse_arith[i].name) == 0)
+        {
+            if (dst->kind != OPERAND_REG || !dst->is_xmm ||
+                (src->kind == OPERAND_REG && !src->is_xmm))
+                return 0;
+            emit_sse(as, sse_arith[i].prefix, 0, sse_arith[i].opcode, dst->reg, src);
+            return 1;
+        }
+    }
+
+    for (int i = 0; sse_moves[i].name; i++)
+    {
+        if (strcmp(mnemonic, sse_moves[i].name) == 0)
+        {
+            if (dst->kind == OPERAND_REG && dst->is_xmm && (src->kind != OPERAND_REG || src->is_xmm))
+            {
+                emit_sse(as, sse_moves[i].prefix, 0, sse_moves[i].load, dst->reg, src);
+                return 1;
+            }
+            if (src->kind == OPERAND_REG && src->is_xmm && dst->kind == OPERAND_MEM)
+            {
+                emit_sse(as, sse_moves[i].prefix, 0, sse_moves[i].store, src->reg, dst);
+                return 1;
+            }
+            return 0;
+        }
+    }
+
+    // 整数 ↔ 浮点转换
+    unsigned char prefix = 0;
+    const char *rest = NULL;
+    if (strncmp(mnemonic, "cvtsi2ss", 8) == 0)
+    {
+        prefix = 0xF3;
+        rest = mnemonic + 8;
+    }
+    else if (strncmp(mnemonic, "cvtsi2sd", 8) == 0)
+    {
+        prefix = 0xF2;
+        rest = mnemonic + 8;
+    }
+    if (rest)
+    {
+        int size = suffix_size(*rest);
+        if (*rest && (size == 0 || rest[1]))
+            return 0;
+        if (size == 0)
+            size = src->kind == OPERAND_REG ? src->size : 4;
+        if (dst->kind != OPERAND_REG || !dst->is_xmm || (src->kind == OPERAND_REG && src->is_xmm))
+            return 0;
+        emit_sse(as, prefix, size == 8, 0x2A, dst->reg, src);
+        return 1;
+    }
+
+    unsigned char opcode = 0;
+    if (strcmp(mnemonic, "cvttss2si") == 0 || strcmp(mnemonic, "cvttss2siq") == 0 ||
+        strcmp(mnemonic, "cvttss2sil") == 0)
+    {
+        prefix = 0xF3;
+        opcode = 0x2C;
+    }
+    else if (strcmp(mnemonic, "cvttsd2si") == 0 || strcmp(mnemonic, "cvttsd2siq") == 0 ||
+             strcmp(mnemonic, "cvttsd2sil") == 0)
+    {
+        prefix = 0xF2;
+        opcode = 0x2C;
+    }
+    else if (strcmp(mnemonic, "cvtss2si") == 0 || strcmp(mnemonic, "cvtss2siq") == 0)
+    {
+        prefix = 0xF3;
+        opcode = 0x2D;
+    }
+    else if (strcmp(mnemonic, "cvtsd2si") == 0 || strcmp(mnemonic, "cvtsd2siq") == 0)
+    {
+        prefix = 0xF2;
+        opcode = 0x2D;
+    }
+    if (opcode)
+    {
+        if (dst->kind != OPERAND_REG || dst->is_xmm || (src->kind == OPERAND_REG && !src->is_xmm))
+            return 0;
+        emit_sse(as, prefix, dst->size == 8, opcode, dst->reg, src);
+        return 1;
+    }
+    return 0;
+}
+
+// VEX 前缀 + 操作码 + ModRM：能用两字节形式（C5）时用两字节，否则用三字节（C4）
+static void emit_vex(Assembler *as, const VexInfo *info, int w, int l, int reg, int vvvv, const Operand *rm,
+                     int trailing)
+{
+    int r = (reg >> 3) & 1;
+    int x = 0, b = 0;
+    if (rm->kind == OPERAND_REG)
+    {
+        b = (rm->reg >> 3) & 1;
+    }
+    else if (rm->kind == OPERAND_MEM)
+    {
+        if (rm->base >= 0)
+            b = (rm->base >> 3) & 1;
+        if (rm->index >= 0)
+            x = (rm->index >> 3) & 1;
+    }
+    int tail = (w << 7) | ((~vvvv & 15) << 3) | (l << 2) | info->pp;
+    if (info->map == 1 && !w && !x && !b)
+    {
+        emit_byte(as, 0xC5);
+        emit_byte(as, (unsigned char)((!r << 7) | (tail & 0x7F)));
+    }
+    else
+    {
+        emit_byte(as, 0xC4);
+        emit_byte(as, (unsigned char)((!r << 7) | (!x << 6) | (!b << 5) | info->map));
+        emit_byte(as, (unsigned char)tail);
+    }
+    emit_byte(as, info->opcode);
+    emit_modrm(as, reg, rm, trailing);
+}
+
+static int is_vector_register(const Operand *op)
+{
+    return op->kind == OPERAND_REG && op->is_xmm;
+}
+
+static int encode_vex(Assembler *as, const char *mnemonic, Operand *ops, int num_ops)
+{
+    int l = 0;
+    for (int i = 0; i < num_ops; i++)
+        l |= ops[i].kind == OPERAND_REG && ops[i].size == 32;
+
+    // vmovd/vmovq：通用寄存器与 xmm 之间
+    if ((strcmp(mnemonic, "vmovd") == 0 || strcmp(mnemonic, "vmovq") == 0) && num_ops == 2 && !l)
+    {
+        VexInfo info = {mnemonic, 1, 1, 0x6E, VEX_RM};
+        int w = mnemonic[4] == 'q';
+        if (is_vector_register(&ops[1]) && ops[0].kind == OPERAND_REG && !ops[0].is_xmm)
+        {
+            emit_vex(as, &info, w, 0, ops[1].reg, 0, &ops[0], 0);
+            return 1;
+        }
+        if (is_vector_register(&ops[0]) && ops[1].kind == OPERAND_REG && !ops[1].is_xmm)
+        {
+            info.opcode = 0x7E;
+            emit_vex(as, &info, w, 0, ops[0].reg, 0, &ops[1], 0);
+            return 1;
+        }
+        return 0;
+    }
+
+    for (int i = 0; vex_ops[i].name; i++)
+    {
+        const VexInfo *info = &vex_ops[i];
+        if (strcmp(mnemonic, info->name) != 0)
+            continue;
+        switch (info->form)
+        {
+        case VEX_RVM:
+            if (num_ops != 3 || !is_vector_register(&ops[1]) || !is_vector_register(&ops[2]) ||
+                (ops[0].kind == OPERAND_REG && !ops[0].is_xmm) || ops[0].kind == OPERAND_IMM)
+                return 0;
+            emit_vex(as, info, 0, l, ops[2].reg, ops[1].reg, &ops[0], 0);
+            return 1;
+        case VEX_RM:
+            if (num_ops != 2 || !is_vector_register(&ops[1]) || (ops[0].kind == OPERAND_REG && !ops[0].is_xmm) ||
+                ops[0].kind == OPERAND_IMM)
+                return 0;
+            emit_vex(as, info, 0, l, ops[1].reg, 0, &ops[0], 0);
+            return 1;
+        case VEX_RMI:
+            if (num_ops != 3 || ops[0].kind != OPERAND_IMM || !is_vector_register(&ops[2]) ||
+                (ops[1].kind == OPERAND_REG && !ops[1].is_xmm))
+                return 0;
+            emit_vex(as, info, 0, l, ops[2].reg, 0, &ops[1], 1);
+            emit_byte(as, (unsigned char)ops[0].value);
+            return 1;
+        case VEX_MRI:
+            if (num_ops != 3 || ops[0].kind != OPERAND_IMM || !is_vector_register(&ops[1]) || ops[1].size != 32 ||
+                (ops[2].kind == OPERAND_REG && (!ops[2].is_xmm || ops[2].size != 16)))
+                return 0;
+            emit_vex(as, info, 0, 1, ops[1].reg, 0, &ops[2], 1);
+            emit_byte(as, (unsigned char)ops[0].value);
+            return 1;
+        case VEX_MOVE:
+            if (num_ops != 2)
+                return 0;
+            if (is_vector_register(&ops[1]) && ops[0].kind != OPERAND_IMM && (ops[0].kind != OPERAND_REG || ops[0].is_xmm))
+            {
+                emit_vex(as, info, 0, l, ops[1].reg, 0, &ops[0], 0);
+                return 1;
+            }
+            if (is_vector_register(&ops[0]) && ops[1].kind == OPERAND_MEM)
+            {
+                VexInfo store = *info;
+                store.opcode = (unsigned char)(info->opcode + 0x10);
+                emit_vex(as, &store, 0, l, ops[0].reg, 0, &ops[1], 0);
+                return 1;
+            }
+            return 0;
+        }
+    }
+    return 0;
+}
+
+// 编码一条指令，成功返回 1
+static int encode_instruction(Assembler *as, const char *mnemonic, Operand *ops, int num_ops)
+{
+    int suffix;
+
+    // 无操作数指令
+    if (num_ops == 0)
+    {
+        static const struct
+        {
+            const char *name;
+            unsigned char bytes[3];
+            int len;
+        } simple[] = {
+            {"ret", {0xC3}, 1}, {"retq", {0xC3}, 1}, {"leave", {0xC9}, 1}, {"leaveq", {0xC9}, 1},
+            {"nop", {0x90}, 1}, {"cqto", {0x48, 0x99}, 2}, {"cqo", {0x48, 0x99}, 2},
+            {"cltq", {0x48, 0x98}, 2}, {"cdqe", {0x48, 0x98}, 2}, {"cltd", {0x99}, 1},
+            {"cdq", {0x99}, 1}, {"ud2", {0x0F, 0x0B}, 2}, {"hlt", {0xF4}, 1},
+            {"vzeroupper", {0xC5, 0xF8, 0x77}, 3}, {NULL, {0}, 0}};
+        for (int i = 0; simple[i].name; i++)
+        {
+            if (strcmp(mnemonic, simple[i].name) == 0)
+            {
+                for (int j = 0; j < simple[i].len; j++)
+                    emit_byte(as, simple[i].bytes[j]);
+                return 1;
+            }
+        }
+        return 0;
+    }
+
+    // 跳转与调用
+    if (strcmp(mnemonic, "jmp") == 0 || strcmp(mnemonic, "call") == 0 ||
+        strcmp(mnemonic, "jmpq") == 0 || strcmp(mnemonic, "callq") == 0)
+    {
+        int is_call = mnemonic[0] == 'c';
+        if (num_ops != 1)
+            return 0;
+        if (ops[0].indirect)
+        {
+            unsigned char opcode = 0xFF;
+            if (ops[0].kind == OPERAND_LABEL)
+                return 0;
+            emit_int_op(as, 4, &opcode, 1, is_call ? 2 : 4, &ops[0], 0);
+            return 1;
+        }
+        if (ops[0].kind != OPERAND_LABEL || !ops[0].symbol[0])
+            return 0;
+        emit_byte(as, is_call ? 0xE8 : 0xE9);
+        // 跳到函数（尾调用）和调用一样经过 PLT，被调函数可以在共享库中
+        emit_branch_target(as, &ops[0], is_call || !is_local_label(ops[0].symbol) ? RELOC_PLT32 : RELOC_PC32);
+        return 1;
+    }
+
+    if (mnemonic[0] == 'j')
+    {
+        int cc = match_condition(mnemonic + 1);
+        if (cc < 0 || num_ops != 1 || ops[0].kind != OPERAND_LABEL || !ops[0].symbol[0])
+            return 0;
+        emit_byte(as, 0x0F);
+        emit_byte(as, (unsigned char)(0x80 + cc));
+        emit_branch_target(as, &ops[0], RELOC_PC32);
+        return 1;
+    }
+
+    // setcc
+    if (strncmp(mnemonic, "set", 3) == 0)
+    {
+        int cc = match_condition(mnemonic + 3);
+        if (cc >= 0)
+        {
+            if (num_ops != 1 || (ops[0].kind == OPERAND_REG && ops[0].size != 1))
+                return 0;
+            unsigned char opcode[2] = {0x0F, (unsigned char)(0x90 + cc)};
+            emit_int_op(as, 1, opcode, 2, 0, &ops[0], 0);
+            return 1;
+        }
+    }
+
+    // cmovcc（可带 q/l 后缀）
+    if (strncmp(mnemonic, "cmov", 4) == 0 && num_ops == 2 && ops[1].kind == OPERAND_REG)
+    {
+        char cond[8];
+        size_t len = strlen(mnemonic + 4);
+        if (len > 0 && len < sizeof(cond))
+        {
+            strcpy(cond, mnemonic + 4);
+            int cc = match_condition(cond);
+            if (cc < 0 && len > 1 && suffix_size(cond[len - 1]))
+            {
+                cond[len - 1] = '\0';
+                cc = match_condition(cond);
+            }
+            if (cc >= 0)
+            {
+                unsigned char opcode[2] = {0x0F, (unsigned char)(0x40 + cc)};
+                emit_int_op(as, ops[1].size, opcode, 2, ops[1].reg, &ops[0], 0);
+                return 1;
+            }
+        }
+    }
+
+    // push/pop
+    if ((suffix = match_mnemonic(mnemonic, "push")) >= 0 && num_ops == 1)
+    {
+        if (ops[0].kind == OPERAND_REG && ops[0].size == 8)
+        {
+            if (ops[0].reg >= 8)
+                emit_byte(as, 0x41);
+            emit_byte(as, (unsigned char)(0x50 + (ops[0].reg & 7)));
+            return 1;
+        }
+        if (ops[0].kind == OPERAND_IMM && !ops[0].symbol[0] && fits_int32(ops[0].value))
+        {
+            if (fits_int8(ops[0].value))
+            {
+                emit_byte(as, 0x6A);
+                emit_immediate(as, ops[0].value, 1);
+            }
+            else
+            {
+                emit_byte(as, 0x68);
+                emit_immediate(as, ops[0].value, 4);
+            }
+            return 1;
+        }
+        if (ops[0].kind == OPERAND_MEM)
+        {
+            unsigned char opcode = 0xFF;
+            emit_int_op(as, 4, &opcode, 1, 6, &ops[0], 0);
+            return 1;
+        }
+        return 0;
+    }
+    if ((suffix = match_mnemonic(mnemonic, "pop")) >= 0 && num_ops == 1)
+    {
+        if (ops[0].kind == OPERAND_REG && ops[0].size == 8)
+        {
+            if (ops[0].reg >= 8)
+                emit_byte(as, 0x41);
+            emit_byte(as, (unsigned char)(0x58 + (ops[0].reg & 7)));
+            return 1;
+        }
+        if (ops[0].kind == OPERAND_MEM)
+        {
+            unsigned char opcode = 0x8F;
+            emit_int_op(as, 4, &opcode, 1, 0, &ops[0], 0);
+            return 1;
+        }
+        return 0;
+    }
+
+    // SSE / AVX
+    if (encode_sse(as, mnemonic, ops, num_ops))
+        return 1;
+    if (mnemonic[0] == 'v' && encode_vex(as, mnemonic, ops, num_ops))
+        return 1;
+
+    // 带扩展的移动：movzbq/movsbl/movslq ...
+    if ((strncmp(mnemonic, "movz", 4) == 0 || strncmp(mnemonic, "movs", 4) == 0) &&
+        strlen(mnemonic) == 6 && num_ops == 2)
+    {
+        return encode_extend(as, mnemonic, &ops[0], &ops[1]);
+    }
+
+    // mov / movabs
+    if ((suffix = match_mnemonic(mnemonic, "mov")) >= 0 ||
+        (suffix = match_mnemonic(mnemonic, "movabs")) >= 0)
+    {
+        if (num_ops != 2)
+            return 0;
+        if (strcmp(mnemonic, "movd") == 0)
+            suffix = 4;
+        return encode_mov(as, operand_size(suffix, ops, num_ops), &ops[0], &ops[1]);
+    }
+    if (strcmp(mnemonic, "movd") == 0 && num_ops == 2)
+    {
+        return encode_mov(as, 4, &ops[0], &ops[1]);
+    }
+
+    // ALU 指令
+    for (int op = 0; alu_names[op]; op++)
+    {
+        if ((suffix = match_mnemonic(mnemonic, alu_names[op])) >= 0)
+        {
+            int size = operand_size(suffix, ops, num_ops);
+            if (num_ops != 2 || size == 0)
+                return 0;
+            return encode_alu(as, op, size, &ops[0], &ops[1]);
+        }
+    }
+
+    // lea
+    if ((suffix = match_mnemonic(mnemonic, "lea")) >= 0)
+    {
+        if (num_ops != 2 || ops[0].kind != OPERAND_MEM || ops[1].kind != OPERAND_REG)
+            return 0;
+        unsigned char opcode = 0x8D;
+        emit_int_op(as, ops[1].size, &opcode, 1, ops[1].reg, &ops[0], 0);
+        return 1;
+    }
+
+    // test
+    if ((suffix = match_mnemonic(mnemonic, "test")) >= 0)
+    {
+        int size = operand_size(suffix, ops, num_ops);
+        if (num_ops != 2 || size == 0)
+            return 0;
+        if (ops[0].kind == OPERAND_IMM)
+        {
+            unsigned char opcode = size == 1 ? 0xF6 : 0xF7;
+            int imm_size = size == 1 ? 1 : size == 2 ? 2 : 4;
+            emit_int_op(as, size, &opcode, 1, 0, &ops[1], imm_size);
+            emit_immediate(as, ops[0].value, imm_size);
+            return 1;
+        }
+        if (ops[0].kind != OPERAND_REG)
+            return 0;
+        unsigned char opcode = size == 1 ? 0x84 : 0x85;
+        emit_int_op_reg(as, size, &opcode, 1, &ops[0], &ops[1], 0);
+        return 1;
+    }
+
+    // imul：单操作数 / 双操作数 / 带立即数
+    if ((suffix = match_mnemonic(mnemonic, "imul")) >= 0)
+    {
+        int size = operand_size(suffix, ops, num_ops);
+        if (size == 0)
+            return 0;
+        if (num_ops == 1)
+        {
+            unsigned char opcode = size == 1 ? 0xF6 : 0xF7;
+            emit_int_op(as, size, &opcode, 1, 5, &ops[0], 0);
+            return 1;
+        }
+        if (ops[0].kind == OPERAND_IMM)
+        {
+            Operand *src = &ops[1];
+            Operand *dst = &ops[num_ops - 1];
+            if (dst->kind != OPERAND_REG || ops[0].symbol[0] || !fits_int32(ops[0].value))
+                return 0;
+            if (fits_int8(ops[0].value))
+            {
+                unsigned char opcode = 0x6B;
+                emit_int_op(as, size, &opcode, 1, dst->reg, src, 1);
+                emit_immediate(as, ops[0].value, 1);
+            }
+            else
+            {
+                unsigned char opcode = 0x69;
+                int imm_size = size == 2 ? 2 : 4;
+                emit_int_op(as, size, &opcode, 1, dst->reg, src, imm_size);
+                emit_immediate(as, ops[0].value, imm_size);
+            }
+            return 1;
+        }
+        if (num_ops != 2 || ops[1].kind != OPERAND_REG)
+            return 0;
+        unsigned char opcode[2] = {0x0F, 0xAF};
+        emit_int_op(as, size, opcode, 2, ops[1].reg, &ops[0], 0);
+        return 1;
+    }
+
+    // 单操作数 F6/F7 组与 FE/FF 组
+    static const struct
+    {
+        const char *name;
+        int group; // 0: F6/F7，1: FE/FF
+        int ext;
+    } unary[] = {
+        {"not", 0, 2}, {"neg", 0, 3}, {"mul", 0, 4}, {"div", 0, 6}, {"idiv", 0, 7},
+        {"inc", 1, 0}, {"dec", 1, 1}, {NULL, 0, 0}};
+    for (int i = 0; unary[i].name; i++)
+    {
+        if ((suffix = match_mnemonic(mnemonic, unary[i].name)) >= 0)
+        {
+            int size = operand_size(suffix, ops, num_ops);
+            if (num_ops != 1 || size == 0 || ops[0].kind == OPERAND_IMM)
+                return 0;
+            unsigned char opcode;
+            if (unary[i].group == 0)
+                opcode = size == 1 ? 0xF6 : 0xF7;
+            else
+                opcode = size == 1 ? 0xFE : 0xFF;
+            emit_int_op(as, size, &opcode, 1, unary[i].ext, &ops[0], 0);
+            return 1;
+        }
+    }
+
+    // 移位
+    static const struct
+    {
+        const char *name;
+        int ext;
+    } shifts[] = {
+        {"rol", 0}, {"ror", 1}, {"shl", 4}, {"sal", 4}, {"shr", 5}, {"sar", 7}, {NULL, 0}};
+    for (int i = 0; shifts[i].name; i++)
+    {
+        if ((suffix = match_mnemonic(mnemonic, shifts[i].name)) >= 0)
+        {
+            Operand *dst = &ops[num_ops - 1];
+            int size = suffix > 0 ? suffix : (dst->kind == OPERAND_REG ? dst->size : 0);
+            if (size == 0 || num_ops > 2)
+                return 0;
+            if (num_ops == 1 || (ops[0].kind == OPERAND_IMM && ops[0].value == 1))
+            {
+                unsigned char opcode = size == 1 ? 0xD0 : 0xD1;
+                emit_int_op(as, size, &opcode, 1, shifts[i].ext, dst, 0);
+                return 1;
+            }
+            if (ops[0].kind == OPERAND_REG && ops[0].reg == 1 && ops[0].size == 1)
+            {
+                unsigned char opcode = size == 1 ? 0xD2 : 0xD3;
+                emit_int_op(as, size, &opcode, 1, shifts[i].ext, dst, 0);
+                return 1;
+            }
+            if (ops[0].kind == OPERAND_IMM && !ops[0].symbol[0])
+            {
+                unsigned char opcode = size == 1 ? 0xC0 : 0xC1;
+                emit_int_op(as, size, &opcode, 1, shifts[i].ext, dst, 1);
+                emit_immediate(as, ops[0].value, 1);
+                return 1;
+            }
+            return 0;
+        }
+    }
+
+    return 0;
+}
+
+// ==================== 伪指令 ====================
+
+static void align_section(Assembler *as, int alignment)
+{
+    if (alignment <= 1)
+        return;
+    Section *sec = &as->obj->sections[as->section];
+    if (alignment > sec->alignment)
+        sec->alignment = alignment;
+    while (sec->size % alignment)
+        emit_byte(as, as->section == SECTION_TEXT ? 0x90 : 0x00);
+}
+
+// 解析字符串字面量（支持常见转义）
+static int emit_string(Assembler *as, const char *p, int terminate)
+{
+    p = skip_spaces(p);
+    if (*p != '"')
+        return 0;
+    p++;
+    while (*p && *p != '"')
+    {
+        if (*p == '\\')
+        {
+            p++;
+            switch (*p)
+            {
+            case 'n':
+                emit_byte(as, '\n');
+                p++;
+                break;
+            case 't':
+                emit_byte(as, '\t');
+                p++;
+                break;
+            case 'r':
+                emit_byte(as, '\r');
+                p++;
+                break;
+            case 'b':
+                emit_byte(as, '\b');
+                p++;
+                break;
+            case 'f':
+                emit_byte(as, '\f');
+                p++;
+                break;
+            case 'x':
+            {
+                int value = 0;
+                p++;
+                while (isxdigit((unsigned char)*p))
+                {
+                    value = value * 16 + (isdigit((unsigned char)*p) ? *p - '0' : (tolower(*p) - 'a' + 10));
+                    p++;
+                }
+                emit_byte(as, (unsigned char)value);
+                break;
+            }
+            default:
+                if (*p >= '0' && *p <= '7')
+                {
+                    int value = 0;
+                    for (int i = 0; i < 3 && *p >= '0' && *p <= '7'; i++)
+                        value = value * 8 + (*p++ - '0');
+                    emit_byte(as, (unsigned char)value);
+                }
+                else if (*p)
+                {
+                    emit_byte(as, (unsigned char)*p++);
+                }
+                break;
+            }
+        }
+        else
+        {
+            emit_byte(as, (unsigned char)*p++);
+        }
+    }
+    if (*p != '"')
+        return 0;
+    if (terminate)
+        emit_byte(as, 0);
+    return 1;
+}
+
+// 逗号分隔的数据（.byte/.short/.long/.quad），.quad 支持符号，.long 支持两个符号之差
+static int emit_data_list(Assembler *as, const char *args, int size)
+{
+    char item[160];
+    const char *p = args;
+    while (*p)
+    {
+        const char *comma = strchr(p, ',');
+        size_t len = comma ? (size_t)(comma - p) : strlen(p);
+        if (len >= sizeof(item))
+            return 0;
+        memcpy(item, p, len);
+        item[len] = '\0';
+
+        char symbol[128];
+        char base[128];
+        long value;
+        if (size == 4 && parse_difference(item, symbol, base))
+        {
+            // .long A-B：B 必须已在当前段中定义，A - B = (A - P) + (P - B)，按 PC 相对引用处理
+            int index = get_symbol(as, base);
+            AsmSymbol *sym = &as->obj->symbols[index];
+            if (!sym->is_defined || sym->section != as->section)
+                return 0;
+            add_fixup(as, symbol, RELOC_PC32, (long)(current_offset(as) - sym->offset));
+            emit_value(as, 0, 4);
+            p = comma ? comma + 1 : p + len;
+            continue;
+        }
+        if (!parse_expression(item, symbol, &value))
+            return 0;
+        if (symbol[0])
+        {
+            if (size != 8)
+                return 0;
+            add_fixup(as, symbol, RELOC_ABS64, value);
+            value = 0;
+        }
+        emit_value(as, (uint64_t)value, size);
+        p = comma ? comma + 1 : p + len;
+    }
+    return 1;
+}
+
+// 切换到指定名字的段，不认识的段返回 0
+static int switch_section(Assembler *as, const char *name)
+{
+    if (strcmp(name, ".text") == 0)
+        as->section = SECTION_TEXT;
+    else if (strcmp(name, ".data") == 0)
+        as->section = SECTION_DATA;
+    else if (strcmp(name, ".rodata") == 0 || strncmp(name, ".rodata.", 8) == 0)
+        as->section = SECTION_RODATA;
+    else
+        return 0;
+    return 1;
+}
+
+static int handle_directive(Assembler *as, const char *name, const char *args)
+{
+    if (strcmp(name, ".text") == 0 || strcmp(name, ".data") == 0)
+        return switch_section(as, name);
+
+    if (strcmp(name, ".section") == 0)
+    {
+        char section[64];
+        int len = 0;
+        while (args[len] && args[len] != ',' && args[len] != ' ' && len < 63)
+        {
+            section[len] = args[len];
+            len++;
+        }
+        section[len] = '\0';
+        // 不可执行栈标记：ELF 写出时总会带上
+        if (strcmp(section, ".note.GNU-stack") == 0)
+            return 1;
+        return switch_section(as, section);
+    }
+
+    if (strcmp(name, ".globl") == 0 || strcmp(name, ".global") == 0)
+    {
+        char symbol[128];
+        long value;
+        if (!parse_expression(args, symbol, &value) || !symbol[0])
+            return 0;
+        int index = get_symbol(as, symbol);
+        as->obj->symbols[index].is_global = 1;
+        return 1;
+    }
+
+    if (strcmp(name, ".type") == 0)
+    {
+        const char *comma = strchr(args, ',');
+        char symbol[128];
+        long value;
+        if (!comma || (size_t)(comma - args) >= sizeof(symbol))
+            return 0;
+        char head[128];
+        memcpy(head, args, comma - args);
+        head[comma - args] = '\0';
+        if (!parse_expression(head, symbol, &value) || !symbol[0])
+            return 0;
+        int index = get_symbol(as, symbol);
+        if (strstr(comma, "function"))
+            as->obj->symbols[index].is_function = 1;
+        return 1;
+    }
+
+    // 对目标文件没有影响的伪指令
+    if (strcmp(name, ".file") == 0 || strcmp(name, ".size") == 0 ||
+        strcmp(name, ".ident") == 0 || strcmp(name, ".local") == 0)
+        return 1;
+
+    if (strcmp(name, ".string") == 0 || strcmp(name, ".asciz") == 0)
+        return emit_string(as, args, 1);
+    if (strcmp(name, ".ascii") == 0)
+        return emit_string(as, args, 0);
+
+    if (strcmp(name, ".byte") == 0)
+        return emit_data_list(as, args, 1);
+    if (strcmp(name, ".short") == 0 || strcmp(name, ".value") == 0 || strcmp(name, ".word") == 0)
+        return emit_data_list(as, args, 2);
+    if (strcmp(name, ".long") == 0 || strcmp(name, ".int") == 0)
+        return emit_data_list(as, args, 4);
+    if (strcmp(name, ".quad") == 0)
+        return emit_data_list(as, args, 8);
+
+    if (strcmp(name, ".zero") == 0 || strcmp(name, ".skip") == 0 || strcmp(name, ".space") == 0)
+    {
+        long count = strtol(args, NULL, 0);
+        if (count < 0)
+            return 0;
+        for (long i = 0; i < count; i++)
+            emit_byte(as, 0);
+        return 1;
+    }
+
+    if (strcmp(name, ".align") == 0 || strcmp(name, ".balign") == 0)
+    {
+        align_section(as, (int)strtol(args, NULL, 0));
+        return 1;
+    }
+    if (strcmp(name, ".p2align") == 0)
+    {
+        align_section(as, 1 << (int)strtol(args, NULL, 0));
+        return 1;
+    }
+
+    return 0;
+}
+
+// ==================== 逐行汇编 ====================
+
+static void define_label(Assembler *as, const char *name)
+{
+    int index = get_symbol(as, name);
+    AsmSymbol *sym = &as->obj->symbols[index];
+    if (sym->is_defined)
+    {
+        asm_error(as, "symbol already defined", name);
+        return;
+    }
+    sym->is_defined = 1;
+    sym->section = as->section;
+    sym->offset = current_offset(as);
+}
+
+// 去掉 '#' 注释（字符串内的除外）和行尾空白
+static void strip_comment(char *line)
+{
+    int in_string = 0;
+    for (char *p = line; *p; p++)
+    {
+        if (*p == '"' && (p == line || p[-1] != '\\'))
+            in_string = !in_string;
+        else if (*p == '#' && !in_string)
+        {
+            *p = '\0';
+            break;
+        }
+    }
+    size_t len = strlen(line);
+    while (len > 0 && isspace((unsigned char)line[len - 1]))
+        line[--len] = '\0';
+}
+
+static void assemble_line(Assembler *as, char *line)
+{
+    strip_comment(line);
+    char *p = (char *)skip_spaces(line);
+
+    // 标签（可能有多个，后面还可以跟指令）
+    for (;;)
+    {
+        char *q = p;
+        while (is_symbol_char(*q))
+            q++;
+        if (q > p && *q == ':')
+        {
+            *q = '\0';
+            define_label(as, p);
+            p = (char *)skip_spaces(q + 1);
+            continue;
+        }
+        break;
+    }
+    if (*p == '\0')
+        return;
+
+    // 助记符或伪指令名
+    char mnemonic[32];
+    int len = 0;
+    while (*p && !isspace((unsigned char)*p) && len < 31)
+        mnemonic[len++] = *p++;
+    mnemonic[len] = '\0';
+    p = (char *)skip_spaces(p);
+
+    if (mnemonic[0] == '.')
+    {
+        if (!handle_directive(as, mnemonic, p))
+            asm_error(as, "unsupported directive", mnemonic);
+        return;
+    }
+
+    // 拆分操作数（括号内的逗号不算分隔符）
+    Operand ops[MAX_OPERANDS];
+    int num_ops = 0;
+    while (*p)
+    {
+        char text[192];
+        int depth = 0;
+        int n = 0;
+        while (*p && (depth > 0 || *p != ','))
+        {
+            if (*p == '(')
+                depth++;
+            else if (*p == ')')
+                depth--;
+            if (n < (int)sizeof(text) - 1)
+                text[n++] = *p;
+            p++;
+        }
+        text[n] = '\0';
+        if (*p == ',')
+            p++;
+        // 只支持 RIP 相对的符号地址（绝对地址需要 R_X86_64_32S 重定位）
+        if (num_ops >= MAX_OPERANDS || !parse_operand(text, &ops[num_ops]) ||
+            (ops[num_ops].kind == OPERAND_MEM && ops[num_ops].symbol[0] && !ops[num_ops].rip))
+        {
+            asm_error(as, "unsupported operand", text);
+            return;
+        }
+        num_ops++;
+    }
+
+    if (as->section != SECTION_TEXT)
+    {
+        asm_error(as, "instruction outside .text", mnemonic);
+        return;
+    }
+
+    if (!encode_instruction(as, mnemonic, ops, num_ops))
+    {
+        asm_error(as, "unsupported instruction", line);
+    }
+}
+
+// 汇编结束后处理所有引用：段内可确定的 PC 相对引用直接回填，其余生成重定位
+static void resolve_fixups(Assembler *as)
+{
+    ObjectCode *obj = as->obj;
+    for (int i = 0; i < as->num_fixups; i++)
+    {
+        Fixup *fix = &as->fixups[i];
+        AsmSymbol *sym = &obj->symbols[fix->symbol];
+        Section *sec = &obj->sections[fix->section];
+
+        if (!sym->is_defined && is_local_label(sym->name))
+        {
+            asm_error(as, "undefined local label", sym->name);
+            return;
+        }
+
+        if (fix->type != RELOC_ABS64 && fix->type != RELOC_GOTPCREL && sym->is_defined && !sym->is_global &&
+            sym->section == fix->section)
+        {
+            long value = (long)sym->offset + fix->addend - (long)fix->offset;
+            for (int b = 0; b < 4; b++)
+                sec->data[fix->offset + b] = (unsigned char)(value >> (b * 8));
+            continue;
+        }
+        add_relocation(sec, fix->offset, fix->symbol, fix->type, fix->addend);
+    }
+}
+
+ObjectCode *assemble(const char *source, FILE *diag)
+{
+    ObjectCode *obj = (ObjectCode *)calloc(1, sizeof(ObjectCode));
+    if (!obj)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    static const char *section_names[SECTION_COUNT] = {".text", ".data", ".rodata"};
+    for (int i = 0; i < SECTION_COUNT; i++)
+    {
+        obj->sections[i].name = section_names[i];
+        obj->sections[i].alignment = 1;
+    }
+
+    Assembler as;
+    as.obj = obj;
+    as.section = SECTION_TEXT;
+    as.line = 0;
+    as.diag = diag;
+    as.failed = 0;
+    as.fixups = NULL;
+    as.num_fixups = 0;
+    as.fixup_capacity = 0;
+    as.symbol_hash = NULL;
+    as.hash_size = 0;
+
+    char *line = NULL;
+    size_t line_capacity = 0;
+    const char *p = source;
+    while (*p && !as.failed)
+    {
+        const char *end = strchr(p, '\n');
+        size_t len = end ? (size_t)(end - p) : strlen(p);
+        if (len + 1 > line_capacity)
+        {
+            line_capacity = len + 1;
+            line = (char *)realloc(line, line_capacity);
+        }
+        memcpy(line, p, len);
+        line[len] = '\0';
+        as.line++;
+        assemble_line(&as, line);
+        p = end ? end + 1 : p + len;
+    }
+    free(line);
+
+    if (!as.failed)
+        resolve_fixups(&as);
+    free(as.fixups);
+    free(as.symbol_hash);
+
+    if (as.failed)
+    {
+        object_code_free(obj);
+        return NULL;
+    }
+    return obj;
+}
+
+void object_code_free(ObjectCode *obj)
+{
+    if (!obj)
+        return;
+    for (int i = 0; i < SECTION_COUNT; i++)
+    {
+        free(obj->sections[i].data);
+        free(obj->sections[i].relocs);
+    }
+    for (int i = 0; i < obj->num_symbols; i++)
+    {
+        free(obj->symbols[i].name);
+    }
+    free(obj->symbols);
+    free(obj);
+}
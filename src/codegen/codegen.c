@@ -1,4 +1,6 @@
 #include "codegen.h"
+#include "opt.h"
+#include "switch_lower.h"
 #include <stdlib.h>
 #include <stdarg.h>
 #include <string.h>
@@ -20,12 +22,28 @@ CodeGenerator *codegen_create(FILE *output, SemanticAnalyzer *analyzer)
     gen->max_stack_size = 0;
     gen->loop_context = NULL;
     gen->return_label = 0;
+    gen->rbx_save_offset = 0;
+    gen->return_type = NULL;
     gen->strings = NULL;
     gen->num_strings = 0;
     gen->string_capacity = 0;
+    gen->data_symbols = NULL;
+    gen->num_data_symbols = 0;
+    gen->data_capacity = 0;
+    gen->num_units = 0;
+    gen->rename_statics = 0;
+    gen->ir_dump = NULL;
+    gen->passes = pass_manager_create(NULL);
+    gen->asm_buffer = peephole_create();
     return gen;
 }
 
+void codegen_set_pass_options(CodeGenerator *gen, const PassOptions *options)
+{
+    pass_manager_destroy(gen->passes);
+    gen->passes = pass_manager_create(options);
+}
+
 // 销毁代码生成器
 void codegen_destroy(CodeGenerator *gen)
 {
@@ -41,6 +59,9 @@ void codegen_destroy(CodeGenerator *gen)
             }
         }
         free(gen->strings);
+        free(gen->data_symbols);
+        pass_manager_destroy(gen->passes);
+        peephole_destroy(gen->asm_buffer);
         free(gen);
     }
 }
@@ -54,6 +75,18 @@ int new_label(CodeGenerator *gen)
 // 添加字符串常量并返回其标签编号
 int add_string_constant(CodeGenerator *gen, const char *str)
 {
+    // 相同内容的字符串共用一个标签
+    size_t str_len = strlen(str);
+    int quoted = str_len >= 2 && str[0] == '"' && str[str_len - 1] == '"';
+    const char *body = quoted ? str + 1 : str;
+    size_t body_len = quoted ? str_len - 2 : str_len;
+    for (int i = 0; i < gen->num_strings; i++)
+    {
+        const char *content = gen->strings[i]->content;
+        if (strlen(content) == body_len && strncmp(content, body, body_len) == 0)
+            return gen->strings[i]->label;
+    }
+
     // 检查是否需要扩展数组
     if (gen->num_strings >= gen->string_capacity)
     {
@@ -121,14 +154,39 @@ void emit_string_constants(CodeGenerator *gen)
     emit(gen, "");
 }
 
-// 输出汇编指令
+// 输出汇编指令（先追加到缓冲区，由 flush_output 统一写出）
 void emit(CodeGenerator *gen, const char *format, ...)
 {
+    char line[256];
     va_list args;
     va_start(args, format);
-    vfprintf(gen->output, format, args);
+    int len = vsnprintf(line, sizeof(line), format, args);
+    va_end(args);
+    if (len < (int)sizeof(line))
+    {
+        peephole_append(gen->asm_buffer, line);
+        return;
+    }
+
+    // 长字符串常量等超过缓冲区的行
+    char *long_line = (char *)malloc(len + 1);
+    if (!long_line)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    va_start(args, format);
+    vsnprintf(long_line, len + 1, format, args);
     va_end(args);
-    fprintf(gen->output, "\n");
+    peephole_append(gen->asm_buffer, long_line);
+    free(long_line);
+}
+
+// 对缓冲的指令运行汇编遍（窥孔优化）后写入输出文件
+static void flush_output(CodeGenerator *gen)
+{
+    pass_manager_run_asm(gen->passes, gen->asm_buffer);
+    peephole_flush(gen->asm_buffer, gen->output);
 }
 
 // 压栈
@@ -149,626 +207,1105 @@ void pop_reg(CodeGenerator *gen, const char *reg)
     gen->current_stack_offset -= 8;
 }
 
-// 生成函数序言
-void gen_prologue(CodeGenerator *gen, const char *func_name)
+// 生成函数序言（frame_size 为参数和局部变量占用的字节数）
+void gen_prologue(CodeGenerator *gen, const char *func_name, int is_static, int frame_size)
 {
     emit(gen, "");
-    emit(gen, "    .globl %s", func_name);
+    if (!is_static)
+        emit(gen, "    .globl %s", func_name);
     emit(gen, "    .type %s, @function", func_name);
     emit(gen, "%s:", func_name);
     emit(gen, "    pushq %%rbp");
     emit(gen, "    movq %%rsp, %%rbp");
-    // 为局部变量预留空间（后面会调整）
-    emit(gen, "    subq $64, %%rsp  # Reserve space for local variables");
+    // 为局部变量和保存 %rbx 的槽预留空间，保持 16 字节对齐。
+    // 栈式代码生成把 %rbx 当作临时寄存器，而它是被调用者保存的（调用者可能把变量分配在 %rbx 中）
+    frame_size = (frame_size + 7) & ~7;
+    gen->rbx_save_offset = -(frame_size + 8);
+    frame_size = (frame_size + 8 + 15) & ~15;
+    emit(gen, "    subq $%d, %%rsp  # Reserve space for local variables", frame_size);
+    emit(gen, "    movq %%rbx, %d(%%rbp)  # Save callee-saved %%rbx", gen->rbx_save_offset);
 }
 
 // 生成函数尾声
 void gen_epilogue(CodeGenerator *gen)
 {
     emit(gen, ".L%d:  # Function return", gen->return_label);
+    emit(gen, "    movq %d(%%rbp), %%rbx", gen->rbx_save_offset);
     emit(gen, "    movq %%rbp, %%rsp");
     emit(gen, "    popq %%rbp");
     emit(gen, "    ret");
 }
 
-// 辅助函数：检查表达式是否为指针类型
-static int is_pointer_expression(ASTNode *node)
+// 变量的内存操作数：全局/静态变量为 label(%rip)，局部变量为 -offset(%rbp)（对象的起始地址）。
+// extern 变量先从 GOT 表项把地址读入 %r11，操作数为 (%r11)，只在下一次调用之前有效
+static const char *variable_operand(CodeGenerator *gen, Symbol *symbol, char *buffer, size_t size)
 {
-    if (!node)
-        return 0;
+    if (symbol->is_extern && symbol->label)
+    {
+        emit(gen, "    movq %s@GOTPCREL(%%rip), %%r11  # Address of extern '%s'", symbol->label, symbol->name);
+        snprintf(buffer, size, "(%%r11)");
+    }
+    else if (symbol->label && (symbol->is_global || symbol->is_static))
+        snprintf(buffer, size, "%s(%%rip)", symbol->label);
+    else
+        snprintf(buffer, size, "%d(%%rbp)", -symbol->offset);
+    return buffer;
+}
 
-    // 如果节点有semantic_info，尝试获取类型
-    // 注意：semantic_info可能是Symbol*或TypeInfo*，需要安全处理
-    if (node->semantic_info && node->type == AST_IDENTIFIER)
+// 表达式的类型（语义分析记录在节点上：标识符记录符号，成员访问记录成员，其余记录类型），未知时返回 NULL
+static TypeInfo *expr_type(ASTNode *node)
+{
+    if (!node || !node->semantic_info)
+        return NULL;
+    switch (node->type)
+    {
+    case AST_IDENTIFIER:
+    case AST_DECLARATOR:
     {
-        // 对于标识符节点，semantic_info是Symbol*
         Symbol *symbol = (Symbol *)node->semantic_info;
-        if (symbol && symbol->type)
-        {
-            return symbol->type->pointer_level > 0;
-        }
+        return symbol->kind == SYMBOL_FUNCTION ? NULL : symbol->type;
     }
-    else if (node->semantic_info)
-    {
-        // 对于其他节点，semantic_info可能是TypeInfo*
-        // 但为了安全，我们不尝试访问它
-        // 只依赖于下面的AST节点类型判断
+    case AST_MEMBER_ACCESS:
+        return ((StructMember *)node->semantic_info)->type;
+    case AST_SIZEOF_EXPR:
+    case AST_INIT_LIST:
+        return NULL;
+    default:
+        return (TypeInfo *)node->semantic_info;
     }
+}
 
-    // 对于一元表达式（取地址），结果是指针
-    if (node->type == AST_UNARY_EXPR && node->value.op_type == OP_ADDR)
-    {
-        return 1;
-    }
+// 数组和结构体没有放得进寄存器的值，作为值使用时得到它们的地址
+static int is_aggregate(TypeInfo *type)
+{
+    return type && (type_is_array(type) || (type->pointer_level == 0 && type->base_type == TYPE_STRUCT));
+}
 
-    // 对于数组下标，结果不是指针（是元素值）
-    // 但 &arr[i] 是指针
+// 指针和数组（退化为首元素的地址）参与地址运算
+static int is_address_type(TypeInfo *type)
+{
+    return type && (type->pointer_level > 0 || type_is_array(type));
+}
 
-    return 0;
+// 指针 ± 整数时整数的缩放倍数：指向的元素的大小
+static int element_size(TypeInfo *type)
+{
+    TypeInfo *element = type_element(type);
+    int size = element ? type_size(element) : 1;
+    free_type(element);
+    return size > 0 ? size : 1;
 }
 
-// 辅助函数：检查表达式是否为浮点类型
-static int is_float_expression(ASTNode *node)
+// 内存中标量的访问宽度；类型未知时按 8 字节
+static int access_size(TypeInfo *type)
 {
-    if (!node)
-        return 0;
+    if (!type || is_aggregate(type))
+        return 8;
+    return type_size(type);
+}
 
-    // 如果节点有semantic_info，尝试获取类型
-    if (node->semantic_info && node->type == AST_IDENTIFIER)
-    {
-        // 对于标识符节点，semantic_info是Symbol*
-        Symbol *symbol = (Symbol *)node->semantic_info;
-        if (symbol && symbol->type)
-        {
-            return (symbol->type->base_type == TYPE_FLOAT ||
-                    symbol->type->base_type == TYPE_DOUBLE);
-        }
-    }
-    else if (node->semantic_info)
+// 通用寄存器按宽度的名字：64、32、16、8 位
+static const char *const sized_registers[][4] = {
+    {"rax", "eax", "ax", "al"},   {"rbx", "ebx", "bx", "bl"},   {"rcx", "ecx", "cx", "cl"},
+    {"rdx", "edx", "dx", "dl"},   {"rsi", "esi", "si", "sil"},  {"rdi", "edi", "di", "dil"},
+    {"r8", "r8d", "r8w", "r8b"},  {"r9", "r9d", "r9w", "r9b"},
+};
+
+static const char *sized_register(const char *reg, int size)
+{
+    int column = size == 4 ? 1 : size == 2 ? 2 : size == 1 ? 3 : 0;
+    for (size_t i = 0; i < sizeof(sized_registers) / sizeof(sized_registers[0]); i++)
     {
-        // 对于表达式节点，semantic_info可能是TypeInfo*
-        TypeInfo *type = (TypeInfo *)node->semantic_info;
-        // 简单启发式：检查base_type是否在有效范围
-        if ((int)type->base_type >= 0 && (int)type->base_type < 20)
-        {
-            return (type->base_type == TYPE_FLOAT ||
-                    type->base_type == TYPE_DOUBLE);
-        }
+        if (strcmp(sized_registers[i][0], reg) == 0)
+            return sized_registers[i][column];
     }
+    return reg;
+}
 
-    // 浮点数字面量
-    if (node->type == AST_FLOAT_LITERAL)
+// 从内存读取标量到 64 位寄存器：不足 8 字节的整数符号扩展（unsigned 零扩展），
+// float 得到 32 位的位模式
+static void gen_load(CodeGenerator *gen, TypeInfo *type, const char *src, const char *reg)
+{
+    int is_unsigned = type_is_unsigned(type) || (type && type->pointer_level == 0 && type->base_type == TYPE_FLOAT);
+    switch (access_size(type))
     {
-        return 1;
+    case 1:
+        emit(gen, "    movsbq %s, %%%s", src, reg);
+        break;
+    case 2:
+        emit(gen, "    movswq %s, %%%s", src, reg);
+        break;
+    case 4:
+        if (is_unsigned)
+            emit(gen, "    movl %s, %%%s", src, sized_register(reg, 4));
+        else
+            emit(gen, "    movslq %s, %%%s", src, reg);
+        break;
+    default:
+        emit(gen, "    movq %s, %%%s", src, reg);
+        break;
     }
-
-    return 0;
 }
 
-// 辅助函数：检查表达式是否为double类型
-static int is_double_expression(ASTNode *node)
+// 把寄存器中的值按类型的宽度写入内存
+static void gen_store(CodeGenerator *gen, TypeInfo *type, const char *reg, const char *dst)
 {
-    if (!node)
-        return 0;
+    int size = access_size(type);
+    const char *suffix = size == 1 ? "b" : size == 2 ? "w" : size == 4 ? "l" : "q";
+    emit(gen, "    mov%s %%%s, %s", suffix, sized_register(reg, size), dst);
+}
 
-    // 如果节点有semantic_info，尝试获取类型
-    if (node->semantic_info && node->type == AST_IDENTIFIER)
+// 结构体赋值：把 %rax 指向的 size 字节复制到 %rbx 指向的位置（借用 %rcx）
+static void gen_copy_object(CodeGenerator *gen, int size)
+{
+    int offset = 0;
+    for (int chunk = 8; chunk >= 1; chunk /= 2)
     {
-        // 对于标识符节点，semantic_info是Symbol*
-        Symbol *symbol = (Symbol *)node->semantic_info;
-        if (symbol && symbol->type)
+        const char *suffix = chunk == 8 ? "q" : chunk == 4 ? "l" : chunk == 2 ? "w" : "b";
+        for (; offset + chunk <= size; offset += chunk)
         {
-            return (symbol->type->base_type == TYPE_DOUBLE);
+            emit(gen, "    mov%s %d(%%rax), %%%s", suffix, offset, sized_register("rcx", chunk));
+            emit(gen, "    mov%s %%%s, %d(%%rbx)", suffix, sized_register("rcx", chunk), offset);
         }
     }
-    else if (node->semantic_info)
+}
+
+// 计算左值的地址，结果在 %rax
+static void gen_address(CodeGenerator *gen, ASTNode *node)
+{
+    switch (node->type)
+    {
+    case AST_IDENTIFIER:
+    case AST_DECLARATOR:
     {
-        // 对于表达式节点，semantic_info可能是TypeInfo*
-        TypeInfo *type = (TypeInfo *)node->semantic_info;
-        // 简单启发式：检查base_type是否在有效范围
-        if ((int)type->base_type >= 0 && (int)type->base_type < 20)
+        Symbol *symbol = (Symbol *)node->semantic_info;
+        char operand[280];
+        if (!symbol)
         {
-            return (type->base_type == TYPE_DOUBLE);
+            emit(gen, "    movq $0, %%rax  # ERROR: Unknown variable");
+            break;
         }
+        emit(gen, "    leaq %s, %%rax  # Address of '%s'", variable_operand(gen, symbol, operand, sizeof(operand)),
+             symbol->name);
+        break;
     }
 
-    return 0;
-}
-
-// 生成表达式代码（结果放在 %rax）
-void gen_expression(CodeGenerator *gen, ASTNode *node)
-{
-    if (!node)
-        return;
-
-    switch (node->type)
+    case AST_ARRAY_SUBSCRIPT:
     {
-    case AST_INT_LITERAL:
-        emit(gen, "    movq $%d, %%rax  # Load integer constant", node->value.int_val);
+        // 元素地址 = 基地址 + index * 元素大小（数组名求值得到首元素的地址，指针求值得到指针的值）
+        TypeInfo *type = expr_type(node);
+        int size = type ? type_size(type) : 8;
+        gen_expression(gen, node->children[1]);
+        push_reg(gen, "rax");
+        gen_expression(gen, node->children[0]);
+        pop_reg(gen, "rcx");
+        if (size != 1)
+            emit(gen, "    imulq $%d, %%rcx  # Scale index by element size", size);
+        emit(gen, "    addq %%rcx, %%rax  # Element address");
         break;
+    }
 
-    case AST_FLOAT_LITERAL:
+    case AST_MEMBER_ACCESS:
     {
-        // 将浮点数转换为IEEE 754位表示
-        float f = node->value.float_val;
-        union
-        {
-            float f;
-            uint32_t i;
-        } converter;
-        converter.f = f;
+        StructMember *member = (StructMember *)node->semantic_info;
+        if (node->value.op_type == OP_ARROW)
+            gen_expression(gen, node->children[0]);
+        else
+            gen_address(gen, node->children[0]);
+        if (member && member->offset)
+            emit(gen, "    addq $%d, %%rax  # Member '%s'", member->offset, member->name);
+        break;
+    }
 
-        // 加载IEEE 754位表示（符号扩展到64位）
-        emit(gen, "    movq $%u, %%rax  # Load float literal %.2f (IEEE 754: 0x%08x)",
-             converter.i, f, converter.i);
+    default:
+        // *p 的地址是 p 的值；其他表达式（例如返回指针的调用）的值就是地址
+        if (node->type == AST_UNARY_EXPR && node->value.op_type == OP_DEREF)
+            node = node->children[0];
+        gen_expression(gen, node);
         break;
     }
+}
 
-    case AST_SIZEOF_EXPR:
-    {
-        // sizeof(type) 或 sizeof(expr)
-        int size = 8; // 默认8字节
+// ========== 浮点运算 ==========
+// float/double 表达式在 SSE 寄存器中求值，结果放在 %xmm0：变量用 movss/movsd 读写，
+// 运算用 addss/addsd 等，只在 C 语义要求的地方做整数和浮点之间的转换（cvtsi2sd、cvttsd2si）。
+// 需要通过 %rax 传递浮点值时（数组元素、结构体成员的存储和表达式的值），%rax 中是它的位模式
 
-        if (node->num_children > 0)
-        {
-            ASTNode *child = node->children[0];
+static void gen_float_expression(CodeGenerator *gen, ASTNode *node);
+static void gen_call(CodeGenerator *gen, ASTNode *node);
 
-            if (child->type == AST_TYPE_SPECIFIER)
-            {
-                // sizeof(type)
-                const char *type_str = child->value.string_val;
-                if (type_str)
-                {
-                    if (strcmp(type_str, "int") == 0 || strcmp(type_str, "float") == 0)
-                        size = 8;
-                    else if (strcmp(type_str, "char") == 0)
-                        size = 1;
-                    else if (strcmp(type_str, "short") == 0)
-                        size = 2;
-                    else if (strcmp(type_str, "long") == 0 || strcmp(type_str, "double") == 0)
-                        size = 8;
-                }
-            }
-        }
+// 类型对应的浮点种类：TYPE_FLOAT 或 TYPE_DOUBLE，其他类型（包括指针和数组）返回 TYPE_INT
+static DataType float_kind(TypeInfo *type)
+{
+    if (!type || type->pointer_level > 0 || type->array_size > 0 || type->array_dimensions > 0)
+        return TYPE_INT;
+    if (type->base_type == TYPE_FLOAT || type->base_type == TYPE_DOUBLE)
+        return type->base_type;
+    return TYPE_INT;
+}
 
-        emit(gen, "    movq $%d, %%rax  # sizeof result", size);
-        break;
-    }
+// 通常算术转换：有 double 时为 double，否则有 float 时为 float
+static DataType common_float_kind(DataType a, DataType b)
+{
+    if (a == TYPE_DOUBLE || b == TYPE_DOUBLE)
+        return TYPE_DOUBLE;
+    if (a == TYPE_FLOAT || b == TYPE_FLOAT)
+        return TYPE_FLOAT;
+    return TYPE_INT;
+}
 
-    case AST_STRING_LITERAL:
+// 表达式的浮点种类（不是浮点表达式时返回 TYPE_INT）
+static DataType expr_float_kind(ASTNode *node)
+{
+    if (!node)
+        return TYPE_INT;
+
+    switch (node->type)
     {
-        // 添加字符串常量并获取标签
-        int label = add_string_constant(gen, node->value.string_val);
-        // 加载字符串地址到rax
-        emit(gen, "    leaq .LC%d(%%rip), %%rax  # Load string address", label);
-        break;
-    }
+    case AST_FLOAT_LITERAL:
+        return node->value.float_val.is_float ? TYPE_FLOAT : TYPE_DOUBLE;
 
     case AST_IDENTIFIER:
+    case AST_DECLARATOR:
     {
-        // 使用存储的符号信息
-        const char *name = node->value.string_val;
         Symbol *symbol = (Symbol *)node->semantic_info;
-        if (symbol)
-        {
-            // 检查是否是枚举常量（declaration节点类型为AST_ENUM_CONST）
-            if (symbol->declaration && symbol->declaration->type == AST_ENUM_CONST)
-            {
-                // 枚举常量：直接使用其整数值
-                int enum_value = symbol->declaration->value.int_val;
-                emit(gen, "    movq $%d, %%rax  # Enum constant '%s'", enum_value, name);
-            }
-            else if (symbol->is_global || symbol->is_static)
-            {
-                // 全局/静态变量：使用标签访问
-                emit(gen, "    movq %s(%%rip), %%rax  # Load global/static '%s'",
-                     symbol->label, name);
-            }
-            else
-            {
-                // 局部变量：使用栈偏移访问
-                int offset = -(symbol->offset + 8); // 相对于 rbp 的偏移
-                emit(gen, "    movq %d(%%rbp), %%rax  # Load variable '%s'", offset, name);
-            }
-        }
-        else
-        {
-            emit(gen, "    movq $0, %%rax  # ERROR: Unknown variable '%s'", name);
-        }
-        break;
+        if (!symbol || symbol->kind == SYMBOL_FUNCTION)
+            return TYPE_INT;
+        return float_kind(symbol->type);
     }
 
-    case AST_BINARY_EXPR:
+    case AST_ARRAY_SUBSCRIPT:
+    case AST_CAST_EXPR:
+    case AST_MEMBER_ACCESS:
+        return float_kind(expr_type(node));
+
+    case AST_CALL_EXPR:
     {
-        if (node->num_children < 2)
-            break;
+        Symbol *symbol = node->num_children > 0 ? (Symbol *)node->children[0]->semantic_info : NULL;
+        if (!symbol || symbol->kind != SYMBOL_FUNCTION || !symbol->type)
+            return TYPE_INT;
+        return float_kind(symbol->type->return_type);
+    }
 
-        // 先计算右操作数
-        gen_expression(gen, node->children[1]);
-        push_reg(gen, "rax"); // 保存右操作数
+    case AST_ASSIGN_EXPR:
+        return node->num_children > 0 ? expr_float_kind(node->children[0]) : TYPE_INT;
 
-        // 计算左操作数
-        gen_expression(gen, node->children[0]);
+    case AST_TERNARY_EXPR:
+        if (node->num_children < 3)
+            return TYPE_INT;
+        return common_float_kind(expr_float_kind(node->children[1]), expr_float_kind(node->children[2]));
 
-        // 恢复右操作数到 rbx
-        pop_reg(gen, "rbx");
+    case AST_UNARY_EXPR:
+        if (node->num_children < 1)
+            return TYPE_INT;
+        switch (node->value.op_type)
+        {
+        case OP_NEG:
+        case OP_PREINC:
+        case OP_PREDEC:
+        case OP_POSTINC:
+        case OP_POSTDEC:
+            return expr_float_kind(node->children[0]);
+        case OP_DEREF:
+            return float_kind(expr_type(node));
+        default:
+            return TYPE_INT;
+        }
 
-        // 执行操作（结果在 rax）
+    case AST_BINARY_EXPR:
+        if (node->num_children < 2)
+            return TYPE_INT;
         switch (node->value.op_type)
         {
+        case OP_ADD:
+        case OP_SUB:
+        case OP_MUL:
+        case OP_DIV:
+            if (is_address_type(expr_type(node->children[0])) || is_address_type(expr_type(node->children[1])))
+                return TYPE_INT;
+            return common_float_kind(expr_float_kind(node->children[0]), expr_float_kind(node->children[1]));
         case OP_COMMA:
-            // 逗号运算符：左侧已求值并丢弃，右侧结果已在rax中
-            // rbx中是右侧的值，直接使用
-            emit(gen, "    movq %%rbx, %%rax  # Comma operator: use right side");
-            break;
+            return expr_float_kind(node->children[1]);
+        default:
+            return TYPE_INT;
+        }
 
-        case OP_ADD:
-        {
-            // 检查是否是指针算术
-            int left_is_ptr = is_pointer_expression(node->children[0]);
-            int right_is_ptr = is_pointer_expression(node->children[1]);
+    default:
+        return TYPE_INT;
+    }
+}
 
-            // 检查是否是浮点运算
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
+static const char *sse_suffix(DataType kind)
+{
+    return kind == TYPE_FLOAT ? "ss" : "sd";
+}
 
-            if (left_is_ptr && !right_is_ptr)
-            {
-                // 指针 + 整数：缩放整数并减去（栈向下增长）
-                emit(gen, "    imulq $8, %%rbx  # Scale integer for pointer arithmetic");
-                emit(gen, "    subq %%rbx, %%rax  # Add (pointer + integer, stack grows down)");
-            }
-            else if (!left_is_ptr && right_is_ptr)
-            {
-                // 整数 + 指针：缩放整数并减去
-                emit(gen, "    imulq $8, %%rax  # Scale integer for pointer arithmetic");
-                emit(gen, "    subq %%rax, %%rbx  # Add (integer + pointer, stack grows down)");
-                emit(gen, "    movq %%rbx, %%rax  # Result in rax");
-            }
-            else if (left_is_float || right_is_float)
-            {
-                int left_is_double = is_double_expression(node->children[0]);
-                int right_is_double = is_double_expression(node->children[1]);
+static const char *float_kind_name(DataType kind)
+{
+    return kind == TYPE_FLOAT ? "float" : "double";
+}
 
-                if (left_is_double || right_is_double)
-                {
-                    // Double加法
-                    emit(gen, "    cvtsi2sd %%rax, %%xmm0  # Convert left int to double");
-                    emit(gen, "    cvtsi2sd %%rbx, %%xmm1  # Convert right int to double");
-                    emit(gen, "    addsd %%xmm1, %%xmm0  # Double add");
-                    emit(gen, "    cvttsd2si %%xmm0, %%rax  # Convert result to int");
-                }
-                else
-                {
-                    // Float加法
-                    emit(gen, "    cvtsi2ss %%rax, %%xmm0  # Convert left int to float");
-                    emit(gen, "    cvtsi2ss %%rbx, %%xmm1  # Convert right int to float");
-                    emit(gen, "    addss %%xmm1, %%xmm0  # Float add");
-                    emit(gen, "    cvttss2si %%xmm0, %%rax  # Convert result to int");
-                }
-            }
-            else
-            {
-                // 普通整数加法
-                emit(gen, "    addq %%rbx, %%rax  # Integer add");
-            }
-            break;
-        }
-        case OP_SUB:
-        {
-            // 检查是否是指针算术
-            int left_is_ptr = is_pointer_expression(node->children[0]);
-            int right_is_ptr = is_pointer_expression(node->children[1]);
+// 把 %xmm0 保存到栈上 / 从栈上取回到 %xmm1（和 push_reg/pop_reg 一样记录栈偏移）
+static void push_xmm0(CodeGenerator *gen, DataType kind)
+{
+    emit(gen, "    subq $8, %%rsp");
+    emit(gen, "    mov%s %%xmm0, (%%rsp)  # Save %s operand", sse_suffix(kind), float_kind_name(kind));
+    gen->current_stack_offset += 8;
+    if (gen->current_stack_offset > gen->max_stack_size)
+    {
+        gen->max_stack_size = gen->current_stack_offset;
+    }
+}
 
-            // 检查是否是浮点运算
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
+static void pop_xmm1(CodeGenerator *gen, DataType kind)
+{
+    emit(gen, "    mov%s (%%rsp), %%xmm1  # Restore %s operand", sse_suffix(kind), float_kind_name(kind));
+    emit(gen, "    addq $8, %%rsp");
+    gen->current_stack_offset -= 8;
+}
 
-            if (left_is_ptr && !right_is_ptr)
-            {
-                // 指针 - 整数：缩放整数并加上（栈向下增长，减去整数意味着向高地址）
-                emit(gen, "    imulq $8, %%rbx  # Scale integer for pointer arithmetic");
-                emit(gen, "    addq %%rbx, %%rax  # Subtract (pointer - integer, stack grows down)");
-            }
-            else if (left_is_ptr && right_is_ptr)
-            {
-                // 指针 - 指针：结果是元素个数（需要除以8）
-                emit(gen, "    subq %%rbx, %%rax  # Subtract (pointer - pointer)");
-                emit(gen, "    movq $8, %%rbx");
-                emit(gen, "    cqto  # Sign extend");
-                emit(gen, "    idivq %%rbx  # Divide by element size");
-            }
-            else if (left_is_float || right_is_float)
-            {
-                int left_is_double = is_double_expression(node->children[0]);
-                int right_is_double = is_double_expression(node->children[1]);
+// 值的转换：TYPE_INT 的值在 %rax 中，浮点值在 %xmm0 中
+static void gen_float_convert(CodeGenerator *gen, DataType from, DataType to)
+{
+    if (from == to)
+        return;
+    if (from == TYPE_INT)
+        emit(gen, "    cvtsi2%sq %%rax, %%xmm0  # Convert integer to %s", sse_suffix(to), float_kind_name(to));
+    else if (to == TYPE_INT)
+        emit(gen, "    cvtt%s2si %%xmm0, %%rax  # Truncate %s to integer", sse_suffix(from), float_kind_name(from));
+    else if (to == TYPE_DOUBLE)
+        emit(gen, "    cvtss2sd %%xmm0, %%xmm0  # Widen float to double");
+    else
+        emit(gen, "    cvtsd2ss %%xmm0, %%xmm0  # Narrow double to float");
+}
 
-                if (left_is_double || right_is_double)
-                {
-                    // Double减法
-                    emit(gen, "    cvtsi2sd %%rax, %%xmm0  # Convert left int to double");
-                    emit(gen, "    cvtsi2sd %%rbx, %%xmm1  # Convert right int to double");
-                    emit(gen, "    subsd %%xmm1, %%xmm0  # Double subtract");
-                    emit(gen, "    cvttsd2si %%xmm0, %%rax  # Convert result to int");
-                }
-                else
-                {
-                    // Float减法
-                    emit(gen, "    cvtsi2ss %%rax, %%xmm0  # Convert left int to float");
-                    emit(gen, "    cvtsi2ss %%rbx, %%xmm1  # Convert right int to float");
-                    emit(gen, "    subss %%xmm1, %%xmm0  # Float subtract");
-                    emit(gen, "    cvttss2si %%xmm0, %%rax  # Convert result to int");
-                }
-            }
-            else
-            {
-                // 普通整数减法
-                emit(gen, "    subq %%rbx, %%rax  # Integer subtract");
-            }
-            break;
-        }
-        case OP_MUL:
-        {
-            // 检查是否为浮点类型
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
+// %xmm0 中的值 ↔ %rax 中的位模式
+static void gen_float_to_bits(CodeGenerator *gen, DataType kind)
+{
+    if (kind == TYPE_FLOAT)
+        emit(gen, "    movd %%xmm0, %%eax  # Float bits");
+    else
+        emit(gen, "    movq %%xmm0, %%rax  # Double bits");
+}
 
-            if (left_is_float || right_is_float)
-            {
-                int left_is_double = is_double_expression(node->children[0]);
-                int right_is_double = is_double_expression(node->children[1]);
+static void gen_bits_to_float(CodeGenerator *gen, DataType kind)
+{
+    if (kind == TYPE_FLOAT)
+        emit(gen, "    movd %%eax, %%xmm0");
+    else
+        emit(gen, "    movq %%rax, %%xmm0");
+}
 
-                if (left_is_double || right_is_double)
-                {
-                    // Double乘法
-                    emit(gen, "    cvtsi2sd %%rax, %%xmm0  # Convert left int to double");
-                    emit(gen, "    cvtsi2sd %%rbx, %%xmm1  # Convert right int to double");
-                    emit(gen, "    mulsd %%xmm1, %%xmm0  # Double multiply");
-                    emit(gen, "    cvttsd2si %%xmm0, %%rax  # Convert result to int");
-                }
-                else
-                {
-                    // Float乘法
-                    emit(gen, "    cvtsi2ss %%rax, %%xmm0  # Convert left int to float");
-                    emit(gen, "    cvtsi2ss %%rbx, %%xmm1  # Convert right int to float");
-                    emit(gen, "    mulss %%xmm1, %%xmm0  # Float multiply");
-                    emit(gen, "    cvttss2si %%xmm0, %%rax  # Convert result to int");
-                }
-            }
-            else
-            {
-                // 整数乘法
-                emit(gen, "    imulq %%rbx, %%rax  # Integer multiply");
-            }
-            break;
+// 计算表达式并转换为 kind（TYPE_FLOAT/TYPE_DOUBLE），结果在 %xmm0
+static void gen_float_value(CodeGenerator *gen, ASTNode *node, DataType kind)
+{
+    DataType from = expr_float_kind(node);
+    if (from == TYPE_INT)
+        gen_expression(gen, node);
+    else
+        gen_float_expression(gen, node);
+    gen_float_convert(gen, from, kind);
+}
+
+// 计算表达式并转换为 kind，结果在 %rax：整数值，或者浮点值的位模式（赋值、传参时使用）
+static void gen_value_as(CodeGenerator *gen, ASTNode *node, DataType kind)
+{
+    DataType from = expr_float_kind(node);
+    if (kind != TYPE_INT)
+    {
+        gen_float_value(gen, node, kind);
+        gen_float_to_bits(gen, kind);
+    }
+    else if (from != TYPE_INT)
+    {
+        gen_float_expression(gen, node);
+        gen_float_convert(gen, from, TYPE_INT);
+    }
+    else
+    {
+        gen_expression(gen, node);
+    }
+}
+
+// 条件表达式：浮点值和 0 比较（NaN 为真），结果 0/1 放在 %rax；整数表达式直接求值
+static void gen_condition(CodeGenerator *gen, ASTNode *node)
+{
+    DataType kind = expr_float_kind(node);
+    if (kind == TYPE_INT)
+    {
+        gen_expression(gen, node);
+        return;
+    }
+    gen_float_expression(gen, node);
+    emit(gen, "    xorps %%xmm1, %%xmm1");
+    emit(gen, "    ucomi%s %%xmm1, %%xmm0  # Compare %s with zero", sse_suffix(kind), float_kind_name(kind));
+    emit(gen, "    setne %%al");
+    emit(gen, "    setp %%cl");
+    emit(gen, "    orb %%cl, %%al");
+    emit(gen, "    movzbq %%al, %%rax");
+}
+
+// 浮点比较，结果 0/1 放在 %rax。
+// 操作数无序（有 NaN）时 ucomis 把 ZF、PF、CF 都置 1：< 和 <= 交换操作数后用 seta/setae，
+// 使无序时结果为假；== 还要求 PF=0，!= 在 PF=1 时为真
+static void gen_float_compare(CodeGenerator *gen, ASTNode *node, DataType kind)
+{
+    const char *sfx = sse_suffix(kind);
+    gen_float_value(gen, node->children[1], kind);
+    push_xmm0(gen, kind);
+    gen_float_value(gen, node->children[0], kind);
+    pop_xmm1(gen, kind);
+
+    switch (node->value.op_type)
+    {
+    case OP_LT:
+        emit(gen, "    ucomi%s %%xmm0, %%xmm1  # %s compare <", sfx, float_kind_name(kind));
+        emit(gen, "    seta %%al");
+        break;
+    case OP_LE:
+        emit(gen, "    ucomi%s %%xmm0, %%xmm1  # %s compare <=", sfx, float_kind_name(kind));
+        emit(gen, "    setae %%al");
+        break;
+    case OP_GT:
+        emit(gen, "    ucomi%s %%xmm1, %%xmm0  # %s compare >", sfx, float_kind_name(kind));
+        emit(gen, "    seta %%al");
+        break;
+    case OP_GE:
+        emit(gen, "    ucomi%s %%xmm1, %%xmm0  # %s compare >=", sfx, float_kind_name(kind));
+        emit(gen, "    setae %%al");
+        break;
+    case OP_EQ:
+        emit(gen, "    ucomi%s %%xmm1, %%xmm0  # %s compare ==", sfx, float_kind_name(kind));
+        emit(gen, "    sete %%al");
+        emit(gen, "    setnp %%cl");
+        emit(gen, "    andb %%cl, %%al");
+        break;
+    default:
+        emit(gen, "    ucomi%s %%xmm1, %%xmm0  # %s compare !=", sfx, float_kind_name(kind));
+        emit(gen, "    setne %%al");
+        emit(gen, "    setp %%cl");
+        emit(gen, "    orb %%cl, %%al");
+        break;
+    }
+    emit(gen, "    movzbq %%al, %%rax");
+}
+
+// 浮点常量（位模式经 %eax/%rax 装入 %xmm0）
+static void gen_float_constant(CodeGenerator *gen, double value, DataType kind)
+{
+    if (kind == TYPE_FLOAT)
+    {
+        union
+        {
+            float f;
+            uint32_t bits;
+        } converter;
+        converter.f = (float)value;
+        if (converter.bits == 0)
+        {
+            emit(gen, "    xorps %%xmm0, %%xmm0  # Load float constant 0");
+            return;
         }
-        case OP_DIV:
+        emit(gen, "    movl $%u, %%eax  # Load float constant %g", converter.bits, converter.f);
+        emit(gen, "    movd %%eax, %%xmm0");
+    }
+    else
+    {
+        union
         {
-            // 检查是否为浮点类型
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
+            double d;
+            int64_t bits;
+        } converter;
+        converter.d = value;
+        if (converter.bits == 0)
+        {
+            emit(gen, "    xorps %%xmm0, %%xmm0  # Load double constant 0");
+            return;
+        }
+        emit(gen, "    movabsq $%lld, %%rax  # Load double constant %g", (long long)converter.bits, value);
+        emit(gen, "    movq %%rax, %%xmm0");
+    }
+}
 
-            if (left_is_float || right_is_float)
-            {
-                int left_is_double = is_double_expression(node->children[0]);
-                int right_is_double = is_double_expression(node->children[1]);
+// 浮点 ++/--：变量直接在 %xmm0 中加减 1 后写回；其他左值改写为 x = x ± 1
+static void gen_float_increment(CodeGenerator *gen, ASTNode *node, DataType kind)
+{
+    ASTNode *operand = node->children[0];
+    OperatorType op = node->value.op_type;
+    int is_post = op == OP_POSTINC || op == OP_POSTDEC;
+    const char *arith = (op == OP_PREINC || op == OP_POSTINC) ? "add" : "sub";
+    const char *sfx = sse_suffix(kind);
 
-                if (left_is_double || right_is_double)
-                {
-                    // Double除法
-                    emit(gen, "    cvtsi2sd %%rax, %%xmm0  # Convert dividend int to double");
-                    emit(gen, "    cvtsi2sd %%rbx, %%xmm1  # Convert divisor int to double");
-                    emit(gen, "    divsd %%xmm1, %%xmm0  # Double divide");
-                    emit(gen, "    cvttsd2si %%xmm0, %%rax  # Convert result to int");
-                }
-                else
-                {
-                    // Float除法
-                    emit(gen, "    cvtsi2ss %%rax, %%xmm0  # Convert dividend int to float");
-                    emit(gen, "    cvtsi2ss %%rbx, %%xmm1  # Convert divisor int to float");
-                    emit(gen, "    divss %%xmm1, %%xmm0  # Float divide");
-                    emit(gen, "    cvttss2si %%xmm0, %%rax  # Convert result to int");
-                }
-            }
-            else
-            {
-                // 整数除法
-                emit(gen, "    cqto  # Sign extend");
-                emit(gen, "    idivq %%rbx  # Integer divide");
-            }
+    if (operand->type == AST_IDENTIFIER)
+    {
+        char location[280];
+        variable_operand(gen, (Symbol *)operand->semantic_info, location, sizeof(location));
+        emit(gen, "    mov%s %s, %%xmm0  # Load '%s'", sfx, location, operand->value.string_val);
+        emit(gen, "    movq $1, %%rax");
+        emit(gen, "    cvtsi2%sq %%rax, %%xmm1", sfx);
+        if (is_post)
+            emit(gen, "    movaps %%xmm0, %%xmm2  # Save old value");
+        emit(gen, "    %s%s %%xmm1, %%xmm0", arith, sfx);
+        emit(gen, "    mov%s %%xmm0, %s  # Store back", sfx, location);
+        if (is_post)
+            emit(gen, "    movaps %%xmm2, %%xmm0  # Result is old value");
+        return;
+    }
+
+    ASTNode one;
+    ASTNode binary;
+    ASTNode assign;
+    ASTNode *binary_children[2] = {operand, &one};
+    ASTNode *assign_children[2] = {operand, &binary};
+    memset(&one, 0, sizeof(one));
+    memset(&binary, 0, sizeof(binary));
+    memset(&assign, 0, sizeof(assign));
+    one.type = AST_INT_LITERAL;
+    one.value.int_val = 1;
+    binary.type = AST_BINARY_EXPR;
+    binary.value.op_type = arith[0] == 'a' ? OP_ADD : OP_SUB;
+    binary.children = binary_children;
+    binary.num_children = 2;
+    assign.type = AST_ASSIGN_EXPR;
+    assign.value.op_type = OP_ASSIGN;
+    assign.children = assign_children;
+    assign.num_children = 2;
+    gen_float_expression(gen, &assign);
+    if (is_post)
+    {
+        // 新值减回 1 得到旧值
+        emit(gen, "    movq $1, %%rax");
+        emit(gen, "    cvtsi2%sq %%rax, %%xmm1", sfx);
+        emit(gen, "    %s%s %%xmm1, %%xmm0", arith[0] == 'a' ? "sub" : "add", sfx);
+    }
+}
+
+// 生成浮点表达式的代码，结果（种类为 expr_float_kind(node)）放在 %xmm0
+static void gen_float_expression(CodeGenerator *gen, ASTNode *node)
+{
+    DataType kind = expr_float_kind(node);
+    const char *sfx = sse_suffix(kind);
+
+    switch (node->type)
+    {
+    case AST_FLOAT_LITERAL:
+        gen_float_constant(gen, node->value.float_val.value, kind);
+        break;
+
+    case AST_IDENTIFIER:
+    {
+        Symbol *symbol = (Symbol *)node->semantic_info;
+        char location[280];
+        emit(gen, "    mov%s %s, %%xmm0  # Load %s '%s'", sfx, variable_operand(gen, symbol, location, sizeof(location)),
+             float_kind_name(kind), symbol->name);
+        break;
+    }
+
+    case AST_CALL_EXPR:
+        gen_call(gen, node);
+        break;
+
+    case AST_CAST_EXPR:
+        gen_float_value(gen, node->children[1], kind);
+        break;
+
+    case AST_BINARY_EXPR:
+    {
+        if (node->value.op_type == OP_COMMA)
+        {
+            gen_expression(gen, node->children[0]);
+            gen_float_expression(gen, node->children[1]);
             break;
         }
-        case OP_MOD:
-            emit(gen, "    cqto  # Sign extend");
-            emit(gen, "    idivq %%rbx  # Modulo");
-            emit(gen, "    movq %%rdx, %%rax  # Result in rax");
+
+        const char *arith = "add";
+        switch (node->value.op_type)
+        {
+        case OP_SUB:
+            arith = "sub";
             break;
-        case OP_LT:
+        case OP_MUL:
+            arith = "mul";
+            break;
+        case OP_DIV:
+            arith = "div";
+            break;
+        default:
+            break;
+        }
+
+        // 同种类的浮点变量直接作为内存操作数，不必先求值到寄存器
+        ASTNode *right = node->children[1];
+        if (right->type == AST_IDENTIFIER && expr_float_kind(right) == kind)
         {
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
-            int left_is_double = is_double_expression(node->children[0]);
-            int right_is_double = is_double_expression(node->children[1]);
+            char location[280];
+            gen_float_value(gen, node->children[0], kind);
+            emit(gen, "    %s%s %s, %%xmm0  # %s %s", arith, sfx,
+                 variable_operand(gen, (Symbol *)right->semantic_info, location, sizeof(location)), float_kind_name(kind),
+                 arith);
+            break;
+        }
 
-            if (left_is_double || right_is_double)
-            {
-                emit(gen, "    movq %%rax, %%xmm0  # Load left to xmm0");
-                emit(gen, "    movq %%rbx, %%xmm1  # Load right to xmm1");
-                emit(gen, "    ucomisd %%xmm1, %%xmm0  # Double compare");
-                emit(gen, "    setb %%al  # Set if below");
-                emit(gen, "    movzbq %%al, %%rax");
-            }
-            else if (left_is_float || right_is_float)
+        gen_float_value(gen, right, kind);
+        push_xmm0(gen, kind);
+        gen_float_value(gen, node->children[0], kind);
+        pop_xmm1(gen, kind);
+        emit(gen, "    %s%s %%xmm1, %%xmm0  # %s %s", arith, sfx, float_kind_name(kind), arith);
+        break;
+    }
+
+    case AST_UNARY_EXPR:
+        if (node->value.op_type == OP_NEG)
+        {
+            // 取负：翻转符号位（0.0 取负得到 -0.0）
+            gen_float_expression(gen, node->children[0]);
+            if (kind == TYPE_FLOAT)
             {
-                emit(gen, "    cvtsi2ss %%rax, %%xmm0  # Convert left to float");
-                emit(gen, "    cvtsi2ss %%rbx, %%xmm1  # Convert right to float");
-                emit(gen, "    ucomiss %%xmm1, %%xmm0  # Float compare");
-                emit(gen, "    setb %%al  # Set if below");
-                emit(gen, "    movzbq %%al, %%rax");
+                emit(gen, "    movl $-2147483648, %%ecx  # Float sign bit");
+                emit(gen, "    movd %%ecx, %%xmm1");
+                emit(gen, "    xorps %%xmm1, %%xmm0  # Negate");
             }
             else
             {
-                emit(gen, "    cmpq %%rbx, %%rax  # Integer compare <");
-                emit(gen, "    setl %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                emit(gen, "    movabsq $-9223372036854775808, %%rcx  # Double sign bit");
+                emit(gen, "    movq %%rcx, %%xmm1");
+                emit(gen, "    xorpd %%xmm1, %%xmm0  # Negate");
             }
-            break;
         }
-        case OP_GT:
+        else if (node->value.op_type == OP_DEREF)
         {
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
-            int left_is_double = is_double_expression(node->children[0]);
-            int right_is_double = is_double_expression(node->children[1]);
+            gen_expression(gen, node);
+            gen_bits_to_float(gen, kind);
+        }
+        else
+        {
+            gen_float_increment(gen, node, kind);
+        }
+        break;
 
-            if (left_is_double || right_is_double)
-            {
-                emit(gen, "    movq %%rax, %%xmm0");
-                emit(gen, "    movq %%rbx, %%xmm1");
-                emit(gen, "    ucomisd %%xmm1, %%xmm0");
-                emit(gen, "    seta %%al");
-                emit(gen, "    movzbq %%al, %%rax");
-            }
-            else if (left_is_float || right_is_float)
-            {
-                emit(gen, "    cvtsi2ss %%rax, %%xmm0");
-                emit(gen, "    cvtsi2ss %%rbx, %%xmm1");
-                emit(gen, "    ucomiss %%xmm1, %%xmm0");
-                emit(gen, "    seta %%al");
-                emit(gen, "    movzbq %%al, %%rax");
-            }
-            else
-            {
-                emit(gen, "    cmpq %%rbx, %%rax");
-                emit(gen, "    setg %%al");
-                emit(gen, "    movzbq %%al, %%rax");
-            }
+    case AST_TERNARY_EXPR:
+    {
+        int false_label = new_label(gen);
+        int end_label = new_label(gen);
+        gen_condition(gen, node->children[0]);
+        emit(gen, "    testq %%rax, %%rax  # Test condition");
+        emit(gen, "    je .L%d  # Jump if false", false_label);
+        gen_float_value(gen, node->children[1], kind);
+        emit(gen, "    jmp .L%d  # Skip false branch", end_label);
+        emit(gen, ".L%d:  # False branch", false_label);
+        gen_float_value(gen, node->children[2], kind);
+        emit(gen, ".L%d:  # End ternary", end_label);
+        break;
+    }
+
+    case AST_ASSIGN_EXPR:
+    {
+        ASTNode *lhs = node->children[0];
+        if (node->value.op_type == OP_ASSIGN && (lhs->type == AST_IDENTIFIER || lhs->type == AST_DECLARATOR))
+        {
+            Symbol *symbol = (Symbol *)lhs->semantic_info;
+            char location[280];
+            gen_float_value(gen, node->children[1], kind);
+            emit(gen, "    mov%s %%xmm0, %s  # Store %s '%s'", sfx, variable_operand(gen, symbol, location, sizeof(location)),
+                 float_kind_name(kind), symbol->name);
             break;
         }
-        case OP_LE:
+        // 复合赋值和其他左值：%rax 中是存入的位模式
+        gen_expression(gen, node);
+        gen_bits_to_float(gen, kind);
+        break;
+    }
+
+    default:
+        // 数组元素、结构体成员：按位模式加载到 %rax 后移入 %xmm0
+        gen_expression(gen, node);
+        gen_bits_to_float(gen, kind);
+        break;
+    }
+}
+
+// 参数按形参类型传递；没有原型对应的参数（可变参数部分）中 float 提升为 double
+static DataType arg_kind(TypeInfo *func_type, ASTNode *arg, int index)
+{
+    if (func_type && index < func_type->num_params)
+        return float_kind(func_type->param_types[index]);
+    DataType kind = expr_float_kind(arg);
+    return kind == TYPE_FLOAT ? TYPE_DOUBLE : kind;
+}
+
+// 参数在所属类别（整数 / 浮点）的寄存器中的编号，放不下时返回 -1（通过栈传递）
+static int arg_register(TypeInfo *func_type, ASTNode **args, int index)
+{
+    int is_float = arg_kind(func_type, args[index], index) != TYPE_INT;
+    int position = 0;
+    for (int i = 0; i < index; i++)
+    {
+        if ((arg_kind(func_type, args[i], i) != TYPE_INT) == is_float)
+            position++;
+    }
+    return position < (is_float ? 8 : 6) ? position : -1;
+}
+
+// 函数调用（System V AMD64 ABI）：整数参数依次放入 rdi、rsi、rdx、rcx、r8、r9，
+// 浮点参数放入 xmm0～xmm7，放不下的从右到左压栈；调用可变参数函数时 %al 为使用的向量寄存器数。
+// 返回值在 %rax 或 %xmm0 中
+static void gen_call(CodeGenerator *gen, ASTNode *node)
+{
+    static const char *const param_regs[] = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
+
+    if (node->num_children < 1)
+        return;
+
+    // 获取函数名
+    ASTNode *func_node = node->children[0];
+    if (func_node->type != AST_IDENTIFIER)
+        return;
+
+    const char *func_name = func_node->value.string_val;
+    Symbol *func_symbol = (Symbol *)func_node->semantic_info;
+    if (func_symbol && func_symbol->is_static && func_symbol->label)
+        func_name = func_symbol->label;
+    TypeInfo *func_type = func_symbol && func_symbol->kind == SYMBOL_FUNCTION ? func_symbol->type : NULL;
+
+    ASTNode **args = NULL;
+    int num_args = 0;
+    if (node->num_children > 1 && node->children[1]->type == AST_ARG_LIST)
+    {
+        args = node->children[1]->children;
+        num_args = node->children[1]->num_children;
+    }
+
+    int num_stack_args = 0;
+    int num_float_regs = 0;
+    for (int i = 0; i < num_args; i++)
+    {
+        if (arg_register(func_type, args, i) < 0)
+            num_stack_args++;
+        else if (arg_kind(func_type, args[i], i) != TYPE_INT)
+            num_float_regs++;
+    }
+
+    // call 时 %rsp 必须 16 字节对齐（函数体内 %rbp 是对齐的，current_stack_offset 记录之后压栈的字节数）
+    int padding = (gen->current_stack_offset + num_stack_args * 8) % 16 ? 8 : 0;
+    if (padding)
+    {
+        emit(gen, "    subq $8, %%rsp  # Align stack for call");
+        gen->current_stack_offset += 8;
+    }
+
+    // 栈参数从右到左压栈
+    for (int i = num_args - 1; i >= 0; i--)
+    {
+        if (arg_register(func_type, args, i) >= 0)
+            continue;
+        gen_value_as(gen, args[i], arg_kind(func_type, args[i], i));
+        push_reg(gen, "rax");
+    }
+
+    // 寄存器参数先全部求值压栈（求值时可能调用其他函数），再依次弹出到参数寄存器
+    for (int i = num_args - 1; i >= 0; i--)
+    {
+        if (arg_register(func_type, args, i) < 0)
+            continue;
+        gen_value_as(gen, args[i], arg_kind(func_type, args[i], i));
+        push_reg(gen, "rax");
+    }
+    for (int i = 0; i < num_args; i++)
+    {
+        int reg = arg_register(func_type, args, i);
+        if (reg < 0)
+            continue;
+        if (arg_kind(func_type, args[i], i) == TYPE_INT)
+        {
+            pop_reg(gen, param_regs[reg]);
+        }
+        else
         {
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
-            int left_is_double = is_double_expression(node->children[0]);
-            int right_is_double = is_double_expression(node->children[1]);
+            pop_reg(gen, "rax");
+            emit(gen, "    movq %%rax, %%xmm%d  # Floating-point argument %d", reg, i + 1);
+        }
+    }
+
+    if (!func_type || func_type->is_variadic)
+        emit(gen, "    movl $%d, %%eax  # Number of vector registers used", num_float_regs);
+    emit(gen, "    call %s", func_name);
+    // 不足 8 字节的整数返回值高位没有定义，按返回类型扩展
+    TypeInfo *return_type = func_type ? func_type->return_type : NULL;
+    if (return_type && return_type->base_type != TYPE_VOID && float_kind(return_type) == TYPE_INT &&
+        access_size(return_type) < 8)
+    {
+        char source[8];
+        snprintf(source, sizeof(source), "%%%s", sized_register("rax", access_size(return_type)));
+        gen_load(gen, return_type, source, "rax");
+    }
+
+    int cleanup = num_stack_args * 8 + padding;
+    if (cleanup)
+    {
+        emit(gen, "    addq $%d, %%rsp  # Pop stack arguments", cleanup);
+        gen->current_stack_offset -= cleanup;
+    }
+}
+
+// 复合赋值的运算：%rbx 中是左侧的旧值，%rax 中是右侧的值，结果放在 %rax。
+// 指针的 += 和 -= 按指向的元素大小缩放
+static void gen_compound_op(CodeGenerator *gen, OperatorType op, TypeInfo *lhs_type)
+{
+    if (is_address_type(lhs_type) && (op == OP_ADD_ASSIGN || op == OP_SUB_ASSIGN))
+        emit(gen, "    imulq $%d, %%rax  # Scale integer for pointer arithmetic", element_size(lhs_type));
+    switch (op)
+    {
+    case OP_ADD_ASSIGN:
+        emit(gen, "    addq %%rax, %%rbx  # +=");
+        break;
+    case OP_SUB_ASSIGN:
+        emit(gen, "    subq %%rax, %%rbx  # -=");
+        break;
+    case OP_MUL_ASSIGN:
+        emit(gen, "    imulq %%rax, %%rbx  # *=");
+        break;
+    case OP_DIV_ASSIGN:
+        emit(gen, "    movq %%rax, %%rcx  # Move divisor to rcx");
+        emit(gen, "    movq %%rbx, %%rax  # Move dividend to rax");
+        emit(gen, "    cqto  # Sign extend");
+        emit(gen, "    idivq %%rcx  # Divide rax by rcx");
+        emit(gen, "    movq %%rax, %%rbx  # Result to rbx");
+        break;
+    case OP_MOD_ASSIGN:
+        emit(gen, "    movq %%rax, %%rcx  # Move divisor to rcx");
+        emit(gen, "    movq %%rbx, %%rax  # Move dividend to rax");
+        emit(gen, "    cqto  # Sign extend");
+        emit(gen, "    idivq %%rcx  # Divide, remainder in rdx");
+        emit(gen, "    movq %%rdx, %%rbx  # Remainder to rbx");
+        break;
+    case OP_AND_ASSIGN:
+        emit(gen, "    andq %%rax, %%rbx  # &=");
+        break;
+    case OP_OR_ASSIGN:
+        emit(gen, "    orq %%rax, %%rbx  # |=");
+        break;
+    case OP_XOR_ASSIGN:
+        emit(gen, "    xorq %%rax, %%rbx  # ^=");
+        break;
+    case OP_LEFT_ASSIGN:
+        emit(gen, "    movq %%rax, %%rcx  # Shift count to rcx");
+        emit(gen, "    shlq %%cl, %%rbx  # <<=");
+        break;
+    case OP_RIGHT_ASSIGN:
+        emit(gen, "    movq %%rax, %%rcx  # Shift count to rcx");
+        emit(gen, "    shrq %%cl, %%rbx  # >>=");
+        break;
+    default:
+        break;
+    }
+    emit(gen, "    movq %%rbx, %%rax  # Result to rax");
+}
+
+// 生成表达式代码（结果放在 %rax）
+void gen_expression(CodeGenerator *gen, ASTNode *node)
+{
+    if (!node)
+        return;
+
+    // 浮点运算在 %xmm0 中完成，%rax 中得到结果的位模式
+    DataType kind = expr_float_kind(node);
+    if (kind != TYPE_INT &&
+        (node->type == AST_FLOAT_LITERAL || node->type == AST_BINARY_EXPR || node->type == AST_TERNARY_EXPR ||
+         node->type == AST_CAST_EXPR || (node->type == AST_UNARY_EXPR && node->value.op_type != OP_DEREF)))
+    {
+        gen_float_expression(gen, node);
+        gen_float_to_bits(gen, kind);
+        return;
+    }
+
+    switch (node->type)
+    {
+    case AST_INT_LITERAL:
+        emit(gen, "    movq $%d, %%rax  # Load integer constant", node->value.int_val);
+        break;
+
+    case AST_SIZEOF_EXPR:
+        // sizeof(type) 或 sizeof(expr)：操作数的类型由语义分析记录
+        emit(gen, "    movq $%d, %%rax  # sizeof result", const_sizeof(node));
+        break;
+
+    case AST_STRING_LITERAL:
+    {
+        // 添加字符串常量并获取标签
+        int label = add_string_constant(gen, node->value.string_val);
+        // 加载字符串地址到rax
+        emit(gen, "    leaq .LC%d(%%rip), %%rax  # Load string address", label);
+        break;
+    }
 
-            if (left_is_double || right_is_double)
+    case AST_IDENTIFIER:
+    {
+        // 使用存储的符号信息
+        const char *name = node->value.string_val;
+        Symbol *symbol = (Symbol *)node->semantic_info;
+        if (symbol)
+        {
+            // 检查是否是枚举常量（declaration节点类型为AST_ENUM_CONST）
+            if (symbol->declaration && symbol->declaration->type == AST_ENUM_CONST)
             {
-                emit(gen, "    movq %%rax, %%xmm0");
-                emit(gen, "    movq %%rbx, %%xmm1");
-                emit(gen, "    ucomisd %%xmm1, %%xmm0");
-                emit(gen, "    setbe %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                // 枚举常量：直接使用其整数值
+                int enum_value = symbol->declaration->value.int_val;
+                emit(gen, "    movq $%d, %%rax  # Enum constant '%s'", enum_value, name);
             }
-            else if (left_is_float || right_is_float)
+            else if (symbol->kind == SYMBOL_FUNCTION)
             {
-                emit(gen, "    cvtsi2ss %%rax, %%xmm0");
-                emit(gen, "    cvtsi2ss %%rbx, %%xmm1");
-                emit(gen, "    ucomiss %%xmm1, %%xmm0");
-                emit(gen, "    setbe %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                // 函数名作为值：函数地址
+                emit(gen, "    leaq %s(%%rip), %%rax  # Address of function '%s'",
+                     symbol->label ? symbol->label : name, name);
+            }
+            else if (is_aggregate(symbol->type))
+            {
+                // 数组和结构体作为值：数组退化为首元素的地址
+                gen_address(gen, node);
             }
             else
             {
-                emit(gen, "    cmpq %%rbx, %%rax");
-                emit(gen, "    setle %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                // 全局/静态变量通过标签访问，局部变量通过栈偏移访问
+                char operand[280];
+                gen_load(gen, symbol->type, variable_operand(gen, symbol, operand, sizeof(operand)), "rax");
             }
-            break;
         }
-        case OP_GE:
+        else
         {
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
-            int left_is_double = is_double_expression(node->children[0]);
-            int right_is_double = is_double_expression(node->children[1]);
+            emit(gen, "    movq $0, %%rax  # ERROR: Unknown variable '%s'", name);
+        }
+        break;
+    }
 
-            if (left_is_double || right_is_double)
-            {
-                emit(gen, "    movq %%rax, %%xmm0");
-                emit(gen, "    movq %%rbx, %%xmm1");
-                emit(gen, "    ucomisd %%xmm1, %%xmm0");
-                emit(gen, "    setae %%al");
-                emit(gen, "    movzbq %%al, %%rax");
-            }
-            else if (left_is_float || right_is_float)
-            {
-                emit(gen, "    cvtsi2ss %%rax, %%xmm0");
-                emit(gen, "    cvtsi2ss %%rbx, %%xmm1");
-                emit(gen, "    ucomiss %%xmm1, %%xmm0");
-                emit(gen, "    setae %%al");
-                emit(gen, "    movzbq %%al, %%rax");
-            }
-            else
-            {
-                emit(gen, "    cmpq %%rbx, %%rax");
-                emit(gen, "    setge %%al");
-                emit(gen, "    movzbq %%al, %%rax");
-            }
+    case AST_BINARY_EXPR:
+    {
+        if (node->num_children < 2)
+            break;
+
+        OperatorType op = node->value.op_type;
+        int is_comparison = op == OP_LT || op == OP_GT || op == OP_LE || op == OP_GE || op == OP_EQ || op == OP_NE;
+        DataType operand_kind =
+            common_float_kind(expr_float_kind(node->children[0]), expr_float_kind(node->children[1]));
+        if (is_comparison && operand_kind != TYPE_INT)
+        {
+            gen_float_compare(gen, node, operand_kind);
             break;
         }
-        case OP_EQ:
+        int is_logical = op == OP_AND || op == OP_OR;
+
+        // 先计算右操作数
+        if (is_logical)
+            gen_condition(gen, node->children[1]);
+        else
+            gen_expression(gen, node->children[1]);
+        push_reg(gen, "rax"); // 保存右操作数
+
+        // 计算左操作数
+        if (is_logical)
+            gen_condition(gen, node->children[0]);
+        else
+            gen_expression(gen, node->children[0]);
+
+        // 恢复右操作数到 rbx
+        pop_reg(gen, "rbx");
+
+        // 执行操作（结果在 rax）
+        switch (node->value.op_type)
         {
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
-            int left_is_double = is_double_expression(node->children[0]);
-            int right_is_double = is_double_expression(node->children[1]);
+        case OP_COMMA:
+            // 逗号运算符：左侧已求值并丢弃，右侧结果已在rax中
+            // rbx中是右侧的值，直接使用
+            emit(gen, "    movq %%rbx, %%rax  # Comma operator: use right side");
+            break;
 
-            if (left_is_double || right_is_double)
+        case OP_ADD:
+        {
+            // 指针算术：整数按指向的元素大小缩放
+            TypeInfo *left_type = expr_type(node->children[0]);
+            TypeInfo *right_type = expr_type(node->children[1]);
+            if (is_address_type(left_type) && !is_address_type(right_type))
             {
-                emit(gen, "    movq %%rax, %%xmm0");
-                emit(gen, "    movq %%rbx, %%xmm1");
-                emit(gen, "    ucomisd %%xmm1, %%xmm0");
-                emit(gen, "    sete %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                emit(gen, "    imulq $%d, %%rbx  # Scale integer for pointer arithmetic", element_size(left_type));
+                emit(gen, "    addq %%rbx, %%rax  # Pointer add");
             }
-            else if (left_is_float || right_is_float)
+            else if (!is_address_type(left_type) && is_address_type(right_type))
             {
-                emit(gen, "    cvtsi2ss %%rax, %%xmm0");
-                emit(gen, "    cvtsi2ss %%rbx, %%xmm1");
-                emit(gen, "    ucomiss %%xmm1, %%xmm0");
-                emit(gen, "    sete %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                emit(gen, "    imulq $%d, %%rax  # Scale integer for pointer arithmetic", element_size(right_type));
+                emit(gen, "    addq %%rbx, %%rax  # Pointer add");
             }
             else
             {
-                emit(gen, "    cmpq %%rbx, %%rax");
-                emit(gen, "    sete %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                // 普通整数加法
+                emit(gen, "    addq %%rbx, %%rax  # Integer add");
             }
             break;
         }
-        case OP_NE:
+        case OP_SUB:
         {
-            int left_is_float = is_float_expression(node->children[0]);
-            int right_is_float = is_float_expression(node->children[1]);
-            int left_is_double = is_double_expression(node->children[0]);
-            int right_is_double = is_double_expression(node->children[1]);
-
-            if (left_is_double || right_is_double)
+            TypeInfo *left_type = expr_type(node->children[0]);
+            TypeInfo *right_type = expr_type(node->children[1]);
+            if (is_address_type(left_type) && !is_address_type(right_type))
             {
-                emit(gen, "    movq %%rax, %%xmm0");
-                emit(gen, "    movq %%rbx, %%xmm1");
-                emit(gen, "    ucomisd %%xmm1, %%xmm0");
-                emit(gen, "    setne %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                emit(gen, "    imulq $%d, %%rbx  # Scale integer for pointer arithmetic", element_size(left_type));
+                emit(gen, "    subq %%rbx, %%rax  # Pointer subtract");
             }
-            else if (left_is_float || right_is_float)
+            else if (is_address_type(left_type) && is_address_type(right_type))
             {
-                emit(gen, "    cvtsi2ss %%rax, %%xmm0");
-                emit(gen, "    cvtsi2ss %%rbx, %%xmm1");
-                emit(gen, "    ucomiss %%xmm1, %%xmm0");
-                emit(gen, "    setne %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                // 指针 - 指针：结果是元素个数
+                emit(gen, "    subq %%rbx, %%rax  # Subtract (pointer - pointer)");
+                emit(gen, "    movq $%d, %%rbx", element_size(left_type));
+                emit(gen, "    cqto  # Sign extend");
+                emit(gen, "    idivq %%rbx  # Divide by element size");
             }
             else
             {
-                emit(gen, "    cmpq %%rbx, %%rax");
-                emit(gen, "    setne %%al");
-                emit(gen, "    movzbq %%al, %%rax");
+                // 普通整数减法
+                emit(gen, "    subq %%rbx, %%rax  # Integer subtract");
             }
             break;
         }
+        case OP_MUL:
+            emit(gen, "    imulq %%rbx, %%rax  # Integer multiply");
+            break;
+        case OP_DIV:
+            emit(gen, "    cqto  # Sign extend");
+            emit(gen, "    idivq %%rbx  # Integer divide");
+            break;
+        case OP_MOD:
+            emit(gen, "    cqto  # Sign extend");
+            emit(gen, "    idivq %%rbx  # Modulo");
+            emit(gen, "    movq %%rdx, %%rax  # Result in rax");
+            break;
+        case OP_LT:
+            emit(gen, "    cmpq %%rbx, %%rax  # Integer compare <");
+            emit(gen, "    setl %%al");
+            emit(gen, "    movzbq %%al, %%rax");
+            break;
+        case OP_GT:
+            emit(gen, "    cmpq %%rbx, %%rax");
+            emit(gen, "    setg %%al");
+            emit(gen, "    movzbq %%al, %%rax");
+            break;
+        case OP_LE:
+            emit(gen, "    cmpq %%rbx, %%rax");
+            emit(gen, "    setle %%al");
+            emit(gen, "    movzbq %%al, %%rax");
+            break;
+        case OP_GE:
+            emit(gen, "    cmpq %%rbx, %%rax");
+            emit(gen, "    setge %%al");
+            emit(gen, "    movzbq %%al, %%rax");
+            break;
+        case OP_EQ:
+            emit(gen, "    cmpq %%rbx, %%rax");
+            emit(gen, "    sete %%al");
+            emit(gen, "    movzbq %%al, %%rax");
+            break;
+        case OP_NE:
+            emit(gen, "    cmpq %%rbx, %%rax");
+            emit(gen, "    setne %%al");
+            emit(gen, "    movzbq %%al, %%rax");
+            break;
         case OP_AND:
             // 逻辑与: 两个都非零则为1，否则为0
             emit(gen, "    testq %%rax, %%rax  # Test left operand");
@@ -818,211 +1355,88 @@ void gen_expression(CodeGenerator *gen, ASTNode *node)
             break;
 
         ASTNode *lhs = node->children[0];
-
-        // 检查是否为复合赋值运算符
-        int is_compound = (node->value.op_type != OP_ASSIGN);
-
-        // 如果是复合赋值，先加载左侧的值
-        if (is_compound)
-        {
-            gen_expression(gen, lhs); // 加载左侧的当前值到 rax
-            push_reg(gen, "rax");     // 保存到栈
+        DataType lhs_kind = expr_float_kind(lhs);
+        OperatorType compound_op = node->value.op_type;
+        OperatorType arith_op = compound_op == OP_ADD_ASSIGN   ? OP_ADD
+                                : compound_op == OP_SUB_ASSIGN ? OP_SUB
+                                : compound_op == OP_MUL_ASSIGN ? OP_MUL
+                                : compound_op == OP_DIV_ASSIGN ? OP_DIV
+                                                               : OP_ASSIGN;
+
+        // 有浮点操作数的复合赋值按 x = x op y 生成（运算在浮点类型中进行，再转换为左侧的类型）
+        if (arith_op != OP_ASSIGN && (lhs_kind != TYPE_INT || expr_float_kind(node->children[1]) != TYPE_INT))
+        {
+            ASTNode *rhs = node->children[1];
+            ASTNode *operands[2] = {lhs, rhs};
+            ASTNode binary;
+            memset(&binary, 0, sizeof(binary));
+            binary.type = AST_BINARY_EXPR;
+            binary.lineno = node->lineno;
+            binary.value.op_type = arith_op;
+            binary.children = operands;
+            binary.num_children = 2;
+            node->value.op_type = OP_ASSIGN;
+            node->children[1] = &binary;
+            gen_expression(gen, node);
+            node->children[1] = rhs;
+            node->value.op_type = compound_op;
+            break;
         }
 
-        // 检查左侧是否是数组下标 (arr[i] = value)
-        if (lhs->type == AST_ARRAY_SUBSCRIPT)
+        // 浮点变量的赋值直接从 %xmm0 存储
+        if (lhs_kind != TYPE_INT && compound_op == OP_ASSIGN &&
+            (lhs->type == AST_IDENTIFIER || lhs->type == AST_DECLARATOR))
         {
-            if (lhs->num_children < 2)
-                break;
-
-            ASTNode *array_node = lhs->children[0];
-            ASTNode *index_node = lhs->children[1];
-
-            // 计算索引
-            gen_expression(gen, index_node);
-            push_reg(gen, "rax"); // 保存索引
-
-            // 获取数组基地址（arr[0]）
-            if (array_node->type == AST_IDENTIFIER)
-            {
-                Symbol *symbol = (Symbol *)array_node->semantic_info;
-                if (symbol)
-                {
-                    // arr[0]的地址
-                    int offset = -(symbol->offset + 8);
-                    emit(gen, "    leaq %d(%%rbp), %%rbx  # Load array base (arr[0]) for assign", offset);
-                }
-            }
-            else
-            {
-                gen_expression(gen, array_node);
-                emit(gen, "    movq %%rax, %%rbx  # Array base address");
-            }
-
-            // 弹出索引
-            pop_reg(gen, "rax");
-
-            // 计算元素地址：base - index*8（栈向下增长）
-            emit(gen, "    imulq $8, %%rax  # Calculate offset (index * 8)");
-            emit(gen, "    subq %%rax, %%rbx  # Subtract offset from base");
-            emit(gen, "    movq %%rbx, %%rax  # Move element address to rax");
-            push_reg(gen, "rax"); // 保存元素地址
-
-            // 计算右侧表达式的值
-            gen_expression(gen, node->children[1]);
-
-            // 恢复元素地址
-            pop_reg(gen, "rbx");
-
-            // 存储值到数组元素
-            emit(gen, "    movq %%rax, (%%rbx)  # Store to array element");
+            gen_float_expression(gen, node);
+            gen_float_to_bits(gen, lhs_kind);
+            break;
         }
-        // 检查左侧是否是解引用表达式 (*ptr = value)
-        else if (lhs->type == AST_UNARY_EXPR && lhs->value.op_type == OP_DEREF)
-        {
-            // 先计算指针地址
-            gen_expression(gen, lhs->children[0]);
-            push_reg(gen, "rax"); // 保存指针地址
-
-            // 计算右侧表达式的值
-            gen_expression(gen, node->children[1]);
 
-            // 恢复指针地址到 rbx
-            pop_reg(gen, "rbx");
-
-            // 存储值到指针指向的位置
-            emit(gen, "    movq %%rax, (%%rbx)  # Store to dereferenced pointer");
-        }
-        // 检查左侧是否是结构体成员访问 (p.x = value)
-        else if (lhs->type == AST_MEMBER_ACCESS)
-        {
-            if (lhs->num_children < 2)
-                break;
-
-            ASTNode *struct_node = lhs->children[0];
-            ASTNode *member_node = lhs->children[1];
-
-            // 计算右侧表达式的值
-            gen_expression(gen, node->children[1]);
-
-            // 如果结构体是标识符
-            if (struct_node->type == AST_IDENTIFIER)
-            {
-                Symbol *symbol = (Symbol *)struct_node->semantic_info;
-                if (symbol && symbol->type)
-                {
-                    const char *member_name = member_node->value.string_val;
-                    int member_offset = 0;
-                    int found = 0;
-
-                    // 从TypeInfo的members中查找成员偏移
-                    if (symbol->type->members && symbol->type->num_members > 0)
-                    {
-                        for (int i = 0; i < symbol->type->num_members; i++)
-                        {
-                            if (strcmp(symbol->type->members[i].name, member_name) == 0)
-                            {
-                                member_offset = symbol->type->members[i].offset;
-                                found = 1;
-                                break;
-                            }
-                        }
-                    }
-
-                    // 如果没有找到members信息，使用默认偏移（向后兼容）
-                    if (!found)
-                    {
-                        if (strcmp(member_name, "y") == 0)
-                            member_offset = 8;
-                        else if (strcmp(member_name, "x") == 0)
-                            member_offset = 0;
-                    }
-
-                    // 结构体变量基地址 + 成员偏移
-                    int base_offset = -(symbol->offset + 8);
-                    int final_offset = base_offset - member_offset;
+        int is_compound = (node->value.op_type != OP_ASSIGN);
+        TypeInfo *lhs_type = expr_type(lhs);
 
-                    emit(gen, "    movq %%rax, %d(%%rbp)  # Store to %s.%s",
-                         final_offset, symbol->name, member_name);
-                }
-            }
-        }
-        else if (lhs->type == AST_IDENTIFIER || lhs->type == AST_DECLARATOR)
+        // 标量变量：直接按变量的操作数读写
+        if ((lhs->type == AST_IDENTIFIER || lhs->type == AST_DECLARATOR) && !is_aggregate(lhs_type))
         {
-            // 计算右侧表达式
-            gen_expression(gen, node->children[1]);
-
-            // 如果是复合赋值，执行运算
+            Symbol *symbol = (Symbol *)lhs->semantic_info;
+            if (!symbol)
+                break;
+            char location[280];
             if (is_compound)
             {
-                pop_reg(gen, "rbx"); // 弹出左侧的旧值到 rbx
-
-                // 根据运算符类型执行操作
-                switch (node->value.op_type)
-                {
-                case OP_ADD_ASSIGN:
-                    emit(gen, "    addq %%rax, %%rbx  # +=");
-                    break;
-                case OP_SUB_ASSIGN:
-                    emit(gen, "    subq %%rax, %%rbx  # -=");
-                    break;
-                case OP_MUL_ASSIGN:
-                    emit(gen, "    imulq %%rax, %%rbx  # *=");
-                    break;
-                case OP_DIV_ASSIGN:
-                    emit(gen, "    movq %%rax, %%rcx  # Move divisor to rcx");
-                    emit(gen, "    movq %%rbx, %%rax  # Move dividend to rax");
-                    emit(gen, "    cqto  # Sign extend");
-                    emit(gen, "    idivq %%rcx  # Divide rax by rcx");
-                    emit(gen, "    movq %%rax, %%rbx  # Result to rbx");
-                    break;
-                case OP_MOD_ASSIGN:
-                    emit(gen, "    movq %%rax, %%rcx  # Move divisor to rcx");
-                    emit(gen, "    movq %%rbx, %%rax  # Move dividend to rax");
-                    emit(gen, "    cqto  # Sign extend");
-                    emit(gen, "    idivq %%rcx  # Divide, remainder in rdx");
-                    emit(gen, "    movq %%rdx, %%rbx  # Remainder to rbx");
-                    break;
-                case OP_AND_ASSIGN:
-                    emit(gen, "    andq %%rax, %%rbx  # &=");
-                    break;
-                case OP_OR_ASSIGN:
-                    emit(gen, "    orq %%rax, %%rbx  # |=");
-                    break;
-                case OP_XOR_ASSIGN:
-                    emit(gen, "    xorq %%rax, %%rbx  # ^=");
-                    break;
-                case OP_LEFT_ASSIGN:
-                    emit(gen, "    movq %%rax, %%rcx  # Shift count to rcx");
-                    emit(gen, "    shlq %%cl, %%rbx  # <<=");
-                    break;
-                case OP_RIGHT_ASSIGN:
-                    emit(gen, "    movq %%rax, %%rcx  # Shift count to rcx");
-                    emit(gen, "    shrq %%cl, %%rbx  # >>=");
-                    break;
-                }
-                emit(gen, "    movq %%rbx, %%rax  # Result to rax");
+                gen_load(gen, lhs_type, variable_operand(gen, symbol, location, sizeof(location)), "rax"); // 左侧的当前值
+                push_reg(gen, "rax");
             }
-
-            // 存储到左侧变量
-            const char *name = lhs->value.string_val;
-            Symbol *symbol = (Symbol *)lhs->semantic_info;
-            if (symbol)
+            gen_value_as(gen, node->children[1], lhs_kind);
+            if (is_compound)
             {
-                if (symbol->is_global || symbol->is_static)
-                {
-                    // 全局/静态变量：使用标签访问
-                    emit(gen, "    movq %%rax, %s(%%rip)  # Store to global/static '%s'",
-                         symbol->label, name);
-                }
-                else
-                {
-                    // 局部变量：使用栈偏移访问
-                    int offset = -(symbol->offset + 8);
-                    emit(gen, "    movq %%rax, %d(%%rbp)  # Store to variable '%s'", offset, name);
-                }
+                pop_reg(gen, "rbx");
+                gen_compound_op(gen, node->value.op_type, lhs_type);
             }
+            // 右侧可能含有调用，extern 变量的地址要重新读取
+            gen_store(gen, lhs_type, "rax", variable_operand(gen, symbol, location, sizeof(location)));
+            break;
+        }
+
+        // 其他左值（数组元素、解引用、结构体成员，以及整个结构体）：先求地址
+        gen_address(gen, lhs);
+        push_reg(gen, "rax");
+        gen_value_as(gen, node->children[1], lhs_kind);
+        if (is_compound)
+        {
+            emit(gen, "    movq (%%rsp), %%rbx  # Lvalue address");
+            gen_load(gen, lhs_type, "(%rbx)", "rbx");
+            gen_compound_op(gen, node->value.op_type, lhs_type);
+        }
+        pop_reg(gen, "rbx");
+        if (lhs_type && lhs_type->pointer_level == 0 && lhs_type->base_type == TYPE_STRUCT && !type_is_array(lhs_type))
+        {
+            // 结构体赋值：%rax 中是右侧对象的地址，结果是左侧对象的地址
+            gen_copy_object(gen, type_size(lhs_type));
+            emit(gen, "    movq %%rbx, %%rax");
+            break;
         }
+        gen_store(gen, lhs_type, "rax", "(%rbx)");
         break;
     }
 
@@ -1031,33 +1445,8 @@ void gen_expression(CodeGenerator *gen, ASTNode *node)
         // 类型转换 (type)expr
         if (node->num_children < 2)
             break;
-
-        // 生成被转换的表达式
-        gen_expression(gen, node->children[1]);
-
-        // 根据目标类型进行转换
-        TypeInfo *target_type = (TypeInfo *)node->semantic_info;
-        if (target_type)
-        {
-            if (target_type->base_type == TYPE_FLOAT)
-            {
-                // 转换到float: int -> float
-                emit(gen, "    cvtsi2ss %%rax, %%xmm0  # Cast int to float");
-            }
-            else if (target_type->base_type == TYPE_INT ||
-                     target_type->base_type == TYPE_LONG ||
-                     target_type->base_type == TYPE_SHORT ||
-                     target_type->base_type == TYPE_CHAR)
-            {
-                // 转换到整数类型
-                // 从float转换
-                emit(gen, "    # Cast to int (value already in rax or convert from xmm0)");
-                // 如果源可能是float，尝试转换
-                emit(gen, "    cvttss2si %%xmm0, %%rbx  # Try float to int");
-                emit(gen, "    test %%rax, %%rax");
-                emit(gen, "    cmovz %%rbx, %%rax  # Use float conversion if rax was 0");
-            }
-        }
+        // 转换为浮点类型的情况由上面的浮点路径处理，这里目标是整数或指针
+        gen_value_as(gen, node->children[1], TYPE_INT);
         break;
     }
 
@@ -1070,217 +1459,52 @@ void gen_expression(CodeGenerator *gen, ASTNode *node)
         switch (node->value.op_type)
         {
         case OP_ADDR:
-            // 取地址：不计算操作数的值，而是返回其地址
-            if (node->children[0]->type == AST_IDENTIFIER)
-            {
-                ASTNode *id = node->children[0];
-                Symbol *symbol = (Symbol *)id->semantic_info;
-                if (symbol)
-                {
-                    int offset = -(symbol->offset + 8);
-                    emit(gen, "    leaq %d(%%rbp), %%rax  # Load address of '%s'",
-                         offset, id->value.string_val);
-                }
-            }
-            else if (node->children[0]->type == AST_ARRAY_SUBSCRIPT)
-            {
-                // 对于数组下标，计算元素的地址（不加载值）
-                ASTNode *array_node = node->children[0]->children[0];
-                ASTNode *index_node = node->children[0]->children[1];
-
-                // 计算索引
-                gen_expression(gen, index_node);
-                emit(gen, "    pushq %%rax");
-
-                // 获取数组基地址
-                Symbol *array_symbol = (Symbol *)array_node->semantic_info;
-                if (array_symbol)
-                {
-                    emit(gen, "    leaq -%d(%%rbp), %%rbx  # Load array base (arr[0]) address",
-                         array_symbol->offset + 8);
-                    emit(gen, "    popq %%rax");
-                    emit(gen, "    imulq $8, %%rax  # Calculate offset (index * 8)");
-                    emit(gen, "    subq %%rax, %%rbx  # Subtract offset from base");
-                    emit(gen, "    movq %%rbx, %%rax  # Move element address to rax");
-                }
-            }
-            break;
-        case OP_PREINC:
-        case OP_PREDEC:
         {
-            // 前缀递增/递减：++i, --i, ++arr[i], ++p.x
-            // 先递增/递减，然后返回新值
+            // 取地址：不计算操作数的值，而是返回其地址
             ASTNode *operand = node->children[0];
-
-            if (operand->type == AST_IDENTIFIER)
-            {
-                // 简单变量：++i
-                Symbol *symbol = (Symbol *)operand->semantic_info;
-                if (symbol)
-                {
-                    int offset = -(symbol->offset + 8);
-                    emit(gen, "    movq %d(%%rbp), %%rax  # Load variable", offset);
-                    if (node->value.op_type == OP_PREINC)
-                        emit(gen, "    addq $1, %%rax  # ++");
-                    else
-                        emit(gen, "    subq $1, %%rax  # --");
-                    emit(gen, "    movq %%rax, %d(%%rbp)  # Store back", offset);
-                }
-            }
-            else if (operand->type == AST_ARRAY_SUBSCRIPT)
-            {
-                // 数组元素：++arr[i]
-                // 需要特殊处理：获取地址而不是值
-                if (operand->num_children >= 2)
-                {
-                    ASTNode *array_node = operand->children[0];
-                    ASTNode *index_node = operand->children[1];
-
-                    // 计算索引
-                    gen_expression(gen, index_node);
-                    push_reg(gen, "rax");
-
-                    // 获取数组基地址
-                    if (array_node->type == AST_IDENTIFIER)
-                    {
-                        Symbol *symbol = (Symbol *)array_node->semantic_info;
-                        if (symbol)
-                        {
-                            int base_offset = -(symbol->offset + 8);
-                            emit(gen, "    leaq %d(%%rbp), %%rax  # Array base", base_offset);
-                        }
-                    }
-
-                    // 计算元素地址
-                    pop_reg(gen, "rcx");
-                    emit(gen, "    imulq $8, %%rcx");
-                    emit(gen, "    subq %%rcx, %%rax  # Element address");
-
-                    // 加载、递增、存回
-                    emit(gen, "    movq (%%rax), %%rbx  # Load value");
-                    push_reg(gen, "rax");
-                    if (node->value.op_type == OP_PREINC)
-                        emit(gen, "    addq $1, %%rbx");
-                    else
-                        emit(gen, "    subq $1, %%rbx");
-                    pop_reg(gen, "rax");
-                    emit(gen, "    movq %%rbx, (%%rax)  # Store back");
-                    emit(gen, "    movq %%rbx, %%rax  # Result");
-                }
-            }
-            else if (operand->type == AST_MEMBER_ACCESS ||
-                     (operand->type == AST_UNARY_EXPR && operand->value.op_type == OP_DEREF))
-            {
-                // 结构体成员或解引用：++p.x, ++(*ptr)
-                // gen_expression对于MEMBER_ACCESS会返回地址+值
-                // 我们需要重新获取地址
+            Symbol *symbol = operand->type == AST_IDENTIFIER ? (Symbol *)operand->semantic_info : NULL;
+            if (symbol && symbol->kind == SYMBOL_FUNCTION)
                 gen_expression(gen, operand);
-                emit(gen, "    movq (%%rax), %%rbx  # Load current value");
-                push_reg(gen, "rax");
-
-                if (node->value.op_type == OP_PREINC)
-                    emit(gen, "    addq $1, %%rbx  # ++");
-                else
-                    emit(gen, "    subq $1, %%rbx  # --");
-
-                pop_reg(gen, "rax");
-                emit(gen, "    movq %%rbx, (%%rax)  # Store back");
-                emit(gen, "    movq %%rbx, %%rax  # Result is new value");
-            }
+            else
+                gen_address(gen, operand);
             break;
         }
+        case OP_PREINC:
+        case OP_PREDEC:
         case OP_POSTINC:
         case OP_POSTDEC:
         {
-            // 后缀递增/递减：i++, i--, arr[i]++, p.x++
-            // 先返回旧值，然后递增/递减
+            // 递增/递减：++i, arr[i]--, p->x++ 等；指针按指向的元素大小增减
             ASTNode *operand = node->children[0];
+            TypeInfo *type = expr_type(operand);
+            OperatorType op = node->value.op_type;
+            int is_post = op == OP_POSTINC || op == OP_POSTDEC;
+            const char *arith = (op == OP_PREINC || op == OP_POSTINC) ? "addq" : "subq";
+            int step = is_address_type(type) ? element_size(type) : 1;
+            char location[280];
 
-            if (operand->type == AST_IDENTIFIER)
+            if (operand->type == AST_IDENTIFIER && operand->semantic_info)
             {
-                // 简单变量：i++
-                Symbol *symbol = (Symbol *)operand->semantic_info;
-                if (symbol)
-                {
-                    int offset = -(symbol->offset + 8);
-                    emit(gen, "    movq %d(%%rbp), %%rax  # Load variable", offset);
-                    emit(gen, "    movq %%rax, %%rbx  # Save old value");
-                    if (node->value.op_type == OP_POSTINC)
-                        emit(gen, "    addq $1, %%rbx  # ++");
-                    else
-                        emit(gen, "    subq $1, %%rbx  # --");
-                    emit(gen, "    movq %%rbx, %d(%%rbp)  # Store new value", offset);
-                    // rax still holds old value
-                }
+                variable_operand(gen, (Symbol *)operand->semantic_info, location, sizeof(location));
             }
-            else if (operand->type == AST_ARRAY_SUBSCRIPT)
+            else
             {
-                // 数组元素：arr[i]++
-                if (operand->num_children >= 2)
-                {
-                    ASTNode *array_node = operand->children[0];
-                    ASTNode *index_node = operand->children[1];
-
-                    // 计算索引
-                    gen_expression(gen, index_node);
-                    push_reg(gen, "rax");
-
-                    // 获取数组基地址
-                    if (array_node->type == AST_IDENTIFIER)
-                    {
-                        Symbol *symbol = (Symbol *)array_node->semantic_info;
-                        if (symbol)
-                        {
-                            int base_offset = -(symbol->offset + 8);
-                            emit(gen, "    leaq %d(%%rbp), %%rax  # Array base", base_offset);
-                        }
-                    }
-
-                    // 计算元素地址
-                    pop_reg(gen, "rcx");
-                    emit(gen, "    imulq $8, %%rcx");
-                    emit(gen, "    subq %%rcx, %%rax  # Element address");
-
-                    // 加载旧值
-                    emit(gen, "    movq (%%rax), %%rbx  # Load old value");
-                    push_reg(gen, "rax"); // 保存地址
-                    emit(gen, "    movq %%rbx, %%rax  # Old value to rax");
-                    push_reg(gen, "rax"); // 保存旧值
-
-                    // 递增递减
-                    if (node->value.op_type == OP_POSTINC)
-                        emit(gen, "    addq $1, %%rbx");
-                    else
-                        emit(gen, "    subq $1, %%rbx");
-
-                    // 存回新值
-                    pop_reg(gen, "rax"); // 恢复旧值（给返回用）
-                    pop_reg(gen, "rcx"); // 恢复地址
-                    emit(gen, "    movq %%rbx, (%%rcx)  # Store new value");
-                    // rax中已经是旧值
-                }
+                gen_address(gen, operand);
+                emit(gen, "    movq %%rax, %%rcx  # Lvalue address");
+                snprintf(location, sizeof(location), "(%%rcx)");
             }
-            else if (operand->type == AST_MEMBER_ACCESS ||
-                     (operand->type == AST_UNARY_EXPR && operand->value.op_type == OP_DEREF))
+            gen_load(gen, type, location, "rax");
+            if (is_post)
             {
-                // 结构体成员或解引用：p.x++, (*ptr)++
-                gen_expression(gen, operand);
-                push_reg(gen, "rax");
-                emit(gen, "    movq (%%rax), %%rax  # Load current value");
-                push_reg(gen, "rax");
-
-                if (node->value.op_type == OP_POSTINC)
-                    emit(gen, "    addq $1, %%rax  # ++");
-                else
-                    emit(gen, "    subq $1, %%rax  # --");
-
-                emit(gen, "    movq %%rax, %%rbx  # New value to rbx");
-                pop_reg(gen, "rax"); // 恢复旧值
-                push_reg(gen, "rax");
-                pop_reg(gen, "rcx");
-                pop_reg(gen, "rdx");
-                emit(gen, "    movq %%rbx, (%%rdx)  # Store new value");
-                emit(gen, "    movq %%rcx, %%rax  # Result is old value");
+                emit(gen, "    movq %%rax, %%rbx  # Save old value");
+                emit(gen, "    %s $%d, %%rbx", arith, step);
+                gen_store(gen, type, "rbx", location);
+                // rax 中是旧值
+            }
+            else
+            {
+                emit(gen, "    %s $%d, %%rax", arith, step);
+                gen_store(gen, type, "rax", location);
             }
             break;
         }
@@ -1290,7 +1514,10 @@ void gen_expression(CodeGenerator *gen, ASTNode *node)
         case OP_BIT_NOT:
         default:
             // 对于其他运算符，先计算操作数
-            gen_expression(gen, node->children[0]);
+            if (node->value.op_type == OP_NOT)
+                gen_condition(gen, node->children[0]);
+            else
+                gen_expression(gen, node->children[0]);
 
             if (node->value.op_type == OP_NOT)
             {
@@ -1306,8 +1533,9 @@ void gen_expression(CodeGenerator *gen, ASTNode *node)
             }
             else if (node->value.op_type == OP_DEREF)
             {
-                // 解引用：rax 中是指针（地址），加载该地址处的值
-                emit(gen, "    movq (%%rax), %%rax  # Dereference pointer");
+                // 解引用：rax 中是指针（地址），加载该地址处的值（指向数组或结构体时地址就是结果）
+                if (!is_aggregate(expr_type(node)))
+                    gen_load(gen, expr_type(node), "(%rax)", "rax");
             }
             else if (node->value.op_type == OP_BIT_NOT)
             {
@@ -1320,166 +1548,19 @@ void gen_expression(CodeGenerator *gen, ASTNode *node)
     }
 
     case AST_CALL_EXPR:
-    {
-        if (node->num_children < 1)
-            break;
-
-        // 获取函数名
-        ASTNode *func_node = node->children[0];
-        if (func_node->type != AST_IDENTIFIER)
-            break;
-
-        const char *func_name = func_node->value.string_val;
-
-        // System V AMD64 ABI: 参数寄存器
-        const char *param_regs[] = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
-
-        // 准备参数
-        int num_args = 0;
-        if (node->num_children > 1 && node->children[1]->type == AST_ARG_LIST)
-        {
-            ASTNode *arg_list = node->children[1];
-            num_args = arg_list->num_children;
-
-            // 将参数压栈（从右到左）
-            for (int i = num_args - 1; i >= 0; i--)
-            {
-                gen_expression(gen, arg_list->children[i]);
-                push_reg(gen, "rax");
-            }
-
-            // 从栈弹出到参数寄存器（从左到右）
-            int num_reg_args = num_args < 6 ? num_args : 6;
-            for (int i = 0; i < num_reg_args; i++)
-            {
-                pop_reg(gen, param_regs[i]);
-            }
-        }
-
-        // 调用函数前保证栈对齐到16字节
-        // System V AMD64 ABI要求 call 前栈是16字节对齐的
-        emit(gen, "    call %s", func_name);
-
-        // rax 现在包含返回值
+        gen_call(gen, node);
+        if (kind != TYPE_INT)
+            gen_float_to_bits(gen, kind);
         break;
-    }
 
     case AST_ARRAY_SUBSCRIPT:
-    {
-        // 数组下标访问: array[index]
-        if (node->num_children < 2)
-            break;
-
-        ASTNode *array_node = node->children[0];
-        ASTNode *index_node = node->children[1];
-
-        // 计算当前维度的索引
-        gen_expression(gen, index_node);
-        push_reg(gen, "rax"); // 保存当前索引到栈
-
-        // 获取数组基地址
-        if (array_node->type == AST_IDENTIFIER)
-        {
-            Symbol *symbol = (Symbol *)array_node->semantic_info;
-            if (symbol)
-            {
-                // 数组在栈上，arr[0]的地址
-                int base_offset = -(symbol->offset + 8);
-                emit(gen, "    leaq %d(%%rbp), %%rax  # Load array base (arr[0])", base_offset);
-            }
-        }
-        else if (array_node->type == AST_ARRAY_SUBSCRIPT)
-        {
-            // 嵌套数组访问：递归计算内层地址
-            gen_expression(gen, array_node);
-            // rax 中已经是内层的地址
-        }
-        else
-        {
-            // 其他表达式
-            gen_expression(gen, array_node);
-        }
-
-        // 恢复当前维度的索引
-        pop_reg(gen, "rcx");
-
-        // 计算元素大小：根据类型确定
-        int element_size = 8; // 默认8字节
-        if (node->semantic_info)
-        {
-            TypeInfo *elem_type = (TypeInfo *)node->semantic_info;
-            // 对于多维数组，如果还有维度，大小是剩余维度的总大小
-            if (elem_type->array_dimensions > 0 && elem_type->array_sizes)
-            {
-                // 计算剩余维度的总大小
-                element_size = 1;
-                for (int d = 0; d < elem_type->array_dimensions; d++)
-                {
-                    if (elem_type->array_sizes[d] > 0)
-                    {
-                        element_size *= elem_type->array_sizes[d];
-                    }
-                }
-                element_size *= 8; // 基本元素大小（int = 8字节）
-            }
-            else
-            {
-                // 基本类型大小
-                switch (elem_type->base_type)
-                {
-                case TYPE_CHAR:
-                    element_size = 1;
-                    break;
-                case TYPE_SHORT:
-                    element_size = 2;
-                    break;
-                case TYPE_INT:
-                case TYPE_FLOAT:
-                case TYPE_LONG:
-                case TYPE_DOUBLE:
-                case TYPE_POINTER:
-                    element_size = 8;
-                    break;
-                default:
-                    element_size = 8;
-                }
-            }
-        }
-
-        // 计算偏移：index * element_size
-        if (element_size != 1)
-        {
-            emit(gen, "    imulq $%d, %%rcx  # Calculate offset (index * %d)",
-                 element_size, element_size);
-        }
-
-        // 计算元素地址: base - offset（因为栈向下增长）
-        emit(gen, "    subq %%rcx, %%rax  # Subtract offset (stack grows down)");
-
-        // 检查是否应该加载值
-        // 通过当前节点的semantic_info（返回类型）判断
-        // 如果返回类型仍然是数组（array_dimensions > 0），则不加载值
-        int should_load_value = 1; // 默认加载值
-
-        if (node->semantic_info)
-        {
-            TypeInfo *result_type = (TypeInfo *)node->semantic_info;
-            if (result_type && result_type->array_dimensions > 0)
-            {
-                // 返回类型是多维数组，不加载值（保留地址给下一层）
-                should_load_value = 0;
-            }
-        }
-
-        if (should_load_value)
-        {
-            // 一维数组或多维数组的最后一次访问：加载元素值
-            emit(gen, "    movq (%%rax), %%rax  # Load array element");
-        }
-        // 否则，rax 中已经是地址，用于下一层数组访问
-
+    case AST_MEMBER_ACCESS:
+        // 数组元素、结构体成员：先求地址，标量再按类型的宽度加载
+        // （多维数组的中间结果和结构体类型的成员保留地址）
+        gen_address(gen, node);
+        if (!is_aggregate(expr_type(node)))
+            gen_load(gen, expr_type(node), "(%rax)", "rax");
         break;
-    }
 
     case AST_INIT_LIST:
     {
@@ -1497,7 +1578,7 @@ void gen_expression(CodeGenerator *gen, ASTNode *node)
         int end_label = new_label(gen);
 
         // 计算条件
-        gen_expression(gen, node->children[0]);
+        gen_condition(gen, node->children[0]);
         emit(gen, "    testq %%rax, %%rax  # Test condition");
         emit(gen, "    je .L%d  # Jump if false", false_label);
 
@@ -1514,65 +1595,198 @@ void gen_expression(CodeGenerator *gen, ASTNode *node)
         break;
     }
 
-    case AST_MEMBER_ACCESS:
-    {
-        // 结构体成员访问
-        if (node->num_children < 2)
-            break;
+    default:
+        break;
+    }
+}
+
+// ========== 初始化列表 ==========
+// 初始化列表按 C 的规则对应到对象的各个标量：嵌套的花括号对应一个子数组或结构体，
+// 省略了花括号时按顺序依次填充。局部变量逐个存储，全局变量输出为数据
+
+// 一个标量（或用同类型的值整体初始化的结构体）的初始化，offset 为它在对象中的位置
+typedef void (*InitElementFn)(CodeGenerator *gen, TypeInfo *type, int offset, ASTNode *value, void *ctx);
+
+// 数组第一维的长度
+static int array_length(TypeInfo *type)
+{
+    if (type->array_dimensions > 0 && type->array_sizes)
+        return type->array_sizes[type->array_dimensions - 1];
+    return type->array_size;
+}
+
+static void walk_initializer(CodeGenerator *gen, TypeInfo *type, int offset, ASTNode *list, int *pos,
+                             InitElementFn fn, void *ctx);
 
-        ASTNode *struct_node = node->children[0];
-        ASTNode *member_node = node->children[1];
+// 用 list 中从 *pos 开始的元素依次初始化数组的元素或结构体的成员
+static void walk_aggregate(CodeGenerator *gen, TypeInfo *type, int offset, ASTNode *list, int *pos,
+                           InitElementFn fn, void *ctx)
+{
+    if (type_is_array(type))
+    {
+        TypeInfo *element = type_element(type);
+        int size = type_size(element);
+        for (int i = 0; i < array_length(type) && *pos < list->num_children; i++)
+            walk_initializer(gen, element, offset + i * size, list, pos, fn, ctx);
+        free_type(element);
+        return;
+    }
+    for (int i = 0; i < type->num_members && *pos < list->num_children; i++)
+        walk_initializer(gen, type->members[i].type, offset + type->members[i].offset, list, pos, fn, ctx);
+}
 
-        if (struct_node->type == AST_IDENTIFIER)
+// 用 list 的第 *pos 个元素（或省略花括号时的若干个元素）初始化一个对象
+static void walk_initializer(CodeGenerator *gen, TypeInfo *type, int offset, ASTNode *list, int *pos,
+                             InitElementFn fn, void *ctx)
+{
+    if (*pos >= list->num_children)
+        return;
+    ASTNode *item = list->children[*pos];
+    if (is_aggregate(type))
+    {
+        TypeInfo *item_type = expr_type(item);
+        if (item->type == AST_INIT_LIST)
         {
-            Symbol *symbol = (Symbol *)struct_node->semantic_info;
-            if (symbol && symbol->type)
-            {
-                const char *member_name = member_node->value.string_val;
-                int member_offset = 0;
-                int found = 0;
+            int inner = 0;
+            (*pos)++;
+            walk_aggregate(gen, type, offset, item, &inner, fn, ctx);
+        }
+        else if (!type_is_array(type) && item_type && item_type->base_type == TYPE_STRUCT &&
+                 item_type->pointer_level == 0 && !type_is_array(item_type))
+        {
+            (*pos)++;
+            fn(gen, type, offset, item, ctx); // 结构体整体赋值
+        }
+        else
+        {
+            walk_aggregate(gen, type, offset, list, pos, fn, ctx);
+        }
+        return;
+    }
+    (*pos)++;
+    while (item->type == AST_INIT_LIST && item->num_children > 0)
+        item = item->children[0]; // int x = {1}
+    if (item->type != AST_INIT_LIST)
+        fn(gen, type, offset, item, ctx);
+}
 
-                // 从TypeInfo的members中查找成员偏移
-                if (symbol->type->members && symbol->type->num_members > 0)
-                {
-                    for (int i = 0; i < symbol->type->num_members; i++)
-                    {
-                        if (strcmp(symbol->type->members[i].name, member_name) == 0)
-                        {
-                            member_offset = symbol->type->members[i].offset;
-                            found = 1;
-                            break;
-                        }
-                    }
-                }
+// 用初始化列表初始化位于 offset 处、类型为 type 的整个对象
+static void walk_initializer_list(CodeGenerator *gen, TypeInfo *type, int offset, ASTNode *list, InitElementFn fn,
+                                  void *ctx)
+{
+    int position = 0;
+    if (is_aggregate(type))
+        walk_aggregate(gen, type, offset, list, &position, fn, ctx);
+    else
+        walk_initializer(gen, type, offset, list, &position, fn, ctx);
+}
 
-                // 如果没有找到members信息，使用默认偏移（向后兼容）
-                if (!found)
-                {
-                    if (strcmp(member_name, "y") == 0)
-                        member_offset = 8;
-                    else if (strcmp(member_name, "x") == 0)
-                        member_offset = 0;
-                }
+// 局部对象的元素：offset 相对于 %rbp
+static void store_local_element(CodeGenerator *gen, TypeInfo *type, int offset, ASTNode *value, void *ctx)
+{
+    (void)ctx;
+    char location[64];
+    snprintf(location, sizeof(location), "%d(%%rbp)", offset);
+    if (is_aggregate(type))
+    {
+        gen_expression(gen, value); // 右侧结构体的地址
+        emit(gen, "    leaq %s, %%rbx", location);
+        gen_copy_object(gen, type_size(type));
+        return;
+    }
+    gen_value_as(gen, value, float_kind(type));
+    gen_store(gen, type, "rax", location);
+}
 
-                // 结构体变量的基地址 + 成员偏移
-                int base_offset = -(symbol->offset + 8);
-                int final_offset = base_offset - member_offset;
+#define ZERO_UNROLL_LIMIT 64 // 不超过这么多字节的对象逐个清零，更大的用循环
 
-                emit(gen, "    leaq %d(%%rbp), %%rax  # Load address of %s.%s",
-                     final_offset, symbol->name, member_name);
-                emit(gen, "    movq (%%rax), %%rax  # Load member value");
-            }
+// 把 [base(%rbp), base + size) 清零
+static void gen_zero_object(CodeGenerator *gen, int base, int size)
+{
+    int offset = 0;
+    if (size > ZERO_UNROLL_LIMIT)
+    {
+        int loop_label = new_label(gen);
+        emit(gen, "    leaq %d(%%rbp), %%rcx  # Clear object", base);
+        emit(gen, "    movq $%d, %%rax", size / 8);
+        emit(gen, ".L%d:", loop_label);
+        emit(gen, "    movq $0, (%%rcx)");
+        emit(gen, "    addq $8, %%rcx");
+        emit(gen, "    subq $1, %%rax");
+        emit(gen, "    jne .L%d", loop_label);
+        offset = size / 8 * 8;
+    }
+    for (int chunk = 8; chunk >= 1; chunk /= 2)
+    {
+        const char *suffix = chunk == 8 ? "q" : chunk == 4 ? "l" : chunk == 2 ? "w" : "b";
+        for (; offset + chunk <= size; offset += chunk)
+            emit(gen, "    mov%s $0, %d(%%rbp)", suffix, base + offset);
+    }
+}
+
+// 生成语句代码
+// switch 分派（switch_lower.c）的栈式输出：switch 值在 rax 中
+static int stack_switch_new_label(void *ctx)
+{
+    return new_label((CodeGenerator *)ctx);
+}
+
+static void stack_switch_emit_label(void *ctx, int label)
+{
+    emit((CodeGenerator *)ctx, ".L%d:", label);
+}
+
+static void stack_switch_emit_jump(void *ctx, int label)
+{
+    emit((CodeGenerator *)ctx, "    jmp .L%d", label);
+}
+
+static void stack_switch_emit_branch(void *ctx, IrOpcode cond, long value, int label)
+{
+    CodeGenerator *gen = (CodeGenerator *)ctx;
+    if (value >= -2147483648L && value <= 2147483647L)
+    {
+        emit(gen, "    cmpq $%ld, %%rax  # Compare case value", value);
+    }
+    else
+    {
+        emit(gen, "    movabsq $%ld, %%r11", value);
+        emit(gen, "    cmpq %%r11, %%rax  # Compare case value");
+    }
+    emit(gen, "    %s .L%d", cond == IR_EQ ? "je" : "jl", label);
+}
+
+static void stack_switch_emit_table(void *ctx, long low, const int *labels, int num_entries, int default_label)
+{
+    emit_jump_table((CodeGenerator *)ctx, "rax", low, labels, num_entries, default_label);
+}
+
+// 语句执行完之后一定跳走：return/break/continue、其中有这样的语句的复合语句、两个分支都跳走的 if
+static int statement_jumps_away(ASTNode *node)
+{
+    if (!node)
+        return 0;
+    switch (node->type)
+    {
+    case AST_RETURN_STMT:
+    case AST_BREAK_STMT:
+    case AST_CONTINUE_STMT:
+        return 1;
+    case AST_COMPOUND_STMT:
+        for (int i = 0; i < node->num_children; i++)
+        {
+            if (statement_jumps_away(node->children[i]))
+                return 1;
         }
-        break;
-    }
-
+        return 0;
+    case AST_IF_STMT:
+        return node->num_children > 2 && statement_jumps_away(node->children[1]) &&
+               statement_jumps_away(node->children[2]);
     default:
-        break;
+        return 0;
     }
 }
 
-// 生成语句代码
 void gen_statement(CodeGenerator *gen, ASTNode *node)
 {
     if (!node)
@@ -1637,36 +1851,12 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
                             }
                         }
 
-                        if (symbol)
+                        if (symbol && symbol->type)
                         {
-                            // 展平多维初始化列表到一维序列
-                            int flat_index = 0;
-
-                            // 递归函数：展平初始化列表
-                            void flatten_init_list(ASTNode * list, int *index_ptr)
-                            {
-                                for (int i = 0; i < list->num_children; i++)
-                                {
-                                    ASTNode *child = list->children[i];
-                                    if (child->type == AST_INIT_LIST)
-                                    {
-                                        // 递归处理嵌套列表
-                                        flatten_init_list(child, index_ptr);
-                                    }
-                                    else
-                                    {
-                                        // 叶子节点：计算并存储
-                                        gen_expression(gen, child);
-                                        int elem_offset = -(symbol->offset + (*index_ptr + 1) * 8);
-                                        emit(gen, "    movq %%rax, %d(%%rbp)  # Initialize array[%d]",
-                                             elem_offset, *index_ptr);
-                                        (*index_ptr)++;
-                                    }
-                                }
-                            }
-
-                            // 展平并初始化所有元素
-                            flatten_init_list(init_expr, &flat_index);
+                            // 先把整个对象清零（没有给出的元素为 0），再逐个存储给出的元素
+                            gen_zero_object(gen, -symbol->offset, type_size(symbol->type));
+                            walk_initializer_list(gen, symbol->type, -symbol->offset, init_expr,
+                                                  store_local_element, NULL);
                         }
                     }
                     else
@@ -1691,18 +1881,33 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
         for (int i = 0; i < node->num_children; i++)
         {
             gen_statement(gen, node->children[i]);
+            // dce：跳走之后的语句不可达
+            if (pass_enabled(gen->passes, PASS_DCE) && statement_jumps_away(node->children[i]))
+                break;
         }
         break;
 
     case AST_IF_STMT:
     {
+        // dce：条件是常量时只生成会执行的分支
+        int dce = pass_enabled(gen->passes, PASS_DCE);
+        long value;
+        if (dce && node->num_children > 1 && const_eval(node->children[0], &value))
+        {
+            if (value)
+                gen_statement(gen, node->children[1]);
+            else if (node->num_children > 2)
+                gen_statement(gen, node->children[2]);
+            break;
+        }
+
         int else_label = new_label(gen);
         int end_label = new_label(gen);
 
         // 计算条件
         if (node->num_children > 0)
         {
-            gen_expression(gen, node->children[0]);
+            gen_condition(gen, node->children[0]);
             emit(gen, "    testq %%rax, %%rax  # Test condition");
             emit(gen, "    je .L%d  # Jump if false", else_label);
         }
@@ -1712,7 +1917,8 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
         {
             gen_statement(gen, node->children[1]);
         }
-        emit(gen, "    jmp .L%d  # Jump to end", end_label);
+        if (!dce || !statement_jumps_away(node->children[1]))
+            emit(gen, "    jmp .L%d  # Jump to end", end_label);
 
         // else 分支
         emit(gen, ".L%d:", else_label);
@@ -1743,7 +1949,7 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
         // 计算条件
         if (node->num_children > 0)
         {
-            gen_expression(gen, node->children[0]);
+            gen_condition(gen, node->children[0]);
             emit(gen, "    testq %%rax, %%rax  # Test condition");
             emit(gen, "    je .L%d  # Jump if false", end_label);
         }
@@ -1789,7 +1995,7 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
         // 计算条件
         if (node->num_children > 1)
         {
-            gen_expression(gen, node->children[1]);
+            gen_condition(gen, node->children[1]);
             emit(gen, "    testq %%rax, %%rax  # Test condition");
             emit(gen, "    jne .L%d  # Jump if true", start_label);
         }
@@ -1829,7 +2035,7 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
             // expression_statement 可能包含表达式
             if (node->children[1]->num_children > 0)
             {
-                gen_expression(gen, node->children[1]->children[0]);
+                gen_condition(gen, node->children[1]->children[0]);
                 emit(gen, "    testq %%rax, %%rax  # Test condition");
                 emit(gen, "    je .L%d  # Jump if false", end_label);
             }
@@ -1861,7 +2067,12 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
     case AST_RETURN_STMT:
         if (node->num_children > 0)
         {
-            gen_expression(gen, node->children[0]);
+            // 浮点返回值放在 %xmm0，整数返回值放在 %rax
+            DataType kind = float_kind(gen->return_type);
+            if (kind != TYPE_INT)
+                gen_float_value(gen, node->children[0], kind);
+            else
+                gen_value_as(gen, node->children[0], TYPE_INT);
         }
         else
         {
@@ -1877,55 +2088,56 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
 
         int end_label = new_label(gen);
 
-        // 计算switch表达式
-        gen_expression(gen, node->children[0]);
-        emit(gen, "    pushq %%rax  # Save switch value");
-
         // 设置循环上下文（switch可以使用break）
         LoopContext loop_ctx;
         loop_ctx.end_label = end_label;
         loop_ctx.parent = gen->loop_context;
         gen->loop_context = &loop_ctx;
 
-        // 生成case比较和跳转
         ASTNode *body = node->children[1];
         int default_label = -1;
 
         if (body->type == AST_COMPOUND_STMT)
         {
-            // 第一遍：生成case比较
+            // 第一遍：为case/default分配标签，收集case值
+            SwitchCase *cases = (SwitchCase *)malloc((body->num_children + 1) * sizeof(SwitchCase));
+            if (!cases)
+            {
+                fprintf(stderr, "Out of memory\n");
+                exit(1);
+            }
+            int num_cases = 0;
             for (int i = 0; i < body->num_children; i++)
             {
-                if (body->children[i]->type == AST_CASE_STMT)
+                ASTNode *child = body->children[i];
+                if (child->type == AST_CASE_STMT)
                 {
-                    int case_label = new_label(gen);
-                    body->children[i]->value.int_val = case_label;
-
-                    if (body->children[i]->num_children >= 1)
+                    child->value.int_val = new_label(gen);
+                    long value;
+                    if (child->num_children >= 1 && const_eval(child->children[0], &value))
+                    {
+                        cases[num_cases].value = value;
+                        cases[num_cases].label = child->value.int_val;
+                        num_cases++;
+                    }
+                    else
                     {
-                        emit(gen, "    movq (%%rsp), %%rbx  # Load switch value");
-                        gen_expression(gen, body->children[i]->children[0]);
-                        emit(gen, "    cmpq %%rax, %%rbx  # Compare case value");
-                        emit(gen, "    je .L%d  # Jump if match", case_label);
+                        emit(gen, "    # ERROR: case label is not an integer constant");
                     }
                 }
-                else if (body->children[i]->type == AST_DEFAULT_STMT)
+                else if (child->type == AST_DEFAULT_STMT)
                 {
                     default_label = new_label(gen);
-                    body->children[i]->value.int_val = default_label;
+                    child->value.int_val = default_label;
                 }
             }
 
-            // 没有匹配，跳到default或结束
-            if (default_label >= 0)
-            {
-                emit(gen, "    jmp .L%d  # Jump to default", default_label);
-            }
-            else
-            {
-                emit(gen, "    addq $8, %%rsp  # Pop switch value");
-                emit(gen, "    jmp .L%d  # No match, exit switch", end_label);
-            }
+            // 计算switch表达式，分派期间一直保存在rax中
+            gen_expression(gen, node->children[0]);
+            SwitchTarget target = {gen, stack_switch_new_label, stack_switch_emit_label, stack_switch_emit_jump,
+                                   stack_switch_emit_branch, stack_switch_emit_table};
+            switch_emit_dispatch(&target, cases, num_cases, default_label >= 0 ? default_label : end_label);
+            free(cases);
 
             // 第二遍：生成case代码
             for (int i = 0; i < body->num_children; i++)
@@ -1952,8 +2164,11 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
                 }
             }
         }
+        else
+        {
+            gen_expression(gen, node->children[0]);
+        }
 
-        emit(gen, "    addq $8, %%rsp  # Pop switch value");
         emit(gen, ".L%d:  # Switch end", end_label);
 
         // 恢复循环上下文
@@ -1993,46 +2208,84 @@ void gen_statement(CodeGenerator *gen, ASTNode *node)
     }
 }
 
-// 生成函数代码
-void gen_function(CodeGenerator *gen, ASTNode *node)
+// 输出已经运行过 IR 遍的函数：寄存器分配、指令选择（之后释放 ir_func）
+static void emit_ir_function(CodeGenerator *gen, IrFunction *ir_func)
 {
-    if (!node || node->type != AST_FUNCTION_DEF)
-        return;
-    if (node->num_children < 3)
-        return;
+    if (gen->ir_dump)
+        ir_print_function(ir_func, gen->ir_dump);
+    RegAllocation *alloc = pass_manager_allocate(gen->passes, ir_func);
+    ir_emit_function(gen, ir_func, alloc);
+    regalloc_free(alloc);
+    ir_function_free(ir_func);
+    flush_output(gen);
+}
 
-    // 获取函数名
+// 输出降低为 IR 的函数：IR 遍、寄存器分配、指令选择（之后释放 ir_func）
+static void gen_ir_function(CodeGenerator *gen, IrFunction *ir_func)
+{
+    pass_manager_run_ir(gen->passes, ir_func);
+    emit_ir_function(gen, ir_func);
+}
+
+// 栈式代码生成：所有变量都在栈上，表达式的中间结果经过 rax 和栈
+static void gen_stack_function(CodeGenerator *gen, ASTNode *node)
+{
+    // 获取函数名（static 函数使用符号的标签，--unity 时可能已重命名）
     ASTNode *declarator = node->children[1];
+    Symbol *func_symbol = (Symbol *)declarator->semantic_info;
     const char *func_name = declarator->value.string_val;
+    int is_static = func_symbol && func_symbol->is_static && func_symbol->label;
+    if (is_static)
+        func_name = func_symbol->label;
+    if (gen->ir_dump)
+        fprintf(gen->ir_dump, "function %s: not lowered to IR (stack code generator)\n\n", func_name);
 
     // 为这个函数分配唯一的返回标签
     gen->return_label = new_label(gen);
+    gen->return_type = func_symbol && func_symbol->type ? func_symbol->type->return_type : NULL;
 
     // 生成序言
-    gen_prologue(gen, func_name);
+    gen_prologue(gen, func_name, is_static, func_symbol ? func_symbol->frame_size : 0);
 
     // 处理函数参数（从寄存器保存到栈）
-    // System V AMD64 ABI: rdi, rsi, rdx, rcx, r8, r9
+    // System V AMD64 ABI：整数参数在 rdi、rsi、rdx、rcx、r8、r9，浮点参数在 xmm0～xmm7，
+    // 其余参数由调用者压栈，从 16(%rbp) 开始
     const char *param_regs[] = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
     if (declarator->num_children > 0 && declarator->children[0]->type == AST_PARAM_LIST)
     {
         ASTNode *param_list = declarator->children[0];
-        int num_params = param_list->num_children < 6 ? param_list->num_children : 6;
+        int num_int_regs = 0;
+        int num_float_regs = 0;
+        int stack_offset = 16;
 
-        for (int i = 0; i < num_params; i++)
+        for (int i = 0; i < param_list->num_children; i++)
         {
             ASTNode *param = param_list->children[i];
             if (param->type == AST_DECLARATION && param->num_children >= 2)
             {
                 ASTNode *param_declarator = param->children[1];
-                const char *param_name = param_declarator->value.string_val;
                 Symbol *param_symbol = (Symbol *)param_declarator->semantic_info;
-
-                if (param_symbol)
+                if (!param_symbol)
+                    continue;
+
+                const char *param_name = param_symbol->name;
+                char location[280];
+                variable_operand(gen, param_symbol, location, sizeof(location));
+                DataType kind = float_kind(param_symbol->type);
+                if (kind != TYPE_INT && num_float_regs < 8)
+                {
+                    emit(gen, "    mov%s %%xmm%d, %s  # Save parameter '%s'", sse_suffix(kind), num_float_regs++,
+                         location, param_name);
+                }
+                else if (kind == TYPE_INT && num_int_regs < 6)
+                {
+                    gen_store(gen, param_symbol->type, param_regs[num_int_regs++], location);
+                }
+                else
                 {
-                    int offset = -(param_symbol->offset + 8);
-                    emit(gen, "    movq %%%s, %d(%%rbp)  # Save parameter '%s'",
-                         param_regs[i], offset, param_name);
+                    emit(gen, "    movq %d(%%rbp), %%rax  # Stack parameter '%s'", stack_offset, param_name);
+                    gen_store(gen, param_symbol->type, "rax", location);
+                    stack_offset += 8;
                 }
             }
         }
@@ -2043,10 +2296,95 @@ void gen_function(CodeGenerator *gen, ASTNode *node)
 
     // 生成尾声
     gen_epilogue(gen);
+    flush_output(gen);
+}
+
+// 生成函数代码
+void gen_function(CodeGenerator *gen, ASTNode *node)
+{
+    if (!node || node->type != AST_FUNCTION_DEF)
+        return;
+    if (node->num_children < 3)
+        return;
+
+    // 优先走 IR + 寄存器分配
+    IrFunction *ir_func = ir_lower_function(gen, node);
+    if (ir_func)
+        gen_ir_function(gen, ir_func);
+    else
+        gen_stack_function(gen, node);
+}
+
+static int unit_new_label(void *ctx)
+{
+    return new_label((CodeGenerator *)ctx);
+}
+
+// 先把本单元的函数全部降低为 IR，内联并运行各函数的 IR 遍，
+// 删除没有被引用的 static 函数和变量（first_symbol 起是本单元的变量）之后再按源码顺序逐个输出
+static void gen_unit_functions(CodeGenerator *gen, ASTNode *root, int first_symbol)
+{
+    int count = root->num_children;
+    int num_vars = gen->num_data_symbols - first_symbol;
+    IrFunction **funcs = (IrFunction **)calloc(count ? count : 1, sizeof(IrFunction *));
+    char *live_funcs = (char *)calloc(count ? count : 1, 1);
+    char *live_vars = (char *)calloc(num_vars ? num_vars : 1, 1);
+    if (!funcs || !live_funcs || !live_vars)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < count; i++)
+    {
+        ASTNode *child = root->children[i];
+        if (child->type == AST_FUNCTION_DEF && child->num_children >= 3)
+            funcs[i] = ir_lower_function(gen, child);
+    }
+
+    pass_manager_inline(gen->passes, funcs, count, unit_new_label, gen);
+    for (int i = 0; i < count; i++)
+    {
+        if (funcs[i])
+            pass_manager_run_ir(gen->passes, funcs[i]);
+    }
+
+    pass_manager_dce_unit(gen->passes, root, funcs, gen->data_symbols + first_symbol, num_vars, live_funcs,
+                          live_vars);
+    int kept = first_symbol;
+    for (int k = 0; k < num_vars; k++)
+    {
+        if (live_vars[k])
+            gen->data_symbols[kept++] = gen->data_symbols[first_symbol + k];
+    }
+    gen->num_data_symbols = kept;
+
+    for (int i = 0; i < count; i++)
+    {
+        ASTNode *child = root->children[i];
+        if (!live_funcs[i])
+        {
+            if (gen->ir_dump)
+                fprintf(gen->ir_dump, "function %s: removed (unreferenced static function)\n\n",
+                        ((Symbol *)child->children[1]->semantic_info)->label);
+            if (funcs[i])
+                ir_function_free(funcs[i]);
+        }
+        else if (funcs[i])
+        {
+            emit_ir_function(gen, funcs[i]);
+        }
+        else if (child->type == AST_FUNCTION_DEF && child->num_children >= 3)
+        {
+            gen_stack_function(gen, child);
+        }
+    }
+    free(funcs);
+    free(live_funcs);
+    free(live_vars);
 }
 
-// 收集全局/静态变量
-static void collect_global_symbols(ASTNode *node, Symbol ***vars, int *count, int *capacity)
+// 收集全局/静态变量（extern 变量在其他文件中定义）
+static void collect_global_symbols(CodeGenerator *gen, ASTNode *node)
 {
     if (!node)
         return;
@@ -2065,88 +2403,351 @@ static void collect_global_symbols(ASTNode *node, Symbol ***vars, int *count, in
             symbol = (Symbol *)declarator->semantic_info;
         }
 
-        if (symbol && (symbol->is_global || symbol->is_static))
+        if (symbol && symbol->label && (symbol->is_global || symbol->is_static) &&
+            !symbol->is_extern)
         {
-            if (*count >= *capacity)
+            if (gen->num_data_symbols >= gen->data_capacity)
             {
-                *capacity *= 2;
-                *vars = realloc(*vars, (*capacity) * sizeof(Symbol *));
+                gen->data_capacity = gen->data_capacity ? gen->data_capacity * 2 : 16;
+                gen->data_symbols = (Symbol **)realloc(gen->data_symbols,
+                                                       gen->data_capacity * sizeof(Symbol *));
+                if (!gen->data_symbols)
+                {
+                    fprintf(stderr, "Error: Failed to allocate memory for global variables\n");
+                    exit(1);
+                }
             }
-            (*vars)[(*count)++] = symbol;
+            gen->data_symbols[gen->num_data_symbols++] = symbol;
         }
     }
 
     for (int i = 0; i < node->num_children; i++)
     {
-        collect_global_symbols(node->children[i], vars, count, capacity);
+        collect_global_symbols(gen, node->children[i]);
+    }
+}
+
+// 给静态符号的标签加上编译单元编号：count.0 → count.0.u1
+static void rename_static_symbol(CodeGenerator *gen, Symbol *symbol)
+{
+    char label[300];
+    snprintf(label, sizeof(label), "%s.u%d", symbol->label, gen->num_units);
+    free(symbol->label);
+    symbol->label = strdup(label);
+}
+
+// 浮点常量表达式（浮点字面量、整数常量表达式以及它们的取负和四则运算）
+static int float_const_eval(ASTNode *node, double *value)
+{
+    long int_value;
+    double a, b;
+    if (!node)
+        return 0;
+    if (node->type == AST_FLOAT_LITERAL)
+    {
+        *value = node->value.float_val.value;
+        return 1;
+    }
+    if (const_eval(node, &int_value))
+    {
+        *value = (double)int_value;
+        return 1;
+    }
+    if (node->type == AST_UNARY_EXPR && node->value.op_type == OP_NEG && node->num_children > 0)
+    {
+        if (!float_const_eval(node->children[0], &a))
+            return 0;
+        *value = -a;
+        return 1;
+    }
+    if (node->type != AST_BINARY_EXPR || node->num_children < 2 || !float_const_eval(node->children[0], &a) ||
+        !float_const_eval(node->children[1], &b))
+        return 0;
+    switch (node->value.op_type)
+    {
+    case OP_ADD:
+        *value = a + b;
+        break;
+    case OP_SUB:
+        *value = a - b;
+        break;
+    case OP_MUL:
+        *value = a * b;
+        break;
+    case OP_DIV:
+        *value = a / b;
+        break;
+    default:
+        return 0;
+    }
+    // float 运算的结果舍入到 float 精度
+    if (expr_float_kind(node) == TYPE_FLOAT)
+        *value = (float)*value;
+    return 1;
+}
+
+// 数据的宽度对应的伪指令
+static const char *data_directive(int size)
+{
+    switch (size)
+    {
+    case 1:
+        return ".byte";
+    case 2:
+        return ".short";
+    case 4:
+        return ".long";
+    default:
+        return ".quad";
+    }
+}
+
+// 静态对象（或其中元素、成员）的地址：label + offset
+static int static_address(ASTNode *node, const char **label, long *offset)
+{
+    switch (node->type)
+    {
+    case AST_IDENTIFIER:
+    {
+        Symbol *symbol = (Symbol *)node->semantic_info;
+        if (!symbol || !symbol->label || !(symbol->is_global || symbol->is_static))
+            return 0;
+        *label = symbol->label;
+        *offset = 0;
+        return 1;
+    }
+    case AST_ARRAY_SUBSCRIPT:
+    {
+        long index;
+        TypeInfo *type = expr_type(node);
+        if (!type || !type_is_array(expr_type(node->children[0])) || !const_eval(node->children[1], &index) ||
+            !static_address(node->children[0], label, offset))
+            return 0;
+        *offset += index * type_size(type);
+        return 1;
+    }
+    case AST_MEMBER_ACCESS:
+    {
+        StructMember *member = (StructMember *)node->semantic_info;
+        if (!member || node->value.op_type != OP_MEMBER || !static_address(node->children[0], label, offset))
+            return 0;
+        *offset += member->offset;
+        return 1;
+    }
+    default:
+        return 0;
+    }
+}
+
+// 一个标量的初始值：整数常量表达式、浮点常量表达式、字符串字面量，
+// 或者静态对象的地址（&x、数组名、函数名）。value 为 NULL 时为 0
+static void emit_scalar_data(CodeGenerator *gen, TypeInfo *type, ASTNode *value, const char *name)
+{
+    if (is_aggregate(type))
+    {
+        if (value)
+            fprintf(stderr, "Warning: initializer of '%s' is not a constant expression, using 0\n", name);
+        emit(gen, "    .zero %d  # %s", type_size(type), name);
+        return;
+    }
+
+    const char *directive = data_directive(access_size(type));
+    if (value && value->type == AST_STRING_LITERAL)
+    {
+        int label = add_string_constant(gen, value->value.string_val);
+        emit(gen, "    .quad .LC%d  # %s", label, name);
+        return;
+    }
+
+    // &x、&arr[2]、&s.m、数组名和函数名是链接时确定的地址
+    const char *label = NULL;
+    long offset = 0;
+    int is_address = 0;
+    if (value && value->type == AST_UNARY_EXPR && value->value.op_type == OP_ADDR && value->num_children > 0)
+        is_address = static_address(value->children[0], &label, &offset);
+    else if (value && value->type == AST_IDENTIFIER && value->semantic_info)
+    {
+        Symbol *symbol = (Symbol *)value->semantic_info;
+        if (symbol->kind == SYMBOL_FUNCTION)
+        {
+            label = symbol->label ? symbol->label : symbol->name;
+            is_address = 1;
+        }
+        else if (is_aggregate(symbol->type))
+        {
+            is_address = static_address(value, &label, &offset);
+        }
+    }
+    if (is_address)
+    {
+        if (offset)
+            emit(gen, "    .quad %s+%ld  # %s", label, offset, name);
+        else
+            emit(gen, "    .quad %s  # %s", label, name);
+        return;
+    }
+
+    DataType kind = float_kind(type);
+    if (kind != TYPE_INT)
+    {
+        double number = 0;
+        if (value && !float_const_eval(value, &number))
+        {
+            fprintf(stderr, "Warning: initializer of '%s' is not a constant expression, using 0\n", name);
+            number = 0;
+        }
+        if (kind == TYPE_FLOAT)
+        {
+            union
+            {
+                float f;
+                uint32_t bits;
+            } converter;
+            converter.f = (float)number;
+            emit(gen, "    .long %u  # %s = %g", converter.bits, name, converter.f);
+        }
+        else
+        {
+            union
+            {
+                double d;
+                int64_t bits;
+            } converter;
+            converter.d = number;
+            emit(gen, "    .quad %lld  # %s = %g", (long long)converter.bits, name, number);
+        }
+        return;
+    }
+
+    long init_value = 0;
+    if (value && !const_eval(value, &init_value))
+    {
+        fprintf(stderr, "Warning: initializer of '%s' is not a constant expression, using 0\n", name);
+        init_value = 0;
+    }
+    emit(gen, "    %s %ld  # %s", directive, init_value, name);
+}
+
+// 输出初始化列表时的位置：对象中已经输出了 cursor 个字节
+typedef struct DataCursor
+{
+    const char *name;
+    int cursor;
+} DataCursor;
+
+static void emit_data_element(CodeGenerator *gen, TypeInfo *type, int offset, ASTNode *value, void *ctx)
+{
+    DataCursor *data = (DataCursor *)ctx;
+    if (offset > data->cursor)
+        emit(gen, "    .zero %d", offset - data->cursor);
+    emit_scalar_data(gen, type, value, data->name);
+    data->cursor = offset + (is_aggregate(type) ? type_size(type) : access_size(type));
+}
+
+// 静态变量的初始值，没有给出的部分为 0
+static void emit_initial_value(CodeGenerator *gen, Symbol *var)
+{
+    ASTNode *init_expr = NULL;
+    if (var->declaration && var->declaration->num_children >= 2)
+    {
+        ASTNode *declarator = var->declaration->children[1];
+        if (declarator->type == AST_ASSIGN_EXPR && declarator->num_children >= 2)
+        {
+            init_expr = declarator->children[1];
+        }
+    }
+
+    if (!init_expr || init_expr->type != AST_INIT_LIST)
+    {
+        emit_scalar_data(gen, var->type, init_expr, var->name);
+        return;
     }
+
+    DataCursor data;
+    data.name = var->name;
+    data.cursor = 0;
+    walk_initializer_list(gen, var->type, 0, init_expr, emit_data_element, &data);
+    int size = type_size(var->type);
+    if (size > data.cursor)
+        emit(gen, "    .zero %d", size - data.cursor);
 }
 
 // 生成全局/静态变量段
-static void gen_global_data(CodeGenerator *gen, Symbol **vars, int count)
+static void gen_global_data(CodeGenerator *gen)
 {
-    if (count == 0)
+    if (gen->num_data_symbols == 0)
         return;
 
     emit(gen, "");
     emit(gen, "    .data");
     emit(gen, "    # Global and static variables");
 
-    for (int i = 0; i < count; i++)
+    for (int i = 0; i < gen->num_data_symbols; i++)
     {
-        Symbol *var = vars[i];
+        Symbol *var = gen->data_symbols[i];
+        emit(gen, "    .align %d", type_alignment(var->type));
         if (var->is_global)
         {
             emit(gen, "    .globl %s", var->label);
         }
         emit(gen, "%s:", var->label);
-
-        // 从声明节点中获取初始化值
-        long init_value = 0;
-        if (var->declaration && var->declaration->num_children >= 2)
-        {
-            ASTNode *declarator = var->declaration->children[1];
-            if (declarator->type == AST_ASSIGN_EXPR && declarator->num_children >= 2)
-            {
-                ASTNode *init_expr = declarator->children[1];
-                if (init_expr->type == AST_INT_LITERAL)
-                {
-                    init_value = init_expr->value.int_val;
-                }
-            }
-        }
-
-        emit(gen, "    .quad %ld  # %s", init_value, var->name);
+        emit_initial_value(gen, var);
     }
 }
 
-// 生成完整程序代码
-void generate_code(CodeGenerator *gen, ASTNode *root)
+// 输出文件头
+void codegen_begin(CodeGenerator *gen)
+{
+    emit(gen, "    .file \"output.c\"");
+}
+
+// 生成一个编译单元的函数代码，全局变量留到 codegen_finish 统一输出
+void codegen_add_unit(CodeGenerator *gen, SemanticAnalyzer *analyzer, ASTNode *root)
 {
     if (!root || root->type != AST_PROGRAM)
         return;
 
-    // 输出文件头
-    emit(gen, "    .file \"output.c\"");
+    gen->analyzer = analyzer;
+    gen->num_units++;
 
-    // 收集所有全局/静态变量
-    Symbol **global_vars = malloc(16 * sizeof(Symbol *));
-    int var_count = 0;
-    int var_capacity = 16;
+    // 语义分析之后、生成代码之前的 AST 遍
+    pass_manager_run_ast(gen->passes, root);
 
+    // 收集所有全局/静态变量
+    int first_symbol = gen->num_data_symbols;
     for (int i = 0; i < root->num_children; i++)
     {
-        collect_global_symbols(root->children[i], &global_vars, &var_count, &var_capacity);
+        collect_global_symbols(gen, root->children[i]);
     }
 
-    // 生成全局/静态变量段
-    gen_global_data(gen, global_vars, var_count);
-    free(global_vars);
+    // --unity：重命名本单元的静态变量和 static 函数
+    if (gen->rename_statics)
+    {
+        for (int i = first_symbol; i < gen->num_data_symbols; i++)
+        {
+            if (gen->data_symbols[i]->is_static)
+                rename_static_symbol(gen, gen->data_symbols[i]);
+        }
+        for (int i = 0; i < root->num_children; i++)
+        {
+            ASTNode *child = root->children[i];
+            if (child->type != AST_FUNCTION_DEF || child->num_children < 2)
+                continue;
+            Symbol *func_symbol = (Symbol *)child->children[1]->semantic_info;
+            if (func_symbol && func_symbol->is_static && func_symbol->label)
+                rename_static_symbol(gen, func_symbol);
+        }
+    }
 
     emit(gen, "");
     emit(gen, "    .text");
 
     // 遍历所有函数（这会收集字符串常量）
+    if (pass_enabled(gen->passes, PASS_INLINE) || pass_enabled(gen->passes, PASS_DCE))
+    {
+        gen_unit_functions(gen, root, first_symbol);
+        return;
+    }
     for (int i = 0; i < root->num_children; i++)
     {
         if (root->children[i]->type == AST_FUNCTION_DEF)
@@ -2154,6 +2755,13 @@ void generate_code(CodeGenerator *gen, ASTNode *root)
             gen_function(gen, root->children[i]);
         }
     }
+}
+
+// 输出所有单元共用的 .data 和 .rodata 段
+void codegen_finish(CodeGenerator *gen)
+{
+    // 生成全局/静态变量段
+    gen_global_data(gen);
 
     // 在代码生成完毕后输出字符串常量（.rodata段）
     emit(gen, "");
@@ -2162,4 +2770,16 @@ void generate_code(CodeGenerator *gen, ASTNode *root)
     // 输出文件尾
     emit(gen, "");
     emit(gen, "    .section .note.GNU-stack,\"\",@progbits");
+    flush_output(gen);
+}
+
+// 生成完整程序代码
+void generate_code(CodeGenerator *gen, ASTNode *root)
+{
+    if (!root || root->type != AST_PROGRAM)
+        return;
+
+    codegen_begin(gen);
+    codegen_add_unit(gen, gen->analyzer, root);
+    codegen_finish(gen);
 }
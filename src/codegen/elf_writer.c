@@ -0,0 +1,331 @@
+#include "elf_writer.h"
+#include <elf.h>
+#include <stdlib.h>
+#include <string.h>
+
+// 可增长的字节缓冲区
+typedef struct ByteBuffer
+{
+    unsigned char *data;
+    size_t size;
+    size_t capacity;
+} ByteBuffer;
+
+static void buffer_append(ByteBuffer *buf, const void *data, size_t size)
+{
+    if (buf->size + size > buf->capacity)
+    {
+        size_t capacity = buf->capacity ? buf->capacity : 1024;
+        while (capacity < buf->size + size)
+            capacity *= 2;
+        buf->data = (unsigned char *)realloc(buf->data, capacity);
+        if (!buf->data)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+        buf->capacity = capacity;
+    }
+    if (data)
+        memcpy(buf->data + buf->size, data, size);
+    else
+        memset(buf->data + buf->size, 0, size);
+    buf->size += size;
+}
+
+static void buffer_align(ByteBuffer *buf, size_t alignment)
+{
+    if (alignment > 1 && buf->size % alignment)
+        buffer_append(buf, NULL, alignment - buf->size % alignment);
+}
+
+// 字符串表：返回字符串在表中的偏移
+static Elf64_Word strtab_add(ByteBuffer *strtab, const char *name)
+{
+    Elf64_Word offset = (Elf64_Word)strtab->size;
+    buffer_append(strtab, name, strlen(name) + 1);
+    return offset;
+}
+
+// 输出段表项的描述
+typedef struct OutputSection
+{
+    const char *name;
+    Elf64_Word type;
+    Elf64_Xword flags;
+    const void *data;
+    size_t size;
+    Elf64_Xword alignment;
+    Elf64_Word link;
+    Elf64_Word info;
+    Elf64_Xword entry_size;
+} OutputSection;
+
+#define MAX_OUTPUT_SECTIONS 16
+
+int elf_object_to_memory(ObjectCode *obj, unsigned char **data, size_t *size)
+{
+    // ELF 段下标：1 起依次为 .text/.data/.rodata，与 SectionIndex 对应
+    OutputSection sections[MAX_OUTPUT_SECTIONS];
+    int num_sections = 1;
+    memset(sections, 0, sizeof(sections));
+
+    static const Elf64_Xword section_flags[SECTION_COUNT] = {
+        SHF_ALLOC | SHF_EXECINSTR, SHF_ALLOC | SHF_WRITE, SHF_ALLOC};
+    int elf_section[SECTION_COUNT];
+    for (int i = 0; i < SECTION_COUNT; i++)
+    {
+        Section *sec = &obj->sections[i];
+        elf_section[i] = num_sections;
+        OutputSection *out = &sections[num_sections++];
+        out->name = sec->name;
+        out->type = SHT_PROGBITS;
+        out->flags = section_flags[i];
+        out->data = sec->data;
+        out->size = sec->size;
+        out->alignment = sec->alignment;
+    }
+
+    // 空的 .bss 和不可执行栈标记
+    sections[num_sections].name = ".bss";
+    sections[num_sections].type = SHT_NOBITS;
+    sections[num_sections].flags = SHF_ALLOC | SHF_WRITE;
+    sections[num_sections].alignment = 1;
+    num_sections++;
+    sections[num_sections].name = ".note.GNU-stack";
+    sections[num_sections].type = SHT_PROGBITS;
+    sections[num_sections].alignment = 1;
+    num_sections++;
+
+    // ---------- 符号表 ----------
+    ByteBuffer symtab = {NULL, 0, 0};
+    ByteBuffer strtab = {NULL, 0, 0};
+    strtab_add(&strtab, "");
+
+    Elf64_Sym sym;
+    memset(&sym, 0, sizeof(sym));
+    buffer_append(&symtab, &sym, sizeof(sym));
+
+    // 段符号（局部标签的重定位都改为引用段符号）
+    int section_symbol[SECTION_COUNT];
+    int num_elf_symbols = 1;
+    for (int i = 0; i < SECTION_COUNT; i++)
+    {
+        memset(&sym, 0, sizeof(sym));
+        sym.st_info = ELF64_ST_INFO(STB_LOCAL, STT_SECTION);
+        sym.st_shndx = (Elf64_Section)elf_section[i];
+        buffer_append(&symtab, &sym, sizeof(sym));
+        section_symbol[i] = num_elf_symbols++;
+    }
+
+    int *elf_symbol = (int *)malloc(sizeof(int) * (obj->num_symbols + 1));
+    if (!elf_symbol)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    // 先输出局部符号，再输出全局/未定义符号（ELF 要求局部符号在前）
+    Elf64_Word first_global = 0;
+    for (int pass = 0; pass < 2; pass++)
+    {
+        for (int i = 0; i < obj->num_symbols; i++)
+        {
+            AsmSymbol *s = &obj->symbols[i];
+            int is_global = s->is_global || !s->is_defined;
+            if (pass == 0)
+                elf_symbol[i] = -1;
+            if (is_local_label(s->name) || is_global != pass)
+                continue;
+
+            memset(&sym, 0, sizeof(sym));
+            sym.st_name = strtab_add(&strtab, s->name);
+            int type = s->is_function ? STT_FUNC : STT_NOTYPE;
+            sym.st_info = ELF64_ST_INFO(is_global ? STB_GLOBAL : STB_LOCAL, type);
+            sym.st_shndx = s->is_defined ? (Elf64_Section)elf_section[s->section] : SHN_UNDEF;
+            sym.st_value = s->is_defined ? s->offset : 0;
+            buffer_append(&symtab, &sym, sizeof(sym));
+            elf_symbol[i] = num_elf_symbols++;
+        }
+        if (pass == 0)
+        {
+            // 第一个全局符号的下标记录在 .symtab 的 sh_info 中
+            first_global = (Elf64_Word)num_elf_symbols;
+        }
+    }
+
+    // ---------- 重定位表 ----------
+    ByteBuffer rela[SECTION_COUNT];
+    int symtab_index = num_sections;
+    for (int i = 0; i < SECTION_COUNT; i++)
+    {
+        rela[i].data = NULL;
+        rela[i].size = 0;
+        rela[i].capacity = 0;
+        Section *sec = &obj->sections[i];
+        for (int r = 0; r < sec->num_relocs; r++)
+        {
+            Relocation *rel = &sec->relocs[r];
+            AsmSymbol *s = &obj->symbols[rel->symbol];
+            Elf64_Rela entry;
+            entry.r_offset = rel->offset;
+            entry.r_addend = rel->addend;
+            if (elf_symbol[rel->symbol] >= 0 && (s->is_global || !s->is_defined))
+            {
+                entry.r_info = ELF64_R_INFO(elf_symbol[rel->symbol], rel->type);
+            }
+            else
+            {
+                // 局部符号：引用所在段的段符号，偏移并入加数
+                entry.r_info = ELF64_R_INFO(section_symbol[s->section], rel->type);
+                entry.r_addend += (Elf64_Sxword)s->offset;
+            }
+            buffer_append(&rela[i], &entry, sizeof(entry));
+        }
+    }
+    free(elf_symbol);
+
+    // 重定位段排在符号表之前，先数出它们的个数以确定 .symtab 的下标
+    for (int i = 0; i < SECTION_COUNT; i++)
+    {
+        if (rela[i].size)
+            symtab_index++;
+    }
+
+    static const char *rela_names[SECTION_COUNT] = {".rela.text", ".rela.data", ".rela.rodata"};
+    for (int i = 0; i < SECTION_COUNT; i++)
+    {
+        if (!rela[i].size)
+            continue;
+        OutputSection *out = &sections[num_sections++];
+        out->name = rela_names[i];
+        out->type = SHT_RELA;
+        out->flags = SHF_INFO_LINK;
+        out->data = rela[i].data;
+        out->size = rela[i].size;
+        out->alignment = 8;
+        out->link = (Elf64_Word)symtab_index;
+        out->info = (Elf64_Word)elf_section[i];
+        out->entry_size = sizeof(Elf64_Rela);
+    }
+
+    OutputSection *out = &sections[num_sections++];
+    out->name = ".symtab";
+    out->type = SHT_SYMTAB;
+    out->data = symtab.data;
+    out->size = symtab.size;
+    out->alignment = 8;
+    out->link = (Elf64_Word)(symtab_index + 1);
+    out->info = first_global;
+    out->entry_size = sizeof(Elf64_Sym);
+
+    out = &sections[num_sections++];
+    out->name = ".strtab";
+    out->type = SHT_STRTAB;
+    out->data = strtab.data;
+    out->size = strtab.size;
+    out->alignment = 1;
+
+    // 段名字符串表（最后一个段）
+    ByteBuffer shstrtab = {NULL, 0, 0};
+    strtab_add(&shstrtab, "");
+    Elf64_Word name_offsets[MAX_OUTPUT_SECTIONS];
+    name_offsets[0] = 0;
+    for (int i = 1; i < num_sections; i++)
+        name_offsets[i] = strtab_add(&shstrtab, sections[i].name);
+    int shstrtab_index = num_sections;
+    name_offsets[num_sections] = strtab_add(&shstrtab, ".shstrtab");
+    out = &sections[num_sections++];
+    out->name = ".shstrtab";
+    out->type = SHT_STRTAB;
+    out->data = shstrtab.data;
+    out->size = shstrtab.size;
+    out->alignment = 1;
+
+    // ---------- 文件布局：ELF 头 + 各段数据 + 段表 ----------
+    ByteBuffer file = {NULL, 0, 0};
+    buffer_append(&file, NULL, sizeof(Elf64_Ehdr));
+
+    Elf64_Off offsets[MAX_OUTPUT_SECTIONS];
+    offsets[0] = 0;
+    for (int i = 1; i < num_sections; i++)
+    {
+        if (sections[i].type == SHT_NOBITS)
+        {
+            offsets[i] = file.size;
+            continue;
+        }
+        buffer_align(&file, sections[i].alignment ? sections[i].alignment : 1);
+        offsets[i] = file.size;
+        if (sections[i].size)
+            buffer_append(&file, sections[i].data, sections[i].size);
+    }
+
+    buffer_align(&file, 8);
+    Elf64_Off section_header_offset = file.size;
+    for (int i = 0; i < num_sections; i++)
+    {
+        Elf64_Shdr header;
+        memset(&header, 0, sizeof(header));
+        if (i > 0)
+        {
+            header.sh_name = name_offsets[i];
+            header.sh_type = sections[i].type;
+            header.sh_flags = sections[i].flags;
+            header.sh_offset = offsets[i];
+            header.sh_size = sections[i].size;
+            header.sh_link = sections[i].link;
+            header.sh_info = sections[i].info;
+            header.sh_addralign = sections[i].alignment;
+            header.sh_entsize = sections[i].entry_size;
+        }
+        buffer_append(&file, &header, sizeof(header));
+    }
+
+    Elf64_Ehdr *ehdr = (Elf64_Ehdr *)file.data;
+    memset(ehdr, 0, sizeof(Elf64_Ehdr));
+    memcpy(ehdr->e_ident, ELFMAG, SELFMAG);
+    ehdr->e_ident[EI_CLASS] = ELFCLASS64;
+    ehdr->e_ident[EI_DATA] = ELFDATA2LSB;
+    ehdr->e_ident[EI_VERSION] = EV_CURRENT;
+    ehdr->e_ident[EI_OSABI] = ELFOSABI_SYSV;
+    ehdr->e_type = ET_REL;
+    ehdr->e_machine = EM_X86_64;
+    ehdr->e_version = EV_CURRENT;
+    ehdr->e_shoff = section_header_offset;
+    ehdr->e_ehsize = sizeof(Elf64_Ehdr);
+    ehdr->e_shentsize = sizeof(Elf64_Shdr);
+    ehdr->e_shnum = (Elf64_Half)num_sections;
+    ehdr->e_shstrndx = (Elf64_Half)shstrtab_index;
+
+    for (int i = 0; i < SECTION_COUNT; i++)
+        free(rela[i].data);
+    free(symtab.data);
+    free(strtab.data);
+    free(shstrtab.data);
+
+    *data = file.data;
+    *size = file.size;
+    return 0;
+}
+
+int write_elf_object(ObjectCode *obj, const char *output_file, FILE *diag)
+{
+    unsigned char *data;
+    size_t size;
+    if (elf_object_to_memory(obj, &data, &size) != 0)
+        return 1;
+
+    int result = 0;
+    FILE *fp = fopen(output_file, "wb");
+    if (!fp || fwrite(data, 1, size, fp) != size)
+    {
+        fprintf(diag, "  ✗ Cannot write object file: %s\n", output_file);
+        result = 1;
+    }
+    if (fp && fclose(fp) != 0)
+        result = 1;
+
+    free(data);
+    return result;
+}
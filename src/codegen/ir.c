@@ -0,0 +1,568 @@
+#include "ir.h"
+#include <stdlib.h>
+#include <string.h>
+
+IrFunction *ir_function_create(const char *name, int is_static)
+{
+    IrFunction *func = (IrFunction *)calloc(1, sizeof(IrFunction));
+    if (!func)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    func->name = strdup(name);
+    func->is_static = is_static;
+    func->return_size = 8;
+    return func;
+}
+
+void ir_function_free(IrFunction *func)
+{
+    if (!func)
+        return;
+    for (int i = 0; i < func->num_instrs; i++)
+        free(func->instrs[i].args);
+    for (int i = 0; i < func->num_blocks; i++)
+    {
+        free(func->blocks[i].succs);
+        free(func->blocks[i].preds);
+    }
+    free(func->blocks);
+    free(func->instrs);
+    free(func->name);
+    free(func);
+}
+
+IrOperand ir_none(void)
+{
+    IrOperand operand = {IR_OPERAND_NONE, 0, 0, NULL};
+    return operand;
+}
+
+IrOperand ir_vreg(int vreg)
+{
+    IrOperand operand = {IR_OPERAND_VREG, vreg, 0, NULL};
+    return operand;
+}
+
+IrOperand ir_imm(long value)
+{
+    IrOperand operand = {IR_OPERAND_IMM, value, 0, NULL};
+    return operand;
+}
+
+IrOperand ir_local(int slot, long offset)
+{
+    IrOperand operand = {IR_OPERAND_LOCAL, slot, offset, NULL};
+    return operand;
+}
+
+IrOperand ir_global(const char *name, long offset)
+{
+    IrOperand operand = {IR_OPERAND_GLOBAL, 0, offset, name};
+    return operand;
+}
+
+IrOperand ir_got(const char *name)
+{
+    IrOperand operand = {IR_OPERAND_GOT, 0, 0, name};
+    return operand;
+}
+
+IrOperand ir_string(int label)
+{
+    IrOperand operand = {IR_OPERAND_STRING, label, 0, NULL};
+    return operand;
+}
+
+IrOperand ir_label(int label)
+{
+    IrOperand operand = {IR_OPERAND_LABEL, label, 0, NULL};
+    return operand;
+}
+
+int ir_new_vreg(IrFunction *func)
+{
+    return func->num_vregs++;
+}
+
+int ir_new_label(IrFunction *func)
+{
+    return func->new_label(func->label_ctx);
+}
+
+IrInstr *ir_emit(IrFunction *func, IrOpcode op, IrOperand dst, IrOperand a, IrOperand b)
+{
+    if (func->num_instrs >= func->capacity)
+    {
+        func->capacity = func->capacity ? func->capacity * 2 : 64;
+        func->instrs = (IrInstr *)realloc(func->instrs, func->capacity * sizeof(IrInstr));
+        if (!func->instrs)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    IrInstr *instr = &func->instrs[func->num_instrs++];
+    memset(instr, 0, sizeof(*instr));
+    instr->op = op;
+    instr->size = 8;
+    instr->dst = dst;
+    instr->a = a;
+    instr->b = b;
+    return instr;
+}
+
+int ir_alloc_local(IrFunction *func, int size)
+{
+    // 每个对象按 8 字节对齐，槽号是对象起始地址相对 %rbp 的（负）偏移
+    func->frame_size += (size + 7) & ~7;
+    return func->frame_size;
+}
+
+// 下标变了，控制流图作废
+static void free_blocks(IrFunction *func)
+{
+    for (int i = 0; i < func->num_blocks; i++)
+    {
+        free(func->blocks[i].succs);
+        free(func->blocks[i].preds);
+    }
+    free(func->blocks);
+    func->blocks = NULL;
+    func->num_blocks = 0;
+}
+
+void ir_remove_instrs(IrFunction *func, const char *dead)
+{
+    int count = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (dead[i])
+        {
+            free(func->instrs[i].args);
+            continue;
+        }
+        func->instrs[count++] = func->instrs[i];
+    }
+    func->num_instrs = count;
+    free_blocks(func);
+}
+
+void ir_insert_instrs(IrFunction *func, int pos, const IrInstr *instrs, int count)
+{
+    if (count <= 0)
+        return;
+    if (func->num_instrs + count > func->capacity)
+    {
+        while (func->num_instrs + count > func->capacity)
+            func->capacity = func->capacity ? func->capacity * 2 : 64;
+        func->instrs = (IrInstr *)realloc(func->instrs, func->capacity * sizeof(IrInstr));
+        if (!func->instrs)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    memmove(&func->instrs[pos + count], &func->instrs[pos], (func->num_instrs - pos) * sizeof(IrInstr));
+    memcpy(&func->instrs[pos], instrs, count * sizeof(IrInstr));
+    func->num_instrs += count;
+    free_blocks(func);
+}
+
+int ir_is_int_copy(const IrInstr *instr)
+{
+    return instr->op == IR_MOV || (instr->op == IR_EXT && instr->size == 4 && !instr->is_unsigned);
+}
+
+// ========== 定义和使用 ==========
+
+int ir_instr_def(const IrInstr *instr)
+{
+    switch (instr->op)
+    {
+    case IR_STORE:
+    case IR_JMP:
+    case IR_BR:
+    case IR_SWITCH:
+    case IR_LABEL:
+    case IR_RET:
+        return -1;
+    default:
+        return instr->dst.kind == IR_OPERAND_VREG ? (int)instr->dst.value : -1;
+    }
+}
+
+int ir_instr_uses(IrInstr *instr, IrOperand **uses)
+{
+    int count = 0;
+    switch (instr->op)
+    {
+    case IR_LABEL:
+    case IR_JMP:
+    case IR_PARAM:
+        break;
+    case IR_CALL:
+        for (int i = 0; i < instr->num_args; i++)
+            uses[count++] = &instr->args[i];
+        break;
+    default:
+        if (instr->a.kind != IR_OPERAND_NONE)
+            uses[count++] = &instr->a;
+        if (instr->b.kind != IR_OPERAND_NONE)
+            uses[count++] = &instr->b;
+        break;
+    }
+    return count;
+}
+
+// ========== 控制流图 ==========
+
+static int ends_block(IrOpcode op)
+{
+    return op == IR_JMP || op == IR_BR || op == IR_SWITCH || op == IR_RET;
+}
+
+static void add_pred(IrBlock *block, int pred)
+{
+    block->preds = (int *)realloc(block->preds, (block->num_preds + 1) * sizeof(int));
+    if (!block->preds)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    block->preds[block->num_preds++] = pred;
+}
+
+// 添加后继块（跳转表中重复的目标只算一次）
+static void add_succ(IrBlock *block, int succ)
+{
+    for (int i = 0; i < block->num_succs; i++)
+    {
+        if (block->succs[i] == succ)
+            return;
+    }
+    block->succs = (int *)realloc(block->succs, (block->num_succs + 1) * sizeof(int));
+    if (!block->succs)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    block->succs[block->num_succs++] = succ;
+}
+
+void ir_build_cfg(IrFunction *func)
+{
+    free_blocks(func);
+    if (func->num_instrs == 0)
+        return;
+
+    // 1. 划分：标签开始新块，跳转/返回结束当前块
+    int capacity = 16;
+    func->blocks = (IrBlock *)malloc(capacity * sizeof(IrBlock));
+    if (!func->blocks)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    int start = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        int is_end = i + 1 == func->num_instrs || ends_block(func->instrs[i].op) ||
+                     func->instrs[i + 1].op == IR_LABEL;
+        if (!is_end)
+            continue;
+        if (func->num_blocks >= capacity)
+        {
+            capacity *= 2;
+            func->blocks = (IrBlock *)realloc(func->blocks, capacity * sizeof(IrBlock));
+            if (!func->blocks)
+            {
+                fprintf(stderr, "Out of memory\n");
+                exit(1);
+            }
+        }
+        IrBlock *block = &func->blocks[func->num_blocks++];
+        memset(block, 0, sizeof(*block));
+        block->first = start;
+        block->last = i;
+        start = i + 1;
+    }
+
+    // 2. 标签 → 块
+    long min_label = 0, max_label = -1;
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        IrInstr *first = &func->instrs[func->blocks[b].first];
+        if (first->op != IR_LABEL)
+            continue;
+        if (max_label < min_label || first->a.value < min_label)
+            min_label = first->a.value;
+        if (first->a.value > max_label)
+            max_label = first->a.value;
+    }
+    int num_labels = max_label >= min_label ? (int)(max_label - min_label + 1) : 0;
+    int *label_block = (int *)malloc((num_labels ? num_labels : 1) * sizeof(int));
+    if (!label_block)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < num_labels; i++)
+        label_block[i] = -1;
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        IrInstr *first = &func->instrs[func->blocks[b].first];
+        if (first->op == IR_LABEL)
+            label_block[first->a.value - min_label] = b;
+    }
+
+    // 3. 控制流边
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        IrBlock *block = &func->blocks[b];
+        IrInstr *last = &func->instrs[block->last];
+        long targets[2] = {-1, -1};
+        int falls_through = b + 1 < func->num_blocks;
+        if (last->op == IR_JMP)
+        {
+            targets[0] = last->a.value;
+            falls_through = 0;
+        }
+        else if (last->op == IR_BR)
+        {
+            targets[0] = last->dst.value;
+        }
+        else if (last->op == IR_SWITCH)
+        {
+            targets[0] = last->dst.value;
+            falls_through = 0;
+        }
+        else if (last->op == IR_RET)
+        {
+            falls_through = 0;
+        }
+        if (falls_through)
+            add_succ(block, b + 1);
+        int num_targets = last->op == IR_SWITCH ? last->num_args + 1 : 1;
+        for (int t = 0; t < num_targets; t++)
+        {
+            long target = t == 0 ? targets[0] : last->args[t - 1].value;
+            if (target >= min_label && target <= max_label && label_block[target - min_label] >= 0)
+                add_succ(block, label_block[target - min_label]);
+        }
+    }
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        for (int s = 0; s < func->blocks[b].num_succs; s++)
+            add_pred(&func->blocks[func->blocks[b].succs[s]], b);
+    }
+    free(label_block);
+}
+
+// ========== 文本输出 ==========
+
+// 与 IrOpcode 的顺序一致
+static const char *opcode_names[] = {"mov",  "add",   "sub",   "mul",  "div", "mod", "and",
+                                     "or",   "xor",   "shl",   "sar",  "neg", "not", "ext",
+                                     "eq",   "ne",    "lt",    "le",   "gt",  "ge",  "load", "store",
+                                     "param", "call", "jmp",   "br",   "switch", "label", "ret",
+                                     "vload", "vstore", "vsplat", "vadd", "vsub", "vmul", "vand",
+                                     "vor",  "vxor",  "vmin",  "vmax", "vwiden", "vreduce"};
+
+static void print_operand(FILE *out, IrOperand *operand)
+{
+    switch (operand->kind)
+    {
+    case IR_OPERAND_NONE:
+        break;
+    case IR_OPERAND_VREG:
+        fprintf(out, "v%ld", operand->value);
+        if (operand->offset)
+            fprintf(out, "%+ld", operand->offset);
+        break;
+    case IR_OPERAND_IMM:
+        fprintf(out, "%ld", operand->value);
+        break;
+    case IR_OPERAND_LOCAL:
+        fprintf(out, "&local%ld", operand->value);
+        if (operand->offset)
+            fprintf(out, "%+ld", operand->offset);
+        break;
+    case IR_OPERAND_GLOBAL:
+        fprintf(out, "&%s", operand->name);
+        if (operand->offset)
+            fprintf(out, "%+ld", operand->offset);
+        break;
+    case IR_OPERAND_GOT:
+        fprintf(out, "&%s@GOT", operand->name);
+        break;
+    case IR_OPERAND_STRING:
+        fprintf(out, "&.LC%ld", operand->value);
+        break;
+    case IR_OPERAND_LABEL:
+        fprintf(out, ".L%ld", operand->value);
+        break;
+    case IR_OPERAND_VECTOR:
+        fprintf(out, "vec%ld", operand->value);
+        break;
+    }
+}
+
+// 向量指令的元素类型和个数，例如 vadd.i32x4
+static void print_vector_shape(FILE *out, IrInstr *instr)
+{
+    fprintf(out, ".%c%dx%d", instr->is_unsigned ? 'u' : 'i', instr->size * 8, instr->width / instr->size);
+}
+
+static void print_instr(FILE *out, IrInstr *instr)
+{
+    fprintf(out, "    ");
+    switch (instr->op)
+    {
+    case IR_LABEL:
+        print_operand(out, &instr->a);
+        fprintf(out, ":");
+        break;
+    case IR_JMP:
+        fprintf(out, "jmp ");
+        print_operand(out, &instr->a);
+        break;
+    case IR_BR:
+        fprintf(out, "br %s ", opcode_names[instr->cond]);
+        print_operand(out, &instr->a);
+        fprintf(out, ", ");
+        print_operand(out, &instr->b);
+        fprintf(out, " -> ");
+        print_operand(out, &instr->dst);
+        break;
+    case IR_SWITCH:
+        fprintf(out, "switch ");
+        print_operand(out, &instr->a);
+        fprintf(out, " - ");
+        print_operand(out, &instr->b);
+        fprintf(out, " [");
+        for (int i = 0; i < instr->num_args; i++)
+        {
+            if (i > 0)
+                fprintf(out, ", ");
+            print_operand(out, &instr->args[i]);
+        }
+        fprintf(out, "] else ");
+        print_operand(out, &instr->dst);
+        break;
+    case IR_STORE:
+        fprintf(out, "store%d [", instr->size);
+        print_operand(out, &instr->a);
+        fprintf(out, "], ");
+        print_operand(out, &instr->b);
+        break;
+    case IR_VSTORE:
+        fprintf(out, "vstore");
+        print_vector_shape(out, instr);
+        fprintf(out, " [");
+        print_operand(out, &instr->a);
+        fprintf(out, "], ");
+        print_operand(out, &instr->b);
+        break;
+    case IR_RET:
+        fprintf(out, "ret");
+        if (instr->a.kind != IR_OPERAND_NONE)
+        {
+            fprintf(out, " ");
+            print_operand(out, &instr->a);
+        }
+        break;
+    default:
+        if (instr->dst.kind != IR_OPERAND_NONE)
+        {
+            print_operand(out, &instr->dst);
+            fprintf(out, " = ");
+        }
+        if (instr->op == IR_LOAD)
+        {
+            fprintf(out, "%s%d [", instr->is_unsigned ? "loadu" : "load", instr->size);
+            print_operand(out, &instr->a);
+            fprintf(out, "]");
+        }
+        else if (instr->op == IR_EXT)
+        {
+            fprintf(out, "%s%d ", instr->is_unsigned ? "extu" : "ext", instr->size);
+            print_operand(out, &instr->a);
+        }
+        else if (instr->op == IR_CALL)
+        {
+            fprintf(out, "%s %s(", instr->is_tail ? "tailcall" : "call", instr->a.name);
+            for (int i = 0; i < instr->num_args; i++)
+            {
+                if (i > 0)
+                    fprintf(out, ", ");
+                print_operand(out, &instr->args[i]);
+            }
+            fprintf(out, instr->is_variadic ? ", ...)" : ")");
+        }
+        else if (instr->op == IR_VLOAD)
+        {
+            fprintf(out, "vload");
+            print_vector_shape(out, instr);
+            fprintf(out, " [");
+            print_operand(out, &instr->a);
+            fprintf(out, "]");
+        }
+        else if (instr->op > IR_VLOAD)
+        {
+            fprintf(out, "%s", opcode_names[instr->op]);
+            if (instr->op == IR_VREDUCE)
+                fprintf(out, ".%s", opcode_names[instr->cond]);
+            print_vector_shape(out, instr);
+            fprintf(out, " ");
+            print_operand(out, &instr->a);
+            if (instr->b.kind != IR_OPERAND_NONE)
+            {
+                fprintf(out, ", ");
+                print_operand(out, &instr->b);
+            }
+        }
+        else
+        {
+            fprintf(out, "%s ", opcode_names[instr->op]);
+            print_operand(out, &instr->a);
+            if (instr->b.kind != IR_OPERAND_NONE)
+            {
+                fprintf(out, ", ");
+                print_operand(out, &instr->b);
+            }
+        }
+        break;
+    }
+    fprintf(out, "\n");
+}
+
+void ir_print_function(IrFunction *func, FILE *out)
+{
+    if (!func->blocks)
+        ir_build_cfg(func);
+    fprintf(out, "function %s: %d vregs, %d blocks, %d bytes of locals\n", func->name,
+            func->num_vregs, func->num_blocks, func->frame_size);
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        IrBlock *block = &func->blocks[b];
+        fprintf(out, "  bb%d:", b);
+        if (block->num_preds > 0)
+        {
+            fprintf(out, "  preds");
+            for (int i = 0; i < block->num_preds; i++)
+                fprintf(out, " bb%d", block->preds[i]);
+        }
+        if (block->num_succs > 0)
+        {
+            fprintf(out, "  succs");
+            for (int i = 0; i < block->num_succs; i++)
+                fprintf(out, " bb%d", block->succs[i]);
+        }
+        fprintf(out, "\n");
+        for (int i = block->first; i <= block->last; i++)
+            print_instr(out, &func->instrs[i]);
+    }
+    fprintf(out, "\n");
+}
@@ -0,0 +1,1460 @@
+#include "codegen.h"
+#include "ir.h"
+#include "opt.h"
+#include "switch_lower.h"
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// AST → 三地址中间代码。
+// 标量局部变量和参数（没有被取地址的）直接放在虚拟寄存器中，数组和取过地址的变量
+// 在栈帧中分配对象，通过 LOAD/STORE 访问。
+// 遇到还不支持的结构（浮点、结构体成员、内联汇编等）时放弃，整个函数回退到栈式代码生成。
+
+#define MAX_ARRAY_DIMS 8
+
+// 表达式的类型（只保留代码生成需要的信息）
+typedef struct ValueType
+{
+    DataType base;
+    int pointer_level;
+    int num_dims;
+    int dims[MAX_ARRAY_DIMS]; // C 的书写顺序：int a[2][3] → {2, 3}
+    int narrowed;             // 值已经在类型的取值范围内（变量、加载和调用的结果），运算的结果为 0
+} ValueType;
+
+// 局部变量 → 虚拟寄存器或栈上对象
+typedef struct VarBinding
+{
+    Symbol *symbol;
+    int vreg; // >= 0：值在虚拟寄存器中
+    int slot; // vreg < 0 时为 LOCAL 槽号
+} VarBinding;
+
+// case/default 语句 → 标签
+typedef struct CaseLabel
+{
+    ASTNode *node;
+    int label;
+} CaseLabel;
+
+// 左值：虚拟寄存器中的变量，或者内存地址
+typedef struct LValue
+{
+    int vreg;
+    IrOperand addr;
+    ValueType type;
+} LValue;
+
+typedef struct Lowerer
+{
+    CodeGenerator *gen;
+    IrFunction *func;
+    VarBinding *vars;
+    int num_vars;
+    int var_capacity;
+    Symbol **addressed; // 被取过地址的变量（必须放在内存中）
+    int num_addressed;
+    int addressed_capacity;
+    CaseLabel *cases;
+    int num_cases;
+    int case_capacity;
+    LoopContext *loop; // break/continue 目标
+    ValueType return_type;
+    int failed;        // 遇到不支持的结构
+} Lowerer;
+
+static IrOperand lower_expr(Lowerer *l, ASTNode *node, ValueType *type);
+static void lower_statement(Lowerer *l, ASTNode *node);
+static void lower_branch_false(Lowerer *l, ASTNode *node, int false_label);
+
+static void *grow_array(void *array, int *capacity, size_t element_size)
+{
+    *capacity = *capacity ? *capacity * 2 : 16;
+    array = realloc(array, *capacity * element_size);
+    if (!array)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return array;
+}
+
+static IrOperand fail(Lowerer *l)
+{
+    l->failed = 1;
+    return ir_imm(0);
+}
+
+// ========== 类型 ==========
+
+static void type_from_info(TypeInfo *info, ValueType *type)
+{
+    memset(type, 0, sizeof(*type));
+    if (!info)
+    {
+        type->base = TYPE_INT;
+        return;
+    }
+    type->base = info->base_type;
+    type->pointer_level = info->pointer_level;
+    type->narrowed = 1;
+    if (info->array_dimensions > 0 && info->array_sizes)
+    {
+        // 语义分析按声明符从外到内记录维度，和 C 的书写顺序相反
+        int n = info->array_dimensions < MAX_ARRAY_DIMS ? info->array_dimensions : MAX_ARRAY_DIMS;
+        for (int i = 0; i < n; i++)
+            type->dims[i] = info->array_sizes[n - 1 - i];
+        type->num_dims = n;
+    }
+    else if (info->array_size > 0)
+    {
+        type->dims[0] = info->array_size;
+        type->num_dims = 1;
+    }
+}
+
+static void int_type(ValueType *type)
+{
+    memset(type, 0, sizeof(*type));
+    type->base = TYPE_INT;
+}
+
+static int is_pointer_like(const ValueType *type)
+{
+    return type->num_dims > 0 || type->pointer_level > 0;
+}
+
+// 代码生成支持的标量类型（浮点和结构体暂不支持）
+static int is_supported_type(const ValueType *type)
+{
+    if (type->pointer_level > 0)
+        return 1;
+    switch (type->base)
+    {
+    case TYPE_INT:
+    case TYPE_CHAR:
+    case TYPE_SHORT:
+    case TYPE_LONG:
+    case TYPE_UNSIGNED:
+    case TYPE_VOID:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// 标量在内存中的大小（和语义分析的 type_size 一致），寄存器中的值都是 64 位
+static int scalar_size(const ValueType *type)
+{
+    if (type->pointer_level > 0)
+        return 8;
+    switch (type->base)
+    {
+    case TYPE_CHAR:
+    case TYPE_VOID:
+        return 1;
+    case TYPE_SHORT:
+        return 2;
+    case TYPE_INT:
+    case TYPE_UNSIGNED:
+        return 4;
+    default:
+        return 8;
+    }
+}
+
+// 从内存加载时零扩展的类型
+static int is_unsigned_scalar(const ValueType *type)
+{
+    return type->pointer_level == 0 && type->num_dims == 0 && type->base == TYPE_UNSIGNED;
+}
+
+static int value_size(const ValueType *type)
+{
+    int size = scalar_size(type);
+    for (int i = 0; i < type->num_dims; i++)
+        size *= type->dims[i] > 0 ? type->dims[i] : 1;
+    return size;
+}
+
+// 数组元素或指针指向的类型
+static void pointee_type(const ValueType *type, ValueType *elem)
+{
+    *elem = *type;
+    if (type->num_dims > 0)
+    {
+        for (int i = 1; i < type->num_dims; i++)
+            elem->dims[i - 1] = type->dims[i];
+        elem->num_dims = type->num_dims - 1;
+    }
+    else if (type->pointer_level > 0)
+    {
+        elem->pointer_level--;
+    }
+}
+
+// ========== 变量 ==========
+
+static int is_addressed(Lowerer *l, Symbol *symbol)
+{
+    for (int i = 0; i < l->num_addressed; i++)
+    {
+        if (l->addressed[i] == symbol)
+            return 1;
+    }
+    return 0;
+}
+
+// 找出所有被取地址的变量
+static void collect_addressed(Lowerer *l, ASTNode *node)
+{
+    if (!node)
+        return;
+    if (node->type == AST_UNARY_EXPR && node->value.op_type == OP_ADDR && node->num_children > 0 &&
+        node->children[0]->type == AST_IDENTIFIER && node->children[0]->semantic_info)
+    {
+        Symbol *symbol = (Symbol *)node->children[0]->semantic_info;
+        if (!is_addressed(l, symbol))
+        {
+            if (l->num_addressed >= l->addressed_capacity)
+                l->addressed = (Symbol **)grow_array(l->addressed, &l->addressed_capacity,
+                                                     sizeof(Symbol *));
+            l->addressed[l->num_addressed++] = symbol;
+        }
+    }
+    for (int i = 0; i < node->num_children; i++)
+        collect_addressed(l, node->children[i]);
+}
+
+static int is_static_storage(Symbol *symbol)
+{
+    return symbol->label && (symbol->is_global || symbol->is_static);
+}
+
+// 局部变量的位置，第一次遇到时分配
+static VarBinding *bind_variable(Lowerer *l, Symbol *symbol)
+{
+    for (int i = 0; i < l->num_vars; i++)
+    {
+        if (l->vars[i].symbol == symbol)
+            return &l->vars[i];
+    }
+
+    ValueType type;
+    type_from_info(symbol->type, &type);
+    if (l->num_vars >= l->var_capacity)
+        l->vars = (VarBinding *)grow_array(l->vars, &l->var_capacity, sizeof(VarBinding));
+    VarBinding *binding = &l->vars[l->num_vars++];
+    binding->symbol = symbol;
+    if (type.num_dims > 0 || is_addressed(l, symbol))
+    {
+        binding->vreg = -1;
+        binding->slot = ir_alloc_local(l->func, value_size(&type));
+    }
+    else
+    {
+        binding->vreg = ir_new_vreg(l->func);
+        binding->slot = 0;
+    }
+    return binding;
+}
+
+// ========== 指令辅助 ==========
+
+static IrOperand emit_binary(Lowerer *l, IrOpcode op, IrOperand a, IrOperand b)
+{
+    IrOperand dst = ir_vreg(ir_new_vreg(l->func));
+    ir_emit(l->func, op, dst, a, b);
+    return dst;
+}
+
+// 把地址类操作数（LOCAL/GLOBAL/STRING）放进虚拟寄存器
+static IrOperand materialize(Lowerer *l, IrOperand operand)
+{
+    if (operand.kind == IR_OPERAND_VREG && operand.offset == 0)
+        return operand;
+    if (operand.kind == IR_OPERAND_VREG)
+    {
+        IrOperand base = operand;
+        base.offset = 0;
+        return emit_binary(l, IR_ADD, base, ir_imm(operand.offset));
+    }
+    if (operand.kind == IR_OPERAND_IMM)
+        return operand;
+    IrOperand dst = ir_vreg(ir_new_vreg(l->func));
+    ir_emit(l->func, IR_MOV, dst, operand, ir_none());
+    return dst;
+}
+
+static IrOperand emit_load(Lowerer *l, IrOperand addr, const ValueType *type)
+{
+    IrOperand dst = ir_vreg(ir_new_vreg(l->func));
+    IrInstr *instr = ir_emit(l->func, IR_LOAD, dst, addr, ir_none());
+    instr->size = scalar_size(type);
+    instr->is_unsigned = is_unsigned_scalar(type);
+    return dst;
+}
+
+static void emit_store(Lowerer *l, IrOperand addr, IrOperand value, int size)
+{
+    IrInstr *instr = ir_emit(l->func, IR_STORE, ir_none(), addr, value);
+    instr->size = size;
+}
+
+static void emit_label(Lowerer *l, int label)
+{
+    ir_emit(l->func, IR_LABEL, ir_none(), ir_label(label), ir_none());
+}
+
+static void emit_jump(Lowerer *l, int label)
+{
+    ir_emit(l->func, IR_JMP, ir_none(), ir_label(label), ir_none());
+}
+
+static void emit_branch(Lowerer *l, IrOpcode cond, IrOperand a, IrOperand b, int label)
+{
+    IrInstr *instr = ir_emit(l->func, IR_BR, ir_label(label), a, b);
+    instr->cond = cond;
+}
+
+// 地址 + index * scale
+static IrOperand offset_address(Lowerer *l, IrOperand addr, IrOperand index, int scale)
+{
+    if (index.kind == IR_OPERAND_IMM)
+    {
+        addr.offset += index.value * scale;
+        return addr;
+    }
+    IrOperand scaled = index;
+    if (scale != 1)
+        scaled = emit_binary(l, IR_MUL, index, ir_imm(scale));
+    IrOperand base = materialize(l, addr);
+    return emit_binary(l, IR_ADD, base, scaled);
+}
+
+// 指针 ± 整数时按元素大小缩放
+static IrOperand scale_index(Lowerer *l, IrOperand index, int scale)
+{
+    if (scale == 1)
+        return index;
+    if (index.kind == IR_OPERAND_IMM)
+        return ir_imm(index.value * scale);
+    return emit_binary(l, IR_MUL, index, ir_imm(scale));
+}
+
+// ========== 左值 ==========
+
+static int lower_lvalue(Lowerer *l, ASTNode *node, LValue *lv);
+
+// 数组/指针表达式的基地址（数组名和多维数组的中间结果不需要加载）
+static IrOperand lower_base_address(Lowerer *l, ASTNode *node, ValueType *type)
+{
+    if (node->type == AST_IDENTIFIER || node->type == AST_ARRAY_SUBSCRIPT)
+    {
+        LValue lv;
+        if (!lower_lvalue(l, node, &lv))
+            return fail(l);
+        *type = lv.type;
+        if (lv.vreg >= 0)
+            return ir_vreg(lv.vreg);
+        if (lv.type.num_dims > 0)
+            return lv.addr;
+        return emit_load(l, lv.addr, &lv.type);
+    }
+    IrOperand value = lower_expr(l, node, type);
+    return value;
+}
+
+static int lower_lvalue(Lowerer *l, ASTNode *node, LValue *lv)
+{
+    lv->vreg = -1;
+    lv->addr = ir_none();
+    int_type(&lv->type);
+
+    switch (node->type)
+    {
+    case AST_IDENTIFIER:
+    case AST_DECLARATOR:
+    {
+        Symbol *symbol = (Symbol *)node->semantic_info;
+        if (!symbol || symbol->kind == SYMBOL_FUNCTION || symbol->kind == SYMBOL_TYPEDEF)
+            return 0;
+        type_from_info(symbol->type, &lv->type);
+        if (!is_supported_type(&lv->type))
+            return 0;
+        if (symbol->is_extern && symbol->label)
+        {
+            // 在别处定义的对象可能离代码超过 ±2GB（例如 JIT 中宿主进程的 stdout），
+            // 从 GOT 表项读取它的地址
+            lv->addr = ir_vreg(ir_new_vreg(l->func));
+            IrInstr *instr = ir_emit(l->func, IR_LOAD, lv->addr, ir_got(symbol->label), ir_none());
+            instr->size = 8;
+            return 1;
+        }
+        if (is_static_storage(symbol))
+        {
+            lv->addr = ir_global(symbol->label, 0);
+            return 1;
+        }
+        if (symbol->scope_level == 0)
+            return 0; // 没有分配存储的全局对象（例如全局数组）
+        VarBinding *binding = bind_variable(l, symbol);
+        if (binding->vreg >= 0)
+            lv->vreg = binding->vreg;
+        else
+            lv->addr = ir_local(binding->slot, 0);
+        return 1;
+    }
+
+    case AST_ARRAY_SUBSCRIPT:
+    {
+        if (node->num_children < 2)
+            return 0;
+        ValueType base_type;
+        IrOperand base = lower_base_address(l, node->children[0], &base_type);
+        if (l->failed || !is_pointer_like(&base_type))
+            return 0;
+        ValueType index_type;
+        IrOperand index = lower_expr(l, node->children[1], &index_type);
+        pointee_type(&base_type, &lv->type);
+        lv->addr = offset_address(l, base, index, value_size(&lv->type));
+        return 1;
+    }
+
+    case AST_UNARY_EXPR:
+    {
+        if (node->value.op_type != OP_DEREF || node->num_children < 1)
+            return 0;
+        ValueType pointer_type;
+        IrOperand pointer = lower_expr(l, node->children[0], &pointer_type);
+        if (l->failed || !is_pointer_like(&pointer_type))
+            return 0;
+        pointee_type(&pointer_type, &lv->type);
+        lv->addr = pointer;
+        return 1;
+    }
+
+    default:
+        return 0;
+    }
+}
+
+static IrOperand load_lvalue(Lowerer *l, LValue *lv)
+{
+    if (lv->vreg >= 0)
+        return ir_vreg(lv->vreg);
+    if (lv->type.num_dims > 0)
+        return materialize(l, lv->addr); // 数组退化为首元素地址
+    return emit_load(l, lv->addr, &lv->type);
+}
+
+// 常量按类型截断
+static long truncate_constant(long value, int size, int is_unsigned)
+{
+    int bits = size * 8;
+    unsigned long mask = (1UL << bits) - 1;
+    unsigned long low = (unsigned long)value & mask;
+    if (!is_unsigned && (low >> (bits - 1)))
+        low |= ~mask;
+    return (long)low;
+}
+
+// 寄存器中的值都是 64 位的，写入不足 8 字节的整数变量时只保留低位再扩展（和存入内存再加载一致）。
+// 已经在范围内的值（同样宽度和符号的变量、加载和调用的结果，或者更窄的值）不需要截断
+static IrOperand narrow_value(Lowerer *l, IrOperand value, const ValueType *value_type, IrOperand dst,
+                              const ValueType *type)
+{
+    int size = scalar_size(type);
+    int is_unsigned = is_unsigned_scalar(type);
+    int needs_ext = size < 8 && !is_pointer_like(type);
+    if (needs_ext && value.kind == IR_OPERAND_IMM)
+    {
+        value = ir_imm(truncate_constant(value.value, size, is_unsigned));
+        needs_ext = 0;
+    }
+    if (needs_ext && value_type && value_type->narrowed && !is_pointer_like(value_type))
+    {
+        int value_size = scalar_size(value_type);
+        int value_unsigned = is_unsigned_scalar(value_type);
+        if ((value_size == size && value_unsigned == is_unsigned) ||
+            (value_size < size && (value_unsigned || !is_unsigned)))
+            needs_ext = 0;
+    }
+    if (!needs_ext)
+    {
+        if (dst.kind == IR_OPERAND_NONE)
+            return value;
+        ir_emit(l->func, IR_MOV, dst, value, ir_none());
+        return dst;
+    }
+    if (dst.kind == IR_OPERAND_NONE)
+        dst = ir_vreg(ir_new_vreg(l->func));
+    IrInstr *instr = ir_emit(l->func, IR_EXT, dst, value, ir_none());
+    instr->size = size;
+    instr->is_unsigned = is_unsigned;
+    return dst;
+}
+
+// 写入左值，返回写入后的值（赋值表达式的值）
+static IrOperand store_lvalue(Lowerer *l, LValue *lv, IrOperand value, const ValueType *value_type)
+{
+    if (lv->vreg >= 0)
+        return narrow_value(l, value, value_type, ir_vreg(lv->vreg), &lv->type);
+    emit_store(l, lv->addr, value, scalar_size(&lv->type));
+    return narrow_value(l, value, value_type, ir_none(), &lv->type);
+}
+
+// ========== 表达式 ==========
+
+static IrOpcode binary_opcode(OperatorType op)
+{
+    switch (op)
+    {
+    case OP_ADD:
+    case OP_ADD_ASSIGN:
+        return IR_ADD;
+    case OP_SUB:
+    case OP_SUB_ASSIGN:
+        return IR_SUB;
+    case OP_MUL:
+    case OP_MUL_ASSIGN:
+        return IR_MUL;
+    case OP_DIV:
+    case OP_DIV_ASSIGN:
+        return IR_DIV;
+    case OP_MOD:
+    case OP_MOD_ASSIGN:
+        return IR_MOD;
+    case OP_BIT_AND:
+    case OP_AND_ASSIGN:
+        return IR_AND;
+    case OP_BIT_OR:
+    case OP_OR_ASSIGN:
+        return IR_OR;
+    case OP_BIT_XOR:
+    case OP_XOR_ASSIGN:
+        return IR_XOR;
+    case OP_LEFT_SHIFT:
+    case OP_LEFT_ASSIGN:
+        return IR_SHL;
+    case OP_RIGHT_SHIFT:
+    case OP_RIGHT_ASSIGN:
+        return IR_SAR;
+    case OP_LT:
+        return IR_LT;
+    case OP_GT:
+        return IR_GT;
+    case OP_LE:
+        return IR_LE;
+    case OP_GE:
+        return IR_GE;
+    case OP_EQ:
+        return IR_EQ;
+    case OP_NE:
+        return IR_NE;
+    default:
+        return IR_MOV;
+    }
+}
+
+static int is_comparison(OperatorType op)
+{
+    return op == OP_LT || op == OP_GT || op == OP_LE || op == OP_GE || op == OP_EQ || op == OP_NE;
+}
+
+static IrOpcode negate_condition(IrOpcode cond)
+{
+    switch (cond)
+    {
+    case IR_EQ:
+        return IR_NE;
+    case IR_NE:
+        return IR_EQ;
+    case IR_LT:
+        return IR_GE;
+    case IR_GE:
+        return IR_LT;
+    case IR_GT:
+        return IR_LE;
+    default:
+        return IR_GT; // IR_LE
+    }
+}
+
+// 值在 int 的取值范围内：有符号的 int/short/char 变量或者 int 范围内的常量
+static int fits_int(IrOperand value, const ValueType *type)
+{
+    if (value.kind == IR_OPERAND_IMM)
+        return value.value >= INT_MIN && value.value <= INT_MAX;
+    return type->narrowed && !is_pointer_like(type) && scalar_size(type) <= 4 && !is_unsigned_scalar(type);
+}
+
+// 算术运算（含指针算术），结果类型写入 type
+static IrOperand lower_arithmetic(Lowerer *l, OperatorType op, IrOperand left, ValueType *left_type,
+                                  IrOperand right, ValueType *right_type, ValueType *type)
+{
+    IrOpcode opcode = binary_opcode(op);
+    if (opcode == IR_ADD || opcode == IR_SUB)
+    {
+        ValueType elem;
+        if (is_pointer_like(left_type) && is_pointer_like(right_type) && opcode == IR_SUB)
+        {
+            // 指针 - 指针：相差的元素个数
+            pointee_type(left_type, &elem);
+            IrOperand bytes = emit_binary(l, IR_SUB, left, right);
+            int_type(type);
+            int size = value_size(&elem);
+            return size == 1 ? bytes : emit_binary(l, IR_DIV, bytes, ir_imm(size));
+        }
+        if (is_pointer_like(left_type))
+        {
+            pointee_type(left_type, &elem);
+            *type = *left_type;
+            return emit_binary(l, opcode, left, scale_index(l, right, value_size(&elem)));
+        }
+        if (is_pointer_like(right_type) && opcode == IR_ADD)
+        {
+            pointee_type(right_type, &elem);
+            *type = *right_type;
+            return emit_binary(l, opcode, right, scale_index(l, left, value_size(&elem)));
+        }
+    }
+    int_type(type);
+    // 两个 int 范围内的有符号值的运算结果溢出是未定义行为，可以认为结果在 int 范围内
+    type->narrowed = fits_int(left, left_type) && fits_int(right, right_type);
+    return emit_binary(l, opcode, left, right);
+}
+
+// && || 和比较运算的值：条件为真得 1，否则得 0
+static IrOperand lower_condition_value(Lowerer *l, ASTNode *node)
+{
+    int false_label = new_label(l->gen);
+    int end_label = new_label(l->gen);
+    IrOperand result = ir_vreg(ir_new_vreg(l->func));
+    lower_branch_false(l, node, false_label);
+    ir_emit(l->func, IR_MOV, result, ir_imm(1), ir_none());
+    emit_jump(l, end_label);
+    emit_label(l, false_label);
+    ir_emit(l->func, IR_MOV, result, ir_imm(0), ir_none());
+    emit_label(l, end_label);
+    return result;
+}
+
+static IrOperand lower_assign(Lowerer *l, ASTNode *node, ValueType *type)
+{
+    if (node->num_children < 2)
+        return fail(l);
+
+    LValue lv;
+    if (!lower_lvalue(l, node->children[0], &lv) || lv.type.num_dims > 0)
+        return fail(l);
+    *type = lv.type;
+
+    ValueType rhs_type;
+    if (node->value.op_type == OP_ASSIGN)
+    {
+        IrOperand value = lower_expr(l, node->children[1], &rhs_type);
+        return store_lvalue(l, &lv, value, &rhs_type);
+    }
+
+    // 复合赋值：a op= b 等价于 a = a op b（a 只求值一次）
+    IrOperand old_value = load_lvalue(l, &lv);
+    IrOperand rhs = lower_expr(l, node->children[1], &rhs_type);
+    ValueType result_type;
+    IrOperand value = lower_arithmetic(l, node->value.op_type, old_value, &lv.type, rhs, &rhs_type,
+                                       &result_type);
+    return store_lvalue(l, &lv, value, &result_type);
+}
+
+static IrOperand lower_incdec(Lowerer *l, ASTNode *node, ValueType *type)
+{
+    LValue lv;
+    if (!lower_lvalue(l, node->children[0], &lv) || lv.type.num_dims > 0)
+        return fail(l);
+    *type = lv.type;
+
+    OperatorType op = node->value.op_type;
+    int step = 1;
+    if (lv.type.pointer_level > 0)
+    {
+        ValueType elem;
+        pointee_type(&lv.type, &elem);
+        step = value_size(&elem);
+    }
+    IrOpcode opcode = (op == OP_PREINC || op == OP_POSTINC) ? IR_ADD : IR_SUB;
+
+    IrOperand old_value = load_lvalue(l, &lv);
+    IrOperand result = old_value;
+    if ((op == OP_POSTINC || op == OP_POSTDEC) && lv.vreg >= 0)
+    {
+        // 变量本身马上会被修改，先复制旧值
+        result = ir_vreg(ir_new_vreg(l->func));
+        ir_emit(l->func, IR_MOV, result, old_value, ir_none());
+    }
+    IrOperand new_value = emit_binary(l, opcode, old_value, ir_imm(step));
+    ValueType sum_type;
+    int_type(&sum_type);
+    sum_type.narrowed = lv.type.pointer_level == 0 && fits_int(old_value, &lv.type);
+    new_value = store_lvalue(l, &lv, new_value, &sum_type);
+    return (op == OP_PREINC || op == OP_PREDEC) ? new_value : result;
+}
+
+static IrOperand lower_call(Lowerer *l, ASTNode *node, ValueType *type)
+{
+    ASTNode *func_node = node->children[0];
+    Symbol *func_symbol = (Symbol *)func_node->semantic_info;
+    if (func_node->type != AST_IDENTIFIER || !func_symbol || func_symbol->kind != SYMBOL_FUNCTION)
+        return fail(l);
+
+    TypeInfo *func_type = func_symbol->type;
+    type_from_info(func_type ? func_type->return_type : NULL, type);
+    if (!is_supported_type(type))
+        return fail(l);
+
+    const char *name = func_node->value.string_val;
+    if (func_symbol->is_static && func_symbol->label)
+        name = func_symbol->label;
+
+    int num_args = 0;
+    IrOperand *args = NULL;
+    if (node->num_children > 1 && node->children[1]->type == AST_ARG_LIST)
+    {
+        ASTNode *arg_list = node->children[1];
+        num_args = arg_list->num_children;
+        args = (IrOperand *)malloc((num_args ? num_args : 1) * sizeof(IrOperand));
+        if (!args)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+        // 和栈式代码生成一样从右到左求值
+        for (int i = num_args - 1; i >= 0; i--)
+        {
+            ValueType arg_type;
+            args[i] = lower_expr(l, arg_list->children[i], &arg_type);
+            if (!is_supported_type(&arg_type))
+                l->failed = 1;
+        }
+    }
+
+    IrOperand dst = ir_none();
+    if (type->base != TYPE_VOID || type->pointer_level > 0)
+        dst = ir_vreg(ir_new_vreg(l->func));
+    IrInstr *instr = ir_emit(l->func, IR_CALL, dst, ir_global(name, 0), ir_none());
+    instr->args = args;
+    instr->num_args = num_args;
+    instr->is_variadic = func_type && func_type->is_variadic;
+    // 不足 8 字节的返回值由 ir_x86 在调用之后扩展
+    if (!is_pointer_like(type) && type->base != TYPE_VOID)
+    {
+        instr->size = scalar_size(type);
+        instr->is_unsigned = is_unsigned_scalar(type);
+    }
+    return dst.kind == IR_OPERAND_NONE ? ir_imm(0) : dst;
+}
+
+static IrOperand lower_expr(Lowerer *l, ASTNode *node, ValueType *type)
+{
+    ValueType scratch;
+    if (!type)
+        type = &scratch;
+    int_type(type);
+    if (!node || l->failed)
+        return fail(l);
+
+    switch (node->type)
+    {
+    case AST_INT_LITERAL:
+    case AST_CHAR_LITERAL:
+        return ir_imm(node->value.int_val);
+
+    case AST_STRING_LITERAL:
+    {
+        type->base = TYPE_CHAR;
+        type->pointer_level = 1;
+        int label = add_string_constant(l->gen, node->value.string_val);
+        return materialize(l, ir_string(label));
+    }
+
+    case AST_SIZEOF_EXPR:
+        return ir_imm(const_sizeof(node));
+
+    case AST_IDENTIFIER:
+    {
+        Symbol *symbol = (Symbol *)node->semantic_info;
+        if (!symbol)
+            return fail(l);
+        if (symbol->declaration && symbol->declaration->type == AST_ENUM_CONST)
+            return ir_imm(symbol->declaration->value.int_val);
+        if (symbol->kind == SYMBOL_FUNCTION)
+        {
+            type->pointer_level = 1;
+            return materialize(l, ir_global(symbol->label ? symbol->label : symbol->name, 0));
+        }
+        LValue lv;
+        if (!lower_lvalue(l, node, &lv))
+            return fail(l);
+        *type = lv.type;
+        return load_lvalue(l, &lv);
+    }
+
+    case AST_ARRAY_SUBSCRIPT:
+    {
+        LValue lv;
+        if (!lower_lvalue(l, node, &lv))
+            return fail(l);
+        *type = lv.type;
+        return load_lvalue(l, &lv);
+    }
+
+    case AST_BINARY_EXPR:
+    {
+        if (node->num_children < 2)
+            return fail(l);
+        OperatorType op = node->value.op_type;
+        if (op == OP_AND || op == OP_OR || is_comparison(op))
+        {
+            if (is_comparison(op))
+            {
+                IrOperand left = lower_expr(l, node->children[0], NULL);
+                IrOperand right = lower_expr(l, node->children[1], NULL);
+                return emit_binary(l, binary_opcode(op), left, right);
+            }
+            return lower_condition_value(l, node);
+        }
+        if (op == OP_COMMA)
+        {
+            lower_expr(l, node->children[0], NULL);
+            return lower_expr(l, node->children[1], type);
+        }
+        ValueType left_type, right_type;
+        IrOperand left = lower_expr(l, node->children[0], &left_type);
+        IrOperand right = lower_expr(l, node->children[1], &right_type);
+        return lower_arithmetic(l, op, left, &left_type, right, &right_type, type);
+    }
+
+    case AST_ASSIGN_EXPR:
+        return lower_assign(l, node, type);
+
+    case AST_UNARY_EXPR:
+    {
+        if (node->num_children < 1)
+            return fail(l);
+        OperatorType op = node->value.op_type;
+        switch (op)
+        {
+        case OP_ADDR:
+        {
+            LValue lv;
+            if (!lower_lvalue(l, node->children[0], &lv) || lv.vreg >= 0)
+                return fail(l);
+            *type = lv.type;
+            if (type->num_dims == 0)
+                type->pointer_level++;
+            return materialize(l, lv.addr);
+        }
+        case OP_DEREF:
+        {
+            LValue lv;
+            if (!lower_lvalue(l, node, &lv))
+                return fail(l);
+            *type = lv.type;
+            return load_lvalue(l, &lv);
+        }
+        case OP_PREINC:
+        case OP_PREDEC:
+        case OP_POSTINC:
+        case OP_POSTDEC:
+            return lower_incdec(l, node, type);
+        case OP_NOT:
+        {
+            IrOperand value = lower_expr(l, node->children[0], NULL);
+            return emit_binary(l, IR_EQ, value, ir_imm(0));
+        }
+        case OP_NEG:
+        case OP_BIT_NOT:
+        {
+            IrOperand value = lower_expr(l, node->children[0], type);
+            IrOperand dst = ir_vreg(ir_new_vreg(l->func));
+            ir_emit(l->func, op == OP_NEG ? IR_NEG : IR_NOT, dst, value, ir_none());
+            int_type(type);
+            return dst;
+        }
+        default:
+            return fail(l);
+        }
+    }
+
+    case AST_CALL_EXPR:
+        if (node->num_children < 1)
+            return fail(l);
+        return lower_call(l, node, type);
+
+    case AST_TERNARY_EXPR:
+    {
+        if (node->num_children < 3)
+            return fail(l);
+        int false_label = new_label(l->gen);
+        int end_label = new_label(l->gen);
+        IrOperand result = ir_vreg(ir_new_vreg(l->func));
+        lower_branch_false(l, node->children[0], false_label);
+        IrOperand value = lower_expr(l, node->children[1], type);
+        ir_emit(l->func, IR_MOV, result, value, ir_none());
+        emit_jump(l, end_label);
+        emit_label(l, false_label);
+        value = lower_expr(l, node->children[2], NULL);
+        ir_emit(l->func, IR_MOV, result, value, ir_none());
+        emit_label(l, end_label);
+        return result;
+    }
+
+    default:
+        // 浮点字面量、结构体成员、类型转换等
+        return fail(l);
+    }
+}
+
+// 条件为假时跳转到 false_label，为真时继续执行下一条指令
+static void lower_branch_false(Lowerer *l, ASTNode *node, int false_label)
+{
+    if (node->type == AST_BINARY_EXPR && node->num_children >= 2)
+    {
+        OperatorType op = node->value.op_type;
+        if (op == OP_AND)
+        {
+            lower_branch_false(l, node->children[0], false_label);
+            lower_branch_false(l, node->children[1], false_label);
+            return;
+        }
+        if (op == OP_OR)
+        {
+            int true_label = new_label(l->gen);
+            int next_label = new_label(l->gen);
+            lower_branch_false(l, node->children[0], next_label);
+            emit_jump(l, true_label);
+            emit_label(l, next_label);
+            lower_branch_false(l, node->children[1], false_label);
+            emit_label(l, true_label);
+            return;
+        }
+        if (is_comparison(op))
+        {
+            IrOperand left = lower_expr(l, node->children[0], NULL);
+            IrOperand right = lower_expr(l, node->children[1], NULL);
+            emit_branch(l, negate_condition(binary_opcode(op)), left, right, false_label);
+            return;
+        }
+    }
+    if (node->type == AST_UNARY_EXPR && node->value.op_type == OP_NOT && node->num_children > 0)
+    {
+        // !x 为假 ⇔ x 为真
+        int skip_label = new_label(l->gen);
+        lower_branch_false(l, node->children[0], skip_label);
+        emit_jump(l, false_label);
+        emit_label(l, skip_label);
+        return;
+    }
+    IrOperand value = lower_expr(l, node, NULL);
+    emit_branch(l, IR_EQ, value, ir_imm(0), false_label);
+}
+
+// ========== 语句 ==========
+
+static Symbol *declared_symbol(ASTNode *declarator)
+{
+    if (declarator->type == AST_ASSIGN_EXPR && declarator->num_children > 0)
+        return (Symbol *)declarator->children[0]->semantic_info;
+    return (Symbol *)declarator->semantic_info;
+}
+
+// 初始化列表展开成逐个元素的存储，没有给出的元素补 0
+static void lower_init_list(Lowerer *l, LValue *lv, ASTNode *list)
+{
+    ValueType elem = lv->type;
+    elem.num_dims = 0;
+    int elem_size = scalar_size(&elem);
+    int count = value_size(&lv->type) / elem_size;
+
+    int index = 0;
+    ASTNode **stack[MAX_ARRAY_DIMS + 1];
+    int positions[MAX_ARRAY_DIMS + 1];
+    int sizes[MAX_ARRAY_DIMS + 1];
+    int depth = 0;
+    stack[0] = list->children;
+    sizes[0] = list->num_children;
+    positions[0] = 0;
+    while (depth >= 0)
+    {
+        if (positions[depth] >= sizes[depth])
+        {
+            depth--;
+            continue;
+        }
+        ASTNode *child = stack[depth][positions[depth]++];
+        if (child->type == AST_INIT_LIST)
+        {
+            if (depth + 1 > MAX_ARRAY_DIMS)
+            {
+                l->failed = 1;
+                return;
+            }
+            depth++;
+            stack[depth] = child->children;
+            sizes[depth] = child->num_children;
+            positions[depth] = 0;
+            continue;
+        }
+        if (index >= count)
+            break;
+        IrOperand value = lower_expr(l, child, NULL);
+        IrOperand addr = lv->addr;
+        addr.offset += (long)index * elem_size;
+        emit_store(l, addr, value, elem_size);
+        index++;
+    }
+    for (; index < count; index++)
+    {
+        IrOperand addr = lv->addr;
+        addr.offset += (long)index * elem_size;
+        emit_store(l, addr, ir_imm(0), elem_size);
+    }
+}
+
+static void lower_declaration(Lowerer *l, ASTNode *node)
+{
+    if (node->num_children < 2)
+        return;
+    ASTNode *declarator = node->children[1];
+    Symbol *symbol = declared_symbol(declarator);
+    if (!symbol || symbol->kind != SYMBOL_VARIABLE)
+        return; // 函数原型、typedef 等
+    if (is_static_storage(symbol) || symbol->is_extern)
+        return; // 静态变量在 .data 段中初始化
+
+    LValue lv;
+    ASTNode *target = declarator->type == AST_ASSIGN_EXPR ? declarator->children[0] : declarator;
+    if (!lower_lvalue(l, target, &lv))
+    {
+        l->failed = 1;
+        return;
+    }
+    if (declarator->type != AST_ASSIGN_EXPR || declarator->num_children < 2)
+        return;
+
+    ASTNode *init = declarator->children[1];
+    if (init->type == AST_INIT_LIST)
+    {
+        if (lv.type.num_dims == 0)
+        {
+            l->failed = 1;
+            return;
+        }
+        lower_init_list(l, &lv, init);
+        return;
+    }
+    if (lv.type.num_dims > 0)
+    {
+        l->failed = 1;
+        return;
+    }
+    ValueType init_type;
+    IrOperand value = lower_expr(l, init, &init_type);
+    store_lvalue(l, &lv, value, &init_type);
+}
+
+static int case_label(Lowerer *l, ASTNode *node)
+{
+    for (int i = 0; i < l->num_cases; i++)
+    {
+        if (l->cases[i].node == node)
+            return l->cases[i].label;
+    }
+    return -1;
+}
+
+// 一个 switch 的所有 case 值
+typedef struct CaseValues
+{
+    SwitchCase *cases;
+    int num_cases;
+    int capacity;
+} CaseValues;
+
+// 为 switch 体中的 case/default 分配标签并收集 case 值（不进入内层 switch）
+static void collect_cases(Lowerer *l, ASTNode *node, CaseValues *values, int *default_label)
+{
+    if (!node || node->type == AST_SWITCH_STMT)
+        return;
+    if (node->type == AST_CASE_STMT || node->type == AST_DEFAULT_STMT)
+    {
+        if (l->num_cases >= l->case_capacity)
+            l->cases = (CaseLabel *)grow_array(l->cases, &l->case_capacity, sizeof(CaseLabel));
+        int label = new_label(l->gen);
+        l->cases[l->num_cases].node = node;
+        l->cases[l->num_cases].label = label;
+        l->num_cases++;
+        if (node->type == AST_DEFAULT_STMT)
+            *default_label = label;
+        else if (node->num_children >= 1)
+        {
+            long value;
+            if (!const_eval(node->children[0], &value))
+            {
+                l->failed = 1; // case 标签必须是整数常量表达式
+                return;
+            }
+            if (values->num_cases >= values->capacity)
+                values->cases = (SwitchCase *)grow_array(values->cases, &values->capacity, sizeof(SwitchCase));
+            values->cases[values->num_cases].value = value;
+            values->cases[values->num_cases].label = label;
+            values->num_cases++;
+        }
+    }
+    for (int i = 0; i < node->num_children; i++)
+        collect_cases(l, node->children[i], values, default_label);
+}
+
+// switch 分派输出为 IR：比较生成 BR，跳转表生成 SWITCH
+typedef struct SwitchLowering
+{
+    Lowerer *l;
+    IrOperand selector;
+} SwitchLowering;
+
+static int switch_new_label(void *ctx)
+{
+    return new_label(((SwitchLowering *)ctx)->l->gen);
+}
+
+static void switch_emit_label(void *ctx, int label)
+{
+    emit_label(((SwitchLowering *)ctx)->l, label);
+}
+
+static void switch_emit_jump(void *ctx, int label)
+{
+    emit_jump(((SwitchLowering *)ctx)->l, label);
+}
+
+static void switch_emit_branch(void *ctx, IrOpcode cond, long value, int label)
+{
+    SwitchLowering *s = (SwitchLowering *)ctx;
+    emit_branch(s->l, cond, s->selector, ir_imm(value), label);
+}
+
+static void switch_emit_table(void *ctx, long low, const int *labels, int num_entries, int default_label)
+{
+    SwitchLowering *s = (SwitchLowering *)ctx;
+    IrInstr *instr = ir_emit(s->l->func, IR_SWITCH, ir_label(default_label), s->selector, ir_imm(low));
+    instr->args = (IrOperand *)malloc(num_entries * sizeof(IrOperand));
+    if (!instr->args)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < num_entries; i++)
+        instr->args[i] = ir_label(labels[i]);
+    instr->num_args = num_entries;
+}
+
+static void lower_switch(Lowerer *l, ASTNode *node)
+{
+    if (node->num_children < 2)
+        return;
+
+    IrOperand value = materialize(l, lower_expr(l, node->children[0], NULL));
+    if (value.kind == IR_OPERAND_IMM)
+    {
+        IrOperand copy = ir_vreg(ir_new_vreg(l->func));
+        ir_emit(l->func, IR_MOV, copy, value, ir_none());
+        value = copy;
+    }
+    int end_label = new_label(l->gen);
+    int default_label = -1;
+
+    CaseValues values = {NULL, 0, 0};
+    collect_cases(l, node->children[1], &values, &default_label);
+    if (l->failed)
+    {
+        free(values.cases);
+        return;
+    }
+    SwitchLowering lowering = {l, value};
+    SwitchTarget target = {&lowering, switch_new_label, switch_emit_label, switch_emit_jump, switch_emit_branch,
+                           switch_emit_table};
+    switch_emit_dispatch(&target, values.cases, values.num_cases, default_label >= 0 ? default_label : end_label);
+    free(values.cases);
+
+    LoopContext ctx;
+    ctx.start_label = -1;
+    ctx.end_label = end_label;
+    ctx.continue_label = l->loop ? l->loop->continue_label : -1;
+    ctx.parent = l->loop;
+    l->loop = &ctx;
+    lower_statement(l, node->children[1]);
+    l->loop = ctx.parent;
+    emit_label(l, end_label);
+}
+
+static void lower_loop_body(Lowerer *l, ASTNode *body, int break_label, int continue_label)
+{
+    LoopContext ctx;
+    ctx.start_label = -1;
+    ctx.end_label = break_label;
+    ctx.continue_label = continue_label;
+    ctx.parent = l->loop;
+    l->loop = &ctx;
+    lower_statement(l, body);
+    l->loop = ctx.parent;
+}
+
+static void lower_statement(Lowerer *l, ASTNode *node)
+{
+    if (!node || l->failed)
+        return;
+
+    switch (node->type)
+    {
+    case AST_DECLARATION:
+        lower_declaration(l, node);
+        break;
+
+    case AST_EXPR_STMT:
+        if (node->num_children > 0)
+            lower_expr(l, node->children[0], NULL);
+        break;
+
+    case AST_COMPOUND_STMT:
+        for (int i = 0; i < node->num_children; i++)
+            lower_statement(l, node->children[i]);
+        break;
+
+    case AST_IF_STMT:
+    {
+        if (node->num_children < 2)
+            break;
+        int else_label = new_label(l->gen);
+        lower_branch_false(l, node->children[0], else_label);
+        lower_statement(l, node->children[1]);
+        if (node->num_children > 2)
+        {
+            int end_label = new_label(l->gen);
+            emit_jump(l, end_label);
+            emit_label(l, else_label);
+            lower_statement(l, node->children[2]);
+            emit_label(l, end_label);
+        }
+        else
+        {
+            emit_label(l, else_label);
+        }
+        break;
+    }
+
+    case AST_WHILE_STMT:
+    {
+        if (node->num_children < 2)
+            break;
+        int start_label = new_label(l->gen);
+        int end_label = new_label(l->gen);
+        emit_label(l, start_label);
+        lower_branch_false(l, node->children[0], end_label);
+        lower_loop_body(l, node->children[1], end_label, start_label);
+        emit_jump(l, start_label);
+        emit_label(l, end_label);
+        break;
+    }
+
+    case AST_DO_WHILE_STMT:
+    {
+        if (node->num_children < 2)
+            break;
+        int start_label = new_label(l->gen);
+        int continue_label = new_label(l->gen);
+        int end_label = new_label(l->gen);
+        emit_label(l, start_label);
+        lower_loop_body(l, node->children[0], end_label, continue_label);
+        emit_label(l, continue_label);
+        lower_branch_false(l, node->children[1], end_label);
+        emit_jump(l, start_label);
+        emit_label(l, end_label);
+        break;
+    }
+
+    case AST_FOR_STMT:
+    {
+        if (node->num_children < 3)
+            break;
+        int start_label = new_label(l->gen);
+        int continue_label = new_label(l->gen);
+        int end_label = new_label(l->gen);
+        lower_statement(l, node->children[0]);
+        emit_label(l, start_label);
+        ASTNode *cond = node->children[1];
+        if (cond && cond->num_children > 0)
+            lower_branch_false(l, cond->children[0], end_label);
+        int body_index = node->num_children == 3 ? 2 : 3;
+        lower_loop_body(l, node->children[body_index], end_label, continue_label);
+        emit_label(l, continue_label);
+        if (node->num_children == 4 && node->children[2])
+            lower_expr(l, node->children[2], NULL);
+        emit_jump(l, start_label);
+        emit_label(l, end_label);
+        break;
+    }
+
+    case AST_RETURN_STMT:
+    {
+        IrOperand value = ir_none();
+        if (node->num_children > 0)
+        {
+            ValueType value_type;
+            value = lower_expr(l, node->children[0], &value_type);
+            if (l->return_type.base != TYPE_VOID)
+                value = narrow_value(l, value, &value_type, ir_none(), &l->return_type);
+        }
+        ir_emit(l->func, IR_RET, ir_none(), value, ir_none());
+        break;
+    }
+
+    case AST_SWITCH_STMT:
+        lower_switch(l, node);
+        break;
+
+    case AST_CASE_STMT:
+        emit_label(l, case_label(l, node));
+        if (node->num_children >= 2)
+            lower_statement(l, node->children[1]);
+        break;
+
+    case AST_DEFAULT_STMT:
+        emit_label(l, case_label(l, node));
+        if (node->num_children >= 1)
+            lower_statement(l, node->children[0]);
+        break;
+
+    case AST_BREAK_STMT:
+        if (!l->loop)
+        {
+            l->failed = 1;
+            break;
+        }
+        emit_jump(l, l->loop->end_label);
+        break;
+
+    case AST_CONTINUE_STMT:
+        if (!l->loop || l->loop->continue_label < 0)
+        {
+            l->failed = 1;
+            break;
+        }
+        emit_jump(l, l->loop->continue_label);
+        break;
+
+    case AST_STRUCT_DEF:
+    case AST_UNION_DEF:
+    case AST_ENUM_DEF:
+    case AST_TYPEDEF:
+        break;
+
+    default:
+        // 内联汇编等
+        l->failed = 1;
+        break;
+    }
+}
+
+// 参数从调用约定的位置取出
+static void lower_parameters(Lowerer *l, ASTNode *declarator)
+{
+    if (declarator->num_children == 0 || declarator->children[0]->type != AST_PARAM_LIST)
+        return;
+    ASTNode *param_list = declarator->children[0];
+    int index = 0;
+    for (int i = 0; i < param_list->num_children; i++)
+    {
+        ASTNode *param = param_list->children[i];
+        if (param->type != AST_DECLARATION || param->num_children < 2)
+            continue; // "..." 或 (void)
+        Symbol *symbol = (Symbol *)param->children[1]->semantic_info;
+        if (!symbol)
+        {
+            l->failed = 1;
+            return;
+        }
+        LValue lv;
+        if (!lower_lvalue(l, param->children[1], &lv) || lv.type.num_dims > 0)
+        {
+            l->failed = 1;
+            return;
+        }
+        IrOperand value = ir_vreg(lv.vreg >= 0 ? lv.vreg : ir_new_vreg(l->func));
+        IrInstr *instr = ir_emit(l->func, IR_PARAM, value, ir_imm(index++), ir_none());
+        // 调用者只保证低位，ir_x86 在入口按参数类型扩展
+        if (!is_pointer_like(&lv.type))
+        {
+            instr->size = scalar_size(&lv.type);
+            instr->is_unsigned = is_unsigned_scalar(&lv.type);
+        }
+        if (lv.vreg < 0)
+            store_lvalue(l, &lv, value, &lv.type);
+    }
+}
+
+static int unit_new_label(void *ctx)
+{
+    return new_label((CodeGenerator *)ctx);
+}
+
+IrFunction *ir_lower_function(CodeGenerator *gen, ASTNode *node)
+{
+    if (!node || node->type != AST_FUNCTION_DEF || node->num_children < 3)
+        return NULL;
+
+    ASTNode *declarator = node->children[1];
+    Symbol *func_symbol = (Symbol *)declarator->semantic_info;
+    if (!func_symbol || declarator->type != AST_DECLARATOR || !declarator->value.string_val)
+        return NULL;
+    int is_static = func_symbol->is_static && func_symbol->label;
+    const char *name = is_static ? func_symbol->label : declarator->value.string_val;
+
+    ValueType return_type;
+    type_from_info(func_symbol->type ? func_symbol->type->return_type : NULL, &return_type);
+    if (!is_supported_type(&return_type))
+        return NULL;
+
+    Lowerer l;
+    memset(&l, 0, sizeof(l));
+    l.gen = gen;
+    l.return_type = return_type;
+    l.func = ir_function_create(name, is_static);
+    l.func->is_inline = func_symbol->is_inline;
+    if (!is_pointer_like(&return_type) && return_type.base != TYPE_VOID)
+        l.func->return_size = scalar_size(&return_type);
+    l.func->new_label = unit_new_label;
+    l.func->label_ctx = gen;
+    collect_addressed(&l, node->children[2]);
+
+    lower_parameters(&l, declarator);
+    lower_statement(&l, node->children[2]);
+    // 函数末尾没有 return 时返回 0（main 的隐式返回值）；void 函数不返回值，
+    // 这样末尾的 f(...); 和 return f(...); 一样是尾调用
+    int num_instrs = l.func->num_instrs;
+    if (num_instrs == 0 || (l.func->instrs[num_instrs - 1].op != IR_RET &&
+                            l.func->instrs[num_instrs - 1].op != IR_JMP))
+    {
+        int is_void = return_type.base == TYPE_VOID && !is_pointer_like(&return_type);
+        ir_emit(l.func, IR_RET, ir_none(), is_void ? ir_none() : ir_imm(0), ir_none());
+    }
+
+    free(l.vars);
+    free(l.addressed);
+    free(l.cases);
+    if (l.failed)
+    {
+        ir_function_free(l.func);
+        return NULL;
+    }
+    return l.func;
+}
@@ -0,0 +1,1041 @@
+#include "codegen.h"
+#include "ir.h"
+#include "regalloc.h"
+#include "switch_lower.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 分配好寄存器的 IR → x86-64 汇编。
+// %rax、%r11 是临时寄存器，%rdx 用于除法，%rcx 用于移位计数。
+// 向量指令的寄存器由 vectorize 直接分配（%xmm0-%xmm12），%xmm13-%xmm15 是临时寄存器。
+//
+// 栈帧布局（相对 %rbp）：
+//   [rbp - frame_size, rbp)                 局部对象（数组、取过地址的变量）
+//   之后每个溢出槽 8 字节
+//   之后保存用到的被调用者保存寄存器
+// 总大小向上取整到 16 字节，保证 call 时栈对齐。大小为 0 的叶子函数不建立栈帧。
+
+#define OPERAND_SIZE 64
+
+static const char *arg_regs[6] = {"rdi", "rsi", "rdx", "rcx", "r8", "r9"};
+
+typedef struct Emitter
+{
+    CodeGenerator *gen;
+    IrFunction *func;
+    RegAllocation *alloc;
+    int return_label;
+    int uses_avx; // 有 32 字节的向量指令：向量指令都用 VEX 编码，调用和返回之前清除 ymm 的高半部分
+    int saved[NUM_CALLEE_SAVED_PREGS]; // 用到的被调用者保存寄存器
+    int num_saved;
+    int save_base;   // 保存区之前的栈帧大小
+    int needs_frame; // 建立了 %rbp 栈帧
+    int return_used; // 有跳到返回标签的 ret
+} Emitter;
+
+static int fits_int32(long value)
+{
+    return value >= -2147483648L && value <= 2147483647L;
+}
+
+static int vreg_register(Emitter *e, IrOperand *operand)
+{
+    if (operand->kind != IR_OPERAND_VREG)
+        return -1;
+    return e->alloc->reg[operand->value];
+}
+
+static int spill_offset(Emitter *e, int vreg)
+{
+    return e->func->frame_size + 8 * (e->alloc->spill_slot[vreg] + 1);
+}
+
+static int is_spilled(Emitter *e, IrOperand *operand)
+{
+    return operand->kind == IR_OPERAND_VREG && e->alloc->reg[operand->value] < 0;
+}
+
+// 值操作数（VREG 或 IMM）的汇编写法
+static const char *value_operand(Emitter *e, IrOperand *operand, char *buffer)
+{
+    if (operand->kind == IR_OPERAND_IMM)
+        snprintf(buffer, OPERAND_SIZE, "$%ld", operand->value);
+    else if (vreg_register(e, operand) >= 0)
+        snprintf(buffer, OPERAND_SIZE, "%%%s", preg_name(vreg_register(e, operand)));
+    else
+        snprintf(buffer, OPERAND_SIZE, "%d(%%rbp)", -spill_offset(e, (int)operand->value));
+    return buffer;
+}
+
+// 地址操作数的内存写法；指针在栈上时先装入 %r11
+static const char *address_operand(Emitter *e, IrOperand *addr, char *buffer)
+{
+    switch (addr->kind)
+    {
+    case IR_OPERAND_LOCAL:
+        snprintf(buffer, OPERAND_SIZE, "%ld(%%rbp)", addr->offset - addr->value);
+        break;
+    case IR_OPERAND_GLOBAL:
+        if (addr->offset)
+            snprintf(buffer, OPERAND_SIZE, "%s+%ld(%%rip)", addr->name, addr->offset);
+        else
+            snprintf(buffer, OPERAND_SIZE, "%s(%%rip)", addr->name);
+        break;
+    case IR_OPERAND_GOT:
+        snprintf(buffer, OPERAND_SIZE, "%s@GOTPCREL(%%rip)", addr->name);
+        break;
+    case IR_OPERAND_STRING:
+        snprintf(buffer, OPERAND_SIZE, ".LC%ld(%%rip)", addr->value);
+        break;
+    default:
+    {
+        int reg = vreg_register(e, addr);
+        if (reg < 0)
+        {
+            emit(e->gen, "    movq %d(%%rbp), %%r11", -spill_offset(e, (int)addr->value));
+            snprintf(buffer, OPERAND_SIZE, "%ld(%%r11)", addr->offset);
+        }
+        else
+        {
+            snprintf(buffer, OPERAND_SIZE, "%ld(%%%s)", addr->offset, preg_name(reg));
+        }
+        break;
+    }
+    }
+    return buffer;
+}
+
+static int is_address_kind(IrOperand *operand)
+{
+    return operand->kind == IR_OPERAND_LOCAL || operand->kind == IR_OPERAND_GLOBAL ||
+           operand->kind == IR_OPERAND_STRING;
+}
+
+// 把值装入指定的寄存器
+static void load_value(Emitter *e, IrOperand *operand, const char *reg)
+{
+    char buffer[OPERAND_SIZE];
+    if (is_address_kind(operand))
+    {
+        emit(e->gen, "    leaq %s, %%%s", address_operand(e, operand, buffer), reg);
+        return;
+    }
+    if (operand->kind == IR_OPERAND_IMM && !fits_int32(operand->value))
+    {
+        emit(e->gen, "    movabsq $%ld, %%%s", operand->value, reg);
+        return;
+    }
+    if (vreg_register(e, operand) >= 0 && strcmp(preg_name(vreg_register(e, operand)), reg) == 0)
+        return;
+    emit(e->gen, "    movq %s, %%%s", value_operand(e, operand, buffer), reg);
+}
+
+// 作为源操作数使用：超出 32 位的立即数先装入 %r11
+static const char *source_operand(Emitter *e, IrOperand *operand, char *buffer)
+{
+    if (operand->kind == IR_OPERAND_IMM && !fits_int32(operand->value))
+    {
+        load_value(e, operand, "r11");
+        snprintf(buffer, OPERAND_SIZE, "%%r11");
+        return buffer;
+    }
+    return value_operand(e, operand, buffer);
+}
+
+// 结果写入的寄存器：dst 在寄存器中就直接用，否则先写到 %rax
+static const char *result_register(Emitter *e, IrOperand *dst)
+{
+    int reg = vreg_register(e, dst);
+    return reg >= 0 ? preg_name(reg) : "rax";
+}
+
+static void store_result(Emitter *e, IrOperand *dst, const char *reg)
+{
+    if (dst->kind != IR_OPERAND_VREG)
+        return;
+    int dst_reg = vreg_register(e, dst);
+    if (dst_reg >= 0 && strcmp(preg_name(dst_reg), reg) == 0)
+        return;
+    char buffer[OPERAND_SIZE];
+    emit(e->gen, "    movq %%%s, %s", reg, value_operand(e, dst, buffer));
+}
+
+// dst = a
+static void emit_move(Emitter *e, IrOperand *dst, IrOperand *src)
+{
+    char buffer[OPERAND_SIZE];
+    char dst_buffer[OPERAND_SIZE];
+    if (dst->kind != IR_OPERAND_VREG)
+        return;
+    if (src->kind == IR_OPERAND_VREG && src->value == dst->value)
+        return;
+    if (vreg_register(e, dst) >= 0)
+    {
+        load_value(e, src, preg_name(vreg_register(e, dst)));
+        return;
+    }
+    if ((src->kind == IR_OPERAND_IMM && fits_int32(src->value)) || vreg_register(e, src) >= 0)
+    {
+        emit(e->gen, "    movq %s, %s", value_operand(e, src, buffer), value_operand(e, dst, dst_buffer));
+        return;
+    }
+    load_value(e, src, "rax");
+    store_result(e, dst, "rax");
+}
+
+static const char *binary_mnemonic(IrOpcode op)
+{
+    switch (op)
+    {
+    case IR_ADD:
+        return "addq";
+    case IR_SUB:
+        return "subq";
+    case IR_MUL:
+        return "imulq";
+    case IR_AND:
+        return "andq";
+    case IR_OR:
+        return "orq";
+    case IR_XOR:
+        return "xorq";
+    case IR_SHL:
+        return "salq";
+    default:
+        return "sarq";
+    }
+}
+
+static const char *condition_suffix(IrOpcode cond)
+{
+    switch (cond)
+    {
+    case IR_EQ:
+        return "e";
+    case IR_NE:
+        return "ne";
+    case IR_LT:
+        return "l";
+    case IR_LE:
+        return "le";
+    case IR_GT:
+        return "g";
+    default:
+        return "ge";
+    }
+}
+
+// dst = a op b（双地址指令：先把 a 复制到结果寄存器）
+static void emit_binary(Emitter *e, IrInstr *instr)
+{
+    char buffer[OPERAND_SIZE];
+    const char *reg = result_register(e, &instr->dst);
+    // 结果寄存器就是 b 所在的寄存器时，复制 a 会覆盖 b
+    if (vreg_register(e, &instr->b) >= 0 && strcmp(preg_name(vreg_register(e, &instr->b)), reg) == 0 &&
+        !(instr->a.kind == IR_OPERAND_VREG && instr->a.value == instr->b.value))
+        reg = "rax";
+
+    if (instr->op == IR_SHL || instr->op == IR_SAR)
+    {
+        load_value(e, &instr->a, reg);
+        if (instr->b.kind == IR_OPERAND_IMM)
+            emit(e->gen, "    %s $%ld, %%%s", binary_mnemonic(instr->op), instr->b.value & 63, reg);
+        else
+        {
+            load_value(e, &instr->b, "rcx");
+            emit(e->gen, "    %s %%cl, %%%s", binary_mnemonic(instr->op), reg);
+        }
+        store_result(e, &instr->dst, reg);
+        return;
+    }
+
+    const char *source;
+    if (instr->b.kind == IR_OPERAND_IMM && !fits_int32(instr->b.value))
+        source = source_operand(e, &instr->b, buffer);
+    else
+        source = value_operand(e, &instr->b, buffer);
+    load_value(e, &instr->a, reg);
+    emit(e->gen, "    %s %s, %%%s", binary_mnemonic(instr->op), source, reg);
+    store_result(e, &instr->dst, reg);
+}
+
+static void emit_divide(Emitter *e, IrInstr *instr)
+{
+    char buffer[OPERAND_SIZE];
+    load_value(e, &instr->a, "rax");
+    emit(e->gen, "    cqto");
+    if (instr->b.kind == IR_OPERAND_IMM)
+    {
+        load_value(e, &instr->b, "r11");
+        emit(e->gen, "    idivq %%r11");
+    }
+    else
+    {
+        emit(e->gen, "    idivq %s", value_operand(e, &instr->b, buffer));
+    }
+    store_result(e, &instr->dst, instr->op == IR_DIV ? "rax" : "rdx");
+}
+
+// cmpq b, a（a 不能是立即数，两个操作数不能都在内存中）
+static void emit_compare(Emitter *e, IrOperand *a, IrOperand *b)
+{
+    char left_buffer[OPERAND_SIZE];
+    char right_buffer[OPERAND_SIZE];
+    const char *left;
+    if (a->kind == IR_OPERAND_IMM || (is_spilled(e, a) && is_spilled(e, b)))
+    {
+        load_value(e, a, "rax");
+        left = "%rax";
+    }
+    else
+    {
+        left = value_operand(e, a, left_buffer);
+    }
+    const char *right = source_operand(e, b, right_buffer);
+    emit(e->gen, "    cmpq %s, %s", right, left);
+}
+
+static void emit_load(Emitter *e, IrInstr *instr)
+{
+    char buffer[OPERAND_SIZE];
+    const char *reg = result_register(e, &instr->dst);
+    const char *addr = address_operand(e, &instr->a, buffer);
+    int r = vreg_register(e, &instr->dst);
+    switch (instr->size)
+    {
+    case 1:
+        emit(e->gen, "    %s %s, %%%s", instr->is_unsigned ? "movzbq" : "movsbq", addr, reg);
+        break;
+    case 2:
+        emit(e->gen, "    %s %s, %%%s", instr->is_unsigned ? "movzwq" : "movswq", addr, reg);
+        break;
+    case 4:
+        // 写 32 位寄存器会把高 32 位清零
+        if (instr->is_unsigned)
+            emit(e->gen, "    movl %s, %%%s", addr, r >= 0 ? preg_name32(r) : "eax");
+        else
+            emit(e->gen, "    movslq %s, %%%s", addr, reg);
+        break;
+    default:
+        emit(e->gen, "    movq %s, %%%s", addr, reg);
+        break;
+    }
+    store_result(e, &instr->dst, reg);
+}
+
+// 寄存器中对应访问宽度的部分
+static const char *sized_register(int reg, int size)
+{
+    switch (size)
+    {
+    case 1:
+        return preg_name8(reg);
+    case 2:
+        return preg_name16(reg);
+    case 4:
+        return preg_name32(reg);
+    default:
+        return preg_name(reg);
+    }
+}
+
+// rax 中对应访问宽度的部分
+static const char *sized_rax(int size)
+{
+    switch (size)
+    {
+    case 1:
+        return "al";
+    case 2:
+        return "ax";
+    case 4:
+        return "eax";
+    default:
+        return "rax";
+    }
+}
+
+// dst = source 的低 size 字节扩展成 64 位（source 是寄存器的对应部分或者内存操作数）
+static void emit_extend(Emitter *e, IrOperand *dst, const char *source, int size, int is_unsigned)
+{
+    const char *reg = result_register(e, dst);
+    int r = vreg_register(e, dst);
+    switch (size)
+    {
+    case 1:
+        emit(e->gen, "    %s %s, %%%s", is_unsigned ? "movzbq" : "movsbq", source, reg);
+        break;
+    case 2:
+        emit(e->gen, "    %s %s, %%%s", is_unsigned ? "movzwq" : "movswq", source, reg);
+        break;
+    default:
+        if (is_unsigned)
+            emit(e->gen, "    movl %s, %%%s", source, r >= 0 ? preg_name32(r) : "eax");
+        else
+            emit(e->gen, "    movslq %s, %%%s", source, reg);
+        break;
+    }
+    store_result(e, dst, reg);
+}
+
+// IR_EXT：寄存器中的值取对应宽度的部分，栈上的值直接读低位（小端）
+static void emit_ext(Emitter *e, IrInstr *instr)
+{
+    char buffer[OPERAND_SIZE];
+    int r = vreg_register(e, &instr->a);
+    if (r >= 0)
+        snprintf(buffer, OPERAND_SIZE, "%%%s", sized_register(r, instr->size));
+    else if (is_spilled(e, &instr->a))
+        value_operand(e, &instr->a, buffer);
+    else
+    {
+        load_value(e, &instr->a, "rax");
+        snprintf(buffer, OPERAND_SIZE, "%%%s", sized_rax(instr->size));
+    }
+    emit_extend(e, &instr->dst, buffer, instr->size, instr->is_unsigned);
+}
+
+static const char *store_mnemonic(int size)
+{
+    switch (size)
+    {
+    case 1:
+        return "movb";
+    case 2:
+        return "movw";
+    case 4:
+        return "movl";
+    default:
+        return "movq";
+    }
+}
+
+static void emit_store(Emitter *e, IrInstr *instr)
+{
+    char value_buffer[OPERAND_SIZE];
+    char addr_buffer[OPERAND_SIZE];
+    const char *value;
+    int reg = vreg_register(e, &instr->b);
+    if (reg >= 0)
+    {
+        snprintf(value_buffer, OPERAND_SIZE, "%%%s", sized_register(reg, instr->size));
+        value = value_buffer;
+    }
+    else if (instr->b.kind == IR_OPERAND_IMM && fits_int32(instr->b.value))
+    {
+        long imm = instr->b.value;
+        if (instr->size == 1)
+            imm = (signed char)imm;
+        else if (instr->size == 2)
+            imm = (short)imm;
+        else if (instr->size == 4)
+            imm = (int)imm;
+        snprintf(value_buffer, OPERAND_SIZE, "$%ld", imm);
+        value = value_buffer;
+    }
+    else
+    {
+        load_value(e, &instr->b, "rax");
+        value = instr->size == 1 ? "%al" : instr->size == 2 ? "%ax" : instr->size == 4 ? "%eax" : "%rax";
+    }
+    const char *addr = address_operand(e, &instr->a, addr_buffer);
+    emit(e->gen, "    %s %s, %s", store_mnemonic(instr->size), value, addr);
+}
+
+// ========== 并行赋值 ==========
+
+// 一组同时发生的 "寄存器 → 寄存器" 赋值：先做目标不再被读取的，
+// 剩下的构成环，借 %r11 打断
+typedef struct RegMove
+{
+    const char *src;
+    const char *dst;
+} RegMove;
+
+static void emit_parallel_moves(Emitter *e, RegMove *moves, int count)
+{
+    int pending = count;
+    while (pending > 0)
+    {
+        int progress = 0;
+        for (int i = 0; i < count; i++)
+        {
+            if (!moves[i].dst)
+                continue;
+            if (strcmp(moves[i].src, moves[i].dst) == 0)
+            {
+                moves[i].dst = NULL;
+                pending--;
+                progress = 1;
+                continue;
+            }
+            int blocked = 0;
+            for (int j = 0; j < count && !blocked; j++)
+            {
+                if (j != i && moves[j].dst && strcmp(moves[j].src, moves[i].dst) == 0)
+                    blocked = 1;
+            }
+            if (!blocked)
+            {
+                emit(e->gen, "    movq %%%s, %%%s", moves[i].src, moves[i].dst);
+                moves[i].dst = NULL;
+                pending--;
+                progress = 1;
+            }
+        }
+        if (!progress)
+        {
+            // 环：把某个目标寄存器的旧值移到 %r11
+            const char *saved = NULL;
+            for (int i = 0; i < count && !saved; i++)
+            {
+                if (moves[i].dst)
+                    saved = moves[i].dst;
+            }
+            emit(e->gen, "    movq %%%s, %%r11", saved);
+            for (int i = 0; i < count; i++)
+            {
+                if (moves[i].dst && strcmp(moves[i].src, saved) == 0)
+                    moves[i].src = "r11";
+            }
+        }
+    }
+}
+
+// 函数入口：把参数从调用约定的位置搬到分配的位置
+static int emit_parameters(Emitter *e)
+{
+    IrFunction *func = e->func;
+    RegMove moves[6];
+    int num_moves = 0;
+    int count = 0;
+    char buffer[OPERAND_SIZE];
+
+    while (count < func->num_instrs && func->instrs[count].op == IR_PARAM)
+        count++;
+
+    // 1. 目标在栈上的寄存器参数（只读寄存器，不影响其他赋值）
+    for (int i = 0; i < count; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        int index = (int)instr->a.value;
+        if (index < 6 && vreg_register(e, &instr->dst) < 0)
+            emit(e->gen, "    movq %%%s, %s", arg_regs[index], value_operand(e, &instr->dst, buffer));
+    }
+    // 2. 寄存器之间的并行赋值
+    for (int i = 0; i < count; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        int index = (int)instr->a.value;
+        int reg = vreg_register(e, &instr->dst);
+        if (index < 6 && reg >= 0)
+        {
+            moves[num_moves].src = arg_regs[index];
+            moves[num_moves].dst = preg_name(reg);
+            num_moves++;
+        }
+    }
+    emit_parallel_moves(e, moves, num_moves);
+    // 3. 通过栈传递的参数
+    for (int i = 0; i < count; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        int index = (int)instr->a.value;
+        if (index < 6)
+            continue;
+        const char *reg = result_register(e, &instr->dst);
+        emit(e->gen, "    movq %d(%%rbp), %%%s", 16 + 8 * (index - 6), reg);
+        store_result(e, &instr->dst, reg);
+    }
+    // 4. 调用者只保证不足 8 字节的参数的低位
+    for (int i = 0; i < count; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        if (instr->size < 8 && instr->dst.kind == IR_OPERAND_VREG)
+        {
+            int reg = vreg_register(e, &instr->dst);
+            if (reg >= 0)
+                snprintf(buffer, OPERAND_SIZE, "%%%s", sized_register(reg, instr->size));
+            else
+                value_operand(e, &instr->dst, buffer);
+            emit_extend(e, &instr->dst, buffer, instr->size, instr->is_unsigned);
+        }
+    }
+    return count;
+}
+
+// 寄存器参数：先做寄存器之间的并行赋值，再装入立即数和栈上的值
+static void emit_register_args(Emitter *e, IrInstr *instr)
+{
+    RegMove moves[6];
+    int num_moves = 0;
+    int num_reg_args = instr->num_args < 6 ? instr->num_args : 6;
+    for (int i = 0; i < num_reg_args; i++)
+    {
+        int reg = vreg_register(e, &instr->args[i]);
+        if (reg >= 0)
+        {
+            moves[num_moves].src = preg_name(reg);
+            moves[num_moves].dst = arg_regs[i];
+            num_moves++;
+        }
+    }
+    emit_parallel_moves(e, moves, num_moves);
+    for (int i = 0; i < num_reg_args; i++)
+    {
+        if (vreg_register(e, &instr->args[i]) < 0)
+            load_value(e, &instr->args[i], arg_regs[i]);
+    }
+}
+
+static void emit_call(Emitter *e, IrInstr *instr)
+{
+    char buffer[OPERAND_SIZE];
+    int num_stack = instr->num_args > 6 ? instr->num_args - 6 : 0;
+
+    // 栈上的参数从右到左压栈，个数为奇数时补 8 字节保持 16 字节对齐
+    if (num_stack % 2)
+        emit(e->gen, "    subq $8, %%rsp");
+    for (int i = instr->num_args - 1; i >= 6; i--)
+    {
+        IrOperand *arg = &instr->args[i];
+        if (arg->kind == IR_OPERAND_IMM && !fits_int32(arg->value))
+        {
+            load_value(e, arg, "r11");
+            emit(e->gen, "    pushq %%r11");
+        }
+        else
+        {
+            emit(e->gen, "    pushq %s", value_operand(e, arg, buffer));
+        }
+    }
+
+    emit_register_args(e, instr);
+
+    // 可变参数函数：%al 是通过向量寄存器传递的参数个数
+    if (instr->is_variadic)
+        emit(e->gen, "    movl $0, %%eax");
+    emit(e->gen, "    call %s", instr->a.name);
+    if (num_stack > 0)
+        emit(e->gen, "    addq $%d, %%rsp", 8 * (num_stack + num_stack % 2));
+    // 不足 8 字节的返回值高位没有定义
+    if (instr->size < 8 && instr->dst.kind == IR_OPERAND_VREG)
+    {
+        snprintf(buffer, OPERAND_SIZE, "%%%s", sized_rax(instr->size));
+        emit_extend(e, &instr->dst, buffer, instr->size, instr->is_unsigned);
+    }
+    else
+        store_result(e, &instr->dst, "rax");
+}
+
+// 函数出口：恢复被调用者保存的寄存器，拆掉栈帧（之后是 ret 或者尾调用的 jmp）
+static void emit_epilogue(Emitter *e)
+{
+    if (e->uses_avx)
+        emit(e->gen, "    vzeroupper");
+    for (int i = 0; i < e->num_saved; i++)
+        emit(e->gen, "    movq %d(%%rbp), %%%s", -(e->save_base + 8 * (i + 1)), preg_name(e->saved[i]));
+    if (e->needs_frame)
+    {
+        emit(e->gen, "    movq %%rbp, %%rsp");
+        emit(e->gen, "    popq %%rbp");
+    }
+}
+
+// 尾调用：参数装入寄存器之后拆掉自己的栈帧，jmp 到被调函数，由它直接返回到调用者
+static void emit_tail_call(Emitter *e, IrInstr *instr)
+{
+    emit_register_args(e, instr);
+    emit_epilogue(e);
+    if (instr->is_variadic)
+        emit(e->gen, "    movl $0, %%eax");
+    emit(e->gen, "    jmp %s", instr->a.name);
+}
+
+// 后面的 ret 由被调函数代劳
+static int is_tail_call(IrFunction *func, int pos)
+{
+    IrInstr *instr = &func->instrs[pos];
+    return instr->op == IR_CALL && instr->is_tail && instr->num_args <= 6 && pos + 1 < func->num_instrs &&
+           func->instrs[pos + 1].op == IR_RET;
+}
+
+static void emit_switch(Emitter *e, IrInstr *instr)
+{
+    int *labels = (int *)malloc(instr->num_args * sizeof(int));
+    if (!labels)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < instr->num_args; i++)
+        labels[i] = (int)instr->args[i].value;
+    load_value(e, &instr->a, "rax");
+    emit_jump_table(e->gen, "rax", instr->b.value, labels, instr->num_args, (int)instr->dst.value);
+    free(labels);
+}
+
+// ========== 向量指令 ==========
+
+#define VEC_TEMP0 13
+#define VEC_TEMP1 14
+#define VEC_TEMP2 15
+
+static char vector_prefix(int width)
+{
+    return width == 32 ? 'y' : 'x';
+}
+
+// dst = src1 op src2：AVX 用三操作数形式；SSE 先把 src1 复制到 dst（dst 不能是 src2）
+static void emit_vector_op(Emitter *e, const char *mnemonic, int width, int src2, int src1, int dst)
+{
+    char c = vector_prefix(width);
+    if (e->uses_avx)
+    {
+        emit(e->gen, "    v%s %%%cmm%d, %%%cmm%d, %%%cmm%d", mnemonic, c, src2, c, src1, c, dst);
+        return;
+    }
+    if (dst != src1)
+        emit(e->gen, "    movdqa %%xmm%d, %%xmm%d", src1, dst);
+    emit(e->gen, "    %s %%xmm%d, %%xmm%d", mnemonic, src2, dst);
+}
+
+// 32 位乘法：SSE2 只有 pmuludq（偶数位置的两个 32 位数相乘得到 64 位），
+// 奇数位置移到偶数位置再乘一次，两组结果的低 32 位交错拼回来
+static void emit_vector_mul(Emitter *e, int width, int b, int a, int dst)
+{
+    if (e->uses_avx)
+    {
+        emit_vector_op(e, "pmulld", width, b, a, dst);
+        return;
+    }
+    emit(e->gen, "    movdqa %%xmm%d, %%xmm%d", a, VEC_TEMP1);
+    emit(e->gen, "    psrlq $32, %%xmm%d", VEC_TEMP1);
+    emit(e->gen, "    movdqa %%xmm%d, %%xmm%d", b, VEC_TEMP2);
+    emit(e->gen, "    psrlq $32, %%xmm%d", VEC_TEMP2);
+    emit(e->gen, "    pmuludq %%xmm%d, %%xmm%d", VEC_TEMP2, VEC_TEMP1);
+    emit_vector_op(e, "pmuludq", width, b, a, dst);
+    emit(e->gen, "    pshufd $8, %%xmm%d, %%xmm%d", dst, dst);
+    emit(e->gen, "    pshufd $8, %%xmm%d, %%xmm%d", VEC_TEMP1, VEC_TEMP1);
+    emit(e->gen, "    punpckldq %%xmm%d, %%xmm%d", VEC_TEMP1, dst);
+}
+
+// 有符号 32 位最小/最大值：SSE2 用比较得到的掩码选择 (b & mask) | (a & ~mask)，
+// 最小值的掩码是 a > b，最大值的掩码是 b > a
+static void emit_vector_minmax(Emitter *e, int is_max, int width, int b, int a, int dst)
+{
+    if (e->uses_avx)
+    {
+        emit_vector_op(e, is_max ? "pmaxsd" : "pminsd", width, b, a, dst);
+        return;
+    }
+    emit(e->gen, "    movdqa %%xmm%d, %%xmm%d", is_max ? b : a, VEC_TEMP2);
+    emit(e->gen, "    pcmpgtd %%xmm%d, %%xmm%d", is_max ? a : b, VEC_TEMP2);
+    emit(e->gen, "    movdqa %%xmm%d, %%xmm%d", b, VEC_TEMP1);
+    emit(e->gen, "    pand %%xmm%d, %%xmm%d", VEC_TEMP2, VEC_TEMP1);
+    emit(e->gen, "    pandn %%xmm%d, %%xmm%d", a, VEC_TEMP2);
+    emit(e->gen, "    por %%xmm%d, %%xmm%d", VEC_TEMP1, VEC_TEMP2);
+    emit(e->gen, "    movdqa %%xmm%d, %%xmm%d", VEC_TEMP2, dst);
+}
+
+// dst = a op b，size 是元素大小
+static void emit_vector_combine(Emitter *e, IrOpcode op, int size, int width, int b, int a, int dst)
+{
+    switch (op)
+    {
+    case IR_VADD:
+        emit_vector_op(e, size == 4 ? "paddd" : "paddq", width, b, a, dst);
+        break;
+    case IR_VSUB:
+        emit_vector_op(e, size == 4 ? "psubd" : "psubq", width, b, a, dst);
+        break;
+    case IR_VAND:
+        emit_vector_op(e, "pand", width, b, a, dst);
+        break;
+    case IR_VOR:
+        emit_vector_op(e, "por", width, b, a, dst);
+        break;
+    case IR_VXOR:
+        emit_vector_op(e, "pxor", width, b, a, dst);
+        break;
+    case IR_VMUL:
+        emit_vector_mul(e, width, b, a, dst);
+        break;
+    default:
+        emit_vector_minmax(e, op == IR_VMAX, width, b, a, dst);
+        break;
+    }
+}
+
+// 标量装入 %rax，放进最低的元素后复制到所有元素
+static void emit_vector_splat(Emitter *e, IrInstr *instr)
+{
+    int dst = (int)instr->dst.value;
+    char c = vector_prefix(instr->width);
+    const char *v = e->uses_avx ? "v" : "";
+    if (instr->a.kind == IR_OPERAND_IMM && instr->a.value == 0)
+    {
+        emit_vector_op(e, "pxor", instr->width, dst, dst, dst);
+        return;
+    }
+    load_value(e, &instr->a, "rax");
+    if (instr->size == 4)
+        emit(e->gen, "    %smovd %%eax, %%xmm%d", v, dst);
+    else
+        emit(e->gen, "    %smovq %%rax, %%xmm%d", v, dst);
+    if (e->uses_avx)
+        emit(e->gen, "    vpbroadcast%c %%xmm%d, %%%cmm%d", instr->size == 4 ? 'd' : 'q', dst, c, dst);
+    else if (instr->size == 4)
+        emit(e->gen, "    pshufd $0, %%xmm%d, %%xmm%d", dst, dst);
+    else
+        emit(e->gen, "    punpcklqdq %%xmm%d, %%xmm%d", dst, dst);
+}
+
+// 一半的 32 位元素扩展成 64 位。SSE2 与符号掩码（无符号时为 0）交错
+static void emit_vector_widen(Emitter *e, IrInstr *instr)
+{
+    int a = (int)instr->a.value;
+    int dst = (int)instr->dst.value;
+    int high = instr->b.value != 0;
+    if (e->uses_avx)
+    {
+        int src = a;
+        if (high && instr->width == 32)
+            emit(e->gen, "    vextracti128 $1, %%ymm%d, %%xmm%d", a, VEC_TEMP2);
+        else if (high)
+            emit(e->gen, "    vpshufd $238, %%xmm%d, %%xmm%d", a, VEC_TEMP2);
+        if (high)
+            src = VEC_TEMP2;
+        emit(e->gen, "    vpmov%cxdq %%xmm%d, %%%cmm%d", instr->is_unsigned ? 'z' : 's', src,
+             vector_prefix(instr->width), dst);
+        return;
+    }
+    emit(e->gen, "    pxor %%xmm%d, %%xmm%d", VEC_TEMP2, VEC_TEMP2);
+    if (!instr->is_unsigned)
+        emit(e->gen, "    pcmpgtd %%xmm%d, %%xmm%d", a, VEC_TEMP2);
+    if (dst != a)
+        emit(e->gen, "    movdqa %%xmm%d, %%xmm%d", a, dst);
+    emit(e->gen, "    punpck%cdq %%xmm%d, %%xmm%d", high ? 'h' : 'l', VEC_TEMP2, dst);
+}
+
+// 所有元素合并成一个标量：高半部分依次合并到低半部分，最后取出最低的元素（会改写 a）
+static void emit_vector_reduce(Emitter *e, IrInstr *instr)
+{
+    int a = (int)instr->a.value;
+    const char *v = e->uses_avx ? "v" : "";
+    if (instr->width == 32)
+    {
+        emit(e->gen, "    vextracti128 $1, %%ymm%d, %%xmm%d", a, VEC_TEMP0);
+        emit_vector_combine(e, instr->cond, instr->size, 16, VEC_TEMP0, a, a);
+    }
+    emit(e->gen, "    %spshufd $78, %%xmm%d, %%xmm%d", v, a, VEC_TEMP0);
+    emit_vector_combine(e, instr->cond, instr->size, 16, VEC_TEMP0, a, a);
+    if (instr->size == 4)
+    {
+        emit(e->gen, "    %spshufd $177, %%xmm%d, %%xmm%d", v, a, VEC_TEMP0);
+        emit_vector_combine(e, instr->cond, instr->size, 16, VEC_TEMP0, a, a);
+    }
+
+    const char *reg = result_register(e, &instr->dst);
+    int r = vreg_register(e, &instr->dst);
+    if (instr->size == 4)
+    {
+        // 写 32 位寄存器会把高 32 位清零
+        const char *reg32 = r >= 0 ? preg_name32(r) : "eax";
+        emit(e->gen, "    %smovd %%xmm%d, %%%s", v, a, reg32);
+        if (!instr->is_unsigned)
+            emit(e->gen, "    movslq %%%s, %%%s", reg32, reg);
+    }
+    else
+    {
+        emit(e->gen, "    %smovq %%xmm%d, %%%s", v, a, reg);
+    }
+    store_result(e, &instr->dst, reg);
+}
+
+static void emit_vector(Emitter *e, IrInstr *instr)
+{
+    char buffer[OPERAND_SIZE];
+    char c = vector_prefix(instr->width);
+    const char *v = e->uses_avx ? "v" : "";
+    switch (instr->op)
+    {
+    case IR_VLOAD:
+        emit(e->gen, "    %smovdqu %s, %%%cmm%ld", v, address_operand(e, &instr->a, buffer), c, instr->dst.value);
+        break;
+    case IR_VSTORE:
+        emit(e->gen, "    %smovdqu %%%cmm%ld, %s", v, c, instr->b.value, address_operand(e, &instr->a, buffer));
+        break;
+    case IR_VSPLAT:
+        emit_vector_splat(e, instr);
+        break;
+    case IR_VWIDEN:
+        emit_vector_widen(e, instr);
+        break;
+    case IR_VREDUCE:
+        emit_vector_reduce(e, instr);
+        break;
+    default:
+        emit_vector_combine(e, instr->op, instr->size, instr->width, (int)instr->b.value, (int)instr->a.value,
+                            (int)instr->dst.value);
+        break;
+    }
+}
+
+static void emit_instruction(Emitter *e, IrInstr *instr, int is_last)
+{
+    switch (instr->op)
+    {
+    case IR_MOV:
+        emit_move(e, &instr->dst, &instr->a);
+        break;
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_AND:
+    case IR_OR:
+    case IR_XOR:
+    case IR_SHL:
+    case IR_SAR:
+        emit_binary(e, instr);
+        break;
+    case IR_DIV:
+    case IR_MOD:
+        emit_divide(e, instr);
+        break;
+    case IR_NEG:
+    case IR_NOT:
+    {
+        const char *reg = result_register(e, &instr->dst);
+        load_value(e, &instr->a, reg);
+        emit(e->gen, "    %s %%%s", instr->op == IR_NEG ? "negq" : "notq", reg);
+        store_result(e, &instr->dst, reg);
+        break;
+    }
+    case IR_EXT:
+        emit_ext(e, instr);
+        break;
+    case IR_EQ:
+    case IR_NE:
+    case IR_LT:
+    case IR_LE:
+    case IR_GT:
+    case IR_GE:
+        emit_compare(e, &instr->a, &instr->b);
+        emit(e->gen, "    set%s %%al", condition_suffix(instr->op));
+        emit(e->gen, "    movzbq %%al, %%rax");
+        store_result(e, &instr->dst, "rax");
+        break;
+    case IR_LOAD:
+        emit_load(e, instr);
+        break;
+    case IR_STORE:
+        emit_store(e, instr);
+        break;
+    case IR_PARAM:
+        break; // 已在函数入口统一处理
+    case IR_CALL:
+        if (e->uses_avx)
+            emit(e->gen, "    vzeroupper");
+        emit_call(e, instr);
+        break;
+    case IR_JMP:
+        emit(e->gen, "    jmp .L%ld", instr->a.value);
+        break;
+    case IR_BR:
+        emit_compare(e, &instr->a, &instr->b);
+        emit(e->gen, "    j%s .L%ld", condition_suffix(instr->cond), instr->dst.value);
+        break;
+    case IR_SWITCH:
+        emit_switch(e, instr);
+        break;
+    case IR_LABEL:
+        emit(e->gen, ".L%ld:", instr->a.value);
+        break;
+    case IR_RET:
+        if (instr->a.kind != IR_OPERAND_NONE)
+            load_value(e, &instr->a, "rax");
+        if (!is_last)
+        {
+            emit(e->gen, "    jmp .L%d", e->return_label);
+            e->return_used = 1;
+        }
+        break;
+    default:
+        emit_vector(e, instr);
+        break;
+    }
+}
+
+// 除了尾调用没有函数调用，也不从栈上读取参数
+static int is_frameless_leaf(IrFunction *func)
+{
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        if ((instr->op == IR_CALL && !is_tail_call(func, i)) || (instr->op == IR_PARAM && instr->a.value >= 6))
+            return 0;
+    }
+    return 1;
+}
+
+void ir_emit_function(CodeGenerator *gen, IrFunction *func, RegAllocation *alloc)
+{
+    Emitter e;
+    e.gen = gen;
+    e.func = func;
+    e.alloc = alloc;
+    e.return_label = new_label(gen);
+    e.uses_avx = 0;
+    e.return_used = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+        e.uses_avx |= func->instrs[i].op >= IR_VLOAD && func->instrs[i].width == 32;
+
+    e.num_saved = 0;
+    for (int r = 0; r < NUM_CALLEE_SAVED_PREGS; r++)
+    {
+        if (e.alloc->used_callee_saved & (1 << r))
+            e.saved[e.num_saved++] = r;
+    }
+    e.save_base = func->frame_size + 8 * e.alloc->num_spill_slots;
+    int frame = (e.save_base + 8 * e.num_saved + 15) & ~15;
+    // 不调用其他函数（尾调用除外）、栈上没有任何东西的叶子函数不需要建立栈帧
+    e.needs_frame = frame > 0 || !is_frameless_leaf(func);
+
+    emit(gen, "");
+    if (!func->is_static)
+        emit(gen, "    .globl %s", func->name);
+    emit(gen, "    .type %s, @function", func->name);
+    emit(gen, "%s:", func->name);
+    if (e.needs_frame)
+    {
+        emit(gen, "    pushq %%rbp");
+        emit(gen, "    movq %%rsp, %%rbp");
+    }
+    if (frame > 0)
+        emit(gen, "    subq $%d, %%rsp", frame);
+    for (int i = 0; i < e.num_saved; i++)
+        emit(gen, "    movq %%%s, %d(%%rbp)", preg_name(e.saved[i]), -(e.save_base + 8 * (i + 1)));
+
+    int first = emit_parameters(&e);
+    int falls_through = 1; // 最后一条指令之后会执行到返回标签
+    for (int i = first; i < func->num_instrs; i++)
+    {
+        falls_through = 1;
+        if (is_tail_call(func, i))
+        {
+            emit_tail_call(&e, &func->instrs[i]);
+            falls_through = 0;
+            i++; // 跳过之后的 ret
+            continue;
+        }
+        emit_instruction(&e, &func->instrs[i], i == func->num_instrs - 1);
+    }
+
+    // 所有出口都是尾调用时不需要返回的代码
+    if (!falls_through && !e.return_used)
+        return;
+    emit(gen, ".L%d:  # Function return", e.return_label);
+    emit_epilogue(&e);
+    emit(gen, "    ret");
+}
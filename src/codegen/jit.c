@@ -0,0 +1,356 @@
+#include "jit.h"
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <unistd.h>
+#include <dlfcn.h>
+#include <sys/mman.h>
+
+// 进程内符号表：stdlib/ 中声明的函数直接映射到宿主 libc 的实现
+typedef struct HostSymbol
+{
+    const char *name;
+    void *address;
+} HostSymbol;
+
+static const HostSymbol host_symbols[] = {
+    {"putchar", (void *)putchar},
+    {"puts", (void *)puts},
+    {"printf", (void *)printf},
+    {"sprintf", (void *)sprintf},
+    {"malloc", (void *)malloc},
+    {"calloc", (void *)calloc},
+    {"realloc", (void *)realloc},
+    {"free", (void *)free},
+    {"exit", (void *)exit},
+    {"atoi", (void *)atoi},
+    {"atol", (void *)atol},
+    {"strtol", (void *)strtol},
+    {"strlen", (void *)strlen},
+    {"strcmp", (void *)strcmp},
+    {"strcpy", (void *)strcpy},
+    {"strcat", (void *)strcat},
+    {"memset", (void *)memset},
+    {"memcpy", (void *)memcpy},
+    {NULL, NULL}};
+
+// 每个外部函数一个跳板：jmp *0(%rip) + 8 字节绝对地址
+#define STUB_SIZE 16
+// 每个经 GOT 访问的符号一个 8 字节表项，存放符号的绝对地址
+#define SLOT_SIZE 8
+
+// 目标文件各段在可执行内存中的地址
+typedef struct LoadedObject
+{
+    ObjectCode *obj;
+    size_t section_offset[SECTION_COUNT]; // 在所属内存块中的偏移
+    unsigned char *section_base[SECTION_COUNT];
+} LoadedObject;
+
+typedef struct JitImage
+{
+    LoadedObject *objects;
+    int num_objects;
+    unsigned char *memory; // mmap 的整块内存
+    size_t memory_size;
+    unsigned char *stubs;  // 跳板区（位于代码段末尾）
+    char **stub_names;
+    int num_stubs;
+    int stub_capacity;
+    unsigned char *slots;  // GOT 表项区（位于跳板区之后）
+    char **slot_names;
+    int num_slots;
+    int slot_capacity;
+    FILE *diag;
+} JitImage;
+
+static size_t align_up(size_t value, size_t alignment)
+{
+    return (value + alignment - 1) & ~(alignment - 1);
+}
+
+static void *lookup_host_symbol(const char *name)
+{
+    for (int i = 0; host_symbols[i].name; i++)
+    {
+        if (strcmp(host_symbols[i].name, name) == 0)
+            return host_symbols[i].address;
+    }
+    // 不在表中的函数（例如 abs/getchar）从已加载的共享库中查找
+    return dlsym(RTLD_DEFAULT, name);
+}
+
+// 在所有目标文件中查找全局定义
+static void *lookup_global(JitImage *image, const char *name)
+{
+    for (int i = 0; i < image->num_objects; i++)
+    {
+        ObjectCode *obj = image->objects[i].obj;
+        int index = object_find_symbol(obj, name);
+        if (index >= 0 && obj->symbols[index].is_defined && obj->symbols[index].is_global)
+        {
+            AsmSymbol *sym = &obj->symbols[index];
+            return image->objects[i].section_base[sym->section] + sym->offset;
+        }
+    }
+    return NULL;
+}
+
+// 解析符号地址；is_external 表示符号来自宿主进程
+static void *resolve_symbol(JitImage *image, LoadedObject *loaded, int index, int *is_external)
+{
+    AsmSymbol *sym = &loaded->obj->symbols[index];
+    *is_external = 0;
+    if (sym->is_defined)
+        return loaded->section_base[sym->section] + sym->offset;
+
+    void *address = lookup_global(image, sym->name);
+    if (address)
+        return address;
+
+    *is_external = 1;
+    return lookup_host_symbol(sym->name);
+}
+
+// 为外部函数分配（或复用）跳板，返回跳板地址
+static unsigned char *get_stub(JitImage *image, const char *name, void *target)
+{
+    for (int i = 0; i < image->num_stubs; i++)
+    {
+        if (strcmp(image->stub_names[i], name) == 0)
+            return image->stubs + i * STUB_SIZE;
+    }
+    if (image->num_stubs >= image->stub_capacity)
+        return NULL;
+
+    unsigned char *stub = image->stubs + image->num_stubs * STUB_SIZE;
+    uint64_t address = (uint64_t)(uintptr_t)target;
+    stub[0] = 0xFF; // jmp *0(%rip)
+    stub[1] = 0x25;
+    memset(stub + 2, 0, 4);
+    memcpy(stub + 6, &address, 8);
+    stub[14] = 0xCC;
+    stub[15] = 0xCC;
+    image->stub_names[image->num_stubs++] = (char *)name;
+    return stub;
+}
+
+// 为符号分配（或复用）GOT 表项，返回表项地址。
+// 外部数据（例如 libc 的 stdout）可能离代码超过 ±2GB，
+// 代码用 movq sym@GOTPCREL(%rip) 从旁边的表项读取它的地址
+static unsigned char *get_slot(JitImage *image, const char *name, void *target)
+{
+    for (int i = 0; i < image->num_slots; i++)
+    {
+        if (strcmp(image->slot_names[i], name) == 0)
+            return image->slots + i * SLOT_SIZE;
+    }
+    if (image->num_slots >= image->slot_capacity)
+        return NULL;
+
+    unsigned char *slot = image->slots + image->num_slots * SLOT_SIZE;
+    uint64_t address = (uint64_t)(uintptr_t)target;
+    memcpy(slot, &address, 8);
+    image->slot_names[image->num_slots++] = (char *)name;
+    return slot;
+}
+
+static int apply_relocations(JitImage *image)
+{
+    for (int i = 0; i < image->num_objects; i++)
+    {
+        LoadedObject *loaded = &image->objects[i];
+        for (int s = 0; s < SECTION_COUNT; s++)
+        {
+            Section *sec = &loaded->obj->sections[s];
+            for (int r = 0; r < sec->num_relocs; r++)
+            {
+                Relocation *rel = &sec->relocs[r];
+                const char *name = loaded->obj->symbols[rel->symbol].name;
+                unsigned char *place = loaded->section_base[s] + rel->offset;
+                int is_external;
+                unsigned char *target = resolve_symbol(image, loaded, rel->symbol, &is_external);
+                if (!target)
+                {
+                    fprintf(image->diag, "  ✗ Undefined reference to '%s'\n", name);
+                    return 1;
+                }
+
+                if (rel->type == RELOC_ABS64)
+                {
+                    uint64_t value = (uint64_t)(uintptr_t)target + rel->addend;
+                    memcpy(place, &value, 8);
+                    continue;
+                }
+                if (rel->type == RELOC_GOTPCREL)
+                {
+                    target = get_slot(image, name, target);
+                    if (!target)
+                    {
+                        fprintf(image->diag, "  ✗ Too many GOT entries for '%s'\n", name);
+                        return 1;
+                    }
+                }
+
+                // PC 相对：外部函数离得太远时改为跳到跳板
+                int64_t value = (int64_t)(intptr_t)target + rel->addend - (int64_t)(intptr_t)place;
+                if ((value < INT32_MIN || value > INT32_MAX) && is_external && s == SECTION_TEXT)
+                {
+                    target = get_stub(image, name, target);
+                    if (target)
+                        value = (int64_t)(intptr_t)target + rel->addend - (int64_t)(intptr_t)place;
+                }
+                if (value < INT32_MIN || value > INT32_MAX)
+                {
+                    fprintf(image->diag, "  ✗ Relocation out of range for '%s'\n", name);
+                    return 1;
+                }
+                int32_t value32 = (int32_t)value;
+                memcpy(place, &value32, 4);
+            }
+        }
+    }
+    return 0;
+}
+
+// 统计代码段中引用的外部符号数量（跳板区大小的上限）
+static int count_external_references(ObjectCode **objects, int num_objects)
+{
+    int count = 0;
+    for (int i = 0; i < num_objects; i++)
+    {
+        Section *text = &objects[i]->sections[SECTION_TEXT];
+        for (int r = 0; r < text->num_relocs; r++)
+        {
+            if (!objects[i]->symbols[text->relocs[r].symbol].is_defined)
+                count++;
+        }
+    }
+    return count;
+}
+
+// 统计 GOTPCREL 重定位的数量（GOT 表项区大小的上限）
+static int count_got_references(ObjectCode **objects, int num_objects)
+{
+    int count = 0;
+    for (int i = 0; i < num_objects; i++)
+    {
+        for (int s = 0; s < SECTION_COUNT; s++)
+        {
+            Section *sec = &objects[i]->sections[s];
+            for (int r = 0; r < sec->num_relocs; r++)
+            {
+                if (sec->relocs[r].type == RELOC_GOTPCREL)
+                    count++;
+            }
+        }
+    }
+    return count;
+}
+
+int jit_run(ObjectCode **objects, int num_objects, int argc, char **argv,
+            FILE *diag, int *exit_code)
+{
+    JitImage image;
+    memset(&image, 0, sizeof(image));
+    image.diag = diag;
+    image.num_objects = num_objects;
+    image.objects = (LoadedObject *)calloc(num_objects, sizeof(LoadedObject));
+    image.stub_capacity = count_external_references(objects, num_objects);
+    image.stub_names = (char **)calloc(image.stub_capacity + 1, sizeof(char *));
+    image.slot_capacity = count_got_references(objects, num_objects);
+    image.slot_names = (char **)calloc(image.slot_capacity + 1, sizeof(char *));
+    if (!image.objects || !image.stub_names || !image.slot_names)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+
+    // 布局：[代码 + 跳板 + GOT] [只读数据] [数据]，每部分按页对齐以便分别设置权限
+    size_t page = (size_t)sysconf(_SC_PAGESIZE);
+    size_t segment_size[SECTION_COUNT] = {0, 0, 0};
+    static const int segment_order[SECTION_COUNT] = {SECTION_TEXT, SECTION_RODATA, SECTION_DATA};
+    for (int i = 0; i < num_objects; i++)
+    {
+        image.objects[i].obj = objects[i];
+        for (int s = 0; s < SECTION_COUNT; s++)
+        {
+            segment_size[s] = align_up(segment_size[s], 16);
+            image.objects[i].section_offset[s] = segment_size[s];
+            segment_size[s] += objects[i]->sections[s].size;
+        }
+    }
+    size_t stub_offset = align_up(segment_size[SECTION_TEXT], 16);
+    size_t slot_offset = stub_offset + (size_t)image.stub_capacity * STUB_SIZE;
+    segment_size[SECTION_TEXT] = slot_offset + (size_t)image.slot_capacity * SLOT_SIZE;
+
+    size_t segment_start[SECTION_COUNT];
+    size_t total = 0;
+    for (int k = 0; k < SECTION_COUNT; k++)
+    {
+        int s = segment_order[k];
+        segment_start[s] = total;
+        total += align_up(segment_size[s] ? segment_size[s] : 1, page);
+    }
+
+    image.memory = mmap(NULL, total, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (image.memory == MAP_FAILED)
+    {
+        fprintf(diag, "  ✗ Cannot map executable memory\n");
+        free(image.objects);
+        free(image.stub_names);
+        free(image.slot_names);
+        return 1;
+    }
+    image.memory_size = total;
+    image.stubs = image.memory + segment_start[SECTION_TEXT] + stub_offset;
+    image.slots = image.memory + segment_start[SECTION_TEXT] + slot_offset;
+
+    for (int i = 0; i < num_objects; i++)
+    {
+        for (int s = 0; s < SECTION_COUNT; s++)
+        {
+            unsigned char *base = image.memory + segment_start[s] + image.objects[i].section_offset[s];
+            image.objects[i].section_base[s] = base;
+            if (objects[i]->sections[s].size)
+                memcpy(base, objects[i]->sections[s].data, objects[i]->sections[s].size);
+        }
+    }
+
+    int result = apply_relocations(&image);
+    void *entry = NULL;
+    if (result == 0)
+    {
+        entry = lookup_global(&image, "main");
+        if (!entry)
+        {
+            fprintf(diag, "  ✗ Undefined reference to 'main'\n");
+            result = 1;
+        }
+    }
+
+    if (result == 0)
+    {
+        size_t text_size = align_up(segment_size[SECTION_TEXT] ? segment_size[SECTION_TEXT] : 1, page);
+        size_t rodata_size = align_up(segment_size[SECTION_RODATA] ? segment_size[SECTION_RODATA] : 1, page);
+        if (mprotect(image.memory + segment_start[SECTION_TEXT], text_size, PROT_READ | PROT_EXEC) != 0 ||
+            mprotect(image.memory + segment_start[SECTION_RODATA], rodata_size, PROT_READ) != 0)
+        {
+            fprintf(diag, "  ✗ Cannot make code executable\n");
+            result = 1;
+        }
+    }
+
+    if (result == 0)
+    {
+        int (*main_function)(int, char **) = (int (*)(int, char **))entry;
+        *exit_code = main_function(argc, argv);
+        fflush(stdout);
+    }
+
+    munmap(image.memory, image.memory_size);
+    free(image.objects);
+    free(image.stub_names);
+    free(image.slot_names);
+    return result;
+}
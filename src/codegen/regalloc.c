@@ -0,0 +1,415 @@
+#include "regalloc.h"
+#include <limits.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+static const char *preg_names[NUM_PREGS] = {"rbx", "r12", "r13", "r14", "r15",
+                                            "rsi", "rdi", "r8",  "r9",  "r10"};
+static const char *preg_names32[NUM_PREGS] = {"ebx",  "r12d", "r13d", "r14d", "r15d",
+                                              "esi",  "edi",  "r8d",  "r9d",  "r10d"};
+static const char *preg_names16[NUM_PREGS] = {"bx",   "r12w", "r13w", "r14w", "r15w",
+                                              "si",   "di",   "r8w",  "r9w",  "r10w"};
+static const char *preg_names8[NUM_PREGS] = {"bl",  "r12b", "r13b", "r14b", "r15b",
+                                             "sil", "dil",  "r8b",  "r9b",  "r10b"};
+
+const char *preg_name(int reg)
+{
+    return preg_names[reg];
+}
+
+const char *preg_name32(int reg)
+{
+    return preg_names32[reg];
+}
+
+const char *preg_name16(int reg)
+{
+    return preg_names16[reg];
+}
+
+const char *preg_name8(int reg)
+{
+    return preg_names8[reg];
+}
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// ========== 活跃变量分析 ==========
+
+typedef struct Liveness
+{
+    int words;          // 每个位集合的 64 位字数
+    uint64_t *live_in;  // [num_blocks][words]
+    uint64_t *live_out; // [num_blocks][words]
+} Liveness;
+
+static void set_bit(uint64_t *set, int v)
+{
+    set[v / 64] |= (uint64_t)1 << (v % 64);
+}
+
+static void clear_bit(uint64_t *set, int v)
+{
+    set[v / 64] &= ~((uint64_t)1 << (v % 64));
+}
+
+static int test_bit(const uint64_t *set, int v)
+{
+    return (set[v / 64] >> (v % 64)) & 1;
+}
+
+// 指令读取的虚拟寄存器
+static int instr_uses(IrInstr *instr, int *uses)
+{
+    int count = 0;
+    switch (instr->op)
+    {
+    case IR_LABEL:
+    case IR_JMP:
+    case IR_PARAM:
+        break;
+    case IR_CALL:
+        for (int i = 0; i < instr->num_args; i++)
+        {
+            if (instr->args[i].kind == IR_OPERAND_VREG)
+                uses[count++] = (int)instr->args[i].value;
+        }
+        break;
+    default:
+        if (instr->a.kind == IR_OPERAND_VREG)
+            uses[count++] = (int)instr->a.value;
+        if (instr->b.kind == IR_OPERAND_VREG)
+            uses[count++] = (int)instr->b.value;
+        break;
+    }
+    return count;
+}
+
+// 指令写入的虚拟寄存器，没有则返回 -1
+static int instr_def(IrInstr *instr)
+{
+    switch (instr->op)
+    {
+    case IR_STORE:
+    case IR_JMP:
+    case IR_BR:
+    case IR_SWITCH:
+    case IR_LABEL:
+    case IR_RET:
+        return -1;
+    default:
+        return instr->dst.kind == IR_OPERAND_VREG ? (int)instr->dst.value : -1;
+    }
+}
+
+static int *instr_use_buffer(IrFunction *func)
+{
+    int max_uses = 2;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (func->instrs[i].num_args > max_uses)
+            max_uses = func->instrs[i].num_args;
+    }
+    return (int *)xcalloc(max_uses, sizeof(int));
+}
+
+// 基本块级的后向数据流，迭代到不动点：
+// live_out[b] = ∪ live_in[后继]，live_in[b] = use[b] ∪ (live_out[b] - def[b])
+static void compute_liveness(IrFunction *func, Liveness *live)
+{
+    int n = func->num_blocks;
+    int words = (func->num_vregs + 63) / 64;
+    if (words == 0)
+        words = 1;
+    live->words = words;
+    live->live_in = (uint64_t *)xcalloc((size_t)n * words, sizeof(uint64_t));
+    live->live_out = (uint64_t *)xcalloc((size_t)n * words, sizeof(uint64_t));
+
+    // 块内先于定义的使用（use）和块内的定义（def）
+    uint64_t *use = (uint64_t *)xcalloc((size_t)n * words, sizeof(uint64_t));
+    uint64_t *def = (uint64_t *)xcalloc((size_t)n * words, sizeof(uint64_t));
+    int *uses = instr_use_buffer(func);
+    for (int b = 0; b < n; b++)
+    {
+        IrBlock *block = &func->blocks[b];
+        uint64_t *block_use = use + (size_t)b * words;
+        uint64_t *block_def = def + (size_t)b * words;
+        for (int i = block->first; i <= block->last; i++)
+        {
+            int num_uses = instr_uses(&func->instrs[i], uses);
+            for (int u = 0; u < num_uses; u++)
+            {
+                if (!test_bit(block_def, uses[u]))
+                    set_bit(block_use, uses[u]);
+            }
+            int d = instr_def(&func->instrs[i]);
+            if (d >= 0)
+                set_bit(block_def, d);
+        }
+    }
+    free(uses);
+
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int b = n - 1; b >= 0; b--)
+        {
+            IrBlock *block = &func->blocks[b];
+            uint64_t *out = live->live_out + (size_t)b * words;
+            uint64_t *in = live->live_in + (size_t)b * words;
+            for (int w = 0; w < words; w++)
+            {
+                uint64_t new_out = 0;
+                for (int s = 0; s < block->num_succs; s++)
+                    new_out |= live->live_in[(size_t)block->succs[s] * words + w];
+                uint64_t new_in = use[(size_t)b * words + w] | (new_out & ~def[(size_t)b * words + w]);
+                if (new_out != out[w] || new_in != in[w])
+                {
+                    out[w] = new_out;
+                    in[w] = new_in;
+                    changed = 1;
+                }
+            }
+        }
+    }
+
+    free(use);
+    free(def);
+}
+
+// ========== 线性扫描 ==========
+
+typedef struct Interval
+{
+    int vreg;
+    int start;
+    int end;
+    int crosses_call; // 区间内有函数调用，只能放在被调用者保存的寄存器中
+} Interval;
+
+static void extend_interval(Interval *interval, int position)
+{
+    if (position < interval->start)
+        interval->start = position;
+    if (position > interval->end)
+        interval->end = position;
+}
+
+static int compare_start(const void *a, const void *b)
+{
+    const Interval *x = (const Interval *)a;
+    const Interval *y = (const Interval *)b;
+    if (x->start != y->start)
+        return x->start - y->start;
+    return x->vreg - y->vreg;
+}
+
+// 参数 vreg 对应的传入寄存器（不可分配的 %rdx、%rcx 除外）
+static int param_register_hint(IrFunction *func, int vreg, int last_param)
+{
+    static const int incoming[6] = {PREG_RDI, PREG_RSI, -1, -1, PREG_R8, PREG_R9};
+    for (int i = 0; i <= last_param; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        if (instr->dst.kind == IR_OPERAND_VREG && instr->dst.value == vreg && instr->a.value < 6)
+            return incoming[instr->a.value];
+    }
+    return -1;
+}
+
+static int is_callee_saved(int reg)
+{
+    return reg < NUM_CALLEE_SAVED_PREGS;
+}
+
+static void spill(RegAllocation *alloc, int vreg)
+{
+    alloc->reg[vreg] = -1;
+    alloc->spill_slot[vreg] = alloc->num_spill_slots++;
+}
+
+RegAllocation *regalloc_run(IrFunction *func)
+{
+    int num_vregs = func->num_vregs;
+    RegAllocation *alloc = (RegAllocation *)xcalloc(1, sizeof(RegAllocation));
+    alloc->num_vregs = num_vregs;
+    alloc->reg = (int *)xcalloc(num_vregs, sizeof(int));
+    alloc->spill_slot = (int *)xcalloc(num_vregs, sizeof(int));
+    for (int v = 0; v < num_vregs; v++)
+        alloc->reg[v] = -1;
+    if (num_vregs == 0)
+        return alloc;
+
+    if (!func->blocks)
+        ir_build_cfg(func);
+    Liveness live;
+    compute_liveness(func, &live);
+
+    // 活跃区间：所有活跃点、定义点和使用点的最小/最大下标。
+    // 每个基本块从 live_out 出发向前扫描，得到每条指令之后的活跃集合
+    Interval *intervals = (Interval *)xcalloc(num_vregs, sizeof(Interval));
+    for (int v = 0; v < num_vregs; v++)
+    {
+        intervals[v].vreg = v;
+        intervals[v].start = INT_MAX;
+        intervals[v].end = -1;
+    }
+    uint64_t *current = (uint64_t *)xcalloc(live.words, sizeof(uint64_t));
+    int *uses = instr_use_buffer(func);
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        IrBlock *block = &func->blocks[b];
+        memcpy(current, live.live_out + (size_t)b * live.words, live.words * sizeof(uint64_t));
+        for (int i = block->last; i >= block->first; i--)
+        {
+            IrInstr *instr = &func->instrs[i];
+            int def = instr_def(instr);
+            for (int w = 0; w < live.words; w++)
+            {
+                uint64_t bits = current[w];
+                while (bits)
+                {
+                    int v = w * 64 + __builtin_ctzll(bits);
+                    bits &= bits - 1;
+                    extend_interval(&intervals[v], i);
+                    if (instr->op == IR_CALL && v != def)
+                        intervals[v].crosses_call = 1;
+                }
+            }
+            if (def >= 0)
+            {
+                extend_interval(&intervals[def], i);
+                clear_bit(current, def);
+            }
+            int num_uses = instr_uses(instr, uses);
+            for (int u = 0; u < num_uses; u++)
+            {
+                extend_interval(&intervals[uses[u]], i);
+                set_bit(current, uses[u]);
+            }
+        }
+    }
+    free(current);
+    free(uses);
+    free(live.live_in);
+    free(live.live_out);
+
+    int last_param = -1;
+    while (last_param + 1 < func->num_instrs && func->instrs[last_param + 1].op == IR_PARAM)
+        last_param++;
+    // 参数在函数入口一起搬运（并行赋值），它们的区间必须互不重叠
+    for (int i = 0; i <= last_param; i++)
+    {
+        int v = instr_def(&func->instrs[i]);
+        if (v >= 0)
+        {
+            intervals[v].start = 0;
+            if (intervals[v].end < last_param)
+                intervals[v].end = last_param;
+        }
+    }
+    int count = 0;
+    for (int v = 0; v < num_vregs; v++)
+    {
+        if (intervals[v].end >= 0)
+            intervals[count++] = intervals[v];
+    }
+    qsort(intervals, count, sizeof(Interval), compare_start);
+
+    Interval *active[NUM_PREGS]; // 按寄存器编号索引，NULL 表示空闲
+    memset(active, 0, sizeof(active));
+
+    for (int k = 0; k < count; k++)
+    {
+        Interval *cur = &intervals[k];
+
+        // 释放已经结束的区间
+        for (int r = 0; r < NUM_PREGS; r++)
+        {
+            if (active[r] && active[r]->end < cur->start)
+                active[r] = NULL;
+        }
+
+        // 不跨调用的参数优先留在传入它的寄存器中；
+        // 其他不跨调用的区间优先使用调用者保存的寄存器，把被调用者保存的留给跨调用的值
+        int chosen = -1;
+        int hint = param_register_hint(func, cur->vreg, last_param);
+        if (!cur->crosses_call && hint >= 0 && !active[hint])
+            chosen = hint;
+        if (!cur->crosses_call && chosen < 0)
+        {
+            for (int r = NUM_CALLEE_SAVED_PREGS; r < NUM_PREGS && chosen < 0; r++)
+            {
+                if (!active[r])
+                    chosen = r;
+            }
+        }
+        for (int r = 0; r < NUM_CALLEE_SAVED_PREGS && chosen < 0; r++)
+        {
+            if (!active[r])
+                chosen = r;
+        }
+
+        if (chosen < 0)
+        {
+            // 没有空闲寄存器：溢出结束得最晚的那个
+            int victim = -1;
+            for (int r = 0; r < NUM_PREGS; r++)
+            {
+                if (cur->crosses_call && !is_callee_saved(r))
+                    continue;
+                if (victim < 0 || active[r]->end > active[victim]->end)
+                    victim = r;
+            }
+            if (victim >= 0 && active[victim]->end > cur->end)
+            {
+                spill(alloc, active[victim]->vreg);
+                chosen = victim;
+            }
+            else
+            {
+                spill(alloc, cur->vreg);
+                continue;
+            }
+        }
+
+        alloc->reg[cur->vreg] = chosen;
+        active[chosen] = cur;
+        if (is_callee_saved(chosen))
+            alloc->used_callee_saved |= 1 << chosen;
+    }
+
+    free(intervals);
+    return alloc;
+}
+
+RegAllocation *regalloc_spill_all(IrFunction *func)
+{
+    RegAllocation *alloc = (RegAllocation *)xcalloc(1, sizeof(RegAllocation));
+    alloc->num_vregs = func->num_vregs;
+    alloc->reg = (int *)xcalloc(func->num_vregs, sizeof(int));
+    alloc->spill_slot = (int *)xcalloc(func->num_vregs, sizeof(int));
+    for (int v = 0; v < func->num_vregs; v++)
+        spill(alloc, v);
+    return alloc;
+}
+
+void regalloc_free(RegAllocation *alloc)
+{
+    if (!alloc)
+        return;
+    free(alloc->reg);
+    free(alloc->spill_slot);
+    free(alloc);
+}
@@ -0,0 +1,162 @@
+#include "switch_lower.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 一簇 case：count 为 1 时是单个值，否则用跳转表覆盖 [low, high]
+typedef struct SwitchCluster
+{
+    long low;
+    long high;
+    int first; // 第一个 case 在排好序的数组中的下标
+    int count;
+} SwitchCluster;
+
+static int compare_cases(const void *a, const void *b)
+{
+    const SwitchCase *x = (const SwitchCase *)a;
+    const SwitchCase *y = (const SwitchCase *)b;
+    if (x->value != y->value)
+        return x->value < y->value ? -1 : 1;
+    // 相同的值按标签排序，保证去重时保留源码中靠前的 case
+    return x->label - y->label;
+}
+
+// cases[first..last] 是否足够稠密，可以用一张跳转表
+static int table_fits(const SwitchCase *cases, int first, int last)
+{
+    int count = last - first + 1;
+    if (count < SWITCH_TABLE_MIN_CASES)
+        return 0;
+    unsigned long range = (unsigned long)cases[last].value - (unsigned long)cases[first].value;
+    return range < (unsigned long)count * SWITCH_TABLE_MAX_RATIO;
+}
+
+// 从左到右贪心地划分：每个簇尽量向右延伸到仍然稠密的最远位置
+static int build_clusters(const SwitchCase *cases, int num_cases, SwitchCluster *clusters)
+{
+    int num_clusters = 0;
+    int i = 0;
+    while (i < num_cases)
+    {
+        int last = i;
+        for (int j = num_cases - 1; j >= i + SWITCH_TABLE_MIN_CASES - 1; j--)
+        {
+            if (table_fits(cases, i, j))
+            {
+                last = j;
+                break;
+            }
+        }
+        SwitchCluster *cluster = &clusters[num_clusters++];
+        cluster->low = cases[i].value;
+        cluster->high = cases[last].value;
+        cluster->first = i;
+        cluster->count = last - i + 1;
+        i = last + 1;
+    }
+    return num_clusters;
+}
+
+static void emit_cluster_table(const SwitchTarget *target, const SwitchCase *cases, const SwitchCluster *cluster,
+                               int default_label)
+{
+    int num_entries = (int)(cluster->high - cluster->low + 1);
+    int *labels = (int *)malloc(num_entries * sizeof(int));
+    if (!labels)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < num_entries; i++)
+        labels[i] = default_label;
+    for (int i = cluster->first; i < cluster->first + cluster->count; i++)
+        labels[cases[i].value - cluster->low] = cases[i].label;
+    target->emit_table(target->ctx, cluster->low, labels, num_entries, default_label);
+    free(labels);
+}
+
+// 在 clusters[lo..hi] 中查找：先和中间簇的起始值比较，小于时进入左半边
+static void dispatch(const SwitchTarget *target, const SwitchCase *cases, const SwitchCluster *clusters, int lo,
+                     int hi, int default_label)
+{
+    if (lo == hi && clusters[lo].count > 1)
+    {
+        emit_cluster_table(target, cases, &clusters[lo], default_label);
+        return;
+    }
+
+    int all_single = 1;
+    for (int i = lo; i <= hi; i++)
+        all_single &= clusters[i].count == 1;
+    if (all_single && hi - lo + 1 <= SWITCH_LINEAR_MAX)
+    {
+        for (int i = lo; i <= hi; i++)
+            target->emit_branch(target->ctx, IR_EQ, clusters[i].low, cases[clusters[i].first].label);
+        target->emit_jump(target->ctx, default_label);
+        return;
+    }
+
+    int mid = (lo + hi + 1) / 2;
+    int left_label = target->new_label(target->ctx);
+    target->emit_branch(target->ctx, IR_LT, clusters[mid].low, left_label);
+    dispatch(target, cases, clusters, mid, hi, default_label);
+    target->emit_label(target->ctx, left_label);
+    dispatch(target, cases, clusters, lo, mid - 1, default_label);
+}
+
+void switch_emit_dispatch(const SwitchTarget *target, SwitchCase *cases, int num_cases, int default_label)
+{
+    if (num_cases == 0)
+    {
+        target->emit_jump(target->ctx, default_label);
+        return;
+    }
+
+    qsort(cases, num_cases, sizeof(SwitchCase), compare_cases);
+    int count = 1;
+    for (int i = 1; i < num_cases; i++)
+    {
+        if (cases[i].value != cases[count - 1].value)
+            cases[count++] = cases[i];
+    }
+
+    SwitchCluster *clusters = (SwitchCluster *)malloc(count * sizeof(SwitchCluster));
+    if (!clusters)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    int num_clusters = build_clusters(cases, count, clusters);
+    dispatch(target, cases, clusters, 0, num_clusters - 1, default_label);
+    free(clusters);
+}
+
+void emit_jump_table(CodeGenerator *gen, const char *reg, long low, const int *labels, int num_entries,
+                     int default_label)
+{
+    int table_label = new_label(gen);
+    if (low >= -2147483648L && low <= 2147483647L)
+    {
+        if (low != 0)
+            emit(gen, "    subq $%ld, %%%s", low, reg);
+    }
+    else
+    {
+        emit(gen, "    movabsq $%ld, %%r11", low);
+        emit(gen, "    subq %%r11, %%%s", reg);
+    }
+    // 无符号比较同时排除了小于 low 的值
+    emit(gen, "    cmpq $%d, %%%s", num_entries - 1, reg);
+    emit(gen, "    ja .L%d", default_label);
+    emit(gen, "    leaq .L%d(%%rip), %%r11", table_label);
+    emit(gen, "    movslq (%%r11,%%%s,4), %%%s", reg, reg);
+    emit(gen, "    addq %%r11, %%%s", reg);
+    emit(gen, "    jmp *%%%s", reg);
+
+    emit(gen, "    .section .rodata");
+    emit(gen, "    .align 4");
+    emit(gen, ".L%d:", table_label);
+    for (int i = 0; i < num_entries; i++)
+        emit(gen, "    .long .L%d-.L%d", labels[i], table_label);
+    emit(gen, "    .text");
+}
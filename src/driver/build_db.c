@@ -0,0 +1,431 @@
+#include "build_db.h"
+#include "sha256.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/stat.h>
+
+// 数据库格式版本，修改文件布局时递增
+#define BUILD_DB_HEADER "vc-build-db 1"
+
+// 一个依赖文件
+typedef struct DepEntry
+{
+    char *path;
+    long mtime_sec;
+    long mtime_nsec;
+    long size;
+    char hash[SHA256_HEX_SIZE];
+} DepEntry;
+
+// 一个编译单元：源文件 → 输出文件，deps[0] 是源文件本身
+typedef struct BuildUnit
+{
+    char *source;
+    char *output;
+    char *flags;
+    DepEntry *deps;
+    int num_deps;
+} BuildUnit;
+
+struct BuildDb
+{
+    char *path;
+    BuildUnit *units;
+    int num_units;
+    int capacity;
+    int dirty; // 是否需要写回
+    pthread_mutex_t lock;
+};
+
+static char *copy_string(const char *text)
+{
+    char *copy = strdup(text);
+    if (!copy)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return copy;
+}
+
+static void free_unit(BuildUnit *unit)
+{
+    free(unit->source);
+    free(unit->output);
+    free(unit->flags);
+    for (int i = 0; i < unit->num_deps; i++)
+        free(unit->deps[i].path);
+    free(unit->deps);
+}
+
+static BuildUnit *find_unit(BuildDb *db, const char *source, const char *output)
+{
+    for (int i = 0; i < db->num_units; i++)
+    {
+        if (strcmp(db->units[i].source, source) == 0 && strcmp(db->units[i].output, output) == 0)
+            return &db->units[i];
+    }
+    return NULL;
+}
+
+static BuildUnit *add_unit(BuildDb *db)
+{
+    if (db->num_units >= db->capacity)
+    {
+        db->capacity = db->capacity ? db->capacity * 2 : 16;
+        db->units = (BuildUnit *)realloc(db->units, db->capacity * sizeof(BuildUnit));
+        if (!db->units)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    BuildUnit *unit = &db->units[db->num_units++];
+    memset(unit, 0, sizeof(*unit));
+    return unit;
+}
+
+static void add_dep(BuildUnit *unit, const DepEntry *dep)
+{
+    unit->deps = (DepEntry *)realloc(unit->deps, (unit->num_deps + 1) * sizeof(DepEntry));
+    if (!unit->deps)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    unit->deps[unit->num_deps++] = *dep;
+}
+
+// 计算文件内容的 SHA-256，失败返回 -1
+static int hash_file(const char *path, char hash[SHA256_HEX_SIZE])
+{
+    FILE *fp = fopen(path, "rb");
+    if (!fp)
+        return -1;
+    Sha256 ctx;
+    sha256_init(&ctx);
+    char buffer[65536];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0)
+        sha256_update(&ctx, buffer, n);
+    int failed = ferror(fp);
+    fclose(fp);
+    if (failed)
+        return -1;
+    sha256_final_hex(&ctx, hash);
+    return 0;
+}
+
+// 记录依赖文件的当前状态，失败返回 -1
+static int snapshot_file(const char *path, DepEntry *dep)
+{
+    struct stat st;
+    if (stat(path, &st) != 0 || hash_file(path, dep->hash) != 0)
+        return -1;
+    dep->path = copy_string(path);
+    dep->mtime_sec = (long)st.st_mtim.tv_sec;
+    dep->mtime_nsec = (long)st.st_mtim.tv_nsec;
+    dep->size = (long)st.st_size;
+    return 0;
+}
+
+// ========== 读写数据库文件 ==========
+
+// 把一行按 '\t' 切开（原地修改），返回字段数
+static int split_fields(char *line, char **fields, int max_fields)
+{
+    int count = 0;
+    line[strcspn(line, "\n")] = '\0';
+    while (count < max_fields)
+    {
+        fields[count++] = line;
+        char *tab = strchr(line, '\t');
+        if (!tab)
+            break;
+        *tab = '\0';
+        line = tab + 1;
+    }
+    return count;
+}
+
+static void load_db(BuildDb *db, FILE *fp)
+{
+    char *line = NULL;
+    size_t capacity = 0;
+    if (getline(&line, &capacity, fp) < 0 || strncmp(line, BUILD_DB_HEADER, strlen(BUILD_DB_HEADER)) != 0)
+    {
+        // 空文件或旧版本：当作空数据库
+        free(line);
+        return;
+    }
+
+    BuildUnit *unit = NULL;
+    while (getline(&line, &capacity, fp) >= 0)
+    {
+        char *fields[6];
+        int count = split_fields(line, fields, 6);
+        if (count == 4 && strcmp(fields[0], "unit") == 0)
+        {
+            unit = add_unit(db);
+            unit->source = copy_string(fields[1]);
+            unit->output = copy_string(fields[2]);
+            unit->flags = copy_string(fields[3]);
+        }
+        else if (count == 6 && strcmp(fields[0], "dep") == 0 && unit &&
+                 strlen(fields[4]) == SHA256_HEX_SIZE - 1)
+        {
+            DepEntry dep;
+            dep.mtime_sec = atol(fields[1]);
+            dep.mtime_nsec = atol(fields[2]);
+            dep.size = atol(fields[3]);
+            memcpy(dep.hash, fields[4], SHA256_HEX_SIZE);
+            dep.path = copy_string(fields[5]);
+            add_dep(unit, &dep);
+        }
+    }
+    free(line);
+}
+
+static int save_db(BuildDb *db)
+{
+    size_t length = strlen(db->path) + 8;
+    char *temp_path = (char *)malloc(length);
+    if (!temp_path)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    snprintf(temp_path, length, "%s.tmp", db->path);
+
+    FILE *fp = fopen(temp_path, "w");
+    if (!fp)
+    {
+        free(temp_path);
+        return -1;
+    }
+    fprintf(fp, "%s\n", BUILD_DB_HEADER);
+    for (int i = 0; i < db->num_units; i++)
+    {
+        BuildUnit *unit = &db->units[i];
+        fprintf(fp, "unit\t%s\t%s\t%s\n", unit->source, unit->output, unit->flags);
+        for (int j = 0; j < unit->num_deps; j++)
+        {
+            DepEntry *dep = &unit->deps[j];
+            fprintf(fp, "dep\t%ld\t%ld\t%ld\t%s\t%s\n", dep->mtime_sec, dep->mtime_nsec,
+                    dep->size, dep->hash, dep->path);
+        }
+    }
+    int result = fclose(fp) == 0 ? 0 : -1;
+    if (result == 0)
+        result = rename(temp_path, db->path);
+    if (result != 0)
+        unlink(temp_path);
+    free(temp_path);
+    return result;
+}
+
+// ========== 接口 ==========
+
+BuildDb *build_db_open(const char *path)
+{
+    BuildDb *db = (BuildDb *)calloc(1, sizeof(BuildDb));
+    if (!db)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    db->path = copy_string(path);
+    pthread_mutex_init(&db->lock, NULL);
+
+    FILE *fp = fopen(path, "r");
+    if (fp)
+    {
+        load_db(db, fp);
+        fclose(fp);
+    }
+    return db;
+}
+
+void build_db_close(BuildDb *db)
+{
+    if (!db)
+        return;
+    if (db->dirty && save_db(db) != 0)
+        fprintf(stderr, "Warning: cannot write build database %s\n", db->path);
+    for (int i = 0; i < db->num_units; i++)
+        free_unit(&db->units[i]);
+    free(db->units);
+    pthread_mutex_destroy(&db->lock);
+    free(db->path);
+    free(db);
+}
+
+int build_db_is_up_to_date(BuildDb *db, const char *source, const char *output, const char *flags)
+{
+    if (access(output, F_OK) != 0)
+        return 0;
+
+    pthread_mutex_lock(&db->lock);
+    BuildUnit *unit = find_unit(db, source, output);
+    int up_to_date = unit && unit->num_deps > 0 && strcmp(unit->flags, flags) == 0;
+    for (int i = 0; up_to_date && i < unit->num_deps; i++)
+    {
+        DepEntry *dep = &unit->deps[i];
+        struct stat st;
+        if (stat(dep->path, &st) != 0)
+        {
+            up_to_date = 0;
+            break;
+        }
+        if ((long)st.st_mtim.tv_sec == dep->mtime_sec &&
+            (long)st.st_mtim.tv_nsec == dep->mtime_nsec && (long)st.st_size == dep->size)
+            continue;
+
+        // 时间戳变了，比较内容
+        char hash[SHA256_HEX_SIZE];
+        if (hash_file(dep->path, hash) != 0 || strcmp(hash, dep->hash) != 0)
+        {
+            up_to_date = 0;
+            break;
+        }
+        dep->mtime_sec = (long)st.st_mtim.tv_sec;
+        dep->mtime_nsec = (long)st.st_mtim.tv_nsec;
+        dep->size = (long)st.st_size;
+        db->dirty = 1;
+    }
+    pthread_mutex_unlock(&db->lock);
+    return up_to_date;
+}
+
+void build_db_record(BuildDb *db, const char *source, const char *output, const char *flags,
+                     char **headers, int num_headers)
+{
+    // 在锁外读取和计算摘要
+    DepEntry *deps = (DepEntry *)malloc((num_headers + 1) * sizeof(DepEntry));
+    if (!deps)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    int num_deps = 0;
+    int complete = snapshot_file(source, &deps[num_deps]) == 0;
+    if (complete)
+        num_deps++;
+    for (int i = 0; complete && i < num_headers; i++)
+    {
+        if (snapshot_file(headers[i], &deps[num_deps]) != 0)
+            complete = 0;
+        else
+            num_deps++;
+    }
+
+    pthread_mutex_lock(&db->lock);
+    BuildUnit *unit = find_unit(db, source, output);
+    if (unit)
+    {
+        free_unit(unit);
+        memset(unit, 0, sizeof(*unit));
+    }
+    else
+    {
+        unit = add_unit(db);
+    }
+    unit->source = copy_string(source);
+    unit->output = copy_string(output);
+    unit->flags = copy_string(flags);
+    // 某个依赖无法读取时不保存依赖，下次一定重新编译
+    if (complete)
+    {
+        unit->deps = deps;
+        unit->num_deps = num_deps;
+        deps = NULL;
+    }
+    db->dirty = 1;
+    pthread_mutex_unlock(&db->lock);
+
+    if (deps)
+    {
+        for (int i = 0; i < num_deps; i++)
+            free(deps[i].path);
+        free(deps);
+    }
+}
+
+// make 依赖文件中的空格需要转义
+static void write_make_path(FILE *fp, const char *path)
+{
+    for (const char *p = path; *p; p++)
+    {
+        if (*p == ' ')
+            fputc('\\', fp);
+        else if (*p == '$')
+            fputc('$', fp);
+        fputc(*p, fp);
+    }
+}
+
+// 和源文件在同一目录的头文件经 "./" 查找，gcc/clang 写的是 h.h 而不是 ./h.h，
+// make 把两者当作不同的目标
+static const char *dependency_path(const char *path)
+{
+    while (path[0] == '.' && path[1] == '/')
+    {
+        path += 2;
+        while (*path == '/')
+            path++;
+    }
+    return path;
+}
+
+int write_dependency_file(const char *dep_file, const char *target, const char *source,
+                          char **headers, int num_headers)
+{
+    FILE *fp = fopen(dep_file, "w");
+    if (!fp)
+        return -1;
+    write_make_path(fp, target);
+    fputs(": ", fp);
+    write_make_path(fp, source);
+    for (int i = 0; i < num_headers; i++)
+    {
+        fputs(" \\\n ", fp);
+        write_make_path(fp, dependency_path(headers[i]));
+    }
+    fputs("\n", fp);
+
+    // 和 gcc -MP 一样为每个头文件生成空规则，头文件被删除时 make 不会报错
+    for (int i = 0; i < num_headers; i++)
+    {
+        fputs("\n", fp);
+        write_make_path(fp, dependency_path(headers[i]));
+        fputs(":\n", fp);
+    }
+    return fclose(fp) == 0 ? 0 : -1;
+}
+
+int build_db_write_dependency_file(BuildDb *db, const char *dep_file, const char *source,
+                                   const char *output)
+{
+    pthread_mutex_lock(&db->lock);
+    BuildUnit *unit = find_unit(db, source, output);
+    int result = -1;
+    if (unit && unit->num_deps > 0)
+    {
+        // deps[0] 是源文件本身，其余是头文件
+        char **headers = (char **)malloc(unit->num_deps * sizeof(char *));
+        if (!headers)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+        for (int i = 1; i < unit->num_deps; i++)
+            headers[i - 1] = unit->deps[i].path;
+        result = write_dependency_file(dep_file, output, source, headers, unit->num_deps - 1);
+        free(headers);
+    }
+    pthread_mutex_unlock(&db->lock);
+    return result;
+}
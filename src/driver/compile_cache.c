@@ -0,0 +1,396 @@
+#include "compile_cache.h"
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <dirent.h>
+#include <unistd.h>
+#include <pthread.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+
+// 缓存格式版本，修改键的组成或文件布局时递增
+#define CACHE_FORMAT_VERSION "vc-cache-2"
+
+// 淘汰时降到上限的 90%，避免每次写入都扫描目录
+#define CACHE_LOW_WATERMARK(max) ((max) / 10 * 9)
+
+struct CompileCache
+{
+    char *directory;
+    size_t max_size;
+    FILE *diag;
+    long session_hits;
+    long session_misses;
+    pthread_mutex_t lock;
+};
+
+// 缓存条目：<64 位十六进制键><后缀>
+typedef struct CacheEntry
+{
+    char *name;
+    time_t mtime;
+    size_t size;
+} CacheEntry;
+
+static char *join_path(const char *directory, const char *name, const char *suffix)
+{
+    size_t length = strlen(directory) + strlen(name) + strlen(suffix) + 2;
+    char *path = (char *)malloc(length);
+    if (!path)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    snprintf(path, length, "%s/%s%s", directory, name, suffix);
+    return path;
+}
+
+static int copy_fd_to_fd(int in, int out)
+{
+    char buffer[65536];
+    for (;;)
+    {
+        ssize_t n = read(in, buffer, sizeof(buffer));
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n < 0)
+            return -1;
+        if (n == 0)
+            return 0;
+        char *p = buffer;
+        while (n > 0)
+        {
+            ssize_t written = write(out, p, (size_t)n);
+            if (written < 0 && errno == EINTR)
+                continue;
+            if (written <= 0)
+                return -1;
+            p += written;
+            n -= written;
+        }
+    }
+}
+
+// ========== 统计文件（用 flock 在进程之间互斥） ==========
+
+static int lock_stats(CompileCache *cache, CacheStats *stats)
+{
+    char *path = join_path(cache->directory, "stats", "");
+    int fd = open(path, O_RDWR | O_CREAT, 0644);
+    free(path);
+    memset(stats, 0, sizeof(*stats));
+    if (fd < 0)
+        return -1;
+    if (flock(fd, LOCK_EX) != 0)
+    {
+        close(fd);
+        return -1;
+    }
+
+    char text[256];
+    ssize_t n = pread(fd, text, sizeof(text) - 1, 0);
+    if (n > 0)
+    {
+        text[n] = '\0';
+        sscanf(text, "hits %ld\nmisses %ld\nevictions %ld\nentries %ld\nsize %zu",
+               &stats->hits, &stats->misses, &stats->evictions, &stats->entries,
+               &stats->total_size);
+    }
+    return fd;
+}
+
+static void unlock_stats(int fd, const CacheStats *stats)
+{
+    char text[256];
+    int length = snprintf(text, sizeof(text), "hits %ld\nmisses %ld\nevictions %ld\nentries %ld\nsize %zu\n",
+                          stats->hits, stats->misses, stats->evictions, stats->entries,
+                          stats->total_size);
+    if (ftruncate(fd, 0) == 0 && pwrite(fd, text, (size_t)length, 0) != length)
+    {
+        // 统计信息只是参考，写失败时忽略
+    }
+    flock(fd, LOCK_UN);
+    close(fd);
+}
+
+static void record_lookup(CompileCache *cache, int hit)
+{
+    pthread_mutex_lock(&cache->lock);
+    if (hit)
+        cache->session_hits++;
+    else
+        cache->session_misses++;
+    pthread_mutex_unlock(&cache->lock);
+
+    CacheStats stats;
+    int fd = lock_stats(cache, &stats);
+    if (fd < 0)
+        return;
+    if (hit)
+        stats.hits++;
+    else
+        stats.misses++;
+    unlock_stats(fd, &stats);
+}
+
+// ========== 淘汰 ==========
+
+static int is_entry_name(const char *name)
+{
+    size_t length = strlen(name);
+    if (length != SHA256_HEX_SIZE - 1 + 2 || name[length - 2] != '.')
+        return 0;
+    return name[length - 1] == 's' || name[length - 1] == 'o';
+}
+
+static int compare_entry_age(const void *a, const void *b)
+{
+    const CacheEntry *x = (const CacheEntry *)a;
+    const CacheEntry *y = (const CacheEntry *)b;
+    if (x->mtime != y->mtime)
+        return x->mtime < y->mtime ? -1 : 1;
+    return strcmp(x->name, y->name);
+}
+
+// 重新统计缓存目录，按最近使用时间（mtime，命中时会更新）从旧到新删除，
+// 直到总大小不超过低水位。调用者持有统计文件锁
+static void evict_entries(CompileCache *cache, CacheStats *stats)
+{
+    DIR *dir = opendir(cache->directory);
+    if (!dir)
+        return;
+
+    CacheEntry *entries = NULL;
+    int num_entries = 0;
+    int capacity = 0;
+    size_t total = 0;
+    struct dirent *ent;
+    while ((ent = readdir(dir)) != NULL)
+    {
+        if (!is_entry_name(ent->d_name))
+            continue;
+        char *path = join_path(cache->directory, ent->d_name, "");
+        struct stat st;
+        int found = stat(path, &st) == 0;
+        free(path);
+        if (!found)
+            continue;
+
+        if (num_entries >= capacity)
+        {
+            capacity = capacity ? capacity * 2 : 64;
+            entries = (CacheEntry *)realloc(entries, sizeof(CacheEntry) * capacity);
+            if (!entries)
+            {
+                fprintf(stderr, "Out of memory\n");
+                exit(1);
+            }
+        }
+        entries[num_entries].name = strdup(ent->d_name);
+        entries[num_entries].mtime = st.st_mtime;
+        entries[num_entries].size = (size_t)st.st_size;
+        total += (size_t)st.st_size;
+        num_entries++;
+    }
+    closedir(dir);
+
+    qsort(entries, num_entries, sizeof(CacheEntry), compare_entry_age);
+    size_t target = CACHE_LOW_WATERMARK(cache->max_size);
+    int remaining = num_entries;
+    for (int i = 0; i < num_entries && total > target; i++)
+    {
+        char *path = join_path(cache->directory, entries[i].name, "");
+        if (unlink(path) == 0)
+        {
+            total -= entries[i].size;
+            remaining--;
+            stats->evictions++;
+        }
+        free(path);
+    }
+
+    for (int i = 0; i < num_entries; i++)
+        free(entries[i].name);
+    free(entries);
+    stats->entries = remaining;
+    stats->total_size = total;
+}
+
+// ========== 接口 ==========
+
+CompileCache *compile_cache_open(const char *directory, size_t max_size, FILE *diag)
+{
+    if (mkdir(directory, 0755) != 0 && errno != EEXIST)
+    {
+        fprintf(diag, "Warning: cannot create cache directory %s\n", directory);
+        return NULL;
+    }
+
+    CompileCache *cache = (CompileCache *)malloc(sizeof(CompileCache));
+    if (!cache)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    cache->directory = strdup(directory);
+    cache->max_size = max_size;
+    cache->diag = diag;
+    cache->session_hits = 0;
+    cache->session_misses = 0;
+    pthread_mutex_init(&cache->lock, NULL);
+    return cache;
+}
+
+void compile_cache_close(CompileCache *cache)
+{
+    if (!cache)
+        return;
+    pthread_mutex_destroy(&cache->lock);
+    free(cache->directory);
+    free(cache);
+}
+
+// 编译器本身的摘要：重新编译 vc 之后旧的缓存结果不再可用。
+// 按正在运行的可执行文件的内容计算（时间戳只精确到秒，一秒内的两次构建无法区分），每个进程只算一次
+static unsigned char compiler_digest[SHA256_DIGEST_SIZE];
+static pthread_once_t compiler_digest_once = PTHREAD_ONCE_INIT;
+
+static void compute_compiler_digest(void)
+{
+    Sha256 ctx;
+    sha256_init(&ctx);
+    int fd = open("/proc/self/exe", O_RDONLY);
+    if (fd >= 0)
+    {
+        char buffer[65536];
+        for (;;)
+        {
+            ssize_t n = read(fd, buffer, sizeof(buffer));
+            if (n < 0 && errno == EINTR)
+                continue;
+            if (n <= 0)
+                break;
+            sha256_update(&ctx, buffer, (size_t)n);
+        }
+        close(fd);
+    }
+    sha256_final(&ctx, compiler_digest);
+}
+
+void compile_cache_init_compiler_digest(void)
+{
+    pthread_once(&compiler_digest_once, compute_compiler_digest);
+}
+
+void compile_cache_key(const char *text, size_t length, const char *flags,
+                       char key[SHA256_HEX_SIZE])
+{
+    Sha256 ctx;
+    sha256_init(&ctx);
+    sha256_update(&ctx, CACHE_FORMAT_VERSION, sizeof(CACHE_FORMAT_VERSION));
+
+    compile_cache_init_compiler_digest();
+    sha256_update(&ctx, compiler_digest, sizeof(compiler_digest));
+
+    sha256_update(&ctx, flags, strlen(flags) + 1);
+    sha256_update(&ctx, text, length);
+    sha256_final_hex(&ctx, key);
+}
+
+int compile_cache_fetch(CompileCache *cache, const char *key, const char *suffix,
+                        const char *output_file)
+{
+    char *path = join_path(cache->directory, key, suffix);
+    int in = open(path, O_RDONLY);
+    free(path);
+    if (in < 0)
+    {
+        record_lookup(cache, 0);
+        return -1;
+    }
+
+    int result = -1;
+    int out = open(output_file, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (out >= 0)
+    {
+        result = copy_fd_to_fd(in, out);
+        if (close(out) != 0)
+            result = -1;
+    }
+    if (result == 0)
+        futimens(in, NULL); // 更新最近使用时间
+    close(in);
+
+    if (result != 0)
+        unlink(output_file);
+    record_lookup(cache, result == 0);
+    return result;
+}
+
+void compile_cache_store(CompileCache *cache, const char *key, const char *suffix,
+                         const char *output_file)
+{
+    int in = open(output_file, O_RDONLY);
+    if (in < 0)
+        return;
+
+    // 先写临时文件再改名，其他进程不会读到写了一半的条目
+    char *temp_path = join_path(cache->directory, "tmp.XXXXXX", "");
+    int out = mkstemp(temp_path);
+    int ok = 0;
+    if (out >= 0)
+    {
+        fchmod(out, 0644);
+        ok = copy_fd_to_fd(in, out) == 0;
+        if (close(out) != 0)
+            ok = 0;
+    }
+    close(in);
+
+    char *path = join_path(cache->directory, key, suffix);
+    struct stat st;
+    int existed = stat(path, &st) == 0;
+    size_t old_size = existed ? (size_t)st.st_size : 0;
+    if (ok && stat(temp_path, &st) == 0 && rename(temp_path, path) == 0)
+    {
+        CacheStats stats;
+        int fd = lock_stats(cache, &stats);
+        if (fd >= 0)
+        {
+            if (!existed)
+                stats.entries++;
+            stats.total_size -= (stats.total_size >= old_size) ? old_size : stats.total_size;
+            stats.total_size += (size_t)st.st_size;
+            if (stats.total_size > cache->max_size)
+                evict_entries(cache, &stats);
+            unlock_stats(fd, &stats);
+        }
+    }
+    else
+    {
+        if (out >= 0)
+            unlink(temp_path);
+        fprintf(cache->diag, "  ⚠ Cannot store %s in cache\n", output_file);
+    }
+    free(temp_path);
+    free(path);
+}
+
+void compile_cache_session_stats(CompileCache *cache, long *hits, long *misses)
+{
+    pthread_mutex_lock(&cache->lock);
+    *hits = cache->session_hits;
+    *misses = cache->session_misses;
+    pthread_mutex_unlock(&cache->lock);
+}
+
+int compile_cache_read_stats(CompileCache *cache, CacheStats *stats)
+{
+    int fd = lock_stats(cache, stats);
+    if (fd < 0)
+        return -1;
+    flock(fd, LOCK_UN);
+    close(fd);
+    return 0;
+}
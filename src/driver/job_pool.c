@@ -0,0 +1,173 @@
+#include "job_pool.h"
+#include <stdlib.h>
+#include <pthread.h>
+
+// 线程池共享状态
+typedef struct JobPool
+{
+    CompileJob *jobs;
+    int num_jobs;
+    CompileJobFunc func;
+    void *ctx;
+    int next_job;     // 下一个待领取的任务
+    int first_failed; // 最早失败的任务下标（之后的任务不再领取）
+    pthread_mutex_t lock;
+    pthread_cond_t job_done;
+} JobPool;
+
+// 工作线程：按顺序领取任务，输出缓冲到内存流中
+static void *worker_main(void *arg)
+{
+    JobPool *pool = (JobPool *)arg;
+
+    for (;;)
+    {
+        pthread_mutex_lock(&pool->lock);
+        if (pool->next_job >= pool->num_jobs || pool->next_job > pool->first_failed)
+        {
+            pthread_mutex_unlock(&pool->lock);
+            break;
+        }
+        int index = pool->next_job++;
+        pthread_mutex_unlock(&pool->lock);
+
+        CompileJob *job = &pool->jobs[index];
+        FILE *log = open_memstream(&job->log_text, &job->log_size);
+        FILE *diag = open_memstream(&job->diag_text, &job->diag_size);
+        int status = 1;
+        if (log && diag)
+        {
+            status = pool->func(job, log, diag, pool->ctx);
+        }
+        if (log)
+            fclose(log);
+        if (diag)
+            fclose(diag);
+
+        pthread_mutex_lock(&pool->lock);
+        job->status = status;
+        job->done = 1;
+        if (status != 0 && index < pool->first_failed)
+        {
+            pool->first_failed = index;
+        }
+        pthread_cond_broadcast(&pool->job_done);
+        pthread_mutex_unlock(&pool->lock);
+    }
+    return NULL;
+}
+
+// 回放任务输出并释放缓冲区
+static void replay_job_output(CompileJob *job)
+{
+    if (job->log_text)
+    {
+        fwrite(job->log_text, 1, job->log_size, stdout);
+        fflush(stdout);
+    }
+    if (job->diag_text)
+    {
+        fwrite(job->diag_text, 1, job->diag_size, stderr);
+        fflush(stderr);
+    }
+    free(job->log_text);
+    free(job->diag_text);
+    job->log_text = NULL;
+    job->diag_text = NULL;
+}
+
+// 顺序执行（-j 1）：直接输出到 stdout/stderr
+static int run_sequential(CompileJob *jobs, int num_jobs, CompileJobFunc func, void *ctx)
+{
+    for (int i = 0; i < num_jobs; i++)
+    {
+        jobs[i].status = func(&jobs[i], stdout, stderr, ctx);
+        jobs[i].done = 1;
+        if (jobs[i].status != 0)
+            return i;
+    }
+    return -1;
+}
+
+int job_pool_run(CompileJob *jobs, int num_jobs, int num_workers,
+                 CompileJobFunc func, void *ctx)
+{
+    for (int i = 0; i < num_jobs; i++)
+    {
+        jobs[i].status = 0;
+        jobs[i].done = 0;
+        jobs[i].log_text = NULL;
+        jobs[i].log_size = 0;
+        jobs[i].diag_text = NULL;
+        jobs[i].diag_size = 0;
+    }
+
+    if (num_workers > num_jobs)
+        num_workers = num_jobs;
+    if (num_workers <= 1)
+        return run_sequential(jobs, num_jobs, func, ctx);
+
+    JobPool pool;
+    pool.jobs = jobs;
+    pool.num_jobs = num_jobs;
+    pool.func = func;
+    pool.ctx = ctx;
+    pool.next_job = 0;
+    pool.first_failed = num_jobs;
+    pthread_mutex_init(&pool.lock, NULL);
+    pthread_cond_init(&pool.job_done, NULL);
+
+    pthread_t *threads = (pthread_t *)malloc(sizeof(pthread_t) * num_workers);
+    int num_threads = 0;
+    for (int i = 0; i < num_workers; i++)
+    {
+        if (pthread_create(&threads[num_threads], NULL, worker_main, &pool) == 0)
+            num_threads++;
+    }
+
+    int failed = -1;
+    if (num_threads == 0)
+    {
+        // 无法创建线程：退回顺序执行
+        failed = run_sequential(jobs, num_jobs, func, ctx);
+    }
+    else
+    {
+        // 按输入顺序等待并回放输出，保证诊断顺序与顺序编译一致
+        for (int i = 0; i < num_jobs; i++)
+        {
+            pthread_mutex_lock(&pool.lock);
+            while (!jobs[i].done)
+            {
+                pthread_cond_wait(&pool.job_done, &pool.lock);
+            }
+            pthread_mutex_unlock(&pool.lock);
+
+            replay_job_output(&jobs[i]);
+            if (jobs[i].status != 0)
+            {
+                failed = i;
+                break;
+            }
+        }
+    }
+
+    for (int i = 0; i < num_threads; i++)
+    {
+        pthread_join(threads[i], NULL);
+    }
+    free(threads);
+
+    // 丢弃失败任务之后已完成任务的输出（顺序编译时它们不会运行）
+    for (int i = 0; i < num_jobs; i++)
+    {
+        free(jobs[i].log_text);
+        free(jobs[i].diag_text);
+        jobs[i].log_text = NULL;
+        jobs[i].diag_text = NULL;
+    }
+
+    pthread_cond_destroy(&pool.job_done);
+    pthread_mutex_destroy(&pool.lock);
+    return failed;
+}
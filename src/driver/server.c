@@ -0,0 +1,462 @@
+#include "server.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdint.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include <limits.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/types.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+
+// 请求格式：4 字节长度（附带 SCM_RIGHTS 传递的 3 个文件描述符），
+// 随后是以 '\0' 分隔的 工作目录、环境变量个数（十进制）、各个环境变量、argv[0]、argv[1] ...
+// 应答格式：4 字节退出码
+// 子进程通过数据报套接字把新读入的文件路径（每个数据报一个，以 '\0' 结尾）报告给服务器进程
+#define MAX_REQUEST_SIZE (1 << 20)
+#define NUM_PASSED_FDS 3
+
+extern char **environ;
+
+static volatile sig_atomic_t server_stopping = 0;
+
+static void handle_stop_signal(int sig)
+{
+    (void)sig;
+    server_stopping = 1;
+}
+
+static int fill_socket_address(struct sockaddr_un *addr, const char *socket_path)
+{
+    memset(addr, 0, sizeof(*addr));
+    addr->sun_family = AF_UNIX;
+    if (strlen(socket_path) >= sizeof(addr->sun_path))
+    {
+        fprintf(stderr, "Socket path too long: %s\n", socket_path);
+        return -1;
+    }
+    strcpy(addr->sun_path, socket_path);
+    return 0;
+}
+
+static int read_fully(int fd, void *buffer, size_t size)
+{
+    char *p = (char *)buffer;
+    while (size > 0)
+    {
+        ssize_t n = read(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        p += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+static int write_fully(int fd, const void *buffer, size_t size)
+{
+    const char *p = (const char *)buffer;
+    while (size > 0)
+    {
+        ssize_t n = write(fd, p, size);
+        if (n < 0 && errno == EINTR)
+            continue;
+        if (n <= 0)
+            return -1;
+        p += n;
+        size -= (size_t)n;
+    }
+    return 0;
+}
+
+// ========== 服务器 ==========
+
+// 接收请求头：长度和客户端的 stdin/stdout/stderr
+static int receive_header(int conn, uint32_t *length, int *fds)
+{
+    char control[CMSG_SPACE(sizeof(int) * NUM_PASSED_FDS)];
+    struct iovec iov;
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    iov.iov_base = length;
+    iov.iov_len = sizeof(*length);
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t n;
+    do
+    {
+        n = recvmsg(conn, &msg, 0);
+    } while (n < 0 && errno == EINTR);
+    if (n != (ssize_t)sizeof(*length))
+        return -1;
+
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    if (!cmsg || cmsg->cmsg_level != SOL_SOCKET || cmsg->cmsg_type != SCM_RIGHTS ||
+        cmsg->cmsg_len != CMSG_LEN(sizeof(int) * NUM_PASSED_FDS))
+        return -1;
+    memcpy(fds, CMSG_DATA(cmsg), sizeof(int) * NUM_PASSED_FDS);
+    return 0;
+}
+
+// 子进程把路径发给服务器进程；队列满时丢弃（只影响预热）
+static void send_report(const char *path, void *ctx)
+{
+    int fd = *(int *)ctx;
+    send(fd, path, strlen(path) + 1, MSG_DONTWAIT | MSG_NOSIGNAL);
+}
+
+// 服务器进程预热子进程报告的文件
+static void receive_reports(int fd, const ServerCacheHooks *hooks)
+{
+    char path[PATH_MAX + 1];
+    ssize_t n;
+    while ((n = recv(fd, path, sizeof(path) - 1, MSG_DONTWAIT)) > 0)
+    {
+        path[n] = '\0';
+        hooks->warm(path);
+    }
+}
+
+// 在子进程中执行一次请求：切换到客户端的工作目录，环境变量、标准流换成客户端的
+static int serve_request(int conn, ServerRequestFunc handler, const ServerCacheHooks *hooks, int report_fd)
+{
+    uint32_t length;
+    int fds[NUM_PASSED_FDS];
+    if (receive_header(conn, &length, fds) != 0)
+        return -1;
+
+    int status = -1;
+    char *payload = NULL;
+    char **argv = NULL;
+    char **env = NULL;
+    if (length == 0 || length > MAX_REQUEST_SIZE)
+        goto done;
+    payload = (char *)malloc(length + 1);
+    if (!payload || read_fully(conn, payload, length) != 0)
+        goto done;
+    payload[length] = '\0';
+
+    // 拆分 工作目录 + 环境变量 + argv
+    int count = 0;
+    for (uint32_t i = 0; i < length; i++)
+    {
+        if (payload[i] == '\0')
+            count++;
+    }
+    if (count < 3)
+        goto done;
+    char *p = payload;
+    const char *cwd = p;
+    p += strlen(p) + 1;
+    char *end;
+    long num_env = strtol(p, &end, 10);
+    if (*end != '\0' || num_env < 0 || num_env > count - 3)
+        goto done;
+    p += strlen(p) + 1;
+    argv = (char **)malloc(sizeof(char *) * count);
+    env = (char **)malloc(sizeof(char *) * (num_env + 1));
+    if (!argv || !env)
+        goto done;
+    for (long i = 0; i < num_env; i++)
+    {
+        env[i] = p;
+        p += strlen(p) + 1;
+    }
+    env[num_env] = NULL;
+    environ = env; // 子进程处理完请求就退出，不需要恢复
+    int argc = 0;
+    while (argc < count - 2 - num_env)
+    {
+        argv[argc++] = p;
+        p += strlen(p) + 1;
+    }
+    argv[argc] = NULL;
+
+    if (chdir(cwd) != 0)
+    {
+        dprintf(fds[2], "vc server: cannot change to directory %s\n", cwd);
+        status = 1;
+        goto done;
+    }
+
+    fflush(stdout);
+    fflush(stderr);
+    for (int i = 0; i < NUM_PASSED_FDS; i++)
+        dup2(fds[i], i);
+
+    // 只报告这次请求读入的文件，不报告从服务器进程继承来的记录
+    if (hooks)
+        hooks->collect(NULL, NULL);
+    status = handler(argc, argv);
+
+    fflush(stdout);
+    fflush(stderr);
+    if (hooks)
+        hooks->collect(send_report, &report_fd);
+
+done:
+    for (int i = 0; i < NUM_PASSED_FDS; i++)
+        close(fds[i]);
+    if (status >= 0)
+    {
+        int32_t reply = status;
+        write_fully(conn, &reply, sizeof(reply));
+    }
+    free(argv);
+    // environ 指向 payload 时保留它们直到子进程退出
+    if (environ != env)
+    {
+        free(env);
+        free(payload);
+    }
+    return status;
+}
+
+int server_run(const char *socket_path, ServerRequestFunc handler, const ServerCacheHooks *hooks)
+{
+    struct sockaddr_un addr;
+    if (fill_socket_address(&addr, socket_path) != 0)
+        return 1;
+
+    int listener = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listener < 0)
+    {
+        perror("socket");
+        return 1;
+    }
+
+    if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        // 套接字文件已存在：能连上说明已有服务器在运行，否则是上次遗留的文件
+        int bind_error = errno;
+        int probe = socket(AF_UNIX, SOCK_STREAM, 0);
+        int in_use = probe >= 0 && connect(probe, (struct sockaddr *)&addr, sizeof(addr)) == 0;
+        if (probe >= 0)
+            close(probe);
+        if (bind_error != EADDRINUSE)
+        {
+            perror(socket_path);
+            close(listener);
+            return 1;
+        }
+        if (in_use)
+        {
+            fprintf(stderr, "A server is already listening on %s\n", socket_path);
+            close(listener);
+            return 1;
+        }
+        unlink(socket_path);
+        if (bind(listener, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+        {
+            perror(socket_path);
+            close(listener);
+            return 1;
+        }
+    }
+    if (listen(listener, 64) != 0)
+    {
+        perror("listen");
+        close(listener);
+        unlink(socket_path);
+        return 1;
+    }
+
+    // 不设置 SA_RESTART，让 accept 在收到信号后返回
+    struct sigaction sa;
+    memset(&sa, 0, sizeof(sa));
+    sa.sa_handler = handle_stop_signal;
+    sigemptyset(&sa.sa_mask);
+    sigaction(SIGINT, &sa, NULL);
+    sigaction(SIGTERM, &sa, NULL);
+    signal(SIGPIPE, SIG_IGN);
+    signal(SIGCHLD, SIG_IGN); // 子进程退出后自动回收
+
+    // 子进程向服务器进程报告新读入的文件
+    int reports[2] = {-1, -1};
+    if (hooks && socketpair(AF_UNIX, SOCK_DGRAM, 0, reports) != 0)
+    {
+        perror("socketpair");
+        reports[0] = reports[1] = -1;
+    }
+    for (int i = 0; i < 2; i++)
+    {
+        if (reports[i] >= 0)
+            fcntl(reports[i], F_SETFD, FD_CLOEXEC);
+    }
+
+    printf("vc server listening on %s\n", socket_path);
+    fflush(stdout);
+
+    // 每个请求 fork 一个子进程处理：子进程继承服务器已加载的状态（头文件缓存等），
+    // 多个请求可以同时编译，编译器崩溃也不会影响服务器
+    long num_requests = 0;
+    while (!server_stopping)
+    {
+        struct pollfd pfds[2];
+        pfds[0].fd = listener;
+        pfds[0].events = POLLIN;
+        pfds[1].fd = reports[0];
+        pfds[1].events = POLLIN;
+        int ready = poll(pfds, reports[0] >= 0 ? 2 : 1, -1);
+        if (ready < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("poll");
+            break;
+        }
+        if (reports[0] >= 0 && (pfds[1].revents & POLLIN))
+            receive_reports(reports[0], hooks);
+        if (!(pfds[0].revents & POLLIN))
+            continue;
+
+        int conn = accept(listener, NULL, NULL);
+        if (conn < 0)
+        {
+            if (errno == EINTR)
+                continue;
+            perror("accept");
+            break;
+        }
+
+        num_requests++;
+        pid_t pid = fork();
+        if (pid == 0)
+        {
+            close(listener);
+            if (reports[0] >= 0)
+                close(reports[0]);
+            signal(SIGINT, SIG_DFL);
+            signal(SIGTERM, SIG_DFL);
+            signal(SIGCHLD, SIG_DFL);
+            int status = serve_request(conn, handler, reports[1] >= 0 ? hooks : NULL, reports[1]);
+            if (status < 0)
+                fprintf(stderr, "vc server: malformed request %ld\n", num_requests);
+            _exit(status < 0 ? 1 : status);
+        }
+        if (pid < 0)
+            perror("fork");
+        close(conn);
+    }
+
+    close(listener);
+    for (int i = 0; i < 2; i++)
+    {
+        if (reports[i] >= 0)
+            close(reports[i]);
+    }
+    unlink(socket_path);
+    printf("vc server stopped after %ld request(s)\n", num_requests);
+    return 0;
+}
+
+// ========== 客户端 ==========
+
+int client_forward(const char *socket_path, int argc, char **argv, int *exit_status)
+{
+    struct sockaddr_un addr;
+    if (fill_socket_address(&addr, socket_path) != 0)
+        return -1;
+
+    char cwd[PATH_MAX];
+    if (!getcwd(cwd, sizeof(cwd)))
+        return -1;
+
+    // 环境变量整体转发（VC_CACHE_DIR、PATH 等），服务器上的编译和本地编译看到的相同
+    int num_env = 0;
+    while (environ[num_env])
+        num_env++;
+    char env_count[16];
+    snprintf(env_count, sizeof(env_count), "%d", num_env);
+
+    size_t length = strlen(cwd) + 1 + strlen(env_count) + 1;
+    for (int i = 0; i < num_env; i++)
+        length += strlen(environ[i]) + 1;
+    for (int i = 0; i < argc; i++)
+        length += strlen(argv[i]) + 1;
+    if (length > MAX_REQUEST_SIZE)
+        return -1;
+
+    char *payload = (char *)malloc(length);
+    if (!payload)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    char *p = payload;
+    strcpy(p, cwd);
+    p += strlen(cwd) + 1;
+    strcpy(p, env_count);
+    p += strlen(env_count) + 1;
+    for (int i = 0; i < num_env; i++)
+    {
+        strcpy(p, environ[i]);
+        p += strlen(environ[i]) + 1;
+    }
+    for (int i = 0; i < argc; i++)
+    {
+        strcpy(p, argv[i]);
+        p += strlen(argv[i]) + 1;
+    }
+
+    int conn = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (conn < 0 || connect(conn, (struct sockaddr *)&addr, sizeof(addr)) != 0)
+    {
+        if (conn >= 0)
+            close(conn);
+        free(payload);
+        return -1;
+    }
+    signal(SIGPIPE, SIG_IGN);
+
+    // 长度和标准流描述符一起发送
+    uint32_t header = (uint32_t)length;
+    int fds[NUM_PASSED_FDS] = {STDIN_FILENO, STDOUT_FILENO, STDERR_FILENO};
+    char control[CMSG_SPACE(sizeof(fds))];
+    memset(control, 0, sizeof(control));
+    struct iovec iov;
+    iov.iov_base = &header;
+    iov.iov_len = sizeof(header);
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+    struct cmsghdr *cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(fds));
+    memcpy(CMSG_DATA(cmsg), fds, sizeof(fds));
+
+    int32_t reply;
+    int result = -1;
+    if (sendmsg(conn, &msg, 0) == (ssize_t)sizeof(header) &&
+        write_fully(conn, payload, length) == 0)
+    {
+        // 请求已发出：之后的失败不能再退回本地编译（可能已经产生了输出）
+        result = 0;
+        if (read_fully(conn, &reply, sizeof(reply)) == 0)
+        {
+            *exit_status = reply;
+        }
+        else
+        {
+            fprintf(stderr, "vc: server %s terminated while compiling\n", socket_path);
+            *exit_status = 1;
+        }
+    }
+
+    close(conn);
+    free(payload);
+    return result;
+}
@@ -0,0 +1,211 @@
+#include "time_report.h"
+#include <string.h>
+#include <time.h>
+#include <sys/resource.h>
+
+// ========== 内存分配统计 ==========
+// 在可执行文件中定义 malloc/calloc/realloc/free，转发给 glibc 的实现并计数。
+// 计数器是线程局部的，-j 并行编译时每个文件只统计自己线程的分配
+
+static int alloc_tracking = 0;
+static __thread long thread_allocations = 0;
+static __thread size_t thread_alloc_bytes = 0;
+
+void time_report_enable_alloc_tracking(void)
+{
+    alloc_tracking = 1;
+}
+
+#if !defined(__SANITIZE_ADDRESS__) && defined(__GLIBC__)
+extern void *__libc_malloc(size_t size);
+extern void *__libc_calloc(size_t count, size_t size);
+extern void *__libc_realloc(void *ptr, size_t size);
+extern void __libc_free(void *ptr);
+
+void *malloc(size_t size)
+{
+    if (alloc_tracking)
+    {
+        thread_allocations++;
+        thread_alloc_bytes += size;
+    }
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    if (alloc_tracking)
+    {
+        thread_allocations++;
+        thread_alloc_bytes += count * size;
+    }
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    if (alloc_tracking)
+    {
+        thread_allocations++;
+        thread_alloc_bytes += size;
+    }
+    return __libc_realloc(ptr, size);
+}
+
+void free(void *ptr)
+{
+    __libc_free(ptr);
+}
+#endif
+
+// ========== 计时 ==========
+
+static double clock_ms(clockid_t clock)
+{
+    struct timespec ts;
+    clock_gettime(clock, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+static double children_cpu_ms(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_CHILDREN, &usage);
+    return (usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000.0 +
+           (usage.ru_utime.tv_usec + usage.ru_stime.tv_usec) / 1000.0;
+}
+
+static long peak_rss_kb(void)
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return usage.ru_maxrss;
+}
+
+void phase_timer_start(PhaseTimer *timer, FileTimeReport *report)
+{
+    if (!report)
+        return;
+    timer->wall_ms = clock_ms(CLOCK_MONOTONIC);
+    timer->cpu_ms = clock_ms(CLOCK_THREAD_CPUTIME_ID) + children_cpu_ms();
+    timer->peak_rss_kb = peak_rss_kb();
+    timer->allocations = thread_allocations;
+    timer->alloc_bytes = thread_alloc_bytes;
+}
+
+void phase_timer_stop(PhaseTimer *timer, FileTimeReport *report, CompilePhase phase)
+{
+    if (!report)
+        return;
+    PhaseStats *stats = &report->phases[phase];
+    stats->measured = 1;
+    stats->wall_ms += clock_ms(CLOCK_MONOTONIC) - timer->wall_ms;
+    stats->cpu_ms += clock_ms(CLOCK_THREAD_CPUTIME_ID) + children_cpu_ms() - timer->cpu_ms;
+    stats->peak_rss_kb += peak_rss_kb() - timer->peak_rss_kb;
+    stats->allocations += thread_allocations - timer->allocations;
+    stats->alloc_bytes += thread_alloc_bytes - timer->alloc_bytes;
+}
+
+const char *compile_phase_name(CompilePhase phase)
+{
+    static const char *names[PHASE_COUNT] = {
+        "preprocess", "parse", "semantic", "codegen", "assemble", "link"};
+    return (phase >= 0 && phase < PHASE_COUNT) ? names[phase] : "unknown";
+}
+
+// ========== 输出 ==========
+
+static void print_stats_row(FILE *out, const char *label, const PhaseStats *stats)
+{
+    fprintf(out, "    %-12s %10.3f %10.3f %10ld %10ld %12zu\n", label, stats->wall_ms,
+            stats->cpu_ms, stats->peak_rss_kb, stats->allocations, stats->alloc_bytes);
+}
+
+static void add_stats(PhaseStats *total, const PhaseStats *stats)
+{
+    total->wall_ms += stats->wall_ms;
+    total->cpu_ms += stats->cpu_ms;
+    total->peak_rss_kb += stats->peak_rss_kb;
+    total->allocations += stats->allocations;
+    total->alloc_bytes += stats->alloc_bytes;
+}
+
+void time_report_print(FILE *out, FileTimeReport *reports, int num_reports)
+{
+    PhaseStats grand_total;
+    memset(&grand_total, 0, sizeof(grand_total));
+
+    fprintf(out, "[Time Report]\n");
+    for (int i = 0; i < num_reports; i++)
+    {
+        PhaseStats total;
+        memset(&total, 0, sizeof(total));
+        fprintf(out, "  %s\n", reports[i].name);
+        fprintf(out, "    %-12s %10s %10s %10s %10s %12s\n", "Phase", "Wall(ms)", "CPU(ms)",
+                "RSS(+KB)", "Allocs", "Bytes");
+        for (int p = 0; p < PHASE_COUNT; p++)
+        {
+            if (!reports[i].phases[p].measured)
+                continue;
+            print_stats_row(out, compile_phase_name((CompilePhase)p), &reports[i].phases[p]);
+            add_stats(&total, &reports[i].phases[p]);
+        }
+        print_stats_row(out, "total", &total);
+        add_stats(&grand_total, &total);
+    }
+    if (num_reports > 1)
+    {
+        fprintf(out, "  All files\n");
+        print_stats_row(out, "total", &grand_total);
+    }
+}
+
+static void print_json_string(FILE *out, const char *text)
+{
+    fputc('"', out);
+    for (const unsigned char *p = (const unsigned char *)text; *p; p++)
+    {
+        if (*p == '"' || *p == '\\')
+            fprintf(out, "\\%c", *p);
+        else if (*p < 0x20)
+            fprintf(out, "\\u%04x", *p);
+        else
+            fputc(*p, out);
+    }
+    fputc('"', out);
+}
+
+static void print_json_stats(FILE *out, const PhaseStats *stats)
+{
+    fprintf(out, "{\"wall_ms\": %.3f, \"cpu_ms\": %.3f, \"peak_rss_delta_kb\": %ld, "
+                 "\"allocations\": %ld, \"allocated_bytes\": %zu}",
+            stats->wall_ms, stats->cpu_ms, stats->peak_rss_kb, stats->allocations,
+            stats->alloc_bytes);
+}
+
+void time_report_print_json(FILE *out, FileTimeReport *reports, int num_reports)
+{
+    fprintf(out, "{\n  \"files\": [\n");
+    for (int i = 0; i < num_reports; i++)
+    {
+        PhaseStats total;
+        memset(&total, 0, sizeof(total));
+        fprintf(out, "    {\n      \"name\": ");
+        print_json_string(out, reports[i].name);
+        fprintf(out, ",\n      \"phases\": {");
+        int first = 1;
+        for (int p = 0; p < PHASE_COUNT; p++)
+        {
+            if (!reports[i].phases[p].measured)
+                continue;
+            fprintf(out, "%s\n        \"%s\": ", first ? "" : ",", compile_phase_name((CompilePhase)p));
+            print_json_stats(out, &reports[i].phases[p]);
+            add_stats(&total, &reports[i].phases[p]);
+            first = 0;
+        }
+        fprintf(out, "\n      },\n      \"total\": ");
+        print_json_stats(out, &total);
+        fprintf(out, "\n    }%s\n", i + 1 < num_reports ? "," : "");
+    }
+    fprintf(out, "  ]\n}\n");
+}
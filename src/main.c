@@ -6,10 +6,29 @@
 #include "semantic.h"
 #include "codegen.h"
 #include "preprocessor.h"
+#include "parser.h"
+#include "job_pool.h"
+#include "assembler.h"
+#include "elf_writer.h"
+#include "jit.h"
+#include "server.h"
+#include "compile_cache.h"
+#include "time_report.h"
+#include "build_db.h"
 
-extern int yyparse();
-extern ASTNode *ast_root;
-extern FILE *yyin;
+// 编译选项（所有任务共享，只读）
+typedef struct CompileOptions
+{
+    int debug_mode;
+    int emit_object;        // 生成目标文件（否则生成汇编文本）
+    int integrated_as;      // 使用内置汇编器（-fno-integrated-as 时调用 gcc -c）
+    CompileCache *cache;    // 编译缓存（--cache-dir，未启用时为 NULL）
+    BuildDb *build_db;      // 依赖数据库（--incremental，未启用时为 NULL）
+    int write_deps;         // -MD：为每个输出写 .d 依赖文件
+    int dump_ir;            // --dump-ir：把每个函数的 IR 写入编译日志
+    PassOptions passes;     // -O 级别、-f<遍名>/-fno-<遍名>、-v（各遍耗时写入编译日志）
+    char output_flags[256]; // 影响输出内容的选项（缓存键和依赖数据库使用）
+} CompileOptions;
 
 void print_usage(const char *program_name) {
     printf("Usage: %s [options] <input.c> [input2.c ...]\n", program_name);
@@ -17,153 +36,680 @@ void print_usage(const char *program_name) {
     printf("  -S           Generate assembly code only (.s files)\n");
     printf("  -c           Compile only (generate .o files)\n");
     printf("  -o <file>    Output file name\n");
+    printf("  -j <N>       Compile up to N files in parallel\n");
+    printf("  -fno-integrated-as  Assemble with 'gcc -c' instead of the built-in assembler\n");
+    printf("  -O0, -O1, -O2  Optimization level (default -O1; -O0 keeps every value on the stack)\n");
+    printf("  -f<pass>, -fno-<pass>  Enable or disable a single optimization pass\n");
+    printf("  -finline-limit=<n>  Largest function body (IR instructions) the inline pass expands\n");
+    printf("  -funroll-loops      Unroll counted for loops (off by default)\n");
+    printf("  -funroll-factor=<n> Loop body copies per unrolled iteration, 2..16 (default 4)\n");
+    printf("  -mavx2              Vectorize with AVX2 (default SSE2)\n");
+    printf("  -v, --verbose  Print the time spent in each optimization pass\n");
+    printf("  --incremental  Only recompile inputs whose source or included headers changed\n");
+    printf("               (dependencies are kept in %s; objects are kept after linking)\n",
+           BUILD_DB_DEFAULT_PATH);
+    printf("  -MD          Write a make dependency file (.d) next to each output\n");
+    printf("  --unity      Compile all inputs into one assembly/object file (shared string table,\n");
+    printf("               one data section, static symbols renamed per file)\n");
+    printf("  --run        Compile in memory and run main() directly (args after '--')\n");
     printf("  --debug      Enable debug output (AST and symbol table)\n");
+    printf("  --dump-ir    Print each function's IR (basic blocks, virtual registers) while compiling\n");
+    printf("  --peephole-self-test  Run the before/after examples of every peephole rule and exit\n");
+    printf("  --cache-dir <dir>   Cache .s/.o files keyed on preprocessed source\n");
+    printf("                      (also enabled by the VC_CACHE_DIR environment variable)\n");
+    printf("  --cache-size <MB>   Cache size limit, least recently used entries are evicted (default 256)\n");
+    printf("  --cache-stats       Print cache hit/miss counters\n");
+    printf("  --time-report       Print time, CPU, peak RSS and allocations per phase and file\n");
+    printf("  --time-report-json <file>  Write the same report as JSON ('-' for stdout;\n");
+    printf("                      all other output then goes to stderr)\n");
+    printf("  --server <socket>   Run as a compile server on a Unix socket\n");
+    printf("  --connect <socket>  Send this compilation to a running server\n");
+    printf("                      (also enabled by the VC_SERVER environment variable)\n");
     printf("  -h, --help   Show this help message\n");
+    printf("\n");
+    pass_options_print_help(stdout);
     printf("\nExamples:\n");
     printf("  %s program.c              # Compile to executable 'output'\n", program_name);
     printf("  %s -S program.c           # Generate program.s (assembly)\n", program_name);
     printf("  %s -o test test.c         # Compile to executable 'test'\n", program_name);
     printf("  %s -c file1.c file2.c     # Generate file1.o and file2.o\n", program_name);
     printf("  %s file1.c file2.c        # Compile and link multiple files\n", program_name);
+    printf("  %s -j 8 *.c               # Compile with 8 worker threads\n", program_name);
+    printf("  %s --unity -S -o all.s *.c  # Generate a single all.s for all inputs\n", program_name);
+    printf("  %s --incremental a.c b.c  # Rebuild only what changed since the last run\n", program_name);
+    printf("  %s --run prog.c -- a b    # Run prog.c in memory with arguments\n", program_name);
+    printf("  %s --server /tmp/vc.sock  # Keep a warm compiler running\n", program_name);
+    printf("  %s --connect /tmp/vc.sock -c a.c  # Compile a.c on the server\n", program_name);
     printf("  %s --debug program.c      # Compile with debug info\n", program_name);
 }
 
-// 编译单个文件到汇编
-int compile_to_assembly(const char *input_file, const char *output_file, int debug_mode) {
-    printf("\n[Compiling] %s → %s\n", input_file, output_file);
-    
+// 预处理一个文件，返回的代码以两个 '\0' 结尾（调用者负责释放），失败返回 NULL。
+// headers 不为 NULL 时返回读入的头文件列表（调用者负责释放）
+static char *preprocess_file(const char *input_file, FILE *log, FILE *diag,
+                             FileTimeReport *report, char ***headers, int *num_headers) {
     // ========== Phase 0: Preprocessing ==========
-    printf("  [1/4] Preprocessing...\n");
+    fprintf(log, "  [1/4] Preprocessing...\n");
+    PhaseTimer timer;
+    phase_timer_start(&timer, report);
     
     char *source_code = read_file_content(input_file);
     if (!source_code) {
-        fprintf(stderr, "  ✗ Cannot read input file: %s\n", input_file);
-        return 1;
+        fprintf(diag, "  ✗ Cannot read input file: %s\n", input_file);
+        return NULL;
     }
     
     Preprocessor *pp = preprocessor_create();
     if (!pp) {
-        fprintf(stderr, "  ✗ Cannot create preprocessor\n");
+        fprintf(diag, "  ✗ Cannot create preprocessor\n");
         free(source_code);
-        return 1;
+        return NULL;
     }
+    pp->diag = diag;
     
     char *preprocessed_code = preprocessor_process(pp, source_code, input_file);
     free(source_code);
+    if (headers && preprocessed_code) {
+        *headers = preprocessor_take_included_files(pp, num_headers);
+    }
     preprocessor_free(pp);
+    phase_timer_stop(&timer, report, PHASE_PREPROCESS);
     
     if (!preprocessed_code) {
-        fprintf(stderr, "  ✗ Preprocessing failed\n");
-        return 1;
+        fprintf(diag, "  ✗ Preprocessing failed\n");
+        return NULL;
     }
-    
-    // 写入临时文件
-    char temp_file[] = "/tmp/cc_XXXXXX";
-    int fd = mkstemp(temp_file);
-    if (fd == -1) {
-        fprintf(stderr, "  ✗ Cannot create temporary file\n");
-        free(preprocessed_code);
-        return 1;
-    }
-    
-    FILE *temp_fp = fdopen(fd, "w");
-    fprintf(temp_fp, "%s", preprocessed_code);
-    fclose(temp_fp);
-    free(preprocessed_code);
+    return preprocessed_code;
+}
+
+// 语法分析和语义分析（取得 preprocessed_code 的所有权），成功时返回 AST 和语义分析器
+static int analyze_preprocessed(char *preprocessed_code, int debug_mode, FILE *log, FILE *diag,
+                                FileTimeReport *report, ASTNode **ast_out,
+                                SemanticAnalyzer **analyzer_out) {
+    PhaseTimer timer;
     
     // ========== Phase 1: Parsing ==========
-    printf("  [2/4] Parsing...\n");
+    fprintf(log, "  [2/4] Parsing...\n");
+    phase_timer_start(&timer, report);
     
-    yyin = fopen(temp_file, "r");
-    if (!yyin) {
-        fprintf(stderr, "  ✗ Cannot open temp file\n");
-        unlink(temp_file);
-        return 1;
-    }
+    // 预处理结果直接交给词法分析器，不再写入临时文件
+    ASTNode *ast_root = NULL;
+    int parse_result = parse_buffer(preprocessed_code, strlen(preprocessed_code), diag, &ast_root);
+    free(preprocessed_code);
+    phase_timer_stop(&timer, report, PHASE_PARSE);
     
-    if (yyparse() != 0) {
-        fprintf(stderr, "  ✗ Parsing failed\n");
-        fclose(yyin);
-        unlink(temp_file);
+    if (parse_result != 0) {
+        fprintf(diag, "  ✗ Parsing failed\n");
         return 1;
     }
     
-    fclose(yyin);
-    unlink(temp_file);
-    
     if (!ast_root) {
-        fprintf(stderr, "  ✗ No AST generated\n");
+        fprintf(diag, "  ✗ No AST generated\n");
         return 1;
     }
     
     if (debug_mode) {
-        printf("  [Debug] AST:\n");
+        fprintf(log, "  [Debug] AST:\n");
         print_ast(ast_root, 2);
     }
     
     // ========== Phase 2: Semantic Analysis ==========
-    printf("  [3/4] Semantic Analysis...\n");
+    fprintf(log, "  [3/4] Semantic Analysis...\n");
+    phase_timer_start(&timer, report);
     
     SemanticAnalyzer *analyzer = semantic_analyzer_create();
+    analyzer->diag = diag;
+    analyzer->symbol_table->diag = diag;
     analyze_program(analyzer, ast_root);
+    phase_timer_stop(&timer, report, PHASE_SEMANTIC);
     
     if (debug_mode) {
-        printf("  [Debug] Symbol Table:\n");
+        fprintf(log, "  [Debug] Symbol Table:\n");
         print_symbol_table(analyzer->symbol_table);
     }
     
     if (analyzer->error_count > 0) {
-        fprintf(stderr, "  ✗ Semantic analysis failed with %d error(s)\n", 
+        fprintf(diag, "  ✗ Semantic analysis failed with %d error(s)\n", 
                 analyzer->error_count);
         semantic_analyzer_destroy(analyzer);
         free_ast(ast_root);
-        ast_root = NULL;
         return 1;
     }
     
-    // ========== Phase 3: Code Generation ==========
-    printf("  [4/4] Code Generation...\n");
-    
-    FILE *out = fopen(output_file, "w");
-    if (!out) {
-        fprintf(stderr, "  ✗ Failed to open output file: %s\n", output_file);
-        semantic_analyzer_destroy(analyzer);
-        free_ast(ast_root);
-        ast_root = NULL;
+    *ast_out = ast_root;
+    *analyzer_out = analyzer;
+    return 0;
+}
+
+// 编译预处理后的代码（取得 preprocessed_code 的所有权），汇编代码写入 out
+static int compile_preprocessed(char *preprocessed_code, FILE *out, const CompileOptions *options,
+                                FILE *log, FILE *diag, FileTimeReport *report) {
+    ASTNode *ast_root = NULL;
+    SemanticAnalyzer *analyzer = NULL;
+    if (analyze_preprocessed(preprocessed_code, options->debug_mode, log, diag, report,
+                             &ast_root, &analyzer) != 0) {
         return 1;
     }
     
+    // ========== Phase 3: Code Generation ==========
+    fprintf(log, "  [4/4] Code Generation...\n");
+    PhaseTimer timer;
+    phase_timer_start(&timer, report);
+    
     CodeGenerator *gen = codegen_create(out, analyzer);
+    gen->ir_dump = options->dump_ir ? log : NULL;
+    codegen_set_pass_options(gen, &options->passes);
     generate_code(gen, ast_root);
+    fflush(out);
+    phase_timer_stop(&timer, report, PHASE_CODEGEN);
+    if (options->passes.verbose) {
+        pass_manager_report(gen->passes, log);
+    }
     
-    fclose(out);
     codegen_destroy(gen);
     semantic_analyzer_destroy(analyzer);
     free_ast(ast_root);
-    ast_root = NULL;
+    return 0;
+}
+
+// 编译单个文件，汇编代码写入 out（进度写入 log，诊断写入 diag，可在多个线程中并发调用）
+int compile_to_assembly(const char *input_file, FILE *out, const CompileOptions *options,
+                        FILE *log, FILE *diag, FileTimeReport *report) {
+    char *preprocessed_code = preprocess_file(input_file, log, diag, report, NULL, NULL);
+    if (!preprocessed_code) {
+        return 1;
+    }
+    return compile_preprocessed(preprocessed_code, out, options, log, diag, report);
+}
+
+// 用 gcc 汇编（-fno-integrated-as，或内置汇编器不支持的输入，例如内联汇编）
+static int assemble_with_gcc(const char *asm_text, const char *output_file, FILE *diag) {
+    char cmd[1024];
+    snprintf(cmd, sizeof(cmd), "gcc -x assembler -c - -o %s", output_file);
+    
+    FILE *pipe = popen(cmd, "w");
+    if (!pipe) {
+        fprintf(diag, "  ✗ Failed to run assembler\n");
+        return 1;
+    }
+    fputs(asm_text, pipe);
+    return pclose(pipe) == 0 ? 0 : 1;
+}
+
+// 把汇编文本转换为目标文件：优先使用内置汇编器，直接写出 ELF
+static int assemble_object(const char *asm_text, const char *output_file,
+                           const CompileOptions *options, FILE *log, FILE *diag) {
+    if (options->integrated_as) {
+        ObjectCode *obj = assemble(asm_text, diag);
+        if (obj) {
+            int result = write_elf_object(obj, output_file, diag);
+            object_code_free(obj);
+            return result;
+        }
+        fprintf(diag, "  ⚠ Falling back to external assembler\n");
+    }
+    fprintf(log, "  Running: gcc -c → %s\n", output_file);
+    return assemble_with_gcc(asm_text, output_file, diag);
+}
+
+// 影响输出内容的选项（缓存键和依赖数据库使用）
+static const char *output_flags(const CompileOptions *options) {
+    return options->output_flags;
+}
+
+static void init_output_flags(CompileOptions *options) {
+    char passes[192];
+    snprintf(options->output_flags, sizeof(options->output_flags), "%s %s",
+             !options->emit_object ? "-S" :
+             (options->integrated_as ? "-c" : "-c -fno-integrated-as"),
+             pass_options_string(&options->passes, passes, sizeof(passes)));
+}
+
+// 从预处理结果生成 job 的输出文件（取得 preprocessed_code 的所有权）
+static int build_output(CompileJob *job, const CompileOptions *options, char *preprocessed_code,
+                        FILE *log, FILE *diag) {
+    // 缓存键：预处理结果 + 影响输出的选项
+    char cache_key[SHA256_HEX_SIZE];
+    const char *cache_suffix = options->emit_object ? ".o" : ".s";
+    if (options->cache) {
+        compile_cache_key(preprocessed_code, strlen(preprocessed_code), output_flags(options),
+                          cache_key);
+        if (compile_cache_fetch(options->cache, cache_key, cache_suffix, job->output_file) == 0) {
+            free(preprocessed_code);
+            fprintf(log, "  ✓ Cache hit: %.16s\n", cache_key);
+            fprintf(log, "  ✓ Generated: %s\n", job->output_file);
+            return 0;
+        }
+    }
     
-    printf("  ✓ Generated: %s\n", output_file);
+    if (!options->emit_object) {
+        FILE *out = fopen(job->output_file, "w");
+        if (!out) {
+            fprintf(diag, "  ✗ Failed to open output file: %s\n", job->output_file);
+            free(preprocessed_code);
+            return 1;
+        }
+        int result = compile_preprocessed(preprocessed_code, out, options,
+                                          log, diag, job->time_report);
+        fclose(out);
+        if (result != 0)
+            return result;
+    } else {
+        // 汇编代码只保存在内存中，直接交给汇编器
+        char *asm_text = NULL;
+        size_t asm_size = 0;
+        FILE *out = open_memstream(&asm_text, &asm_size);
+        if (!out) {
+            fprintf(diag, "  ✗ Cannot allocate assembly buffer\n");
+            free(preprocessed_code);
+            return 1;
+        }
+        int result = compile_preprocessed(preprocessed_code, out, options,
+                                          log, diag, job->time_report);
+        fclose(out);
+        if (result == 0) {
+            PhaseTimer timer;
+            phase_timer_start(&timer, job->time_report);
+            result = assemble_object(asm_text, job->output_file, options, log, diag);
+            phase_timer_stop(&timer, job->time_report, PHASE_ASSEMBLE);
+            if (result != 0)
+                fprintf(diag, "  ✗ Assembly failed for %s\n", job->output_file);
+        }
+        free(asm_text);
+        if (result != 0)
+            return result;
+    }
+    
+    if (options->cache) {
+        compile_cache_store(options->cache, cache_key, cache_suffix, job->output_file);
+    }
+    fprintf(log, "  ✓ Generated: %s\n", job->output_file);
     return 0;
 }
 
-int main(int argc, char **argv) {
+// -MD 的依赖文件名：输出文件换成 .d 后缀（a.o → a.d）
+static char *dependency_file_name(const char *output_file) {
+    size_t length = strlen(output_file) + 3;
+    char *dep_file = (char*)malloc(length);
+    if (!dep_file) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    strcpy(dep_file, output_file);
+    char *dot = strrchr(dep_file, '.');
+    if (dot && !strchr(dot, '/')) {
+        *dot = '\0';
+    }
+    strcat(dep_file, ".d");
+    return dep_file;
+}
+
+// 写 -MD 依赖文件（file.o → file.d）并更新 --incremental 的依赖数据库
+static void record_dependencies(CompileJob *job, const CompileOptions *options,
+                                char **headers, int num_headers, FILE *diag) {
+    if (options->write_deps) {
+        char *dep_file = dependency_file_name(job->output_file);
+        if (write_dependency_file(dep_file, job->output_file, job->input_file,
+                                  headers, num_headers) != 0) {
+            fprintf(diag, "  ⚠ Cannot write %s\n", dep_file);
+        }
+        free(dep_file);
+    }
+    if (options->build_db) {
+        build_db_record(options->build_db, job->input_file, job->output_file,
+                        output_flags(options), headers, num_headers);
+    }
+}
+
+// 线程池任务：编译一个输入文件（-S 输出 .s，否则输出 .o）
+static int compile_job(CompileJob *job, FILE *log, FILE *diag, void *ctx) {
+    CompileOptions *options = (CompileOptions *)ctx;
+    
+    // --incremental：源文件和它包含的头文件都没变，输出文件可以直接使用
+    // -MD 时依赖文件也要存在，缺少时按数据库中记录的头文件补写，补写失败就重新编译
+    if (options->build_db &&
+        build_db_is_up_to_date(options->build_db, job->input_file, job->output_file,
+                               output_flags(options))) {
+        int deps_ready = 1;
+        if (options->write_deps) {
+            char *dep_file = dependency_file_name(job->output_file);
+            deps_ready = access(dep_file, F_OK) == 0 ||
+                         build_db_write_dependency_file(options->build_db, dep_file,
+                                                        job->input_file, job->output_file) == 0;
+            free(dep_file);
+        }
+        if (deps_ready) {
+            fprintf(log, "\n[Up to date] %s → %s\n", job->input_file, job->output_file);
+            return 0;
+        }
+    }
+    fprintf(log, "\n[Compiling] %s → %s\n", job->input_file, job->output_file);
+    
+    char **headers = NULL;
+    int num_headers = 0;
+    int track_deps = options->build_db || options->write_deps;
+    char *preprocessed_code = preprocess_file(job->input_file, log, diag, job->time_report,
+                                              track_deps ? &headers : NULL, &num_headers);
+    if (!preprocessed_code) {
+        return 1;
+    }
+    
+    int result = build_output(job, options, preprocessed_code, log, diag);
+    if (result == 0 && track_deps) {
+        record_dependencies(job, options, headers, num_headers, diag);
+    }
+    for (int i = 0; i < num_headers; i++) {
+        free(headers[i]);
+    }
+    free(headers);
+    return result;
+}
+
+// --unity：各文件的前端结果，全部分析完成后由同一个 CodeGenerator 生成代码
+typedef struct UnityUnits {
+    CompileJob *jobs;
+    ASTNode **asts;
+    SemanticAnalyzer **analyzers;
+    int debug_mode;
+} UnityUnits;
+
+// 线程池任务：预处理、语法分析和语义分析一个文件，结果保存在 UnityUnits 中
+static int unity_frontend_job(CompileJob *job, FILE *log, FILE *diag, void *ctx) {
+    UnityUnits *units = (UnityUnits *)ctx;
+    int index = (int)(job - units->jobs);
+    fprintf(log, "\n[Analyzing] %s\n", job->input_file);
+    
+    char *preprocessed_code = preprocess_file(job->input_file, log, diag, job->time_report,
+                                              NULL, NULL);
+    if (!preprocessed_code) {
+        return 1;
+    }
+    return analyze_preprocessed(preprocessed_code, units->debug_mode, log, diag, job->time_report,
+                                &units->asts[index], &units->analyzers[index]);
+}
+
+// --unity：所有输入文件生成到一个汇编文件（emit_object 时为一个目标文件）。
+// 字符串常量只保存一份，只有一个 .data/.rodata 段，static 函数和变量按文件重命名。
+// reports 中每个文件一项，shared_report 记录共享段输出和汇编
+static int compile_unity(char **input_files, int num_input_files, const char *output_file,
+                         const CompileOptions *options, int num_workers,
+                         FileTimeReport *reports, FileTimeReport *shared_report) {
+    CompileJob *jobs = (CompileJob*)calloc(num_input_files, sizeof(CompileJob));
+    UnityUnits units;
+    units.jobs = jobs;
+    units.asts = (ASTNode**)calloc(num_input_files, sizeof(ASTNode*));
+    units.analyzers = (SemanticAnalyzer**)calloc(num_input_files, sizeof(SemanticAnalyzer*));
+    units.debug_mode = options->debug_mode;
+    if (!jobs || !units.asts || !units.analyzers) {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    for (int i = 0; i < num_input_files; i++) {
+        jobs[i].input_file = input_files[i];
+        jobs[i].time_report = reports ? &reports[i] : NULL;
+    }
+    
+    int result = 0;
+    int failed = job_pool_run(jobs, num_input_files, num_workers, unity_frontend_job, &units);
+    if (failed >= 0) {
+        fprintf(stderr, "\n✗ Compilation failed for %s\n", input_files[failed]);
+        result = 1;
+    }
+    
+    if (result == 0) {
+        printf("\n[Unity] %d file(s) → %s\n", num_input_files, output_file);
+        char *asm_text = NULL;
+        size_t asm_size = 0;
+        FILE *out = options->emit_object ? open_memstream(&asm_text, &asm_size)
+                                         : fopen(output_file, "w");
+        if (!out) {
+            fprintf(stderr, "  ✗ Failed to open output file: %s\n", output_file);
+            result = 1;
+        } else {
+            PhaseTimer timer;
+            CodeGenerator *gen = codegen_create(out, units.analyzers[0]);
+            gen->rename_statics = 1;
+            gen->ir_dump = options->dump_ir ? stdout : NULL;
+            codegen_set_pass_options(gen, &options->passes);
+            codegen_begin(gen);
+            for (int i = 0; i < num_input_files; i++) {
+                phase_timer_start(&timer, jobs[i].time_report);
+                codegen_add_unit(gen, units.analyzers[i], units.asts[i]);
+                fflush(out);
+                phase_timer_stop(&timer, jobs[i].time_report, PHASE_CODEGEN);
+            }
+            phase_timer_start(&timer, shared_report);
+            codegen_finish(gen);
+            if (options->passes.verbose) {
+                pass_manager_report(gen->passes, stdout);
+            }
+            codegen_destroy(gen);
+            fclose(out);
+            phase_timer_stop(&timer, shared_report, PHASE_CODEGEN);
+            
+            if (options->emit_object) {
+                phase_timer_start(&timer, shared_report);
+                result = assemble_object(asm_text, output_file, options, stdout, stderr);
+                phase_timer_stop(&timer, shared_report, PHASE_ASSEMBLE);
+                if (result != 0) {
+                    fprintf(stderr, "  ✗ Assembly failed for %s\n", output_file);
+                }
+            }
+            if (result == 0) {
+                printf("  ✓ Generated: %s\n", output_file);
+            }
+        }
+        free(asm_text);
+    }
+    
+    for (int i = 0; i < num_input_files; i++) {
+        semantic_analyzer_destroy(units.analyzers[i]);
+        if (units.asts[i]) {
+            free_ast(units.asts[i]);
+        }
+    }
+    free(units.asts);
+    free(units.analyzers);
+    free(jobs);
+    return result;
+}
+
+static void print_cache_stats(CompileCache *cache) {
+    long hits, misses;
+    compile_cache_session_stats(cache, &hits, &misses);
+    CacheStats stats;
+    printf("[Cache]\n");
+    printf("  This run: %ld hit(s), %ld miss(es)\n", hits, misses);
+    if (compile_cache_read_stats(cache, &stats) == 0) {
+        printf("  Total:    %ld hit(s), %ld miss(es), %ld eviction(s)\n",
+               stats.hits, stats.misses, stats.evictions);
+        printf("  Size:     %ld entries, %.1f KB\n", stats.entries, stats.total_size / 1024.0);
+    }
+}
+
+// --run：编译到内存后直接执行，不写任何文件，返回程序的退出码
+static int run_in_memory(char **input_files, int num_input_files, const CompileOptions *options,
+                         int program_argc, char **program_argv) {
+    ObjectCode **objects = (ObjectCode**)calloc(num_input_files, sizeof(ObjectCode*));
+    
+    // 编译进度不输出，只保留程序自己的输出（--dump-ir、-v 时日志写到 stderr）
+    char *log_text = NULL;
+    size_t log_size = 0;
+    FILE *log = (options->dump_ir || options->passes.verbose) ? stderr
+                                                             : open_memstream(&log_text, &log_size);
+    
+    int result = (objects && log) ? 0 : 1;
+    for (int i = 0; i < num_input_files && result == 0; i++) {
+        char *asm_text = NULL;
+        size_t asm_size = 0;
+        FILE *out = open_memstream(&asm_text, &asm_size);
+        if (!out) {
+            result = 1;
+            break;
+        }
+        result = compile_to_assembly(input_files[i], out, options, log, stderr, NULL);
+        fclose(out);
+        if (result == 0) {
+            objects[i] = assemble(asm_text, stderr);
+            if (!objects[i]) {
+                fprintf(stderr, "  ✗ Cannot run %s in memory\n", input_files[i]);
+                result = 1;
+            }
+        }
+        free(asm_text);
+    }
+    if (log && log != stderr) {
+        fclose(log);
+    }
+    free(log_text);
+    
+    int exit_code = 1;
+    if (result == 0) {
+        result = jit_run(objects, num_input_files, program_argc, program_argv, stderr, &exit_code);
+    }
+    
+    for (int i = 0; i < num_input_files; i++) {
+        object_code_free(objects[i]);
+    }
+    free(objects);
+    return result == 0 ? exit_code : 1;
+}
+
+// 输出 --time-report 的文本表格和/或 JSON 文件（json_stdout 不为 NULL 时 JSON 写到原来的标准输出）
+static void emit_time_report(FileTimeReport *reports, int num_reports, int text,
+                             const char *json_file, FILE *json_stdout) {
+    if (!reports) {
+        return;
+    }
+    if (text) {
+        printf("\n");
+        time_report_print(stdout, reports, num_reports);
+    }
+    if (json_file) {
+        FILE *out = json_stdout;
+        if (!out) {
+            out = strcmp(json_file, "-") == 0 ? stdout : fopen(json_file, "w");
+        }
+        if (!out) {
+            fprintf(stderr, "Warning: cannot write time report to %s\n", json_file);
+            return;
+        }
+        time_report_print_json(out, reports, num_reports);
+        if (out != stdout) {
+            fclose(out);
+        }
+    }
+}
+
+// --time-report-json -：标准输出只留给 JSON（可以直接用管道交给 jq），
+// 编译过程的输出（包括汇编器、链接器和 --run 的程序）改到标准错误。返回写 JSON 的流
+static FILE *reserve_stdout_for_json(void) {
+    fflush(stdout);
+    int fd = dup(STDOUT_FILENO);
+    FILE *json = fd >= 0 ? fdopen(fd, "w") : NULL;
+    if (!json || dup2(STDERR_FILENO, STDOUT_FILENO) < 0) {
+        fprintf(stderr, "Warning: cannot separate the JSON time report from other output\n");
+        if (json) {
+            fclose(json);
+        } else if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    return json;
+}
+
+// 命令行编译入口（编译服务器对每个请求也调用它）
+static int compiler_main(int argc, char **argv) {
     char *output_file = NULL;
     char **input_files = NULL;
     int num_input_files = 0;
     int compile_only = 0;    // -c选项：编译到.o
     int assembly_only = 0;   // -S选项：编译到.s
     int debug_mode = 0;
+    int dump_ir = 0;         // --dump-ir选项：输出每个函数的 IR
+    PassOptions passes;      // -O、-f<遍名>、-v选项
+    int num_workers = 1;     // -j选项：并行编译线程数
+    int integrated_as = 1;   // 使用内置汇编器
+    int run_mode = 0;        // --run选项：在内存中执行
+    int unity = 0;           // --unity选项：所有输入生成到一个文件
+    int incremental = 0;     // --incremental选项：只重新编译变化的文件
+    int write_deps = 0;      // -MD选项：输出 .d 依赖文件
+    int program_argc = 0;    // '--' 之后的参数传给被执行的程序
+    char **program_argv = NULL;
+    const char *cache_dir = getenv("VC_CACHE_DIR"); // --cache-dir：编译缓存目录
+    size_t cache_size = CACHE_DEFAULT_MAX_SIZE;
+    int cache_stats = 0;
+    int time_report = 0;     // --time-report：打印各阶段开销
+    const char *time_report_json = NULL; // --time-report-json：JSON 输出文件
+    
+    pass_options_init(&passes);
     
     // Parse command line arguments
+    int pass_arg;
     for (int i = 1; i < argc; i++) {
-        if (strcmp(argv[i], "-S") == 0) {
+        if (strcmp(argv[i], "--") == 0) {
+            program_argc = argc - i - 1;
+            program_argv = argv + i + 1;
+            break;
+        } else if (strcmp(argv[i], "-S") == 0) {
             assembly_only = 1;
         } else if (strcmp(argv[i], "-c") == 0) {
             compile_only = 1;
         } else if (strcmp(argv[i], "-o") == 0 && i + 1 < argc) {
             output_file = argv[++i];
+        } else if (strncmp(argv[i], "-j", 2) == 0) {
+            const char *count = argv[i][2] ? argv[i] + 2 : (i + 1 < argc ? argv[++i] : "");
+            num_workers = atoi(count);
+            if (num_workers <= 0) {
+                fprintf(stderr, "Invalid job count: '%s'\n", count);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "-fno-integrated-as") == 0) {
+            integrated_as = 0;
+        } else if (strcmp(argv[i], "-fintegrated-as") == 0) {
+            integrated_as = 1;
+        } else if ((pass_arg = pass_options_parse(&passes, argv[i])) != 0) {
+            if (pass_arg == -2) {
+                pass_options_print_value_error(stderr, argv[i]);
+                return 1;
+            }
+            if (pass_arg < 0) {
+                fprintf(stderr, "Unknown optimization option: %s\n", argv[i]);
+                pass_options_print_help(stderr);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--run") == 0) {
+            run_mode = 1;
+        } else if (strcmp(argv[i], "--unity") == 0) {
+            unity = 1;
+        } else if (strcmp(argv[i], "--incremental") == 0) {
+            incremental = 1;
+        } else if (strcmp(argv[i], "-MD") == 0) {
+            write_deps = 1;
+        } else if (strcmp(argv[i], "--cache-dir") == 0 && i + 1 < argc) {
+            cache_dir = argv[++i];
+        } else if (strcmp(argv[i], "--cache-size") == 0 && i + 1 < argc) {
+            long megabytes = atol(argv[++i]);
+            if (megabytes <= 0) {
+                fprintf(stderr, "Invalid cache size: '%s'\n", argv[i]);
+                return 1;
+            }
+            cache_size = (size_t)megabytes * 1024 * 1024;
+        } else if (strcmp(argv[i], "--cache-stats") == 0) {
+            cache_stats = 1;
+        } else if (strcmp(argv[i], "--time-report") == 0) {
+            time_report = 1;
+        } else if (strcmp(argv[i], "--time-report-json") == 0 && i + 1 < argc) {
+            time_report_json = argv[++i];
+        } else if (strcmp(argv[i], "--server") == 0 || strcmp(argv[i], "--connect") == 0) {
+            fprintf(stderr, "%s must be the first option\n", argv[i]);
+            return 1;
         } else if (strcmp(argv[i], "--debug") == 0) {
             debug_mode = 1;
+        } else if (strcmp(argv[i], "--dump-ir") == 0) {
+            dump_ir = 1;
+        } else if (strcmp(argv[i], "--peephole-self-test") == 0) {
+            return peephole_self_test(stdout) ? 1 : 0;
         } else if (strcmp(argv[i], "-h") == 0 || strcmp(argv[i], "--help") == 0) {
             print_usage(argv[0]);
             return 0;
@@ -180,12 +726,55 @@ int main(int argc, char **argv) {
         }
     }
     
+    // 只查看缓存统计
+    if (num_input_files == 0 && cache_stats && cache_dir && cache_dir[0]) {
+        CompileCache *cache = compile_cache_open(cache_dir, cache_size, stderr);
+        if (!cache) {
+            return 1;
+        }
+        print_cache_stats(cache);
+        compile_cache_close(cache);
+        return 0;
+    }
+    
     if (num_input_files == 0) {
         fprintf(stderr, "Error: No input files\n");
         print_usage(argv[0]);
         return 1;
     }
     
+    FILE *json_stdout = NULL;
+    if (time_report_json && strcmp(time_report_json, "-") == 0) {
+        json_stdout = reserve_stdout_for_json();
+    }
+    
+    CompileOptions options;
+    options.debug_mode = debug_mode;
+    options.emit_object = !assembly_only;
+    options.integrated_as = integrated_as;
+    options.cache = NULL;
+    options.build_db = NULL;
+    options.write_deps = write_deps;
+    options.dump_ir = dump_ir;
+    options.passes = passes;
+    init_output_flags(&options);
+    
+    if (run_mode) {
+        // argv[0] 为第一个源文件名，其后是 '--' 之后的参数
+        char **run_argv = (char**)malloc(sizeof(char*) * (program_argc + 2));
+        run_argv[0] = input_files[0];
+        for (int i = 0; i < program_argc; i++) {
+            run_argv[i + 1] = program_argv[i];
+        }
+        run_argv[program_argc + 1] = NULL;
+        
+        int status = run_in_memory(input_files, num_input_files, &options,
+                                   program_argc + 1, run_argv);
+        free(run_argv);
+        free(input_files);
+        return status;
+    }
+    
     printf("════════════════════════════════════════════════════════\n");
     printf("🚀 C Compiler - Multi-File Compilation\n");
     printf("════════════════════════════════════════════════════════\n");
@@ -194,33 +783,108 @@ int main(int argc, char **argv) {
     printf("Mode: %s\n", mode_str);
     printf("Input files: %d\n", num_input_files);
     
-    // Array to store object files
-    char **object_files = (char**)malloc(sizeof(char*) * num_input_files);
+    // --debug 会直接打印 AST 和符号表，只在顺序编译时有意义
+    if (debug_mode) {
+        num_workers = 1;
+    }
+    if (num_workers > 1) {
+        printf("Parallel jobs: %d\n", num_workers);
+    }
+    if (unity) {
+        printf("Unity build: %d file(s) → 1 output\n", num_input_files);
+    }
+    
+    // 每个输入文件一份统计，--unity 时加一项共享的代码段输出和汇编，最后一项用于链接
+    int num_reports = num_input_files + (unity ? 1 : 0);
+    FileTimeReport *reports = NULL;
+    if (time_report || time_report_json) {
+        reports = (FileTimeReport*)calloc(num_reports + 1, sizeof(FileTimeReport));
+        for (int i = 0; i < num_input_files; i++) {
+            reports[i].name = input_files[i];
+        }
+        if (unity) {
+            reports[num_input_files].name = "(unity)";
+        }
+        reports[num_reports].name = "(link)";
+        time_report_enable_alloc_tracking();
+    }
     
-    // Compile each file to assembly
-    for (int i = 0; i < num_input_files; i++) {
-        char *input = input_files[i];
-        char *asm_file = (char*)malloc(strlen(input) + 10);
-        
-        // Generate assembly file name: file.c -> file.s
-        strcpy(asm_file, input);
-        char *dot = strrchr(asm_file, '.');
-        if (dot) {
-            strcpy(dot, ".s");
-        } else {
-            strcat(asm_file, ".s");
+    // Compile each file (in parallel with -j N)
+    // --unity 把所有文件合成一个单元，按文件记录依赖没有意义
+    if (unity && (incremental || write_deps)) {
+        fprintf(stderr, "Warning: --incremental and -MD are ignored with --unity\n");
+        incremental = 0;
+        options.write_deps = 0;
+    }
+    
+    // Array to store object files (--unity 时只有一个输出)
+    int num_outputs = unity ? 1 : num_input_files;
+    char **object_files = (char**)malloc(sizeof(char*) * num_outputs);
+    
+    if (unity) {
+        // -S/-c 时 -o 指定输出文件，链接时生成临时的 unity.o
+        const char *unity_output = assembly_only ? "unity.s" : "unity.o";
+        if (output_file && (assembly_only || compile_only)) {
+            unity_output = output_file;
         }
-        
-        if (compile_to_assembly(input, asm_file, debug_mode) != 0) {
-            fprintf(stderr, "\n✗ Compilation failed for %s\n", input);
-            free(asm_file);
-            for (int j = 0; j < i; j++) free(object_files[j]);
+        object_files[0] = strdup(unity_output);
+        if (compile_unity(input_files, num_input_files, object_files[0], &options, num_workers,
+                          reports, reports ? &reports[num_input_files] : NULL) != 0) {
+            free(object_files[0]);
             free(object_files);
             free(input_files);
+            free(reports);
             return 1;
         }
+    } else {
+        CompileJob *jobs = (CompileJob*)malloc(sizeof(CompileJob) * num_input_files);
+    
+        for (int i = 0; i < num_input_files; i++) {
+            char *input = input_files[i];
+            char *out_file = (char*)malloc(strlen(input) + 10);
         
-        object_files[i] = asm_file;
+            // Generate output file name: file.c -> file.s (-S) / file.o
+            const char *ext = assembly_only ? ".s" : ".o";
+            strcpy(out_file, input);
+            char *dot = strrchr(out_file, '.');
+            if (dot) {
+                strcpy(dot, ext);
+            } else {
+                strcat(out_file, ext);
+            }
+        
+            object_files[i] = out_file;
+            jobs[i].input_file = input;
+            jobs[i].output_file = out_file;
+            jobs[i].time_report = reports ? &reports[i] : NULL;
+        }
+    
+        // --debug/--dump-ir 需要打印每个文件的 AST 或 IR，不使用缓存
+        if (cache_dir && cache_dir[0] && !debug_mode && !dump_ir) {
+            options.cache = compile_cache_open(cache_dir, cache_size, stderr);
+        }
+        if (incremental) {
+            options.build_db = build_db_open(BUILD_DB_DEFAULT_PATH);
+        }
+        int failed = job_pool_run(jobs, num_input_files, num_workers, compile_job, &options);
+        free(jobs);
+        build_db_close(options.build_db);
+    
+        if (options.cache) {
+            if (cache_stats) {
+                printf("\n");
+                print_cache_stats(options.cache);
+            }
+            compile_cache_close(options.cache);
+        }
+    
+        if (failed >= 0) {
+            fprintf(stderr, "\n✗ Compilation failed for %s\n", input_files[failed]);
+            for (int j = 0; j < num_input_files; j++) free(object_files[j]);
+            free(object_files);
+            free(input_files);
+            return 1;
+        }
     }
     
     printf("\n");
@@ -231,7 +895,7 @@ int main(int argc, char **argv) {
     if (assembly_only) {
         // -S mode: keep assembly files only
         printf("[Assembly files generated]\n");
-        for (int i = 0; i < num_input_files; i++) {
+        for (int i = 0; i < num_outputs; i++) {
             printf("  ✓ %s\n", object_files[i]);
         }
         
@@ -240,59 +904,29 @@ int main(int argc, char **argv) {
         printf("🎉 Assembly generation successful!\n");
         printf("════════════════════════════════════════════════════════\n\n");
         printf("Assembly files:\n");
-        for (int i = 0; i < num_input_files; i++) {
+        for (int i = 0; i < num_outputs; i++) {
             printf("  %s\n", object_files[i]);
         }
         
+        emit_time_report(reports, num_reports, time_report, time_report_json, json_stdout);
+        
         // Cleanup
-        for (int i = 0; i < num_input_files; i++) {
+        for (int i = 0; i < num_outputs; i++) {
             free(object_files[i]);
         }
         free(object_files);
         free(input_files);
+        free(reports);
         return 0;
     } else if (compile_only) {
-        // -c mode: assemble to .o files
-        printf("[Assembling to object files]\n");
-        for (int i = 0; i < num_input_files; i++) {
-            char *obj_file = (char*)malloc(strlen(object_files[i]) + 10);
-            strcpy(obj_file, object_files[i]);
-            char *dot = strrchr(obj_file, '.');
-            if (dot) {
-                strcpy(dot, ".o");
-            }
-            
-            char cmd[512];
-            snprintf(cmd, sizeof(cmd), "gcc -c %s -o %s 2>&1", object_files[i], obj_file);
-            
-            printf("  %s → %s\n", object_files[i], obj_file);
-            
-            FILE *pipe = popen(cmd, "r");
-            if (!pipe) {
-                fprintf(stderr, "  ✗ Failed to run assembler\n");
-                free(obj_file);
-                continue;
-            }
-            
-            char buffer[256];
-            int has_errors = 0;
-            while (fgets(buffer, sizeof(buffer), pipe)) {
-                fprintf(stderr, "    %s", buffer);
-                has_errors = 1;
-            }
-            int status = pclose(pipe);
-            
-            if (status == 0 && !has_errors) {
-                printf("  ✓ Generated: %s\n", obj_file);
-            } else {
-                fprintf(stderr, "  ✗ Assembly failed for %s\n", object_files[i]);
-            }
-            
-            free(obj_file);
+        // -c mode: object files were written by the compile jobs
+        printf("[Object files generated]\n");
+        for (int i = 0; i < num_outputs; i++) {
+            printf("  ✓ %s\n", object_files[i]);
         }
     } else {
-        // Link mode: assemble and link
-        printf("[Assembling and Linking]\n");
+        // Link mode: link the object files
+        printf("[Linking]\n");
         
         if (!output_file) {
             output_file = "output";
@@ -300,7 +934,7 @@ int main(int argc, char **argv) {
         
         // Build gcc command
         char cmd[4096] = "gcc -no-pie ";
-        for (int i = 0; i < num_input_files; i++) {
+        for (int i = 0; i < num_outputs; i++) {
             strcat(cmd, object_files[i]);
             strcat(cmd, " ");
         }
@@ -308,12 +942,14 @@ int main(int argc, char **argv) {
         strcat(cmd, output_file);
         strcat(cmd, " 2>&1");
         
-        printf("  Linking %d file(s)...\n", num_input_files);
+        printf("  Linking %d file(s)...\n", num_outputs);
+        PhaseTimer link_timer;
+        phase_timer_start(&link_timer, reports ? &reports[num_reports] : NULL);
         
         FILE *pipe = popen(cmd, "r");
         if (!pipe) {
             fprintf(stderr, "  ✗ Failed to run linker\n");
-            for (int i = 0; i < num_input_files; i++) free(object_files[i]);
+            for (int i = 0; i < num_outputs; i++) free(object_files[i]);
             free(object_files);
             free(input_files);
             return 1;
@@ -326,10 +962,11 @@ int main(int argc, char **argv) {
             has_errors = 1;
         }
         int status = pclose(pipe);
+        phase_timer_stop(&link_timer, reports ? &reports[num_reports] : NULL, PHASE_LINK);
         
         if (status != 0 || has_errors) {
             fprintf(stderr, "\n✗ Linking failed\n");
-            for (int i = 0; i < num_input_files; i++) free(object_files[i]);
+            for (int i = 0; i < num_outputs; i++) free(object_files[i]);
             free(object_files);
             free(input_files);
             return 1;
@@ -338,14 +975,21 @@ int main(int argc, char **argv) {
         printf("  ✓ Generated executable: %s\n", output_file);
     }
     
-    // Cleanup assembly files
-    for (int i = 0; i < num_input_files; i++) {
-        unlink(object_files[i]);  // Delete .s files
+    // Cleanup intermediate object files (kept with -c, and with --incremental for the next run)
+    for (int i = 0; i < num_outputs; i++) {
+        if (!compile_only && !incremental) {
+            unlink(object_files[i]);
+        }
         free(object_files[i]);
     }
     free(object_files);
     free(input_files);
     
+    // 链接时多输出一项 (link)
+    emit_time_report(reports, num_reports + (compile_only ? 0 : 1),
+                     time_report, time_report_json, json_stdout);
+    free(reports);
+    
     printf("\n");
     printf("════════════════════════════════════════════════════════\n");
     printf("🎉 Compilation successful!\n");
@@ -360,3 +1004,65 @@ int main(int argc, char **argv) {
     return 0;
 }
 
+// 程序在内存中运行时会执行用户代码，不交给服务器
+static int needs_local_run(int argc, char **argv) {
+    for (int i = 1; i < argc && strcmp(argv[i], "--") != 0; i++) {
+        if (strcmp(argv[i], "--run") == 0) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    // --server <socket>：常驻内存，头文件缓存在请求之间保留
+    if (argc >= 2 && strcmp(argv[1], "--server") == 0) {
+        if (argc != 3) {
+            fprintf(stderr, "Usage: %s --server <socket>\n", argv[0]);
+            return 1;
+        }
+        preprocessor_enable_header_cache(1);
+        int preloaded = preprocessor_preload_headers("stdlib");
+        if (preloaded > 0) {
+            printf("Preloaded %d header(s) from stdlib/\n", preloaded);
+        }
+        compile_cache_init_compiler_digest();
+        // 子进程读入的头文件在服务器进程中预热，之后的请求可以直接使用
+        ServerCacheHooks hooks;
+        hooks.collect = preprocessor_header_cache_take_new;
+        hooks.warm = preprocessor_preload_header;
+        return server_run(argv[2], compiler_main, &hooks);
+    }
+    
+    // --connect <socket> 或 VC_SERVER：把命令行转发给服务器，连不上时在本地编译
+    const char *server_socket = getenv("VC_SERVER");
+    int first_arg = 1;
+    if (argc >= 3 && strcmp(argv[1], "--connect") == 0) {
+        server_socket = argv[2];
+        first_arg = 3;
+    }
+    
+    // 转发时 argv[0] 保持不变，去掉 --connect <socket>
+    char **forward_argv = (char**)malloc(sizeof(char*) * (argc + 1));
+    int forward_argc = 0;
+    forward_argv[forward_argc++] = argv[0];
+    for (int i = first_arg; i < argc; i++) {
+        forward_argv[forward_argc++] = argv[i];
+    }
+    forward_argv[forward_argc] = NULL;
+    
+    if (server_socket && server_socket[0] && !needs_local_run(forward_argc, forward_argv)) {
+        int exit_status = 1;
+        if (client_forward(server_socket, forward_argc, forward_argv, &exit_status) == 0) {
+            free(forward_argv);
+            return exit_status;
+        }
+        if (first_arg == 3) {
+            fprintf(stderr, "Warning: cannot connect to server %s, compiling locally\n", server_socket);
+        }
+    }
+    
+    int status = compiler_main(forward_argc, forward_argv);
+    free(forward_argv);
+    return status;
+}
@@ -0,0 +1,551 @@
+#include "opt.h"
+#include "symbol_table.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 常量折叠与常量传播（AST 遍）。
+// 折叠：值在编译时确定的 + - * / % 比较、逻辑、位运算、?:、强制转换和 sizeof
+// 直接替换为整数字面量；常量条件的 ?: 只保留被选中的分支。
+// 传播：只在声明时初始化、之后既不被赋值也不被取地址的整型局部变量和 static 变量，
+// 其引用替换为初始值（非 static 全局变量可能被其他文件修改，不参与传播）。
+
+static void *xrealloc(void *p, size_t size)
+{
+    p = realloc(p, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+typedef enum
+{
+    CONST_UNKNOWN,
+    CONST_EVALUATING, // 正在求值（防止 int x = x + 1 这样的自引用）
+    CONST_YES,
+    CONST_NO
+} ConstState;
+
+// 一个变量的读写情况
+typedef struct ConstSymbol
+{
+    Symbol *symbol;
+    int declarations; // 出现的声明次数（tentative definition 会出现多次）
+    int writes;       // 赋值、复合赋值、++/-- 的次数
+    int addressed;    // 被取地址
+    ASTNode *init;    // 初始化表达式（NULL 表示没有）
+    ConstState state;
+    long value;
+} ConstSymbol;
+
+typedef struct FoldContext
+{
+    ConstSymbol *symbols;
+    int num_symbols;
+    int capacity;
+    int *buckets; // 按 Symbol 指针散列的开放寻址表，存 symbols 的下标，-1 为空
+    int num_buckets;
+    int has_asm; // 内联汇编可能修改任何变量，不做传播
+    int changed;
+} FoldContext;
+
+// ========== 求值 ==========
+
+static int fits_int(long value)
+{
+    return value >= -2147483648L && value <= 2147483647L;
+}
+
+static int is_integer_scalar(TypeInfo *type)
+{
+    if (!type || type->pointer_level > 0 || type->array_size >= 0 || type->array_dimensions > 0)
+        return 0;
+    switch (type->base_type)
+    {
+    case TYPE_INT:
+    case TYPE_CHAR:
+    case TYPE_SHORT:
+    case TYPE_LONG:
+    case TYPE_UNSIGNED:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+// 把值转换为 type 能表示的值（C 的整数转换）
+static long convert_to_type(TypeInfo *type, long value)
+{
+    switch (type->base_type)
+    {
+    case TYPE_CHAR:
+        return (signed char)value;
+    case TYPE_SHORT:
+        return (short)value;
+    case TYPE_INT:
+        return (int)value;
+    case TYPE_UNSIGNED:
+        return (unsigned int)value;
+    default:
+        return value;
+    }
+}
+
+int const_sizeof(ASTNode *node)
+{
+    // 语义分析把操作数的类型记录在 sizeof 节点上
+    TypeInfo *type = (TypeInfo *)node->semantic_info;
+    return type ? type_size(type) : 8;
+}
+
+// 运算按 64 位进行（和生成的代码一致），除以 0 和越界移位不折叠
+static int eval_binary(OperatorType op, long a, long b, long *value)
+{
+    switch (op)
+    {
+    case OP_ADD:
+        *value = (long)((unsigned long)a + (unsigned long)b);
+        return 1;
+    case OP_SUB:
+        *value = (long)((unsigned long)a - (unsigned long)b);
+        return 1;
+    case OP_MUL:
+        *value = (long)((unsigned long)a * (unsigned long)b);
+        return 1;
+    case OP_DIV:
+    case OP_MOD:
+        if (b == 0 || (a == -9223372036854775807L - 1 && b == -1))
+            return 0;
+        *value = op == OP_DIV ? a / b : a % b;
+        return 1;
+    case OP_LT:
+        *value = a < b;
+        return 1;
+    case OP_GT:
+        *value = a > b;
+        return 1;
+    case OP_LE:
+        *value = a <= b;
+        return 1;
+    case OP_GE:
+        *value = a >= b;
+        return 1;
+    case OP_EQ:
+        *value = a == b;
+        return 1;
+    case OP_NE:
+        *value = a != b;
+        return 1;
+    case OP_BIT_AND:
+        *value = a & b;
+        return 1;
+    case OP_BIT_OR:
+        *value = a | b;
+        return 1;
+    case OP_BIT_XOR:
+        *value = a ^ b;
+        return 1;
+    case OP_LEFT_SHIFT:
+        if (b < 0 || b > 63)
+            return 0;
+        *value = (long)((unsigned long)a << b);
+        return 1;
+    case OP_RIGHT_SHIFT:
+        if (b < 0 || b > 63)
+            return 0;
+        *value = a >> b;
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static int symbol_bucket(FoldContext *ctx, Symbol *symbol)
+{
+    unsigned long h = (unsigned long)symbol;
+    h ^= h >> 17;
+    h *= 0x9E3779B97F4A7C15UL;
+    int mask = ctx->num_buckets - 1;
+    int i = (int)(h >> 32) & mask;
+    while (ctx->buckets[i] >= 0 && ctx->symbols[ctx->buckets[i]].symbol != symbol)
+        i = (i + 1) & mask;
+    return i;
+}
+
+static ConstSymbol *find_symbol(FoldContext *ctx, Symbol *symbol)
+{
+    if (ctx->num_buckets == 0)
+        return NULL;
+    int index = ctx->buckets[symbol_bucket(ctx, symbol)];
+    return index >= 0 ? &ctx->symbols[index] : NULL;
+}
+
+static int eval(FoldContext *ctx, ASTNode *node, long *value);
+
+// 变量是否是已知常量
+static int eval_symbol(FoldContext *ctx, Symbol *symbol, long *value)
+{
+    if (!ctx || ctx->has_asm)
+        return 0;
+    ConstSymbol *entry = find_symbol(ctx, symbol);
+    if (!entry)
+        return 0;
+    if (entry->state == CONST_UNKNOWN)
+    {
+        entry->state = CONST_NO;
+        if (entry->declarations == 1 && entry->writes == 0 && !entry->addressed)
+        {
+            long init_value = 0;
+            entry->state = CONST_EVALUATING;
+            // 没有初始化的静态存储期变量初始为 0，局部变量的值不确定
+            int known = entry->init ? eval(ctx, entry->init, &init_value) : symbol->label != NULL;
+            entry->state = CONST_NO;
+            if (known)
+            {
+                entry->value = convert_to_type(symbol->type, init_value);
+                entry->state = CONST_YES;
+            }
+        }
+    }
+    if (entry->state != CONST_YES)
+        return 0;
+    *value = entry->value;
+    return 1;
+}
+
+static int eval(FoldContext *ctx, ASTNode *node, long *value)
+{
+    long a, b;
+    if (!node)
+        return 0;
+    switch (node->type)
+    {
+    case AST_INT_LITERAL:
+        *value = node->value.int_val;
+        return 1;
+
+    case AST_SIZEOF_EXPR:
+        *value = const_sizeof(node);
+        return 1;
+
+    case AST_IDENTIFIER:
+    {
+        Symbol *symbol = (Symbol *)node->semantic_info;
+        if (!symbol)
+            return 0;
+        if (symbol->declaration && symbol->declaration->type == AST_ENUM_CONST)
+        {
+            *value = symbol->declaration->value.int_val;
+            return 1;
+        }
+        return eval_symbol(ctx, symbol, value);
+    }
+
+    case AST_UNARY_EXPR:
+        if (node->num_children < 1 || !eval(ctx, node->children[0], &a))
+            return 0;
+        switch (node->value.op_type)
+        {
+        case OP_NEG:
+            *value = (long)(0UL - (unsigned long)a);
+            return 1;
+        case OP_NOT:
+            *value = !a;
+            return 1;
+        case OP_BIT_NOT:
+            *value = ~a;
+            return 1;
+        default:
+            return 0;
+        }
+
+    case AST_BINARY_EXPR:
+        if (node->num_children < 2 || !eval(ctx, node->children[0], &a))
+            return 0;
+        // && 和 || 短路：右边不会被求值时不要求它是常量
+        if (node->value.op_type == OP_AND || node->value.op_type == OP_OR)
+        {
+            if ((node->value.op_type == OP_AND) != (a != 0))
+            {
+                *value = a != 0;
+                return 1;
+            }
+            if (!eval(ctx, node->children[1], &b))
+                return 0;
+            *value = b != 0;
+            return 1;
+        }
+        if (!eval(ctx, node->children[1], &b))
+            return 0;
+        return eval_binary(node->value.op_type, a, b, value);
+
+    case AST_TERNARY_EXPR:
+        if (node->num_children < 3 || !eval(ctx, node->children[0], &a))
+            return 0;
+        return eval(ctx, node->children[a ? 1 : 2], value);
+
+    case AST_CAST_EXPR:
+    {
+        TypeInfo *target = (TypeInfo *)node->semantic_info;
+        if (node->num_children < 2 || !is_integer_scalar(target))
+            return 0;
+        ASTNode *operand = node->children[1];
+        if (operand->type == AST_FLOAT_LITERAL)
+            a = (long)operand->value.float_val.value;
+        else if (!eval(ctx, operand, &a))
+            return 0;
+        *value = convert_to_type(target, a);
+        return 1;
+    }
+
+    default:
+        return 0;
+    }
+}
+
+int const_eval(ASTNode *node, long *value)
+{
+    return eval(NULL, node, value);
+}
+
+// ========== 变量的读写情况 ==========
+
+static ConstSymbol *get_symbol(FoldContext *ctx, Symbol *symbol)
+{
+    ConstSymbol *entry = find_symbol(ctx, symbol);
+    if (entry)
+        return entry;
+    if (ctx->num_symbols >= ctx->capacity)
+    {
+        ctx->capacity = ctx->capacity ? ctx->capacity * 2 : 32;
+        ctx->symbols = (ConstSymbol *)xrealloc(ctx->symbols, ctx->capacity * sizeof(ConstSymbol));
+        // 散列表保持至多半满
+        ctx->num_buckets = ctx->capacity * 2;
+        ctx->buckets = (int *)xrealloc(ctx->buckets, ctx->num_buckets * sizeof(int));
+        memset(ctx->buckets, -1, ctx->num_buckets * sizeof(int));
+        for (int i = 0; i < ctx->num_symbols; i++)
+            ctx->buckets[symbol_bucket(ctx, ctx->symbols[i].symbol)] = i;
+    }
+    ctx->buckets[symbol_bucket(ctx, symbol)] = ctx->num_symbols;
+    entry = &ctx->symbols[ctx->num_symbols++];
+    memset(entry, 0, sizeof(*entry));
+    entry->symbol = symbol;
+    return entry;
+}
+
+// 可以传播的变量：整型标量的局部变量和 static 变量
+static int is_candidate(Symbol *symbol)
+{
+    if (!symbol || symbol->kind != SYMBOL_VARIABLE || symbol->is_extern || symbol->is_global)
+        return 0;
+    if (symbol->scope_level == 0 && !symbol->is_static)
+        return 0;
+    if (symbol->type && symbol->type->is_volatile)
+        return 0;
+    return is_integer_scalar(symbol->type);
+}
+
+// 被修改或取地址的变量（标识符节点）
+static void note_write(FoldContext *ctx, ASTNode *target, int addressed)
+{
+    if (!target || target->type != AST_IDENTIFIER || !target->semantic_info)
+        return;
+    ConstSymbol *entry = get_symbol(ctx, (Symbol *)target->semantic_info);
+    if (addressed)
+        entry->addressed = 1;
+    else
+        entry->writes++;
+}
+
+static void scan(FoldContext *ctx, ASTNode *node)
+{
+    if (!node)
+        return;
+    switch (node->type)
+    {
+    case AST_DECLARATION:
+    {
+        if (node->num_children < 2)
+            return;
+        ASTNode *declarator = node->children[1];
+        ASTNode *init = NULL;
+        Symbol *symbol;
+        if (declarator->type == AST_ASSIGN_EXPR && declarator->num_children >= 2)
+        {
+            symbol = (Symbol *)declarator->children[0]->semantic_info;
+            init = declarator->children[1];
+        }
+        else
+        {
+            symbol = (Symbol *)declarator->semantic_info;
+        }
+        if (symbol)
+        {
+            ConstSymbol *entry = get_symbol(ctx, symbol);
+            entry->declarations++;
+            entry->init = init;
+            if (!is_candidate(symbol) || (init && init->type == AST_INIT_LIST))
+                entry->writes++;
+        }
+        scan(ctx, init);
+        return;
+    }
+
+    case AST_ASSIGN_EXPR:
+        if (node->num_children > 0)
+            note_write(ctx, node->children[0], 0);
+        break;
+
+    case AST_UNARY_EXPR:
+        if (node->num_children > 0)
+        {
+            switch (node->value.op_type)
+            {
+            case OP_ADDR:
+                note_write(ctx, node->children[0], 1);
+                break;
+            case OP_PREINC:
+            case OP_PREDEC:
+            case OP_POSTINC:
+            case OP_POSTDEC:
+                note_write(ctx, node->children[0], 0);
+                break;
+            default:
+                break;
+            }
+        }
+        break;
+
+    case AST_ASM_STMT:
+        ctx->has_asm = 1;
+        break;
+
+    default:
+        break;
+    }
+    for (int i = 0; i < node->num_children; i++)
+        scan(ctx, node->children[i]);
+}
+
+// ========== 改写 ==========
+
+static void free_children(ASTNode *node)
+{
+    for (int i = 0; i < node->num_children; i++)
+        free_ast(node->children[i]);
+    free(node->children);
+    node->children = NULL;
+    node->num_children = 0;
+    node->children_capacity = 0;
+}
+
+// 就地把节点改为整数字面量
+static void replace_with_literal(ASTNode *node, long value)
+{
+    free_children(node);
+    if (node->type == AST_IDENTIFIER && node->value.string_val)
+        free(node->value.string_val);
+    node->type = AST_INT_LITERAL;
+    node->value.int_val = (int)value;
+    node->semantic_info = NULL;
+}
+
+// 就地把节点替换为它的第 index 个子节点
+static void replace_with_child(ASTNode *node, int index)
+{
+    ASTNode *child = node->children[index];
+    node->children[index] = NULL;
+    free_children(node);
+    *node = *child;
+    free(child);
+}
+
+static int is_foldable(ASTNode *node)
+{
+    switch (node->type)
+    {
+    case AST_IDENTIFIER:
+    case AST_UNARY_EXPR:
+    case AST_BINARY_EXPR:
+    case AST_TERNARY_EXPR:
+    case AST_CAST_EXPR:
+    case AST_SIZEOF_EXPR:
+        return 1;
+    default:
+        return 0;
+    }
+}
+
+static void fold(FoldContext *ctx, ASTNode *node)
+{
+    if (!node)
+        return;
+    switch (node->type)
+    {
+    case AST_DECLARATION:
+        // 只折叠初始化表达式，声明符中的标识符不是值
+        if (node->num_children >= 2 && node->children[1]->type == AST_ASSIGN_EXPR &&
+            node->children[1]->num_children >= 2)
+            fold(ctx, node->children[1]->children[1]);
+        return;
+    case AST_FUNCTION_DEF:
+        if (node->num_children >= 3)
+            fold(ctx, node->children[2]);
+        return;
+    case AST_SIZEOF_EXPR:
+    case AST_ASM_STMT:
+        break;
+    default:
+        for (int i = 0; i < node->num_children; i++)
+            fold(ctx, node->children[i]);
+        break;
+    }
+
+    if (!is_foldable(node))
+        return;
+    long value;
+    if (eval(ctx, node, &value))
+    {
+        if (fits_int(value))
+        {
+            replace_with_literal(node, value);
+            ctx->changed = 1;
+        }
+        return;
+    }
+
+    // 部分折叠：常量条件的 ?: 只保留一个分支
+    long cond;
+    if (node->type == AST_TERNARY_EXPR && node->num_children >= 3 && eval(ctx, node->children[0], &cond))
+    {
+        replace_with_child(node, cond ? 1 : 2);
+        ctx->changed = 1;
+        return;
+    }
+
+    // 1 && x、0 || x 化为 x != 0
+    if (node->type == AST_BINARY_EXPR && node->num_children >= 2 &&
+        (node->value.op_type == OP_AND || node->value.op_type == OP_OR) &&
+        eval(ctx, node->children[0], &cond))
+    {
+        ASTNode *left = node->children[0];
+        node->children[0] = node->children[1];
+        node->children[1] = left;
+        replace_with_literal(left, 0);
+        node->value.op_type = OP_NE;
+        ctx->changed = 1;
+    }
+}
+
+int opt_constfold(ASTNode *root)
+{
+    FoldContext ctx;
+    memset(&ctx, 0, sizeof(ctx));
+    scan(&ctx, root);
+    fold(&ctx, root);
+    free(ctx.symbols);
+    free(ctx.buckets);
+    return ctx.changed;
+}
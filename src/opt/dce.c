@@ -0,0 +1,348 @@
+#include "opt.h"
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+// dce：删除死代码。
+// 函数内：
+//   1. 从入口不可达的块。simplify-cfg 只删除 ret/jmp 之后到下一个标签之间的指令，
+//      return 之后的循环这样带标签、自己跳回自己的不可达代码留到这里删除
+//   2. 结果没有用到的纯计算。活跃性从空集合开始迭代，只有被保留的指令读取的 vreg 才是活跃的，
+//      所以只在自己身上循环的值（例如强度削弱之后不再使用的归纳变量 i = i + 1）也能删除，
+//      结果在使用之前就被覆盖的定义同样删除
+// 纯计算是算术、比较和 mov（包括取地址）。加载保留（可能是 volatile 对象或设备寄存器），
+// 调用、存储和向量指令都保留。除以零是未定义行为，删除结果不用的除法不改变有定义的程序。
+// 编译单元：见 opt_dce_unit。
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// ========== 不可达块 ==========
+
+static int remove_unreachable_blocks(IrFunction *func)
+{
+    if (func->num_blocks == 0)
+        return 0;
+    char *reached = (char *)xcalloc(func->num_blocks, 1);
+    int *stack = (int *)xcalloc(func->num_blocks, sizeof(int));
+    int top = 0;
+    reached[0] = 1;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        IrBlock *block = &func->blocks[stack[--top]];
+        for (int k = 0; k < block->num_succs; k++)
+        {
+            int succ = block->succs[k];
+            if (!reached[succ])
+            {
+                reached[succ] = 1;
+                stack[top++] = succ;
+            }
+        }
+    }
+
+    char *dead = (char *)xcalloc(func->num_instrs, 1);
+    int num_dead = 0;
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        if (reached[b])
+            continue;
+        for (int i = func->blocks[b].first; i <= func->blocks[b].last; i++)
+        {
+            dead[i] = 1;
+            num_dead++;
+        }
+    }
+    if (num_dead > 0)
+        ir_remove_instrs(func, dead);
+    free(reached);
+    free(stack);
+    free(dead);
+    return num_dead > 0;
+}
+
+// ========== 无用的计算 ==========
+
+// 没有副作用、只写 dst 的指令（IR_MOV ... IR_GE）
+static int is_pure(const IrInstr *instr)
+{
+    return instr->op >= IR_MOV && instr->op <= IR_GE && instr->dst.kind == IR_OPERAND_VREG;
+}
+
+typedef struct Liveness
+{
+    IrFunction *func;
+    int words;          // 每个集合的 64 位字数
+    uint64_t *live_in;  // 每块一行
+    uint64_t *live_out;
+    IrOperand **uses;   // ir_instr_uses 的缓冲
+} Liveness;
+
+static int test_bit(const uint64_t *set, long vreg)
+{
+    return (int)((set[vreg / 64] >> (vreg % 64)) & 1);
+}
+
+// 从块尾的活跃集合 live 向前走过块 b，结束时 live 是块首的活跃集合。
+// 结果不活跃的纯计算不读取任何值；dead 不为 NULL 时标记这些指令
+static void walk_block(Liveness *lv, int b, uint64_t *live, char *dead)
+{
+    IrFunction *func = lv->func;
+    for (int i = func->blocks[b].last; i >= func->blocks[b].first; i--)
+    {
+        IrInstr *instr = &func->instrs[i];
+        int def = ir_instr_def(instr);
+        if (is_pure(instr) && !test_bit(live, def))
+        {
+            if (dead)
+                dead[i] = 1;
+            continue;
+        }
+        if (def >= 0)
+            live[def / 64] &= ~((uint64_t)1 << (def % 64));
+        int n = ir_instr_uses(instr, lv->uses);
+        for (int k = 0; k < n; k++)
+        {
+            if (lv->uses[k]->kind == IR_OPERAND_VREG)
+                live[lv->uses[k]->value / 64] |= (uint64_t)1 << (lv->uses[k]->value % 64);
+        }
+    }
+}
+
+static int remove_dead_instrs(IrFunction *func)
+{
+    if (func->num_blocks == 0)
+        return 0;
+    int max_uses = 2;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (func->instrs[i].num_args > max_uses)
+            max_uses = func->instrs[i].num_args;
+    }
+
+    Liveness lv;
+    lv.func = func;
+    lv.words = (func->num_vregs + 63) / 64;
+    lv.live_in = (uint64_t *)xcalloc((size_t)func->num_blocks * lv.words, sizeof(uint64_t));
+    lv.live_out = (uint64_t *)xcalloc((size_t)func->num_blocks * lv.words, sizeof(uint64_t));
+    lv.uses = (IrOperand **)xcalloc(max_uses, sizeof(IrOperand *));
+    uint64_t *live = (uint64_t *)xcalloc(lv.words, sizeof(uint64_t));
+
+    // 后向数据流，集合只增不减，从空集合开始得到最小不动点
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int b = func->num_blocks - 1; b >= 0; b--)
+        {
+            uint64_t *out = lv.live_out + (size_t)b * lv.words;
+            IrBlock *block = &func->blocks[b];
+            for (int k = 0; k < block->num_succs; k++)
+            {
+                const uint64_t *in = lv.live_in + (size_t)block->succs[k] * lv.words;
+                for (int w = 0; w < lv.words; w++)
+                    out[w] |= in[w];
+            }
+            memcpy(live, out, lv.words * sizeof(uint64_t));
+            walk_block(&lv, b, live, NULL);
+            uint64_t *in = lv.live_in + (size_t)b * lv.words;
+            if (memcmp(in, live, lv.words * sizeof(uint64_t)) != 0)
+            {
+                memcpy(in, live, lv.words * sizeof(uint64_t));
+                changed = 1;
+            }
+        }
+    }
+
+    char *dead = (char *)xcalloc(func->num_instrs, 1);
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        memcpy(live, lv.live_out + (size_t)b * lv.words, lv.words * sizeof(uint64_t));
+        walk_block(&lv, b, live, dead);
+    }
+    int num_dead = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+        num_dead += dead[i];
+    if (num_dead > 0)
+        ir_remove_instrs(func, dead);
+
+    free(dead);
+    free(live);
+    free(lv.live_in);
+    free(lv.live_out);
+    free(lv.uses);
+    return num_dead > 0;
+}
+
+int opt_dce(IrFunction *func)
+{
+    ir_build_cfg(func);
+    int changed = 0;
+    if (remove_unreachable_blocks(func))
+    {
+        // 删除的块之前留下的跳到下一条的跳转和无人引用的标签
+        ir_build_cfg(func);
+        opt_simplify_cfg(func);
+        ir_build_cfg(func);
+        changed = 1;
+    }
+    if (remove_dead_instrs(func))
+    {
+        ir_build_cfg(func);
+        changed = 1;
+    }
+    return changed;
+}
+
+// ========== 编译单元 ==========
+
+// 本单元中可以删除的对象（static 函数的定义和 static 变量）和它们的引用关系
+typedef struct Unit
+{
+    ASTNode *root;
+    IrFunction **funcs;
+    Symbol **vars;
+    int num_vars;
+    char *live_funcs;
+    char *live_vars;
+    char *scanned_funcs;
+    char *scanned_vars;
+} Unit;
+
+static const char *function_label(ASTNode *node)
+{
+    if (node->type != AST_FUNCTION_DEF || node->num_children < 3)
+        return NULL;
+    Symbol *symbol = (Symbol *)node->children[1]->semantic_info;
+    return symbol && symbol->is_static ? symbol->label : NULL;
+}
+
+// 引用了标签为 name 的全局对象
+static void mark(Unit *u, const char *name)
+{
+    if (!name)
+        return;
+    for (int i = 0; i < u->root->num_children; i++)
+    {
+        const char *label = u->live_funcs[i] ? NULL : function_label(u->root->children[i]);
+        if (label && strcmp(label, name) == 0)
+            u->live_funcs[i] = 1;
+    }
+    for (int k = 0; k < u->num_vars; k++)
+    {
+        if (!u->live_vars[k] && strcmp(u->vars[k]->label, name) == 0)
+            u->live_vars[k] = 1;
+    }
+}
+
+static void mark_operand(Unit *u, const IrOperand *operand)
+{
+    if (operand->kind == IR_OPERAND_GLOBAL)
+        mark(u, operand->name);
+}
+
+static void scan_ir(Unit *u, IrFunction *func)
+{
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        mark_operand(u, &instr->dst);
+        mark_operand(u, &instr->a);
+        mark_operand(u, &instr->b);
+        for (int k = 0; instr->op == IR_CALL && k < instr->num_args; k++)
+            mark_operand(u, &instr->args[k]);
+    }
+}
+
+// 没有降低为 IR 的函数和变量的初始值：语法树中的标识符
+static void scan_ast(Unit *u, ASTNode *node)
+{
+    if (!node)
+        return;
+    if (node->type == AST_IDENTIFIER && node->semantic_info)
+        mark(u, ((Symbol *)node->semantic_info)->label);
+    for (int i = 0; i < node->num_children; i++)
+        scan_ast(u, node->children[i]);
+}
+
+static int contains_asm(ASTNode *node)
+{
+    if (!node)
+        return 0;
+    if (node->type == AST_ASM_STMT)
+        return 1;
+    for (int i = 0; i < node->num_children; i++)
+    {
+        if (contains_asm(node->children[i]))
+            return 1;
+    }
+    return 0;
+}
+
+int opt_dce_unit(ASTNode *root, IrFunction **funcs, Symbol **vars, int num_vars, char *live_funcs, char *live_vars)
+{
+    memset(live_funcs, 1, root->num_children);
+    memset(live_vars, 1, num_vars);
+    // 内联汇编可能按名字引用任何符号
+    if (contains_asm(root))
+        return 0;
+
+    Unit u;
+    u.root = root;
+    u.funcs = funcs;
+    u.vars = vars;
+    u.num_vars = num_vars;
+    u.live_funcs = live_funcs;
+    u.live_vars = live_vars;
+    u.scanned_funcs = (char *)xcalloc(root->num_children, 1);
+    u.scanned_vars = (char *)xcalloc(num_vars, 1);
+    for (int i = 0; i < root->num_children; i++)
+        live_funcs[i] = function_label(root->children[i]) == NULL;
+    for (int k = 0; k < num_vars; k++)
+        live_vars[k] = !vars[k]->is_static || vars[k]->is_global;
+
+    // 从非 static 的函数和变量出发，沿着引用标记，直到没有新的对象
+    int progress = 1;
+    while (progress)
+    {
+        progress = 0;
+        for (int i = 0; i < root->num_children; i++)
+        {
+            ASTNode *child = root->children[i];
+            if (!live_funcs[i] || u.scanned_funcs[i] || child->type != AST_FUNCTION_DEF)
+                continue;
+            u.scanned_funcs[i] = 1;
+            progress = 1;
+            if (funcs[i])
+                scan_ir(&u, funcs[i]);
+            else
+                scan_ast(&u, child);
+        }
+        for (int k = 0; k < num_vars; k++)
+        {
+            if (!live_vars[k] || u.scanned_vars[k])
+                continue;
+            u.scanned_vars[k] = 1;
+            progress = 1;
+            scan_ast(&u, vars[k]->declaration);
+        }
+    }
+
+    int removed = 0;
+    for (int i = 0; i < root->num_children; i++)
+        removed += !live_funcs[i];
+    for (int k = 0; k < num_vars; k++)
+        removed += !live_vars[k];
+    free(u.scanned_funcs);
+    free(u.scanned_vars);
+    return removed;
+}
@@ -0,0 +1,279 @@
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+// inline：把同一编译单元内小函数的 IR 复制到调用处，省掉参数搬运、call/ret 和栈帧的开销，
+// 之后的 simplify-cfg 和寄存器分配把函数体和调用者作为一个整体处理。
+// 复制时被调函数的虚拟寄存器、栈上对象和标签都重新编号：
+//   IR_PARAM i → MOV 参数 ← 调用处第 i 个实参
+//   IR_RET a   → MOV 调用结果 ← a，然后跳到调用处之后的标签
+// 按调用图自底向上处理，被调函数先完成自己的内联；递归（直接或经过调用环）的函数不内联。
+
+#define INLINE_LEAF_DIVISOR 4 // 没有声明 inline 的叶子函数，预算为 limit 的这个分之一
+#define INLINE_GROWTH_FACTOR 8 // 一个调用者因内联增加的指令数不超过 limit 的这个倍数
+
+typedef enum
+{
+    VISIT_NONE,
+    VISIT_ACTIVE, // 正在处理（在调用链上）
+    VISIT_DONE
+} VisitState;
+
+typedef struct Inliner
+{
+    IrFunction **funcs;
+    int num_funcs;
+    int limit;
+    int (*new_label)(void *ctx);
+    void *ctx;
+    VisitState *state;
+    int changed;
+} Inliner;
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static int find_function(Inliner *in, const IrInstr *call)
+{
+    if (call->a.kind != IR_OPERAND_GLOBAL || !call->a.name)
+        return -1;
+    for (int i = 0; i < in->num_funcs; i++)
+    {
+        if (in->funcs[i] && strcmp(in->funcs[i]->name, call->a.name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// 函数大小：不计标签和参数的指令条数
+static int function_size(IrFunction *func)
+{
+    int size = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (func->instrs[i].op != IR_LABEL && func->instrs[i].op != IR_PARAM)
+            size++;
+    }
+    return size;
+}
+
+static int num_params(IrFunction *func)
+{
+    int count = 0;
+    while (count < func->num_instrs && func->instrs[count].op == IR_PARAM)
+        count++;
+    return count;
+}
+
+static int calls_function(IrFunction *func, const char *name)
+{
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        if (instr->op == IR_CALL && (!name || (instr->a.name && strcmp(instr->a.name, name) == 0)))
+            return 1;
+    }
+    return 0;
+}
+
+// 被调函数能否在这个调用处展开
+static int should_inline(Inliner *in, int caller, int callee, const IrInstr *call, int growth)
+{
+    IrFunction *func = in->funcs[callee];
+    if (callee == caller || in->state[callee] != VISIT_DONE)
+        return 0; // 递归
+    if (calls_function(func, func->name))
+        return 0;
+    // 实参个数必须和形参一致（可变参数或旧式声明的调用保持原样）
+    if (num_params(func) != call->num_args)
+        return 0;
+    int size = function_size(func);
+    int budget = func->is_inline ? in->limit : in->limit / INLINE_LEAF_DIVISOR;
+    if (size > budget || (!func->is_inline && calls_function(func, NULL)))
+        return 0;
+    return growth + size <= in->limit * INLINE_GROWTH_FACTOR;
+}
+
+static IrInstr *append(IrFunction *func, const IrInstr *instr)
+{
+    IrInstr *slot = ir_emit(func, instr->op, instr->dst, instr->a, instr->b);
+    *slot = *instr;
+    return slot;
+}
+
+// 一次展开的重新编号
+typedef struct Renaming
+{
+    int vreg_base;
+    int frame_base;
+    long min_label;
+    int num_labels;
+    int *labels; // 被调函数的标签 → 新标签
+} Renaming;
+
+static void rename_operand(const Renaming *r, IrOperand *operand)
+{
+    switch (operand->kind)
+    {
+    case IR_OPERAND_VREG:
+        operand->value += r->vreg_base;
+        break;
+    case IR_OPERAND_LOCAL:
+        operand->value += r->frame_base;
+        break;
+    case IR_OPERAND_LABEL:
+    {
+        long index = operand->value - r->min_label;
+        if (index >= 0 && index < r->num_labels && r->labels[index] >= 0)
+            operand->value = r->labels[index];
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+static void build_renaming(Inliner *in, IrFunction *caller, IrFunction *callee, Renaming *r)
+{
+    long min_label = 0, max_label = -1;
+    for (int i = 0; i < callee->num_instrs; i++)
+    {
+        IrInstr *instr = &callee->instrs[i];
+        if (instr->op != IR_LABEL)
+            continue;
+        if (max_label < min_label || instr->a.value < min_label)
+            min_label = instr->a.value;
+        if (instr->a.value > max_label)
+            max_label = instr->a.value;
+    }
+    r->vreg_base = caller->num_vregs;
+    r->frame_base = caller->frame_size;
+    r->min_label = min_label;
+    r->num_labels = max_label >= min_label ? (int)(max_label - min_label + 1) : 0;
+    r->labels = (int *)xcalloc(r->num_labels, sizeof(int));
+    for (int i = 0; i < r->num_labels; i++)
+        r->labels[i] = -1;
+    for (int i = 0; i < callee->num_instrs; i++)
+    {
+        if (callee->instrs[i].op == IR_LABEL)
+            r->labels[callee->instrs[i].a.value - min_label] = in->new_label(in->ctx);
+    }
+}
+
+// 在 caller 的末尾追加 callee 的函数体，call 的参数和结果换成传送
+static void expand_call(Inliner *in, IrFunction *caller, IrFunction *callee, const IrInstr *call)
+{
+    Renaming r;
+    build_renaming(in, caller, callee, &r);
+    caller->num_vregs += callee->num_vregs;
+    caller->frame_size += callee->frame_size;
+    int done_label = in->new_label(in->ctx);
+
+    for (int i = 0; i < callee->num_instrs; i++)
+    {
+        IrInstr copy = callee->instrs[i];
+        rename_operand(&r, &copy.dst);
+        rename_operand(&r, &copy.a);
+        rename_operand(&r, &copy.b);
+        if (copy.op == IR_PARAM)
+        {
+            // 不足 8 字节的参数和函数入口一样扩展
+            IrInstr *move = ir_emit(caller, copy.size < 8 ? IR_EXT : IR_MOV, copy.dst, call->args[copy.a.value],
+                                    ir_none());
+            move->size = copy.size;
+            move->is_unsigned = copy.is_unsigned;
+            continue;
+        }
+        if (copy.op == IR_RET)
+        {
+            if (call->dst.kind != IR_OPERAND_NONE && copy.a.kind != IR_OPERAND_NONE)
+                ir_emit(caller, IR_MOV, call->dst, copy.a, ir_none());
+            ir_emit(caller, IR_JMP, ir_none(), ir_label(done_label), ir_none());
+            continue;
+        }
+        if (copy.args)
+        {
+            copy.args = (IrOperand *)xcalloc(copy.num_args, sizeof(IrOperand));
+            for (int k = 0; k < copy.num_args; k++)
+            {
+                copy.args[k] = callee->instrs[i].args[k];
+                rename_operand(&r, &copy.args[k]);
+            }
+        }
+        append(caller, &copy);
+    }
+    ir_emit(caller, IR_LABEL, ir_none(), ir_label(done_label), ir_none());
+    free(r.labels);
+}
+
+static void inline_calls(Inliner *in, int index)
+{
+    IrFunction *func = in->funcs[index];
+    IrInstr *instrs = func->instrs;
+    int num_instrs = func->num_instrs;
+    int growth = 0;
+
+    // 重新生成指令数组：展开的调用原地替换为函数体
+    func->instrs = NULL;
+    func->num_instrs = 0;
+    func->capacity = 0;
+    for (int i = 0; i < num_instrs; i++)
+    {
+        IrInstr *instr = &instrs[i];
+        int callee = instr->op == IR_CALL ? find_function(in, instr) : -1;
+        if (callee < 0 || !should_inline(in, index, callee, instr, growth))
+        {
+            append(func, instr);
+            continue;
+        }
+        expand_call(in, func, in->funcs[callee], instr);
+        growth += function_size(in->funcs[callee]);
+        free(instr->args);
+        in->changed = 1;
+    }
+    free(instrs);
+}
+
+static void visit(Inliner *in, int index)
+{
+    IrFunction *func = in->funcs[index];
+    in->state[index] = VISIT_ACTIVE;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (func->instrs[i].op != IR_CALL)
+            continue;
+        int callee = find_function(in, &func->instrs[i]);
+        if (callee >= 0 && in->state[callee] == VISIT_NONE)
+            visit(in, callee);
+    }
+    inline_calls(in, index);
+    in->state[index] = VISIT_DONE;
+}
+
+int opt_inline(IrFunction **funcs, int num_funcs, int limit, int (*new_label)(void *ctx), void *ctx)
+{
+    Inliner in;
+    in.funcs = funcs;
+    in.num_funcs = num_funcs;
+    in.limit = limit;
+    in.new_label = new_label;
+    in.ctx = ctx;
+    in.state = (VisitState *)xcalloc(num_funcs, sizeof(VisitState));
+    in.changed = 0;
+
+    for (int i = 0; i < num_funcs; i++)
+    {
+        if (funcs[i] && in.state[i] == VISIT_NONE)
+            visit(&in, i);
+    }
+    free(in.state);
+    return in.changed;
+}
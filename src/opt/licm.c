@@ -0,0 +1,193 @@
+#include "loop.h"
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+// licm：循环中的不变计算（操作数在循环中都不会改变）移到前置块，进入循环之前只算一次，
+// 例如 a[i] 中数组的基地址、条件 i < n * 2 中的 n * 2。
+// IR 不是 SSA 形式：变量对应的 vreg 可以多次赋值，降低阶段产生的临时值只赋值一次。
+// 这里只移动在整个函数中只有一个定义的 vreg，移动之后它的每个使用看到的值都不变。
+// 可能出错的计算不移动：除法只在除数是非零且不是 -1 的常量时移动；
+// 加载只在循环中没有存储和调用、并且位于每次进入循环都会执行的头块时移动。
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+typedef struct Hoister
+{
+    IrFunction *func;
+    IrLoop *loop;
+    int *defs;         // vreg → 函数中的定义次数
+    int *loop_defs;    // vreg → 循环中的定义次数
+    char *hoisted;     // vreg 的定义已经决定移到前置块
+    int writes_memory; // 循环中有存储或函数调用
+} Hoister;
+
+static void hoister_init(Hoister *h, IrFunction *func, IrLoop *loop)
+{
+    h->func = func;
+    h->loop = loop;
+    h->defs = (int *)xcalloc(func->num_vregs, sizeof(int));
+    h->loop_defs = (int *)xcalloc(func->num_vregs, sizeof(int));
+    h->hoisted = (char *)xcalloc(func->num_vregs, 1);
+    h->writes_memory = 0;
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        for (int i = func->blocks[b].first; i <= func->blocks[b].last; i++)
+        {
+            IrInstr *instr = &func->instrs[i];
+            int d = ir_instr_def(instr);
+            if (d >= 0)
+            {
+                h->defs[d]++;
+                h->loop_defs[d] += loop->contains[b] != 0;
+            }
+            if (loop->contains[b] && (instr->op == IR_STORE || instr->op == IR_CALL))
+                h->writes_memory = 1;
+        }
+    }
+}
+
+static void hoister_free(Hoister *h)
+{
+    free(h->defs);
+    free(h->loop_defs);
+    free(h->hoisted);
+}
+
+static int is_invariant(Hoister *h, const IrOperand *operand)
+{
+    return operand->kind != IR_OPERAND_VREG || h->loop_defs[operand->value] == 0 || h->hoisted[operand->value];
+}
+
+static int can_hoist(Hoister *h, IrInstr *instr, int block)
+{
+    int dst = ir_instr_def(instr);
+    if (dst < 0 || h->defs[dst] != 1)
+        return 0;
+    switch (instr->op)
+    {
+    case IR_MOV:
+        if (instr->a.kind == IR_OPERAND_IMM)
+            return 0; // 常量不需要占用一个寄存器
+        break;
+    case IR_ADD:
+    case IR_SUB:
+    case IR_MUL:
+    case IR_AND:
+    case IR_OR:
+    case IR_XOR:
+    case IR_SHL:
+    case IR_SAR:
+    case IR_NEG:
+    case IR_NOT:
+    case IR_EXT:
+    case IR_EQ:
+    case IR_NE:
+    case IR_LT:
+    case IR_LE:
+    case IR_GT:
+    case IR_GE:
+        break;
+    case IR_DIV:
+    case IR_MOD:
+        if (instr->b.kind != IR_OPERAND_IMM || instr->b.value == 0 || instr->b.value == -1)
+            return 0;
+        break;
+    case IR_LOAD:
+        if (instr->a.kind == IR_OPERAND_GOT)
+            break; // GOT 表项在运行时不变
+        if (h->writes_memory || block != h->loop->header)
+            return 0;
+        break;
+    default:
+        return 0;
+    }
+    return is_invariant(h, &instr->a) && is_invariant(h, &instr->b);
+}
+
+// 找出可以移动的指令（移动后可能使依赖它们的指令也变成不变的，迭代到不动点），
+// 按找到的顺序记在 order 中，返回个数
+static int find_invariants(Hoister *h, char *moved, int *order)
+{
+    IrFunction *func = h->func;
+    int count = 0;
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int b = 0; b < func->num_blocks; b++)
+        {
+            if (!h->loop->contains[b])
+                continue;
+            for (int i = func->blocks[b].first; i <= func->blocks[b].last; i++)
+            {
+                if (moved[i] || !can_hoist(h, &func->instrs[i], b))
+                    continue;
+                moved[i] = 1;
+                h->hoisted[func->instrs[i].dst.value] = 1;
+                order[count++] = i;
+                changed = 1;
+            }
+        }
+    }
+    return count;
+}
+
+// 把 order 中的指令按顺序移到头块的标签之前（前置块的末尾）
+static void move_to_preheader(IrFunction *func, int header_first, char *moved, const int *order, int count)
+{
+    IrInstr *copies = (IrInstr *)xcalloc(count, sizeof(IrInstr));
+    for (int k = 0; k < count; k++)
+        copies[k] = func->instrs[order[k]];
+    int pos = header_first;
+    for (int i = 0; i < header_first; i++)
+        pos -= moved[i];
+    // 移动的都不是调用，没有 args，删除时不会释放复制出去的内容
+    ir_remove_instrs(func, moved);
+    ir_insert_instrs(func, pos, copies, count);
+    free(copies);
+}
+
+static int hoist_loop(IrFunction *func, IrLoopInfo **info, IrLoop *loop, void *ctx)
+{
+    (void)ctx;
+    // 先确认有东西可以移动，避免为没有收益的循环插入前置块
+    Hoister h;
+    hoister_init(&h, func, loop);
+    char *moved = (char *)xcalloc(func->num_instrs, 1);
+    int *order = (int *)xcalloc(func->num_instrs, sizeof(int));
+    int count = find_invariants(&h, moved, order);
+    hoister_free(&h);
+    free(moved);
+    free(order);
+    if (count == 0)
+        return 0;
+
+    loop = ir_prepare_loop(func, info, loop);
+    if (!loop)
+        return 0;
+    hoister_init(&h, func, loop);
+    moved = (char *)xcalloc(func->num_instrs, 1);
+    order = (int *)xcalloc(func->num_instrs, sizeof(int));
+    count = find_invariants(&h, moved, order);
+    if (count > 0)
+        move_to_preheader(func, func->blocks[loop->header].first, moved, order, count);
+    hoister_free(&h);
+    free(moved);
+    free(order);
+    return count > 0;
+}
+
+int opt_licm(IrFunction *func)
+{
+    return ir_visit_loops(func, hoist_loop, NULL);
+}
@@ -0,0 +1,587 @@
+#include "loop.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 循环分析：支配关系用迭代数据流计算（块数不多，位集合足够快），
+// 自然循环从回边的起点沿前驱反向搜索到头块为止。
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static void set_bit(uint64_t *set, int v)
+{
+    set[v / 64] |= (uint64_t)1 << (v % 64);
+}
+
+static int test_bit(const uint64_t *set, int v)
+{
+    return (set[v / 64] >> (v % 64)) & 1;
+}
+
+// 从入口块可达的块
+static char *reachable_blocks(IrFunction *func)
+{
+    char *reachable = (char *)xcalloc(func->num_blocks, 1);
+    int *stack = (int *)xcalloc(func->num_blocks, sizeof(int));
+    int top = 0;
+    reachable[0] = 1;
+    stack[top++] = 0;
+    while (top > 0)
+    {
+        IrBlock *block = &func->blocks[stack[--top]];
+        for (int s = 0; s < block->num_succs; s++)
+        {
+            if (!reachable[block->succs[s]])
+            {
+                reachable[block->succs[s]] = 1;
+                stack[top++] = block->succs[s];
+            }
+        }
+    }
+    free(stack);
+    return reachable;
+}
+
+// dom[b] = {b} ∪ ∩ dom[前驱]，入口块只被自己支配；不可达的块不参与
+static void compute_dominators(IrFunction *func, IrLoopInfo *info, const char *reachable)
+{
+    int n = func->num_blocks;
+    int words = info->words;
+    info->dom = (uint64_t *)xcalloc((size_t)n * words, sizeof(uint64_t));
+    for (int b = 0; b < n; b++)
+    {
+        uint64_t *dom = info->dom + (size_t)b * words;
+        if (b == 0)
+            set_bit(dom, 0);
+        else
+            memset(dom, 0xff, words * sizeof(uint64_t));
+    }
+
+    uint64_t *scratch = (uint64_t *)xcalloc(words, sizeof(uint64_t));
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int b = 1; b < n; b++)
+        {
+            if (!reachable[b])
+                continue;
+            IrBlock *block = &func->blocks[b];
+            memset(scratch, 0xff, words * sizeof(uint64_t));
+            for (int p = 0; p < block->num_preds; p++)
+            {
+                if (!reachable[block->preds[p]])
+                    continue;
+                const uint64_t *pred_dom = info->dom + (size_t)block->preds[p] * words;
+                for (int w = 0; w < words; w++)
+                    scratch[w] &= pred_dom[w];
+            }
+            set_bit(scratch, b);
+            uint64_t *dom = info->dom + (size_t)b * words;
+            if (memcmp(scratch, dom, words * sizeof(uint64_t)) != 0)
+            {
+                memcpy(dom, scratch, words * sizeof(uint64_t));
+                changed = 1;
+            }
+        }
+    }
+    free(scratch);
+}
+
+int ir_dominates(const IrLoopInfo *info, int a, int b)
+{
+    return test_bit(info->dom + (size_t)b * info->words, a);
+}
+
+// 把回边 latch → header 的自然循环并入 loop
+static void add_back_edge(IrFunction *func, IrLoop *loop, int latch, const char *reachable)
+{
+    loop->latches = (int *)realloc(loop->latches, (loop->num_latches + 1) * sizeof(int));
+    if (!loop->latches)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    loop->latches[loop->num_latches++] = latch;
+
+    int *stack = (int *)xcalloc(func->num_blocks, sizeof(int));
+    int top = 0;
+    if (!loop->contains[latch])
+    {
+        loop->contains[latch] = 1;
+        stack[top++] = latch;
+    }
+    while (top > 0)
+    {
+        IrBlock *block = &func->blocks[stack[--top]];
+        for (int p = 0; p < block->num_preds; p++)
+        {
+            int pred = block->preds[p];
+            if (reachable[pred] && !loop->contains[pred])
+            {
+                loop->contains[pred] = 1;
+                stack[top++] = pred;
+            }
+        }
+    }
+    free(stack);
+}
+
+static int compare_loops(const void *a, const void *b)
+{
+    const IrLoop *x = (const IrLoop *)a;
+    const IrLoop *y = (const IrLoop *)b;
+    if (x->num_blocks != y->num_blocks)
+        return x->num_blocks - y->num_blocks;
+    return x->header - y->header;
+}
+
+IrLoopInfo *ir_find_loops(IrFunction *func)
+{
+    IrLoopInfo *info = (IrLoopInfo *)xcalloc(1, sizeof(IrLoopInfo));
+    int n = func->num_blocks;
+    info->num_blocks = n;
+    info->words = (n + 63) / 64 ? (n + 63) / 64 : 1;
+    if (n == 0)
+        return info;
+
+    char *reachable = reachable_blocks(func);
+    compute_dominators(func, info, reachable);
+
+    // 头块 → 循环（同一个头块的回边合并）
+    int *loop_of = (int *)xcalloc(n, sizeof(int));
+    for (int b = 0; b < n; b++)
+        loop_of[b] = -1;
+    info->loops = (IrLoop *)xcalloc(n, sizeof(IrLoop));
+    for (int b = 0; b < n; b++)
+    {
+        if (!reachable[b])
+            continue;
+        IrBlock *block = &func->blocks[b];
+        for (int s = 0; s < block->num_succs; s++)
+        {
+            int header = block->succs[s];
+            if (!ir_dominates(info, header, b))
+                continue;
+            if (loop_of[header] < 0)
+            {
+                IrLoop *loop = &info->loops[info->num_loops];
+                loop_of[header] = info->num_loops++;
+                loop->header = header;
+                IrInstr *first = &func->instrs[func->blocks[header].first];
+                loop->label = first->op == IR_LABEL ? first->a.value : -1;
+                loop->contains = (char *)xcalloc(n, 1);
+                loop->contains[header] = 1;
+            }
+            add_back_edge(func, &info->loops[loop_of[header]], b, reachable);
+        }
+    }
+    free(loop_of);
+    free(reachable);
+
+    for (int i = 0; i < info->num_loops; i++)
+    {
+        IrLoop *loop = &info->loops[i];
+        for (int b = 0; b < n; b++)
+            loop->num_blocks += loop->contains[b] != 0;
+    }
+    qsort(info->loops, info->num_loops, sizeof(IrLoop), compare_loops);
+    // 嵌套深度：包含头块的循环个数（包括自己）
+    for (int i = 0; i < info->num_loops; i++)
+    {
+        for (int j = 0; j < info->num_loops; j++)
+            info->loops[i].depth += info->loops[j].contains[info->loops[i].header] != 0;
+    }
+    return info;
+}
+
+void ir_loops_free(IrLoopInfo *info)
+{
+    if (!info)
+        return;
+    for (int i = 0; i < info->num_loops; i++)
+    {
+        free(info->loops[i].contains);
+        free(info->loops[i].latches);
+    }
+    free(info->loops);
+    free(info->dom);
+    free(info);
+}
+
+IrLoop *ir_find_loop(IrLoopInfo *info, long label)
+{
+    for (int i = 0; i < info->num_loops; i++)
+    {
+        if (info->loops[i].label == label)
+            return &info->loops[i];
+    }
+    return NULL;
+}
+
+// 块的最后一条指令之后是否会顺序执行到下一块
+static int falls_through(IrFunction *func, int b)
+{
+    IrOpcode op = func->instrs[func->blocks[b].last].op;
+    return op != IR_JMP && op != IR_RET && op != IR_SWITCH;
+}
+
+// 块末尾的跳转中指向 from 的目标改为 to
+static void retarget(IrInstr *instr, long from, long to)
+{
+    if (instr->op == IR_JMP && instr->a.value == from)
+        instr->a.value = to;
+    if ((instr->op == IR_BR || instr->op == IR_SWITCH) && instr->dst.value == from)
+        instr->dst.value = to;
+    for (int k = 0; instr->op == IR_SWITCH && k < instr->num_args; k++)
+    {
+        if (instr->args[k].value == from)
+            instr->args[k].value = to;
+    }
+}
+
+int ir_make_preheader(IrFunction *func, const IrLoop *loop)
+{
+    if (loop->label < 0)
+        return -1;
+    int header = loop->header;
+    IrBlock *block = &func->blocks[header];
+    int num_outside = 0, outside = -1;
+    for (int p = 0; p < block->num_preds; p++)
+    {
+        if (!loop->contains[block->preds[p]])
+        {
+            num_outside++;
+            outside = block->preds[p];
+        }
+    }
+    if (num_outside == 0 && header != 0)
+        return -1;
+    if (num_outside == 1 && outside == header - 1 && func->blocks[outside].num_succs == 1 &&
+        falls_through(func, outside))
+        return 0;
+
+    // 循环外跳到头块的边改为跳到新的前置块；
+    // 排在头块前面的循环内的块原来顺序执行到头块，现在要跳过前置块
+    int pre_label = ir_new_label(func);
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        if (!loop->contains[b])
+            retarget(&func->instrs[func->blocks[b].last], loop->label, pre_label);
+    }
+    IrInstr seq[2];
+    int count = 0;
+    memset(seq, 0, sizeof(seq));
+    if (header > 0 && loop->contains[header - 1] && falls_through(func, header - 1))
+    {
+        seq[count].op = IR_JMP;
+        seq[count].size = 8;
+        seq[count++].a = ir_label((int)loop->label);
+    }
+    seq[count].op = IR_LABEL;
+    seq[count].size = 8;
+    seq[count++].a = ir_label(pre_label);
+    ir_insert_instrs(func, block->first, seq, count);
+    return 1;
+}
+
+IrLoop *ir_prepare_loop(IrFunction *func, IrLoopInfo **info, IrLoop *loop)
+{
+    long label = loop->label;
+    int status = ir_make_preheader(func, loop);
+    if (status < 0)
+        return NULL;
+    if (status == 0)
+        return loop;
+    ir_build_cfg(func);
+    ir_loops_free(*info);
+    *info = ir_find_loops(func);
+    return ir_find_loop(*info, label);
+}
+
+int ir_visit_loops(IrFunction *func, int (*visit)(IrFunction *func, IrLoopInfo **info, IrLoop *loop, void *ctx),
+                   void *ctx)
+{
+    // 待访问的循环按头块标签记录，访问过的标记为 -1
+    ir_build_cfg(func);
+    IrLoopInfo *info = ir_find_loops(func);
+    int num_pending = info->num_loops;
+    long *pending = (long *)xcalloc(num_pending, sizeof(long));
+    for (int i = 0; i < num_pending; i++)
+        pending[i] = info->loops[i].label;
+    ir_loops_free(info);
+
+    int changed = 0;
+    for (;;)
+    {
+        ir_build_cfg(func);
+        info = ir_find_loops(func);
+        IrLoop *loop = NULL;
+        for (int i = 0; i < info->num_loops && !loop; i++)
+        {
+            for (int k = 0; k < num_pending && !loop; k++)
+            {
+                if (pending[k] >= 0 && pending[k] == info->loops[i].label)
+                {
+                    loop = &info->loops[i];
+                    pending[k] = -1;
+                }
+            }
+        }
+        if (!loop)
+        {
+            ir_loops_free(info);
+            break;
+        }
+        changed |= visit(func, &info, loop, ctx) != 0;
+        ir_loops_free(info);
+    }
+    free(pending);
+    return changed;
+}
+
+// ========== 计数循环 ==========
+
+static int is_vreg(const IrOperand *operand, int vreg)
+{
+    return operand->kind == IR_OPERAND_VREG && operand->value == vreg;
+}
+
+// instr 是否为 iv + c / c + iv / iv - c（c 为常量）
+static int increment_of(const IrInstr *instr, int iv, long *step)
+{
+    if (instr->op == IR_ADD && is_vreg(&instr->a, iv) && instr->b.kind == IR_OPERAND_IMM)
+        *step = instr->b.value;
+    else if (instr->op == IR_ADD && is_vreg(&instr->b, iv) && instr->a.kind == IR_OPERAND_IMM)
+        *step = instr->a.value;
+    else if (instr->op == IR_SUB && is_vreg(&instr->a, iv) && instr->b.kind == IR_OPERAND_IMM)
+        *step = -instr->b.value;
+    else
+        return 0;
+    return 1;
+}
+
+// a <cond> b 换成 b <cond'> a
+static IrOpcode swap_condition(IrOpcode cond)
+{
+    switch (cond)
+    {
+    case IR_LT:
+        return IR_GT;
+    case IR_LE:
+        return IR_GE;
+    case IR_GT:
+        return IR_LT;
+    case IR_GE:
+        return IR_LE;
+    default:
+        return cond;
+    }
+}
+
+static int evaluate(IrOpcode cond, long a, long b)
+{
+    switch (cond)
+    {
+    case IR_EQ:
+        return a == b;
+    case IR_NE:
+        return a != b;
+    case IR_LT:
+        return a < b;
+    case IR_LE:
+        return a <= b;
+    case IR_GT:
+        return a > b;
+    default:
+        return a >= b;
+    }
+}
+
+// 循环中 vreg 的定义次数，以及最后一个定义的位置
+static int count_loop_defs(IrFunction *func, const IrLoop *loop, int vreg, int *pos)
+{
+    int count = 0;
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        if (!loop->contains[b])
+            continue;
+        for (int i = func->blocks[b].first; i <= func->blocks[b].last; i++)
+        {
+            if (ir_instr_def(&func->instrs[i]) == vreg)
+            {
+                count++;
+                *pos = i;
+            }
+        }
+    }
+    return count;
+}
+
+static int block_of(IrFunction *func, int pos)
+{
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        if (pos >= func->blocks[b].first && pos <= func->blocks[b].last)
+            return b;
+    }
+    return -1;
+}
+
+// vreg 是否为步长 ±1 的基本归纳变量：循环中唯一的定义是 iv = iv + c，
+// 或者 t = iv + c; iv = mov t（同一块中），并且每次迭代都会执行（所在块支配回边的起点）
+static int find_step(IrFunction *func, IrLoopInfo *info, const IrLoop *loop, int latch, int iv, long *step,
+                     int *def_pos, int *step_pos)
+{
+    int pos = -1;
+    *step_pos = -1;
+    if (count_loop_defs(func, loop, iv, &pos) != 1)
+        return 0;
+    IrInstr *instr = &func->instrs[pos];
+    int found = increment_of(instr, iv, step);
+    if (!found && ir_is_int_copy(instr) && instr->a.kind == IR_OPERAND_VREG)
+    {
+        int t = (int)instr->a.value;
+        int t_pos = -1;
+        if (count_loop_defs(func, loop, t, &t_pos) == 1 && t_pos < pos && block_of(func, t_pos) == block_of(func, pos))
+        {
+            found = increment_of(&func->instrs[t_pos], iv, step);
+            *step_pos = t_pos;
+        }
+    }
+    if (!found || (*step != 1 && *step != -1))
+        return 0;
+    *def_pos = pos;
+    return ir_dominates(info, block_of(func, pos), latch);
+}
+
+int ir_match_counted_loop(IrFunction *func, IrLoopInfo *info, const IrLoop *loop, IrCountedLoop *cl)
+{
+    memset(cl, 0, sizeof(*cl));
+    int header = loop->header;
+    if (loop->label < 0 || loop->num_latches != 1)
+        return 0;
+    // 最内层：其他循环的头块都不在这个循环中
+    for (int j = 0; j < info->num_loops; j++)
+    {
+        if (&info->loops[j] != loop && loop->contains[info->loops[j].header])
+            return 0;
+    }
+    // 循环的块是从头块开始的连续一段，最后一块 jmp 回头块
+    int latch = header + loop->num_blocks - 1;
+    if (loop->latches[0] != latch || latch <= header || latch >= func->num_blocks)
+        return 0;
+    for (int b = header; b <= latch; b++)
+    {
+        if (!loop->contains[b])
+            return 0;
+    }
+    IrInstr *back = &func->instrs[func->blocks[latch].last];
+    if (back->op != IR_JMP || back->a.value != loop->label)
+        return 0;
+    // 头块只有标签和一条比较
+    IrBlock *head = &func->blocks[header];
+    if (head->last != head->first + 1)
+        return 0;
+    IrInstr *br = &func->instrs[head->last];
+    if (br->op != IR_BR)
+        return 0;
+    // 唯一的出口是头块的比较
+    for (int b = header + 1; b <= latch; b++)
+    {
+        for (int s = 0; s < func->blocks[b].num_succs; s++)
+        {
+            if (!loop->contains[func->blocks[b].succs[s]])
+                return 0;
+        }
+        if (func->instrs[func->blocks[b].last].op == IR_RET)
+            return 0;
+    }
+
+    cl->header = header;
+    cl->latch = latch;
+    cl->body_first = head->last + 1;
+    cl->body_last = func->blocks[latch].last;
+    cl->exit_label = br->dst.value;
+    for (int i = cl->body_first; i < cl->body_last; i++)
+        cl->body_size += func->instrs[i].op != IR_LABEL;
+
+    // 比较写成 i <cond> bound
+    const IrOperand *bound;
+    if (br->a.kind == IR_OPERAND_VREG && find_step(func, info, loop, latch, (int)br->a.value, &cl->step, &cl->iv_def, &cl->step_def))
+    {
+        cl->iv = (int)br->a.value;
+        cl->cond = br->cond;
+        bound = &br->b;
+    }
+    else if (br->b.kind == IR_OPERAND_VREG && find_step(func, info, loop, latch, (int)br->b.value, &cl->step, &cl->iv_def, &cl->step_def))
+    {
+        cl->iv = (int)br->b.value;
+        cl->cond = swap_condition(br->cond);
+        bound = &br->a;
+    }
+    else
+    {
+        return 0;
+    }
+    int pos;
+    if (bound->kind == IR_OPERAND_VREG)
+    {
+        if (bound->value == cl->iv || count_loop_defs(func, loop, (int)bound->value, &pos) != 0)
+            return 0;
+    }
+    else if (bound->kind != IR_OPERAND_IMM)
+    {
+        return 0;
+    }
+    cl->bound = *bound;
+    // 退出条件要随 i 单调：递增时 i >= n / i > n，递减时 i <= n / i < n
+    if (cl->step > 0)
+        return cl->cond == IR_GE || cl->cond == IR_GT;
+    return cl->cond == IR_LE || cl->cond == IR_LT;
+}
+
+int ir_loop_initial_value(IrFunction *func, const IrCountedLoop *cl, long *value)
+{
+    int iv = cl->iv;
+    int b = cl->header - 1;
+    int visited = 0;
+    while (b >= 0 && visited++ < func->num_blocks)
+    {
+        for (int i = func->blocks[b].last; i >= func->blocks[b].first; i--)
+        {
+            IrInstr *instr = &func->instrs[i];
+            if (ir_instr_def(instr) != iv)
+                continue;
+            if (instr->op != IR_MOV || instr->a.kind != IR_OPERAND_IMM)
+                return 0;
+            *value = instr->a.value;
+            return 1;
+        }
+        if (func->blocks[b].num_preds != 1)
+            return 0;
+        b = func->blocks[b].preds[0];
+    }
+    return 0;
+}
+
+long ir_loop_trip_count(const IrCountedLoop *cl, long initial, long limit)
+{
+    long count = 0;
+    long i = initial;
+    while (!evaluate(cl->cond, i, cl->bound.value))
+    {
+        if (++count > limit)
+            return -1;
+        i += cl->step;
+    }
+    return count;
+}
@@ -0,0 +1,330 @@
+#include "pass_manager.h"
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+typedef enum
+{
+    PASS_KIND_AST, // 每个编译单元运行一次
+    PASS_KIND_IR,  // 每个函数运行一次
+    PASS_KIND_ASM  // 每个函数输出汇编之前运行一次
+} PassKind;
+
+typedef struct PassInfo
+{
+    const char *name; // -f<name> / -fno-<name>
+    PassKind kind;
+    int min_level; // 从这个 -O 级别开始默认启用（大于 OPT_LEVEL_MAX 表示只能用 -f<name> 打开）
+    const char *description;
+    int (*run_ir)(IrFunction *func);
+    int (*run_ast)(ASTNode *root);
+    int (*run_asm)(PeepholeBuffer *buf);
+} PassInfo;
+
+// 按运行顺序排列，下标与 PassId 一致
+static const PassInfo passes[NUM_PASSES] = {
+    {"constfold", PASS_KIND_AST, 1, "fold constant expressions and propagate constant variables", NULL, opt_constfold,
+     NULL},
+    {"inline", PASS_KIND_IR, 2, "expand small leaf functions and inline functions at their call sites", NULL, NULL,
+     NULL},
+    {"tail-calls", PASS_KIND_IR, 1, "turn self tail recursion into loops and emit other tail calls as jumps",
+     opt_tail_calls, NULL, NULL},
+    {"simplify-cfg", PASS_KIND_IR, 1, "remove unreachable code and redundant jumps", opt_simplify_cfg, NULL, NULL},
+    {"licm", PASS_KIND_IR, 2, "hoist loop-invariant computations into the loop preheader", opt_licm, NULL, NULL},
+    {"vectorize", PASS_KIND_IR, 2, "vectorize element-wise array loops and reductions (SSE2, AVX2 with -mavx2)", NULL,
+     NULL, NULL},
+    {"strength-reduce", PASS_KIND_IR, 2, "replace induction-variable multiplies with pointers bumped each iteration",
+     opt_strength_reduce, NULL, NULL},
+    {"unroll-loops", PASS_KIND_IR, OPT_LEVEL_MAX + 1,
+     "unroll counted for loops (remainder loop for the leftover iterations, short constant loops fully)", NULL, NULL,
+     NULL},
+    {"dce", PASS_KIND_IR, 1,
+     "remove unreachable blocks, unused computations and unreferenced static functions and variables", opt_dce, NULL,
+     NULL},
+    {"regalloc", PASS_KIND_IR, 1, "linear-scan register allocation", NULL, NULL, NULL},
+    {"peephole", PASS_KIND_ASM, 1, "rewrite redundant instruction sequences in the emitted assembly", NULL, NULL,
+     peephole_optimize},
+};
+
+static double now_ms(void)
+{
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1000.0 + ts.tv_nsec / 1000000.0;
+}
+
+// ========== 选项 ==========
+
+void pass_options_init(PassOptions *options)
+{
+    options->opt_level = OPT_LEVEL_DEFAULT;
+    memset(options->forced, -1, sizeof(options->forced));
+    options->verbose = 0;
+    options->inline_limit = INLINE_LIMIT_DEFAULT;
+    options->unroll_factor = UNROLL_FACTOR_DEFAULT;
+    options->avx2 = 0;
+}
+
+// 带数值的选项：name 是 "-finline-limit=" 这样的前缀，取值范围为 min..max
+typedef struct ValueOption
+{
+    const char *name;
+    long min;
+    long max;
+} ValueOption;
+
+static const ValueOption inline_limit_option = {"-finline-limit=", 0, INLINE_LIMIT_MAX};
+static const ValueOption unroll_factor_option = {"-funroll-factor=", UNROLL_FACTOR_MIN, UNROLL_FACTOR_MAX};
+
+// arg 以 option->name 开头时返回 1 并在 *value 中给出数值，数值不合法或超出范围返回 -2，其他选项返回 0
+static int parse_value_option(const ValueOption *option, const char *arg, int *value)
+{
+    size_t length = strlen(option->name);
+    if (strncmp(arg, option->name, length) != 0)
+        return 0;
+    char *end;
+    long number = strtol(arg + length, &end, 10);
+    if (arg[length] == '\0' || *end != '\0' || number < option->min || number > option->max)
+        return -2;
+    *value = (int)number;
+    return 1;
+}
+
+void pass_options_print_value_error(FILE *out, const char *arg)
+{
+    const ValueOption *option = &unroll_factor_option;
+    if (strncmp(arg, inline_limit_option.name, strlen(inline_limit_option.name)) == 0)
+        option = &inline_limit_option;
+    fprintf(out, "Invalid value '%s' for %s<n> (expected an integer in %ld..%ld)\n", arg + strlen(option->name),
+            option->name, option->min, option->max);
+}
+
+static int find_pass(const char *name)
+{
+    for (int i = 0; i < NUM_PASSES; i++)
+    {
+        if (strcmp(passes[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+int pass_options_parse(PassOptions *options, const char *arg)
+{
+    if (strcmp(arg, "-v") == 0 || strcmp(arg, "--verbose") == 0)
+    {
+        options->verbose = 1;
+        return 1;
+    }
+    if (strncmp(arg, "-O", 2) == 0)
+    {
+        const char *level = arg + 2;
+        if (*level == '\0')
+            options->opt_level = 1;
+        else if (level[0] >= '0' && level[0] <= '9' && level[1] == '\0')
+            options->opt_level = level[0] - '0' > OPT_LEVEL_MAX ? OPT_LEVEL_MAX : level[0] - '0';
+        else
+            return -1;
+        return 1;
+    }
+    int result = parse_value_option(&inline_limit_option, arg, &options->inline_limit);
+    if (result == 0)
+        result = parse_value_option(&unroll_factor_option, arg, &options->unroll_factor);
+    if (result != 0)
+        return result;
+    if (strcmp(arg, "-mavx2") == 0 || strcmp(arg, "-mno-avx2") == 0)
+    {
+        options->avx2 = arg[2] == 'a';
+        return 1;
+    }
+    if (strncmp(arg, "-f", 2) == 0)
+    {
+        int enable = 1;
+        const char *name = arg + 2;
+        if (strncmp(name, "no-", 3) == 0)
+        {
+            enable = 0;
+            name += 3;
+        }
+        int id = find_pass(name);
+        if (id < 0)
+            return -1;
+        options->forced[id] = (signed char)enable;
+        return 1;
+    }
+    return 0;
+}
+
+const char *pass_options_string(const PassOptions *options, char *buffer, size_t size)
+{
+    size_t len = (size_t)snprintf(buffer, size, "-O%d", options->opt_level);
+    for (int i = 0; i < NUM_PASSES && len < size; i++)
+    {
+        if (options->forced[i] >= 0)
+            len += (size_t)snprintf(buffer + len, size - len, " -f%s%s", options->forced[i] ? "" : "no-",
+                                    passes[i].name);
+    }
+    if (options->inline_limit != INLINE_LIMIT_DEFAULT && len < size)
+        len += (size_t)snprintf(buffer + len, size - len, " -finline-limit=%d", options->inline_limit);
+    if (options->unroll_factor != UNROLL_FACTOR_DEFAULT && len < size)
+        len += (size_t)snprintf(buffer + len, size - len, " -funroll-factor=%d", options->unroll_factor);
+    if (options->avx2 && len < size)
+        snprintf(buffer + len, size - len, " -mavx2");
+    return buffer;
+}
+
+void pass_options_print_help(FILE *out)
+{
+    fprintf(out, "Optimization passes (-f<pass> / -fno-<pass>):\n");
+    for (int i = 0; i < NUM_PASSES; i++)
+    {
+        if (passes[i].min_level > OPT_LEVEL_MAX)
+            fprintf(out, "  %-16s off   %s\n", passes[i].name, passes[i].description);
+        else
+            fprintf(out, "  %-16s -O%d+  %s\n", passes[i].name, passes[i].min_level, passes[i].description);
+    }
+    fprintf(out, "  -finline-limit=<n>  size budget of inlined functions in IR instructions (default %d)\n",
+            INLINE_LIMIT_DEFAULT);
+    fprintf(out, "  -funroll-factor=<n> copies of the loop body per unrolled iteration, 2..%d (default %d)\n",
+            UNROLL_FACTOR_MAX, UNROLL_FACTOR_DEFAULT);
+    fprintf(out, "  -mavx2              vectorize with 32-byte AVX2 registers (default 16-byte SSE2)\n");
+}
+
+// ========== 调度 ==========
+
+PassManager *pass_manager_create(const PassOptions *options)
+{
+    PassManager *pm = (PassManager *)calloc(1, sizeof(PassManager));
+    if (!pm)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    if (options)
+        pm->options = *options;
+    else
+        pass_options_init(&pm->options);
+    return pm;
+}
+
+void pass_manager_destroy(PassManager *pm)
+{
+    free(pm);
+}
+
+int pass_enabled(const PassManager *pm, PassId id)
+{
+    if (pm->options.forced[id] >= 0)
+        return pm->options.forced[id];
+    return pm->options.opt_level >= passes[id].min_level;
+}
+
+void pass_manager_run_ast(PassManager *pm, ASTNode *root)
+{
+    for (int i = 0; i < NUM_PASSES; i++)
+    {
+        if (passes[i].kind != PASS_KIND_AST || !passes[i].run_ast || !pass_enabled(pm, (PassId)i))
+            continue;
+        double start = now_ms();
+        int changed = passes[i].run_ast(root);
+        pm->stats[i].wall_ms += now_ms() - start;
+        pm->stats[i].runs++;
+        pm->stats[i].changed += changed != 0;
+    }
+}
+
+// 需要选项作为参数的 IR 遍（表中 run_ir 为 NULL）
+static int run_with_options(PassManager *pm, PassId id, IrFunction *func)
+{
+    if (id == PASS_VECTORIZE)
+        return opt_vectorize(func, pm->options.avx2 ? 32 : 16);
+    return opt_unroll_loops(func, pm->options.unroll_factor);
+}
+
+void pass_manager_run_ir(PassManager *pm, IrFunction *func)
+{
+    for (int i = 0; i < NUM_PASSES; i++)
+    {
+        int takes_options = i == PASS_VECTORIZE || i == PASS_UNROLL_LOOPS;
+        if (passes[i].kind != PASS_KIND_IR || (!passes[i].run_ir && !takes_options) || !pass_enabled(pm, (PassId)i))
+            continue;
+        double start = now_ms();
+        int changed = takes_options ? run_with_options(pm, (PassId)i, func) : passes[i].run_ir(func);
+        pm->stats[i].wall_ms += now_ms() - start;
+        pm->stats[i].runs++;
+        pm->stats[i].changed += changed != 0;
+    }
+    if (!func->blocks)
+        ir_build_cfg(func);
+}
+
+void pass_manager_inline(PassManager *pm, IrFunction **funcs, int num_funcs, int (*new_label)(void *ctx),
+                         void *ctx)
+{
+    if (!pass_enabled(pm, PASS_INLINE))
+        return;
+    double start = now_ms();
+    int changed = opt_inline(funcs, num_funcs, pm->options.inline_limit, new_label, ctx);
+    pm->stats[PASS_INLINE].wall_ms += now_ms() - start;
+    pm->stats[PASS_INLINE].runs++;
+    pm->stats[PASS_INLINE].changed += changed != 0;
+}
+
+void pass_manager_dce_unit(PassManager *pm, ASTNode *root, IrFunction **funcs, Symbol **vars, int num_vars,
+                           char *live_funcs, char *live_vars)
+{
+    if (!pass_enabled(pm, PASS_DCE))
+    {
+        memset(live_funcs, 1, root->num_children);
+        memset(live_vars, 1, num_vars);
+        return;
+    }
+    double start = now_ms();
+    int changed = opt_dce_unit(root, funcs, vars, num_vars, live_funcs, live_vars);
+    pm->stats[PASS_DCE].wall_ms += now_ms() - start;
+    pm->stats[PASS_DCE].runs++;
+    pm->stats[PASS_DCE].changed += changed != 0;
+}
+
+RegAllocation *pass_manager_allocate(PassManager *pm, IrFunction *func)
+{
+    if (!pass_enabled(pm, PASS_REGALLOC))
+        return regalloc_spill_all(func);
+    double start = now_ms();
+    RegAllocation *alloc = regalloc_run(func);
+    pm->stats[PASS_REGALLOC].wall_ms += now_ms() - start;
+    pm->stats[PASS_REGALLOC].runs++;
+    pm->stats[PASS_REGALLOC].changed++;
+    return alloc;
+}
+
+void pass_manager_run_asm(PassManager *pm, PeepholeBuffer *buf)
+{
+    for (int i = 0; i < NUM_PASSES; i++)
+    {
+        if (passes[i].kind != PASS_KIND_ASM || !passes[i].run_asm || !pass_enabled(pm, (PassId)i))
+            continue;
+        double start = now_ms();
+        int changed = passes[i].run_asm(buf);
+        pm->stats[i].wall_ms += now_ms() - start;
+        pm->stats[i].runs++;
+        pm->stats[i].changed += changed != 0;
+    }
+}
+
+void pass_manager_report(const PassManager *pm, FILE *out)
+{
+    char flags[256];
+    double total = 0;
+    for (int i = 0; i < NUM_PASSES; i++)
+        total += pm->stats[i].wall_ms;
+    fprintf(out, "===== Optimization passes (%s) =====\n", pass_options_string(&pm->options, flags, sizeof(flags)));
+    fprintf(out, "%-16s %8s %6s %8s %10s\n", "pass", "status", "runs", "changed", "time(ms)");
+    for (int i = 0; i < NUM_PASSES; i++)
+    {
+        fprintf(out, "%-16s %8s %6d %8d %10.3f\n", passes[i].name, pass_enabled(pm, (PassId)i) ? "on" : "off",
+                pm->stats[i].runs, pm->stats[i].changed, pm->stats[i].wall_ms);
+    }
+    fprintf(out, "%-16s %8s %6s %8s %10.3f\n", "total", "", "", "", total);
+}
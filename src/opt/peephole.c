@@ -0,0 +1,1323 @@
+#include "peephole.h"
+#include <stdlib.h>
+#include <string.h>
+
+// 窥孔优化：代码生成器（尤其是栈式代码生成器）按固定模板输出指令，
+// 留下大量 pushq/popq 对、先装入寄存器再使用的立即数、setcc + testq + je 这样的比较分支，
+// 以及跳到下一行的跳转。这里在每个函数的完整指令序列上按规则表做模式匹配和改写。
+
+static void *xmalloc(size_t size)
+{
+    void *p = malloc(size ? size : 1);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+static char *xstrdup(const char *s)
+{
+    size_t len = strlen(s);
+    char *copy = (char *)xmalloc(len + 1);
+    memcpy(copy, s, len + 1);
+    return copy;
+}
+
+// ========== 缓冲区 ==========
+
+PeepholeBuffer *peephole_create(void)
+{
+    PeepholeBuffer *buf = (PeepholeBuffer *)xmalloc(sizeof(PeepholeBuffer));
+    buf->lines = NULL;
+    buf->num_lines = 0;
+    buf->capacity = 0;
+    return buf;
+}
+
+void peephole_destroy(PeepholeBuffer *buf)
+{
+    if (!buf)
+        return;
+    for (int i = 0; i < buf->num_lines; i++)
+        free(buf->lines[i]);
+    free(buf->lines);
+    free(buf);
+}
+
+void peephole_append(PeepholeBuffer *buf, const char *line)
+{
+    if (buf->num_lines == buf->capacity)
+    {
+        buf->capacity = buf->capacity ? buf->capacity * 2 : 256;
+        char **lines = (char **)realloc(buf->lines, buf->capacity * sizeof(char *));
+        if (!lines)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+        buf->lines = lines;
+    }
+    buf->lines[buf->num_lines++] = xstrdup(line);
+}
+
+void peephole_flush(PeepholeBuffer *buf, FILE *out)
+{
+    for (int i = 0; i < buf->num_lines; i++)
+    {
+        fputs(buf->lines[i], out);
+        fputc('\n', out);
+        free(buf->lines[i]);
+    }
+    buf->num_lines = 0;
+}
+
+// ========== 指令模型 ==========
+
+enum
+{
+    R_RAX,
+    R_RCX,
+    R_RDX,
+    R_RBX,
+    R_RSP,
+    R_RBP,
+    R_RSI,
+    R_RDI,
+    R_R8,
+    R_R9,
+    R_R10,
+    R_R11,
+    R_R12,
+    R_R13,
+    R_R14,
+    R_R15,
+    NUM_GPRS
+};
+
+#define REG_BIT(r) (1u << (r))
+#define ALL_REGS 0xFFFFu
+// 调用读取的参数寄存器（%al 传可变参数的向量寄存器个数）
+#define CALL_USES (REG_BIT(R_RDI) | REG_BIT(R_RSI) | REG_BIT(R_RDX) | REG_BIT(R_RCX) | REG_BIT(R_R8) | \
+                   REG_BIT(R_R9) | REG_BIT(R_RAX) | REG_BIT(R_RSP))
+#define CALLER_SAVED (REG_BIT(R_RAX) | REG_BIT(R_RCX) | REG_BIT(R_RDX) | REG_BIT(R_RSI) | REG_BIT(R_RDI) | \
+                      REG_BIT(R_R8) | REG_BIT(R_R9) | REG_BIT(R_R10) | REG_BIT(R_R11))
+// 返回时仍然有意义的寄存器：返回值和被调用者保存的寄存器
+#define RET_LIVE (REG_BIT(R_RAX) | REG_BIT(R_RDX) | REG_BIT(R_RBX) | REG_BIT(R_RSP) | REG_BIT(R_RBP) | \
+                  REG_BIT(R_R12) | REG_BIT(R_R13) | REG_BIT(R_R14) | REG_BIT(R_R15))
+
+static const char *const reg_names[4][NUM_GPRS] = {
+    {"rax", "rcx", "rdx", "rbx", "rsp", "rbp", "rsi", "rdi", "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15"},
+    {"eax", "ecx", "edx", "ebx", "esp", "ebp", "esi", "edi", "r8d", "r9d", "r10d", "r11d", "r12d", "r13d", "r14d",
+     "r15d"},
+    {"ax", "cx", "dx", "bx", "sp", "bp", "si", "di", "r8w", "r9w", "r10w", "r11w", "r12w", "r13w", "r14w", "r15w"},
+    {"al", "cl", "dl", "bl", "spl", "bpl", "sil", "dil", "r8b", "r9b", "r10b", "r11b", "r12b", "r13b", "r14b",
+     "r15b"},
+};
+static const int reg_widths[4] = {64, 32, 16, 8};
+
+// 寄存器名（不含 %）→ 编号，width 返回位数；不是通用寄存器（%xmm0、%rip）时返回 -1
+static int parse_reg(const char *name, size_t len, int *width)
+{
+    static const char *const high_bytes[4] = {"ah", "ch", "dh", "bh"};
+    for (int w = 0; w < 4; w++)
+    {
+        for (int r = 0; r < NUM_GPRS; r++)
+        {
+            if (strlen(reg_names[w][r]) == len && strncmp(reg_names[w][r], name, len) == 0)
+            {
+                if (width)
+                    *width = reg_widths[w];
+                return r;
+            }
+        }
+    }
+    for (int r = 0; r < 4; r++)
+    {
+        if (len == 2 && strncmp(high_bytes[r], name, 2) == 0)
+        {
+            if (width)
+                *width = 8;
+            return r;
+        }
+    }
+    return -1;
+}
+
+typedef enum
+{
+    OPERAND_REG,  // 通用寄存器
+    OPERAND_IMM,  // $5、$label
+    OPERAND_MEM,  // -8(%rbp)、x(%rip)、(%rax,%rcx,8)
+    OPERAND_OTHER // %xmm0、*%rax 等
+} OperandKind;
+
+static OperandKind operand_kind(const char *op, int *reg, int *width)
+{
+    if (op[0] == '$')
+        return OPERAND_IMM;
+    if (op[0] == '%')
+    {
+        int r = parse_reg(op + 1, strlen(op + 1), width);
+        if (reg)
+            *reg = r;
+        return r >= 0 ? OPERAND_REG : OPERAND_OTHER;
+    }
+    if (op[0] == '*' || op[0] == '\0')
+        return OPERAND_OTHER;
+    return OPERAND_MEM;
+}
+
+// 操作数中出现的所有通用寄存器
+static unsigned operand_regs(const char *op)
+{
+    unsigned mask = 0;
+    for (const char *p = op; *p; p++)
+    {
+        if (*p != '%')
+            continue;
+        const char *name = p + 1;
+        size_t len = 0;
+        while ((name[len] >= 'a' && name[len] <= 'z') || (name[len] >= '0' && name[len] <= '9'))
+            len++;
+        int r = parse_reg(name, len, NULL);
+        if (r >= 0)
+            mask |= REG_BIT(r);
+    }
+    return mask;
+}
+
+typedef enum
+{
+    FLOW_NONE,
+    FLOW_JUMP,     // jmp label
+    FLOW_BRANCH,   // jcc label
+    FLOW_CALL,
+    FLOW_RET,
+    FLOW_INDIRECT  // jmp *%rax 等无法分析的控制流
+} Flow;
+
+typedef struct InstrInfo
+{
+    unsigned uses;      // 读取的寄存器
+    unsigned defs;      // 完整写入的寄存器（部分写入同时记为读取）
+    Flow flow;
+    int writes_memory;
+    int uses_stack;     // 读写 %rsp（push/pop/call 或以 %rsp 寻址）
+    int unknown;        // 不认识的指令：当作读取所有寄存器
+    char target[64];    // 跳转目标标签
+} InstrInfo;
+
+#define MAX_OPERANDS 3
+#define OPERAND_MAX 128
+
+// 把 "addq $1, -8(%rbp)" 拆成助记符和操作数，返回操作数个数（格式不认识时返回 -1）
+static int split_instr(const char *code, char *mnemonic, size_t mnemonic_size, char ops[][OPERAND_MAX])
+{
+    size_t len = strcspn(code, " ");
+    if (len == 0 || len >= mnemonic_size)
+        return -1;
+    memcpy(mnemonic, code, len);
+    mnemonic[len] = '\0';
+    const char *p = code + len;
+    if (*p == '\0')
+        return 0;
+    p++;
+    int count = 0;
+    while (*p)
+    {
+        if (count == MAX_OPERANDS)
+            return -1;
+        int depth = 0;
+        size_t n = 0;
+        while (p[n] && !(p[n] == ',' && depth == 0))
+        {
+            if (p[n] == '(')
+                depth++;
+            else if (p[n] == ')')
+                depth--;
+            n++;
+        }
+        if (n >= OPERAND_MAX)
+            return -1;
+        memcpy(ops[count], p, n);
+        ops[count][n] = '\0';
+        count++;
+        p += n;
+        if (*p == ',')
+            p++;
+        while (*p == ' ')
+            p++;
+    }
+    return count;
+}
+
+static int starts_with(const char *s, const char *prefix)
+{
+    return strncmp(s, prefix, strlen(prefix)) == 0;
+}
+
+static int starts_with_any(const char *s, const char *const *prefixes)
+{
+    for (int i = 0; prefixes[i]; i++)
+    {
+        if (starts_with(s, prefixes[i]))
+            return 1;
+    }
+    return 0;
+}
+
+// 条件码和它的反条件
+static const char *const conditions[][2] = {
+    {"e", "ne"}, {"ne", "e"}, {"z", "nz"}, {"nz", "z"}, {"l", "ge"}, {"ge", "l"}, {"le", "g"}, {"g", "le"},
+    {"b", "ae"}, {"ae", "b"}, {"be", "a"}, {"a", "be"}, {"s", "ns"}, {"ns", "s"}, {"p", "np"}, {"np", "p"},
+    {"o", "no"}, {"no", "o"},
+};
+
+static const char *invert_condition(const char *cc)
+{
+    for (size_t i = 0; i < sizeof(conditions) / sizeof(conditions[0]); i++)
+    {
+        if (strcmp(conditions[i][0], cc) == 0)
+            return conditions[i][1];
+    }
+    return NULL;
+}
+
+// 写目标操作数：mem 记为写内存，寄存器记为定义（8/16 位部分写入同时记为读取）
+static void write_operand(InstrInfo *info, const char *op)
+{
+    int reg = -1, width = 64;
+    OperandKind kind = operand_kind(op, &reg, &width);
+    if (kind == OPERAND_MEM)
+        info->writes_memory = 1;
+    else if (kind == OPERAND_REG)
+    {
+        info->defs |= REG_BIT(reg);
+        if (width < 32)
+            info->uses |= REG_BIT(reg);
+    }
+}
+
+static void analyze(const char *code, InstrInfo *info)
+{
+    static const char *const compares[] = {"cmp", "test", "ucomis", "comis", "bt", NULL};
+    static const char *const moves[] = {"mov", "lea", "cvt", NULL};
+    static const char *const alu[] = {"add", "sub", "and", "or", "xor", "imul", "sal", "sar", "shl", "shr",
+                                      "rol", "ror", "adc", "sbb", "cmov", "mul", "div", NULL};
+    static const char *const unary[] = {"neg", "not", "inc", "dec", "set", NULL};
+    static const char *const divides[] = {"idiv", "div", "imul", "mul", NULL};
+
+    char mnemonic[32];
+    char ops[MAX_OPERANDS][OPERAND_MAX];
+    memset(info, 0, sizeof(*info));
+    int n = split_instr(code, mnemonic, sizeof(mnemonic), ops);
+    if (n < 0)
+    {
+        info->unknown = 1;
+        info->uses = ALL_REGS;
+        return;
+    }
+    // 内存操作数中的地址寄存器总是被读取
+    for (int i = 0; i < n; i++)
+    {
+        if (operand_kind(ops[i], NULL, NULL) == OPERAND_MEM)
+            info->uses |= operand_regs(ops[i]);
+    }
+
+    const char *m = mnemonic;
+    if (strcmp(m, "jmp") == 0)
+    {
+        if (n == 1 && operand_kind(ops[0], NULL, NULL) == OPERAND_MEM && strlen(ops[0]) < sizeof(info->target))
+        {
+            info->flow = FLOW_JUMP;
+            strcpy(info->target, ops[0]);
+        }
+        else
+        {
+            info->flow = FLOW_INDIRECT;
+            info->uses = ALL_REGS;
+        }
+    }
+    else if (m[0] == 'j' && n == 1 && invert_condition(m + 1) && strlen(ops[0]) < sizeof(info->target))
+    {
+        info->flow = FLOW_BRANCH;
+        strcpy(info->target, ops[0]);
+    }
+    else if (strcmp(m, "call") == 0)
+    {
+        info->flow = FLOW_CALL;
+        info->uses |= CALL_USES | (n == 1 ? operand_regs(ops[0]) : 0);
+        info->defs = CALLER_SAVED;
+        info->writes_memory = 1;
+    }
+    else if (strcmp(m, "ret") == 0)
+    {
+        info->flow = FLOW_RET;
+        info->uses = RET_LIVE;
+    }
+    else if (strcmp(m, "pushq") == 0 && n == 1)
+    {
+        info->uses |= operand_regs(ops[0]) | REG_BIT(R_RSP);
+        info->defs = REG_BIT(R_RSP);
+        info->writes_memory = 1;
+    }
+    else if (strcmp(m, "popq") == 0 && n == 1)
+    {
+        info->uses |= REG_BIT(R_RSP);
+        write_operand(info, ops[0]);
+        info->defs |= REG_BIT(R_RSP);
+    }
+    else if (strcmp(m, "leave") == 0)
+    {
+        info->uses = REG_BIT(R_RBP);
+        info->defs = REG_BIT(R_RSP) | REG_BIT(R_RBP);
+    }
+    else if (strcmp(m, "cqto") == 0 || strcmp(m, "cqo") == 0 || strcmp(m, "cltd") == 0)
+    {
+        info->uses = REG_BIT(R_RAX);
+        info->defs = REG_BIT(R_RDX);
+    }
+    else if (strcmp(m, "cltq") == 0)
+    {
+        info->uses = REG_BIT(R_RAX);
+        info->defs = REG_BIT(R_RAX);
+    }
+    else if (strcmp(m, "nop") == 0)
+    {
+    }
+    else if (n == 1 && starts_with_any(m, divides))
+    {
+        info->uses |= operand_regs(ops[0]) | REG_BIT(R_RAX) | REG_BIT(R_RDX);
+        info->defs = REG_BIT(R_RAX) | REG_BIT(R_RDX);
+    }
+    else if (n == 1 && starts_with_any(m, unary))
+    {
+        info->uses |= operand_regs(ops[0]);
+        write_operand(info, ops[0]);
+    }
+    else if (n == 2 && starts_with_any(m, compares))
+    {
+        info->uses |= operand_regs(ops[0]) | operand_regs(ops[1]);
+    }
+    else if (n == 2 && starts_with_any(m, moves))
+    {
+        if (operand_kind(ops[0], NULL, NULL) != OPERAND_MEM || starts_with(m, "mov"))
+            info->uses |= operand_regs(ops[0]);
+        write_operand(info, ops[1]);
+    }
+    else if (n == 2 && starts_with_any(m, alu))
+    {
+        info->uses |= operand_regs(ops[0]) | operand_regs(ops[1]);
+        write_operand(info, ops[1]);
+    }
+    else
+    {
+        info->unknown = 1;
+        info->uses = ALL_REGS;
+        info->writes_memory = 1;
+    }
+    if ((info->uses | info->defs) & REG_BIT(R_RSP) || info->flow == FLOW_CALL || info->flow == FLOW_RET)
+        info->uses_stack = 1;
+}
+
+// ========== 函数上下文 ==========
+
+typedef enum
+{
+    LINE_BLANK,     // 空行、纯注释
+    LINE_DIRECTIVE, // .section 等伪指令：模式匹配不能跨越
+    LINE_LABEL,
+    LINE_INSTR,
+    LINE_DELETED
+} LineKind;
+
+typedef struct Line
+{
+    LineKind kind;
+    char *code;    // 去掉注释、合并空白后的文本（标签包含冒号）
+    int rewritten; // 被规则改写过，输出时用 code 代替原文
+} Line;
+
+typedef struct Context
+{
+    Line *lines;
+    int num_lines;
+    int *labels; // 标签所在的行号
+    int num_labels;
+    int labels_dirty;
+    int only_rule; // 自检时只启用一条规则，-1 表示全部启用
+} Context;
+
+static char *normalize(const char *text)
+{
+    char *code = (char *)xmalloc(strlen(text) + 1);
+    size_t len = 0;
+    int in_string = 0;
+    for (const char *p = text; *p; p++)
+    {
+        if (*p == '"' && (p == text || p[-1] != '\\'))
+            in_string = !in_string;
+        if (*p == '#' && !in_string)
+            break;
+        if ((*p == ' ' || *p == '\t') && !in_string)
+        {
+            if (len > 0 && code[len - 1] != ' ')
+                code[len++] = ' ';
+            continue;
+        }
+        code[len++] = *p;
+    }
+    while (len > 0 && code[len - 1] == ' ')
+        len--;
+    code[len] = '\0';
+    return code;
+}
+
+static LineKind classify(const char *code)
+{
+    size_t len = strlen(code);
+    if (len == 0)
+        return LINE_BLANK;
+    if (code[len - 1] == ':' && !strchr(code, ' '))
+        return LINE_LABEL;
+    if (code[0] == '.')
+        return LINE_DIRECTIVE;
+    return LINE_INSTR;
+}
+
+static void context_init(Context *ctx, char **texts, int count)
+{
+    ctx->lines = (Line *)xmalloc(count * sizeof(Line));
+    ctx->num_lines = count;
+    for (int i = 0; i < count; i++)
+    {
+        ctx->lines[i].code = normalize(texts[i]);
+        ctx->lines[i].kind = classify(ctx->lines[i].code);
+        ctx->lines[i].rewritten = 0;
+    }
+    ctx->labels = NULL;
+    ctx->num_labels = 0;
+    ctx->labels_dirty = 1;
+    ctx->only_rule = -1;
+}
+
+static void context_free(Context *ctx)
+{
+    for (int i = 0; i < ctx->num_lines; i++)
+        free(ctx->lines[i].code);
+    free(ctx->lines);
+    free(ctx->labels);
+}
+
+// 标签所在的行，不在本函数中时返回 -1
+static int find_label(Context *ctx, const char *name)
+{
+    if (ctx->labels_dirty)
+    {
+        free(ctx->labels);
+        ctx->labels = (int *)xmalloc(ctx->num_lines * sizeof(int));
+        ctx->num_labels = 0;
+        for (int i = 0; i < ctx->num_lines; i++)
+        {
+            if (ctx->lines[i].kind == LINE_LABEL)
+                ctx->labels[ctx->num_labels++] = i;
+        }
+        ctx->labels_dirty = 0;
+    }
+    size_t len = strlen(name);
+    for (int i = 0; i < ctx->num_labels; i++)
+    {
+        const char *code = ctx->lines[ctx->labels[i]].code;
+        if (strncmp(code, name, len) == 0 && code[len] == ':' && code[len + 1] == '\0')
+            return ctx->labels[i];
+    }
+    return -1;
+}
+
+// 跳过空行和已删除的行
+static int next_line(const Context *ctx, int i)
+{
+    while (i < ctx->num_lines && (ctx->lines[i].kind == LINE_BLANK || ctx->lines[i].kind == LINE_DELETED))
+        i++;
+    return i;
+}
+
+// 从第 start 行开始执行时，mask 中的寄存器是否可能在被重新写入之前被读取。
+// 沿 jmp 继续、在 jcc 处两条路径都检查；遇到无法分析的情况返回 1
+#define LIVENESS_BUDGET 256
+
+static int regs_live_from(Context *ctx, int start, unsigned mask, int *budget)
+{
+    for (int i = start; i < ctx->num_lines; i++)
+    {
+        Line *line = &ctx->lines[i];
+        if (line->kind == LINE_BLANK || line->kind == LINE_DELETED || line->kind == LINE_LABEL)
+            continue;
+        if (line->kind == LINE_DIRECTIVE || --*budget < 0)
+            return 1;
+        InstrInfo info;
+        analyze(line->code, &info);
+        if (info.uses & mask)
+            return 1;
+        if (info.flow == FLOW_RET || info.flow == FLOW_INDIRECT)
+            return 0;
+        if (info.flow == FLOW_JUMP || info.flow == FLOW_BRANCH)
+        {
+            int target = find_label(ctx, info.target);
+            if (target < 0)
+                return 1;
+            if (info.flow == FLOW_JUMP)
+            {
+                i = target;
+                continue;
+            }
+            if (regs_live_from(ctx, target + 1, mask, budget))
+                return 1;
+            continue;
+        }
+        mask &= ~info.defs;
+        if (mask == 0)
+            return 0;
+    }
+    return 1;
+}
+
+// ========== 模式匹配 ==========
+
+#define MAX_WINDOW 5
+#define MAX_BINDINGS 8
+#define BINDING_MAX 128
+
+typedef struct Match
+{
+    Context *ctx;
+    int pos[MAX_WINDOW]; // 匹配到的行号
+    int count;
+    int num_bindings;
+    char names[MAX_BINDINGS][8];
+    char values[MAX_BINDINGS][BINDING_MAX];
+} Match;
+
+static const char *lookup(const Match *m, const char *name, size_t len)
+{
+    for (int i = 0; i < m->num_bindings; i++)
+    {
+        if (strlen(m->names[i]) == len && strncmp(m->names[i], name, len) == 0)
+            return m->values[i];
+    }
+    return NULL;
+}
+
+static int bind(Match *m, const char *name, size_t name_len, const char *value, size_t value_len)
+{
+    if (m->num_bindings == MAX_BINDINGS || name_len >= sizeof(m->names[0]) || value_len >= BINDING_MAX)
+        return 0;
+    memcpy(m->names[m->num_bindings], name, name_len);
+    m->names[m->num_bindings][name_len] = '\0';
+    memcpy(m->values[m->num_bindings], value, value_len);
+    m->values[m->num_bindings][value_len] = '\0';
+    m->num_bindings++;
+    return 1;
+}
+
+static const char *get(const Match *m, const char *name)
+{
+    return lookup(m, name, strlen(name));
+}
+
+static int set(Match *m, const char *name, const char *value)
+{
+    return bind(m, name, strlen(name), value, strlen(value));
+}
+
+// 占位符 {x} 匹配一个操作数或助记符的一部分：非空，不跨越顶层的空格和逗号，括号配对。
+// 整行只有一个占位符时匹配整条指令
+static int match_text(const char *p, const char *s, Match *m)
+{
+    if (*p == '\0')
+        return *s == '\0';
+    if (*p != '{')
+        return *p == *s && match_text(p + 1, s + 1, m);
+
+    const char *name = p + 1;
+    const char *close = strchr(name, '}');
+    size_t name_len = (size_t)(close - name);
+    const char *rest = close + 1;
+    const char *bound = lookup(m, name, name_len);
+    if (bound)
+    {
+        size_t n = strlen(bound);
+        return strncmp(s, bound, n) == 0 && match_text(rest, s + n, m);
+    }
+
+    int depth = 0;
+    for (size_t len = 1; s[len - 1]; len++)
+    {
+        char c = s[len - 1];
+        if (c == '(')
+            depth++;
+        else if (c == ')')
+            depth--;
+        if (depth < 0 || (depth == 0 && (c == ' ' || c == ',')))
+            break;
+        if (depth > 0)
+            continue;
+        int saved = m->num_bindings;
+        if (bind(m, name, name_len, s, len) && match_text(rest, s + len, m))
+            return 1;
+        m->num_bindings = saved;
+    }
+    return 0;
+}
+
+static int match_line(const char *pattern, const char *code, Match *m)
+{
+    size_t len = strlen(pattern);
+    if (pattern[0] == '{' && pattern[len - 1] == '}' && strchr(pattern, '}') == pattern + len - 1)
+    {
+        const char *bound = lookup(m, pattern + 1, len - 2);
+        if (bound)
+            return strcmp(bound, code) == 0;
+        return bind(m, pattern + 1, len - 2, code, strlen(code));
+    }
+    return match_text(pattern, code, m);
+}
+
+// 用绑定替换模板中的占位符
+static int expand(const Match *m, const char *template_text, char *out, size_t size)
+{
+    size_t len = 0;
+    for (const char *p = template_text; *p;)
+    {
+        const char *text = p;
+        size_t n = 1;
+        if (*p == '{')
+        {
+            const char *close = strchr(p, '}');
+            text = lookup(m, p + 1, (size_t)(close - p - 1));
+            if (!text)
+                return 0;
+            n = strlen(text);
+            p = close + 1;
+        }
+        else
+        {
+            p++;
+        }
+        if (len + n >= size)
+            return 0;
+        memcpy(out + len, text, n);
+        len += n;
+    }
+    out[len] = '\0';
+    return 1;
+}
+
+// ========== 规则 ==========
+
+typedef struct PeepholeRule
+{
+    const char *name;
+    const char *before[MAX_WINDOW + 1]; // NULL 结尾；以冒号结尾的模式匹配标签，其余匹配指令
+    const char *after[MAX_WINDOW + 1];  // 行数不超过 before
+    int (*guard)(Match *m);             // 可以检查条件并添加新的绑定
+} PeepholeRule;
+
+static int last_line(const Match *m)
+{
+    return m->pos[m->count - 1];
+}
+
+// mask 中的寄存器在第 line 行之前已经死了（之后不会在写入前被读取）
+static int dead_from(Match *m, int line, unsigned mask)
+{
+    int budget = LIVENESS_BUDGET;
+    return !regs_live_from(m->ctx, line, mask, &budget);
+}
+
+static int dead_after(Match *m, unsigned mask)
+{
+    return dead_from(m, last_line(m) + 1, mask);
+}
+
+static OperandKind kind_of(const char *op)
+{
+    return operand_kind(op, NULL, NULL);
+}
+
+// 64 位通用寄存器，返回位掩码（不是时返回 0）
+static unsigned reg64(const char *op)
+{
+    int reg = -1, width = 0;
+    if (operand_kind(op, &reg, &width) != OPERAND_REG || width != 64)
+        return 0;
+    return REG_BIT(reg);
+}
+
+// 可以作为 movq/addq 源操作数的值：64 位寄存器、立即数或内存
+static int is_value(const char *op)
+{
+    return reg64(op) || kind_of(op) == OPERAND_IMM || kind_of(op) == OPERAND_MEM;
+}
+
+static int both_memory(const char *a, const char *b)
+{
+    return kind_of(a) == OPERAND_MEM && kind_of(b) == OPERAND_MEM;
+}
+
+static int is_one_of(const char *s, const char *const *list)
+{
+    for (int i = 0; list[i]; i++)
+    {
+        if (strcmp(s, list[i]) == 0)
+            return 1;
+    }
+    return 0;
+}
+
+// movq %rax, %rax
+static int guard_self_move(Match *m)
+{
+    return reg64(get(m, "a")) != 0;
+}
+
+// jmp/jcc 紧接着目标标签，或者 jcc L1; jmp L2; L1: 改为 j!cc L2
+static int guard_jump(Match *m)
+{
+    const char *cc = get(m, "cc");
+    return strcmp(cc, "mp") == 0 || invert_condition(cc);
+}
+
+static int guard_branch_over_jump(Match *m)
+{
+    const char *inverse = invert_condition(get(m, "cc"));
+    return inverse && set(m, "nc", inverse);
+}
+
+// 目标标签后的第一条指令是 jmp 时直接跳到最终目标（遇到环时放弃）
+static int guard_thread_jump(Match *m)
+{
+    if (!guard_jump(m))
+        return 0;
+    char visited[8][BINDING_MAX];
+    int num_visited = 0;
+    char target[BINDING_MAX];
+    strcpy(target, get(m, "L"));
+    while (num_visited < 8)
+    {
+        int label = find_label(m->ctx, target);
+        if (label < 0)
+            break;
+        int next = label;
+        while ((next = next_line(m->ctx, next + 1)) < m->ctx->num_lines && m->ctx->lines[next].kind == LINE_LABEL)
+            ;
+        if (next >= m->ctx->num_lines || m->ctx->lines[next].kind != LINE_INSTR ||
+            strncmp(m->ctx->lines[next].code, "jmp ", 4) != 0)
+            break;
+        const char *final = m->ctx->lines[next].code + 4;
+        if (strlen(final) >= BINDING_MAX || find_label(m->ctx, final) < 0)
+            break;
+        for (int i = 0; i < num_visited; i++)
+        {
+            if (strcmp(visited[i], final) == 0)
+                return 0;
+        }
+        strcpy(visited[num_visited++], target);
+        strcpy(target, final);
+    }
+    return num_visited > 0 && strcmp(target, get(m, "L")) != 0 && set(m, "M", target);
+}
+
+// setcc %al; movzbq %al, %rax; testq %rax, %rax; je L  改为  j!cc L
+static int guard_setcc_branch(Match *m)
+{
+    static const char *const tests[] = {"testq %rax, %rax", "cmpq $0, %rax", NULL};
+    const char *cc = get(m, "cc");
+    const char *jcc = get(m, "j");
+    const char *inverse = invert_condition(cc);
+    if (!inverse || !is_one_of(get(m, "t"), tests))
+        return 0;
+    int jump_if_zero = strcmp(jcc, "e") == 0 || strcmp(jcc, "z") == 0;
+    if (!jump_if_zero && strcmp(jcc, "ne") != 0 && strcmp(jcc, "nz") != 0)
+        return 0;
+    // %rax 在跳转目标和下一条指令处都必须已经死了
+    return dead_from(m, last_line(m), REG_BIT(R_RAX)) && set(m, "c", jump_if_zero ? inverse : cc);
+}
+
+static int no_stack_pointer(const char *op)
+{
+    return !(operand_regs(op) & REG_BIT(R_RSP));
+}
+
+// pushq a; popq a
+static int guard_push_pop_same(Match *m)
+{
+    const char *a = get(m, "a");
+    return reg64(a) && no_stack_pointer(a);
+}
+
+// pushq a; popq b  改为  movq a, b
+static int guard_push_pop(Match *m)
+{
+    const char *a = get(m, "a");
+    const char *b = get(m, "b");
+    return is_value(a) && (reg64(b) || kind_of(b) == OPERAND_MEM) && !both_memory(a, b) && no_stack_pointer(a) &&
+           no_stack_pointer(b);
+}
+
+// pushq a; ...; popq b：中间的指令不碰栈、不改变 a 时，改为 ...; movq a, b
+static int guard_push_over(Match *m)
+{
+    static const char *const names[] = {"i", "j", "k"};
+    if (!guard_push_pop(m))
+        return 0;
+    const char *a = get(m, "a");
+    for (int i = 0; i < 3; i++)
+    {
+        const char *code = get(m, names[i]);
+        if (!code)
+            break;
+        InstrInfo info;
+        analyze(code, &info);
+        if (info.unknown || info.flow != FLOW_NONE || info.uses_stack || (info.defs & operand_regs(a)) ||
+            (kind_of(a) == OPERAND_MEM && info.writes_memory))
+            return 0;
+    }
+    return 1;
+}
+
+// movq a, r; pushq r  改为  pushq a（r 之后不再使用）
+static int guard_load_push(Match *m)
+{
+    const char *a = get(m, "a");
+    unsigned r = reg64(get(m, "r"));
+    return r && !(r & REG_BIT(R_RSP)) && is_value(a) && no_stack_pointer(a) && dead_after(m, r);
+}
+
+// 结果不再被使用的寄存器写入
+static int guard_dead_move(Match *m)
+{
+    static const char *const ops[] = {"movq",   "movl",   "movabsq", "leaq",   "movzbq",
+                                      "movsbq", "movslq", "movswq",  "movzwq", NULL};
+    int reg = -1, width = 0;
+    if (!is_one_of(get(m, "op"), ops) || operand_kind(get(m, "r"), &reg, &width) != OPERAND_REG || width < 32)
+        return 0;
+    return dead_after(m, REG_BIT(reg));
+}
+
+// movq r, m; movq m, r：第二条是多余的
+static int guard_store_reload(Match *m)
+{
+    unsigned r = reg64(get(m, "r"));
+    const char *mem = get(m, "m");
+    return r && kind_of(mem) == OPERAND_MEM && !(operand_regs(mem) & r);
+}
+
+// movq a, b; movq b, c  改为  movq a, c（b 之后不再使用）
+static int guard_copy_chain(Match *m)
+{
+    const char *a = get(m, "a");
+    const char *c = get(m, "c");
+    unsigned b = reg64(get(m, "b"));
+    return b && is_value(a) && (reg64(c) || kind_of(c) == OPERAND_MEM) && !both_memory(a, c) && dead_after(m, b);
+}
+
+// movq a, r; op r, d  改为  op a, d（立即数、内存操作数直接作为源操作数）
+static int guard_fold_operand(Match *m)
+{
+    static const char *const ops[] = {"addq", "subq", "andq", "orq", "xorq", "cmpq", "testq", "imulq", NULL};
+    const char *a = get(m, "a");
+    const char *d = get(m, "d");
+    unsigned r = reg64(get(m, "r"));
+    if (!r || (r & (REG_BIT(R_RSP) | REG_BIT(R_RBP))) || !is_one_of(get(m, "op"), ops) || !is_value(a))
+        return 0;
+    if (!(reg64(d) || kind_of(d) == OPERAND_MEM) || (operand_regs(d) & r) || both_memory(a, d))
+        return 0;
+    if (strcmp(get(m, "op"), "imulq") == 0 && !reg64(d))
+        return 0;
+    return dead_after(m, r);
+}
+
+// movq a, b; op x, b; movq b, a  改为  op x, a（b 只是 a 的临时副本）
+static int guard_op_through_copy(Match *m)
+{
+    static const char *const ops[] = {"addq", "subq", "andq", "orq", "xorq", "imulq", "salq", "sarq", "shlq", "shrq",
+                                      NULL};
+    static const char *const shifts[] = {"salq", "sarq", "shlq", "shrq", NULL};
+    const char *op = get(m, "op");
+    const char *a = get(m, "a");
+    const char *x = get(m, "x");
+    unsigned b = reg64(get(m, "b"));
+    if (!b || !is_one_of(op, ops) || (operand_regs(x) & b))
+        return 0;
+    if (!(reg64(a) || kind_of(a) == OPERAND_MEM) || (operand_regs(a) & b))
+        return 0;
+    if (!is_value(x) && !(is_one_of(op, shifts) && strcmp(x, "%cl") == 0))
+        return 0;
+    if (kind_of(a) == OPERAND_MEM && (kind_of(x) == OPERAND_MEM || strcmp(op, "imulq") == 0))
+        return 0;
+    return dead_after(m, b);
+}
+
+static int guard_unary_through_copy(Match *m)
+{
+    static const char *const ops[] = {"negq", "notq", "incq", "decq", NULL};
+    const char *a = get(m, "a");
+    unsigned b = reg64(get(m, "b"));
+    return b && is_one_of(get(m, "op"), ops) && (reg64(a) || kind_of(a) == OPERAND_MEM) && !(operand_regs(a) & b) &&
+           dead_after(m, b);
+}
+
+// movq a, b; cmpq x, b  改为  cmpq x, a
+static int guard_cmp_through_copy(Match *m)
+{
+    static const char *const ops[] = {"cmpq", "testq", NULL};
+    const char *a = get(m, "a");
+    const char *x = get(m, "x");
+    unsigned b = reg64(get(m, "b"));
+    return b && is_one_of(get(m, "op"), ops) && (reg64(a) || kind_of(a) == OPERAND_MEM) && is_value(x) &&
+           !(operand_regs(x) & b) && !both_memory(a, x) && dead_after(m, b);
+}
+
+static int guard_test_through_copy(Match *m)
+{
+    unsigned b = reg64(get(m, "b"));
+    return b && reg64(get(m, "a")) && dead_after(m, b);
+}
+
+// leaq m, r; movq (r), d  改为  movq m, d（地址只用一次）
+static int guard_lea_load(Match *m)
+{
+    const char *mem = get(m, "m");
+    unsigned r = reg64(get(m, "r"));
+    unsigned d = reg64(get(m, "d"));
+    return r && d && kind_of(mem) == OPERAND_MEM && (d == r || dead_after(m, r));
+}
+
+// leaq m, r; movq s, (r)  改为  movq s, m
+static int guard_lea_store(Match *m)
+{
+    const char *mem = get(m, "m");
+    const char *value = get(m, "s");
+    unsigned r = reg64(get(m, "r"));
+    return r && kind_of(mem) == OPERAND_MEM && (reg64(value) || kind_of(value) == OPERAND_IMM) &&
+           !(operand_regs(value) & r) && dead_after(m, r);
+}
+
+// 按顺序尝试，同一位置上第一条成立的规则生效
+static const PeepholeRule rules[] = {
+    {"self-move", {"movq {a}, {a}", NULL}, {NULL}, guard_self_move},
+    {"unreachable", {"jmp {L}", "{i}", NULL}, {"jmp {L}", NULL}, NULL},
+    {"unreachable-ret", {"ret", "{i}", NULL}, {"ret", NULL}, NULL},
+    {"jump-to-next", {"j{cc} {L}", "{L}:", NULL}, {"{L}:", NULL}, guard_jump},
+    {"jump-over-label", {"j{cc} {L}", "{X}:", "{L}:", NULL}, {"{X}:", "{L}:", NULL}, guard_jump},
+    {"branch-over-jump", {"j{cc} {L}", "jmp {M}", "{L}:", NULL}, {"j{nc} {M}", "{L}:", NULL}, guard_branch_over_jump},
+    {"thread-jump", {"j{cc} {L}", NULL}, {"j{cc} {M}", NULL}, guard_thread_jump},
+    // 条件跳转不改变标志位，紧接着的相同比较是多余的（switch 的二分查找常见）
+    {"repeat-compare", {"cmpq {a}, {b}", "j{cc} {L}", "cmpq {a}, {b}", NULL}, {"cmpq {a}, {b}", "j{cc} {L}", NULL},
+     NULL},
+    {"setcc-branch", {"set{cc} %al", "movzbq %al, %rax", "{t}", "j{j} {L}", NULL}, {"j{c} {L}", NULL},
+     guard_setcc_branch},
+    {"push-pop-same", {"pushq {a}", "popq {a}", NULL}, {NULL}, guard_push_pop_same},
+    {"push-pop", {"pushq {a}", "popq {b}", NULL}, {"movq {a}, {b}", NULL}, guard_push_pop},
+    {"load-push", {"movq {a}, {r}", "pushq {r}", NULL}, {"pushq {a}", NULL}, guard_load_push},
+    {"push-over", {"pushq {a}", "{i}", "popq {b}", NULL}, {"{i}", "movq {a}, {b}", NULL}, guard_push_over},
+    {"push-over-2", {"pushq {a}", "{i}", "{j}", "popq {b}", NULL}, {"{i}", "{j}", "movq {a}, {b}", NULL},
+     guard_push_over},
+    {"push-over-3", {"pushq {a}", "{i}", "{j}", "{k}", "popq {b}", NULL}, {"{i}", "{j}", "{k}", "movq {a}, {b}", NULL},
+     guard_push_over},
+    {"lea-load", {"leaq {m}, {r}", "movq ({r}), {d}", NULL}, {"movq {m}, {d}", NULL}, guard_lea_load},
+    {"lea-store", {"leaq {m}, {r}", "movq {s}, ({r})", NULL}, {"movq {s}, {m}", NULL}, guard_lea_store},
+    {"store-reload", {"movq {r}, {m}", "movq {m}, {r}", NULL}, {"movq {r}, {m}", NULL}, guard_store_reload},
+    {"op-through-copy", {"movq {a}, {b}", "{op} {x}, {b}", "movq {b}, {a}", NULL}, {"{op} {x}, {a}", NULL},
+     guard_op_through_copy},
+    {"unary-through-copy", {"movq {a}, {b}", "{op} {b}", "movq {b}, {a}", NULL}, {"{op} {a}", NULL},
+     guard_unary_through_copy},
+    {"cmp-through-copy", {"movq {a}, {b}", "{op} {x}, {b}", NULL}, {"{op} {x}, {a}", NULL}, guard_cmp_through_copy},
+    {"test-through-copy", {"movq {a}, {b}", "testq {b}, {b}", NULL}, {"testq {a}, {a}", NULL},
+     guard_test_through_copy},
+    {"fold-operand", {"movq {a}, {r}", "{op} {r}, {d}", NULL}, {"{op} {a}, {d}", NULL}, guard_fold_operand},
+    {"copy-chain", {"movq {a}, {b}", "movq {b}, {c}", NULL}, {"movq {a}, {c}", NULL}, guard_copy_chain},
+    {"dead-move", {"{op} {a}, {r}", NULL}, {NULL}, guard_dead_move},
+};
+
+#define NUM_RULES ((int)(sizeof(rules) / sizeof(rules[0])))
+
+static int pattern_is_label(const char *pattern)
+{
+    size_t len = strlen(pattern);
+    return len > 0 && pattern[len - 1] == ':';
+}
+
+static int try_rule(Context *ctx, const PeepholeRule *rule, int start)
+{
+    Match m;
+    m.ctx = ctx;
+    m.count = 0;
+    m.num_bindings = 0;
+    int i = start;
+    for (int k = 0; rule->before[k]; k++)
+    {
+        i = next_line(ctx, i);
+        if (i >= ctx->num_lines)
+            return 0;
+        const char *pattern = rule->before[k];
+        if (ctx->lines[i].kind != (pattern_is_label(pattern) ? LINE_LABEL : LINE_INSTR))
+            return 0;
+        if (!match_line(pattern, ctx->lines[i].code, &m))
+            return 0;
+        m.pos[m.count++] = i++;
+    }
+    if (rule->guard && !rule->guard(&m))
+        return 0;
+
+    char text[BINDING_MAX * 4];
+    int k = 0;
+    for (; rule->after[k]; k++)
+    {
+        if (!expand(&m, rule->after[k], text, sizeof(text)))
+            return 0;
+    }
+    for (k = 0; rule->after[k]; k++)
+    {
+        Line *line = &ctx->lines[m.pos[k]];
+        expand(&m, rule->after[k], text, sizeof(text));
+        free(line->code);
+        line->code = xstrdup(text);
+        line->kind = pattern_is_label(rule->after[k]) ? LINE_LABEL : LINE_INSTR;
+        line->rewritten = 1;
+    }
+    for (; k < m.count; k++)
+        ctx->lines[m.pos[k]].kind = LINE_DELETED;
+    ctx->labels_dirty = 1;
+    return 1;
+}
+
+static int run_rules(Context *ctx)
+{
+    int total = 0;
+    // 规则之间会互相创造机会（例如 load-push 之后才能 push-over），循环到不再变化
+    for (int round = 0; round < 16; round++)
+    {
+        int changed = 0;
+        for (int i = next_line(ctx, 0); i < ctx->num_lines; i = next_line(ctx, i + 1))
+        {
+            if (ctx->lines[i].kind != LINE_INSTR && ctx->lines[i].kind != LINE_LABEL)
+                continue;
+            for (int r = 0; r < NUM_RULES; r++)
+            {
+                if (ctx->only_rule >= 0 && r != ctx->only_rule)
+                    continue;
+                if (try_rule(ctx, &rules[r], i))
+                {
+                    changed++;
+                    break;
+                }
+            }
+        }
+        total += changed;
+        if (!changed)
+            break;
+    }
+    return total;
+}
+
+int peephole_optimize(PeepholeBuffer *buf)
+{
+    Context ctx;
+    context_init(&ctx, buf->lines, buf->num_lines);
+    int changed = run_rules(&ctx);
+    if (changed)
+    {
+        int count = 0;
+        for (int i = 0; i < ctx.num_lines; i++)
+        {
+            Line *line = &ctx.lines[i];
+            if (line->kind == LINE_DELETED)
+            {
+                free(buf->lines[i]);
+                continue;
+            }
+            if (line->rewritten)
+            {
+                free(buf->lines[i]);
+                size_t len = strlen(line->code);
+                buf->lines[i] = (char *)xmalloc(len + 5);
+                sprintf(buf->lines[i], "%s%s", line->kind == LINE_LABEL ? "" : "    ", line->code);
+            }
+            buf->lines[count++] = buf->lines[i];
+        }
+        buf->num_lines = count;
+    }
+    context_free(&ctx);
+    return changed;
+}
+
+// ========== 自检 ==========
+
+// 每条规则单独启用时的输入和期望输出（行之间用 \n 分隔）；
+// 期望输出与输入相同的例子检查 guard 拒绝了不安全的改写
+typedef struct PeepholeExample
+{
+    const char *rule;
+    const char *before;
+    const char *after;
+} PeepholeExample;
+
+static const PeepholeExample examples[] = {
+    {"self-move", "movq %rax, %rax\nret", "ret"},
+    {"unreachable", "jmp .L1\nmovq $1, %rax\n.L1:\nret", "jmp .L1\n.L1:\nret"},
+    {"unreachable-ret", "ret\naddq $1, %rax\n.L1:\nret", "ret\n.L1:\nret"},
+    {"jump-to-next", "jmp .L1\n.L1:\nret", ".L1:\nret"},
+    {"jump-to-next", "je .L1\n.L1:\nret", ".L1:\nret"},
+    {"jump-over-label", "jmp .L2\n.L1:\n.L2:\nret", ".L1:\n.L2:\nret"},
+    {"branch-over-jump", "jl .L1\njmp .L2\n.L1:\nret\n.L2:\nret", "jge .L2\n.L1:\nret\n.L2:\nret"},
+    {"thread-jump", "jne .L1\nret\n.L1:\njmp .L2\n.L2:\nret", "jne .L2\nret\n.L1:\njmp .L2\n.L2:\nret"},
+    {"thread-jump", "jmp .L1\n.L1:\njmp .L2\n.L2:\njmp .L1", "jmp .L1\n.L1:\njmp .L2\n.L2:\njmp .L1"},
+    {"repeat-compare", "cmpq $97, %rdi\njl .L1\ncmpq $97, %rdi\nje .L2\n.L1:\nret\n.L2:\nret",
+     "cmpq $97, %rdi\njl .L1\nje .L2\n.L1:\nret\n.L2:\nret"},
+    {"setcc-branch", "cmpq %rbx, %rax\nsetl %al\nmovzbq %al, %rax\ntestq %rax, %rax\nje .L1\nmovq $1, %rax\n.L1:\n"
+                     "movq $0, %rax\nret",
+     "cmpq %rbx, %rax\njge .L1\nmovq $1, %rax\n.L1:\nmovq $0, %rax\nret"},
+    {"setcc-branch", "sete %al\nmovzbq %al, %rax\ncmpq $0, %rax\njne .L1\nmovq $0, %rax\nret\n.L1:\nmovq $1, %rax\nret",
+     "je .L1\nmovq $0, %rax\nret\n.L1:\nmovq $1, %rax\nret"},
+    {"setcc-branch", "setg %al\nmovzbq %al, %rax\ntestq %rax, %rax\nje .L1\nret\n.L1:\nret",
+     "setg %al\nmovzbq %al, %rax\ntestq %rax, %rax\nje .L1\nret\n.L1:\nret"},
+    {"push-pop-same", "pushq %rax\npopq %rax\nret", "ret"},
+    {"push-pop", "pushq %rax\npopq %rbx\nret", "movq %rax, %rbx\nret"},
+    {"push-pop", "pushq -8(%rbp)\npopq -16(%rbp)\nret", "pushq -8(%rbp)\npopq -16(%rbp)\nret"},
+    {"load-push", "movq $5, %rax\npushq %rax\nmovq -8(%rbp), %rax\npopq %rbx\nret",
+     "pushq $5\nmovq -8(%rbp), %rax\npopq %rbx\nret"},
+    {"push-over", "pushq $5\nmovq -8(%rbp), %rax\npopq %rbx\nret", "movq -8(%rbp), %rax\nmovq $5, %rbx\nret"},
+    {"push-over", "pushq %rax\nmovq -8(%rbp), %rax\npopq %rbx\nret",
+     "pushq %rax\nmovq -8(%rbp), %rax\npopq %rbx\nret"},
+    {"push-over-2", "pushq -16(%rbp)\nleaq -8(%rbp), %rax\nmovq (%rax), %rax\npopq %rbx\nret",
+     "leaq -8(%rbp), %rax\nmovq (%rax), %rax\nmovq -16(%rbp), %rbx\nret"},
+    {"push-over-2", "pushq -16(%rbp)\nmovq $1, %rax\nmovq %rax, -16(%rbp)\npopq %rbx\nret",
+     "pushq -16(%rbp)\nmovq $1, %rax\nmovq %rax, -16(%rbp)\npopq %rbx\nret"},
+    {"push-over-3", "pushq $1\nmovq $2, %rax\ncall f\naddq $3, %rax\npopq %rbx\nret",
+     "pushq $1\nmovq $2, %rax\ncall f\naddq $3, %rax\npopq %rbx\nret"},
+    {"lea-load", "leaq -32(%rbp), %rax\nmovq (%rax), %rax\nret", "movq -32(%rbp), %rax\nret"},
+    {"lea-load", "leaq -32(%rbp), %rax\nmovq (%rax), %rcx\nmovq %rax, %rdx\nret",
+     "leaq -32(%rbp), %rax\nmovq (%rax), %rcx\nmovq %rax, %rdx\nret"},
+    {"lea-store", "leaq -8(%rbp), %rcx\nmovq %rax, (%rcx)\nret", "movq %rax, -8(%rbp)\nret"},
+    {"store-reload", "movq %rax, -8(%rbp)\nmovq -8(%rbp), %rax\nret", "movq %rax, -8(%rbp)\nret"},
+    {"op-through-copy", "movq %rdi, %rsi\nimulq $3, %rsi\nmovq %rsi, %rdi\nmovq %rdi, %rax\nret",
+     "imulq $3, %rdi\nmovq %rdi, %rax\nret"},
+    {"op-through-copy", "movq x(%rip), %r8\naddq $1, %r8\nmovq %r8, x(%rip)\nret", "addq $1, x(%rip)\nret"},
+    {"op-through-copy", "movq %rdi, %rsi\naddq %rsi, %rsi\nmovq %rsi, %rdi\nmovq %rdi, %rax\nret",
+     "movq %rdi, %rsi\naddq %rsi, %rsi\nmovq %rsi, %rdi\nmovq %rdi, %rax\nret"},
+    {"unary-through-copy", "movq %rdi, %rsi\nnegq %rsi\nmovq %rsi, %rdi\nmovq %rdi, %rax\nret",
+     "negq %rdi\nmovq %rdi, %rax\nret"},
+    {"cmp-through-copy", "movq %rax, %rsi\ncmpq $0, %rsi\nje .L1\n.L1:\nret", "cmpq $0, %rax\nje .L1\n.L1:\nret"},
+    {"cmp-through-copy", "movq %rax, %rsi\ncmpq $0, %rsi\nje .L1\nmovq %rsi, %rax\n.L1:\nret",
+     "movq %rax, %rsi\ncmpq $0, %rsi\nje .L1\nmovq %rsi, %rax\n.L1:\nret"},
+    {"test-through-copy", "movq %rdi, %rsi\ntestq %rsi, %rsi\nret", "testq %rdi, %rdi\nret"},
+    {"fold-operand", "movq $5, %rcx\naddq %rcx, %rax\nret", "addq $5, %rax\nret"},
+    {"fold-operand", "movq -8(%rbp), %rcx\ncmpq %rcx, %rax\nret", "cmpq -8(%rbp), %rax\nret"},
+    {"fold-operand", "movq $5, %rbx\naddq %rbx, %rax\nret", "movq $5, %rbx\naddq %rbx, %rax\nret"},
+    {"copy-chain", "movq %rsi, %r8\nmovq %r8, %rdi\nmovq %rdi, %rax\nret", "movq %rsi, %rax\nret"},
+    {"dead-move", "movq $1, %rax\nmovq $2, %rax\nret", "movq $2, %rax\nret"},
+    {"dead-move", "movq $1, %rax\nret", "movq $1, %rax\nret"},
+    {"dead-move", "movq $1, %rsi\njmp .L1\n.L2:\nmovq %rsi, %rax\nret\n.L1:\nmovq $0, %rsi\nmovq %rsi, %rax\nret",
+     "jmp .L1\n.L2:\nmovq %rsi, %rax\nret\n.L1:\nmovq $0, %rsi\nmovq %rsi, %rax\nret"},
+};
+
+static int find_rule(const char *name)
+{
+    for (int i = 0; i < NUM_RULES; i++)
+    {
+        if (strcmp(rules[i].name, name) == 0)
+            return i;
+    }
+    return -1;
+}
+
+// 按行拆开 \n 分隔的例子
+static int split_lines(const char *text, char ***lines)
+{
+    int count = 1;
+    for (const char *p = text; *p; p++)
+        count += *p == '\n';
+    *lines = (char **)xmalloc(count * sizeof(char *));
+    int n = 0;
+    const char *start = text;
+    for (const char *p = text;; p++)
+    {
+        if (*p != '\n' && *p != '\0')
+            continue;
+        size_t len = (size_t)(p - start);
+        (*lines)[n] = (char *)xmalloc(len + 1);
+        memcpy((*lines)[n], start, len);
+        (*lines)[n][len] = '\0';
+        n++;
+        if (*p == '\0')
+            break;
+        start = p + 1;
+    }
+    return n;
+}
+
+static void print_block(FILE *out, const char *title, const char *text)
+{
+    fprintf(out, "  %s:\n    ", title);
+    for (const char *p = text; *p; p++)
+    {
+        if (*p == '\n')
+            fputs("\n    ", out);
+        else
+            fputc(*p, out);
+    }
+    fputc('\n', out);
+}
+
+int peephole_self_test(FILE *out)
+{
+    int failures = 0;
+    int num_examples = (int)(sizeof(examples) / sizeof(examples[0]));
+    for (int i = 0; i < num_examples; i++)
+    {
+        const PeepholeExample *example = &examples[i];
+        int rule = find_rule(example->rule);
+        char **lines;
+        int count = split_lines(example->before, &lines);
+        Context ctx;
+        context_init(&ctx, lines, count);
+        ctx.only_rule = rule;
+        if (rule >= 0)
+            run_rules(&ctx);
+
+        // 把结果拼回一个字符串比较
+        size_t size = 1;
+        for (int j = 0; j < ctx.num_lines; j++)
+            size += strlen(ctx.lines[j].code) + 1;
+        char *result = (char *)xmalloc(size);
+        size_t len = 0;
+        for (int j = 0; j < ctx.num_lines; j++)
+        {
+            if (ctx.lines[j].kind == LINE_DELETED || ctx.lines[j].kind == LINE_BLANK)
+                continue;
+            len += (size_t)sprintf(result + len, "%s%s", len ? "\n" : "", ctx.lines[j].code);
+        }
+        result[len] = '\0';
+
+        int ok = rule >= 0 && strcmp(result, example->after) == 0;
+        fprintf(out, "%s %-20s %s\n", ok ? "ok  " : "FAIL", example->rule, rule >= 0 ? "" : "(no such rule)");
+        if (!ok)
+        {
+            print_block(out, "before", example->before);
+            print_block(out, "expected", example->after);
+            print_block(out, "got", result);
+            failures++;
+        }
+        free(result);
+        context_free(&ctx);
+        for (int j = 0; j < count; j++)
+            free(lines[j]);
+        free(lines);
+    }
+    fprintf(out, "%d/%d peephole examples passed\n", num_examples - failures, num_examples);
+    return failures;
+}
@@ -0,0 +1,302 @@
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+// simplify-cfg：在线性 IR 上清理降低阶段留下的多余控制流。
+// 降低阶段为每个 if/while/for/switch 生成固定形状的标签和跳转，
+// 其中很多是“跳到紧接着的标签”或“跳到一条跳转”，或者 return/break 之后的死代码。
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// 标签编号 → 指令下标（标签编号在整个编译单元内递增，用区间数组映射）
+typedef struct LabelMap
+{
+    long min_label;
+    int num_labels;
+    int *position; // -1 表示本函数中没有这个标签
+} LabelMap;
+
+static void label_map_build(LabelMap *map, IrFunction *func)
+{
+    long min_label = 0, max_label = -1;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        if (instr->op != IR_LABEL)
+            continue;
+        if (max_label < min_label || instr->a.value < min_label)
+            min_label = instr->a.value;
+        if (instr->a.value > max_label)
+            max_label = instr->a.value;
+    }
+    map->min_label = min_label;
+    map->num_labels = max_label >= min_label ? (int)(max_label - min_label + 1) : 0;
+    map->position = (int *)xcalloc(map->num_labels, sizeof(int));
+    for (int i = 0; i < map->num_labels; i++)
+        map->position[i] = -1;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (func->instrs[i].op == IR_LABEL)
+            map->position[func->instrs[i].a.value - min_label] = i;
+    }
+}
+
+static int label_position(const LabelMap *map, long label)
+{
+    long index = label - map->min_label;
+    if (index < 0 || index >= map->num_labels)
+        return -1;
+    return map->position[index];
+}
+
+// 跳转指令的目标个数：JMP/BR 一个，SWITCH 是默认目标加上跳转表
+static int num_jump_targets(IrInstr *instr)
+{
+    if (instr->op == IR_JMP || instr->op == IR_BR)
+        return 1;
+    if (instr->op == IR_SWITCH)
+        return instr->num_args + 1;
+    return 0;
+}
+
+// 跳转指令的第 k 个目标操作数
+static IrOperand *jump_target(IrInstr *instr, int k)
+{
+    if (instr->op == IR_JMP)
+        return &instr->a;
+    if (k == 0)
+        return &instr->dst;
+    return &instr->args[k - 1];
+}
+
+// 跳过连续的标签，返回第一条非标签指令的下标
+static int skip_labels(IrFunction *func, int i)
+{
+    while (i < func->num_instrs && func->instrs[i].op == IR_LABEL)
+        i++;
+    return i;
+}
+
+static int compare(IrOpcode cond, long a, long b)
+{
+    switch (cond)
+    {
+    case IR_EQ:
+        return a == b;
+    case IR_NE:
+        return a != b;
+    case IR_LT:
+        return a < b;
+    case IR_LE:
+        return a <= b;
+    case IR_GT:
+        return a > b;
+    default:
+        return a >= b;
+    }
+}
+
+// 两个操作数都是立即数的条件分支（例如 while (1)）：成立时改为 JMP，不成立时删除
+static int fold_branches(IrFunction *func, char *dead)
+{
+    int changed = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        if (instr->op != IR_BR || instr->a.kind != IR_OPERAND_IMM || instr->b.kind != IR_OPERAND_IMM)
+            continue;
+        if (compare(instr->cond, instr->a.value, instr->b.value))
+        {
+            instr->op = IR_JMP;
+            instr->a = instr->dst;
+            instr->b = ir_none();
+            instr->dst = ir_none();
+        }
+        else
+        {
+            dead[i] = 1;
+        }
+        changed = 1;
+    }
+    return changed;
+}
+
+static IrOpcode invert_condition(IrOpcode cond)
+{
+    switch (cond)
+    {
+    case IR_EQ:
+        return IR_NE;
+    case IR_NE:
+        return IR_EQ;
+    case IR_LT:
+        return IR_GE;
+    case IR_LE:
+        return IR_GT;
+    case IR_GT:
+        return IR_LE;
+    default:
+        return IR_LT;
+    }
+}
+
+// br c -> L1; jmp L2; L1:  改为  br !c -> L2; L1:
+static int invert_branches(IrFunction *func, char *dead)
+{
+    int changed = 0;
+    for (int i = 0; i + 2 < func->num_instrs; i++)
+    {
+        IrInstr *branch = &func->instrs[i];
+        IrInstr *jump = &func->instrs[i + 1];
+        if (branch->op != IR_BR || jump->op != IR_JMP || dead[i] || dead[i + 1])
+            continue;
+        for (int j = i + 2; j < func->num_instrs && func->instrs[j].op == IR_LABEL; j++)
+        {
+            if (func->instrs[j].a.value != branch->dst.value)
+                continue;
+            branch->cond = invert_condition(branch->cond);
+            branch->dst = jump->a;
+            dead[i + 1] = 1;
+            changed = 1;
+            break;
+        }
+    }
+    return changed;
+}
+
+// 跳到“只有一条 JMP 的标签”时直接跳到最终目标
+static int thread_jumps(IrFunction *func, const LabelMap *map)
+{
+    int changed = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        for (int k = 0; k < num_jump_targets(&func->instrs[i]); k++)
+        {
+            IrOperand *target = jump_target(&func->instrs[i], k);
+            // 限制跳数，避免 L: goto L 这样的环
+            for (int hops = 0; hops < 8; hops++)
+            {
+                int pos = label_position(map, target->value);
+                if (pos < 0)
+                    break;
+                int next = skip_labels(func, pos);
+                if (next >= func->num_instrs || func->instrs[next].op != IR_JMP ||
+                    func->instrs[next].a.value == target->value)
+                    break;
+                target->value = func->instrs[next].a.value;
+                changed = 1;
+            }
+        }
+    }
+    return changed;
+}
+
+int opt_simplify_cfg(IrFunction *func)
+{
+    int changed_any = 0;
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        char *dead = (char *)xcalloc(func->num_instrs, 1);
+        int num_dead = 0;
+        if (fold_branches(func, dead))
+        {
+            // 删除的分支留到下面一起压缩
+            for (int i = 0; i < func->num_instrs; i++)
+                num_dead += dead[i];
+            changed = 1;
+        }
+
+        LabelMap map;
+        label_map_build(&map, func);
+        changed |= thread_jumps(func, &map);
+        free(map.position);
+        if (invert_branches(func, dead))
+        {
+            num_dead++;
+            changed = 1;
+        }
+
+        // 1. RET/JMP/SWITCH 之后直到下一个标签的指令不可达
+        for (int i = 0; i < func->num_instrs; i++)
+        {
+            IrOpcode op = func->instrs[i].op;
+            if (op != IR_RET && op != IR_JMP && op != IR_SWITCH)
+                continue;
+            int j = i + 1;
+            while (j < func->num_instrs && func->instrs[j].op != IR_LABEL)
+            {
+                dead[j++] = 1;
+                num_dead++;
+            }
+            i = j - 1;
+        }
+
+        // 2. 跳到紧接着的标签（中间只隔着标签和死代码）的跳转是多余的
+        for (int i = 0; i < func->num_instrs; i++)
+        {
+            IrOpcode op = func->instrs[i].op;
+            if ((op != IR_JMP && op != IR_BR) || dead[i])
+                continue;
+            IrOperand *target = jump_target(&func->instrs[i], 0);
+            for (int j = i + 1; j < func->num_instrs; j++)
+            {
+                if (dead[j])
+                    continue;
+                if (func->instrs[j].op != IR_LABEL)
+                    break;
+                if (func->instrs[j].a.value == target->value)
+                {
+                    dead[i] = 1;
+                    num_dead++;
+                    break;
+                }
+            }
+        }
+
+        // 3. 没有跳转引用的标签
+        label_map_build(&map, func);
+        char *referenced = (char *)xcalloc(map.num_labels, 1);
+        for (int i = 0; i < func->num_instrs; i++)
+        {
+            if (dead[i])
+                continue;
+            for (int k = 0; k < num_jump_targets(&func->instrs[i]); k++)
+            {
+                IrOperand *target = jump_target(&func->instrs[i], k);
+                if (label_position(&map, target->value) >= 0)
+                    referenced[target->value - map.min_label] = 1;
+            }
+        }
+        for (int i = 0; i < func->num_instrs; i++)
+        {
+            IrInstr *instr = &func->instrs[i];
+            if (instr->op == IR_LABEL && !dead[i] && !referenced[instr->a.value - map.min_label])
+            {
+                dead[i] = 1;
+                num_dead++;
+            }
+        }
+        free(referenced);
+        free(map.position);
+
+        if (num_dead > 0)
+        {
+            ir_remove_instrs(func, dead);
+            changed = 1;
+        }
+        free(dead);
+        changed_any |= changed;
+    }
+    return changed_any;
+}
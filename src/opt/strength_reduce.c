@@ -0,0 +1,419 @@
+#include "loop.h"
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+// strength-reduce：归纳变量的强度削弱。
+// 基本归纳变量 i 在循环中只有一个定义 i = i + c（降低阶段写成 t = add i, c; i = mov t）。
+// 由它线性导出的值 t = i * s、t = i << k、p = x + t（x 在循环中不变）换成新的 vreg r：
+// 前置块中计算 r 的初值，i 每次递增之后紧接着 r = r + c * s，原来的计算改为 t = mov r。
+// 于是 a[i] 的地址变成每次迭代加上元素大小的指针，循环中不再有乘法。
+// 之后把同一块中 t 的使用直接换成 r，删掉不再使用的 t 和循环中没有用到的 r 的递增。
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// 一个导出的归纳变量：r = coef * iv + 循环中不变的值
+typedef struct Reduction
+{
+    int vreg;     // 新的 vreg r
+    int iv;       // 基本归纳变量
+    long coef;
+    int instr;    // 原来计算它的指令
+    IrInstr init; // 前置块中的初值计算
+    int needs_init;
+    int needs_bump;
+} Reduction;
+
+typedef struct Reducer
+{
+    IrFunction *func;
+    IrLoop *loop;
+    int num_vregs;   // 开始时的 vreg 个数（下面的数组按它分配）
+    int *block_of;   // 指令 → 块
+    int *defs;       // vreg → 函数中的定义次数
+    int *loop_defs;  // vreg → 循环中的定义次数
+    int *def_pos;    // vreg → 循环中最后一个定义的下标
+    long *step;      // 基本归纳变量每次迭代的增量
+    int *iv_def;     // 基本归纳变量 → 递增它的指令，不是基本归纳变量为 -1
+    int *reduced;    // vreg → reductions 的下标，-1 表示没有削弱
+    Reduction *reductions;
+    int num_reductions;
+} Reducer;
+
+static void reducer_init(Reducer *r, IrFunction *func, IrLoop *loop)
+{
+    memset(r, 0, sizeof(*r));
+    r->func = func;
+    r->loop = loop;
+    r->num_vregs = func->num_vregs;
+    r->block_of = (int *)xcalloc(func->num_instrs, sizeof(int));
+    r->defs = (int *)xcalloc(func->num_vregs, sizeof(int));
+    r->loop_defs = (int *)xcalloc(func->num_vregs, sizeof(int));
+    r->def_pos = (int *)xcalloc(func->num_vregs, sizeof(int));
+    r->step = (long *)xcalloc(func->num_vregs, sizeof(long));
+    r->iv_def = (int *)xcalloc(func->num_vregs, sizeof(int));
+    r->reduced = (int *)xcalloc(func->num_vregs, sizeof(int));
+    r->reductions = (Reduction *)xcalloc(func->num_instrs, sizeof(Reduction));
+    for (int v = 0; v < func->num_vregs; v++)
+    {
+        r->def_pos[v] = -1;
+        r->iv_def[v] = -1;
+        r->reduced[v] = -1;
+    }
+    for (int b = 0; b < func->num_blocks; b++)
+    {
+        for (int i = func->blocks[b].first; i <= func->blocks[b].last; i++)
+        {
+            r->block_of[i] = b;
+            int d = ir_instr_def(&func->instrs[i]);
+            if (d < 0)
+                continue;
+            r->defs[d]++;
+            if (loop->contains[b])
+            {
+                r->loop_defs[d]++;
+                r->def_pos[d] = i;
+            }
+        }
+    }
+}
+
+static void reducer_free(Reducer *r)
+{
+    free(r->block_of);
+    free(r->defs);
+    free(r->loop_defs);
+    free(r->def_pos);
+    free(r->step);
+    free(r->iv_def);
+    free(r->reduced);
+    free(r->reductions);
+}
+
+static int in_loop(Reducer *r, int i)
+{
+    return r->loop->contains[r->block_of[i]] != 0;
+}
+
+static int is_vreg(const IrOperand *operand, int vreg)
+{
+    return operand->kind == IR_OPERAND_VREG && operand->value == vreg;
+}
+
+// instr 是否为 iv + c / c + iv / iv - c（c 为常量）
+static int increment_of(const IrInstr *instr, int iv, long *step)
+{
+    if (instr->op == IR_ADD && is_vreg(&instr->a, iv) && instr->b.kind == IR_OPERAND_IMM)
+        *step = instr->b.value;
+    else if (instr->op == IR_ADD && is_vreg(&instr->b, iv) && instr->a.kind == IR_OPERAND_IMM)
+        *step = instr->a.value;
+    else if (instr->op == IR_SUB && is_vreg(&instr->a, iv) && instr->b.kind == IR_OPERAND_IMM)
+        *step = -instr->b.value;
+    else
+        return 0;
+    return 1;
+}
+
+// 基本归纳变量：循环中唯一的定义是 iv = iv + c，或者 t = iv + c; iv = mov t（同一块中）
+static void find_induction_variables(Reducer *r)
+{
+    IrFunction *func = r->func;
+    for (int v = 0; v < r->num_vregs; v++)
+    {
+        if (r->loop_defs[v] != 1)
+            continue;
+        int pos = r->def_pos[v];
+        IrInstr *instr = &func->instrs[pos];
+        long step;
+        if (increment_of(instr, v, &step))
+        {
+            r->iv_def[v] = pos;
+            r->step[v] = step;
+            continue;
+        }
+        if (!ir_is_int_copy(instr) || instr->a.kind != IR_OPERAND_VREG)
+            continue;
+        int t = (int)instr->a.value;
+        int t_pos = r->def_pos[t];
+        if (r->defs[t] != 1 || t_pos < 0 || t_pos > pos || r->block_of[t_pos] != r->block_of[pos])
+            continue;
+        if (increment_of(&func->instrs[t_pos], v, &step))
+        {
+            r->iv_def[v] = pos;
+            r->step[v] = step;
+        }
+    }
+}
+
+// 在循环中不变的操作数（常量、地址，或者循环中没有定义的 vreg）
+static int is_invariant(Reducer *r, const IrOperand *operand)
+{
+    if (operand->kind == IR_OPERAND_VREG)
+        return operand->value < r->num_vregs && r->loop_defs[operand->value] == 0;
+    return operand->kind != IR_OPERAND_NONE && operand->kind != IR_OPERAND_LABEL;
+}
+
+static int is_iv(Reducer *r, const IrOperand *operand)
+{
+    return operand->kind == IR_OPERAND_VREG && operand->value < r->num_vregs && r->iv_def[operand->value] >= 0;
+}
+
+static int reduced_index(Reducer *r, const IrOperand *operand)
+{
+    if (operand->kind != IR_OPERAND_VREG || operand->value >= r->num_vregs)
+        return -1;
+    return r->reduced[operand->value];
+}
+
+static Reduction *add_reduction(Reducer *r, int i, int iv, long coef, IrOpcode op, IrOperand a, IrOperand b)
+{
+    Reduction *red = &r->reductions[r->num_reductions];
+    r->reduced[r->func->instrs[i].dst.value] = r->num_reductions++;
+    red->vreg = ir_new_vreg(r->func);
+    red->iv = iv;
+    red->coef = coef;
+    red->instr = i;
+    memset(&red->init, 0, sizeof(red->init));
+    red->init.op = op;
+    red->init.size = 8;
+    red->init.dst = ir_vreg(red->vreg);
+    red->init.a = a;
+    red->init.b = b;
+    return red;
+}
+
+// 识别导出的归纳变量，返回是否找到新的
+static int find_reduction(Reducer *r, int i)
+{
+    IrInstr *instr = &r->func->instrs[i];
+    int dst = ir_instr_def(instr);
+    if (dst < 0 || dst >= r->num_vregs || r->defs[dst] != 1 || r->reduced[dst] >= 0)
+        return 0;
+
+    if (instr->op == IR_MUL || instr->op == IR_SHL)
+    {
+        // i * s、s * i、i << k
+        IrOperand *iv = &instr->a, *scale = &instr->b;
+        if (instr->op == IR_MUL && !is_iv(r, iv))
+        {
+            iv = &instr->b;
+            scale = &instr->a;
+        }
+        if (!is_iv(r, iv) || scale->kind != IR_OPERAND_IMM)
+            return 0;
+        long coef = scale->value;
+        if (instr->op == IR_SHL)
+        {
+            if (coef < 0 || coef > 30)
+                return 0;
+            coef = 1L << coef;
+        }
+        add_reduction(r, i, (int)iv->value, coef, instr->op, ir_vreg((int)iv->value), *scale);
+        return 1;
+    }
+    if (instr->op == IR_ADD)
+    {
+        // x + t、t + x（t 已经削弱，x 在循环中不变）
+        int k = reduced_index(r, &instr->a);
+        IrOperand *other = &instr->b;
+        if (k < 0)
+        {
+            k = reduced_index(r, &instr->b);
+            other = &instr->a;
+        }
+        if (k < 0 || !is_invariant(r, other))
+            return 0;
+        Reduction *base = &r->reductions[k];
+        int iv = base->iv;
+        long coef = base->coef;
+        add_reduction(r, i, iv, coef, IR_ADD, *other, ir_vreg(base->vreg));
+        return 1;
+    }
+    return 0;
+}
+
+// 原来的计算改为 t = mov r；同一块中随后对 t 的使用直接读 r（到 r 递增为止）
+static void rewrite_uses(Reducer *r, Reduction *red)
+{
+    IrFunction *func = r->func;
+    IrInstr *instr = &func->instrs[red->instr];
+    int t = (int)instr->dst.value;
+    instr->op = IR_MOV;
+    instr->a = ir_vreg(red->vreg);
+    instr->b = ir_none();
+
+    IrBlock *block = &func->blocks[r->block_of[red->instr]];
+    for (int j = red->instr + 1; j <= block->last; j++)
+    {
+        IrInstr *user = &func->instrs[j];
+        if (user->op == IR_CALL)
+        {
+            for (int k = 0; k < user->num_args; k++)
+            {
+                if (is_vreg(&user->args[k], t))
+                    user->args[k] = ir_vreg(red->vreg);
+            }
+        }
+        else if (user->op != IR_LABEL && user->op != IR_JMP && user->op != IR_PARAM)
+        {
+            if (is_vreg(&user->a, t))
+                user->a = ir_vreg(red->vreg);
+            if (is_vreg(&user->b, t))
+                user->b = ir_vreg(red->vreg);
+        }
+        if (j == r->iv_def[red->iv])
+            break; // r 在这条指令之后递增
+    }
+}
+
+// 统计每个 vreg 的使用次数（跳过 dead 的指令；in_loop_only 时只统计循环中的）
+static int *count_uses(Reducer *r, const char *dead, int in_loop_only)
+{
+    IrFunction *func = r->func;
+    int *counts = (int *)xcalloc(func->num_vregs, sizeof(int));
+    int capacity = 2;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (func->instrs[i].num_args > capacity)
+            capacity = func->instrs[i].num_args;
+    }
+    IrOperand **uses = (IrOperand **)xcalloc(capacity, sizeof(IrOperand *));
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if ((dead && dead[i]) || (in_loop_only && !in_loop(r, i)))
+            continue;
+        int num_uses = ir_instr_uses(&func->instrs[i], uses);
+        for (int u = 0; u < num_uses; u++)
+        {
+            if (uses[u]->kind == IR_OPERAND_VREG)
+                counts[uses[u]->value]++;
+        }
+    }
+    free(uses);
+    return counts;
+}
+
+static void append(IrInstr *instrs, int *count, const IrInstr *instr)
+{
+    instrs[(*count)++] = *instr;
+}
+
+// 按新的指令顺序重建数组：头块之前插入初值，每个基本归纳变量递增之后插入 r 的递增
+static void rebuild(Reducer *r, const char *dead)
+{
+    IrFunction *func = r->func;
+    int header_first = func->blocks[r->loop->header].first;
+    int capacity = func->num_instrs + 2 * r->num_reductions;
+    IrInstr *instrs = (IrInstr *)xcalloc(capacity, sizeof(IrInstr));
+    int count = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (i == header_first)
+        {
+            for (int k = 0; k < r->num_reductions; k++)
+            {
+                if (r->reductions[k].needs_init)
+                    append(instrs, &count, &r->reductions[k].init);
+            }
+        }
+        if (!dead[i])
+            append(instrs, &count, &func->instrs[i]);
+        for (int k = 0; k < r->num_reductions; k++)
+        {
+            Reduction *red = &r->reductions[k];
+            if (!red->needs_bump || r->iv_def[red->iv] != i)
+                continue;
+            IrInstr bump;
+            memset(&bump, 0, sizeof(bump));
+            bump.op = IR_ADD;
+            bump.size = 8;
+            bump.dst = ir_vreg(red->vreg);
+            bump.a = ir_vreg(red->vreg);
+            bump.b = ir_imm(red->coef * r->step[red->iv]);
+            append(instrs, &count, &bump);
+        }
+    }
+    free(func->instrs);
+    func->instrs = instrs;
+    func->num_instrs = count;
+    func->capacity = capacity;
+    ir_build_cfg(func);
+}
+
+static int reduce_loop(IrFunction *func, IrLoopInfo **info, IrLoop *loop, void *ctx)
+{
+    (void)ctx;
+    // 先找一遍，没有可以削弱的就不插入前置块
+    Reducer r;
+    reducer_init(&r, func, loop);
+    find_induction_variables(&r);
+    int found = 0;
+    for (int i = 0; i < func->num_instrs && !found; i++)
+        found = in_loop(&r, i) && find_reduction(&r, i);
+    func->num_vregs = r.num_vregs; // 试探时分配的 vreg 不保留
+    reducer_free(&r);
+    if (!found)
+        return 0;
+
+    loop = ir_prepare_loop(func, info, loop);
+    if (!loop)
+        return 0;
+    reducer_init(&r, func, loop);
+    find_induction_variables(&r);
+    // 按指令顺序识别，t = i * s 先于使用它的 p = x + t
+    int changed = 1;
+    while (changed)
+    {
+        changed = 0;
+        for (int i = 0; i < func->num_instrs; i++)
+            changed |= in_loop(&r, i) && find_reduction(&r, i);
+    }
+    for (int k = 0; k < r.num_reductions; k++)
+        rewrite_uses(&r, &r.reductions[k]);
+
+    // 不再使用的 t = mov r 删除；循环中没有用到的 r 不需要递增，
+    // 没有被使用、也不是其他初值的来源的 r 不需要初值
+    int *uses = count_uses(&r, NULL, 0);
+    char *dead = (char *)xcalloc(func->num_instrs, 1);
+    for (int k = 0; k < r.num_reductions; k++)
+    {
+        Reduction *red = &r.reductions[k];
+        if (uses[func->instrs[red->instr].dst.value] == 0)
+            dead[red->instr] = 1;
+    }
+    free(uses);
+    int *loop_uses = count_uses(&r, dead, 1);
+    for (int k = r.num_reductions - 1; k >= 0; k--)
+    {
+        Reduction *red = &r.reductions[k];
+        red->needs_bump = loop_uses[red->vreg] > 0;
+        red->needs_init = red->needs_init || red->needs_bump;
+        // 初值依赖的 r 也需要初值
+        int source = red->init.b.kind == IR_OPERAND_VREG ? (int)red->init.b.value : -1;
+        for (int j = 0; j < k && red->needs_init; j++)
+        {
+            if (r.reductions[j].vreg == source)
+                r.reductions[j].needs_init = 1;
+        }
+    }
+    free(loop_uses);
+
+    rebuild(&r, dead);
+    free(dead);
+    reducer_free(&r);
+    return 1;
+}
+
+int opt_strength_reduce(IrFunction *func)
+{
+    return ir_visit_loops(func, reduce_loop, NULL);
+}
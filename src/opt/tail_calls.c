@@ -0,0 +1,329 @@
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+// tail-calls：return f(...) 这样在尾位置的调用不再需要调用者的栈帧。
+// 调用自己的尾调用改成给参数重新赋值、跳回参数之后的入口标签，递归变成循环：
+//   r = call f(a0, a1); ret r        →   p0 = mov a0; p1 = mov a1; jmp .Lentry
+// 调用结果再加上或乘上一个值才返回的（return n * f(n - 1)、return f(n - 1) + f(n - 2)）
+// 引入累加器：函数的返回值写成 acc_add + acc_mul * 结果，入口之前 acc_add = 0、acc_mul = 1，
+//   r = call f(...); t = mul x, r; ret t   →   acc_mul = acc_mul * x; 参数赋值; jmp .Lentry
+//   r = call f(...); t = add x, r; ret t   →   acc_add = acc_add + acc_mul * x; 参数赋值; jmp .Lentry
+//   其余的 ret y                           →   ret acc_add + acc_mul * y
+// IR 的值是 64 位的，加法和乘法按 2^64 取模满足结合律和交换律，改写后的结果与原来逐位相同。
+// 其他的尾调用标记为 is_tail，由 ir_x86 恢复寄存器、拆掉栈帧之后 jmp 到被调函数。
+// 栈上对象的地址被取出过（不只是直接加载/存储）的函数不做任何改写：
+// 指针可能传给被调函数，而调用者的栈帧在跳转之后不再存在（或者被下一轮循环覆盖）。
+
+#define MAX_REGISTER_ARGS 6 // 尾调用的参数都在寄存器中，不需要调用者的栈空间
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+typedef struct Emitter
+{
+    IrInstr *instrs;
+    int count;
+    int capacity;
+} Emitter;
+
+static void emit_instr(Emitter *e, const IrInstr *instr)
+{
+    if (e->count == e->capacity)
+    {
+        e->capacity = e->capacity ? e->capacity * 2 : 64;
+        e->instrs = (IrInstr *)realloc(e->instrs, e->capacity * sizeof(IrInstr));
+        if (!e->instrs)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    e->instrs[e->count++] = *instr;
+}
+
+static void emit_op(Emitter *e, IrOpcode op, IrOperand dst, IrOperand a, IrOperand b)
+{
+    IrInstr instr;
+    memset(&instr, 0, sizeof(instr));
+    instr.op = op;
+    instr.size = 8;
+    instr.dst = dst;
+    instr.a = a;
+    instr.b = b;
+    emit_instr(e, &instr);
+}
+
+// 尾调用自己的位置
+typedef struct RecursiveCall
+{
+    int call;     // 调用指令
+    int ret;      // 之后的 ret
+    IrOpcode acc; // 结果在返回之前做的运算（IR_ADD / IR_MUL），直接返回时为 IR_RET
+    IrOperand x;  // 参与运算的另一个值
+} RecursiveCall;
+
+static int same_vreg(const IrOperand *a, const IrOperand *b)
+{
+    return a->kind == IR_OPERAND_VREG && b->kind == IR_OPERAND_VREG && a->value == b->value;
+}
+
+// 栈上对象的地址是否以值的形式出现过
+static int takes_local_address(IrFunction *func)
+{
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        int direct = instr->op == IR_LOAD || instr->op == IR_STORE;
+        if ((instr->a.kind == IR_OPERAND_LOCAL && !direct) || instr->b.kind == IR_OPERAND_LOCAL)
+            return 1;
+        for (int k = 0; instr->op == IR_CALL && k < instr->num_args; k++)
+        {
+            if (instr->args[k].kind == IR_OPERAND_LOCAL)
+                return 1;
+        }
+    }
+    return 0;
+}
+
+// 调用之后紧跟着返回它的结果（或者都没有值）
+static int returns_result(const IrInstr *call, const IrInstr *ret)
+{
+    if (ret->op != IR_RET)
+        return 0;
+    return ret->a.kind == IR_OPERAND_NONE || same_vreg(&ret->a, &call->dst);
+}
+
+static int count_uses(IrFunction *func, int vreg)
+{
+    IrOperand *uses[MAX_REGISTER_ARGS];
+    int count = 0;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        IrOperand **list = uses;
+        if (instr->op == IR_CALL && instr->num_args > MAX_REGISTER_ARGS)
+            list = (IrOperand **)xcalloc(instr->num_args, sizeof(IrOperand *));
+        int n = ir_instr_uses(instr, list);
+        for (int k = 0; k < n; k++)
+            count += list[k]->kind == IR_OPERAND_VREG && list[k]->value == vreg;
+        if (list != uses)
+            free(list);
+    }
+    return count;
+}
+
+// pos 处是否是可以变成跳转的自递归：实参个数与形参一致，结果直接返回或者经过一次加法/乘法返回
+static int match_recursion(IrFunction *func, int pos, int num_params, RecursiveCall *site)
+{
+    IrInstr *call = &func->instrs[pos];
+    if (call->op != IR_CALL || call->a.kind != IR_OPERAND_GLOBAL || !call->a.name ||
+        strcmp(call->a.name, func->name) != 0 || call->is_variadic || call->num_args != num_params ||
+        pos + 1 >= func->num_instrs)
+        return 0;
+    site->call = pos;
+    IrInstr *next = &func->instrs[pos + 1];
+    if (returns_result(call, next))
+    {
+        site->ret = pos + 1;
+        site->acc = IR_RET;
+        return 1;
+    }
+    // r = call f(...); t = op x, r; ret t（r 和 t 都只在这里使用）
+    if ((next->op != IR_ADD && next->op != IR_MUL) || call->dst.kind != IR_OPERAND_VREG ||
+        pos + 2 >= func->num_instrs)
+        return 0;
+    IrInstr *ret = &func->instrs[pos + 2];
+    if (ret->op != IR_RET || !same_vreg(&ret->a, &next->dst) || same_vreg(&next->a, &next->b))
+        return 0;
+    if (same_vreg(&next->a, &call->dst))
+        site->x = next->b;
+    else if (same_vreg(&next->b, &call->dst))
+        site->x = next->a;
+    else
+        return 0;
+    if (count_uses(func, (int)call->dst.value) != 1 || count_uses(func, (int)next->dst.value) != 1)
+        return 0;
+    site->ret = pos + 2;
+    site->acc = next->op;
+    return 1;
+}
+
+// 在函数开头（参数之后）设置入口标签，把自递归改成循环
+static int eliminate_recursion(IrFunction *func)
+{
+    int num_params = 0;
+    while (num_params < func->num_instrs && func->instrs[num_params].op == IR_PARAM)
+    {
+        IrInstr *param = &func->instrs[num_params];
+        if (param->a.value != num_params || param->dst.kind != IR_OPERAND_VREG)
+            return 0;
+        num_params++;
+    }
+
+    RecursiveCall *sites = (RecursiveCall *)xcalloc(func->num_instrs, sizeof(RecursiveCall));
+    int *site_at = (int *)xcalloc(func->num_instrs, sizeof(int)); // 调用指令 → 编号 + 1
+    int num_sites = 0;
+    int uses_add = 0, uses_mul = 0;
+    for (int i = num_params; i < func->num_instrs; i++)
+    {
+        if (!match_recursion(func, i, num_params, &sites[num_sites]))
+            continue;
+        uses_add |= sites[num_sites].acc == IR_ADD;
+        uses_mul |= sites[num_sites].acc == IR_MUL;
+        site_at[i] = ++num_sites;
+        i = sites[num_sites - 1].ret;
+    }
+    if (num_sites == 0)
+    {
+        free(sites);
+        free(site_at);
+        return 0;
+    }
+
+    Emitter e;
+    memset(&e, 0, sizeof(e));
+    for (int i = 0; i < num_params; i++)
+        emit_instr(&e, &func->instrs[i]);
+    IrOperand acc_add = uses_add ? ir_vreg(ir_new_vreg(func)) : ir_none();
+    IrOperand acc_mul = uses_mul ? ir_vreg(ir_new_vreg(func)) : ir_none();
+    if (uses_add)
+        emit_op(&e, IR_MOV, acc_add, ir_imm(0), ir_none());
+    if (uses_mul)
+        emit_op(&e, IR_MOV, acc_mul, ir_imm(1), ir_none());
+    int entry = ir_new_label(func);
+    emit_op(&e, IR_LABEL, ir_none(), ir_label(entry), ir_none());
+
+    for (int i = num_params; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        if (site_at[i])
+        {
+            RecursiveCall *site = &sites[site_at[i] - 1];
+            // 累加器用的是这一层的值，先于参数赋值更新
+            if (site->acc == IR_MUL)
+            {
+                emit_op(&e, IR_MUL, acc_mul, acc_mul, site->x);
+            }
+            else if (site->acc == IR_ADD)
+            {
+                IrOperand term = site->x;
+                if (uses_mul)
+                {
+                    term = ir_vreg(ir_new_vreg(func));
+                    emit_op(&e, IR_MUL, term, acc_mul, site->x);
+                }
+                emit_op(&e, IR_ADD, acc_add, acc_add, term);
+            }
+            // 参数同时赋值：实参是另一个参数的旧值时先复制出来
+            IrOperand *args = instr->args;
+            for (int k = 0; k < num_params; k++)
+            {
+                for (int j = 0; j < num_params; j++)
+                {
+                    if (j != k && same_vreg(&args[k], &func->instrs[j].dst))
+                    {
+                        IrOperand copy = ir_vreg(ir_new_vreg(func));
+                        emit_op(&e, IR_MOV, copy, args[k], ir_none());
+                        args[k] = copy;
+                        break;
+                    }
+                }
+            }
+            for (int k = 0; k < num_params; k++)
+            {
+                IrInstr *param = &func->instrs[k];
+                if (same_vreg(&args[k], &param->dst))
+                    continue;
+                if (param->size >= 8)
+                {
+                    emit_op(&e, IR_MOV, param->dst, args[k], ir_none());
+                    continue;
+                }
+                // 和函数入口一样按参数类型扩展
+                IrInstr ext;
+                memset(&ext, 0, sizeof(ext));
+                ext.op = IR_EXT;
+                ext.size = param->size;
+                ext.is_unsigned = param->is_unsigned;
+                ext.dst = param->dst;
+                ext.a = args[k];
+                emit_instr(&e, &ext);
+            }
+            emit_op(&e, IR_JMP, ir_none(), ir_label(entry), ir_none());
+            free(instr->args);
+            i = site->ret;
+            continue;
+        }
+        if (instr->op == IR_RET && instr->a.kind != IR_OPERAND_NONE && (uses_add || uses_mul))
+        {
+            // 返回 acc_add + acc_mul * y（递归的出口通常返回常量 1 或 0，不需要乘法或加法）
+            IrOperand value = instr->a;
+            if (uses_mul && value.kind == IR_OPERAND_IMM && value.value == 1)
+            {
+                value = acc_mul;
+            }
+            else if (uses_mul)
+            {
+                IrOperand product = ir_vreg(ir_new_vreg(func));
+                emit_op(&e, IR_MUL, product, acc_mul, value);
+                value = product;
+            }
+            if (uses_add && value.kind == IR_OPERAND_IMM && value.value == 0)
+            {
+                value = acc_add;
+            }
+            else if (uses_add)
+            {
+                IrOperand sum = ir_vreg(ir_new_vreg(func));
+                emit_op(&e, IR_ADD, sum, acc_add, value);
+                value = sum;
+            }
+            emit_op(&e, IR_RET, ir_none(), value, ir_none());
+            continue;
+        }
+        emit_instr(&e, instr);
+    }
+    free(func->instrs);
+    func->instrs = e.instrs;
+    func->num_instrs = e.count;
+    func->capacity = e.capacity;
+    free(sites);
+    free(site_at);
+    return 1;
+}
+
+// 其余的尾调用：参数都在寄存器中，调用之后直接返回它的结果
+static int mark_tail_calls(IrFunction *func)
+{
+    int changed = 0;
+    for (int i = 0; i + 1 < func->num_instrs; i++)
+    {
+        IrInstr *call = &func->instrs[i];
+        if (call->op != IR_CALL || call->is_tail || call->num_args > MAX_REGISTER_ARGS ||
+            !returns_result(call, &func->instrs[i + 1]))
+            continue;
+        call->is_tail = 1;
+        changed = 1;
+    }
+    return changed;
+}
+
+int opt_tail_calls(IrFunction *func)
+{
+    if (takes_local_address(func))
+        return 0;
+    int changed = eliminate_recursion(func);
+    changed |= mark_tail_calls(func);
+    if (changed)
+        ir_build_cfg(func);
+    return changed;
+}
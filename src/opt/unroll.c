@@ -0,0 +1,213 @@
+#include "loop.h"
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+// unroll-loops：展开计数循环。只处理 for/while 降低后的规范形状：
+//   .Lh: br <cond> i, n -> .Lexit   头块只有这一条比较，也是循环唯一的出口
+//        循环体                      紧跟在头块之后的连续块，最后一块 jmp .Lh
+// 其中 i 是步长为 ±1 的基本归纳变量，n 是常量或循环中不变的 vreg。
+// 次数是常量、展开后不大的循环完全展开（去掉比较，循环体复制 次数 份）；
+// 其余的按 factor 展开，剩下不足 factor 次的迭代交给原来的循环：
+//   .Lu: br <cond> i + (factor - 1) * c, n -> .Lh
+//        循环体 × factor
+//        jmp .Lu
+//   .Lh: 原来的循环
+// 复制的循环体使用新的标签，vreg 不改名（IR 不是 SSA 形式，各份依次执行）。
+
+#define UNROLL_MAX_BODY 40       // 循环体（不含标签）超过这个指令数不展开
+#define FULL_UNROLL_MAX_TRIPS 16 // 完全展开的最多迭代次数
+#define FULL_UNROLL_MAX_SIZE 96  // 完全展开后的最多指令数
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+typedef struct Emitter
+{
+    IrInstr *instrs;
+    int count;
+    int capacity;
+} Emitter;
+
+static void emit_instr(Emitter *e, const IrInstr *instr)
+{
+    if (e->count == e->capacity)
+    {
+        e->capacity = e->capacity ? e->capacity * 2 : 64;
+        e->instrs = (IrInstr *)realloc(e->instrs, e->capacity * sizeof(IrInstr));
+        if (!e->instrs)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    e->instrs[e->count++] = *instr;
+}
+
+// 标签或跳转
+static void emit_control(Emitter *e, IrOpcode op, long label)
+{
+    IrInstr instr;
+    memset(&instr, 0, sizeof(instr));
+    instr.op = op;
+    instr.size = 8;
+    instr.a = ir_label((int)label);
+    emit_instr(e, &instr);
+}
+
+// 新标签 → 查找表中的下标，不是循环体中的标签返回 -1
+static int find_label(const long *labels, int count, long label)
+{
+    for (int k = 0; k < count; k++)
+    {
+        if (labels[k] == label)
+            return k;
+    }
+    return -1;
+}
+
+static void rename_label(IrOperand *operand, const long *labels, const int *renamed, int count)
+{
+    int k = find_label(labels, count, operand->value);
+    if (k >= 0)
+        operand->value = renamed[k];
+}
+
+// 复制一份循环体（不含回边的 jmp），循环体中的标签换成新标签
+static void emit_body_copy(IrFunction *func, const IrCountedLoop *cl, Emitter *e, const long *labels, int num_labels)
+{
+    int *renamed = (int *)xcalloc(num_labels, sizeof(int));
+    for (int k = 0; k < num_labels; k++)
+        renamed[k] = ir_new_label(func);
+    for (int i = cl->body_first; i < cl->body_last; i++)
+    {
+        IrInstr copy = func->instrs[i];
+        if (copy.num_args > 0)
+        {
+            copy.args = (IrOperand *)xcalloc(copy.num_args, sizeof(IrOperand));
+            memcpy(copy.args, func->instrs[i].args, copy.num_args * sizeof(IrOperand));
+        }
+        if (copy.op == IR_LABEL || copy.op == IR_JMP)
+            rename_label(&copy.a, labels, renamed, num_labels);
+        if (copy.op == IR_BR || copy.op == IR_SWITCH)
+            rename_label(&copy.dst, labels, renamed, num_labels);
+        for (int k = 0; copy.op == IR_SWITCH && k < copy.num_args; k++)
+            rename_label(&copy.args[k], labels, renamed, num_labels);
+        emit_instr(e, &copy);
+    }
+    free(renamed);
+}
+
+// 用 e 中的指令替换 [first, last]（last < first 时只在 first 处插入）
+static void splice(IrFunction *func, int first, int last, Emitter *e)
+{
+    int removed = last - first + 1;
+    for (int i = first; i <= last; i++)
+        free(func->instrs[i].args);
+    int count = func->num_instrs - removed + e->count;
+    IrInstr *instrs = (IrInstr *)xcalloc(count, sizeof(IrInstr));
+    memcpy(instrs, func->instrs, first * sizeof(IrInstr));
+    if (e->count > 0)
+        memcpy(instrs + first, e->instrs, e->count * sizeof(IrInstr));
+    memcpy(instrs + first + e->count, func->instrs + last + 1, (func->num_instrs - last - 1) * sizeof(IrInstr));
+    free(func->instrs);
+    func->instrs = instrs;
+    func->num_instrs = count;
+    func->capacity = count;
+    ir_build_cfg(func);
+}
+
+static int unroll_loop(IrFunction *func, IrLoopInfo **info, IrLoop *loop, void *ctx)
+{
+    int factor = *(int *)ctx;
+    IrCountedLoop cl;
+    if (!ir_match_counted_loop(func, *info, loop, &cl) || cl.body_size > UNROLL_MAX_BODY)
+        return 0;
+    // 完全展开和余数循环都需要进入循环之前恰好执行一次的位置
+    loop = ir_prepare_loop(func, info, loop);
+    if (!loop || !ir_match_counted_loop(func, *info, loop, &cl))
+        return 0;
+
+    long initial;
+    long trips = -1;
+    if (cl.bound.kind == IR_OPERAND_IMM && ir_loop_initial_value(func, &cl, &initial))
+        trips = ir_loop_trip_count(&cl, initial, FULL_UNROLL_MAX_TRIPS);
+    int full = trips >= 0 && trips * cl.body_size <= FULL_UNROLL_MAX_SIZE;
+    if (!full && trips >= 0 && trips < factor)
+        return 0;
+
+    // 循环体中的标签（每份复制换成新的）
+    long *labels = (long *)xcalloc(cl.body_last - cl.body_first + 1, sizeof(long));
+    int num_labels = 0;
+    for (int i = cl.body_first; i < cl.body_last; i++)
+    {
+        if (func->instrs[i].op == IR_LABEL)
+            labels[num_labels++] = func->instrs[i].a.value;
+    }
+
+    Emitter e;
+    memset(&e, 0, sizeof(e));
+    int header_first = func->blocks[cl.header].first;
+    if (full)
+    {
+        for (long k = 0; k < trips; k++)
+            emit_body_copy(func, &cl, &e, labels, num_labels);
+        int next = cl.body_last + 1;
+        if (next >= func->num_instrs || func->instrs[next].op != IR_LABEL || func->instrs[next].a.value != cl.exit_label)
+            emit_control(&e, IR_JMP, cl.exit_label);
+        splice(func, header_first, cl.body_last, &e);
+    }
+    else
+    {
+        // .Lu: br <cond> i + (factor - 1) * c, n -> .Lh
+        long unrolled_label = ir_new_label(func);
+        long ahead = (factor - 1) * cl.step;
+        emit_control(&e, IR_LABEL, unrolled_label);
+        IrInstr test;
+        memset(&test, 0, sizeof(test));
+        test.op = IR_BR;
+        test.cond = cl.cond;
+        test.size = 8;
+        test.dst = ir_label((int)loop->label);
+        long folded = cl.bound.kind == IR_OPERAND_IMM ? cl.bound.value - ahead : 0;
+        if (cl.bound.kind == IR_OPERAND_IMM && folded >= -2147483647L && folded <= 2147483647L)
+        {
+            test.a = ir_vreg(cl.iv);
+            test.b = ir_imm(folded);
+        }
+        else
+        {
+            IrInstr add;
+            memset(&add, 0, sizeof(add));
+            add.op = IR_ADD;
+            add.size = 8;
+            add.dst = ir_vreg(ir_new_vreg(func));
+            add.a = ir_vreg(cl.iv);
+            add.b = ir_imm(ahead);
+            emit_instr(&e, &add);
+            test.a = add.dst;
+            test.b = cl.bound;
+        }
+        emit_instr(&e, &test);
+        for (int k = 0; k < factor; k++)
+            emit_body_copy(func, &cl, &e, labels, num_labels);
+        emit_control(&e, IR_JMP, unrolled_label);
+        splice(func, header_first, header_first - 1, &e);
+    }
+    free(e.instrs);
+    free(labels);
+    return 1;
+}
+
+int opt_unroll_loops(IrFunction *func, int factor)
+{
+    return ir_visit_loops(func, unroll_loop, &factor);
+}
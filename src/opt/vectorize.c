@@ -0,0 +1,1194 @@
+#include "loop.h"
+#include "opt.h"
+#include <stdlib.h>
+#include <string.h>
+
+// vectorize：把最内层计数循环（ir_match_counted_loop 的形状，i 每次加 1）中逐元素的数组运算
+// 换成一次处理 width 字节的向量指令。循环体中只能有：
+//   x = i * E（或 i << log2(E)），p = base + x          a[i] 的地址，base 在循环中不变，E 为 4 或 8
+//   v = load [p]，store [p], v                         所有访问的元素大小和符号都相同
+//   v = a op b（add/sub/mul/and/or/xor）                操作数是向量值或循环中不变的值
+//   s = s op v（求和、按位与/或/异或）                   归约：s 在循环中不被其他指令读取
+//   if (v < m) m = v、m = v > m ? v : m                  最小/最大值，v 是加载的值
+// 生成的代码：
+//   前置块：重叠检查（可能重叠时直接执行原来的循环），不变值复制到各个元素，累加器置初值
+//   .Lv: br <cond> i + (VF - 1), n -> .Ld   剩下的不足 VF 次时退出
+//        向量循环体；i = i + VF
+//        jmp .Lv
+//   .Ld: 累加器合并成标量，再与原来的累加变量合并
+//   .Lh: 原来的循环处理剩下的迭代
+// 向量寄存器在这里直接分配（%xmm0-%xmm12，-mavx2 时为 %ymm），不够用时不向量化。
+// 向量中 4 字节元素的运算只保留低 32 位，与标量代码存回内存的结果相同；
+// 4 字节元素求和时扩展成 8 字节累加，与标量代码的 64 位累加一致。
+// 只处理整数元素：int/unsigned（4 字节）和 long/指针（8 字节）。char/short 数组的循环保持标量；
+// float/double 数组的循环也不向量化，用到浮点的函数不降低为 IR（见 ir_lower.c），到不了这里。
+
+#define VECTOR_MAX_BODY 60   // 循环体（不含标签）超过这个指令数不向量化
+#define VECTOR_REGS 13       // 可以分配的向量寄存器个数
+#define MAX_REDUCTIONS 4
+#define MAX_ALIAS_CHECKS 6   // 运行时重叠检查的最多对数
+#define MAX_BASES 8          // 不同基址的最多个数
+
+static void *xcalloc(size_t count, size_t size)
+{
+    void *p = calloc(count ? count : 1, size);
+    if (!p)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return p;
+}
+
+// 循环体中定义的 vreg 的分类
+typedef enum
+{
+    VALUE_NONE,    // 不能在向量循环中使用
+    VALUE_SYMBOL,  // 循环体中的 mov &sym（地址常量，使用处直接换成地址）
+    VALUE_INDEX,   // i * E
+    VALUE_ADDRESS, // base + i * E
+    VALUE_VECTOR   // 每个元素不同的值（加载、运算的结果）
+} ValueClass;
+
+// 循环体中每条指令在向量循环中的处理
+typedef enum
+{
+    ACTION_SKIP,    // 不需要（i 的递增、标签、归约的控制流）
+    ACTION_INDEX,   // x' = i * E（新的 vreg）
+    ACTION_ADDRESS, // p' = base + x'
+    ACTION_LOAD,
+    ACTION_STORE,
+    ACTION_OP,
+    ACTION_REDUCE   // 合并到累加器
+} Action;
+
+typedef struct Reduction
+{
+    int var;      // 累加变量 s
+    IrOpcode op;  // IR_VADD / IR_VSUB / IR_VAND / IR_VOR / IR_VXOR / IR_VMIN / IR_VMAX
+    int acc[2];   // 向量累加器（4 字节元素求和时扩展成两个 8 字节的累加器）
+    int num_acc;
+    int ext_size; // s 是不足 8 字节的整数变量时每次写入都截断（s = ext r），合并之后再截断一次
+    int ext_unsigned;
+} Reduction;
+
+typedef struct Vectorizer
+{
+    IrFunction *func;
+    IrCountedLoop cl;
+    int width;
+    int lanes;         // width / elem
+    int elem;          // 元素大小，0 表示还没有遇到访问
+    int is_unsigned;   // 加载的值零扩展
+    int has_load;
+    int num_vregs;     // 开始时的 vreg 个数（下面的数组按它分配）
+    int *defs;         // vreg → 函数中的定义次数
+    int *uses;         // vreg → 函数中的使用次数
+    int *loop_defs;    // vreg → 循环中的定义次数
+    int *loop_uses;    // vreg → 循环中的使用次数
+    ValueClass *cls;
+    IrOperand *base;   // VALUE_ADDRESS 的基址，VALUE_SYMBOL 的地址
+    int *scale;        // VALUE_INDEX / VALUE_ADDRESS 的 E
+    int *rep;          // VALUE_VECTOR → 代表（v = mov w 时与 w 相同）
+    int *loaded_from;  // VALUE_VECTOR → 加载它的地址的 vreg，不是直接加载的为 -1
+    int *renamed;      // VALUE_INDEX / VALUE_ADDRESS → 向量循环中的新 vreg
+    int *vec;          // 代表 → 向量寄存器
+    int *last_use;     // 代表 → 最后一次使用的指令
+    Action *action;    // 循环体中的指令 → 处理方式（下标相对 body_first）
+    int *reduction_of; // ACTION_REDUCE → 归约的编号
+    int *reduce_value; // ACTION_REDUCE → 合并进去的向量值
+    Reduction reductions[MAX_REDUCTIONS];
+    int num_reductions;
+    IrOperand splats[VECTOR_REGS]; // 复制到各个元素的不变值
+    int splat_regs[VECTOR_REGS];
+    int num_splats;
+    IrOperand bases[MAX_BASES];    // 访问的不同基址
+    int base_stored[MAX_BASES];
+    int num_bases;
+    int widen_temp;    // 4 字节元素求和时扩展用的寄存器，-1 表示不需要
+    int needs_first_iv; // 有只在向量循环执行过时才合并的归约
+} Vectorizer;
+
+static int is_vreg(const IrOperand *operand, int vreg)
+{
+    return operand->kind == IR_OPERAND_VREG && operand->value == vreg;
+}
+
+static int same_operand(const IrOperand *a, const IrOperand *b)
+{
+    if (a->kind != b->kind || a->value != b->value || a->offset != b->offset)
+        return 0;
+    return (a->kind != IR_OPERAND_GLOBAL && a->kind != IR_OPERAND_GOT) || strcmp(a->name, b->name) == 0;
+}
+
+static int is_address_kind(const IrOperand *operand)
+{
+    return operand->kind == IR_OPERAND_LOCAL || operand->kind == IR_OPERAND_GLOBAL ||
+           operand->kind == IR_OPERAND_STRING;
+}
+
+static int in_loop(Vectorizer *v, int pos)
+{
+    return pos >= v->cl.body_first - 1 && pos <= v->cl.body_last;
+}
+
+static void vectorizer_init(Vectorizer *v, IrFunction *func, const IrCountedLoop *cl, int width)
+{
+    memset(v, 0, sizeof(*v));
+    v->func = func;
+    v->cl = *cl;
+    v->width = width;
+    v->widen_temp = -1;
+    int n = func->num_vregs;
+    v->num_vregs = n;
+    v->defs = (int *)xcalloc(n, sizeof(int));
+    v->uses = (int *)xcalloc(n, sizeof(int));
+    v->loop_defs = (int *)xcalloc(n, sizeof(int));
+    v->loop_uses = (int *)xcalloc(n, sizeof(int));
+    v->cls = (ValueClass *)xcalloc(n, sizeof(ValueClass));
+    v->base = (IrOperand *)xcalloc(n, sizeof(IrOperand));
+    v->scale = (int *)xcalloc(n, sizeof(int));
+    v->rep = (int *)xcalloc(n, sizeof(int));
+    v->loaded_from = (int *)xcalloc(n, sizeof(int));
+    v->renamed = (int *)xcalloc(n, sizeof(int));
+    v->vec = (int *)xcalloc(n, sizeof(int));
+    v->last_use = (int *)xcalloc(n, sizeof(int));
+    int body = cl->body_last - cl->body_first + 1;
+    v->action = (Action *)xcalloc(body, sizeof(Action));
+    v->reduction_of = (int *)xcalloc(body, sizeof(int));
+    v->reduce_value = (int *)xcalloc(body, sizeof(int));
+
+    int capacity = 2;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        if (func->instrs[i].num_args > capacity)
+            capacity = func->instrs[i].num_args;
+    }
+    IrOperand **uses = (IrOperand **)xcalloc(capacity, sizeof(IrOperand *));
+    // 头块的比较也算在循环中
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        int d = ir_instr_def(instr);
+        if (d >= 0)
+        {
+            v->defs[d]++;
+            v->loop_defs[d] += in_loop(v, i);
+        }
+        int num_uses = ir_instr_uses(instr, uses);
+        for (int u = 0; u < num_uses; u++)
+        {
+            if (uses[u]->kind != IR_OPERAND_VREG)
+                continue;
+            v->uses[uses[u]->value]++;
+            v->loop_uses[uses[u]->value] += in_loop(v, i);
+        }
+    }
+    free(uses);
+    for (int r = 0; r < n; r++)
+    {
+        v->loaded_from[r] = -1;
+        v->vec[r] = -1;
+        v->last_use[r] = -1;
+    }
+}
+
+static void vectorizer_free(Vectorizer *v)
+{
+    free(v->defs);
+    free(v->uses);
+    free(v->loop_defs);
+    free(v->loop_uses);
+    free(v->cls);
+    free(v->base);
+    free(v->scale);
+    free(v->rep);
+    free(v->loaded_from);
+    free(v->renamed);
+    free(v->vec);
+    free(v->last_use);
+    free(v->action);
+    free(v->reduction_of);
+    free(v->reduce_value);
+}
+
+// ========== 分析 ==========
+
+static int is_invariant(Vectorizer *v, const IrOperand *operand)
+{
+    if (operand->kind == IR_OPERAND_VREG)
+        return v->loop_defs[operand->value] == 0 && operand->offset == 0;
+    return operand->kind == IR_OPERAND_IMM;
+}
+
+static int is_vector(Vectorizer *v, const IrOperand *operand)
+{
+    return operand->kind == IR_OPERAND_VREG && v->cls[operand->value] == VALUE_VECTOR;
+}
+
+// 只在循环中使用、只定义一次的临时值
+static int is_loop_temp(Vectorizer *v, int vreg)
+{
+    return v->defs[vreg] == 1 && v->uses[vreg] == v->loop_uses[vreg];
+}
+
+// 向量运算的操作数：向量值，或者复制到各个元素的不变值
+static int use_vector_operand(Vectorizer *v, const IrOperand *operand)
+{
+    if (is_vector(v, operand))
+        return 1;
+    if (!is_invariant(v, operand))
+        return 0;
+    for (int k = 0; k < v->num_splats; k++)
+    {
+        if (same_operand(&v->splats[k], operand))
+            return 1;
+    }
+    if (v->num_splats == VECTOR_REGS)
+        return 0;
+    v->splats[v->num_splats++] = *operand;
+    return 1;
+}
+
+// x = i * E / E * i / i << log2(E)，返回 E（不是时返回 0）
+static int index_scale(Vectorizer *v, const IrInstr *instr)
+{
+    int iv = v->cl.iv;
+    long scale = 0;
+    if (instr->op == IR_MUL && is_vreg(&instr->a, iv) && instr->b.kind == IR_OPERAND_IMM)
+        scale = instr->b.value;
+    else if (instr->op == IR_MUL && is_vreg(&instr->b, iv) && instr->a.kind == IR_OPERAND_IMM)
+        scale = instr->a.value;
+    else if (instr->op == IR_SHL && is_vreg(&instr->a, iv) && instr->b.kind == IR_OPERAND_IMM &&
+             (instr->b.value == 2 || instr->b.value == 3))
+        scale = 1L << instr->b.value;
+    return scale == 4 || scale == 8 ? (int)scale : 0;
+}
+
+// 循环外只定义一次的 mov &sym 换成地址本身（同一数组的不同基址 vreg 得到相同的基址）
+static IrOperand invariant_base(Vectorizer *v, const IrOperand *operand)
+{
+    IrFunction *func = v->func;
+    if (v->defs[operand->value] != 1)
+        return *operand;
+    for (int i = 0; i < func->num_instrs; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        if (ir_instr_def(instr) == operand->value)
+            return instr->op == IR_MOV && is_address_kind(&instr->a) ? instr->a : *operand;
+    }
+    return *operand;
+}
+
+// p = base + x / x + base：基址在循环中不变（或者是循环体中的 mov &sym），成功时记下基址
+static int address_of(Vectorizer *v, const IrInstr *instr, IrOperand *base, int *scale)
+{
+    if (instr->op != IR_ADD)
+        return 0;
+    const IrOperand *index = &instr->b;
+    const IrOperand *other = &instr->a;
+    if (!(index->kind == IR_OPERAND_VREG && v->cls[index->value] == VALUE_INDEX))
+    {
+        index = &instr->a;
+        other = &instr->b;
+    }
+    if (!(index->kind == IR_OPERAND_VREG && v->cls[index->value] == VALUE_INDEX) || index->offset != 0)
+        return 0;
+    if (other->kind == IR_OPERAND_VREG && v->cls[other->value] == VALUE_SYMBOL)
+        *base = v->base[other->value];
+    else if (other->kind == IR_OPERAND_VREG && is_invariant(v, other))
+        *base = invariant_base(v, other);
+    else
+        return 0;
+    *scale = v->scale[index->value];
+    return 1;
+}
+
+// 元素访问：地址是 base + i * E，访问宽度就是 E，所有访问的宽度和符号相同
+static int check_access(Vectorizer *v, const IrOperand *addr, int size, int is_unsigned, int is_store)
+{
+    if (addr->kind != IR_OPERAND_VREG || addr->offset != 0 || v->cls[addr->value] != VALUE_ADDRESS ||
+        v->scale[addr->value] != size)
+        return 0;
+    if (v->elem == 0)
+        v->elem = size;
+    if (v->elem != size || (!is_store && v->has_load && v->is_unsigned != is_unsigned))
+        return 0;
+    if (!is_store)
+    {
+        v->is_unsigned = is_unsigned;
+        v->has_load = 1;
+    }
+    const IrOperand *base = &v->base[addr->value];
+    int k = 0;
+    while (k < v->num_bases && !same_operand(&v->bases[k], base))
+        k++;
+    if (k == v->num_bases)
+    {
+        if (k == MAX_BASES)
+            return 0;
+        v->bases[v->num_bases++] = *base;
+    }
+    v->base_stored[k] |= is_store;
+    return 1;
+}
+
+static int add_reduction(Vectorizer *v, int var, IrOpcode op, int pos, int value)
+{
+    if (v->num_reductions == MAX_REDUCTIONS)
+        return 0;
+    int k = v->num_reductions++;
+    v->reductions[k].var = var;
+    v->reductions[k].op = op;
+    v->reductions[k].ext_size = 0;
+    v->action[pos - v->cl.body_first] = ACTION_REDUCE;
+    v->reduction_of[pos - v->cl.body_first] = k;
+    v->reduce_value[pos - v->cl.body_first] = value;
+    return 1;
+}
+
+static IrOpcode vector_opcode(IrOpcode op)
+{
+    switch (op)
+    {
+    case IR_ADD:
+        return IR_VADD;
+    case IR_SUB:
+        return IR_VSUB;
+    case IR_MUL:
+        return IR_VMUL;
+    case IR_AND:
+        return IR_VAND;
+    case IR_OR:
+        return IR_VOR;
+    case IR_XOR:
+        return IR_VXOR;
+    default:
+        return IR_VLOAD;
+    }
+}
+
+// r = s op v; s = mov r（或 s = ext r、s = s op v），s 在循环中只被这条指令读取；返回消耗的指令数。
+// 加减和位运算的结果模 2^n 只取决于操作数的低 n 位，所以每次截断和最后截断一次的结果相同
+static int match_reduction(Vectorizer *v, int pos)
+{
+    IrFunction *func = v->func;
+    IrInstr *instr = &func->instrs[pos];
+    IrOpcode op = vector_opcode(instr->op);
+    if (op == IR_VLOAD || op == IR_VMUL)
+        return 0;
+    int dst = ir_instr_def(instr);
+    const IrOperand *var = &instr->a;
+    const IrOperand *value = &instr->b;
+    if (op != IR_VSUB && is_vector(v, var))
+    {
+        var = &instr->b;
+        value = &instr->a;
+    }
+    if (var->kind != IR_OPERAND_VREG || var->offset != 0 || !is_vector(v, value))
+        return 0;
+    int s = (int)var->value;
+    if (s == v->cl.iv || v->cls[s] != VALUE_NONE || v->loop_defs[s] != 1 || v->loop_uses[s] != 1)
+        return 0;
+    int consumed = 1;
+    if (dst != s)
+    {
+        IrInstr *next = pos + 1 < v->cl.body_last ? &func->instrs[pos + 1] : NULL;
+        if (!next || (next->op != IR_MOV && next->op != IR_EXT) || !is_vreg(&next->dst, s) ||
+            !is_vreg(&next->a, dst) || v->defs[dst] != 1 || v->uses[dst] != 1)
+            return 0;
+        consumed = 2;
+    }
+    if (!add_reduction(v, s, op, pos, (int)value->value))
+        return 0;
+    if (consumed == 2 && func->instrs[pos + 1].op == IR_EXT)
+    {
+        v->reductions[v->num_reductions - 1].ext_size = func->instrs[pos + 1].size;
+        v->reductions[v->num_reductions - 1].ext_unsigned = func->instrs[pos + 1].is_unsigned;
+    }
+    return consumed;
+}
+
+static IrOpcode negate_condition(IrOpcode cond)
+{
+    switch (cond)
+    {
+    case IR_EQ:
+        return IR_NE;
+    case IR_NE:
+        return IR_EQ;
+    case IR_LT:
+        return IR_GE;
+    case IR_LE:
+        return IR_GT;
+    case IR_GT:
+        return IR_LE;
+    default:
+        return IR_LT;
+    }
+}
+
+static IrOpcode swap_condition(IrOpcode cond)
+{
+    switch (cond)
+    {
+    case IR_LT:
+        return IR_GT;
+    case IR_LE:
+        return IR_GE;
+    case IR_GT:
+        return IR_LT;
+    case IR_GE:
+        return IR_LE;
+    default:
+        return cond;
+    }
+}
+
+static int find_label_in_body(Vectorizer *v, long label, int from)
+{
+    for (int i = from; i < v->cl.body_last; i++)
+    {
+        IrInstr *instr = &v->func->instrs[i];
+        if (instr->op == IR_LABEL && instr->a.value == label)
+            return i;
+    }
+    return -1;
+}
+
+// 最小/最大值的一个分支：[first, last) 中只能重新计算 x 所在的地址并再次加载，
+// 最后一条是 dst = mov y；y 与 x 相同（或者是同一地址的加载）时 *is_x = 1，y 是 m 时为 0
+static int match_arm(Vectorizer *v, int first, int last, int x, int m, int dst, int *is_x)
+{
+    IrFunction *func = v->func;
+    if (last <= first)
+        return 0;
+    IrInstr *move = &func->instrs[last - 1];
+    if (move->op != IR_MOV || !is_vreg(&move->dst, dst) || move->a.kind != IR_OPERAND_VREG || move->a.offset != 0)
+        return 0;
+    int equal_load = -1; // 分支中与 x 相同地址的加载的结果
+    for (int i = first; i < last - 1; i++)
+    {
+        IrInstr *instr = &func->instrs[i];
+        int d = ir_instr_def(instr);
+        IrOperand base;
+        int scale;
+        if (d < 0 || !is_loop_temp(v, d) || v->cls[d] != VALUE_NONE)
+            return 0;
+        if (index_scale(v, instr))
+        {
+            v->cls[d] = VALUE_INDEX;
+            v->scale[d] = index_scale(v, instr);
+        }
+        else if (address_of(v, instr, &base, &scale))
+        {
+            v->cls[d] = VALUE_ADDRESS;
+            v->base[d] = base;
+            v->scale[d] = scale;
+        }
+        else if (instr->op == IR_LOAD && instr->a.kind == IR_OPERAND_VREG && instr->a.offset == 0 &&
+                 v->cls[instr->a.value] == VALUE_ADDRESS && v->loaded_from[x] >= 0 &&
+                 same_operand(&v->base[instr->a.value], &v->base[v->loaded_from[x]]) &&
+                 v->scale[instr->a.value] == instr->size && instr->size == v->elem &&
+                 instr->is_unsigned == v->is_unsigned)
+        {
+            equal_load = d;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    // 分支中的值不会在向量循环中出现
+    for (int i = first; i < last - 1; i++)
+        v->cls[ir_instr_def(&func->instrs[i])] = VALUE_NONE;
+    int y = (int)move->a.value;
+    if (y == m)
+        *is_x = 0;
+    else if (y == x || y == equal_load)
+        *is_x = 1;
+    else
+        return 0;
+    return 1;
+}
+
+// 最小/最大值：
+//   if 形式：    br c x, m -> .L1; [加载] m = mov y; .L1:
+//   三目运算形式：br c x, m -> .L1; [加载] t = mov y1; jmp .L2; .L1: [加载] t = mov y2; .L2: m = mov t
+// 返回消耗的指令数
+static int match_minmax(Vectorizer *v, int pos)
+{
+    IrFunction *func = v->func;
+    IrInstr *br = &func->instrs[pos];
+    int x, m;
+    IrOpcode cond = br->cond;
+    if (is_vector(v, &br->a) && br->b.kind == IR_OPERAND_VREG)
+    {
+        x = (int)br->a.value;
+        m = (int)br->b.value;
+    }
+    else if (is_vector(v, &br->b) && br->a.kind == IR_OPERAND_VREG)
+    {
+        x = (int)br->b.value;
+        m = (int)br->a.value;
+        cond = swap_condition(cond);
+    }
+    else
+    {
+        return 0;
+    }
+    // 现在条件写成 x <cond> m；x 必须是直接加载的值（与标量代码的比较结果一致）
+    if (v->elem != 4 || v->is_unsigned || v->loaded_from[x] < 0 || br->a.offset || br->b.offset)
+        return 0;
+    if (m == v->cl.iv || v->cls[m] != VALUE_NONE || v->loop_defs[m] != 1)
+        return 0;
+    int taken = find_label_in_body(v, br->dst.value, pos + 1);
+    if (taken < 0)
+        return 0;
+
+    int end;          // 消耗的最后一条指令
+    int take_when;    // 1：条件成立时取 x；0：条件不成立时取 x
+    int is_x;
+    IrInstr *before = &func->instrs[taken - 1];
+    if (before->op == IR_JMP)
+    {
+        int join = find_label_in_body(v, before->a.value, taken + 1);
+        if (join < 0 || join + 1 >= v->cl.body_last)
+            return 0;
+        IrInstr *merge = &func->instrs[join + 1];
+        if (merge->op != IR_MOV || !is_vreg(&merge->dst, m) || merge->a.kind != IR_OPERAND_VREG)
+            return 0;
+        int t = (int)merge->a.value;
+        if (v->defs[t] != 2 || v->uses[t] != 1 || v->loop_uses[m] != 2)
+            return 0;
+        int then_is_x, else_is_x;
+        if (!match_arm(v, pos + 1, taken - 1, x, m, t, &then_is_x) ||
+            !match_arm(v, taken + 1, join, x, m, t, &else_is_x) || then_is_x == else_is_x)
+            return 0;
+        take_when = else_is_x;
+        end = join + 1;
+    }
+    else
+    {
+        if (v->loop_uses[m] != 1 || !match_arm(v, pos + 1, taken, x, m, m, &is_x) || !is_x)
+            return 0;
+        take_when = 0;
+        end = taken;
+    }
+    IrOpcode rel = take_when ? cond : negate_condition(cond);
+    IrOpcode op;
+    if (rel == IR_LT || rel == IR_LE)
+        op = IR_VMIN;
+    else if (rel == IR_GT || rel == IR_GE)
+        op = IR_VMAX;
+    else
+        return 0;
+    if (!add_reduction(v, m, op, pos, x))
+        return 0;
+    return end - pos + 1;
+}
+
+// 逐条分类循环体中的指令，不能向量化时返回 0
+static int classify(Vectorizer *v)
+{
+    IrFunction *func = v->func;
+    IrCountedLoop *cl = &v->cl;
+    for (int pos = cl->body_first; pos < cl->body_last; pos++)
+    {
+        IrInstr *instr = &func->instrs[pos];
+        Action *action = &v->action[pos - cl->body_first];
+        int d = ir_instr_def(instr);
+        IrOperand base;
+        int scale;
+        *action = ACTION_SKIP;
+        if (instr->op == IR_LABEL || pos == cl->iv_def || pos == cl->step_def)
+            continue;
+        if (instr->op == IR_BR)
+        {
+            int consumed = match_minmax(v, pos);
+            if (consumed == 0)
+                return 0;
+            pos += consumed - 1;
+            continue;
+        }
+        if (d < 0 && instr->op != IR_STORE)
+            return 0; // 跳转、调用等
+        if (d >= 0 && (d >= v->num_vregs || v->cls[d] != VALUE_NONE))
+            return 0;
+        if (instr->op == IR_MOV && d >= 0 && v->uses[d] == 0)
+            continue; // 没有使用的复制（例如 i++ 的旧值）
+        if (instr->op == IR_MOV && is_address_kind(&instr->a) && v->defs[d] == 1)
+        {
+            v->cls[d] = VALUE_SYMBOL;
+            v->base[d] = instr->a;
+            continue;
+        }
+        if (instr->op == IR_STORE)
+        {
+            if (!check_access(v, &instr->a, instr->size, 0, 1) || !use_vector_operand(v, &instr->b))
+                return 0;
+            *action = ACTION_STORE;
+            continue;
+        }
+        if (!is_loop_temp(v, d))
+        {
+            // 可能是归约：s = s op v
+            int consumed = match_reduction(v, pos);
+            if (consumed == 0)
+                return 0;
+            pos += consumed - 1;
+            continue;
+        }
+        if (index_scale(v, instr))
+        {
+            v->cls[d] = VALUE_INDEX;
+            v->scale[d] = index_scale(v, instr);
+            *action = ACTION_INDEX;
+        }
+        else if (address_of(v, instr, &base, &scale))
+        {
+            v->cls[d] = VALUE_ADDRESS;
+            v->base[d] = base;
+            v->scale[d] = scale;
+            *action = ACTION_ADDRESS;
+        }
+        else if (instr->op == IR_LOAD)
+        {
+            if (!check_access(v, &instr->a, instr->size, instr->is_unsigned, 0))
+                return 0;
+            v->cls[d] = VALUE_VECTOR;
+            v->rep[d] = d;
+            v->loaded_from[d] = (int)instr->a.value;
+            *action = ACTION_LOAD;
+        }
+        else if ((instr->op == IR_MOV ||
+                  (instr->op == IR_EXT && instr->size == v->elem && instr->is_unsigned == v->is_unsigned)) &&
+                 is_vector(v, &instr->a) && instr->a.offset == 0)
+        {
+            // 向量值的复制（或者截断成元素本身的宽度）：与原来的值共用寄存器
+            v->cls[d] = VALUE_VECTOR;
+            v->rep[d] = v->rep[instr->a.value];
+            v->loaded_from[d] = v->loaded_from[instr->a.value];
+        }
+        else if (vector_opcode(instr->op) != IR_VLOAD && (is_vector(v, &instr->a) || is_vector(v, &instr->b)))
+        {
+            int consumed = match_reduction(v, pos);
+            if (consumed > 0)
+            {
+                pos += consumed - 1;
+                continue;
+            }
+            if (!use_vector_operand(v, &instr->a) || !use_vector_operand(v, &instr->b))
+                return 0;
+            v->cls[d] = VALUE_VECTOR;
+            v->rep[d] = d;
+            *action = ACTION_OP;
+        }
+        else
+        {
+            return 0;
+        }
+    }
+    if (v->elem == 0)
+        return 0; // 没有访问数组
+    for (int pos = cl->body_first; pos < cl->body_last; pos++)
+    {
+        IrInstr *instr = &func->instrs[pos];
+        Action action = v->action[pos - cl->body_first];
+        if (action == ACTION_OP && instr->op == IR_MUL && v->elem == 8)
+            return 0; // 没有 8 字节元素的乘法
+    }
+    for (int k = 0; k < v->num_reductions; k++)
+    {
+        IrOpcode op = v->reductions[k].op;
+        if ((op == IR_VMIN || op == IR_VMAX) && (v->elem != 4 || v->is_unsigned))
+            return 0;
+    }
+    return 1;
+}
+
+// ========== 向量寄存器 ==========
+
+static void note_use(Vectorizer *v, const IrOperand *operand, int pos)
+{
+    if (is_vector(v, operand))
+        v->last_use[v->rep[operand->value]] = pos;
+}
+
+// 按循环体中的顺序分配：不变值和累加器一直占用，其余的值在最后一次使用之后释放。
+// 结果的寄存器在释放操作数之前分配，所以不会与操作数相同（SSE 的两操作数形式需要）
+static int allocate_registers(Vectorizer *v)
+{
+    IrFunction *func = v->func;
+    IrCountedLoop *cl = &v->cl;
+    char busy[VECTOR_REGS];
+    memset(busy, 0, sizeof(busy));
+    int next = 0;
+    for (int k = 0; k < v->num_splats; k++)
+    {
+        v->splat_regs[k] = next;
+        busy[next++] = 1;
+    }
+    for (int k = 0; k < v->num_reductions; k++)
+    {
+        Reduction *red = &v->reductions[k];
+        int sum = red->op == IR_VADD || red->op == IR_VSUB;
+        red->num_acc = sum && v->elem == 4 ? 2 : 1;
+        // 累加器的元素比 s 窄时高位已经丢失
+        if (red->ext_size > (red->num_acc == 2 ? 8 : v->elem))
+            return 0;
+        for (int a = 0; a < red->num_acc; a++)
+        {
+            if (next == VECTOR_REGS)
+                return 0;
+            red->acc[a] = next;
+            busy[next++] = 1;
+        }
+    }
+    for (int k = 0; k < v->num_reductions && v->widen_temp < 0; k++)
+    {
+        // 4 字节元素求和时扩展用的临时寄存器，所有求和共用
+        if (v->reductions[k].num_acc == 2)
+        {
+            if (next == VECTOR_REGS)
+                return 0;
+            v->widen_temp = next;
+            busy[next++] = 1;
+        }
+    }
+
+    for (int pos = cl->body_first; pos < cl->body_last; pos++)
+    {
+        IrInstr *instr = &func->instrs[pos];
+        int k = pos - cl->body_first;
+        if (v->action[k] == ACTION_STORE)
+            note_use(v, &instr->b, pos);
+        else if (v->action[k] == ACTION_OP)
+        {
+            note_use(v, &instr->a, pos);
+            note_use(v, &instr->b, pos);
+        }
+        else if (v->action[k] == ACTION_REDUCE)
+            v->last_use[v->rep[v->reduce_value[k]]] = pos;
+    }
+
+    for (int pos = cl->body_first; pos < cl->body_last; pos++)
+    {
+        int k = pos - cl->body_first;
+        int d = ir_instr_def(&func->instrs[pos]);
+        if (v->action[k] == ACTION_LOAD || v->action[k] == ACTION_OP)
+        {
+            int r = 0;
+            while (r < VECTOR_REGS && busy[r])
+                r++;
+            if (r == VECTOR_REGS)
+                return 0;
+            busy[r] = 1;
+            v->vec[d] = r;
+            if (v->last_use[d] < 0)
+                busy[r] = 0; // 结果没有使用
+        }
+        // 释放最后一次使用在这里的值
+        for (int r = 0; r < v->num_vregs; r++)
+        {
+            if (v->last_use[r] == pos && v->vec[r] >= 0)
+                busy[v->vec[r]] = 0;
+        }
+    }
+    return 1;
+}
+
+static int splat_register(Vectorizer *v, const IrOperand *operand)
+{
+    for (int k = 0; k < v->num_splats; k++)
+    {
+        if (same_operand(&v->splats[k], operand))
+            return v->splat_regs[k];
+    }
+    return -1;
+}
+
+static IrOperand vector_operand(Vectorizer *v, const IrOperand *operand)
+{
+    IrOperand result = ir_none();
+    result.kind = IR_OPERAND_VECTOR;
+    if (is_vector(v, operand))
+        result.value = v->vec[v->rep[operand->value]];
+    else
+        result.value = splat_register(v, operand);
+    return result;
+}
+
+static IrOperand vector_reg(int reg)
+{
+    IrOperand operand = ir_none();
+    operand.kind = IR_OPERAND_VECTOR;
+    operand.value = reg;
+    return operand;
+}
+
+// ========== 重叠检查 ==========
+
+// 基址是否为符号地址（&a + offset），是时返回 1
+static int symbolic_base(Vectorizer *v, const IrOperand *base, IrOperand *symbol)
+{
+    if (is_address_kind(base))
+    {
+        *symbol = *base;
+        return 1;
+    }
+    if (base->kind != IR_OPERAND_VREG || v->defs[base->value] != 1)
+        return 0;
+    for (int i = 0; i < v->func->num_instrs; i++)
+    {
+        IrInstr *instr = &v->func->instrs[i];
+        if (ir_instr_def(instr) == base->value)
+        {
+            if (instr->op != IR_MOV || !is_address_kind(&instr->a))
+                return 0;
+            *symbol = instr->a;
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// 有写入的基址与其他基址两两比较：符号地址直接判断，其余的在运行时检查。
+// 返回需要运行时检查的对数（pairs 中），一定重叠时返回 -1
+static int find_alias_checks(Vectorizer *v, int pairs[][2])
+{
+    int count = 0;
+    for (int i = 0; i < v->num_bases; i++)
+    {
+        for (int j = 0; j < v->num_bases; j++)
+        {
+            if (i == j || !v->base_stored[i] || (v->base_stored[j] && j < i))
+                continue;
+            IrOperand p, q;
+            if (symbolic_base(v, &v->bases[i], &p) && symbolic_base(v, &v->bases[j], &q))
+            {
+                IrOperand p0 = p, q0 = q;
+                p0.offset = q0.offset = 0;
+                if (!same_operand(&p0, &q0))
+                    continue; // 不同的对象
+                long distance = q.offset - p.offset;
+                if (distance == 0 || distance >= v->width || distance <= -v->width)
+                    continue;
+                return -1;
+            }
+            if (count == MAX_ALIAS_CHECKS)
+                return -1;
+            pairs[count][0] = i;
+            pairs[count][1] = j;
+            count++;
+        }
+    }
+    return count;
+}
+
+// ========== 生成 ==========
+
+typedef struct Emitter
+{
+    IrInstr *instrs;
+    int count;
+    int capacity;
+} Emitter;
+
+static IrInstr *emit_instr(Emitter *e, IrOpcode op, IrOperand dst, IrOperand a, IrOperand b)
+{
+    if (e->count == e->capacity)
+    {
+        e->capacity = e->capacity ? e->capacity * 2 : 64;
+        e->instrs = (IrInstr *)realloc(e->instrs, e->capacity * sizeof(IrInstr));
+        if (!e->instrs)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    IrInstr *instr = &e->instrs[e->count++];
+    memset(instr, 0, sizeof(*instr));
+    instr->op = op;
+    instr->size = 8;
+    instr->dst = dst;
+    instr->a = a;
+    instr->b = b;
+    return instr;
+}
+
+static IrInstr *emit_vector(Emitter *e, Vectorizer *v, IrOpcode op, IrOperand dst, IrOperand a, IrOperand b,
+                            int size)
+{
+    IrInstr *instr = emit_instr(e, op, dst, a, b);
+    instr->size = size;
+    instr->width = v->width;
+    instr->is_unsigned = v->is_unsigned;
+    return instr;
+}
+
+static void emit_branch(Emitter *e, IrOpcode cond, IrOperand a, IrOperand b, long label)
+{
+    IrInstr *instr = emit_instr(e, IR_BR, ir_label((int)label), a, b);
+    instr->cond = cond;
+}
+
+// 值装入 vreg（地址类操作数先取地址）
+static IrOperand materialize(Emitter *e, IrFunction *func, const IrOperand *operand)
+{
+    if (operand->kind == IR_OPERAND_VREG)
+        return *operand;
+    IrOperand reg = ir_vreg(ir_new_vreg(func));
+    emit_instr(e, IR_MOV, reg, *operand, ir_none());
+    return reg;
+}
+
+// 两个区域的起点相差不到一个向量（并且不相同）时执行原来的循环
+static void emit_alias_check(Emitter *e, Vectorizer *v, const IrOperand *p, const IrOperand *q, long scalar_label)
+{
+    IrFunction *func = v->func;
+    long ok = ir_new_label(func);
+    IrOperand a = materialize(e, func, p);
+    IrOperand b = materialize(e, func, q);
+    IrOperand distance = ir_vreg(ir_new_vreg(func));
+    emit_instr(e, IR_SUB, distance, a, b);
+    emit_branch(e, IR_EQ, distance, ir_imm(0), ok);
+    emit_branch(e, IR_GE, distance, ir_imm(v->width), ok);
+    emit_branch(e, IR_LE, distance, ir_imm(-v->width), ok);
+    emit_instr(e, IR_JMP, ir_none(), ir_label((int)scalar_label), ir_none());
+    emit_instr(e, IR_LABEL, ir_none(), ir_label((int)ok), ir_none());
+}
+
+static long identity_of(IrOpcode op)
+{
+    switch (op)
+    {
+    case IR_VAND:
+        return -1;
+    case IR_VMIN:
+        return 2147483647L;
+    case IR_VMAX:
+        return -2147483648L;
+    default:
+        return 0;
+    }
+}
+
+static IrOpcode scalar_opcode(IrOpcode op)
+{
+    switch (op)
+    {
+    case IR_VSUB:
+        return IR_SUB;
+    case IR_VAND:
+        return IR_AND;
+    case IR_VOR:
+        return IR_OR;
+    case IR_VXOR:
+        return IR_XOR;
+    default:
+        return IR_ADD;
+    }
+}
+
+static void emit_vector_body(Emitter *e, Vectorizer *v)
+{
+    IrFunction *func = v->func;
+    IrCountedLoop *cl = &v->cl;
+    for (int pos = cl->body_first; pos < cl->body_last; pos++)
+    {
+        int k = pos - cl->body_first;
+        IrInstr instr = func->instrs[pos];
+        int d = ir_instr_def(&instr);
+        switch (v->action[k])
+        {
+        case ACTION_SKIP:
+            break;
+        case ACTION_INDEX:
+            v->renamed[d] = ir_new_vreg(func);
+            emit_instr(e, instr.op, ir_vreg(v->renamed[d]), instr.a, instr.b);
+            break;
+        case ACTION_ADDRESS:
+        {
+            const IrOperand *index = instr.b.kind == IR_OPERAND_VREG && v->cls[instr.b.value] == VALUE_INDEX
+                                         ? &instr.b
+                                         : &instr.a;
+            v->renamed[d] = ir_new_vreg(func);
+            emit_instr(e, IR_ADD, ir_vreg(v->renamed[d]), v->base[d], ir_vreg(v->renamed[index->value]));
+            break;
+        }
+        case ACTION_LOAD:
+            emit_vector(e, v, IR_VLOAD, vector_reg(v->vec[d]), ir_vreg(v->renamed[instr.a.value]), ir_none(),
+                        v->elem);
+            break;
+        case ACTION_STORE:
+            emit_vector(e, v, IR_VSTORE, ir_none(), ir_vreg(v->renamed[instr.a.value]),
+                        vector_operand(v, &instr.b), v->elem);
+            break;
+        case ACTION_OP:
+            emit_vector(e, v, vector_opcode(instr.op), vector_reg(v->vec[d]), vector_operand(v, &instr.a),
+                        vector_operand(v, &instr.b), v->elem);
+            break;
+        case ACTION_REDUCE:
+        {
+            Reduction *red = &v->reductions[v->reduction_of[k]];
+            IrOperand value = vector_reg(v->vec[v->rep[v->reduce_value[k]]]);
+            IrOpcode op = red->op == IR_VSUB ? IR_VADD : red->op;
+            if (red->num_acc == 1)
+            {
+                emit_vector(e, v, op, vector_reg(red->acc[0]), vector_reg(red->acc[0]), value, v->elem);
+                break;
+            }
+            // 4 字节元素扩展成 8 字节之后分别累加低半部分和高半部分
+            for (int half = 0; half < 2; half++)
+            {
+                emit_vector(e, v, IR_VWIDEN, vector_reg(v->widen_temp), value, ir_imm(half), 4);
+                emit_vector(e, v, IR_VADD, vector_reg(red->acc[half]), vector_reg(red->acc[half]),
+                            vector_reg(v->widen_temp), 8);
+            }
+            break;
+        }
+        }
+    }
+}
+
+// 最小/最大值和无符号元素的按位与：累加器中的初值不是 64 位的单位元，向量循环执行过才合并
+static int needs_guard(Vectorizer *v, const Reduction *red)
+{
+    return red->op == IR_VMIN || red->op == IR_VMAX || (red->op == IR_VAND && v->is_unsigned);
+}
+
+static void emit_truncate(Emitter *e, const Reduction *red)
+{
+    if (red->ext_size == 0)
+        return;
+    IrInstr *ext = emit_instr(e, IR_EXT, ir_vreg(red->var), ir_vreg(red->var), ir_none());
+    ext->size = red->ext_size;
+    ext->is_unsigned = red->ext_unsigned;
+}
+
+// 向量循环结束后把累加器合并到累加变量
+static void emit_reductions(Emitter *e, Vectorizer *v, int first_iv)
+{
+    IrFunction *func = v->func;
+    for (int k = 0; k < v->num_reductions; k++)
+    {
+        Reduction *red = &v->reductions[k];
+        IrOperand var = ir_vreg(red->var);
+        IrOperand result = ir_vreg(ir_new_vreg(func));
+        IrOpcode op = red->op == IR_VSUB ? IR_VADD : red->op;
+        int size = red->num_acc == 2 ? 8 : v->elem;
+        if (red->num_acc == 2)
+            emit_vector(e, v, IR_VADD, vector_reg(red->acc[0]), vector_reg(red->acc[0]), vector_reg(red->acc[1]), 8);
+        IrInstr *reduce = emit_vector(e, v, IR_VREDUCE, result, vector_reg(red->acc[0]), ir_none(), size);
+        reduce->cond = op;
+        if (!needs_guard(v, red))
+        {
+            emit_instr(e, scalar_opcode(red->op), var, var, result);
+            emit_truncate(e, red);
+            continue;
+        }
+        long skip = ir_new_label(func);
+        emit_branch(e, IR_EQ, ir_vreg(v->cl.iv), ir_vreg(first_iv), skip);
+        if (red->op == IR_VAND)
+        {
+            emit_instr(e, IR_AND, var, var, result);
+        }
+        else
+        {
+            emit_branch(e, red->op == IR_VMIN ? IR_LE : IR_GE, var, result, skip);
+            emit_instr(e, IR_MOV, var, result, ir_none());
+        }
+        emit_instr(e, IR_LABEL, ir_none(), ir_label((int)skip), ir_none());
+        emit_truncate(e, red);
+    }
+}
+
+static int vectorize_loop(IrFunction *func, IrLoopInfo **info, IrLoop *loop, void *ctx)
+{
+    int width = *(int *)ctx;
+    IrCountedLoop cl;
+    if (!ir_match_counted_loop(func, *info, loop, &cl) || cl.step != 1 || cl.body_size > VECTOR_MAX_BODY)
+        return 0;
+
+    // 先确认能够向量化，再为循环插入前置块
+    Vectorizer v;
+    vectorizer_init(&v, func, &cl, width);
+    int ok = classify(&v) && allocate_registers(&v);
+    vectorizer_free(&v);
+    if (!ok)
+        return 0;
+    loop = ir_prepare_loop(func, info, loop);
+    if (!loop || !ir_match_counted_loop(func, *info, loop, &cl))
+        return 0;
+    vectorizer_init(&v, func, &cl, width);
+    int pairs[MAX_ALIAS_CHECKS][2];
+    int num_checks = -1;
+    if (classify(&v) && allocate_registers(&v))
+        num_checks = find_alias_checks(&v, pairs);
+    v.lanes = width / (v.elem ? v.elem : 1);
+    long initial;
+    long trips = -1;
+    if (num_checks >= 0 && cl.bound.kind == IR_OPERAND_IMM && ir_loop_initial_value(func, &cl, &initial))
+        trips = ir_loop_trip_count(&cl, initial, v.lanes);
+    if (num_checks < 0 || (trips >= 0 && trips < v.lanes))
+    {
+        vectorizer_free(&v);
+        return 0;
+    }
+
+    Emitter e;
+    memset(&e, 0, sizeof(e));
+    long scalar_label = loop->label;
+    for (int k = 0; k < num_checks; k++)
+        emit_alias_check(&e, &v, &v.bases[pairs[k][0]], &v.bases[pairs[k][1]], scalar_label);
+    int first_iv = -1;
+    for (int k = 0; k < v.num_reductions; k++)
+        v.needs_first_iv |= needs_guard(&v, &v.reductions[k]);
+    if (v.needs_first_iv)
+    {
+        first_iv = ir_new_vreg(func);
+        emit_instr(&e, IR_MOV, ir_vreg(first_iv), ir_vreg(cl.iv), ir_none());
+    }
+    for (int k = 0; k < v.num_splats; k++)
+        emit_vector(&e, &v, IR_VSPLAT, vector_reg(v.splat_regs[k]), v.splats[k], ir_none(), v.elem);
+    for (int k = 0; k < v.num_reductions; k++)
+    {
+        Reduction *red = &v.reductions[k];
+        for (int a = 0; a < red->num_acc; a++)
+            emit_vector(&e, &v, IR_VSPLAT, vector_reg(red->acc[a]), ir_imm(identity_of(red->op)), ir_none(),
+                        red->num_acc == 2 ? 8 : v.elem);
+    }
+
+    // .Lv: br <cond> i + (VF - 1), n -> .Ld
+    long vector_label = ir_new_label(func);
+    long done_label = ir_new_label(func);
+    long ahead = v.lanes - 1;
+    emit_instr(&e, IR_LABEL, ir_none(), ir_label((int)vector_label), ir_none());
+    long folded = cl.bound.kind == IR_OPERAND_IMM ? cl.bound.value - ahead : 0;
+    if (cl.bound.kind == IR_OPERAND_IMM && folded >= -2147483647L && folded <= 2147483647L)
+    {
+        emit_branch(&e, cl.cond, ir_vreg(cl.iv), ir_imm(folded), done_label);
+    }
+    else
+    {
+        IrOperand last = ir_vreg(ir_new_vreg(func));
+        emit_instr(&e, IR_ADD, last, ir_vreg(cl.iv), ir_imm(ahead));
+        emit_branch(&e, cl.cond, last, cl.bound, done_label);
+    }
+    emit_vector_body(&e, &v);
+    emit_instr(&e, IR_ADD, ir_vreg(cl.iv), ir_vreg(cl.iv), ir_imm(v.lanes));
+    emit_instr(&e, IR_JMP, ir_none(), ir_label((int)vector_label), ir_none());
+    emit_instr(&e, IR_LABEL, ir_none(), ir_label((int)done_label), ir_none());
+    emit_reductions(&e, &v, first_iv);
+
+    ir_insert_instrs(func, func->blocks[cl.header].first, e.instrs, e.count);
+    free(e.instrs);
+    vectorizer_free(&v);
+    return 1;
+}
+
+int opt_vectorize(IrFunction *func, int width)
+{
+    return ir_visit_loops(func, vectorize_loop, &width);
+}
@@ -14,7 +14,7 @@ ASTNode *ast_root = NULL;
 
 %union {
     int int_val;
-    float float_val;
+    double float_val;
     char *string_val;
     ASTNode *node;
 }
@@ -238,7 +238,7 @@ primary_expression:
         $$ = create_int_node($1, yylineno);
     }
     | FLOATING_CONSTANT {
-        $$ = create_float_node($1, yylineno);
+        $$ = create_float_node($1, 0, yylineno);
     }
     | STRING_LITERAL {
         $$ = create_string_node($1, yylineno);
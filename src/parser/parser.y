@@ -3,25 +3,43 @@
 #include <stdlib.h>
 #include <string.h>
 #include "ast.h"
+%}
 
-extern int yylex();
-extern int yyerror(const char *s);
-extern char *yytext;
-extern int yylineno;
+%code requires {
+#include "ast.h"
 
-ASTNode *ast_root = NULL;
-%}
+#ifndef YY_TYPEDEF_YY_SCANNER_T
+#define YY_TYPEDEF_YY_SCANNER_T
+typedef void *yyscan_t;
+#endif
+}
+
+%code {
+int yylex(YYSTYPE *yylval_param, yyscan_t scanner);
+int yyget_lineno(yyscan_t scanner);
+char *yyget_text(yyscan_t scanner);
+FILE *yyget_extra(yyscan_t scanner);
+void yyerror(yyscan_t scanner, ASTNode **ast_root, const char *s);
+
+// 可重入解析：行号取自当前扫描器实例
+#define yylineno yyget_lineno(scanner)
+}
+
+%define api.pure full
+%lex-param {yyscan_t scanner}
+%parse-param {yyscan_t scanner}
+%parse-param {ASTNode **ast_root}
 
 %union {
     int int_val;
-    float float_val;
+    double float_val;
     char *string_val;
     ASTNode *node;
 }
 
 %token <string_val> IDENTIFIER
 %token <int_val> INTEGER_CONSTANT
-%token <float_val> FLOATING_CONSTANT
+%token <float_val> FLOATING_CONSTANT FLOATING_CONSTANT_F
 %token <string_val> CHARACTER_CONSTANT STRING_LITERAL
 
 %token INT FLOAT CHAR VOID SHORT LONG DOUBLE UNSIGNED STRUCT UNION STATIC EXTERN TYPEDEF ENUM SIZEOF RETURN IF ELSE WHILE DO FOR SWITCH CASE DEFAULT BREAK CONTINUE ASM CONST VOLATILE INLINE
@@ -56,9 +74,9 @@ ASTNode *ast_root = NULL;
 
 program:
     external_declaration {
-        ast_root = create_ast_node(AST_PROGRAM, yylineno);
-        add_child(ast_root, $1);
-        $$ = ast_root;
+        *ast_root = create_ast_node(AST_PROGRAM, yylineno);
+        add_child(*ast_root, $1);
+        $$ = *ast_root;
     }
     | program external_declaration {
         add_child($1, $2);
@@ -141,10 +159,13 @@ declaration_specifiers:
     | STATIC INT { $$ = create_string_node("int", yylineno); $$->type = AST_TYPE_SPECIFIER; $$->lineno = -1; /* Mark as static with negative lineno */ }
     | STATIC FLOAT { $$ = create_string_node("float", yylineno); $$->type = AST_TYPE_SPECIFIER; $$->lineno = -1; }
     | STATIC CHAR { $$ = create_string_node("char", yylineno); $$->type = AST_TYPE_SPECIFIER; $$->lineno = -1; }
+    | STATIC VOID { $$ = create_string_node("void", yylineno); $$->type = AST_TYPE_SPECIFIER; $$->lineno = -1; }
     | EXTERN INT { $$ = create_string_node("int", yylineno); $$->type = AST_TYPE_SPECIFIER; $$->lineno = -2; /* Mark as extern with lineno=-2 */ }
     | EXTERN FLOAT { $$ = create_string_node("float", yylineno); $$->type = AST_TYPE_SPECIFIER; $$->lineno = -2; }
     | EXTERN CHAR { $$ = create_string_node("char", yylineno); $$->type = AST_TYPE_SPECIFIER; $$->lineno = -2; }
     | EXTERN VOID { $$ = create_string_node("void", yylineno); $$->type = AST_TYPE_SPECIFIER; $$->lineno = -2; }
+    | INLINE declaration_specifiers { $$ = $2; $$->lineno = $2->lineno == -1 ? -6 : -5; /* Mark as inline with lineno=-5, static inline with -6 */ }
+    | STATIC INLINE declaration_specifiers { $$ = $3; $$->lineno = -6; }
     ;
 
 declarator:
@@ -162,6 +183,7 @@ declarator:
     }
     | declarator LPAREN RPAREN {
         $$ = $1;
+        add_child($$, create_ast_node(AST_PARAM_LIST, yylineno));  // 空参数列表
     }
     | declarator LPAREN parameter_list RPAREN {
         $$ = $1;
@@ -175,7 +197,7 @@ declarator:
     }
     | declarator LBRACKET RBRACKET {
         ASTNode *array_decl = create_ast_node(AST_DECLARATOR, yylineno);
-        array_decl->value.int_val = -1;  // Unsized array
+        array_decl->value.int_val = -2;  // Unsized array（-1 已用于指针）
         add_child(array_decl, $1);
         $$ = array_decl;
     }
@@ -629,7 +651,10 @@ primary_expression:
         $$ = create_int_node($1, yylineno);
     }
     | FLOATING_CONSTANT {
-        $$ = create_float_node($1, yylineno);
+        $$ = create_float_node($1, 0, yylineno);
+    }
+    | FLOATING_CONSTANT_F {
+        $$ = create_float_node($1, 1, yylineno);
     }
     | STRING_LITERAL {
         $$ = create_string_node($1, yylineno);
@@ -731,7 +756,8 @@ union_specifier:
 
 %%
 
-int yyerror(const char *s) {
-    fprintf(stderr, "Parse Error at line %d: %s near '%s'\n", yylineno, s, yytext);
-    return 0;
+void yyerror(yyscan_t scanner, ASTNode **ast_root, const char *s) {
+    (void)ast_root;
+    fprintf(yyget_extra(scanner), "Parse Error at line %d: %s near '%s'\n",
+            yylineno, s, yyget_text(scanner));
 }
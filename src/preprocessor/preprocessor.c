@@ -2,13 +2,13 @@
 #include <stdlib.h>
 #include <string.h>
 #include <ctype.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sys/stat.h>
 
 #define INITIAL_OUTPUT_SIZE 4096
 #define MAX_INCLUDE_DEPTH 10
 
-// 全局变量：当前include深度
-static int include_depth = 0;
-
 // 创建预处理器
 Preprocessor *preprocessor_create(void)
 {
@@ -33,6 +33,11 @@ Preprocessor *preprocessor_create(void)
     pp->num_macros = 0;
     pp->macro_capacity = 0;
     pp->current_filename = NULL;
+    pp->include_depth = 0;
+    pp->diag = stderr;
+    pp->included_files = NULL;
+    pp->num_included_files = 0;
+    pp->included_capacity = 0;
 
     // 添加默认include路径
     preprocessor_add_include_path(pp, ".");
@@ -56,6 +61,10 @@ void preprocessor_free(Preprocessor *pp)
     if (pp->output)
         free(pp->output);
 
+    for (int i = 0; i < pp->num_included_files; i++)
+        free(pp->included_files[i]);
+    free(pp->included_files);
+
     if (pp->include_paths)
     {
         for (int i = 0; i < pp->num_include_paths; i++)
@@ -246,6 +255,172 @@ char *read_file_content(const char *filename)
     return content;
 }
 
+// ========== 头文件缓存 ==========
+// 编译服务器在多次编译之间保留读入的头文件内容。按 (设备, inode) 查找，
+// 修改时间或大小变化时重新读取；-j 的多个线程共享同一个缓存
+
+typedef struct HeaderCacheEntry
+{
+    dev_t device;
+    ino_t inode;
+    struct timespec mtime; // 纳秒精度：同一秒内的修改也能发现
+    struct timespec ctime; // 保留修改时间的写入（touch -d、cp -p、解压）也会改变 ctime
+    off_t size;
+    char *content;
+    char *path;  // 绝对路径（服务器子进程把新读入的头文件报告给服务器进程）
+    int is_new;  // 上次 preprocessor_header_cache_take_new 之后读入或更新
+    struct HeaderCacheEntry *next;
+} HeaderCacheEntry;
+
+static HeaderCacheEntry *header_cache = NULL;
+static int header_cache_enabled = 0;
+static int header_cache_hits = 0;
+static int header_cache_misses = 0;
+static pthread_mutex_t header_cache_lock = PTHREAD_MUTEX_INITIALIZER;
+
+void preprocessor_enable_header_cache(int enabled)
+{
+    pthread_mutex_lock(&header_cache_lock);
+    header_cache_enabled = enabled;
+    pthread_mutex_unlock(&header_cache_lock);
+}
+
+void preprocessor_header_cache_stats(int *entries, int *hits, int *misses)
+{
+    pthread_mutex_lock(&header_cache_lock);
+    int count = 0;
+    for (HeaderCacheEntry *entry = header_cache; entry; entry = entry->next)
+        count++;
+    *entries = count;
+    *hits = header_cache_hits;
+    *misses = header_cache_misses;
+    pthread_mutex_unlock(&header_cache_lock);
+}
+
+static int same_time(const struct timespec *a, const struct timespec *b)
+{
+    return a->tv_sec == b->tv_sec && a->tv_nsec == b->tv_nsec;
+}
+
+// 缓存的内容是否仍然有效：同一个文件（设备和 inode），修改时间、状态改变时间和大小都没有变化
+static int header_cache_valid(const HeaderCacheEntry *entry, const struct stat *st)
+{
+    return entry->device == st->st_dev && entry->inode == st->st_ino && same_time(&entry->mtime, &st->st_mtim) &&
+           same_time(&entry->ctime, &st->st_ctim) && entry->size == st->st_size;
+}
+
+// 读取头文件：缓存启用时返回缓存内容的副本（调用者负责释放）
+static char *read_header_content(const char *path)
+{
+    struct stat st;
+    if (stat(path, &st) != 0)
+        return NULL;
+
+    pthread_mutex_lock(&header_cache_lock);
+    if (!header_cache_enabled)
+    {
+        pthread_mutex_unlock(&header_cache_lock);
+        return read_file_content(path);
+    }
+
+    HeaderCacheEntry *entry = header_cache;
+    while (entry && !(entry->device == st.st_dev && entry->inode == st.st_ino))
+        entry = entry->next;
+
+    if (entry && header_cache_valid(entry, &st))
+    {
+        char *content = strdup(entry->content);
+        header_cache_hits++;
+        pthread_mutex_unlock(&header_cache_lock);
+        return content;
+    }
+    header_cache_misses++;
+    pthread_mutex_unlock(&header_cache_lock);
+
+    // 读文件时不持有锁
+    char *content = read_file_content(path);
+    if (!content)
+        return NULL;
+    char *cached = strdup(content);
+    if (!cached)
+        return content;
+
+    pthread_mutex_lock(&header_cache_lock);
+    entry = header_cache;
+    while (entry && !(entry->device == st.st_dev && entry->inode == st.st_ino))
+        entry = entry->next;
+    if (!entry)
+    {
+        entry = (HeaderCacheEntry *)calloc(1, sizeof(HeaderCacheEntry));
+        if (!entry)
+        {
+            pthread_mutex_unlock(&header_cache_lock);
+            free(cached);
+            return content;
+        }
+        entry->device = st.st_dev;
+        entry->inode = st.st_ino;
+        entry->next = header_cache;
+        header_cache = entry;
+    }
+    free(entry->content);
+    entry->content = cached;
+    entry->mtime = st.st_mtim;
+    entry->ctime = st.st_ctim;
+    entry->size = st.st_size;
+    entry->is_new = 1;
+    char *absolute = realpath(path, NULL);
+    if (absolute)
+    {
+        free(entry->path);
+        entry->path = absolute;
+    }
+    pthread_mutex_unlock(&header_cache_lock);
+    return content;
+}
+
+int preprocessor_preload_header(const char *path)
+{
+    char *content = read_header_content(path);
+    if (!content)
+        return 0;
+    free(content);
+    return 1;
+}
+
+void preprocessor_header_cache_take_new(void (*report)(const char *path, void *ctx), void *ctx)
+{
+    pthread_mutex_lock(&header_cache_lock);
+    for (HeaderCacheEntry *entry = header_cache; entry; entry = entry->next)
+    {
+        if (entry->is_new && entry->path && report)
+            report(entry->path, ctx);
+        entry->is_new = 0;
+    }
+    pthread_mutex_unlock(&header_cache_lock);
+}
+
+int preprocessor_preload_headers(const char *directory)
+{
+    DIR *dir = opendir(directory);
+    if (!dir)
+        return 0;
+
+    int count = 0;
+    struct dirent *ent;
+    char path[1024];
+    while ((ent = readdir(dir)) != NULL)
+    {
+        size_t len = strlen(ent->d_name);
+        if (len < 3 || strcmp(ent->d_name + len - 2, ".h") != 0)
+            continue;
+        snprintf(path, sizeof(path), "%s/%s", directory, ent->d_name);
+        count += preprocessor_preload_header(path);
+    }
+    closedir(dir);
+    return count;
+}
+
 // 查找include文件
 static char *find_include_file(Preprocessor *pp, const char *filename, int use_quotes)
 {
@@ -278,6 +453,38 @@ static char *find_include_file(Preprocessor *pp, const char *filename, int use_q
     return NULL;
 }
 
+// 记录读入的头文件（同一个文件只记录一次）
+static void record_included_file(Preprocessor *pp, const char *path)
+{
+    for (int i = 0; i < pp->num_included_files; i++)
+    {
+        if (strcmp(pp->included_files[i], path) == 0)
+            return;
+    }
+    if (pp->num_included_files >= pp->included_capacity)
+    {
+        pp->included_capacity = pp->included_capacity ? pp->included_capacity * 2 : 16;
+        pp->included_files = (char **)realloc(pp->included_files,
+                                              pp->included_capacity * sizeof(char *));
+        if (!pp->included_files)
+        {
+            fprintf(stderr, "Out of memory\n");
+            exit(1);
+        }
+    }
+    pp->included_files[pp->num_included_files++] = strdup(path);
+}
+
+char **preprocessor_take_included_files(Preprocessor *pp, int *count)
+{
+    char **files = pp->included_files;
+    *count = pp->num_included_files;
+    pp->included_files = NULL;
+    pp->num_included_files = 0;
+    pp->included_capacity = 0;
+    return files;
+}
+
 // 处理 #include 指令
 static const char *process_include(Preprocessor *pp, const char *line)
 {
@@ -286,7 +493,7 @@ static const char *process_include(Preprocessor *pp, const char *line)
 
     if (*p != '"' && *p != '<')
     {
-        fprintf(stderr, "Preprocessor error: Invalid #include directive\n");
+        fprintf(pp->diag, "Preprocessor error: Invalid #include directive\n");
         return NULL;
     }
 
@@ -304,14 +511,14 @@ static const char *process_include(Preprocessor *pp, const char *line)
 
     if (*p != end_char)
     {
-        fprintf(stderr, "Preprocessor error: Unclosed #include directive\n");
+        fprintf(pp->diag, "Preprocessor error: Unclosed #include directive\n");
         return NULL;
     }
 
     // 检查include深度
-    if (include_depth >= MAX_INCLUDE_DEPTH)
+    if (pp->include_depth >= MAX_INCLUDE_DEPTH)
     {
-        fprintf(stderr, "Preprocessor error: #include nested too deeply\n");
+        fprintf(pp->diag, "Preprocessor error: #include nested too deeply\n");
         return NULL;
     }
 
@@ -319,25 +526,51 @@ static const char *process_include(Preprocessor *pp, const char *line)
     char *filepath = find_include_file(pp, filename, use_quotes);
     if (!filepath)
     {
-        fprintf(stderr, "Preprocessor error: Cannot find file '%s'\n", filename);
+        fprintf(pp->diag, "Preprocessor error: Cannot find file '%s'\n", filename);
         return NULL;
     }
 
-    char *content = read_file_content(filepath);
+    char *content = read_header_content(filepath);
+    if (content)
+        record_included_file(pp, filepath);
     free(filepath);
 
     if (!content)
     {
-        fprintf(stderr, "Preprocessor error: Cannot read file '%s'\n", filename);
+        fprintf(pp->diag, "Preprocessor error: Cannot read file '%s'\n", filename);
         return NULL;
     }
 
-    // 递归处理include文件
-    include_depth++;
+    // 递归处理include文件：preprocessor_process 会重置输出缓冲区，
+    // 头文件使用单独的缓冲区，处理完后恢复当前文件的输出和行号
+    char *saved_output = pp->output;
+    int saved_output_size = pp->output_size;
+    int saved_output_pos = pp->output_pos;
+    int saved_line_number = pp->line_number;
+    const char *saved_filename = pp->current_filename;
+    pp->output = (char *)malloc(INITIAL_OUTPUT_SIZE);
+    if (!pp->output)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    pp->output_size = INITIAL_OUTPUT_SIZE;
+
+    pp->include_depth++;
     char *processed = preprocessor_process(pp, content, filename);
-    include_depth--;
+    pp->include_depth--;
     free(content);
 
+    free(pp->output);
+    pp->output = saved_output;
+    pp->output_size = saved_output_size;
+    pp->output_pos = saved_output_pos;
+    pp->line_number = saved_line_number;
+    pp->current_filename = saved_filename;
+    char filename_str[512];
+    snprintf(filename_str, sizeof(filename_str), "\"%s\"", saved_filename ? saved_filename : "<unknown>");
+    preprocessor_define_macro(pp, "__FILE__", filename_str);
+
     if (processed)
     {
         output_string(pp, processed);
@@ -551,7 +784,7 @@ static const char *process_conditional(Preprocessor *pp, const char *p, int *ski
 // 字符串化运算符 # - 将参数转换为字符串
 static char *stringify(const char *text)
 {
-    static char buffer[2048];
+    char buffer[2048];
     char *out = buffer;
     *out++ = '"';
 
@@ -591,7 +824,7 @@ static char *stringify(const char *text)
 // 连接运算符 ## - 连接两个token
 static char *concat_tokens(const char *left, const char *right)
 {
-    static char buffer[1024];
+    char buffer[1024];
     char *out = buffer;
 
     // 复制左侧（去除尾部空白）
@@ -621,7 +854,7 @@ static char *concat_tokens(const char *left, const char *right)
 // 处理宏值中的 # 和 ## 运算符
 static char *process_macro_operators(const char *value, char **param_names, char **param_values, int num_params, int is_variadic, const char *va_args)
 {
-    static char buffer[4096];
+    char buffer[4096];
     char *out = buffer;
     const char *p = value;
 
@@ -764,7 +997,7 @@ static char *process_macro_operators(const char *value, char **param_names, char
 // 展开宏
 static char *expand_macros(Preprocessor *pp, const char *text)
 {
-    static char buffer[4096];
+    char buffer[4096];
     char *out = buffer;
     const char *p = text;
 
@@ -1025,7 +1258,7 @@ char *preprocessor_process(Preprocessor *pp, const char *input, const char *file
                     p += 5;
                     p = skip_whitespace(p);
 
-                    fprintf(stderr, "#error: %s\n", p);
+                    fprintf(pp->diag, "#error: %s\n", p);
                     return NULL; // 编译错误
                 }
 
@@ -1272,6 +1505,11 @@ char *preprocessor_process(Preprocessor *pp, const char *input, const char *file
     // 添加字符串结束符
     output_char(pp, '\0');
 
-    // 返回处理后的代码
-    return strdup(pp->output);
+    // 返回处理后的代码，末尾多保留一个 '\0'，词法分析器可以直接在其上扫描
+    char *result = (char *)malloc(pp->output_pos + 1);
+    if (!result)
+        return NULL;
+    memcpy(result, pp->output, pp->output_pos);
+    result[pp->output_pos] = '\0';
+    return result;
 }
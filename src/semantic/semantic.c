@@ -17,6 +17,9 @@ SemanticAnalyzer *semantic_analyzer_create()
     analyzer->error_count = 0;
     analyzer->warning_count = 0;
     analyzer->loop_depth = 0;
+    analyzer->in_function = 0;
+    analyzer->static_counter = 0;
+    analyzer->diag = stderr;
     return analyzer;
 }
 
@@ -32,24 +35,24 @@ void semantic_analyzer_destroy(SemanticAnalyzer *analyzer)
 // 错误报告
 void semantic_error(SemanticAnalyzer *analyzer, int lineno, const char *format, ...)
 {
-    fprintf(stderr, "Semantic Error (line %d): ", lineno);
+    fprintf(analyzer->diag, "Semantic Error (line %d): ", lineno);
     va_list args;
     va_start(args, format);
-    vfprintf(stderr, format, args);
+    vfprintf(analyzer->diag, format, args);
     va_end(args);
-    fprintf(stderr, "\n");
+    fprintf(analyzer->diag, "\n");
     analyzer->error_count++;
 }
 
 // 警告报告
 void semantic_warning(SemanticAnalyzer *analyzer, int lineno, const char *format, ...)
 {
-    fprintf(stderr, "Warning (line %d): ", lineno);
+    fprintf(analyzer->diag, "Warning (line %d): ", lineno);
     va_list args;
     va_start(args, format);
-    vfprintf(stderr, format, args);
+    vfprintf(analyzer->diag, format, args);
     va_end(args);
-    fprintf(stderr, "\n");
+    fprintf(analyzer->diag, "\n");
     analyzer->warning_count++;
 }
 
@@ -113,17 +116,319 @@ TypeInfo *get_type_from_specifier(ASTNode *node)
             type->struct_name = strdup(node->children[0]->value.string_val);
         }
 
-        // 暂时不解析结构体成员，避免复杂性
-        // TODO: 完整实现结构体成员解析
-        type->struct_size = 16; // 固定大小
-        type->num_members = 0;  // 暂时没有成员信息
-
+        // 成员的布局需要查找其他结构体的定义，由 specifier_type 完成；
+        // 这里没有符号表，只得到不完整的类型
         return type;
     }
 
     return create_type(TYPE_UNKNOWN);
 }
 
+// 声明符作用在基本类型上得到的类型：指针、数组（包括多维数组和指针数组 int *arr[3]）。
+// name 返回声明的名字，declarator 可以是带初始化的 AST_ASSIGN_EXPR
+static TypeInfo *declarator_type(TypeInfo *base_type, ASTNode *declarator, const char **name)
+{
+    TypeInfo *var_type = base_type;
+    *name = NULL;
+
+    ASTNode *id_node_temp = declarator;
+    if (declarator->type == AST_ASSIGN_EXPR && declarator->num_children > 0)
+    {
+        id_node_temp = declarator->children[0];
+    }
+
+    // 处理多维数组和指针：遍历嵌套的DECLARATOR节点
+    // 使用栈来记录类型修饰符的顺序（支持指针数组 int *arr[3]）
+    typedef enum
+    {
+        MOD_POINTER,
+        MOD_ARRAY
+    } ModifierType;
+
+    typedef struct
+    {
+        ModifierType type;
+        int size; // 用于MOD_ARRAY，存储数组大小
+    } TypeModifier;
+
+    TypeModifier *modifiers = NULL;
+    int num_modifiers = 0;
+    int mod_capacity = 4;
+    modifiers = (TypeModifier *)malloc(mod_capacity * sizeof(TypeModifier));
+
+    ASTNode *current = id_node_temp;
+
+    // 遍历DECLARATOR链，收集类型修饰符（按遇到的顺序）
+    while (current && current->type == AST_DECLARATOR)
+    {
+        if (current->num_children > 0)
+        {
+            // 如果int_val == -1，这是一个指针声明
+            if (current->value.int_val == -1)
+            {
+                if (num_modifiers >= mod_capacity)
+                {
+                    mod_capacity *= 2;
+                    modifiers = (TypeModifier *)realloc(modifiers, mod_capacity * sizeof(TypeModifier));
+                }
+                modifiers[num_modifiers].type = MOD_POINTER;
+                modifiers[num_modifiers].size = 0;
+                num_modifiers++;
+
+                // 移动到子节点
+                current = current->children[0];
+            }
+            // 如果int_val > 0，这是一个数组维度；-2 是未指定大小的数组，由初始化列表补全
+            else if (current->value.int_val > 0 || current->value.int_val == -2)
+            {
+                if (num_modifiers >= mod_capacity)
+                {
+                    mod_capacity *= 2;
+                    modifiers = (TypeModifier *)realloc(modifiers, mod_capacity * sizeof(TypeModifier));
+                }
+                modifiers[num_modifiers].type = MOD_ARRAY;
+                modifiers[num_modifiers].size = current->value.int_val > 0 ? current->value.int_val : 0;
+                num_modifiers++;
+
+                // 移动到子节点
+                current = current->children[0];
+            }
+            else
+            {
+                // 其他情况（函数参数等），继续移动
+                current = current->children[0];
+            }
+        }
+        else
+        {
+            // 没有子节点，检查是否有string_val（变量名）
+            if (current->value.string_val)
+            {
+                *name = current->value.string_val;
+            }
+            break;
+        }
+    }
+
+    // 如果遍历到了IDENTIFIER
+    if (current && current->type == AST_IDENTIFIER)
+    {
+        *name = current->value.string_val;
+    }
+
+    // 按照逆序应用类型修饰符（从内到外）
+    // 例如：int *arr[3] → AST: STAR -> [3] -> arr
+    // 修饰符顺序: [POINTER, ARRAY[3]]
+    // 逆序应用: int → int[3] → (int*)[3]  即"3个int指针的数组"
+    for (int i = num_modifiers - 1; i >= 0; i--)
+    {
+        if (modifiers[i].type == MOD_POINTER)
+        {
+            var_type = create_pointer_type(var_type);
+        }
+        else if (modifiers[i].type == MOD_ARRAY)
+        {
+            var_type = create_array_type(var_type, modifiers[i].size);
+        }
+    }
+
+    // 统计数组维度和大小（用于多维数组支持）
+    int num_dimensions = 0;
+    int *array_dimensions = NULL;
+    for (int i = 0; i < num_modifiers; i++)
+    {
+        if (modifiers[i].type == MOD_ARRAY)
+        {
+            num_dimensions++;
+        }
+    }
+
+    if (num_dimensions > 0)
+    {
+        array_dimensions = (int *)malloc(num_dimensions * sizeof(int));
+        int dim_idx = 0;
+        for (int i = 0; i < num_modifiers; i++)
+        {
+            if (modifiers[i].type == MOD_ARRAY)
+            {
+                array_dimensions[dim_idx++] = modifiers[i].size;
+            }
+        }
+
+        // 存储多维数组信息到类型中
+        var_type->array_dimensions = num_dimensions;
+        var_type->array_sizes = array_dimensions;
+    }
+
+    if (modifiers)
+    {
+        free(modifiers);
+    }
+
+    // 注意：多维数组的类型已经在上面创建了
+    // 这里不需要再创建 array_size（它是旧的单维数组逻辑）
+
+    // 如果还没有变量名，尝试从原始 declarator 获取
+    if (!*name)
+    {
+        if (declarator->type == AST_IDENTIFIER)
+        {
+            *name = declarator->value.string_val;
+        }
+        else if (declarator->type == AST_DECLARATOR)
+        {
+            *name = declarator->value.string_val;
+        }
+    }
+
+    return var_type;
+}
+
+// ========== 结构体 ==========
+
+static TypeInfo *specifier_type(SemanticAnalyzer *analyzer, ASTNode *specifier);
+
+// 结构体定义登记在符号表中，名字为 "struct 标签"，和普通标识符互不冲突
+static void struct_key(const char *tag, char *buffer, size_t size)
+{
+    snprintf(buffer, size, "struct %s", tag);
+}
+
+// 按 System V 的规则布局成员：每个成员放在满足自身对齐的第一个偏移上，
+// 结构体的对齐是成员中最大的对齐，大小向上取整到对齐的倍数
+static void layout_struct(SemanticAnalyzer *analyzer, TypeInfo *type, ASTNode *body)
+{
+    int offset = 0;
+    int max_align = 1;
+    type->members = (StructMember *)calloc(body->num_children ? body->num_children : 1, sizeof(StructMember));
+    if (!type->members)
+    {
+        fprintf(stderr, "Error: Failed to allocate memory for struct members\n");
+        exit(1);
+    }
+    type->num_members = 0;
+
+    for (int i = 0; i < body->num_children; i++)
+    {
+        ASTNode *decl = body->children[i];
+        if (decl->type != AST_DECLARATION || decl->num_children < 2)
+            continue;
+        const char *name = NULL;
+        TypeInfo *member_type = declarator_type(specifier_type(analyzer, decl->children[0]), decl->children[1], &name);
+        if (!name)
+            continue;
+        if (member_type->pointer_level == 0 && member_type->base_type == TYPE_STRUCT && member_type->struct_size == 0)
+        {
+            semantic_error(analyzer, decl->lineno, "Member '%s' has incomplete type %s", name,
+                           TYPE_NAME(member_type));
+            continue;
+        }
+        for (int j = 0; j < type->num_members; j++)
+        {
+            if (strcmp(type->members[j].name, name) == 0)
+                semantic_error(analyzer, decl->lineno, "Duplicate member '%s'", name);
+        }
+
+        int align = type_alignment(member_type);
+        offset = (offset + align - 1) / align * align;
+        StructMember *member = &type->members[type->num_members++];
+        member->name = strdup(name);
+        member->type = member_type;
+        member->offset = offset;
+        offset += type_size(member_type);
+        if (align > max_align)
+            max_align = align;
+    }
+
+    type->struct_align = max_align;
+    type->struct_size = (offset + max_align - 1) / max_align * max_align;
+    if (type->struct_size == 0)
+        type->struct_size = max_align; // 空结构体（GNU 扩展）也占用空间
+}
+
+// 结构体说明符的类型：带成员表时完成布局并登记标签，只有标签时查找已登记的定义。
+// 还没有定义的标签（例如自引用的 struct Node *next）得到大小为 0 的不完整类型，
+// 访问成员时再按标签查找
+static TypeInfo *struct_type(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    const char *tag = NULL;
+    ASTNode *body = NULL;
+    for (int i = 0; i < node->num_children; i++)
+    {
+        if (node->children[i]->type == AST_IDENTIFIER)
+            tag = node->children[i]->value.string_val;
+        else if (node->children[i]->type == AST_COMPOUND_STMT)
+            body = node->children[i];
+    }
+
+    char key[256];
+    if (tag)
+        struct_key(tag, key, sizeof(key));
+
+    if (!body)
+    {
+        Symbol *definition = tag ? symbol_table_lookup(analyzer->symbol_table, key) : NULL;
+        if (definition && definition->kind == SYMBOL_STRUCT)
+            return type_clone(definition->type);
+        TypeInfo *incomplete = create_type(TYPE_STRUCT);
+        if (tag)
+            incomplete->struct_name = strdup(tag);
+        return incomplete;
+    }
+
+    TypeInfo *type = create_type(TYPE_STRUCT);
+    if (tag)
+        type->struct_name = strdup(tag);
+    layout_struct(analyzer, type, body);
+
+    if (tag)
+    {
+        Symbol *existing = symbol_table_lookup_current_scope(analyzer->symbol_table, key);
+        if (existing)
+        {
+            // 同一作用域中重复处理同一个定义（例如 struct P {...} a, b;）时保留第一次的结果
+            if (existing->declaration != node)
+                semantic_error(analyzer, node->lineno, "Redefinition of struct %s", tag);
+        }
+        else
+        {
+            Symbol *symbol = symbol_create(key, type_clone(type), SYMBOL_STRUCT);
+            symbol->declaration = node;
+            symbol_table_insert(analyzer->symbol_table, symbol);
+        }
+    }
+    return type;
+}
+
+// 说明符的类型（结构体需要符号表，其他说明符见 get_type_from_specifier）
+static TypeInfo *specifier_type(SemanticAnalyzer *analyzer, ASTNode *specifier)
+{
+    if (specifier && specifier->type == AST_STRUCT_DEF)
+        return struct_type(analyzer, specifier);
+    return get_type_from_specifier(specifier);
+}
+
+// 结构体类型的成员，不完整类型按标签查找定义；找不到时返回 NULL
+static StructMember *find_member(SemanticAnalyzer *analyzer, TypeInfo *type, const char *name)
+{
+    if (!type || type->base_type != TYPE_STRUCT)
+        return NULL;
+    if (type->num_members == 0 && type->struct_name)
+    {
+        char key[256];
+        struct_key(type->struct_name, key, sizeof(key));
+        Symbol *definition = symbol_table_lookup(analyzer->symbol_table, key);
+        if (definition && definition->kind == SYMBOL_STRUCT)
+            type = definition->type;
+    }
+    for (int i = 0; i < type->num_members; i++)
+    {
+        if (strcmp(type->members[i].name, name) == 0)
+            return &type->members[i];
+    }
+    return NULL;
+}
+
 // 类型提升：将较小的类型提升为较大的类型
 TypeInfo *promote_type(TypeInfo *type)
 {
@@ -185,6 +490,20 @@ TypeInfo *usual_arithmetic_conversion(TypeInfo *left, TypeInfo *right)
     return create_type(TYPE_INT);
 }
 
+// 指针和数组（数组名代表首元素的地址）参与地址运算
+static int is_address_type(TypeInfo *type)
+{
+    return type->pointer_level > 0 || type_is_array(type);
+}
+
+static int is_integer_type(TypeInfo *type)
+{
+    if (is_address_type(type))
+        return 0;
+    return type->base_type == TYPE_INT || type->base_type == TYPE_CHAR || type->base_type == TYPE_SHORT ||
+           type->base_type == TYPE_LONG || type->base_type == TYPE_UNSIGNED;
+}
+
 // 检查二元操作的类型
 TypeInfo *check_binary_operation(SemanticAnalyzer *analyzer, OperatorType op,
                                  TypeInfo *left, TypeInfo *right, int lineno)
@@ -208,12 +527,12 @@ TypeInfo *check_binary_operation(SemanticAnalyzer *analyzer, OperatorType op,
         if (op == OP_ADD)
         {
             // 指针 + 整数
-            if (left->pointer_level > 0 && right->base_type == TYPE_INT)
+            if (is_address_type(left) && is_integer_type(right))
             {
                 return left; // 返回指针类型
             }
             // 整数 + 指针
-            if (left->base_type == TYPE_INT && right->pointer_level > 0)
+            if (is_integer_type(left) && is_address_type(right))
             {
                 return right; // 返回指针类型
             }
@@ -223,12 +542,12 @@ TypeInfo *check_binary_operation(SemanticAnalyzer *analyzer, OperatorType op,
         if (op == OP_SUB)
         {
             // 指针 - 整数
-            if (left->pointer_level > 0 && right->base_type == TYPE_INT)
+            if (is_address_type(left) && is_integer_type(right))
             {
                 return left; // 返回指针类型
             }
             // 指针 - 指针（返回整数，表示元素个数）
-            if (left->pointer_level > 0 && right->pointer_level > 0)
+            if (is_address_type(left) && is_address_type(right))
             {
                 if (!types_compatible(left, right))
                 {
@@ -246,7 +565,7 @@ TypeInfo *check_binary_operation(SemanticAnalyzer *analyzer, OperatorType op,
         {
             semantic_error(analyzer, lineno,
                            "Invalid left operand type for arithmetic operation: %s",
-                           type_to_string(left));
+                           TYPE_NAME(left));
             return create_type(TYPE_UNKNOWN);
         }
         if (right->base_type != TYPE_INT && right->base_type != TYPE_FLOAT &&
@@ -255,7 +574,7 @@ TypeInfo *check_binary_operation(SemanticAnalyzer *analyzer, OperatorType op,
         {
             semantic_error(analyzer, lineno,
                            "Invalid right operand type for arithmetic operation: %s",
-                           type_to_string(right));
+                           TYPE_NAME(right));
             return create_type(TYPE_UNKNOWN);
         }
 
@@ -268,20 +587,20 @@ TypeInfo *check_binary_operation(SemanticAnalyzer *analyzer, OperatorType op,
         op == OP_EQ || op == OP_NE)
     {
         // 允许指针比较
-        if (left->pointer_level > 0 && right->pointer_level > 0)
+        if (is_address_type(left) && is_address_type(right))
         {
             if (!types_compatible(left, right))
             {
                 semantic_warning(analyzer, lineno,
                                  "Comparing incompatible pointer types: %s and %s",
-                                 type_to_string(left), type_to_string(right));
+                                 TYPE_NAME(left), TYPE_NAME(right));
             }
             return create_type(TYPE_INT); // 比较结果是 int (0 或 1)
         }
 
         // 允许指针与整数0（NULL）比较
-        if ((left->pointer_level > 0 && right->base_type == TYPE_INT) ||
-            (left->base_type == TYPE_INT && right->pointer_level > 0))
+        if ((is_address_type(left) && is_integer_type(right)) ||
+            (is_integer_type(left) && is_address_type(right)))
         {
             return create_type(TYPE_INT);
         }
@@ -290,7 +609,7 @@ TypeInfo *check_binary_operation(SemanticAnalyzer *analyzer, OperatorType op,
         {
             semantic_warning(analyzer, lineno,
                              "Comparing incompatible types: %s and %s",
-                             type_to_string(left), type_to_string(right));
+                             TYPE_NAME(left), TYPE_NAME(right));
         }
         return create_type(TYPE_INT); // 关系运算结果是 int (0 或 1)
     }
@@ -307,13 +626,13 @@ TypeInfo *check_binary_operation(SemanticAnalyzer *analyzer, OperatorType op,
         op == OP_LEFT_SHIFT || op == OP_RIGHT_SHIFT)
     {
         // 位运算要求两个操作数都是整数类型
-        if (left->base_type != TYPE_INT || left->pointer_level > 0)
+        if (!is_integer_type(left))
         {
             semantic_error(analyzer, lineno,
                            "Left operand of bitwise operation must be integer");
             return create_type(TYPE_UNKNOWN);
         }
-        if (right->base_type != TYPE_INT || right->pointer_level > 0)
+        if (!is_integer_type(right))
         {
             semantic_error(analyzer, lineno,
                            "Right operand of bitwise operation must be integer");
@@ -359,27 +678,8 @@ void check_assignment(SemanticAnalyzer *analyzer, ASTNode *lhs, TypeInfo *rhs_ty
     }
     else if (lhs->type == AST_MEMBER_ACCESS)
     {
-        // 结构体成员访问可以作为左值 (s.x = value)
-        // 避免递归：直接处理，不调用 analyze_expression
-        if (lhs->num_children >= 2)
-        {
-            ASTNode *struct_node = lhs->children[0];
-            if (struct_node->type == AST_IDENTIFIER)
-            {
-                Symbol *symbol = symbol_table_lookup(analyzer->symbol_table,
-                                                     struct_node->value.string_val);
-                if (symbol && symbol->type->base_type == TYPE_STRUCT)
-                {
-                    struct_node->semantic_info = (void *)symbol;
-                    lhs_type = create_type(TYPE_INT); // 简化：成员类型为int
-                }
-                else
-                {
-                    semantic_error(analyzer, lineno, "Variable is not a struct");
-                    return;
-                }
-            }
-        }
+        // 结构体成员访问可以作为左值 (s.x = value, p->x = value)
+        lhs_type = analyze_expression(analyzer, lhs);
     }
     else
     {
@@ -391,12 +691,24 @@ void check_assignment(SemanticAnalyzer *analyzer, ASTNode *lhs, TypeInfo *rhs_ty
     {
         semantic_warning(analyzer, lineno,
                          "Type mismatch in assignment: %s = %s",
-                         type_to_string(lhs_type), type_to_string(rhs_type));
+                         TYPE_NAME(lhs_type), TYPE_NAME(rhs_type));
     }
 }
 
-// 分析表达式
+static TypeInfo *expression_type(SemanticAnalyzer *analyzer, ASTNode *node);
+
+// 分析表达式。结果类型记录在节点的 semantic_info 上供代码生成使用；
+// 标识符记录的是符号，成员访问记录的是成员（StructMember），sizeof 记录的是操作数的类型
 TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    TypeInfo *type = expression_type(analyzer, node);
+    if (node && !node->semantic_info && node->type != AST_IDENTIFIER && node->type != AST_DECLARATOR &&
+        node->type != AST_MEMBER_ACCESS && node->type != AST_SIZEOF_EXPR && node->type != AST_INIT_LIST)
+        node->semantic_info = (void *)type;
+    return type;
+}
+
+static TypeInfo *expression_type(SemanticAnalyzer *analyzer, ASTNode *node)
 {
     if (!node)
         return create_type(TYPE_UNKNOWN);
@@ -407,14 +719,28 @@ TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
         return create_type(TYPE_INT);
 
     case AST_FLOAT_LITERAL:
-        return create_type(TYPE_FLOAT);
+        return create_type(node->value.float_val.is_float ? TYPE_FLOAT : TYPE_DOUBLE);
 
     case AST_SIZEOF_EXPR:
+        if (node->num_children > 0)
+        {
+            ASTNode *operand = node->children[0];
+            // sizeof(x) 在语法上和 sizeof(类型名) 无法区分，名字是变量时改回标识符
+            Symbol *symbol = operand->type == AST_TYPE_SPECIFIER && operand->value.string_val
+                                 ? symbol_table_lookup(analyzer->symbol_table, operand->value.string_val)
+                                 : NULL;
+            if (symbol && symbol->kind != SYMBOL_TYPEDEF)
+                operand->type = AST_IDENTIFIER;
+            if (operand->type == AST_TYPE_SPECIFIER || operand->type == AST_STRUCT_DEF)
+                node->semantic_info = (void *)specifier_type(analyzer, operand);
+            else
+                node->semantic_info = (void *)analyze_expression(analyzer, operand);
+        }
         // sizeof总是返回int类型（实际上是size_t，但我们简化为int）
         return create_type(TYPE_INT);
 
     case AST_STRING_LITERAL:
-        return create_type(TYPE_CHAR); // 简化：字符串视为 char
+        return create_pointer_type(create_type(TYPE_CHAR)); // 字符串字面量退化为 char *
 
     case AST_IDENTIFIER:
     {
@@ -492,16 +818,14 @@ TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
         }
         else if (node->value.op_type == OP_DEREF)
         {
-            // 解引用：返回指针指向的类型
-            if (operand_type->pointer_level == 0)
+            // 解引用：返回指针指向的类型（数组名退化为指向首元素的指针）
+            TypeInfo *deref_type = type_element(operand_type);
+            if (!deref_type)
             {
                 semantic_error(analyzer, node->lineno,
                                "Cannot dereference non-pointer type");
                 return create_type(TYPE_UNKNOWN);
             }
-            // 创建一个指针级别减1的类型
-            TypeInfo *deref_type = create_type(operand_type->base_type);
-            deref_type->pointer_level = operand_type->pointer_level - 1;
             return deref_type;
         }
         else if (node->value.op_type == OP_PREINC || node->value.op_type == OP_PREDEC ||
@@ -509,10 +833,11 @@ TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
         {
             // 递增递减运算符：检查操作数是否为左值（变量、数组元素等）
             // 返回操作数的类型
-            if (operand_type->base_type != TYPE_INT && operand_type->pointer_level == 0)
+            if (!is_integer_type(operand_type) && operand_type->base_type != TYPE_FLOAT &&
+                operand_type->base_type != TYPE_DOUBLE && operand_type->pointer_level == 0)
             {
                 semantic_warning(analyzer, node->lineno,
-                                 "Increment/decrement on non-integer/pointer type");
+                                 "Increment/decrement on non-arithmetic/pointer type");
             }
             return operand_type;
         }
@@ -583,12 +908,19 @@ TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
                 {
                     semantic_warning(analyzer, node->lineno,
                                      "Argument %d type mismatch: expected %s, got %s",
-                                     i + 1, type_to_string(param_type), type_to_string(arg_type));
+                                     i + 1, TYPE_NAME(param_type), TYPE_NAME(arg_type));
                 }
             }
+
+            // 可变参数部分不做类型检查，只分析表达式
+            for (int i = expected_params; i < actual_params && func_type->is_variadic; i++)
+            {
+                analyze_expression(analyzer, node->children[1]->children[i]);
+            }
         }
 
-        if (actual_params != expected_params)
+        if (actual_params != expected_params &&
+            !(func_type->is_variadic && actual_params > expected_params))
         {
             semantic_error(analyzer, node->lineno,
                            "Function '%s' expects %d arguments, but %d were provided",
@@ -615,61 +947,17 @@ TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
         {
             semantic_error(analyzer, node->lineno,
                            "Array subscript must be of integer type, got %s",
-                           type_to_string(index_type));
+                           TYPE_NAME(index_type));
         }
 
-        // 数组访问返回元素类型
+        // 数组访问返回元素类型（多维数组返回降低一维的数组）
         // 优先级：数组 > 指针（因为 int *arr[3] 中 [] 优先于 *）
-        TypeInfo *result_type = NULL;
-
-        if (array_type->array_size >= 0 || array_type->array_dimensions > 0)
-        {
-            // 数组类型，检查是否为多维数组
-            if (array_type->array_dimensions > 1)
-            {
-                // 多维数组：返回降低一维的数组类型
-                result_type = create_type(array_type->base_type);
-                result_type->pointer_level = array_type->pointer_level;
-                result_type->array_dimensions = array_type->array_dimensions - 1;
-
-                // 复制剩余维度的大小
-                if (result_type->array_dimensions > 0)
-                {
-                    result_type->array_sizes = (int *)malloc(result_type->array_dimensions * sizeof(int));
-                    for (int i = 0; i < result_type->array_dimensions; i++)
-                    {
-                        result_type->array_sizes[i] = array_type->array_sizes[i + 1];
-                    }
-                    // 设置第一维大小（用于代码生成）
-                    result_type->array_size = result_type->array_sizes[0];
-                }
-                else
-                {
-                    result_type->array_size = -1;
-                }
-            }
-            else
-            {
-                // 一维数组：返回元素类型
-                result_type = create_type(array_type->base_type);
-                result_type->pointer_level = array_type->pointer_level;
-                // 清除数组信息（元素不再是数组）
-                result_type->array_size = -1;
-                result_type->array_dimensions = 0;
-                result_type->array_sizes = NULL;
-            }
-        }
-        else if (array_type->pointer_level > 0)
-        {
-            // 纯指针类型（无数组），返回指针指向的类型
-            result_type = create_type(array_type->base_type);
-            result_type->pointer_level = array_type->pointer_level - 1;
-        }
-        else
+        TypeInfo *result_type = type_element(array_type);
+        if (!result_type)
         {
             semantic_error(analyzer, node->lineno,
                            "Cannot subscript non-array type: %s",
-                           type_to_string(array_type));
+                           TYPE_NAME(array_type));
             return create_type(TYPE_UNKNOWN);
         }
 
@@ -707,7 +995,7 @@ TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
         {
             semantic_warning(analyzer, node->lineno,
                              "Type mismatch in ternary branches: %s vs %s",
-                             type_to_string(true_type), type_to_string(false_type));
+                             TYPE_NAME(true_type), TYPE_NAME(false_type));
             return true_type;
         }
     }
@@ -720,49 +1008,34 @@ TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
             return create_type(TYPE_UNKNOWN);
         }
 
-        // 简化：暂时跳过完整的类型检查，直接返回int类型
-        // 这避免了可能的无限递归
-        // TODO: 实现完整的结构体成员类型检查
-
-        ASTNode *struct_node = node->children[0];
         ASTNode *member_node = node->children[1];
-
         if (member_node->type != AST_IDENTIFIER)
         {
             semantic_error(analyzer, node->lineno, "Member name must be an identifier");
             return create_type(TYPE_UNKNOWN);
         }
 
-        // 对于点运算符，检查左侧是否是标识符（结构体变量）
-        if (node->value.op_type == OP_MEMBER && struct_node->type == AST_IDENTIFIER)
+        // a.b 要求左侧是结构体，a->b 要求左侧是指向结构体的指针
+        TypeInfo *struct_type_info = analyze_expression(analyzer, node->children[0]);
+        if (node->value.op_type == OP_ARROW)
+            struct_type_info = type_element(struct_type_info);
+        if (!struct_type_info || struct_type_info->base_type != TYPE_STRUCT || struct_type_info->pointer_level > 0 ||
+            type_is_array(struct_type_info))
         {
-            // 查找结构体变量
-            Symbol *symbol = symbol_table_lookup(analyzer->symbol_table, struct_node->value.string_val);
-            if (!symbol)
-            {
-                semantic_error(analyzer, node->lineno, "Undeclared variable: %s",
-                               struct_node->value.string_val);
-                return create_type(TYPE_UNKNOWN);
-            }
-
-            // 存储符号信息
-            struct_node->semantic_info = (void *)symbol;
-
-            // 检查是否为结构体类型
-            if (symbol->type->base_type != TYPE_STRUCT)
-            {
-                semantic_error(analyzer, node->lineno,
-                               "Member access requires struct type");
-                return create_type(TYPE_UNKNOWN);
-            }
+            semantic_error(analyzer, node->lineno, "Member access requires struct type");
+            return create_type(TYPE_UNKNOWN);
+        }
 
-            // 简化：暂时所有成员都返回int类型
-            // TODO: 从结构体定义中查找真实的成员类型
-            return create_type(TYPE_INT);
+        StructMember *member = find_member(analyzer, struct_type_info, member_node->value.string_val);
+        if (!member)
+        {
+            semantic_error(analyzer, node->lineno, "No member named '%s'", member_node->value.string_val);
+            return create_type(TYPE_UNKNOWN);
         }
 
-        // 对于箭头运算符或其他复杂情况，暂时返回int
-        return create_type(TYPE_INT);
+        // 记录成员（类型和偏移），供代码生成使用
+        node->semantic_info = (void *)member;
+        return member->type;
     }
 
     case AST_INIT_LIST:
@@ -776,195 +1049,240 @@ TypeInfo *analyze_expression(SemanticAnalyzer *analyzer, ASTNode *node)
     }
 }
 
-// 分析声明
-void analyze_declaration(SemanticAnalyzer *analyzer, ASTNode *node)
+// 初始化列表（可以嵌套）的每个元素；结构体的成员类型各不相同，不检查
+static void analyze_init_list(SemanticAnalyzer *analyzer, ASTNode *list, TypeInfo *base_type, int lineno)
 {
-    if (!node || node->type != AST_DECLARATION)
+    for (int i = 0; i < list->num_children; i++)
+    {
+        ASTNode *child = list->children[i];
+        if (child->type == AST_INIT_LIST)
+        {
+            analyze_init_list(analyzer, child, base_type, lineno);
+            continue;
+        }
+        TypeInfo *elem_type = analyze_expression(analyzer, child);
+        if (base_type->base_type != TYPE_STRUCT && !types_compatible(base_type, elem_type))
+        {
+            semantic_warning(analyzer, lineno, "Array element %d type mismatch: expected %s, got %s", i,
+                             TYPE_NAME(base_type), TYPE_NAME(elem_type));
+        }
+    }
+}
+
+// 第一维未指定大小的数组：取初始化列表的元素个数
+static void complete_array_size(TypeInfo *type, ASTNode *init_expr)
+{
+    if (init_expr->type != AST_INIT_LIST || (type->array_dimensions == 0 && type->array_size != 0))
         return;
-    if (node->num_children < 2)
+    int *first = type->array_dimensions > 0 && type->array_sizes ? &type->array_sizes[type->array_dimensions - 1]
+                                                                 : &type->array_size;
+    if (*first > 0)
         return;
 
-    // 获取基本类型
-    TypeInfo *base_type = get_type_from_specifier(node->children[0]);
-
-    // 检查各种存储类和类型限定符
-    int is_extern = 0;
-    int is_const = 0;
-    int is_volatile = 0;
-
-    if (node->children[0]->lineno == -2)
+    // 内层省略了花括号时按标量个数折算（int a[][2] = {1, 2, 3, 4} 有 2 行）
+    int count = init_expr->num_children;
+    int nested = 0;
+    for (int i = 0; i < init_expr->num_children; i++)
+        nested |= init_expr->children[i]->type == AST_INIT_LIST;
+    if (!nested)
     {
-        is_extern = 1;
+        int per_element = 1;
+        for (int i = 0; i < type->array_dimensions - 1 && type->array_sizes; i++)
+            per_element *= type->array_sizes[i] > 0 ? type->array_sizes[i] : 1;
+        count = (count + per_element - 1) / per_element;
     }
-    else if (node->children[0]->lineno == -3)
-    {
-        is_const = 1;
-        base_type->is_const = 1;
-    }
-    else if (node->children[0]->lineno == -4)
-    {
-        is_volatile = 1;
-        base_type->is_volatile = 1;
-    }
-
-    // 获取声明符（可能包含初始化）
-    ASTNode *declarator = node->children[1];
-
-    // 处理指针类型和数组类型：根据 declarator 中的信息调整类型
-    TypeInfo *var_type = base_type;
-    int array_size = -1;
-    const char *var_name = NULL;
+    if (count <= 0)
+        return;
+    *first = count;
+    if (type->array_dimensions <= 1)
+        type->array_size = count;
+}
 
-    // 从 declarator 获取变量名、指针级别和数组大小
-    ASTNode *id_node_temp = declarator;
-    if (declarator->type == AST_ASSIGN_EXPR && declarator->num_children > 0)
+// 分析声明
+// 查找函数声明符（带参数列表的声明符），不是函数声明时返回 NULL
+static ASTNode *find_function_declarator(ASTNode *declarator, int *pointer_level)
+{
+    ASTNode *current = declarator;
+    *pointer_level = 0;
+    while (current && current->type == AST_DECLARATOR && current->num_children > 0)
     {
-        id_node_temp = declarator->children[0];
+        ASTNode *last = current->children[current->num_children - 1];
+        if (last->type == AST_PARAM_LIST)
+            return current;
+        if (current->value.int_val == -1)
+            (*pointer_level)++;
+        current = current->children[0];
     }
+    return NULL;
+}
 
-    // 处理多维数组和指针：遍历嵌套的DECLARATOR节点
-    // 使用栈来记录类型修饰符的顺序（支持指针数组 int *arr[3]）
-    typedef enum
+// 参数的类型：说明符加上声明符中的指针层数（数组形参 a[] / a[N] 按指针处理）。
+// name_declarator 返回带参数名的最内层声明符
+static TypeInfo *param_type_from(SemanticAnalyzer *analyzer, ASTNode *param, ASTNode **name_declarator)
+{
+    TypeInfo *type = specifier_type(analyzer, param->children[0]);
+    ASTNode *current = param->num_children >= 2 ? param->children[1] : NULL;
+    while (current && current->type == AST_DECLARATOR && current->num_children > 0 &&
+           current->children[0]->type == AST_DECLARATOR)
     {
-        MOD_POINTER,
-        MOD_ARRAY
-    } ModifierType;
+        type = create_pointer_type(type);
+        current = current->children[0];
+    }
+    if (name_declarator)
+        *name_declarator = current;
+    return type;
+}
 
-    typedef struct
-    {
-        ModifierType type;
-        int size; // 用于MOD_ARRAY，存储数组大小
-    } TypeModifier;
+// 说明符上的存储类标记（见 parser.y 的 declaration_specifiers）：
+// -1 static，-5 inline，-6 static inline
+static int specifier_is_static(ASTNode *specifier)
+{
+    return specifier->lineno == -1 || specifier->lineno == -6;
+}
 
-    TypeModifier *modifiers = NULL;
-    int num_modifiers = 0;
-    int mod_capacity = 4;
-    modifiers = (TypeModifier *)malloc(mod_capacity * sizeof(TypeModifier));
+static int specifier_is_inline(ASTNode *specifier)
+{
+    return specifier->lineno == -5 || specifier->lineno == -6;
+}
 
-    ASTNode *current = id_node_temp;
+// 函数原型声明：int printf(char *format, ...);
+static void analyze_function_prototype(SemanticAnalyzer *analyzer, ASTNode *node,
+                                       TypeInfo *return_type, ASTNode *declarator)
+{
+    const char *func_name = declarator->value.string_val;
+    Symbol *existing = symbol_table_lookup(analyzer->symbol_table, func_name);
+    if (existing && existing->kind == SYMBOL_FUNCTION)
+        return; // 重复声明或已定义
 
-    // 遍历DECLARATOR链，收集类型修饰符（按遇到的顺序）
-    while (current && current->type == AST_DECLARATOR)
+    TypeInfo *func_type = create_function_type(return_type);
+    ASTNode *param_list = declarator->children[declarator->num_children - 1];
+    for (int i = 0; i < param_list->num_children; i++)
     {
-        if (current->num_children > 0)
+        ASTNode *param = param_list->children[i];
+        if (param->type == AST_PARAM_LIST && param->value.string_val &&
+            strcmp(param->value.string_val, "...") == 0)
         {
-            // 如果int_val == -1，这是一个指针声明
-            if (current->value.int_val == -1)
-            {
-                if (num_modifiers >= mod_capacity)
-                {
-                    mod_capacity *= 2;
-                    modifiers = (TypeModifier *)realloc(modifiers, mod_capacity * sizeof(TypeModifier));
-                }
-                modifiers[num_modifiers].type = MOD_POINTER;
-                modifiers[num_modifiers].size = 0;
-                num_modifiers++;
-
-                // 移动到子节点
-                current = current->children[0];
-            }
-            // 如果int_val > 0，这是一个数组维度
-            else if (current->value.int_val > 0)
-            {
-                if (num_modifiers >= mod_capacity)
-                {
-                    mod_capacity *= 2;
-                    modifiers = (TypeModifier *)realloc(modifiers, mod_capacity * sizeof(TypeModifier));
-                }
-                modifiers[num_modifiers].type = MOD_ARRAY;
-                modifiers[num_modifiers].size = current->value.int_val;
-                num_modifiers++;
-
-                // 移动到子节点
-                current = current->children[0];
-            }
-            else
-            {
-                // 其他情况（函数参数等），继续移动
-                current = current->children[0];
-            }
+            func_type->is_variadic = 1;
         }
-        else
+        else if (param->type == AST_DECLARATION && param->num_children >= 1)
         {
-            // 没有子节点，检查是否有string_val（变量名）
-            if (current->value.string_val)
-            {
-                var_name = current->value.string_val;
-            }
-            break;
+            add_param_type(func_type, param_type_from(analyzer, param, NULL));
         }
     }
 
-    // 如果遍历到了IDENTIFIER
-    if (current && current->type == AST_IDENTIFIER)
+    Symbol *func_symbol = symbol_create(func_name, func_type, SYMBOL_FUNCTION);
+    func_symbol->declaration = node;
+    func_symbol->is_defined = 0;
+    if (specifier_is_static(node->children[0]))
     {
-        var_name = current->value.string_val;
+        func_symbol->is_static = 1;
+        func_symbol->label = strdup(func_name);
     }
-
-    // 按照逆序应用类型修饰符（从内到外）
-    // 例如：int *arr[3] → AST: STAR -> [3] -> arr
-    // 修饰符顺序: [POINTER, ARRAY[3]]
-    // 逆序应用: int → int[3] → (int*)[3]  即"3个int指针的数组"
-    for (int i = num_modifiers - 1; i >= 0; i--)
+    func_symbol->is_inline = specifier_is_inline(node->children[0]);
+    if (!symbol_table_insert(analyzer->symbol_table, func_symbol))
     {
-        if (modifiers[i].type == MOD_POINTER)
-        {
-            var_type = create_pointer_type(var_type);
-        }
-        else if (modifiers[i].type == MOD_ARRAY)
-        {
-            var_type = create_array_type(var_type, modifiers[i].size);
-        }
+        semantic_error(analyzer, node->lineno, "'%s' redeclared as a function", func_name);
     }
+}
 
-    // 统计数组维度和大小（用于多维数组支持）
-    int num_dimensions = 0;
-    int *array_dimensions = NULL;
-    for (int i = 0; i < num_modifiers; i++)
+// 能放进 .data 段的类型（标量、指针、数组和完整的结构体）
+static int has_static_storage_type(TypeInfo *type)
+{
+    if (!type)
+        return 0;
+    if (type->pointer_level > 0)
+        return 1;
+    switch (type->base_type)
     {
-        if (modifiers[i].type == MOD_ARRAY)
-        {
-            num_dimensions++;
-        }
+    case TYPE_STRUCT:
+        return type->struct_size > 0;
+    case TYPE_INT:
+    case TYPE_CHAR:
+    case TYPE_SHORT:
+    case TYPE_LONG:
+    case TYPE_UNSIGNED:
+    case TYPE_FLOAT:
+    case TYPE_DOUBLE:
+        return 1;
+    default:
+        return 0;
     }
+}
 
-    if (num_dimensions > 0)
-    {
-        array_dimensions = (int *)malloc(num_dimensions * sizeof(int));
-        int dim_idx = 0;
-        for (int i = 0; i < num_modifiers; i++)
-        {
-            if (modifiers[i].type == MOD_ARRAY)
-            {
-                array_dimensions[dim_idx++] = modifiers[i].size;
-            }
-        }
+// 为全局变量、静态变量和 extern 变量分配标签，代码生成时通过 label(%rip) 访问。
+// 局部静态变量的标签加上编号（count.0），避免和其他函数中的同名变量冲突
+static void assign_static_storage(SemanticAnalyzer *analyzer, Symbol *symbol, ASTNode *specifier)
+{
+    if (!has_static_storage_type(symbol->type))
+        return;
 
-        // 存储多维数组信息到类型中
-        var_type->array_dimensions = num_dimensions;
-        var_type->array_sizes = array_dimensions;
+    int is_static = specifier_is_static(specifier);
+    if (!analyzer->in_function || symbol->is_extern)
+    {
+        symbol->is_global = !is_static;
+        symbol->is_static = is_static;
+        symbol->label = strdup(symbol->name);
+    }
+    else if (is_static)
+    {
+        char label[256];
+        snprintf(label, sizeof(label), "%s.%d", symbol->name, analyzer->static_counter++);
+        symbol->is_static = 1;
+        symbol->label = strdup(label);
     }
+}
 
-    if (modifiers)
+void analyze_declaration(SemanticAnalyzer *analyzer, ASTNode *node)
+{
+    if (!node || node->type != AST_DECLARATION)
+        return;
+    if (node->num_children < 2)
+        return;
+
+    // 函数原型（只声明不定义，例如 stdlib 中的函数）
+    int return_pointer_level;
+    ASTNode *func_declarator = find_function_declarator(node->children[1], &return_pointer_level);
+    if (func_declarator)
     {
-        free(modifiers);
+        TypeInfo *return_type = specifier_type(analyzer, node->children[0]);
+        for (int i = 0; i < return_pointer_level; i++)
+            return_type = create_pointer_type(return_type);
+        analyze_function_prototype(analyzer, node, return_type, func_declarator);
+        return;
     }
 
-    // 注意：多维数组的类型已经在上面创建了
-    // 这里不需要再创建 array_size（它是旧的单维数组逻辑）
+    // 获取基本类型
+    TypeInfo *base_type = specifier_type(analyzer, node->children[0]);
 
-    // 如果还没有变量名，尝试从原始 declarator 获取
-    if (!var_name)
+    // 检查各种存储类和类型限定符
+    int is_extern = 0;
+    int is_const = 0;
+    int is_volatile = 0;
+
+    if (node->children[0]->lineno == -2)
     {
-        if (declarator->type == AST_IDENTIFIER)
-        {
-            var_name = declarator->value.string_val;
-        }
-        else if (declarator->type == AST_DECLARATOR)
-        {
-            var_name = declarator->value.string_val;
-        }
+        is_extern = 1;
+    }
+    else if (node->children[0]->lineno == -3)
+    {
+        is_const = 1;
+        base_type->is_const = 1;
     }
+    else if (node->children[0]->lineno == -4)
+    {
+        is_volatile = 1;
+        base_type->is_volatile = 1;
+    }
+
+    // 获取声明符（可能包含初始化）
+    ASTNode *declarator = node->children[1];
+
+    // 处理指针类型和数组类型：根据 declarator 中的信息调整类型
+    TypeInfo *var_type;
+    int array_size = -1;
+    const char *var_name = NULL;
+
+    var_type = declarator_type(base_type, declarator, &var_name);
 
     // 确保有变量名
     if (!var_name)
@@ -979,10 +1297,21 @@ void analyze_declaration(SemanticAnalyzer *analyzer, ASTNode *node)
         if (declarator->num_children < 2)
             return;
 
+        // 检查初始化表达式的类型
+        ASTNode *init_expr = declarator->children[1];
+
+        // 省略了第一维的数组（int a[] = {1, 2, 3}）由初始化列表确定大小
+        complete_array_size(var_type, init_expr);
+        if (type_is_array(var_type))
+            array_size = var_type->array_dimensions > 0 && var_type->array_sizes
+                             ? var_type->array_sizes[var_type->array_dimensions - 1]
+                             : var_type->array_size;
+
         // 创建并插入符号
         Symbol *symbol = symbol_create(var_name, var_type, SYMBOL_VARIABLE);
         symbol->declaration = node;
         symbol->is_extern = is_extern;
+        assign_static_storage(analyzer, symbol, node->children[0]);
 
         if (!symbol_table_insert(analyzer->symbol_table, symbol))
         {
@@ -993,9 +1322,6 @@ void analyze_declaration(SemanticAnalyzer *analyzer, ASTNode *node)
         // 存储符号信息到 AST 节点
         declarator->children[0]->semantic_info = (void *)symbol;
 
-        // 检查初始化表达式的类型
-        ASTNode *init_expr = declarator->children[1];
-
         // 对于数组，检查初始化列表
         if (init_expr->type == AST_INIT_LIST)
         {
@@ -1005,16 +1331,7 @@ void analyze_declaration(SemanticAnalyzer *analyzer, ASTNode *node)
                                  "Too many initializers for array of size %d", array_size);
             }
             // 检查每个初始化元素的类型
-            for (int i = 0; i < init_expr->num_children; i++)
-            {
-                TypeInfo *elem_type = analyze_expression(analyzer, init_expr->children[i]);
-                if (!types_compatible(base_type, elem_type))
-                {
-                    semantic_warning(analyzer, node->lineno,
-                                     "Array element %d type mismatch: expected %s, got %s",
-                                     i, type_to_string(base_type), type_to_string(elem_type));
-                }
-            }
+            analyze_init_list(analyzer, init_expr, base_type, node->lineno);
         }
         else
         {
@@ -1023,7 +1340,7 @@ void analyze_declaration(SemanticAnalyzer *analyzer, ASTNode *node)
             {
                 semantic_warning(analyzer, node->lineno,
                                  "Type mismatch in initialization: %s = %s",
-                                 type_to_string(var_type), type_to_string(init_type));
+                                 TYPE_NAME(var_type), TYPE_NAME(init_type));
             }
         }
     }
@@ -1033,6 +1350,7 @@ void analyze_declaration(SemanticAnalyzer *analyzer, ASTNode *node)
         Symbol *symbol = symbol_create(var_name, var_type, SYMBOL_VARIABLE);
         symbol->declaration = node;
         symbol->is_extern = is_extern;
+        assign_static_storage(analyzer, symbol, node->children[0]);
 
         if (!symbol_table_insert(analyzer->symbol_table, symbol))
         {
@@ -1151,13 +1469,11 @@ void analyze_statement(SemanticAnalyzer *analyzer, ASTNode *node)
         }
         analyzer->loop_depth--;
 
-        // 注意：对于 C99 for 循环，我们不立即退出作用域
-        // 因为代码生成阶段还需要访问循环变量的符号信息
-        // 作用域会在函数结束时统一清理
-        // if (has_init_decl)
-        // {
-        //     exit_scope(analyzer->symbol_table);
-        // }
+        // 退出的作用域由符号表保留到销毁，代码生成阶段仍可访问循环变量的符号
+        if (has_init_decl)
+        {
+            exit_scope(analyzer->symbol_table);
+        }
         break;
     }
 
@@ -1239,7 +1555,7 @@ void analyze_function(SemanticAnalyzer *analyzer, ASTNode *node)
         return;
 
     // 获取返回类型
-    TypeInfo *return_type = get_type_from_specifier(node->children[0]);
+    TypeInfo *return_type = specifier_type(analyzer, node->children[0]);
 
     // 获取函数名
     ASTNode *declarator = node->children[1];
@@ -1248,19 +1564,41 @@ void analyze_function(SemanticAnalyzer *analyzer, ASTNode *node)
     // 创建函数类型
     TypeInfo *func_type = create_function_type(return_type);
 
-    // 创建函数符号
-    Symbol *func_symbol = symbol_create(func_name, func_type, SYMBOL_FUNCTION);
-    func_symbol->declaration = node;
-    func_symbol->is_defined = 1;
+    // 之前有原型声明时复用该符号，否则创建函数符号
+    Symbol *func_symbol = symbol_table_lookup_current_scope(analyzer->symbol_table, func_name);
+    if (func_symbol && func_symbol->kind == SYMBOL_FUNCTION && !func_symbol->is_defined)
+    {
+        func_symbol->type = func_type;
+        func_symbol->declaration = node;
+        func_symbol->is_defined = 1;
+    }
+    else
+    {
+        func_symbol = symbol_create(func_name, func_type, SYMBOL_FUNCTION);
+        func_symbol->declaration = node;
+        func_symbol->is_defined = 1;
 
-    // 插入到全局作用域
-    if (!symbol_table_insert(analyzer->symbol_table, func_symbol))
+        // 插入到全局作用域
+        if (!symbol_table_insert(analyzer->symbol_table, func_symbol))
+        {
+            semantic_error(analyzer, node->lineno, "Function '%s' already declared", func_name);
+        }
+    }
+
+    // static 函数只在本文件内可见
+    if (specifier_is_static(node->children[0]) && !func_symbol->is_static)
     {
-        semantic_error(analyzer, node->lineno, "Function '%s' already declared", func_name);
+        func_symbol->is_static = 1;
+        func_symbol->label = strdup(func_name);
     }
+    // inline 可以只写在原型或定义上
+    if (specifier_is_inline(node->children[0]))
+        func_symbol->is_inline = 1;
+    declarator->semantic_info = (void *)func_symbol;
 
     // 进入函数作用域
     enter_scope(analyzer->symbol_table);
+    analyzer->in_function = 1;
 
     // 处理函数参数
     if (declarator->num_children > 0 && declarator->children[0]->type == AST_PARAM_LIST)
@@ -1276,15 +1614,16 @@ void analyze_function(SemanticAnalyzer *analyzer, ASTNode *node)
                 strcmp(param->value.string_val, "...") == 0)
             {
                 // 可变参数，跳过但标记函数为可变参数
-                // TODO: 可以在func_type中添加is_variadic标志
+                func_type->is_variadic = 1;
                 continue;
             }
 
             if (param->type == AST_DECLARATION && param->num_children >= 2)
             {
-                TypeInfo *param_type = get_type_from_specifier(param->children[0]);
+                ASTNode *name_declarator = NULL;
+                TypeInfo *param_type = param_type_from(analyzer, param, &name_declarator);
                 ASTNode *param_declarator = param->children[1];
-                const char *param_name = param_declarator->value.string_val;
+                const char *param_name = name_declarator->value.string_val;
 
                 // 创建参数符号
                 Symbol *param_symbol = symbol_create(param_name, param_type, SYMBOL_PARAMETER);
@@ -1320,8 +1659,12 @@ void analyze_function(SemanticAnalyzer *analyzer, ASTNode *node)
         }
     }
 
-    // 不要退出作用域 - 让符号在代码生成时可用
-    // exit_scope(analyzer->symbol_table);
+    analyzer->in_function = 0;
+
+    // 函数作用域的偏移量是所有嵌套块的最高水位，即局部变量需要的栈空间。
+    // 退出后符号仍保留在符号表中，代码生成时可用
+    func_symbol->frame_size = analyzer->symbol_table->current_scope->next_offset;
+    exit_scope(analyzer->symbol_table);
 }
 
 // 分析程序
@@ -1346,8 +1689,8 @@ int analyze_program(SemanticAnalyzer *analyzer, ASTNode *root)
         }
         else if (child->type == AST_STRUCT_DEF)
         {
-            // 结构体定义 - 暂时跳过，不进行语义分析
-            // TODO: 实现完整的结构体类型检查
+            // 结构体定义：布局成员并登记标签
+            free_type(struct_type(analyzer, child));
         }
         else if (child->type == AST_TYPEDEF)
         {
@@ -1360,7 +1703,7 @@ int analyze_program(SemanticAnalyzer *analyzer, ASTNode *root)
                 if (type_node && name_node && name_node->type == AST_IDENTIFIER)
                 {
                     const char *alias_name = name_node->value.string_val;
-                    TypeInfo *base_type = get_type_from_specifier(type_node);
+                    TypeInfo *base_type = specifier_type(analyzer, type_node);
 
                     // 创建符号作为typedef
                     Symbol *symbol = symbol_create(alias_name, base_type, SYMBOL_TYPEDEF);
@@ -24,7 +24,9 @@ Symbol *symbol_create(const char *name, TypeInfo *type, SymbolKind kind)
     symbol->is_static = 0;
     symbol->is_global = 0;
     symbol->is_extern = 0;
+    symbol->is_inline = 0;
     symbol->label = NULL;
+    symbol->frame_size = 0;
     return symbol;
 }
 
@@ -49,6 +51,7 @@ static Scope *scope_create(Scope *parent, int level)
     scope->level = level;
     // 继承父作用域的偏移量，这样嵌套作用域的变量不会覆盖外层变量
     scope->next_offset = parent ? parent->next_offset : 0;
+    scope->next_retired = NULL;
     return scope;
 }
 
@@ -61,6 +64,7 @@ static void scope_destroy(Scope *scope)
     for (int i = 0; i < scope->num_symbols; i++)
     {
         free(scope->symbols[i]->name);
+        free(scope->symbols[i]->label);
         // 只释放非参数符号的类型
         // 参数类型已经在函数类型的 param_types 中，会在函数符号释放时一起释放
         if (scope->symbols[i]->kind != SYMBOL_PARAMETER)
@@ -85,8 +89,10 @@ SymbolTable *symbol_table_create()
 
     table->global_scope = scope_create(NULL, 0);
     table->current_scope = table->global_scope;
+    table->retired_scopes = NULL;
     table->current_level = 0;
     table->has_errors = 0;
+    table->diag = stderr;
 
     return table;
 }
@@ -105,6 +111,12 @@ void symbol_table_destroy(SymbolTable *table)
         scope_destroy(scope);
         scope = parent;
     }
+    while (table->retired_scopes)
+    {
+        Scope *next = table->retired_scopes->next_retired;
+        scope_destroy(table->retired_scopes);
+        table->retired_scopes = next;
+    }
 
     free(table);
 }
@@ -130,7 +142,8 @@ void exit_scope(SymbolTable *table)
     Scope *parent = old_scope->parent;
 
     // 更新父作用域的偏移量，反映子作用域占用的栈空间
-    if (parent)
+    // （函数作用域退出到全局作用域时不需要，下一个函数从 0 开始分配）
+    if (parent && parent->level > 0)
     {
         parent->next_offset = old_scope->next_offset;
     }
@@ -138,7 +151,9 @@ void exit_scope(SymbolTable *table)
     table->current_scope = parent;
     table->current_level--;
 
-    scope_destroy(old_scope);
+    // AST 的 semantic_info 仍指向块内的符号，代码生成结束前不能释放
+    old_scope->next_retired = table->retired_scopes;
+    table->retired_scopes = old_scope;
 }
 
 // 在当前作用域查找符号
@@ -190,7 +205,7 @@ int symbol_table_insert(SymbolTable *table, Symbol *symbol)
     // 检查当前作用域是否已存在同名符号
     if (symbol_table_lookup_current_scope(table, symbol->name))
     {
-        fprintf(stderr, "Error: Symbol '%s' already declared in current scope\n",
+        fprintf(table->diag, "Error: Symbol '%s' already declared in current scope\n",
                 symbol->name);
         table->has_errors = 1;
         return 0;
@@ -214,30 +229,15 @@ int symbol_table_insert(SymbolTable *table, Symbol *symbol)
     // 设置符号属性
     symbol->scope_level = scope->level;
 
-    // 为变量分配偏移量
+    // 为变量分配偏移量：对象占据 [rbp - offset, rbp - offset + size)，起始地址按类型对齐
     if (symbol->kind == SYMBOL_VARIABLE || symbol->kind == SYMBOL_PARAMETER)
     {
+        int size = type_size(symbol->type);
+        int align = type_alignment(symbol->type);
+        if (size <= 0)
+            size = 1;
+        scope->next_offset = (scope->next_offset + size + align - 1) / align * align;
         symbol->offset = scope->next_offset;
-
-        // 计算变量所需的空间
-        int var_size = 8; // 默认 8 字节（int, float, 指针）
-
-        if (symbol->type)
-        {
-            // 如果是数组，分配 array_size * element_size
-            if (symbol->type->array_size > 0)
-            {
-                int element_size = 8; // 假设元素大小为 8 字节
-                var_size = symbol->type->array_size * element_size;
-            }
-            // 如果是结构体，使用结构体大小
-            else if (symbol->type->base_type == TYPE_STRUCT && symbol->type->struct_size > 0)
-            {
-                var_size = symbol->type->struct_size;
-            }
-        }
-
-        scope->next_offset += var_size;
     }
 
     // 添加到作用域
@@ -274,10 +274,16 @@ void print_scope(Scope *scope, int indent)
         case SYMBOL_PARAMETER:
             kind_str = "param";
             break;
+        case SYMBOL_TYPEDEF:
+            kind_str = "typedef";
+            break;
+        case SYMBOL_STRUCT:
+            kind_str = "struct";
+            break;
         }
 
         printf("- %s: %s (%s), offset=%d\n",
-               sym->name, type_to_string(sym->type), kind_str, sym->offset);
+               sym->name, TYPE_NAME(sym->type), kind_str, sym->offset);
     }
 }
 
@@ -22,10 +22,12 @@ TypeInfo *create_type(DataType base_type)
     type->return_type = NULL;
     type->param_types = NULL;
     type->num_params = 0;
+    type->is_variadic = 0;
     type->struct_name = NULL;
     type->members = NULL;
     type->num_members = 0;
     type->struct_size = 0;
+    type->struct_align = 0;
     return type;
 }
 
@@ -114,94 +116,100 @@ int types_compatible(TypeInfo *t1, TypeInfo *t2)
         {
             return 1; // 数值类型间可以转换
         }
+        // 指针和整数之间（空指针常量 0）
+        if ((t1->pointer_level > 0 && t2_is_numeric && t2->pointer_level == 0) ||
+            (t2->pointer_level > 0 && t1_is_numeric && t1->pointer_level == 0))
+        {
+            return 1;
+        }
         return 0;
     }
 
-    // 指针层级必须相同
-    if (t1->pointer_level != t2->pointer_level)
+    // 指针层级必须相同（数组退化为指针，数组大小可以不同）
+    int level1 = t1->pointer_level + (t1->array_size > 0 || t1->array_dimensions > 0);
+    int level2 = t2->pointer_level + (t2->array_size > 0 || t2->array_dimensions > 0);
+    if (level1 != level2)
     {
         return 0;
     }
 
-    // 数组大小可以不同（数组退化为指针）
-
     return 1;
 }
 
-// 将类型转换为字符串（用于调试）
-const char *type_to_string(TypeInfo *type)
+// 将类型转换为字符串（用于调试和诊断），结果写入调用者的缓冲区
+const char *type_to_string(TypeInfo *type, char *buffer, size_t size)
 {
-    static char buffer[256];
-
     if (!type)
     {
-        return "null";
+        snprintf(buffer, size, "null");
+        return buffer;
     }
 
     switch (type->base_type)
     {
     case TYPE_INT:
-        strcpy(buffer, "int");
+        snprintf(buffer, size, "int");
         break;
     case TYPE_FLOAT:
-        strcpy(buffer, "float");
+        snprintf(buffer, size, "float");
         break;
     case TYPE_CHAR:
-        strcpy(buffer, "char");
+        snprintf(buffer, size, "char");
         break;
     case TYPE_VOID:
-        strcpy(buffer, "void");
+        snprintf(buffer, size, "void");
         break;
     case TYPE_SHORT:
-        strcpy(buffer, "short");
+        snprintf(buffer, size, "short");
         break;
     case TYPE_LONG:
-        strcpy(buffer, "long");
+        snprintf(buffer, size, "long");
         break;
     case TYPE_DOUBLE:
-        strcpy(buffer, "double");
+        snprintf(buffer, size, "double");
         break;
     case TYPE_UNSIGNED:
-        strcpy(buffer, "unsigned");
+        snprintf(buffer, size, "unsigned");
         break;
     case TYPE_FUNCTION:
         if (type->return_type)
         {
-            snprintf(buffer, sizeof(buffer), "function()->%s",
-                     type_to_string(type->return_type));
+            char return_name[TYPE_NAME_SIZE];
+            snprintf(buffer, size, "function()->%s",
+                     type_to_string(type->return_type, return_name, sizeof(return_name)));
         }
         else
         {
-            strcpy(buffer, "function");
+            snprintf(buffer, size, "function");
         }
         return buffer;
     case TYPE_STRUCT:
         if (type->struct_name)
         {
-            snprintf(buffer, sizeof(buffer), "struct %s", type->struct_name);
+            snprintf(buffer, size, "struct %s", type->struct_name);
         }
         else
         {
-            strcpy(buffer, "struct");
+            snprintf(buffer, size, "struct");
         }
-        return buffer;
+        break;
     default:
-        strcpy(buffer, "unknown");
+        snprintf(buffer, size, "unknown");
         break;
     }
 
     // 添加指针标记
-    for (int i = 0; i < type->pointer_level; i++)
+    size_t length = strlen(buffer);
+    for (int i = 0; i < type->pointer_level && length + 1 < size; i++)
     {
-        strcat(buffer, "*");
+        buffer[length++] = '*';
+        buffer[length] = '\0';
     }
 
     // 添加数组标记
     if (type->array_size >= 0)
     {
-        char temp[32];
-        snprintf(temp, sizeof(temp), "[%d]", type->array_size);
-        strcat(buffer, temp);
+        snprintf(buffer + length, size - length, "[%d]", type->array_size);
     }
 
     return buffer;
@@ -255,3 +263,137 @@ void free_type(TypeInfo *type)
 
     free(type);
 }
+
+static void *copy_memory(const void *source, size_t size)
+{
+    void *copy = malloc(size ? size : 1);
+    if (!copy)
+    {
+        fprintf(stderr, "Error: Failed to allocate memory for type copy\n");
+        exit(1);
+    }
+    memcpy(copy, source, size);
+    return copy;
+}
+
+// 深拷贝类型信息
+TypeInfo *type_clone(TypeInfo *type)
+{
+    if (!type)
+        return NULL;
+
+    TypeInfo *copy = (TypeInfo *)copy_memory(type, sizeof(TypeInfo));
+    copy->array_sizes = NULL;
+    if (type->array_sizes && type->array_dimensions > 0)
+        copy->array_sizes = (int *)copy_memory(type->array_sizes, type->array_dimensions * sizeof(int));
+    copy->return_type = type_clone(type->return_type);
+    if (type->param_types)
+    {
+        copy->param_types = (TypeInfo **)copy_memory(type->param_types, type->num_params * sizeof(TypeInfo *));
+        for (int i = 0; i < type->num_params; i++)
+            copy->param_types[i] = type_clone(type->param_types[i]);
+    }
+    if (type->struct_name)
+        copy->struct_name = strdup(type->struct_name);
+    if (type->members)
+    {
+        copy->members = (StructMember *)copy_memory(type->members, type->num_members * sizeof(StructMember));
+        for (int i = 0; i < type->num_members; i++)
+        {
+            copy->members[i].name = type->members[i].name ? strdup(type->members[i].name) : NULL;
+            copy->members[i].type = type_clone(type->members[i].type);
+        }
+    }
+    return copy;
+}
+
+int type_is_array(TypeInfo *type)
+{
+    return type && (type->array_size > 0 || type->array_dimensions > 0);
+}
+
+// 去掉数组维度后的大小
+static int scalar_size(TypeInfo *type)
+{
+    if (type->pointer_level > 0)
+        return 8;
+    switch (type->base_type)
+    {
+    case TYPE_CHAR:
+    case TYPE_VOID: // GNU 扩展：void * 的算术按 1 字节
+        return 1;
+    case TYPE_SHORT:
+        return 2;
+    case TYPE_INT:
+    case TYPE_UNSIGNED:
+    case TYPE_FLOAT:
+        return 4;
+    case TYPE_STRUCT:
+        return type->struct_size;
+    default:
+        return 8;
+    }
+}
+
+int type_size(TypeInfo *type)
+{
+    if (!type)
+        return 8;
+    int size = scalar_size(type);
+    if (type->array_dimensions > 0 && type->array_sizes)
+    {
+        for (int i = 0; i < type->array_dimensions; i++)
+            size *= type->array_sizes[i] > 0 ? type->array_sizes[i] : 1;
+    }
+    else if (type->array_size > 0)
+    {
+        size *= type->array_size;
+    }
+    return size;
+}
+
+// 数组的对齐和元素相同
+int type_alignment(TypeInfo *type)
+{
+    if (!type)
+        return 8;
+    if (type->pointer_level == 0 && type->base_type == TYPE_STRUCT)
+        return type->struct_align > 0 ? type->struct_align : 1;
+    int size = scalar_size(type);
+    return size > 0 ? size : 1;
+}
+
+int type_is_unsigned(TypeInfo *type)
+{
+    return type && type->pointer_level == 0 && !type_is_array(type) && type->base_type == TYPE_UNSIGNED;
+}
+
+TypeInfo *type_element(TypeInfo *type)
+{
+    if (!type)
+        return NULL;
+    if (type_is_array(type))
+    {
+        TypeInfo *element = type_clone(type);
+        if (element->array_dimensions > 1 && element->array_sizes)
+        {
+            // array_sizes 按声明符从内到外记录（int a[2][3] → {3, 2}），第一维在最后
+            element->array_dimensions--;
+        }
+        else
+        {
+            free(element->array_sizes);
+            element->array_sizes = NULL;
+            element->array_dimensions = 0;
+            element->array_size = -1;
+        }
+        return element;
+    }
+    if (type->pointer_level > 0)
+    {
+        TypeInfo *element = type_clone(type);
+        element->pointer_level--;
+        return element;
+    }
+    return NULL;
+}
@@ -0,0 +1,232 @@
+#include "vc.h"
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "ast.h"
+#include "semantic.h"
+#include "codegen.h"
+#include "preprocessor.h"
+#include "parser.h"
+#include "assembler.h"
+#include "elf_writer.h"
+
+struct vc_context
+{
+    char **macro_names;    // -D 宏定义
+    char **macro_values;
+    int num_macros;
+    char **include_paths;  // 额外的 include 路径
+    int num_include_paths;
+    char *diagnostics;     // 最近一次编译的诊断输出
+    size_t diagnostics_size;
+};
+
+static char *copy_string(const char *text)
+{
+    char *copy = strdup(text ? text : "");
+    if (!copy)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    return copy;
+}
+
+static void append_string(char ***list, int *count, const char *text)
+{
+    *list = (char **)realloc(*list, sizeof(char *) * (*count + 1));
+    if (!*list)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    (*list)[(*count)++] = copy_string(text);
+}
+
+vc_context *vc_context_create(void)
+{
+    vc_context *ctx = (vc_context *)calloc(1, sizeof(vc_context));
+    if (!ctx)
+        return NULL;
+    ctx->diagnostics = copy_string("");
+    return ctx;
+}
+
+void vc_context_destroy(vc_context *ctx)
+{
+    if (!ctx)
+        return;
+    for (int i = 0; i < ctx->num_macros; i++)
+    {
+        free(ctx->macro_names[i]);
+        free(ctx->macro_values[i]);
+    }
+    for (int i = 0; i < ctx->num_include_paths; i++)
+        free(ctx->include_paths[i]);
+    free(ctx->macro_names);
+    free(ctx->macro_values);
+    free(ctx->include_paths);
+    free(ctx->diagnostics);
+    free(ctx);
+}
+
+void vc_context_define(vc_context *ctx, const char *name, const char *value)
+{
+    int count = ctx->num_macros;
+    append_string(&ctx->macro_names, &count, name);
+    count = ctx->num_macros;
+    append_string(&ctx->macro_values, &count, value ? value : "1");
+    ctx->num_macros = count;
+}
+
+void vc_context_add_include_path(vc_context *ctx, const char *path)
+{
+    append_string(&ctx->include_paths, &ctx->num_include_paths, path);
+}
+
+const char *vc_context_diagnostics(vc_context *ctx)
+{
+    return ctx->diagnostics ? ctx->diagnostics : "";
+}
+
+// 预处理 → 语法分析 → 语义分析 → 代码生成，汇编代码写入 out
+static int compile_source(vc_context *ctx, const char *source, size_t length,
+                          const char *filename, FILE *out, FILE *diag)
+{
+    // preprocessor_process 需要以 '\0' 结尾的输入
+    char *input = (char *)malloc(length + 1);
+    if (!input)
+    {
+        fprintf(stderr, "Out of memory\n");
+        exit(1);
+    }
+    memcpy(input, source, length);
+    input[length] = '\0';
+
+    Preprocessor *pp = preprocessor_create();
+    if (!pp)
+    {
+        free(input);
+        fprintf(diag, "Cannot create preprocessor\n");
+        return 1;
+    }
+    pp->diag = diag;
+    for (int i = 0; i < ctx->num_include_paths; i++)
+        preprocessor_add_include_path(pp, ctx->include_paths[i]);
+    for (int i = 0; i < ctx->num_macros; i++)
+        preprocessor_define_macro(pp, ctx->macro_names[i], ctx->macro_values[i]);
+
+    char *preprocessed = preprocessor_process(pp, input, filename ? filename : "<input>");
+    preprocessor_free(pp);
+    free(input);
+    if (!preprocessed)
+    {
+        fprintf(diag, "Preprocessing failed\n");
+        return 1;
+    }
+
+    ASTNode *ast_root = NULL;
+    int parse_result = parse_buffer(preprocessed, strlen(preprocessed), diag, &ast_root);
+    free(preprocessed);
+    if (parse_result != 0 || !ast_root)
+    {
+        fprintf(diag, "Parsing failed\n");
+        if (ast_root)
+            free_ast(ast_root);
+        return 1;
+    }
+
+    SemanticAnalyzer *analyzer = semantic_analyzer_create();
+    analyzer->diag = diag;
+    analyzer->symbol_table->diag = diag;
+    analyze_program(analyzer, ast_root);
+    if (analyzer->error_count > 0)
+    {
+        fprintf(diag, "Semantic analysis failed with %d error(s)\n", analyzer->error_count);
+        semantic_analyzer_destroy(analyzer);
+        free_ast(ast_root);
+        return 1;
+    }
+
+    CodeGenerator *gen = codegen_create(out, analyzer);
+    generate_code(gen, ast_root);
+    codegen_destroy(gen);
+    semantic_analyzer_destroy(analyzer);
+    free_ast(ast_root);
+    return 0;
+}
+
+// 开始一次编译：清空上次的诊断信息，返回写入诊断的内存流
+static FILE *begin_compile(vc_context *ctx)
+{
+    free(ctx->diagnostics);
+    ctx->diagnostics = NULL;
+    ctx->diagnostics_size = 0;
+    return open_memstream(&ctx->diagnostics, &ctx->diagnostics_size);
+}
+
+int vc_compile_to_assembly(vc_context *ctx, const char *source, size_t length,
+                           const char *filename, char **asm_text, size_t *asm_size)
+{
+    *asm_text = NULL;
+    *asm_size = 0;
+    FILE *diag = begin_compile(ctx);
+    if (!diag)
+        return 1;
+
+    char *text = NULL;
+    size_t size = 0;
+    FILE *out = open_memstream(&text, &size);
+    int result = out ? compile_source(ctx, source, length, filename, out, diag) : 1;
+    if (out)
+        fclose(out);
+    fclose(diag);
+
+    if (result != 0)
+    {
+        free(text);
+        return result;
+    }
+    *asm_text = text;
+    *asm_size = size;
+    return 0;
+}
+
+int vc_compile_to_object(vc_context *ctx, const char *source, size_t length,
+                         const char *filename, unsigned char **object, size_t *object_size)
+{
+    *object = NULL;
+    *object_size = 0;
+
+    char *asm_text;
+    size_t asm_size;
+    int result = vc_compile_to_assembly(ctx, source, length, filename, &asm_text, &asm_size);
+    if (result != 0)
+        return result;
+
+    // 追加汇编阶段的诊断
+    char *previous = ctx->diagnostics;
+    ctx->diagnostics = NULL;
+    FILE *diag = begin_compile(ctx);
+    if (!diag)
+    {
+        ctx->diagnostics = previous;
+        free(asm_text);
+        return 1;
+    }
+    fputs(previous ? previous : "", diag);
+    free(previous);
+
+    ObjectCode *obj = assemble(asm_text, diag);
+    free(asm_text);
+    if (!obj)
+    {
+        fprintf(diag, "Assembly failed\n");
+        fclose(diag);
+        return 1;
+    }
+    result = elf_object_to_memory(obj, object, object_size);
+    object_code_free(obj);
+    fclose(diag);
+    return result;
+}